@@ -0,0 +1,860 @@
+/*
+  ==============================================================================
+  
+    leaf-benchmarks.c
+    
+    Times the tick and block functions of representative objects from each
+    family and reports nanoseconds and cycles per sample as JSON, so results
+    can be diffed between LEAF versions and between builds with LEAF_USE_SIMD
+    on and off.
+    
+    On a desktop, build it with LEAF's sources and run it:
+    
+        cc -O2 -o leaf-benchmarks Benchmarks/leaf-benchmarks.c leaf/Src/leaf*.c leaf/Externals/d_fft_mayer.c -lm
+        ./leaf-benchmarks [filter] > results.json
+    
+    On a Cortex-M, add this file to the firmware project with
+    LEAF_BENCH_NO_MAIN defined, set LEAF_BENCH_CPU_HZ to the core clock and
+    call LEAF_runBenchmarks() with a function that prints a line over a UART.
+    newlib-nano needs -u _printf_float for the numbers to print.
+    
+    Cycles come from DWT CYCCNT on Cortex-M and from the TSC on x86, which
+    counts at a fixed reference rate rather than the current core clock.
+    Other targets report null cycles.
+  
+  ==============================================================================
+*/
+
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 199309L
+#endif
+
+#include "leaf-benchmarks.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#if defined(__ARM_ARCH_7EM__) || defined(__ARM_ARCH_7M__) || defined(__ARM_ARCH_8M_MAIN__) || defined(__ARM_ARCH_8_1M_MAIN__)
+#define BENCH_TIMER_DWT 1
+#elif defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define BENCH_TIMER_TSC 1
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+#endif
+
+#if !BENCH_TIMER_DWT
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+#endif
+
+//==============================================================================
+// Timing
+//==============================================================================
+
+#if BENCH_TIMER_DWT
+#define DWT_CTRL    (*(volatile uint32_t*) 0xE0001000)
+#define DWT_CYCCNT  (*(volatile uint32_t*) 0xE0001004)
+#define DWT_LAR     (*(volatile uint32_t*) 0xE0001FB0)
+#define DEMCR       (*(volatile uint32_t*) 0xE000EDFC)
+#endif
+
+typedef struct BenchTime
+{
+    uint64_t cycles;
+    uint64_t ns;
+} BenchTime;
+
+static void bench_timerInit(void)
+{
+#if BENCH_TIMER_DWT
+    DEMCR |= (1u << 24); // TRCENA
+    DWT_LAR = 0xC5ACCE55; // The Cortex-M7 DWT is locked until this is written
+    DWT_CYCCNT = 0;
+    DWT_CTRL |= 1u;
+#endif
+}
+
+static BenchTime bench_now(void)
+{
+    BenchTime t;
+#if BENCH_TIMER_DWT
+    t.cycles = DWT_CYCCNT;
+    t.ns = 0;
+#else
+#if BENCH_TIMER_TSC
+    t.cycles = __rdtsc();
+#else
+    t.cycles = 0;
+#endif
+#if defined(_WIN32)
+    LARGE_INTEGER count, frequency;
+    QueryPerformanceCounter(&count);
+    QueryPerformanceFrequency(&frequency);
+    t.ns = (uint64_t) ((double) count.QuadPart * 1.0e9 / (double) frequency.QuadPart);
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    t.ns = (uint64_t) ts.tv_sec * 1000000000u + (uint64_t) ts.tv_nsec;
+#endif
+#endif
+    return t;
+}
+
+static BenchTime bench_elapsed(BenchTime start, BenchTime end)
+{
+    BenchTime t;
+#if BENCH_TIMER_DWT
+    // CYCCNT is 32 bits and wraps every few seconds, so each run has to be shorter than that
+    t.cycles = (uint32_t) ((uint32_t) end.cycles - (uint32_t) start.cycles);
+    t.ns = (uint64_t) ((double) t.cycles * 1.0e9 / (double) LEAF_BENCH_CPU_HZ);
+#else
+    t.cycles = end.cycles - start.cycles;
+    t.ns = end.ns - start.ns;
+#endif
+    return t;
+}
+
+//==============================================================================
+// Benchmarks
+//==============================================================================
+
+// Objects are made in the LEAF instance here and freed after each benchmark. Parameters are ones an
+// instrument might use, so objects with data-dependent paths take their usual ones.
+
+static LEAF leaf;
+static char benchMemory[LEAF_BENCH_MEMPOOL_SIZE];
+static uint32_t benchSeed = 22222;
+
+static float bench_random(void)
+{
+    benchSeed = benchSeed * 1664525u + 1013904223u;
+    return (float) (benchSeed >> 8) * (1.0f / 16777216.0f);
+}
+
+//----------------------------------------------------------------------------
+// Oscillators
+
+static void bench_cycle(LEAFBenchmarkOp op, const float* input, float* output, int size)
+{
+    static tCycle osc;
+    (void) input;
+    switch (op)
+    {
+        case BenchmarkInit: tCycle_init(&osc, &leaf); tCycle_setFreq(&osc, 220.0f); break;
+        case BenchmarkTick: for (int i = 0; i < size; i++) output[i] = tCycle_tick(&osc); break;
+        case BenchmarkBlock: tCycle_tickBlock(&osc, output, size); break;
+        case BenchmarkFree: tCycle_free(&osc); break;
+    }
+}
+
+static void bench_cycleBank(LEAFBenchmarkOp op, const float* input, float* output, int size)
+{
+    // Eight partials, all written over the same block since only the time is kept
+    static tCycleBank bank;
+    (void) input;
+    float* outputs[8];
+    for (int v = 0; v < 8; v++) outputs[v] = output;
+    switch (op)
+    {
+        case BenchmarkInit:
+            tCycleBank_init(&bank, 8, &leaf);
+            for (int v = 0; v < 8; v++) tCycleBank_setFreq(&bank, v, 110.0f * (v + 1));
+            break;
+        case BenchmarkBlock: tCycleBank_tickBlock(&bank, outputs, size); break;
+        case BenchmarkFree: tCycleBank_free(&bank); break;
+        default: break;
+    }
+}
+
+static void bench_sawtooth(LEAFBenchmarkOp op, const float* input, float* output, int size)
+{
+    static tSawtooth osc;
+    (void) input;
+    switch (op)
+    {
+        case BenchmarkInit: tSawtooth_init(&osc, &leaf); tSawtooth_setFreq(&osc, 220.0f); break;
+        case BenchmarkTick: for (int i = 0; i < size; i++) output[i] = tSawtooth_tick(&osc); break;
+        case BenchmarkFree: tSawtooth_free(&osc); break;
+        default: break;
+    }
+}
+
+static void bench_pbSaw(LEAFBenchmarkOp op, const float* input, float* output, int size)
+{
+    static tPBSaw osc;
+    (void) input;
+    switch (op)
+    {
+        case BenchmarkInit: tPBSaw_init(&osc, &leaf); tPBSaw_setFreq(&osc, 220.0f); break;
+        case BenchmarkTick: for (int i = 0; i < size; i++) output[i] = tPBSaw_tick(&osc); break;
+        case BenchmarkFree: tPBSaw_free(&osc); break;
+        default: break;
+    }
+}
+
+static void bench_mbSaw(LEAFBenchmarkOp op, const float* input, float* output, int size)
+{
+    static tMBSaw osc;
+    (void) input;
+    switch (op)
+    {
+        case BenchmarkInit: tMBSaw_init(&osc, &leaf); tMBSaw_setFreq(&osc, 220.0f); break;
+        case BenchmarkTick: for (int i = 0; i < size; i++) output[i] = tMBSaw_tick(&osc); break;
+        case BenchmarkBlock: tMBSaw_tickBlock(&osc, output, size); break;
+        case BenchmarkFree: tMBSaw_free(&osc); break;
+    }
+}
+
+static void bench_mbPulse(LEAFBenchmarkOp op, const float* input, float* output, int size)
+{
+    static tMBPulse osc;
+    (void) input;
+    switch (op)
+    {
+        case BenchmarkInit: tMBPulse_init(&osc, &leaf); tMBPulse_setFreq(&osc, 220.0f); tMBPulse_setWidth(&osc, 0.3f); break;
+        case BenchmarkTick: for (int i = 0; i < size; i++) output[i] = tMBPulse_tick(&osc); break;
+        case BenchmarkBlock: tMBPulse_tickBlock(&osc, output, size); break;
+        case BenchmarkFree: tMBPulse_free(&osc); break;
+    }
+}
+
+static void bench_mbTriangle(LEAFBenchmarkOp op, const float* input, float* output, int size)
+{
+    static tMBTriangle osc;
+    (void) input;
+    switch (op)
+    {
+        case BenchmarkInit: tMBTriangle_init(&osc, &leaf); tMBTriangle_setFreq(&osc, 220.0f); break;
+        case BenchmarkTick: for (int i = 0; i < size; i++) output[i] = tMBTriangle_tick(&osc); break;
+        case BenchmarkBlock: tMBTriangle_tickBlock(&osc, output, size); break;
+        case BenchmarkFree: tMBTriangle_free(&osc); break;
+    }
+}
+
+static void bench_noise(LEAFBenchmarkOp op, const float* input, float* output, int size)
+{
+    static tNoise noise;
+    (void) input;
+    switch (op)
+    {
+        case BenchmarkInit: tNoise_init(&noise, PinkNoise, &leaf); break;
+        case BenchmarkTick: for (int i = 0; i < size; i++) output[i] = tNoise_tick(&noise); break;
+        case BenchmarkBlock: tNoise_tickBlock(&noise, output, size); break;
+        case BenchmarkFree: tNoise_free(&noise); break;
+    }
+}
+
+//----------------------------------------------------------------------------
+// Filters
+
+static void bench_onePole(LEAFBenchmarkOp op, const float* input, float* output, int size)
+{
+    static tOnePole filter;
+    switch (op)
+    {
+        case BenchmarkInit: tOnePole_init(&filter, 0.9f, &leaf); tOnePole_setFreq(&filter, 1000.0f); break;
+        case BenchmarkTick: for (int i = 0; i < size; i++) output[i] = tOnePole_tick(&filter, input[i]); break;
+        case BenchmarkBlock: tOnePole_tickBlock(&filter, input, output, size); break;
+        case BenchmarkFree: tOnePole_free(&filter); break;
+    }
+}
+
+static void bench_biQuad(LEAFBenchmarkOp op, const float* input, float* output, int size)
+{
+    static tBiQuad filter;
+    switch (op)
+    {
+        case BenchmarkInit: tBiQuad_init(&filter, &leaf); tBiQuad_setResonance(&filter, 2000.0f, 0.95f, 1); break;
+        case BenchmarkTick: for (int i = 0; i < size; i++) output[i] = tBiQuad_tick(&filter, input[i]); break;
+        case BenchmarkBlock: tBiQuad_tickBlock(&filter, input, output, size); break;
+        case BenchmarkFree: tBiQuad_free(&filter); break;
+    }
+}
+
+static void bench_svf(LEAFBenchmarkOp op, const float* input, float* output, int size)
+{
+    static tSVF filter;
+    switch (op)
+    {
+        case BenchmarkInit: tSVF_init(&filter, SVFTypeLowpass, 1200.0f, 2.0f, &leaf); break;
+        case BenchmarkTick: for (int i = 0; i < size; i++) output[i] = tSVF_tick(&filter, input[i]); break;
+        case BenchmarkBlock: tSVF_tickBlock(&filter, input, output, size); break;
+        case BenchmarkFree: tSVF_free(&filter); break;
+    }
+}
+
+static void bench_vzFilter(LEAFBenchmarkOp op, const float* input, float* output, int size)
+{
+    static tVZFilter filter;
+    switch (op)
+    {
+        case BenchmarkInit: tVZFilter_init(&filter, Bell, 1000.0f, 1.0f, &leaf); tVZFilter_setGain(&filter, 2.0f); break;
+        case BenchmarkTick: for (int i = 0; i < size; i++) output[i] = tVZFilter_tick(&filter, input[i]); break;
+        case BenchmarkBlock: tVZFilter_tickBlock(&filter, input, output, size); break;
+        case BenchmarkFree: tVZFilter_free(&filter); break;
+    }
+}
+
+static void bench_diodeFilter(LEAFBenchmarkOp op, const float* input, float* output, int size)
+{
+    static tDiodeFilter filter;
+    switch (op)
+    {
+        case BenchmarkInit: tDiodeFilter_init(&filter, 1500.0f, 0.5f, &leaf); break;
+        case BenchmarkTick: for (int i = 0; i < size; i++) output[i] = tDiodeFilter_tick(&filter, input[i]); break;
+        case BenchmarkBlock: tDiodeFilter_tickBlock(&filter, input, output, size); break;
+        case BenchmarkFree: tDiodeFilter_free(&filter); break;
+    }
+}
+
+static void bench_butterworth(LEAFBenchmarkOp op, const float* input, float* output, int size)
+{
+    static tButterworth filter;
+    switch (op)
+    {
+        case BenchmarkInit: tButterworth_init(&filter, 4, 200.0f, 4000.0f, &leaf); break;
+        case BenchmarkTick: for (int i = 0; i < size; i++) output[i] = tButterworth_tick(&filter, input[i]); break;
+        case BenchmarkBlock: tButterworth_tickBlock(&filter, input, output, size); break;
+        case BenchmarkFree: tButterworth_free(&filter); break;
+    }
+}
+
+static void bench_fir(LEAFBenchmarkOp op, const float* input, float* output, int size)
+{
+    // A 64 tap windowed sinc lowpass
+    static tFIR filter;
+    static float coeffs[64];
+    switch (op)
+    {
+        case BenchmarkInit:
+            for (int i = 0; i < 64; i++)
+            {
+                float x = (i - 31.5f) * 0.25f;
+                float window = 0.5f - 0.5f * cosf(TWO_PI * (i + 0.5f) / 64.0f);
+                coeffs[i] = 0.25f * window * sinf(PI * x) / (PI * x);
+            }
+            tFIR_init(&filter, coeffs, 64, &leaf);
+            break;
+        case BenchmarkTick: for (int i = 0; i < size; i++) output[i] = tFIR_tick(&filter, input[i]); break;
+        case BenchmarkBlock: tFIR_tickBlock(&filter, input, output, size); break;
+        case BenchmarkFree: tFIR_free(&filter); break;
+    }
+}
+
+static void bench_convolver(LEAFBenchmarkOp op, const float* input, float* output, int size)
+{
+    // A 4096 sample decaying noise IR, about a room's worth at 48k
+    static tConvolver filter;
+    static float ir[4096];
+    switch (op)
+    {
+        case BenchmarkInit:
+            for (int i = 0; i < 4096; i++) ir[i] = (bench_random() * 2.0f - 1.0f) * expf(-i / 800.0f);
+            tConvolver_init(&filter, ir, 4096, LEAF_BENCH_BLOCK_SIZE, &leaf);
+            break;
+        case BenchmarkTick: for (int i = 0; i < size; i++) output[i] = tConvolver_tick(&filter, input[i]); break;
+        case BenchmarkBlock: tConvolver_tickBlock(&filter, input, output, size); break;
+        case BenchmarkFree: tConvolver_free(&filter); break;
+    }
+}
+
+//----------------------------------------------------------------------------
+// Delays
+
+static void bench_delay(LEAFBenchmarkOp op, const float* input, float* output, int size)
+{
+    static tDelay delay;
+    switch (op)
+    {
+        case BenchmarkInit: tDelay_init(&delay, 12000, 48000, &leaf); break;
+        case BenchmarkTick: for (int i = 0; i < size; i++) output[i] = tDelay_tick(&delay, input[i]); break;
+        case BenchmarkFree: tDelay_free(&delay); break;
+        default: break;
+    }
+}
+
+static void bench_linearDelay(LEAFBenchmarkOp op, const float* input, float* output, int size)
+{
+    static tLinearDelay delay;
+    switch (op)
+    {
+        case BenchmarkInit: tLinearDelay_init(&delay, 12000.5f, 48000, &leaf); break;
+        case BenchmarkTick: for (int i = 0; i < size; i++) output[i] = tLinearDelay_tick(&delay, input[i]); break;
+        case BenchmarkFree: tLinearDelay_free(&delay); break;
+        default: break;
+    }
+}
+
+static void bench_hermiteDelay(LEAFBenchmarkOp op, const float* input, float* output, int size)
+{
+    static tHermiteDelay delay;
+    switch (op)
+    {
+        case BenchmarkInit: tHermiteDelay_init(&delay, 12000.5f, 48000, &leaf); break;
+        case BenchmarkTick: for (int i = 0; i < size; i++) output[i] = tHermiteDelay_tick(&delay, input[i]); break;
+        case BenchmarkFree: tHermiteDelay_free(&delay); break;
+        default: break;
+    }
+}
+
+static void bench_tapeDelay(LEAFBenchmarkOp op, const float* input, float* output, int size)
+{
+    static tTapeDelay delay;
+    switch (op)
+    {
+        case BenchmarkInit: tTapeDelay_init(&delay, 12000.0f, 48000, &leaf); break;
+        case BenchmarkTick: for (int i = 0; i < size; i++) output[i] = tTapeDelay_tick(&delay, input[i]); break;
+        case BenchmarkFree: tTapeDelay_free(&delay); break;
+        default: break;
+    }
+}
+
+static void bench_multiTapDelay(LEAFBenchmarkOp op, const float* input, float* output, int size)
+{
+    static tMultiTapDelay delay;
+    switch (op)
+    {
+        case BenchmarkInit:
+            tMultiTapDelay_init(&delay, 48000, 4, &leaf);
+            for (int t = 0; t < 4; t++)
+            {
+                tMultiTapDelay_setTapDelay(&delay, t, 3000.0f * (t + 1) + 0.5f);
+                tMultiTapDelay_setTapGain(&delay, t, 0.5f / (t + 1));
+            }
+            break;
+        case BenchmarkTick: for (int i = 0; i < size; i++) output[i] = tMultiTapDelay_tick(&delay, input[i]); break;
+        case BenchmarkBlock: tMultiTapDelay_tickBlock(&delay, input, output, size); break;
+        case BenchmarkFree: tMultiTapDelay_free(&delay); break;
+    }
+}
+
+//----------------------------------------------------------------------------
+// Reverbs
+
+static void bench_prcReverb(LEAFBenchmarkOp op, const float* input, float* output, int size)
+{
+    static tPRCReverb reverb;
+    switch (op)
+    {
+        case BenchmarkInit: tPRCReverb_init(&reverb, 2.0f, &leaf); break;
+        case BenchmarkTick: for (int i = 0; i < size; i++) output[i] = tPRCReverb_tick(&reverb, input[i]); break;
+        case BenchmarkFree: tPRCReverb_free(&reverb); break;
+        default: break;
+    }
+}
+
+static void bench_nReverb(LEAFBenchmarkOp op, const float* input, float* output, int size)
+{
+    static tNReverb reverb;
+    switch (op)
+    {
+        case BenchmarkInit: tNReverb_init(&reverb, 2.0f, &leaf); break;
+        case BenchmarkTick: for (int i = 0; i < size; i++) output[i] = tNReverb_tick(&reverb, input[i]); break;
+        case BenchmarkFree: tNReverb_free(&reverb); break;
+        default: break;
+    }
+}
+
+static void bench_dattorroReverb(LEAFBenchmarkOp op, const float* input, float* output, int size)
+{
+    static tDattorroReverb reverb;
+    switch (op)
+    {
+        case BenchmarkInit: tDattorroReverb_init(&reverb, &leaf); break;
+        case BenchmarkTick: for (int i = 0; i < size; i++) output[i] = tDattorroReverb_tick(&reverb, input[i]); break;
+        case BenchmarkBlock: tDattorroReverb_tickBlock(&reverb, input, output, size); break;
+        case BenchmarkFree: tDattorroReverb_free(&reverb); break;
+    }
+}
+
+static void bench_fdnReverb(LEAFBenchmarkOp op, const float* input, float* output, int size)
+{
+    static tFDNReverb reverb;
+    switch (op)
+    {
+        case BenchmarkInit: tFDNReverb_init(&reverb, 8, &leaf); tFDNReverb_setT60(&reverb, 2.0f); break;
+        case BenchmarkTick: for (int i = 0; i < size; i++) output[i] = tFDNReverb_tick(&reverb, input[i]); break;
+        case BenchmarkBlock: tFDNReverb_tickBlock(&reverb, input, output, size); break;
+        case BenchmarkFree: tFDNReverb_free(&reverb); break;
+    }
+}
+
+//----------------------------------------------------------------------------
+// Dynamics and distortion
+
+static void bench_compressor(LEAFBenchmarkOp op, const float* input, float* output, int size)
+{
+    static tCompressor compressor;
+    switch (op)
+    {
+        case BenchmarkInit: tCompressor_init(&compressor, &leaf); break;
+        case BenchmarkTick: for (int i = 0; i < size; i++) output[i] = tCompressor_tick(&compressor, input[i]); break;
+        case BenchmarkBlock: tCompressor_tickBlock(&compressor, input, output, size); break;
+        case BenchmarkFree: tCompressor_free(&compressor); break;
+    }
+}
+
+static void bench_adaaSaturator(LEAFBenchmarkOp op, const float* input, float* output, int size)
+{
+    static tADAASaturator saturator;
+    switch (op)
+    {
+        case BenchmarkInit: tADAASaturator_init(&saturator, &leaf); break;
+        case BenchmarkTick: for (int i = 0; i < size; i++) output[i] = tADAASaturator_tick(&saturator, input[i]); break;
+        case BenchmarkBlock: tADAASaturator_tickBlock(&saturator, input, output, size); break;
+        case BenchmarkFree: tADAASaturator_free(&saturator); break;
+    }
+}
+
+static void bench_lockhartWavefolder(LEAFBenchmarkOp op, const float* input, float* output, int size)
+{
+    static tLockhartWavefolder folder;
+    switch (op)
+    {
+        case BenchmarkInit: tLockhartWavefolder_init(&folder, &leaf); break;
+        case BenchmarkTick: for (int i = 0; i < size; i++) output[i] = tLockhartWavefolder_tick(&folder, input[i]); break;
+        case BenchmarkBlock: tLockhartWavefolder_tickBlock(&folder, input, output, size); break;
+        case BenchmarkFree: tLockhartWavefolder_free(&folder); break;
+    }
+}
+
+//----------------------------------------------------------------------------
+// Envelopes
+
+static void bench_adsrs(LEAFBenchmarkOp op, const float* input, float* output, int size)
+{
+    // Retriggered every quarter second so the timing covers every stage
+    static tADSRS envelope;
+    static int count;
+    (void) input;
+    if (op == BenchmarkTick || op == BenchmarkBlock)
+    {
+        if (count <= 0)
+        {
+            tADSRS_on(&envelope, 1.0f);
+            count = LEAF_BENCH_SAMPLE_RATE / 4;
+        }
+        count -= size;
+    }
+    switch (op)
+    {
+        case BenchmarkInit: tADSRS_init(&envelope, 20.0f, 80.0f, 0.5f, 100.0f, &leaf); count = 0; break;
+        case BenchmarkTick: for (int i = 0; i < size; i++) output[i] = tADSRS_tick(&envelope); break;
+        case BenchmarkBlock: tADSRS_tickBlock(&envelope, output, size); break;
+        case BenchmarkFree: tADSRS_free(&envelope); break;
+    }
+}
+
+static void bench_expSmooth(LEAFBenchmarkOp op, const float* input, float* output, int size)
+{
+    static tExpSmooth smooth;
+    (void) input;
+    switch (op)
+    {
+        case BenchmarkInit: tExpSmooth_init(&smooth, 0.0f, 0.01f, &leaf); tExpSmooth_setDest(&smooth, 1.0f); break;
+        case BenchmarkTick: for (int i = 0; i < size; i++) output[i] = tExpSmooth_tick(&smooth); break;
+        case BenchmarkBlock: tExpSmooth_tickBlock(&smooth, output, size); break;
+        case BenchmarkFree: tExpSmooth_free(&smooth); break;
+    }
+}
+
+//----------------------------------------------------------------------------
+// Analysis
+
+static void bench_envelopeFollower(LEAFBenchmarkOp op, const float* input, float* output, int size)
+{
+    static tEnvelopeFollower follower;
+    switch (op)
+    {
+        case BenchmarkInit: tEnvelopeFollower_init(&follower, 0.01f, 0.999f, &leaf); break;
+        case BenchmarkTick: for (int i = 0; i < size; i++) output[i] = tEnvelopeFollower_tick(&follower, input[i]); break;
+        case BenchmarkFree: tEnvelopeFollower_free(&follower); break;
+        default: break;
+    }
+}
+
+static void bench_envPD(LEAFBenchmarkOp op, const float* input, float* output, int size)
+{
+    static tEnvPD env;
+    (void) size;
+    switch (op)
+    {
+        case BenchmarkInit: tEnvPD_init(&env, 1024, 512, LEAF_BENCH_BLOCK_SIZE, &leaf); break;
+        case BenchmarkBlock: tEnvPD_processBlock(&env, (float*) input); output[0] = tEnvPD_tick(&env); break;
+        case BenchmarkFree: tEnvPD_free(&env); break;
+        default: break;
+    }
+}
+
+static void bench_pitchDetector(LEAFBenchmarkOp op, const float* input, float* output, int size)
+{
+    static tPitchDetector detector;
+    switch (op)
+    {
+        case BenchmarkInit: tPitchDetector_init(&detector, 60.0f, 2000.0f, &leaf); break;
+        case BenchmarkTick:
+            for (int i = 0; i < size; i++)
+            {
+                tPitchDetector_tick(&detector, input[i]);
+                output[i] = tPitchDetector_getFrequency(&detector);
+            }
+            break;
+        case BenchmarkFree: tPitchDetector_free(&detector); break;
+        default: break;
+    }
+}
+
+//----------------------------------------------------------------------------
+// Physical models
+
+static void bench_simpleLivingString(LEAFBenchmarkOp op, const float* input, float* output, int size)
+{
+    static tSimpleLivingString string;
+    switch (op)
+    {
+        case BenchmarkInit: tSimpleLivingString_init(&string, 110.0f, 8000.0f, 0.999f, 0.05f, 0.01f, 0.01f, 0, &leaf); break;
+        case BenchmarkTick: for (int i = 0; i < size; i++) output[i] = tSimpleLivingString_tick(&string, input[i]); break;
+        case BenchmarkFree: tSimpleLivingString_free(&string); break;
+        default: break;
+    }
+}
+
+static void bench_livingString(LEAFBenchmarkOp op, const float* input, float* output, int size)
+{
+    static tLivingString string;
+    switch (op)
+    {
+        case BenchmarkInit: tLivingString_init(&string, 110.0f, 0.3f, 0.0f, 8000.0f, 0.999f, 0.05f, 0.01f, 0.01f, 0, &leaf); break;
+        case BenchmarkTick: for (int i = 0; i < size; i++) output[i] = tLivingString_tick(&string, input[i]); break;
+        case BenchmarkBlock: tLivingString_tickBlock(&string, input, output, size); break;
+        case BenchmarkFree: tLivingString_free(&string); break;
+    }
+}
+
+static void bench_complexLivingString(LEAFBenchmarkOp op, const float* input, float* output, int size)
+{
+    static tComplexLivingString string;
+    switch (op)
+    {
+        case BenchmarkInit: tComplexLivingString_init(&string, 110.0f, 0.3f, 0.6f, 0.2f, 8000.0f, 0.999f, 0.05f, 0.01f, 0.01f, 0, &leaf); break;
+        case BenchmarkTick: for (int i = 0; i < size; i++) output[i] = tComplexLivingString_tick(&string, input[i]); break;
+        case BenchmarkBlock: tComplexLivingString_tickBlock(&string, input, output, size); break;
+        case BenchmarkFree: tComplexLivingString_free(&string); break;
+    }
+}
+
+//----------------------------------------------------------------------------
+// Math
+
+static void bench_tanh(LEAFBenchmarkOp op, const float* input, float* output, int size)
+{
+    switch (op)
+    {
+        case BenchmarkTick: for (int i = 0; i < size; i++) output[i] = LEAF_tanh(input[i]); break;
+        case BenchmarkBlock: LEAF_tanhBlock(input, output, size); break;
+        default: break;
+    }
+}
+
+static void bench_mtof(LEAFBenchmarkOp op, const float* input, float* output, int size)
+{
+    switch (op)
+    {
+        case BenchmarkTick: for (int i = 0; i < size; i++) output[i] = mtof(input[i]); break;
+        case BenchmarkBlock: LEAF_mtofBlock(input, output, size); break;
+        default: break;
+    }
+}
+
+static const LEAFBenchmark benchmarks[] =
+{
+    { "oscillators", "tCycle", bench_cycle, 1, 1 },
+    { "oscillators", "tCycleBank", bench_cycleBank, 0, 1 },
+    { "oscillators", "tSawtooth", bench_sawtooth, 1, 0 },
+    { "oscillators", "tPBSaw", bench_pbSaw, 1, 0 },
+    { "oscillators", "tMBSaw", bench_mbSaw, 1, 1 },
+    { "oscillators", "tMBPulse", bench_mbPulse, 1, 1 },
+    { "oscillators", "tMBTriangle", bench_mbTriangle, 1, 1 },
+    { "oscillators", "tNoise", bench_noise, 1, 1 },
+    { "filters", "tOnePole", bench_onePole, 1, 1 },
+    { "filters", "tBiQuad", bench_biQuad, 1, 1 },
+    { "filters", "tSVF", bench_svf, 1, 1 },
+    { "filters", "tVZFilter", bench_vzFilter, 1, 1 },
+    { "filters", "tDiodeFilter", bench_diodeFilter, 1, 1 },
+    { "filters", "tButterworth", bench_butterworth, 1, 1 },
+    { "filters", "tFIR", bench_fir, 1, 1 },
+    { "filters", "tConvolver", bench_convolver, 1, 1 },
+    { "delay", "tDelay", bench_delay, 1, 0 },
+    { "delay", "tLinearDelay", bench_linearDelay, 1, 0 },
+    { "delay", "tHermiteDelay", bench_hermiteDelay, 1, 0 },
+    { "delay", "tTapeDelay", bench_tapeDelay, 1, 0 },
+    { "delay", "tMultiTapDelay", bench_multiTapDelay, 1, 1 },
+    { "reverb", "tPRCReverb", bench_prcReverb, 1, 0 },
+    { "reverb", "tNReverb", bench_nReverb, 1, 0 },
+    { "reverb", "tDattorroReverb", bench_dattorroReverb, 1, 1 },
+    { "reverb", "tFDNReverb", bench_fdnReverb, 1, 1 },
+    { "dynamics", "tCompressor", bench_compressor, 1, 1 },
+    { "distortion", "tADAASaturator", bench_adaaSaturator, 1, 1 },
+    { "distortion", "tLockhartWavefolder", bench_lockhartWavefolder, 1, 1 },
+    { "envelopes", "tADSRS", bench_adsrs, 1, 1 },
+    { "envelopes", "tExpSmooth", bench_expSmooth, 1, 1 },
+    { "analysis", "tEnvelopeFollower", bench_envelopeFollower, 1, 0 },
+    { "analysis", "tEnvPD", bench_envPD, 0, 1 },
+    { "analysis", "tPitchDetector", bench_pitchDetector, 1, 0 },
+    { "physical", "tSimpleLivingString", bench_simpleLivingString, 1, 0 },
+    { "physical", "tLivingString", bench_livingString, 1, 1 },
+    { "physical", "tComplexLivingString", bench_complexLivingString, 1, 1 },
+    { "math", "LEAF_tanh", bench_tanh, 1, 1 },
+    { "math", "mtof", bench_mtof, 1, 1 },
+};
+
+//==============================================================================
+// Runner
+//==============================================================================
+
+static float benchInput[LEAF_BENCH_BLOCK_SIZE];
+static float benchOutput[LEAF_BENCH_BLOCK_SIZE];
+
+static const char* bench_simdName(void)
+{
+#if LEAF_USE_SIMD && !LEAF_USE_CMSIS
+#if defined(__ARM_FEATURE_MVE) && (__ARM_FEATURE_MVE & 2)
+    return "helium";
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+    return "neon";
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    return "sse2";
+#endif
+#endif
+#if LEAF_USE_CMSIS
+    return "cmsis";
+#else
+    return "none";
+#endif
+}
+
+static const char* bench_precisionName(int precision)
+{
+    if (precision == LEAF_PRECISION_FLOAT64) return "float64";
+    if (precision == LEAF_PRECISION_Q31) return "q31";
+    return "float32";
+}
+
+// Times one path of a benchmark and formats its result. The output is summed into a checksum so the
+// work can't be optimized away, and so the tick and block paths and builds with and without SIMD can
+// be checked against each other.
+static void bench_run(const LEAFBenchmark* b, LEAFBenchmarkOp path, char* line, int lineSize)
+{
+    BenchTime best = { 0, 0 };
+    double checksum = 0.0;
+    
+    benchSeed = 22222;
+    b->function(BenchmarkInit, benchInput, benchOutput, LEAF_BENCH_BLOCK_SIZE);
+    for (int k = 0; k < 16; k++) b->function(path, benchInput, benchOutput, LEAF_BENCH_BLOCK_SIZE);
+    
+    for (int r = 0; r < LEAF_BENCH_REPEATS; r++)
+    {
+        BenchTime start = bench_now();
+        for (int k = 0; k < LEAF_BENCH_BLOCKS; k++)
+        {
+            b->function(path, benchInput, benchOutput, LEAF_BENCH_BLOCK_SIZE);
+        }
+        BenchTime time = bench_elapsed(start, bench_now());
+        if (r == 0 || time.ns < best.ns) best = time;
+        
+        for (int i = 0; i < LEAF_BENCH_BLOCK_SIZE; i++) checksum += benchOutput[i];
+    }
+    
+    b->function(BenchmarkFree, benchInput, benchOutput, LEAF_BENCH_BLOCK_SIZE);
+    
+    double samples = (double) LEAF_BENCH_BLOCKS * LEAF_BENCH_BLOCK_SIZE;
+    char cycles[32];
+#if BENCH_TIMER_DWT || BENCH_TIMER_TSC
+    snprintf(cycles, sizeof(cycles), "%.3f", (double) best.cycles / samples);
+#else
+    snprintf(cycles, sizeof(cycles), "null");
+#endif
+
+    snprintf(line, lineSize,
+             "    { \"family\": \"%s\", \"object\": \"%s\", \"path\": \"%s\", \"nsPerSample\": %.3f, \"cyclesPerSample\": %s, \"checksum\": %.6g }",
+             b->family, b->object, path == BenchmarkTick ? "tick" : "block",
+             (double) best.ns / samples, cycles, checksum);
+}
+
+int LEAF_runBenchmarks(void (*print)(const char* line), const char* filter)
+{
+    char line[256];
+    char result[256];
+    int count = 0;
+    
+    LEAF_init(&leaf, LEAF_BENCH_SAMPLE_RATE, benchMemory, sizeof(benchMemory), &bench_random);
+    LEAF_setBlockSize(&leaf, LEAF_BENCH_BLOCK_SIZE);
+    bench_timerInit();
+    
+    // A whole number of cycles of 375 Hz fits in the block, so repeating it stays continuous
+    for (int i = 0; i < LEAF_BENCH_BLOCK_SIZE; i++)
+    {
+        float phase = (float) i / (float) LEAF_BENCH_BLOCK_SIZE;
+        benchInput[i] = 0.5f * sinf(TWO_PI * phase) + 0.1f * sinf(TWO_PI * 7.0f * phase);
+    }
+    
+    print("{");
+    snprintf(line, sizeof(line),
+             "  \"config\": { \"sampleRate\": %d, \"blockSize\": %d, \"blocks\": %d, \"repeats\": %d, \"simd\": \"%s\", \"samplePrecision\": \"%s\", \"coeffPrecision\": \"%s\", \"timer\": \"%s\" },",
+             LEAF_BENCH_SAMPLE_RATE, LEAF_BENCH_BLOCK_SIZE, LEAF_BENCH_BLOCKS, LEAF_BENCH_REPEATS, bench_simdName(),
+             bench_precisionName(LEAF_SAMPLE_PRECISION), bench_precisionName(LEAF_COEFF_PRECISION),
+#if BENCH_TIMER_DWT
+             "dwt"
+#elif BENCH_TIMER_TSC
+             "tsc"
+#else
+             "clock"
+#endif
+             );
+    print(line);
+    print("  \"results\": [");
+    
+    for (unsigned int n = 0; n < sizeof(benchmarks) / sizeof(benchmarks[0]); n++)
+    {
+        const LEAFBenchmark* b = &benchmarks[n];
+        if (filter != NULL && strstr(b->family, filter) == NULL && strstr(b->object, filter) == NULL) continue;
+        
+        // Each result is printed once the next one is ready, so the last one goes without a comma
+        for (int p = 0; p < 2; p++)
+        {
+            if (!(p == 0 ? b->hasTick : b->hasBlock)) continue;
+            if (count++ > 0)
+            {
+                strcat(result, ",");
+                print(result);
+            }
+            bench_run(b, p == 0 ? BenchmarkTick : BenchmarkBlock, result, sizeof(result) - 1);
+        }
+    }
+    if (count > 0) print(result);
+    
+    print("  ]");
+    print("}");
+    return count;
+}
+
+#ifndef LEAF_BENCH_NO_MAIN
+static void bench_printLine(const char* line)
+{
+    fputs(line, stdout);
+    fputc('\n', stdout);
+    fflush(stdout);
+}
+
+int main(int argc, char** argv)
+{
+    LEAF_runBenchmarks(bench_printLine, argc > 1 ? argv[1] : NULL);
+    return 0;
+}
+#endif
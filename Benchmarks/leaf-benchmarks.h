@@ -0,0 +1,82 @@
+/*
+  ==============================================================================
+  
+    leaf-benchmarks.h
+    
+    Headless timing of LEAF's tick and block functions. See leaf-benchmarks.c.
+  
+  ==============================================================================
+*/
+
+#ifndef LEAF_BENCHMARKS_H_INCLUDED
+#define LEAF_BENCHMARKS_H_INCLUDED
+
+#include "../leaf/leaf.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//! Sample rate the benchmarks run LEAF at.
+#ifndef LEAF_BENCH_SAMPLE_RATE
+#define LEAF_BENCH_SAMPLE_RATE 48000
+#endif
+
+//! Block size passed to the block functions, and the number of ticks per timed call of the tick functions.
+#ifndef LEAF_BENCH_BLOCK_SIZE
+#define LEAF_BENCH_BLOCK_SIZE 128
+#endif
+
+//! Blocks processed in each timed run. The default is one second of audio.
+#ifndef LEAF_BENCH_BLOCKS
+#define LEAF_BENCH_BLOCKS (LEAF_BENCH_SAMPLE_RATE / LEAF_BENCH_BLOCK_SIZE)
+#endif
+
+//! Timed runs of each benchmark. The fastest one is reported, which filters out interrupts and the OS scheduler.
+#ifndef LEAF_BENCH_REPEATS
+#define LEAF_BENCH_REPEATS 5
+#endif
+
+//! Size of the LEAF mempool. Every benchmark frees its objects before the next one starts.
+#ifndef LEAF_BENCH_MEMPOOL_SIZE
+#define LEAF_BENCH_MEMPOOL_SIZE (4 * 1024 * 1024)
+#endif
+
+//! Core clock in Hz, used on Cortex-M to turn DWT cycle counts into nanoseconds.
+#ifndef LEAF_BENCH_CPU_HZ
+#define LEAF_BENCH_CPU_HZ 480000000
+#endif
+
+typedef enum LEAFBenchmarkOp
+{
+    BenchmarkInit = 0,
+    BenchmarkTick,
+    BenchmarkBlock,
+    BenchmarkFree
+} LEAFBenchmarkOp;
+
+//! Benchmarks drive their objects through one function. For BenchmarkTick and BenchmarkBlock it processes size samples from input to output.
+typedef void (*LEAFBenchmarkFunction)(LEAFBenchmarkOp op, const float* input, float* output, int size);
+
+typedef struct LEAFBenchmark
+{
+    const char* family; //!< The module, such as "filters".
+    const char* object; //!< The object or function measured.
+    LEAFBenchmarkFunction function;
+    int hasTick; //!< Whether the tick path is measured.
+    int hasBlock; //!< Whether the block path is measured.
+} LEAFBenchmark;
+
+//! Run every benchmark whose family or object contains filter, or all of them if filter is NULL, writing a JSON report through print a line at a time.
+/*!
+ @param print Called with each line of the report, without a newline. On hardware this can write to a UART.
+ @param filter Only run benchmarks whose family or object name contains this, or NULL to run them all.
+ @return The number of results reported.
+ */
+int LEAF_runBenchmarks(void (*print)(const char* line), const char* filter);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LEAF_BENCHMARKS_H_INCLUDED
@@ -181,6 +181,16 @@ void    LEAFTest_end             (void)
 void leaf_pool_report(void)
 {
     DBG(String(leaf_pool_get_used(&leaf)) + " of  " + String(leaf_pool_get_size(&leaf)));
+#if LEAF_POOL_STATS
+    LEAFMempoolStats stats;
+    leaf_pool_get_stats(&leaf, &stats);
+    DBG("peak " + String(stats.peak) + " largest free " + String(stats.largestFree) + " in " + String(stats.freeBlocks) + " free blocks");
+    for (int i = 0; i < mpool_get_num_tags(leaf.mempool); i++)
+    {
+        LEAFMempoolTag* tag = mpool_get_tag(leaf.mempool, i);
+        DBG(String(tag->name) + ": " + String(tag->bytes) + " bytes in " + String(tag->count) + " allocs");
+    }
+#endif
 }
 
 void leaf_pool_dump(void)
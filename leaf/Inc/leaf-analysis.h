@@ -19,6 +19,7 @@ extern "C" {
 #include "leaf-mempool.h"
 #include "leaf-distortion.h"
 #include "leaf-math.h"
+#include "leaf-fft.h"
 #include "leaf-filters.h"
 #include "leaf-envelopes.h"
 #include "leaf-delay.h"
@@ -57,6 +58,10 @@ extern "C" {
      @brief Free a tEnvelopeFollower from its mempool.
      @param follower A pointer to the tEnvelopeFollower to free.
      
+     @fn size_t  tEnvelopeFollower_getRequiredSize (void)
+     @brief Get the bytes tEnvelopeFollower_initToPool() allocates from a first-fit mempool, as a constant expression that can size static memory.
+     @return The size in bytes.
+     
      @fn float   tEnvelopeFollower_tick          (tEnvelopeFollower* const follower, float input)
      @brief Tick the tEnvelopeFollower.
      @param follower A pointer to the relevant tEnvelopeFollower.
@@ -90,11 +95,111 @@ extern "C" {
     void    tEnvelopeFollower_init          (tEnvelopeFollower* const follower, float attackThreshold, float decayCoefficient, LEAF* const leaf);
     void    tEnvelopeFollower_initToPool    (tEnvelopeFollower* const follower, float attackThreshold, float decayCoefficient, tMempool* const mempool);
     void    tEnvelopeFollower_free          (tEnvelopeFollower* const follower);
+#define tEnvelopeFollower_getRequiredSize() LEAF_MEMPOOL_BLOCK_SIZE(sizeof(_tEnvelopeFollower))
     
     float   tEnvelopeFollower_tick          (tEnvelopeFollower* const follower, float sample);
     void    tEnvelopeFollower_setDecayCoefficient    (tEnvelopeFollower* const follower, float decayCoefficient);
     void    tEnvelopeFollower_setAttackThreshold  (tEnvelopeFollower* const follower, float attackThreshold);
     
+    // ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~
+    
+    /*!
+     @defgroup tenvelopefollowerbank tEnvelopeFollowerBank
+     @ingroup analysis
+     @brief Any number of tEnvelopeFollowers sharing settings, for metering many channels at once.
+     @details The channels are processed four at a time with SIMD from interleaved or planar blocks. Alongside the envelopes the bank keeps a meter value per channel, the highest envelope since the last meter update, which is refreshed at a rate set with tEnvelopeFollowerBank_setMeterRate().
+     @{
+     
+     @fn void    tEnvelopeFollowerBank_init          (tEnvelopeFollowerBank* const, int numChannels, float attackThreshold, float decayCoeff, LEAF* const leaf)
+     @brief Initialize a tEnvelopeFollowerBank to the default mempool of a LEAF instance.
+     @param bank A pointer to the tEnvelopeFollowerBank to initialize.
+     @param numChannels The number of channels.
+     @param attackThreshold Amplitude threshold for determining an upcoming attack.
+     @param decayCoeff Decay coefficient.
+     @param leaf A pointer to the leaf instance.
+     
+     @fn void    tEnvelopeFollowerBank_initToPool    (tEnvelopeFollowerBank* const, int numChannels, float attackThreshold, float decayCoeff, tMempool* const)
+     @brief Initialize a tEnvelopeFollowerBank to a specified mempool.
+     @param bank A pointer to the tEnvelopeFollowerBank to initialize.
+     @param numChannels The number of channels.
+     @param attackThreshold Amplitude threshold for determining an upcoming attack.
+     @param decayCoeff Decay coefficient.
+     @param mempool A pointer to the tMempool to use.
+     
+     @fn void    tEnvelopeFollowerBank_free          (tEnvelopeFollowerBank* const)
+     @brief Free a tEnvelopeFollowerBank from its mempool.
+     @param bank A pointer to the tEnvelopeFollowerBank to free.
+     
+     @fn int     tEnvelopeFollowerBank_tickInterleaved (tEnvelopeFollowerBank* const, const float* input, int size)
+     @brief Process a block of interleaved frames.
+     @param bank A pointer to the relevant tEnvelopeFollowerBank.
+     @param input size frames of numChannels samples each.
+     @param size The number of frames.
+     @return The number of meter updates during the block.
+     
+     @fn int     tEnvelopeFollowerBank_tickPlanar    (tEnvelopeFollowerBank* const, const float* const* input, int size)
+     @brief Process a block with a separate buffer per channel.
+     @param bank A pointer to the relevant tEnvelopeFollowerBank.
+     @param input numChannels buffers of size samples each.
+     @param size The number of samples per channel.
+     @return The number of meter updates during the block.
+     
+     @fn float*  tEnvelopeFollowerBank_getValues     (tEnvelopeFollowerBank* const)
+     @brief Get the envelope of each channel after the last sample processed.
+     @param bank A pointer to the relevant tEnvelopeFollowerBank.
+     @return An array of numChannels envelopes.
+     
+     @fn float*  tEnvelopeFollowerBank_getMeters     (tEnvelopeFollowerBank* const)
+     @brief Get the meter value of each channel from the last meter update.
+     @param bank A pointer to the relevant tEnvelopeFollowerBank.
+     @return An array of numChannels meter values.
+     
+     @fn void    tEnvelopeFollowerBank_setMeterRate  (tEnvelopeFollowerBank* const, float rate)
+     @brief Set how often the meter values are updated. Default is 30Hz.
+     @param bank A pointer to the relevant tEnvelopeFollowerBank.
+     @param rate The update rate in Hz.
+     
+     @fn void    tEnvelopeFollowerBank_setDecayCoefficient    (tEnvelopeFollowerBank* const, float decayCoeff)
+     @brief Set the decay coefficient of every channel.
+     @param bank A pointer to the relevant tEnvelopeFollowerBank.
+     @param decayCoeff The new decay coefficient.
+     
+     @fn void    tEnvelopeFollowerBank_setAttackThreshold  (tEnvelopeFollowerBank* const, float attackThresh)
+     @brief Set the attack threshold of every channel.
+     @param bank A pointer to the relevant tEnvelopeFollowerBank.
+     @param attackThresh The new attack threshold.
+     ￼￼￼
+     @} */
+    
+    typedef struct _tEnvelopeFollowerBank
+    {
+        
+        tMempool mempool;
+        int numChannels;
+        float* y;           // envelopes, padded to a multiple of four channels
+        float* peak;        // highest envelopes since the last meter update
+        float* meter;
+        float* scratch;
+        float a_thresh;
+        float d_coeff;
+        int meterInterval, meterCount;
+        float sampleRate;
+    } _tEnvelopeFollowerBank;
+    
+    typedef _tEnvelopeFollowerBank* tEnvelopeFollowerBank;
+    
+    void    tEnvelopeFollowerBank_init          (tEnvelopeFollowerBank* const, int numChannels, float attackThreshold, float decayCoeff, LEAF* const leaf);
+    void    tEnvelopeFollowerBank_initToPool    (tEnvelopeFollowerBank* const, int numChannels, float attackThreshold, float decayCoeff, tMempool* const);
+    void    tEnvelopeFollowerBank_free          (tEnvelopeFollowerBank* const);
+    
+    int     tEnvelopeFollowerBank_tickInterleaved (tEnvelopeFollowerBank* const, const float* input, int size);
+    int     tEnvelopeFollowerBank_tickPlanar    (tEnvelopeFollowerBank* const, const float* const* input, int size);
+    float*  tEnvelopeFollowerBank_getValues     (tEnvelopeFollowerBank* const);
+    float*  tEnvelopeFollowerBank_getMeters     (tEnvelopeFollowerBank* const);
+    void    tEnvelopeFollowerBank_setMeterRate  (tEnvelopeFollowerBank* const, float rate);
+    void    tEnvelopeFollowerBank_setDecayCoefficient    (tEnvelopeFollowerBank* const, float decayCoeff);
+    void    tEnvelopeFollowerBank_setAttackThreshold  (tEnvelopeFollowerBank* const, float attackThresh);
+    
     /*!
      @defgroup tzerocrossingcounter tZeroCrossingCounter
      @ingroup analysis
@@ -117,6 +222,11 @@ extern "C" {
      @brief Free a tZeroCrossingCounter from its mempool.
      @param counter A pointer to the tZeroCrossingCounter to free.
      
+     @fn size_t  tZeroCrossingCounter_getRequiredSize (int maxWindowSize)
+     @brief Get the bytes tZeroCrossingCounter_initToPool() allocates from a first-fit mempool for the given parameters, as a constant expression that can size static memory.
+     @param maxWindowSize The maxWindowSize the tZeroCrossingCounter will be initialized with.
+     @return The size in bytes.
+     
      @fn float   tZeroCrossingCounter_tick         (tZeroCrossingCounter* const counter, float input)
      @brief Tick the tZeroCrossingCounter.
      @param counter A pointer to the relevant tZeroCrossingCounter.
@@ -150,6 +260,7 @@ extern "C" {
     void    tZeroCrossingCounter_init         (tZeroCrossingCounter* const, int maxWindowSize, LEAF* const leaf);
     void    tZeroCrossingCounter_initToPool   (tZeroCrossingCounter* const, int maxWindowSize, tMempool* const mempool);
     void    tZeroCrossingCounter_free         (tZeroCrossingCounter* const);
+#define tZeroCrossingCounter_getRequiredSize(maxWindowSize) (LEAF_MEMPOOL_BLOCK_SIZE(sizeof(_tZeroCrossingCounter)) + LEAF_MEMPOOL_BLOCK_SIZE(sizeof(float) * (maxWindowSize)) + LEAF_MEMPOOL_BLOCK_SIZE(sizeof(uint16_t) * (maxWindowSize)))
     
     float   tZeroCrossingCounter_tick         (tZeroCrossingCounter* const, float input);
     void    tZeroCrossingCounter_setWindowSize    (tZeroCrossingCounter* const, float windowSize);
@@ -178,6 +289,10 @@ extern "C" {
      @brief Free a tPowerFollower from its mempool.
      @param follower A pointer to the tPowerFollower to free.
      
+     @fn size_t  tPowerFollower_getRequiredSize (void)
+     @brief Get the bytes tPowerFollower_initToPool() allocates from a first-fit mempool, as a constant expression that can size static memory.
+     @return The size in bytes.
+     
      @fn float   tPowerFollower_tick         (tPowerFollower* const, float input)
      @brief Pass a sample into the power follower and return the current power.
      @param follower A pointer to the relevant tPowerFollower.
@@ -211,6 +326,7 @@ extern "C" {
     void    tPowerFollower_init         (tPowerFollower* const, float factor, LEAF* const leaf);
     void    tPowerFollower_initToPool   (tPowerFollower* const, float factor, tMempool* const);
     void    tPowerFollower_free         (tPowerFollower* const);
+#define tPowerFollower_getRequiredSize() LEAF_MEMPOOL_BLOCK_SIZE(sizeof(_tPowerFollower))
     
     float   tPowerFollower_tick         (tPowerFollower* const, float input);
     float   tPowerFollower_getPower     (tPowerFollower* const);
@@ -218,6 +334,96 @@ extern "C" {
     
     // ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~
     
+    /*!
+     @defgroup tpowerfollowerbank tPowerFollowerBank
+     @ingroup analysis
+     @brief Any number of tPowerFollowers sharing a smoothing factor, for metering many channels at once.
+     @details Works like tEnvelopeFollowerBank: channels are processed four at a time from interleaved or planar blocks and the meter values are the highest power since the last meter update.
+     @{
+     
+     @fn void    tPowerFollowerBank_init         (tPowerFollowerBank* const, int numChannels, float factor, LEAF* const leaf)
+     @brief Initialize a tPowerFollowerBank to the default mempool of a LEAF instance.
+     @param bank A pointer to the tPowerFollowerBank to initialize.
+     @param numChannels The number of channels.
+     @param factor Smoothing factor of the moving average. 0.0-1.0, with a higher value discounting older inputs more quickly.
+     @param leaf A pointer to the leaf instance.
+     
+     @fn void    tPowerFollowerBank_initToPool   (tPowerFollowerBank* const, int numChannels, float factor, tMempool* const)
+     @brief Initialize a tPowerFollowerBank to a specified mempool.
+     @param bank A pointer to the tPowerFollowerBank to initialize.
+     @param numChannels The number of channels.
+     @param factor Smoothing factor of the moving average. 0.0-1.0, with a higher value discounting older inputs more quickly.
+     @param mempool A pointer to the tMempool to use.
+     
+     @fn void    tPowerFollowerBank_free         (tPowerFollowerBank* const)
+     @brief Free a tPowerFollowerBank from its mempool.
+     @param bank A pointer to the tPowerFollowerBank to free.
+     
+     @fn int     tPowerFollowerBank_tickInterleaved (tPowerFollowerBank* const, const float* input, int size)
+     @brief Process a block of interleaved frames.
+     @param bank A pointer to the relevant tPowerFollowerBank.
+     @param input size frames of numChannels samples each.
+     @param size The number of frames.
+     @return The number of meter updates during the block.
+     
+     @fn int     tPowerFollowerBank_tickPlanar   (tPowerFollowerBank* const, const float* const* input, int size)
+     @brief Process a block with a separate buffer per channel.
+     @param bank A pointer to the relevant tPowerFollowerBank.
+     @param input numChannels buffers of size samples each.
+     @param size The number of samples per channel.
+     @return The number of meter updates during the block.
+     
+     @fn float*  tPowerFollowerBank_getValues    (tPowerFollowerBank* const)
+     @brief Get the power of each channel after the last sample processed.
+     @param bank A pointer to the relevant tPowerFollowerBank.
+     @return An array of numChannels powers.
+     
+     @fn float*  tPowerFollowerBank_getMeters    (tPowerFollowerBank* const)
+     @brief Get the meter value of each channel from the last meter update.
+     @param bank A pointer to the relevant tPowerFollowerBank.
+     @return An array of numChannels meter values.
+     
+     @fn void    tPowerFollowerBank_setMeterRate (tPowerFollowerBank* const, float rate)
+     @brief Set how often the meter values are updated. Default is 30Hz.
+     @param bank A pointer to the relevant tPowerFollowerBank.
+     @param rate The update rate in Hz.
+     
+     @fn void    tPowerFollowerBank_setFactor    (tPowerFollowerBank* const, float factor)
+     @brief Set the smoothing factor of every channel.
+     @param bank A pointer to the relevant tPowerFollowerBank.
+     @param factor Smoothing factor of the moving average. 0.0-1.0, with a higher value discounting older inputs more quickly.
+     ￼￼￼
+     @} */
+    
+    typedef struct _tPowerFollowerBank
+    {
+        
+        tMempool mempool;
+        int numChannels;
+        float* curr;        // powers, padded to a multiple of four channels
+        float* peak;        // highest powers since the last meter update
+        float* meter;
+        float* scratch;
+        float factor, oneminusfactor;
+        int meterInterval, meterCount;
+        float sampleRate;
+    } _tPowerFollowerBank;
+    
+    typedef _tPowerFollowerBank* tPowerFollowerBank;
+    
+    void    tPowerFollowerBank_init         (tPowerFollowerBank* const, int numChannels, float factor, LEAF* const leaf);
+    void    tPowerFollowerBank_initToPool   (tPowerFollowerBank* const, int numChannels, float factor, tMempool* const);
+    void    tPowerFollowerBank_free         (tPowerFollowerBank* const);
+    
+    int     tPowerFollowerBank_tickInterleaved (tPowerFollowerBank* const, const float* input, int size);
+    int     tPowerFollowerBank_tickPlanar   (tPowerFollowerBank* const, const float* const* input, int size);
+    float*  tPowerFollowerBank_getValues    (tPowerFollowerBank* const);
+    float*  tPowerFollowerBank_getMeters    (tPowerFollowerBank* const);
+    void    tPowerFollowerBank_setMeterRate (tPowerFollowerBank* const, float rate);
+    void    tPowerFollowerBank_setFactor    (tPowerFollowerBank* const, float factor);
+    
+    // ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~
+    
     /*!
      @defgroup tenvpd tEnvPD
      @ingroup analysis
@@ -252,6 +458,11 @@ extern "C" {
      @brief
      @param env
      @param inputBlock
+     
+     @fn void    tEnvPD_processView      (tEnvPD* const, LEAFBufferView in)
+     @brief Analyze channel 0 of a buffer view, such as one channel of an interleaved DMA buffer, as tEnvPD_processBlock does.
+     @param env A pointer to the relevant tEnvPD.
+     @param in The input view, with blockSize frames.
      ￼￼￼
      @} */
     
@@ -284,6 +495,7 @@ extern "C" {
     
     float   tEnvPD_tick             (tEnvPD* const);
     void    tEnvPD_processBlock     (tEnvPD* const, float* in);
+    void    tEnvPD_processView      (tEnvPD* const, LEAFBufferView in);
     
     // ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~
     
@@ -407,6 +619,20 @@ extern "C" {
      @param overlap
      @param mempool A pointer to the tMempool to use.
      
+     @fn void    tSNAC_initWithFrameSize (tSNAC* const, int overlaparg, int framesize, LEAF* const leaf)
+     @brief Initialize a tSNAC with a given analysis frame size to the default mempool of a LEAF instance.
+     @param snac A pointer to the tSNAC to initialize.
+     @param overlap
+     @param framesize The analysis frame size, rounded up to a power of two up to SNAC_MAX_FRAME_SIZE. The longest detectable period is SEEK times this, so use 2048 to track bass below about 55 Hz at 48 kHz. The autocorrelation is computed with a tRealFFT of twice this size, so cost grows as N log N.
+     @param leaf A pointer to the leaf instance.
+     
+     @fn void    tSNAC_initToPoolWithFrameSize (tSNAC* const, int overlaparg, int framesize, tMempool* const)
+     @brief Initialize a tSNAC with a given analysis frame size to a specified mempool.
+     @param snac A pointer to the tSNAC to initialize.
+     @param overlap
+     @param framesize The analysis frame size, rounded up to a power of two up to SNAC_MAX_FRAME_SIZE.
+     @param mempool A pointer to the tMempool to use.
+     
      @fn void    tSNAC_free          (tSNAC* const)
      @brief Free a tSNAC from its mempool.
      @param snac A pointer to the tSNAC to free.
@@ -446,6 +672,7 @@ extern "C" {
      @} */
     
 #define SNAC_FRAME_SIZE 1024           // default analysis framesize // should be the same as (or smaller than?) PS_FRAME_SIZE
+#define SNAC_MAX_FRAME_SIZE 8192       // largest analysis framesize
 #define DEFOVERLAP 1                // default overlap
 #define DEFBIAS 0.2f        // default bias
 #define DEFMINRMS 0.003f   // default minimum RMS
@@ -454,6 +681,7 @@ extern "C" {
     typedef struct _tSNAC
     {
         tMempool mempool;
+        tRealFFT fft;
         
         float* inputbuf;
         float* processbuf;
@@ -475,6 +703,8 @@ extern "C" {
     
     void    tSNAC_init          (tSNAC* const, int overlaparg, LEAF* const leaf);
     void    tSNAC_initToPool    (tSNAC* const, int overlaparg, tMempool* const);
+    void    tSNAC_initWithFrameSize (tSNAC* const, int overlaparg, int framesize, LEAF* const leaf);
+    void    tSNAC_initToPoolWithFrameSize (tSNAC* const, int overlaparg, int framesize, tMempool* const);
     void    tSNAC_free          (tSNAC* const);
     
     void    tSNAC_ioSamples     (tSNAC *s, float *in, int size);
@@ -510,6 +740,24 @@ extern "C" {
      @param frameSize
      @param mempool A pointer to the tMempool to use.
      
+     @fn void    tPeriodDetection_initWithAnalysisSize (tPeriodDetection* const, float* in, int bufSize, int frameSize, int analysisSize, LEAF* const leaf)
+     @brief Initialize a tPeriodDetection with a given tSNAC analysis frame size to the default mempool of a LEAF instance. Frames longer than frameSize are overlapped so the period is still updated every frameSize samples.
+     @param detection A pointer to the tPeriodDetection to initialize.
+     @param in
+     @param bufferSize
+     @param frameSize
+     @param analysisSize The tSNAC analysis frame size. See tSNAC_initWithFrameSize.
+     @param leaf A pointer to the leaf instance.
+     
+     @fn void    tPeriodDetection_initToPoolWithAnalysisSize (tPeriodDetection* const, float* in, int bufSize, int frameSize, int analysisSize, tMempool* const)
+     @brief Initialize a tPeriodDetection with a given tSNAC analysis frame size to a specified mempool.
+     @param detection A pointer to the tPeriodDetection to initialize.
+     @param in
+     @param bufferSize
+     @param frameSize
+     @param analysisSize The tSNAC analysis frame size. See tSNAC_initWithFrameSize.
+     @param mempool A pointer to the tMempool to use.
+     
      @fn void    tPeriodDetection_free               (tPeriodDetection* const)
      @brief Free a tPeriodDetection from its mempool.
      @param detection A pointer to the tPeriodDetection to free.
@@ -601,6 +849,8 @@ extern "C" {
     
     void    tPeriodDetection_init               (tPeriodDetection* const, float* in, int bufSize, int frameSize, LEAF* const leaf);
     void    tPeriodDetection_initToPool         (tPeriodDetection* const, float* in, int bufSize, int frameSize, tMempool* const);
+    void    tPeriodDetection_initWithAnalysisSize (tPeriodDetection* const, float* in, int bufSize, int frameSize, int analysisSize, LEAF* const leaf);
+    void    tPeriodDetection_initToPoolWithAnalysisSize (tPeriodDetection* const, float* in, int bufSize, int frameSize, int analysisSize, tMempool* const);
     void    tPeriodDetection_free               (tPeriodDetection* const);
     
     float   tPeriodDetection_tick               (tPeriodDetection* const, float sample);
@@ -635,6 +885,7 @@ extern "C" {
     void    tZeroCrossingInfo_init  (tZeroCrossingInfo* const, LEAF* const leaf);
     void    tZeroCrossingInfo_initToPool    (tZeroCrossingInfo* const, tMempool* const);
     void    tZeroCrossingInfo_free  (tZeroCrossingInfo* const);
+#define tZeroCrossingInfo_getRequiredSize() LEAF_MEMPOOL_BLOCK_SIZE(sizeof(_tZeroCrossingInfo))
     
     int     tZeroCrossingInfo_tick(tZeroCrossingInfo* const, float s);
     int     tZeroCrossingInfo_getState(tZeroCrossingInfo* const);
@@ -730,8 +981,10 @@ extern "C" {
     void    tBACF_init  (tBACF* const bacf, tBitset* const bitset, LEAF* const leaf);
     void    tBACF_initToPool    (tBACF* const bacf, tBitset* const bitset, tMempool* const mempool);
     void    tBACF_free  (tBACF* const bacf);
+#define tBACF_getRequiredSize() LEAF_MEMPOOL_BLOCK_SIZE(sizeof(_tBACF))
     
     int     tBACF_getCorrelation    (tBACF* const bacf, int pos);
+    void    tBACF_getCorrelations   (tBACF* const bacf, int start, int end, int* counts);
     void    tBACF_set  (tBACF* const bacf, tBitset* const bitset);
     
     //==============================================================================
@@ -789,6 +1042,12 @@ extern "C" {
      @param detector A pointer to the relevant tPeriodDetector.
      @param hysteresis The hysteresis in decibels. Defaults to -40db.
      
+     @fn void    tPeriodDetector_setSearchRange   (tPeriodDetector* const detector, float minPeriod, float maxPeriod)
+     @brief Only autocorrelate periods within a range, for example around the last period found. This cuts the cost of each analysis when the pitch is known to move slowly.
+     @param detector A pointer to the relevant tPeriodDetector.
+     @param minPeriod The shortest period to consider in samples, or 0 for no limit.
+     @param maxPeriod The longest period to consider in samples, or 0 for no limit.
+     
      @} */
     
 #define PULSE_THRESHOLD 0.6f
@@ -848,6 +1107,9 @@ extern "C" {
         float                   lowestFreq;
         float                   highestFreq;
         
+        int                     _search_min;
+        int                     _search_max;
+        
         tBACF                   _bacf;
         
     } _tPeriodDetector;
@@ -870,6 +1132,7 @@ extern "C" {
 
     void    tPeriodDetector_setHysteresis   (tPeriodDetector* const detector, float hysteresis);
     void    tPeriodDetector_setSampleRate   (tPeriodDetector* const detector, float sr);
+    void    tPeriodDetector_setSearchRange  (tPeriodDetector* const detector, float minPeriod, float maxPeriod);
     
     //==============================================================================
     
@@ -924,6 +1187,12 @@ extern "C" {
      @brief Set the hysteresis used in zero crossing detection.
      @param detector A pointer to the relevant tPitchDetector.
      @param hysteresis The hysteresis in decibels. Defaults to -40db.
+     
+     @fn void    tPitchDetector_setSearchRange   (tPitchDetector* const detector, float lowFreq, float highFreq)
+     @brief Only search for pitches within a range, for example an octave either side of the last one found. See tPeriodDetector_setSearchRange().
+     @param detector A pointer to the relevant tPitchDetector.
+     @param lowFreq The lowest frequency to consider in Hz, or 0 for no limit.
+     @param highFreq The highest frequency to consider in Hz, or 0 for no limit.
      ￼￼￼
      @} */
     
@@ -965,6 +1234,7 @@ extern "C" {
     
     void    tPitchDetector_setHysteresis    (tPitchDetector* const detector, float hysteresis);
     void    tPitchDetector_setSampleRate    (tPitchDetector* const detector, float sr);
+    void    tPitchDetector_setSearchRange   (tPitchDetector* const detector, float lowFreq, float highFreq);
     
     //==============================================================================
     
@@ -977,7 +1247,7 @@ extern "C" {
      @fn void tDualPitchDetector_init (tDualPitchDetector* const detector, float lowestFreq, float highestFreq, float* inBuffer, int bufSize, LEAF* const leaf)
      @brief Initialize a tDualPitchDetector to the default mempool of a LEAF instance.
      @param detector A pointer to the relevant tDualPitchDetector.
-     @param lowestFreq
+     @param lowestFreq The lowest frequency to track. Below about 55 Hz at 48 kHz a longer SNAC analysis frame is used, at a higher CPU cost per analysis.
      @param highestFreq
      @param inputBuffer A buffer of float to store input to the pitch detector.
      @param bufferSize Size of the input buffer.
@@ -1031,7 +1301,32 @@ extern "C" {
      @brief Set the threshold for periodicity of a signal to be considered as pitched.
      @param detector A pointer to the relevant tDualPitchDetector.
      @param threshold The periodicity threshold from 0.0 to 1.0 with 1.0 being perfectly periodic.
-     ￼￼￼
+     
+     @fn void    tDualPitchDetector_setCaptureSize (tDualPitchDetector* const detector, int size)
+     @brief Allocate the capture buffer that lets analysis run away from the audio thread, or free it with a size of 0.
+     @details Once set, the audio thread calls tDualPitchDetector_capture() and tDualPitchDetector_receive(), and a lower priority task or another core calls tDualPitchDetector_analyse(). Neither side ever waits on the other and estimates arrive one hop behind the inline tick. The other functions of the object belong to the analysis side from then on. Call this before either side starts.
+     @param detector A pointer to the relevant tDualPitchDetector.
+     @param size The number of samples the analysis side may fall behind by, rounded up to a power of two. Should cover a few hops plus however long the analysis task can be held off.
+     
+     @fn int     tDualPitchDetector_capture (tDualPitchDetector* const detector, const float* input, int size)
+     @brief Hand a block of input to the analysis side. Audio thread only.
+     @param detector A pointer to the relevant tDualPitchDetector.
+     @param input The input samples.
+     @param size The number of samples.
+     @return The number of samples taken, less than size only if the analysis side has fallen a whole capture buffer behind.
+     
+     @fn int     tDualPitchDetector_analyse (tDualPitchDetector* const detector)
+     @brief Run the detector over everything captured so far and publish each new estimate. Analysis side only.
+     @param detector A pointer to the relevant tDualPitchDetector.
+     @return The number of hops analysed.
+     
+     @fn int     tDualPitchDetector_receive (tDualPitchDetector* const detector, float* frequency, float* periodicity)
+     @brief Fetch the newest published estimate. Audio thread only.
+     @param detector A pointer to the relevant tDualPitchDetector.
+     @param frequency Set to the detected frequency, or left at the last received one when nothing new has been published. May be NULL.
+     @param periodicity Set to the periodicity of the input, in the same way. May be NULL.
+     @return 1 if an estimate arrived since the last call, otherwise 0.
+     
      @} */
 
     typedef struct _tDualPitchDetector
@@ -1050,6 +1345,17 @@ extern "C" {
         
         float sampleRate;
 
+        float* capture;
+        uint32_t captureMask;
+        volatile uint32_t captureWrite;
+        volatile uint32_t captureRead;
+        
+        // Triple buffer, the shared slot index has bit 2 set when it holds something unread
+        _pitch_info mailbox[3];
+        volatile uint32_t mailboxShared;
+        uint32_t mailboxWrite;
+        uint32_t mailboxRead;
+        
     } _tDualPitchDetector;
     
     typedef _tDualPitchDetector* tDualPitchDetector;
@@ -1068,6 +1374,11 @@ extern "C" {
     void    tDualPitchDetector_setPeriodicityThreshold (tDualPitchDetector* const detector, float thresh);
     void    tDualPitchDetector_setSampleRate    (tDualPitchDetector* const detector, float sr);
     
+    void    tDualPitchDetector_setCaptureSize   (tDualPitchDetector* const detector, int size);
+    int     tDualPitchDetector_capture  (tDualPitchDetector* const detector, const float* input, int size);
+    int     tDualPitchDetector_analyse  (tDualPitchDetector* const detector);
+    int     tDualPitchDetector_receive  (tDualPitchDetector* const detector, float* frequency, float* periodicity);
+    
 #ifdef __cplusplus
 }
 #endif
@@ -28,6 +28,13 @@ extern "C" {
     
     //==============================================================================
     
+#define LEAF_DELAY_SMEAR(x, shift) ((x) | ((x) >> (shift)))
+    
+    //! Round a delay length up to a power of two, as the Pow2 inits and tHermiteDelay do, as a constant expression.
+#define LEAF_DELAY_POW2(n) (LEAF_DELAY_SMEAR(LEAF_DELAY_SMEAR(LEAF_DELAY_SMEAR(LEAF_DELAY_SMEAR(LEAF_DELAY_SMEAR((uint32_t) (n) - 1, 1), 2), 4), 8), 16) + 1)
+    
+    //==============================================================================
+    
     /*!
      @defgroup tdelay tDelay
      @ingroup delay
@@ -48,10 +55,29 @@ extern "C" {
      @param maxLength
      @param mempool A pointer to the tMempool to use.
      
+     @fn void        tDelay_initPow2  (tDelay* const, uint32_t delay, uint32_t maxDelay, LEAF* const leaf)
+     @brief Initialize a tDelay to the default mempool of a LEAF instance, with its buffer rounded up to a power of two so it can wrap with a mask instead of a compare or modulo. The delay can then be set up to the rounded length.
+     @param delay A pointer to the tDelay to initialize.
+     @param initialLength
+     @param maxLength
+     @param leaf A pointer to the leaf instance.
+     
+     @fn void        tDelay_initToPoolPow2(tDelay* const, uint32_t delay, uint32_t maxDelay, tMempool* const)
+     @brief Initialize a tDelay to a specified mempool, with its buffer rounded up to a power of two as in tDelay_initPow2().
+     @param delay A pointer to the tDelay to initialize.
+     @param initialLength
+     @param maxLength
+     @param mempool A pointer to the tMempool to use.
+     
      @fn void        tDelay_free         (tDelay* const)
      @brief Free a tDelay from its mempool.
      @param delay A pointer to the tDelay to free.
      
+     @fn size_t  tDelay_getRequiredSize (uint32_t maxDelay)
+     @brief Get the bytes tDelay_initToPool() allocates from a first-fit mempool for the given parameters, as a constant expression that can size static memory.
+     @param maxDelay The maxDelay the tDelay will be initialized with.
+     @return The size in bytes.
+     
      @fn void        tDelay_clear        (tDelay* const)
      @brief
      @param delay A pointer to the relevant tDelay.
@@ -108,7 +134,7 @@ extern "C" {
         tMempool mempool;
         
         float gain;
-        float* buff;
+        leaf_sample_t* buff;
         
         float lastOut, lastIn;
         
@@ -116,13 +142,19 @@ extern "C" {
         
         uint32_t delay, maxDelay;
         
+        // 0, or maxDelay - 1 when maxDelay is a power of two
+        uint32_t bufferMask;
+        
     } _tDelay;
     
     typedef _tDelay* tDelay;
     
     void        tDelay_init         (tDelay* const, uint32_t delay, uint32_t maxDelay, LEAF* const leaf);
     void        tDelay_initToPool   (tDelay* const, uint32_t delay, uint32_t maxDelay, tMempool* const);
+    void        tDelay_initPow2  (tDelay* const, uint32_t delay, uint32_t maxDelay, LEAF* const leaf);
+    void        tDelay_initToPoolPow2(tDelay* const, uint32_t delay, uint32_t maxDelay, tMempool* const);
     void        tDelay_free         (tDelay* const);
+#define tDelay_getRequiredSize(maxDelay) (LEAF_MEMPOOL_BLOCK_SIZE(sizeof(_tDelay)) + LEAF_MEMPOOL_BLOCK_SIZE(sizeof(leaf_sample_t) * (maxDelay)))
     
     void        tDelay_clear        (tDelay* const);
     void        tDelay_setDelay     (tDelay* const, uint32_t delay);
@@ -156,10 +188,29 @@ extern "C" {
      @param maxLength
      @param mempool A pointer to the tMempool to use.
      
+     @fn void    tLinearDelay_initPow2  (tLinearDelay* const, float delay, uint32_t maxDelay, LEAF* const leaf)
+     @brief Initialize a tLinearDelay to the default mempool of a LEAF instance, with its buffer rounded up to a power of two so it can wrap with a mask instead of a compare or modulo. The delay can then be set up to the rounded length.
+     @param delay A pointer to the tLinearDelay to initialize.
+     @param initialLength
+     @param maxLength
+     @param leaf A pointer to the leaf instance.
+     
+     @fn void    tLinearDelay_initToPoolPow2(tLinearDelay* const, float delay, uint32_t maxDelay, tMempool* const)
+     @brief Initialize a tLinearDelay to a specified mempool, with its buffer rounded up to a power of two as in tLinearDelay_initPow2().
+     @param delay A pointer to the tLinearDelay to initialize.
+     @param initialLength
+     @param maxLength
+     @param mempool A pointer to the tMempool to use.
+     
      @fn void    tLinearDelay_free        (tLinearDelay* const)
      @brief Free a tLinearDelay from its mempool.
      @param delay A pointer to the tLinearDelay to free.
      
+     @fn size_t  tLinearDelay_getRequiredSize (uint32_t maxDelay)
+     @brief Get the bytes tLinearDelay_initToPool() allocates from a first-fit mempool for the given parameters, as a constant expression that can size static memory.
+     @param maxDelay The maxDelay the tLinearDelay will be initialized with.
+     @return The size in bytes.
+     
      @fn void    tLinearDelay_clear         (tLinearDelay* const dl)
      @brief
      @param delay A pointer to the relevant tLinearDelay.
@@ -226,13 +277,14 @@ extern "C" {
         tMempool mempool;
         
         float gain;
-        float* buff;
+        leaf_sample_t* buff;
         
         float lastOut, lastIn;
         
         uint32_t inPoint, outPoint;
         
         uint32_t maxDelay;
+        uint32_t bufferMask;
         
         float delay;
         
@@ -244,7 +296,10 @@ extern "C" {
     
     void    tLinearDelay_init        (tLinearDelay* const, float delay, uint32_t maxDelay, LEAF* const leaf);
     void    tLinearDelay_initToPool  (tLinearDelay* const, float delay, uint32_t maxDelay, tMempool* const);
+    void    tLinearDelay_initPow2  (tLinearDelay* const, float delay, uint32_t maxDelay, LEAF* const leaf);
+    void    tLinearDelay_initToPoolPow2(tLinearDelay* const, float delay, uint32_t maxDelay, tMempool* const);
     void    tLinearDelay_free        (tLinearDelay* const);
+#define tLinearDelay_getRequiredSize(maxDelay) (LEAF_MEMPOOL_BLOCK_SIZE(sizeof(_tLinearDelay)) + LEAF_MEMPOOL_BLOCK_SIZE(sizeof(leaf_sample_t) * (maxDelay)))
     
     void    tLinearDelay_clear         (tLinearDelay* const dl);
     void    tLinearDelay_setDelay    (tLinearDelay* const, float delay);
@@ -286,6 +341,11 @@ extern "C" {
      @brief Free a tHermiteDelay from its mempool.
      @param delay A pointer to the tHermiteDelay to free.
      
+     @fn size_t  tHermiteDelay_getRequiredSize (uint32_t maxDelay)
+     @brief Get the bytes tHermiteDelay_initToPool() allocates from a first-fit mempool for the given parameters, as a constant expression that can size static memory.
+     @param maxDelay The maxDelay the tHermiteDelay will be initialized with, before it's rounded up to a power of two.
+     @return The size in bytes.
+     
      @fn void    tHermiteDelay_clear            (tHermiteDelay* const dl)
      @brief
      @param delay A pointer to the relevant tHermiteDelay.
@@ -368,7 +428,7 @@ extern "C" {
     {
         tMempool mempool;
         
-        float* buff;
+        leaf_sample_t* buff;
         uint32_t bufferMask;
         float lastOut, lastIn;
         
@@ -386,6 +446,7 @@ extern "C" {
     void    tHermiteDelay_init (tHermiteDelay* const dl, float delay, uint32_t maxDelay, LEAF* const leaf);
     void    tHermiteDelay_initToPool (tHermiteDelay* const dl, float delay, uint32_t maxDelay, tMempool* const mp);
     void    tHermiteDelay_free          (tHermiteDelay* const dl);
+#define tHermiteDelay_getRequiredSize(maxDelay) (LEAF_MEMPOOL_BLOCK_SIZE(sizeof(_tHermiteDelay)) + LEAF_MEMPOOL_BLOCK_SIZE(sizeof(leaf_sample_t) * LEAF_DELAY_POW2(maxDelay)))
     
     void    tHermiteDelay_clear         (tHermiteDelay* const dl);
     float   tHermiteDelay_tick          (tHermiteDelay* const dl, float input);
@@ -425,10 +486,29 @@ extern "C" {
      @param maxLength
      @param mempool A pointer to the tMempool to use.
      
+     @fn void    tAllpassDelay_initPow2  (tAllpassDelay* const, float delay, uint32_t maxDelay, LEAF* const leaf)
+     @brief Initialize a tAllpassDelay to the default mempool of a LEAF instance, with its buffer rounded up to a power of two so it can wrap with a mask instead of a compare or modulo. The delay can then be set up to the rounded length.
+     @param delay A pointer to the tAllpassDelay to initialize.
+     @param initialLength
+     @param maxLength
+     @param leaf A pointer to the leaf instance.
+     
+     @fn void    tAllpassDelay_initToPoolPow2(tAllpassDelay* const, float delay, uint32_t maxDelay, tMempool* const)
+     @brief Initialize a tAllpassDelay to a specified mempool, with its buffer rounded up to a power of two as in tAllpassDelay_initPow2().
+     @param delay A pointer to the tAllpassDelay to initialize.
+     @param initialLength
+     @param maxLength
+     @param mempool A pointer to the tMempool to use.
+     
      @fn void    tAllpassDelay_free        (tAllpassDelay* const)
      @brief Free a tAllpassDelay from its mempool.
      @param delay A pointer to the tAllpassDelay to free.
      
+     @fn size_t  tAllpassDelay_getRequiredSize (uint32_t maxDelay)
+     @brief Get the bytes tAllpassDelay_initToPool() allocates from a first-fit mempool for the given parameters, as a constant expression that can size static memory.
+     @param maxDelay The maxDelay the tAllpassDelay will be initialized with.
+     @return The size in bytes.
+     
      @fn void    tAllpassDelay_clear       (tAllpassDelay* const)
      @brief
      @param delay A pointer to the relevant tAllpassDelay.
@@ -485,13 +565,14 @@ extern "C" {
         tMempool mempool;
         
         float gain;
-        float* buff;
+        leaf_sample_t* buff;
         
         float lastOut, lastIn;
         
         uint32_t inPoint, outPoint;
         
         uint32_t maxDelay;
+        uint32_t bufferMask;
         
         float delay;
         
@@ -505,7 +586,10 @@ extern "C" {
     
     void    tAllpassDelay_init        (tAllpassDelay* const, float delay, uint32_t maxDelay, LEAF* const leaf);
     void    tAllpassDelay_initToPool  (tAllpassDelay* const, float delay, uint32_t maxDelay, tMempool* const);
+    void    tAllpassDelay_initPow2  (tAllpassDelay* const, float delay, uint32_t maxDelay, LEAF* const leaf);
+    void    tAllpassDelay_initToPoolPow2(tAllpassDelay* const, float delay, uint32_t maxDelay, tMempool* const);
     void    tAllpassDelay_free        (tAllpassDelay* const);
+#define tAllpassDelay_getRequiredSize(maxDelay) (LEAF_MEMPOOL_BLOCK_SIZE(sizeof(_tAllpassDelay)) + LEAF_MEMPOOL_BLOCK_SIZE(sizeof(leaf_sample_t) * (maxDelay)))
     
     void    tAllpassDelay_clear       (tAllpassDelay* const);
     void    tAllpassDelay_setDelay    (tAllpassDelay* const, float delay);
@@ -539,10 +623,29 @@ extern "C" {
      @param maxLength
      @param mempool A pointer to the tMempool to use.
      
+     @fn void    tTapeDelay_initPow2  (tTapeDelay* const, float delay, uint32_t maxDelay, LEAF* const leaf)
+     @brief Initialize a tTapeDelay to the default mempool of a LEAF instance, with its buffer rounded up to a power of two so it can wrap with a mask instead of a compare or modulo. The delay can then be set up to the rounded length.
+     @param delay A pointer to the tTapeDelay to initialize.
+     @param initialLength
+     @param maxLength
+     @param leaf A pointer to the leaf instance.
+     
+     @fn void    tTapeDelay_initToPoolPow2(tTapeDelay* const, float delay, uint32_t maxDelay, tMempool* const)
+     @brief Initialize a tTapeDelay to a specified mempool, with its buffer rounded up to a power of two as in tTapeDelay_initPow2().
+     @param delay A pointer to the tTapeDelay to initialize.
+     @param initialLength
+     @param maxLength
+     @param mempool A pointer to the tMempool to use.
+     
      @fn void    tTapeDelay_free        (tTapeDelay* const)
      @brief Free a tTapeDelay from its mempool.
      @param delay A pointer to the tTapeDelay to free.
      
+     @fn size_t  tTapeDelay_getRequiredSize (uint32_t maxDelay)
+     @brief Get the bytes tTapeDelay_initToPool() allocates from a first-fit mempool for the given parameters, as a constant expression that can size static memory.
+     @param maxDelay The maxDelay the tTapeDelay will be initialized with.
+     @return The size in bytes.
+     
      @fn void    tTapeDelay_clear       (tTapeDelay* const)
      @brief 
      @param delay A pointer to the relevant tTapeDelay.
@@ -603,13 +706,14 @@ extern "C" {
         tMempool mempool;
         
         float gain;
-        float* buff;
+        leaf_sample_t* buff;
         
         float lastOut, lastIn;
         
         uint32_t inPoint;
         
         uint32_t maxDelay;
+        uint32_t bufferMask;
         
         float delay, inc, idx;
         
@@ -621,7 +725,10 @@ extern "C" {
     
     void    tTapeDelay_init        (tTapeDelay* const, float delay, uint32_t maxDelay, LEAF* const leaf);
     void    tTapeDelay_initToPool  (tTapeDelay* const, float delay, uint32_t maxDelay, tMempool* const);
+    void    tTapeDelay_initPow2  (tTapeDelay* const, float delay, uint32_t maxDelay, LEAF* const leaf);
+    void    tTapeDelay_initToPoolPow2(tTapeDelay* const, float delay, uint32_t maxDelay, tMempool* const);
     void    tTapeDelay_free        (tTapeDelay* const);
+#define tTapeDelay_getRequiredSize(maxDelay) (LEAF_MEMPOOL_BLOCK_SIZE(sizeof(_tTapeDelay)) + LEAF_MEMPOOL_BLOCK_SIZE(sizeof(leaf_sample_t) * (maxDelay)))
     
     void    tTapeDelay_clear       (tTapeDelay* const);
     void    tTapeDelay_setDelay    (tTapeDelay* const, float delay);
@@ -708,6 +815,135 @@ extern "C" {
     float   tRingBuffer_get      (tRingBuffer* const ring, int index);
     int     tRingBuffer_getSize  (tRingBuffer* const ring);
     
+    //==============================================================================
+    
+    /*!
+     @defgroup tmultitapdelay tMultiTapDelay
+     @ingroup delay
+     @brief Delay line with any number of read taps on one tRingBuffer.
+     @details Each sample is written once and every tap reads from the same buffer, which is a power of two long and indexed with a mask. Each tap has its own delay, gain, and interpolation, and the block functions work through the taps a tap at a time so each one reads through the buffer in order.
+     @{
+     
+     @fn void    tMultiTapDelay_init        (tMultiTapDelay* const, uint32_t maxDelay, int numTaps, LEAF* const leaf)
+     @brief Initialize a tMultiTapDelay to the default mempool of a LEAF instance.
+     @param delay A pointer to the tMultiTapDelay to initialize.
+     @param maxDelay The maximum delay of any tap in samples.
+     @param numTaps The number of taps. They start spread evenly up to maxDelay, with a gain of 1 and linear interpolation.
+     @param leaf A pointer to the leaf instance.
+     
+     @fn void    tMultiTapDelay_initToPool  (tMultiTapDelay* const, uint32_t maxDelay, int numTaps, tMempool* const)
+     @brief Initialize a tMultiTapDelay to a specified mempool.
+     @param delay A pointer to the tMultiTapDelay to initialize.
+     @param maxDelay The maximum delay of any tap in samples.
+     @param numTaps The number of taps.
+     @param mempool A pointer to the tMempool to use.
+     
+     @fn void    tMultiTapDelay_free        (tMultiTapDelay* const)
+     @brief Free a tMultiTapDelay from its mempool.
+     @param delay A pointer to the tMultiTapDelay to free.
+     
+     @fn void    tMultiTapDelay_clear       (tMultiTapDelay* const)
+     @brief Clear the delay line.
+     @param delay A pointer to the relevant tMultiTapDelay.
+     
+     @fn float   tMultiTapDelay_tick        (tMultiTapDelay* const, float input)
+     @brief Write a sample to the delay line and read all the taps.
+     @param delay A pointer to the relevant tMultiTapDelay.
+     @param input The input sample.
+     @return The sum of the taps, each scaled by its gain.
+     
+     @fn float   tMultiTapDelay_tapOut      (tMultiTapDelay* const, int tap)
+     @brief Read a single tap as of the last sample written.
+     @param delay A pointer to the relevant tMultiTapDelay.
+     @param tap The index of the tap.
+     @return The tap's output, scaled by its gain.
+     
+     @fn void    tMultiTapDelay_tickBlock   (tMultiTapDelay* const, const float* input, float* output, int size)
+     @brief Process a block of samples, with the same output as calling tMultiTapDelay_tick() for each of them.
+     @param delay A pointer to the relevant tMultiTapDelay.
+     @param input The input block.
+     @param output The output block, which may be the same as input.
+     @param size The number of samples in the block.
+     
+     @fn void    tMultiTapDelay_tickBlockTaps   (tMultiTapDelay* const, const float* input, float** outputs, int size)
+     @brief Process a block of samples, giving each tap its own output block.
+     @param delay A pointer to the relevant tMultiTapDelay.
+     @param input The input block.
+     @param outputs An array of one output block per tap, each scaled by its tap's gain. The first may be the same as input.
+     @param size The number of samples in the block.
+     
+     @fn void    tMultiTapDelay_setTapDelay (tMultiTapDelay* const, int tap, float delay)
+     @brief Set the delay of a tap.
+     @param delay A pointer to the relevant tMultiTapDelay.
+     @param tap The index of the tap.
+     @param delayLength The delay in samples, from 0 to the max delay given on initialization. Hermite taps are held to at least 1.
+     
+     @fn float   tMultiTapDelay_getTapDelay (tMultiTapDelay* const, int tap)
+     @brief Get the delay of a tap.
+     @param delay A pointer to the relevant tMultiTapDelay.
+     @param tap The index of the tap.
+     @return The delay in samples.
+     
+     @fn void    tMultiTapDelay_setTapGain  (tMultiTapDelay* const, int tap, float gain)
+     @brief Set the gain of a tap.
+     @param delay A pointer to the relevant tMultiTapDelay.
+     @param tap The index of the tap.
+     @param gain The gain.
+     
+     @fn void    tMultiTapDelay_setTapInterpolation (tMultiTapDelay* const, int tap, MultiTapInterpolation interpolation)
+     @brief Set how a tap reads between samples.
+     @param delay A pointer to the relevant tMultiTapDelay.
+     @param tap The index of the tap.
+     @param interpolation MultiTapNone to read whole samples only, MultiTapLinear, or MultiTapHermite.
+     
+     @fn int     tMultiTapDelay_getNumTaps  (tMultiTapDelay* const)
+     @brief Get the number of taps.
+     @param delay A pointer to the relevant tMultiTapDelay.
+     @return The number of taps.
+     ￼￼￼
+     @} */
+    
+    typedef enum MultiTapInterpolation
+    {
+        MultiTapNone = 0,
+        MultiTapLinear,
+        MultiTapHermite,
+        MultiTapInterpolationNil
+    } MultiTapInterpolation;
+
+#define MULTITAP_BLOCK 64
+
+    typedef struct _tMultiTapDelay
+    {
+        tMempool mempool;
+        
+        tRingBuffer ring;
+        
+        uint32_t maxDelay;
+        
+        int numTaps;
+        float* delays;
+        float* gains;
+        MultiTapInterpolation* interpolation;
+    } _tMultiTapDelay;
+    
+    typedef _tMultiTapDelay* tMultiTapDelay;
+    
+    void    tMultiTapDelay_init        (tMultiTapDelay* const, uint32_t maxDelay, int numTaps, LEAF* const leaf);
+    void    tMultiTapDelay_initToPool  (tMultiTapDelay* const, uint32_t maxDelay, int numTaps, tMempool* const);
+    void    tMultiTapDelay_free        (tMultiTapDelay* const);
+    
+    void    tMultiTapDelay_clear       (tMultiTapDelay* const);
+    float   tMultiTapDelay_tick        (tMultiTapDelay* const, float input);
+    float   tMultiTapDelay_tapOut      (tMultiTapDelay* const, int tap);
+    void    tMultiTapDelay_tickBlock   (tMultiTapDelay* const, const float* input, float* output, int size);
+    void    tMultiTapDelay_tickBlockTaps   (tMultiTapDelay* const, const float* input, float** outputs, int size);
+    void    tMultiTapDelay_setTapDelay (tMultiTapDelay* const, int tap, float delay);
+    float   tMultiTapDelay_getTapDelay (tMultiTapDelay* const, int tap);
+    void    tMultiTapDelay_setTapGain  (tMultiTapDelay* const, int tap, float gain);
+    void    tMultiTapDelay_setTapInterpolation (tMultiTapDelay* const, int tap, MultiTapInterpolation interpolation);
+    int     tMultiTapDelay_getNumTaps  (tMultiTapDelay* const);
+
 #ifdef __cplusplus
 }
 #endif
@@ -49,6 +49,10 @@ extern "C" {
      @brief Free a tSampleReducer from its mempool.
      @param reducer A pointer to the tSampleReducer to free.
      
+     @fn size_t  tSampleReducer_getRequiredSize (void)
+     @brief Get the bytes tSampleReducer_initToPool() allocates from a first-fit mempool, as a constant expression that can size static memory.
+     @return The size in bytes.
+     
      @fn float   tSampleReducer_tick    (tSampleReducer* const, float input)
      @brief
      @param reducer A pointer to the relevant tSampleReducer.
@@ -72,6 +76,7 @@ extern "C" {
     void    tSampleReducer_init    (tSampleReducer* const, LEAF* const leaf);
     void    tSampleReducer_initToPool   (tSampleReducer* const, tMempool* const);
     void    tSampleReducer_free    (tSampleReducer* const);
+#define tSampleReducer_getRequiredSize() LEAF_MEMPOOL_BLOCK_SIZE(sizeof(_tSampleReducer))
     
     float   tSampleReducer_tick    (tSampleReducer* const, float input);
     void    tSampleReducer_setRatio (tSampleReducer* const, float ratio);
@@ -106,10 +111,41 @@ extern "C" {
      @brief
      @param oversampler A pointer to the relevant tOversampler.
      
+     @fn void    tOversampler_upsampleBlock  (tOversampler* const, const float* input, float* output, int size)
+     @brief Upsample a block of samples. Output is the same as calling tOversampler_upsample on each sample, but the filter state is shifted once per block instead of once per sample. Initialize after LEAF_setBlockSize for the whole block to be filtered at once.
+     @param oversampler A pointer to the relevant tOversampler.
+     @param input The size input samples.
+     @param output The size * ratio upsampled output samples.
+     @param size The number of input samples.
+     
+     @fn void    tOversampler_downsampleBlock (tOversampler* const, const float* input, float* output, int size)
+     @brief Downsample a block of samples. Output is the same as calling tOversampler_downsample on each group of ratio samples.
+     @param oversampler A pointer to the relevant tOversampler.
+     @param input The size * ratio oversampled input samples.
+     @param output The size downsampled output samples.
+     @param size The number of output samples.
+     
      @fn float   tOversampler_tick           (tOversampler* const, float input, float* oversample, float (*effectTick)(float))
      @brief
      @param oversampler A pointer to the relevant tOversampler.
      
+     @fn void    tOversampler_processBlock   (tOversampler* const, const float* input, float* output, int size, void (*effectBlock)(void* ctx, float* buffer, int size), void* ctx)
+     @brief Upsample a block, run an effect once over the whole oversampled block, and downsample it back. Blocks up to LEAF's block size at initialization are handled in one pass; longer blocks are split. For example, to run a tLockhartWavefolder at 4x:
+     @code
+     void fold(void* ctx, float* buffer, int size)
+     {
+        for (int i = 0; i < size; i++) buffer[i] = tLockhartWavefolder_tick((tLockhartWavefolder*)ctx, buffer[i]);
+     }
+     ...
+     tOversampler_processBlock(&os, in, out, blockSize, fold, &wavefolder);
+     @endcode
+     @param oversampler A pointer to the relevant tOversampler.
+     @param input The input samples.
+     @param output The output samples. Can be the same as input.
+     @param size The number of input samples.
+     @param effectBlock The function to process the oversampled samples in place.
+     @param ctx A pointer passed through to effectBlock, usually the object it should tick.
+     
      @fn void    tOversampler_setRatio       (tOversampler* const, int ratio)
      @brief
      @param oversampler A pointer to the relevant tOversampler.
@@ -131,6 +167,10 @@ extern "C" {
         float* pCoeffs;
         float* upState;
         float* downState;
+        float* phaseCoeffs;
+        float* buffer;
+        int bufferSize;
+        int stateSize;
         int numTaps;
         int phaseLength;
     } _tOversampler;
@@ -143,8 +183,12 @@ extern "C" {
     
     void    tOversampler_upsample       (tOversampler* const, float input, float* output);
     float   tOversampler_downsample     (tOversampler* const, float* input);
+    void    tOversampler_upsampleBlock  (tOversampler* const, const float* input, float* output, int size);
+    void    tOversampler_downsampleBlock (tOversampler* const, const float* input, float* output, int size);
     float   tOversampler_tick           (tOversampler* const, float input, float* oversample,
                                          float (*effectTick)(float));
+    void    tOversampler_processBlock   (tOversampler* const, const float* input, float* output, int size,
+                                         void (*effectBlock)(void* ctx, float* buffer, int size), void* ctx);
     void    tOversampler_setRatio       (tOversampler* const, int ratio);
     void    tOversampler_setQuality     (tOversampler* const, int quality);
     int     tOversampler_getLatency     (tOversampler* const);
@@ -171,9 +215,20 @@ extern "C" {
      @brief Free a tLockhartWavefolder from its mempool.
      @param wavefolder A pointer to the tLockhartWavefolder to free.
      
+     @fn size_t  tLockhartWavefolder_getRequiredSize (void)
+     @brief Get the bytes tLockhartWavefolder_initToPool() allocates from a first-fit mempool, as a constant expression that can size static memory.
+     @return The size in bytes.
+     
      @fn float   tLockhartWavefolder_tick    (tLockhartWavefolder* const, float samp)
      @brief
      @param wavefolder A pointer to the relevant tLockhartWavefolder.
+     
+     @fn void    tLockhartWavefolder_tickBlock (tLockhartWavefolder* const, const float* input, float* output, int size)
+     @brief Fold a block of samples. The same as calling tLockhartWavefolder_tick() on each sample. The folder already does first order antiderivative antialiasing, so it needs less oversampling than a plain shaper.
+     @param wavefolder A pointer to the relevant tLockhartWavefolder.
+     @param input The input block.
+     @param output The output block. May be the same as the input.
+     @param size The number of samples.
      ￼￼￼
      @} */
     
@@ -214,8 +269,10 @@ extern "C" {
     void    tLockhartWavefolder_init    (tLockhartWavefolder* const, LEAF* const leaf);
     void    tLockhartWavefolder_initToPool   (tLockhartWavefolder* const, tMempool* const);
     void    tLockhartWavefolder_free    (tLockhartWavefolder* const);
+#define tLockhartWavefolder_getRequiredSize() LEAF_MEMPOOL_BLOCK_SIZE(sizeof(_tLockhartWavefolder))
     
     float   tLockhartWavefolder_tick    (tLockhartWavefolder* const, float samp);
+    void    tLockhartWavefolder_tickBlock (tLockhartWavefolder* const, const float* input, float* output, int size);
 
     //==============================================================================
 
@@ -239,6 +296,10 @@ extern "C" {
      @brief Free a tCrusher from its mempool.
      @param crusher A pointer to the tCrusher to free.
      
+     @fn size_t  tCrusher_getRequiredSize (void)
+     @brief Get the bytes tCrusher_initToPool() allocates from a first-fit mempool, as a constant expression that can size static memory.
+     @return The size in bytes.
+     
      @fn float   tCrusher_tick    (tCrusher* const, float input)
      @brief
      @param crusher A pointer to the relevant tCrusher.
@@ -286,6 +347,7 @@ extern "C" {
     void    tCrusher_init    (tCrusher* const, LEAF* const leaf);
     void    tCrusher_initToPool   (tCrusher* const, tMempool* const);
     void    tCrusher_free    (tCrusher* const);
+#define tCrusher_getRequiredSize() (LEAF_MEMPOOL_BLOCK_SIZE(sizeof(_tCrusher)) + tSampleReducer_getRequiredSize())
     
     float   tCrusher_tick    (tCrusher* const, float input);
     void    tCrusher_setOperation (tCrusher* const, float op);
@@ -295,6 +357,281 @@ extern "C" {
     
     //==============================================================================
     
+    /*!
+     @defgroup adaa Antiderivative antialiasing
+     @ingroup distortion
+     @brief Waveshapers that suppress their own aliasing.
+     @details These shapers use antiderivative antialiasing (ADAA). Instead of sampling the curve at each input, they output its average over the line between consecutive inputs. That cancels most of the aliasing a shaper adds, so they need 2x oversampling at most where a plain shaper would need 8x or 16x from tOversampler, and they sound fine at 1x for many parts.
+     
+     Order 1 averages over the last two inputs. It adds half a sample of delay, and where the curve is straight it is a two point average, which is 3 dB down at half of Nyquist.
+     
+     Order 2 averages that again over the last three inputs. It suppresses more and adds a full sample of delay. Where the curve is straight it is a three point average, which is 3 dB down at about a third of Nyquist, so it is best run inside a 2x tOversampler. It also costs more, because it works in double precision.
+     
+     Order 0 is the plain shaper, for comparison. Order can be changed while running without a click.
+     */
+    
+    typedef struct ADAAState
+    {
+        int shape;
+        int order;
+        float step; //!< Quantizer step.
+        double x1, x2; //!< The last two inputs, after drive.
+        double F1; //!< The antiderivative in use at x1.
+        double D1; //!< The divided difference of F2 between x2 and x1, order 2 only.
+    } ADAAState;
+    
+    /*!
+     @defgroup tadaasaturator tADAASaturator
+     @ingroup distortion
+     @brief Antialiased saturator. See @ref adaa.
+     @{
+     
+     @fn void    tADAASaturator_init         (tADAASaturator* const, LEAF* const leaf)
+     @brief Initialize a tADAASaturator to the default mempool of a LEAF instance. It starts as a first order ADAATanh with a drive of 1.
+     @param saturator A pointer to the tADAASaturator to initialize.
+     @param leaf A pointer to the leaf instance.
+     
+     @fn void    tADAASaturator_initToPool   (tADAASaturator* const, tMempool* const)
+     @brief Initialize a tADAASaturator to a specified mempool.
+     @param saturator A pointer to the tADAASaturator to initialize.
+     @param mempool A pointer to the tMempool to use.
+     
+     @fn void    tADAASaturator_free         (tADAASaturator* const)
+     @brief Free a tADAASaturator from its mempool.
+     @param saturator A pointer to the tADAASaturator to free.
+     
+     @fn size_t  tADAASaturator_getRequiredSize (void)
+     @brief Get the bytes tADAASaturator_initToPool() allocates from a first-fit mempool, as a constant expression that can size static memory.
+     @return The size in bytes.
+     
+     @fn float   tADAASaturator_tick         (tADAASaturator* const, float input)
+     @brief Shape one sample.
+     @param saturator A pointer to the relevant tADAASaturator.
+     @param input The input sample.
+     @return The shaped sample.
+     
+     @fn void    tADAASaturator_tickBlock    (tADAASaturator* const, const float* input, float* output, int size)
+     @brief Shape a block of samples. The same as calling tADAASaturator_tick() on each sample, but faster.
+     @param saturator A pointer to the relevant tADAASaturator.
+     @param input The input block.
+     @param output The output block. May be the same as the input.
+     @param size The number of samples.
+     
+     @fn void    tADAASaturator_setType      (tADAASaturator* const, ADAASaturatorType type)
+     @brief Set the curve.
+     @param saturator A pointer to the relevant tADAASaturator.
+     @param type ADAATanh is the curve of LEAF_tanh(), which reaches 1 at 3. ADAASoftClip is the cubic 1.5x - 0.5x^3, which reaches 1 at 1. ADAAHardClip clips at 1.
+     
+     @fn void    tADAASaturator_setOrder     (tADAASaturator* const, int order)
+     @brief Set the order of antialiasing.
+     @param saturator A pointer to the relevant tADAASaturator.
+     @param order 0, 1, or 2.
+     
+     @fn void    tADAASaturator_setDrive     (tADAASaturator* const, float drive)
+     @brief Set the gain applied before the curve.
+     @param saturator A pointer to the relevant tADAASaturator.
+     @param drive The input gain.
+     
+     @} */
+    
+    typedef enum ADAASaturatorType
+    {
+        ADAATanh = 0,
+        ADAASoftClip,
+        ADAAHardClip,
+        ADAASaturatorTypeNil
+    } ADAASaturatorType;
+    
+    typedef struct _tADAASaturator
+    {
+        tMempool mempool;
+        
+        float drive;
+        ADAAState adaa;
+    } _tADAASaturator;
+    
+    typedef _tADAASaturator* tADAASaturator;
+    
+    void    tADAASaturator_init         (tADAASaturator* const, LEAF* const leaf);
+    void    tADAASaturator_initToPool   (tADAASaturator* const, tMempool* const);
+    void    tADAASaturator_free         (tADAASaturator* const);
+#define tADAASaturator_getRequiredSize() LEAF_MEMPOOL_BLOCK_SIZE(sizeof(_tADAASaturator))
+    
+    float   tADAASaturator_tick         (tADAASaturator* const, float input);
+    void    tADAASaturator_tickBlock    (tADAASaturator* const, const float* input, float* output, int size);
+    void    tADAASaturator_setType      (tADAASaturator* const, ADAASaturatorType type);
+    void    tADAASaturator_setOrder     (tADAASaturator* const, int order);
+    void    tADAASaturator_setDrive     (tADAASaturator* const, float drive);
+    
+    //==============================================================================
+    
+    /*!
+     @defgroup tadaawavefolder tADAAWavefolder
+     @ingroup distortion
+     @brief Antialiased sine wavefolder. See @ref adaa.
+     @details Outputs sin(pi/2 * (drive * input + offset)), so an input at full scale reaches 1 at a drive of 1 and folds back once for each 2 of drive above that. The offset makes the folding asymmetric, which adds even harmonics. For an analog model there is tLockhartWavefolder, which already does first order ADAA but costs much more.
+     @{
+     
+     @fn void    tADAAWavefolder_init        (tADAAWavefolder* const, LEAF* const leaf)
+     @brief Initialize a tADAAWavefolder to the default mempool of a LEAF instance. It starts at first order with a drive of 1 and no offset.
+     @param wavefolder A pointer to the tADAAWavefolder to initialize.
+     @param leaf A pointer to the leaf instance.
+     
+     @fn void    tADAAWavefolder_initToPool  (tADAAWavefolder* const, tMempool* const)
+     @brief Initialize a tADAAWavefolder to a specified mempool.
+     @param wavefolder A pointer to the tADAAWavefolder to initialize.
+     @param mempool A pointer to the tMempool to use.
+     
+     @fn void    tADAAWavefolder_free        (tADAAWavefolder* const)
+     @brief Free a tADAAWavefolder from its mempool.
+     @param wavefolder A pointer to the tADAAWavefolder to free.
+     
+     @fn size_t  tADAAWavefolder_getRequiredSize (void)
+     @brief Get the bytes tADAAWavefolder_initToPool() allocates from a first-fit mempool, as a constant expression that can size static memory.
+     @return The size in bytes.
+     
+     @fn float   tADAAWavefolder_tick        (tADAAWavefolder* const, float input)
+     @brief Fold one sample.
+     @param wavefolder A pointer to the relevant tADAAWavefolder.
+     @param input The input sample.
+     @return The folded sample.
+     
+     @fn void    tADAAWavefolder_tickBlock   (tADAAWavefolder* const, const float* input, float* output, int size)
+     @brief Fold a block of samples. The same as calling tADAAWavefolder_tick() on each sample, but faster.
+     @param wavefolder A pointer to the relevant tADAAWavefolder.
+     @param input The input block.
+     @param output The output block. May be the same as the input.
+     @param size The number of samples.
+     
+     @fn void    tADAAWavefolder_setOrder    (tADAAWavefolder* const, int order)
+     @brief Set the order of antialiasing.
+     @param wavefolder A pointer to the relevant tADAAWavefolder.
+     @param order 0, 1, or 2.
+     
+     @fn void    tADAAWavefolder_setDrive    (tADAAWavefolder* const, float drive)
+     @brief Set the gain applied before folding.
+     @param wavefolder A pointer to the relevant tADAAWavefolder.
+     @param drive The input gain.
+     
+     @fn void    tADAAWavefolder_setOffset   (tADAAWavefolder* const, float offset)
+     @brief Set the offset added after the drive.
+     @param wavefolder A pointer to the relevant tADAAWavefolder.
+     @param offset The offset. An offset of 1 turns a quiet input into ones near the top of the fold.
+     
+     @} */
+    
+    typedef struct _tADAAWavefolder
+    {
+        tMempool mempool;
+        
+        float drive;
+        float offset;
+        ADAAState adaa;
+    } _tADAAWavefolder;
+    
+    typedef _tADAAWavefolder* tADAAWavefolder;
+    
+    void    tADAAWavefolder_init        (tADAAWavefolder* const, LEAF* const leaf);
+    void    tADAAWavefolder_initToPool  (tADAAWavefolder* const, tMempool* const);
+    void    tADAAWavefolder_free        (tADAAWavefolder* const);
+#define tADAAWavefolder_getRequiredSize() LEAF_MEMPOOL_BLOCK_SIZE(sizeof(_tADAAWavefolder))
+    
+    float   tADAAWavefolder_tick        (tADAAWavefolder* const, float input);
+    void    tADAAWavefolder_tickBlock   (tADAAWavefolder* const, const float* input, float* output, int size);
+    void    tADAAWavefolder_setOrder    (tADAAWavefolder* const, int order);
+    void    tADAAWavefolder_setDrive    (tADAAWavefolder* const, float drive);
+    void    tADAAWavefolder_setOffset   (tADAAWavefolder* const, float offset);
+    
+    //==============================================================================
+    
+    /*!
+     @defgroup tadaacrusher tADAACrusher
+     @ingroup distortion
+     @brief Antialiased bit crusher. See @ref adaa.
+     @details Takes the same quality, round, and sampling ratio settings as tCrusher. The clip and the rounding are antialiased; the rounding is the staircase that makes most of tCrusher's aliasing. Two parts of tCrusher are left out because their curves have no useful antiderivative: the bitwise operation, and the truncation to steps of 1/5000 before the gain. The sample rate reduction is kept and aliases just as it does in tCrusher, since that aliasing is the effect.
+     @{
+     
+     @fn void    tADAACrusher_init           (tADAACrusher* const, LEAF* const leaf)
+     @brief Initialize a tADAACrusher to the default mempool of a LEAF instance. It starts at first order with a quality of 1, rounding to 0.25, and no sample rate reduction.
+     @param crusher A pointer to the tADAACrusher to initialize.
+     @param leaf A pointer to the leaf instance.
+     
+     @fn void    tADAACrusher_initToPool     (tADAACrusher* const, tMempool* const)
+     @brief Initialize a tADAACrusher to a specified mempool.
+     @param crusher A pointer to the tADAACrusher to initialize.
+     @param mempool A pointer to the tMempool to use.
+     
+     @fn void    tADAACrusher_free           (tADAACrusher* const)
+     @brief Free a tADAACrusher from its mempool.
+     @param crusher A pointer to the tADAACrusher to free.
+     
+     @fn size_t  tADAACrusher_getRequiredSize (void)
+     @brief Get the bytes tADAACrusher_initToPool() allocates from a first-fit mempool, as a constant expression that can size static memory.
+     @return The size in bytes.
+     
+     @fn float   tADAACrusher_tick           (tADAACrusher* const, float input)
+     @brief Crush one sample.
+     @param crusher A pointer to the relevant tADAACrusher.
+     @param input The input sample.
+     @return The crushed sample.
+     
+     @fn void    tADAACrusher_tickBlock      (tADAACrusher* const, const float* input, float* output, int size)
+     @brief Crush a block of samples. The same as calling tADAACrusher_tick() on each sample, but faster.
+     @param crusher A pointer to the relevant tADAACrusher.
+     @param input The input block.
+     @param output The output block. May be the same as the input.
+     @param size The number of samples.
+     
+     @fn void    tADAACrusher_setOrder       (tADAACrusher* const, int order)
+     @brief Set the order of antialiasing.
+     @param crusher A pointer to the relevant tADAACrusher.
+     @param order 0, 1, or 2.
+     
+     @fn void    tADAACrusher_setQuality     (tADAACrusher* const, float val)
+     @brief Set the quality. Lower quality drives the input harder into the clip.
+     @param crusher A pointer to the relevant tADAACrusher.
+     @param quality 0.0 - 1.0
+     
+     @fn void    tADAACrusher_setRound       (tADAACrusher* const, float rnd)
+     @brief Set the step to round to, after the clip.
+     @param crusher A pointer to the relevant tADAACrusher.
+     @param rnd The step. 0 rounds nothing, leaving a plain clip.
+     
+     @fn void    tADAACrusher_setSamplingRatio (tADAACrusher* const, float ratio)
+     @brief Set the sample rate reduction, as in tSampleReducer.
+     @param crusher A pointer to the relevant tADAACrusher.
+     @param ratio The sampling ratio. 1 turns it off.
+     
+     @} */
+    
+    typedef struct _tADAACrusher
+    {
+        tMempool mempool;
+        
+        float srr;
+        float div;
+        float drive;
+        float gain;
+        ADAAState adaa;
+        tSampleReducer sReducer;
+    } _tADAACrusher;
+    
+    typedef _tADAACrusher* tADAACrusher;
+    
+    void    tADAACrusher_init           (tADAACrusher* const, LEAF* const leaf);
+    void    tADAACrusher_initToPool     (tADAACrusher* const, tMempool* const);
+    void    tADAACrusher_free           (tADAACrusher* const);
+#define tADAACrusher_getRequiredSize() (LEAF_MEMPOOL_BLOCK_SIZE(sizeof(_tADAACrusher)) + tSampleReducer_getRequiredSize())
+    
+    float   tADAACrusher_tick           (tADAACrusher* const, float input);
+    void    tADAACrusher_tickBlock      (tADAACrusher* const, const float* input, float* output, int size);
+    void    tADAACrusher_setOrder       (tADAACrusher* const, int order);
+    void    tADAACrusher_setQuality     (tADAACrusher* const, float val);
+    void    tADAACrusher_setRound       (tADAACrusher* const, float rnd);
+    void    tADAACrusher_setSamplingRatio (tADAACrusher* const, float ratio);
+    
+    //==============================================================================
+
 #ifdef __cplusplus
 }
 #endif
@@ -20,6 +20,7 @@ extern "C" {
 #include "leaf-math.h"
 #include "leaf-mempool.h"
 #include "leaf-analysis.h"
+#include "leaf-distortion.h"
     
     /*!
      * @internal
@@ -51,11 +52,41 @@ extern "C" {
      @brief Free a tCompressor from its mempool.
      @param compressor A pointer to the tCompressor to free.
      
+     @fn size_t  tCompressor_getRequiredSize (void)
+     @brief Get the bytes tCompressor_initToPool() allocates from a first-fit mempool, as a constant expression that can size static memory.
+     @return The size in bytes.
+     
      @fn float   tCompressor_tick        (tCompressor* const, float input)
      @brief
      @param compressor A pointer to the relevant tCompressor.
+     
+     @fn void    tCompressor_tickBlock   (tCompressor* const, const float* input, float* output, int size)
+     @brief Compress a block. The detector and gains are computed with fast log2 and exp2 approximations over the whole block, within 0.01dB of tCompressor_tick().
+     @param compressor A pointer to the relevant tCompressor.
+     @param input The input block.
+     @param output The output block, which may be the same as the input.
+     @param size The number of samples to process.
+     
+     @fn void    tCompressor_tickSidechainBlock (tCompressor* const, const float* input, const float* sidechain, float* output, int size)
+     @brief Compress a block according to the level of a separate sidechain signal.
+     @param compressor A pointer to the relevant tCompressor.
+     @param input The block to compress.
+     @param sidechain The block to detect from.
+     @param output The output block.
+     @param size The number of samples to process.
+     
+     @fn void    tCompressor_tickStereoBlock (tCompressor* const, const float* inL, const float* inR, float* outL, float* outR, int size)
+     @brief Compress a stereo block with both channels linked to the louder of the two.
+     @param compressor A pointer to the relevant tCompressor.
+     
+     @fn void    tCompressor_setLookahead (tCompressor* const, int samples)
+     @brief Delay the signal the block functions output so the gain can react ahead of it. This allocates, so call it at setup.
+     @param compressor A pointer to the relevant tCompressor.
+     @param samples The look-ahead in samples, or 0 for none.
      ￼￼￼
      @} */
+
+#define COMPRESSOR_BLOCK 64
    
     typedef struct _tCompressor
     {
@@ -69,6 +100,11 @@ extern "C" {
         
         int isActive;
         
+        float* lookahead;   // two channels of lookaheadSize samples
+        int lookaheadSize, lookaheadPos;
+        
+        float level[COMPRESSOR_BLOCK], gain[COMPRESSOR_BLOCK]; // scratch for the block functions
+        
         float sampleRate;
         
     } _tCompressor;
@@ -78,8 +114,13 @@ extern "C" {
     void    tCompressor_init        (tCompressor* const, LEAF* const leaf);
     void    tCompressor_initToPool  (tCompressor* const, tMempool* const);
     void    tCompressor_free        (tCompressor* const);
+#define tCompressor_getRequiredSize() LEAF_MEMPOOL_BLOCK_SIZE(sizeof(_tCompressor))
     
     float   tCompressor_tick        (tCompressor* const, float input);
+    void    tCompressor_tickBlock   (tCompressor* const, const float* input, float* output, int size);
+    void    tCompressor_tickSidechainBlock (tCompressor* const, const float* input, const float* sidechain, float* output, int size);
+    void    tCompressor_tickStereoBlock (tCompressor* const, const float* inL, const float* inR, float* outL, float* outR, int size);
+    void    tCompressor_setLookahead (tCompressor* const, int samples);
     
     
     /*!
@@ -103,6 +144,10 @@ extern "C" {
      @brief Free a tFeedbackLeveler from its mempool.
      @param leveler A pointer to the tFeedbackLeveler to free.
      
+     @fn size_t  tFeedbackLeveler_getRequiredSize (void)
+     @brief Get the bytes tFeedbackLeveler_initToPool() allocates from a first-fit mempool, as a constant expression that can size static memory.
+     @return The size in bytes.
+     
      @fn float   tFeedbackLeveler_tick           (tFeedbackLeveler* const, float input)
      @brief
      @param leveler A pointer to the relevant tFeedbackLeveler.
@@ -147,6 +192,7 @@ extern "C" {
     void    tFeedbackLeveler_init           (tFeedbackLeveler* const, float targetLevel, float factor, float strength, int mode, LEAF* const leaf);
     void    tFeedbackLeveler_initToPool     (tFeedbackLeveler* const, float targetLevel, float factor, float strength, int mode, tMempool* const);
     void    tFeedbackLeveler_free           (tFeedbackLeveler* const);
+#define tFeedbackLeveler_getRequiredSize() (LEAF_MEMPOOL_BLOCK_SIZE(sizeof(_tFeedbackLeveler)) + tPowerFollower_getRequiredSize())
     
     float   tFeedbackLeveler_tick           (tFeedbackLeveler* const, float input);
     float   tFeedbackLeveler_sample         (tFeedbackLeveler* const);
@@ -179,6 +225,10 @@ extern "C" {
      @brief Free a tThreshold from its mempool.
      @param threshold A pointer to the tThreshold to free.
      
+     @fn size_t  tThreshold_getRequiredSize (void)
+     @brief Get the bytes tThreshold_initToPool() allocates from a first-fit mempool, as a constant expression that can size static memory.
+     @return The size in bytes.
+     
      @fn int   tThreshold_tick        (tThreshold* const, float input)
      @brief
      @param threshold A pointer to the relevant tThreshold.
@@ -206,6 +256,7 @@ extern "C" {
     void    tThreshold_init        (tThreshold* const, float low, float high, LEAF* const leaf);
     void    tThreshold_initToPool  (tThreshold* const, float low, float high, tMempool* const);
     void    tThreshold_free        (tThreshold* const);
+#define tThreshold_getRequiredSize() LEAF_MEMPOOL_BLOCK_SIZE(sizeof(_tThreshold))
 
     int    tThreshold_tick        (tThreshold* const, float input);
     void   tThreshold_setLow        (tThreshold* const, float low);
@@ -213,6 +264,117 @@ extern "C" {
 
 
 
+    //==============================================================================
+    
+    /*!
+     @defgroup tlimiter tLimiter
+     @ingroup dynamics
+     @brief Look-ahead brickwall limiter.
+     @details The peak over the look-ahead window is tracked with a monotonic queue and the gain is
+     smoothed with a running average the length of the look-ahead, so the cost per sample doesn't
+     depend on the look-ahead and the gain is fully down by the time a peak reaches the output.
+     @{
+     
+     @fn void    tLimiter_init           (tLimiter* const, int lookahead, LEAF* const leaf)
+     @brief Initialize a tLimiter to the default mempool of a LEAF instance.
+     @param limiter A pointer to the tLimiter to initialize.
+     @param lookahead The look-ahead in samples, at least 1. This is also the latency.
+     @param leaf A pointer to the leaf instance.
+     
+     @fn void    tLimiter_initToPool     (tLimiter* const, int lookahead, tMempool* const)
+     @brief Initialize a tLimiter to a specified mempool.
+     @param limiter A pointer to the tLimiter to initialize.
+     @param lookahead The look-ahead in samples, at least 1. This is also the latency.
+     @param mempool A pointer to the tMempool to use.
+     
+     @fn void    tLimiter_free           (tLimiter* const)
+     @brief Free a tLimiter from its mempool.
+     @param limiter A pointer to the tLimiter to free.
+     
+     @fn float   tLimiter_tick           (tLimiter* const, float input)
+     @brief Limit one sample.
+     @param limiter A pointer to the relevant tLimiter.
+     @param input The input sample.
+     @return The limited sample, delayed by the latency.
+     
+     @fn void    tLimiter_tickBlock      (tLimiter* const, const float* input, float* output, int size)
+     @brief Limit a block of samples.
+     @param limiter A pointer to the relevant tLimiter.
+     @param input The input block.
+     @param output The output block, which may be the same as the input.
+     @param size The number of samples to process.
+     
+     @fn void    tLimiter_tickStereoBlock (tLimiter* const, const float* inL, const float* inR, float* outL, float* outR, int size)
+     @brief Limit a stereo block with both channels linked to the louder of the two.
+     @param limiter A pointer to the relevant tLimiter.
+     
+     @fn void    tLimiter_setCeiling     (tLimiter* const, float ceiling)
+     @brief Set the highest output amplitude. Default is 1.0.
+     @param limiter A pointer to the relevant tLimiter.
+     @param ceiling The ceiling as a linear amplitude.
+     
+     @fn void    tLimiter_setRelease     (tLimiter* const, float release)
+     @brief Set the release time. Default is 50ms.
+     @param limiter A pointer to the relevant tLimiter.
+     @param release The release time in milliseconds.
+     
+     @fn void    tLimiter_setTruePeak    (tLimiter* const, int ratio)
+     @brief Detect inter-sample peaks by oversampling the detector with tOversampler. This adds the oversampler's latency to the look-ahead and allocates, so call it at setup.
+     @param limiter A pointer to the relevant tLimiter.
+     @param ratio The oversampling ratio (2, 4, 8...), or 1 to only detect sample peaks. 4 keeps inter-sample peaks within about 0.5dB of the ceiling, 8 within 0.01dB.
+     
+     @fn int     tLimiter_getLatency     (tLimiter* const)
+     @brief Get the delay of the output in samples.
+     @param limiter A pointer to the relevant tLimiter.
+     
+     @} */
+
+#define LIMITER_BLOCK 64
+
+    typedef struct _tLimiter
+    {
+        tMempool mempool;
+        
+        float ceiling;
+        float release, releaseCoeff;
+        float sampleRate;
+        
+        int lookahead;      // length of the gain average
+        int truePeakDelay;  // extra delay for the oversampled detector
+        int window;         // lookahead + truePeakDelay + 1
+        
+        float* delay;       // two channels of lookahead + truePeakDelay samples
+        int delaySize, delayPos;
+        
+        float* peakValue;   // monotonic queue of the peaks in the window
+        uint32_t* peakTime;
+        int peakFront, peakCount;
+        uint32_t time;
+        
+        float* gains;       // the last lookahead gains and their sum
+        int gainPos;
+        double gainSum;
+        float gain;
+        
+        int ratio;
+        tOversampler oversampler[2];
+        float* oversampled;
+    } _tLimiter;
+    
+    typedef _tLimiter* tLimiter;
+    
+    void    tLimiter_init           (tLimiter* const, int lookahead, LEAF* const leaf);
+    void    tLimiter_initToPool     (tLimiter* const, int lookahead, tMempool* const);
+    void    tLimiter_free           (tLimiter* const);
+    
+    float   tLimiter_tick           (tLimiter* const, float input);
+    void    tLimiter_tickBlock      (tLimiter* const, const float* input, float* output, int size);
+    void    tLimiter_tickStereoBlock (tLimiter* const, const float* inL, const float* inR, float* outL, float* outR, int size);
+    void    tLimiter_setCeiling     (tLimiter* const, float ceiling);
+    void    tLimiter_setRelease     (tLimiter* const, float release);
+    void    tLimiter_setTruePeak    (tLimiter* const, int ratio);
+    int     tLimiter_getLatency     (tLimiter* const);
+    
     //////======================================================================
 
 #ifdef __cplusplus
@@ -1,5 +1,5 @@
 /*==============================================================================
- 
+
  leaf-effects.h
  
  
@@ -11,7 +11,7 @@
 #ifdef __cplusplus
 extern "C" {
 #endif
-    
+
     //==============================================================================
 #include "leaf-global.h"
 #include "leaf-math.h"
@@ -19,15 +19,16 @@ extern "C" {
 #include "leaf-dynamics.h"
 #include "leaf-analysis.h"
 #include "leaf-envelopes.h"
-    
-    
-    
+
+
+
     //==============================================================================
     
     /*!
      @defgroup ttalkbox tTalkbox
      @ingroup effects
      @brief High resolution vocoder from mda using Levinson-Durbin LPC algorithm.
+     @details The analysis is spread over the samples as they arrive, so no single tick does much more work than the rest.
      @{
      
      @fn void    tTalkbox_init           (tTalkbox* const, int bufsize, LEAF* const leaf)
@@ -89,9 +90,9 @@ extern "C" {
      @param talkbox A pointer to the relevant tTalkbox.
      
      @} */
-    
+
 #define NUM_TALKBOX_PARAM 4
-    
+
     typedef struct _tTalkbox
     {
         
@@ -106,6 +107,16 @@ extern "C" {
         float* buf0;
         float* buf1;
         float* k;
+        float* synthK;      // coefficients each of the two frames is resynthesized with
+        float* synthZ;      // and their lattice states, ORD_MAX apiece
+        float synthG[2];
+        int32_t synthO[2];  // order, or -1 while a frame is silent
+        float* acR;         // autocorrelation of each frame so far, ORD_MAX apiece
+        double* acRt;       // and the warped one with its allpass chain state
+        double* acR1;
+        double* acR2;
+        int32_t acN[2], acO[2], acWarpOn[2], acCount[2];
+        float acWarp[2];    // settings the autocorrelations are being accumulated with
         float warpFactor;
         int32_t warpOn;
         int freeze;
@@ -149,6 +160,7 @@ extern "C" {
      @defgroup ttalkboxfloat tTalkboxFloat
      @ingroup effects
      @brief High resolution vocoder from mda using Levinson-Durbin LPC algorithm.
+     @details The analysis is spread over the samples as they arrive, so no single tick does much more work than the rest.
      @{
      
      @fn void    tTalkboxFloat_init           (tTalkboxFloat* const, int bufsize, LEAF* const leaf)
@@ -225,6 +237,16 @@ extern "C" {
         float* buf0;
         float* buf1;
         float* k;
+        float* synthK;      // coefficients each of the two frames is resynthesized with
+        float* synthZ;      // and their lattice states, ORD_MAX apiece
+        float synthG[2];
+        int32_t synthO[2];  // order, or -1 while a frame is silent
+        float* acR;         // autocorrelation of each frame so far, ORD_MAX apiece
+        float* acRt;        // and the warped one with its allpass chain state
+        float* acR1;
+        float* acR2;
+        int32_t acN[2], acO[2], acWarpOn[2], acCount[2];
+        float acWarp[2];    // settings the autocorrelations are being accumulated with
         float warpFactor;
         int32_t warpOn;
         int freeze;
@@ -282,10 +304,22 @@ extern "C" {
      @brief Free a tVocoder from its mempool.
      @param vocoder A pointer to the tVocoder to free.
      
+     @fn size_t  tVocoder_getRequiredSize (void)
+     @brief Get the bytes tVocoder_initToPool() allocates from a first-fit mempool, as a constant expression that can size static memory.
+     @return The size in bytes.
+     
      @fn float   tVocoder_tick           (tVocoder* const, float synth, float voice)
      @brief
      @param vocoder A pointer to the relevant tVocoder.
      
+     @fn void    tVocoder_tickBlock      (tVocoder* const, const float* synth, const float* voice, float* output, int size)
+     @brief Process a block of carrier and modulator input. The filter bank bands run as SIMD lanes.
+     @param vocoder A pointer to the relevant tVocoder.
+     @param synth The carrier block.
+     @param voice The modulator block.
+     @param output The output block, which may alias either input.
+     @param size The number of samples to process.
+     
      @fn void    tVocoder_update         (tVocoder* const)
      @brief
      @param vocoder A pointer to the relevant tVocoder.
@@ -295,10 +329,11 @@ extern "C" {
      @param vocoder A pointer to the relevant tVocoder.
      
      @} */
-    
+
 #define NUM_VOCODER_PARAM 8
 #define NBANDS 16
-    
+#define VOCODER_LANES (NBANDS + 4) // room for the filter bank to run four bands at a time from band 1
+
     typedef struct _tVocoder
     {
         
@@ -313,7 +348,7 @@ extern "C" {
         int32_t  nbnd;      //number of bands
         
         //filter coeffs and buffers - seems it's faster to leave this global than make local copy
-        float f[NBANDS][13]; //[0-8][0 1 2 | 0 1 2 3 | 0 1 2 3 | val rate]
+        float f[13][VOCODER_LANES]; //[0 1 2 | 0 1 2 3 | 0 1 2 3 | val rate][band], bands as SIMD lanes
         
         float invSampleRate;
     } _tVocoder;
@@ -323,8 +358,10 @@ extern "C" {
     void    tVocoder_init           (tVocoder* const, LEAF* const leaf);
     void    tVocoder_initToPool     (tVocoder* const, tMempool* const);
     void    tVocoder_free           (tVocoder* const);
+#define tVocoder_getRequiredSize() LEAF_MEMPOOL_BLOCK_SIZE(sizeof(_tVocoder))
     
     float   tVocoder_tick           (tVocoder* const, float synth, float voice);
+    void    tVocoder_tickBlock      (tVocoder* const, const float* synth, const float* voice, float* output, int size);
     void    tVocoder_update         (tVocoder* const);
     void    tVocoder_suspend        (tVocoder* const);
     void    tVocoder_setSampleRate  (tVocoder* const, float sr);
@@ -351,6 +388,10 @@ extern "C" {
      @brief Free a tRosenbergGlottalPulse from its mempool.
      @param pulse A pointer to the tRosenbergGlottalPulse to free.
      
+     @fn size_t  tRosenbergGlottalPulse_getRequiredSize (void)
+     @brief Get the bytes tRosenbergGlottalPulse_initToPool() allocates from a first-fit mempool, as a constant expression that can size static memory.
+     @return The size in bytes.
+     
      @fn float   tRosenbergGlottalPulse_tick           (tRosenbergGlottalPulse* const)
      @brief
      @param pulse A pointer to the relevant tRosenbergGlottalPulse.
@@ -395,6 +436,7 @@ extern "C" {
     void    tRosenbergGlottalPulse_init           (tRosenbergGlottalPulse* const, LEAF* const leaf);
     void    tRosenbergGlottalPulse_initToPool     (tRosenbergGlottalPulse* const, tMempool* const);
     void    tRosenbergGlottalPulse_free           (tRosenbergGlottalPulse* const);
+#define tRosenbergGlottalPulse_getRequiredSize() LEAF_MEMPOOL_BLOCK_SIZE(sizeof(_tRosenbergGlottalPulse))
     
     float   tRosenbergGlottalPulse_tick           (tRosenbergGlottalPulse* const);
     float   tRosenbergGlottalPulse_tickHQ           (tRosenbergGlottalPulse* const gp);
@@ -424,12 +466,24 @@ extern "C" {
      @param solad A pointer to the tSOLAD to initialize.
      @param mempool A pointer to the tMempool to use.
      
+     @fn void    tSOLAD_initShared       (tSOLAD* const, tSOLAD* const source, LEAF* const leaf)
+     @brief Initialize a tSOLAD that reads from the input buffer of another tSOLAD instead of keeping its own. The highpass, buffering and attack detection then run once in the source, and this one only does its own resynthesis.
+     @param solad A pointer to the tSOLAD to initialize.
+     @param source A pointer to the tSOLAD whose input to share. It must outlive this one.
+     @param leaf A pointer to the leaf instance.
+     
+     @fn void    tSOLAD_initToPoolShared (tSOLAD* const, tSOLAD* const source, tMempool* const)
+     @brief Initialize a shared tSOLAD to a specified mempool.
+     @param solad A pointer to the tSOLAD to initialize.
+     @param source A pointer to the tSOLAD whose input to share. It must outlive this one.
+     @param mempool A pointer to the tMempool to use.
+     
      @fn void    tSOLAD_free             (tSOLAD* const)
      @brief Free a tSOLAD from its mempool.
      @param solad A pointer to the tSOLAD to free.
      
      @fn void    tSOLAD_ioSamples        (tSOLAD *w, float* in, float* out, int blocksize)
-     @brief Send one block of input samples, receive one block of output samples
+     @brief Send one block of input samples, receive one block of output samples. A shared tSOLAD ignores in and resynthesizes the block its source was last sent, so call it after the source's ioSamples each block.
      @param solad A pointer to the relevant tSOLAD.
      
      @fn void    tSOLAD_setPeriod        (tSOLAD *w, float period)
@@ -456,7 +510,7 @@ extern "C" {
 #define INITPERIOD 64.0f
     //#define MAXPERIOD (float)((LOOPSIZE - w->blocksize) * 0.8f)
 #define MINPERIOD 8.0f
-    
+
     typedef struct _tSOLAD
     {
         tMempool mempool;
@@ -473,8 +527,10 @@ extern "C" {
         float jump;               // read pointer jump length and direction
         float xfadelength;        // crossfade length expressed at input sample rate
         float xfadevalue;         // crossfade phase and value
+        int attack;               // whether an attack was detected in the last input block
         
         float* delaybuf;
+        struct _tSOLAD* source;   // owner of delaybuf when shared, else NULL
         
     } _tSOLAD;
     
@@ -482,6 +538,8 @@ extern "C" {
     
     void    tSOLAD_init             (tSOLAD* const, int loopSize, LEAF* const leaf);
     void    tSOLAD_initToPool       (tSOLAD* const, int loopSize, tMempool* const);
+    void    tSOLAD_initShared       (tSOLAD* const, tSOLAD* const source, LEAF* const leaf);
+    void    tSOLAD_initToPoolShared (tSOLAD* const, tSOLAD* const source, tMempool* const);
     void    tSOLAD_free             (tSOLAD* const);
     
     // send one block of input samples, receive one block of output samples
@@ -512,6 +570,18 @@ extern "C" {
      @param pitchshift A pointer to the tPitchShift to initialize.
      @param mempool A pointer to the tMempool to use.
      
+     @fn void    tPitchShift_initShared      (tPitchShift* const, tPitchShift* const source, LEAF* const leaf)
+     @brief Initialize a tPitchShift that shares the pitch detector and input buffer of another, as with tSOLAD_initShared(). Shift it after the source each block.
+     @param pitchshift A pointer to the tPitchShift to initialize.
+     @param source A pointer to the tPitchShift whose input to share.
+     @param leaf A pointer to the leaf instance.
+     
+     @fn void    tPitchShift_initToPoolShared (tPitchShift* const, tPitchShift* const source, tMempool* const)
+     @brief Initialize a shared tPitchShift to a specified mempool.
+     @param pitchshift A pointer to the tPitchShift to initialize.
+     @param source A pointer to the tPitchShift whose input to share.
+     @param mempool A pointer to the tMempool to use.
+     
      @fn void    tPitchShift_free            (tPitchShift* const)
      @brief Free a tPitchShift from its mempool.
      @param pitchshift A pointer to the tPitchShift to free.
@@ -555,6 +625,8 @@ extern "C" {
     
     void    tPitchShift_init (tPitchShift* const, tDualPitchDetector* const, int bufSize, LEAF* const leaf);
     void    tPitchShift_initToPool (tPitchShift* const, tDualPitchDetector* const, int bufSize, tMempool* const);
+    void    tPitchShift_initShared (tPitchShift* const, tPitchShift* const source, LEAF* const leaf);
+    void    tPitchShift_initToPoolShared (tPitchShift* const, tPitchShift* const source, tMempool* const);
     void    tPitchShift_free (tPitchShift* const);
     
     void    tPitchShift_shiftBy (tPitchShift* const, float factor, float* in, float* out);
@@ -563,6 +635,112 @@ extern "C" {
     void    tPitchShift_setPickiness (tPitchShift* const, float p);
     void    tPitchShift_setSampleRate(tPitchShift* const, float sr);
     
+    //==============================================================================
+    
+    /*!
+     @defgroup tphasevocoder tPhaseVocoder
+     @ingroup effects
+     @brief Phase vocoder pitch shifter with any number of output voices sharing one analysis.
+     @details Every hop, the last fftSize input samples are windowed and analysed once. Each voice then resynthesizes that spectrum with its bins moved by its pitch factor and its phases advanced to match. A full FFT and one inverse FFT per voice run every hop, so the cost is the same from block to block. Frames whose spectral flux is over the transient threshold reset the voices' phases to the input's, to keep attacks from smearing. Everything is allocated at init. The output lags the input by fftSize samples.
+     @{
+     
+     @fn void    tPhaseVocoder_init          (tPhaseVocoder* const, int fftSize, int overlap, int numVoices, LEAF* const leaf)
+     @brief Initialize a tPhaseVocoder to the default mempool of a LEAF instance.
+     @param pv A pointer to the tPhaseVocoder to initialize.
+     @param fftSize The analysis frame size, a power of two from 64 to 8192. Larger sizes resolve low notes better and smear transients more.
+     @param overlap The number of frames overlapping each sample, 4 or 8. The hop size is fftSize / overlap.
+     @param numVoices The number of shifted outputs.
+     @param leaf A pointer to the leaf instance.
+     
+     @fn void    tPhaseVocoder_initToPool    (tPhaseVocoder* const, int fftSize, int overlap, int numVoices, tMempool* const)
+     @brief Initialize a tPhaseVocoder to a specified mempool.
+     @param pv A pointer to the tPhaseVocoder to initialize.
+     @param fftSize The analysis frame size, a power of two from 64 to 8192.
+     @param overlap The number of frames overlapping each sample, 4 or 8.
+     @param numVoices The number of shifted outputs.
+     @param mempool A pointer to the tMempool to use.
+     
+     @fn void    tPhaseVocoder_free          (tPhaseVocoder* const)
+     @brief Free a tPhaseVocoder from its mempool.
+     @param pv A pointer to the tPhaseVocoder to free.
+     
+     @fn float*  tPhaseVocoder_tick          (tPhaseVocoder* const, float input)
+     @brief Process one sample.
+     @param pv A pointer to the relevant tPhaseVocoder.
+     @param input The input sample.
+     @return An array with one output sample per voice.
+     
+     @fn void    tPhaseVocoder_tickBlock     (tPhaseVocoder* const, const float* input, float** outputs, int size)
+     @brief Process a block of samples, with the same output as calling tPhaseVocoder_tick() for each of them.
+     @param pv A pointer to the relevant tPhaseVocoder.
+     @param input The input block.
+     @param outputs One output block per voice.
+     @param size The number of samples in the block.
+     
+     @fn void    tPhaseVocoder_setPitchFactor    (tPhaseVocoder* const, int voice, float factor)
+     @brief Set the pitch factor of a voice, taking effect from the next hop.
+     @param pv A pointer to the relevant tPhaseVocoder.
+     @param voice The voice to set.
+     @param factor The pitch factor from 0.25 to 4. 1 passes the input through unchanged apart from the latency.
+     
+     @fn void    tPhaseVocoder_setTransientThreshold (tPhaseVocoder* const, float threshold)
+     @brief Set how much of a frame's magnitude has to be new for it to count as a transient.
+     @param pv A pointer to the relevant tPhaseVocoder.
+     @param threshold The spectral flux over total magnitude, from 0 to 1. 1 turns transient detection off. Defaults to 0.3.
+     
+     @fn int     tPhaseVocoder_getLatency    (tPhaseVocoder* const)
+     @brief Get the delay between input and output.
+     @param pv A pointer to the relevant tPhaseVocoder.
+     @return The latency in samples.
+     
+     @} */
+    
+    typedef struct _tPhaseVocoder
+    {
+        tMempool mempool;
+        
+        tRealFFT fft;
+        int fftSize, hopSize, mask;
+        int numVoices;
+        
+        float* window;
+        float* inBuffer;
+        float* frame;
+        int writePos, hopCount;
+        
+        // Analysis, shared by all the voices
+        float* magnitude;
+        float* frequency; // in bins
+        float* phase;
+        float* lastPhase;
+        float* lastMagnitude;
+        float transientThreshold;
+        
+        // Scratch for resynthesizing each voice
+        float* shiftedMagnitude;
+        float* shiftedPhase;
+        float* strongest;
+        int* peaks;
+        
+        float* factors;
+        float** synthPhase;
+        float** outAccum;
+        float* output;
+        float outGain;
+    } _tPhaseVocoder;
+    
+    typedef _tPhaseVocoder* tPhaseVocoder;
+    
+    void    tPhaseVocoder_init          (tPhaseVocoder* const, int fftSize, int overlap, int numVoices, LEAF* const leaf);
+    void    tPhaseVocoder_initToPool    (tPhaseVocoder* const, int fftSize, int overlap, int numVoices, tMempool* const);
+    void    tPhaseVocoder_free          (tPhaseVocoder* const);
+    
+    float*  tPhaseVocoder_tick          (tPhaseVocoder* const, float input);
+    void    tPhaseVocoder_tickBlock     (tPhaseVocoder* const, const float* input, float** outputs, int size);
+    void    tPhaseVocoder_setPitchFactor    (tPhaseVocoder* const, int voice, float factor);
+    void    tPhaseVocoder_setTransientThreshold (tPhaseVocoder* const, float threshold);
+    int     tPhaseVocoder_getLatency    (tPhaseVocoder* const);
+    
     /*!
      @defgroup tsimpleretune tSimpleRetune
      @ingroup effects
@@ -636,11 +814,12 @@ extern "C" {
     void    tSimpleRetune_tuneVoice             (tSimpleRetune* const, int voice, float t);
     float   tSimpleRetune_getInputFrequency     (tSimpleRetune* const);
     void    tSimpleRetune_setSampleRate         (tSimpleRetune* const, float sr);
-
+    
     /*!
      @defgroup tretune tRetune
      @ingroup effects
      @brief Wrapper for multiple pitch shifters with multi-channel output.
+     @details The voices share one pitch detector and one input buffer, so adding a voice only adds its resynthesis.
      @{
      
      @fn void    tRetune_init                (tRetune* const, int numVoices, int bufSize, int frameSize, LEAF* const leaf)
@@ -661,6 +840,13 @@ extern "C" {
      @brief
      @param retune A pointer to the relevant tRetune.
      
+     @fn void    tRetune_tickBlock           (tRetune* const, const float* input, float** outputs, int size)
+     @brief Process a block of input, writing each voice to its own output buffer. The same as calling tRetune_tick() once per sample.
+     @param retune A pointer to the relevant tRetune.
+     @param input The input block.
+     @param outputs An array of numVoices output buffers, each at least size samples long.
+     @param size The number of samples to process.
+     
      @fn void    tRetune_setNumVoices        (tRetune* const, int numVoices)
      @brief
      @param retune A pointer to the relevant tRetune.
@@ -673,6 +859,12 @@ extern "C" {
      @brief
      @param retune A pointer to the relevant tRetune.
      
+     @fn void    tRetune_setPhaseVocoder     (tRetune* const, int fftSize, int overlap)
+     @brief Shift with a tPhaseVocoder instead of a tPitchShift per voice. All the voices share the vocoder's analysis, and the pitch detector still sets the factors when tuning to frequencies. This allocates, so call it at setup like tRetune_setNumVoices().
+     @param retune A pointer to the relevant tRetune.
+     @param fftSize The vocoder's frame size, as for tPhaseVocoder_init(), or 0 to go back to the tPitchShift engine.
+     @param overlap The vocoder's overlap, 4 or 8.
+     
      @} */
     
     typedef struct _tRetune
@@ -691,11 +883,16 @@ extern "C" {
         int index;
         
         float* output;
+        float** blockOutputs;
         
         void (*shiftFunction)(tPitchShift* const, float, float*, float*);
         
         float* shiftValues;
         int numVoices;
+        
+        // Used instead of ps when pvSize isn't 0
+        tPhaseVocoder pv;
+        int pvSize, pvOverlap;
     } _tRetune;
     
     typedef _tRetune* tRetune;
@@ -705,6 +902,7 @@ extern "C" {
     void    tRetune_free                (tRetune* const);
     
     float*  tRetune_tick                (tRetune* const, float sample);
+    void    tRetune_tickBlock           (tRetune* const, const float* input, float** outputs, int size);
     void    tRetune_setMode             (tRetune* const, int mode);
     void    tRetune_setNumVoices        (tRetune* const, int numVoices);
     void    tRetune_setPickiness        (tRetune* const, float p);
@@ -712,6 +910,7 @@ extern "C" {
     void    tRetune_tuneVoice           (tRetune* const, int voice, float t);
     float   tRetune_getInputFrequency   (tRetune* const);
     void    tRetune_setSampleRate       (tRetune* const, float sr);
+    void    tRetune_setPhaseVocoder     (tRetune* const, int fftSize, int overlap);
     
     //==============================================================================
     
@@ -808,7 +1007,7 @@ extern "C" {
     void    tFormantShifter_setSampleRate   (tFormantShifter* const fsr, float sr);
     
     //==============================================================================
-    
+
 #ifdef __cplusplus
 }
 #endif
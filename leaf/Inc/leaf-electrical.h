@@ -11,13 +11,13 @@
 #ifdef __cplusplus
 extern "C" {
 #endif
-    
+
     //==============================================================================
-    
+
 #include "leaf-global.h"
 #include "leaf-math.h"
 #include "leaf-mempool.h"
-    
+
     /*!
      * @internal
      * Header.
@@ -87,7 +87,7 @@ extern "C" {
      @fn float   tWDF_getCurrent             (tWDF* const)
      @brief
      @param wdf A pointer to the relevant tWDF.
-      
+     
      @} */
     
     typedef enum WDFComponentType
@@ -155,9 +155,142 @@ extern "C" {
     float   tWDF_getVoltage             (tWDF* const);
     float   tWDF_getCurrent             (tWDF* const);
     
-    
     //==============================================================================
     
+    /*!
+     @defgroup twdfprogram tWDFProgram
+     @ingroup electrical
+     @brief A tWDF tree compiled into flat arrays, evaluated without recursion or function pointers.
+     @details Initializing a tWDFProgram walks a built tWDF tree once and lays its nodes out children first, with their types, child indices, coefficients and waves in parallel arrays. Each sample is then one loop up the arrays, the root, and one loop back down, giving the same output as tWDF_tick() on the tree. Port resistances are only recomputed when a value has changed since the last tick. The tree is only read when compiling, so change component values through tWDFProgram_setValue() afterwards.
+     @{
+     
+     @fn void    tWDFProgram_init            (tWDFProgram* const, tWDF* const root, tWDF* const outputPoint, LEAF* const leaf)
+     @brief Initialize a tWDFProgram from a tWDF tree, to the default mempool of a LEAF instance.
+     @param prog A pointer to the tWDFProgram to initialize.
+     @param root The root of the tree, an IdealSource, Diode or DiodePair.
+     @param outputPoint The component whose voltage tWDFProgram_tick() returns.
+     @param leaf A pointer to the leaf instance.
+     
+     @fn void    tWDFProgram_initToPool      (tWDFProgram* const, tWDF* const root, tWDF* const outputPoint, tMempool* const)
+     @brief Initialize a tWDFProgram from a tWDF tree, to a specified mempool.
+     @param prog A pointer to the tWDFProgram to initialize.
+     @param root The root of the tree, an IdealSource, Diode or DiodePair.
+     @param outputPoint The component whose voltage tWDFProgram_tick() returns.
+     @param mempool A pointer to the tMempool to use.
+     
+     @fn void    tWDFProgram_free            (tWDFProgram* const)
+     @brief Free a tWDFProgram from its mempool. The tree it was compiled from is left alone.
+     @param prog A pointer to the tWDFProgram to free.
+     
+     @fn float   tWDFProgram_tick            (tWDFProgram* const, float sample)
+     @brief Process one sample.
+     @param prog A pointer to the relevant tWDFProgram.
+     @param sample The input to the sources.
+     @return The voltage at the output point.
+     
+     @fn void    tWDFProgram_tickBlock       (tWDFProgram* const, const float* input, float* output, int size)
+     @brief Process a block of samples.
+     @param prog A pointer to the relevant tWDFProgram.
+     @param input The input to the sources.
+     @param output The block to write the voltage at the output point to.
+     @param size The number of samples to process.
+     
+     @fn int     tWDFProgram_getIndex        (tWDFProgram* const, tWDF* const node)
+     @brief Find where a component of the tree was compiled to.
+     @param prog A pointer to the relevant tWDFProgram.
+     @param node The component.
+     @return The component's index, or -1 if it isn't in the tree.
+     
+     @fn void    tWDFProgram_setValue        (tWDFProgram* const, int index, float value)
+     @brief Set the value of a component. Port resistances are recomputed at the start of the next tick.
+     @param prog A pointer to the relevant tWDFProgram.
+     @param index The component, from tWDFProgram_getIndex().
+     @param value The new resistance, capacitance or inductance.
+     
+     @fn void    tWDFProgram_setSampleRate   (tWDFProgram* const, float sample_rate)
+     @brief
+     @param prog A pointer to the relevant tWDFProgram.
+     
+     @fn void    tWDFProgram_setRootTable    (tWDFProgram* const, int numWaves, float maxWave, int numResistances, float minResistance, float maxResistance)
+     @brief Replace the solver of a Diode or DiodePair root with an interpolated table of its reflected wave.
+     @details The table is allocated from the program's mempool. With one resistance it holds a single row for the root's current port resistance, rebuilt whenever that changes, which makes each change cost numWaves solves. With more it is a grid over log-spaced port resistances and is interpolated in both directions, so nothing needs rebuilding while the circuit is modulated. Incident waves outside the range, or resistances outside the grid, still go to the solver. Pass 0 waves to go back to solving every sample.
+     @param prog A pointer to the relevant tWDFProgram.
+     @param numWaves The number of points across the range of incident waves. More points are more accurate.
+     @param maxWave The largest incident wave to cover, in either direction.
+     @param numResistances The number of port resistances in the grid, or 1 for a single row.
+     @param minResistance The lowest port resistance in the grid.
+     @param maxResistance The highest port resistance in the grid.
+     
+     @fn float   tWDFProgram_getVoltage      (tWDFProgram* const, int index)
+     @brief Get the voltage across a component after the last tick.
+     @param prog A pointer to the relevant tWDFProgram.
+     @param index The component, from tWDFProgram_getIndex().
+     
+     @fn float   tWDFProgram_getCurrent      (tWDFProgram* const, int index)
+     @brief Get the current through a component after the last tick.
+     @param prog A pointer to the relevant tWDFProgram.
+     @param index The component, from tWDFProgram_getIndex().
+     
+     @} */
+    
+    typedef struct _tWDFProgram
+    {
+        tMempool mempool;
+        
+        int numNodes; // the root is always the last node
+        int outputIndex;
+        int dirty;
+        
+        tWDF** nodes;
+        uint8_t* type;
+        int* left;
+        int* right;
+        float* value;
+        float* sampleRate;
+        float* resistance;
+        float* conductance;
+        float* resistanceLeft;
+        float* resistanceRight;
+        float* conductanceLeft;
+        float* conductanceRight;
+        float* gammaZero;
+        float* gammaLeft;
+        float* gammaRight;
+        float* incident;
+        float* reflected;
+        
+        int* upList; // the nodes to visit scanning up, in order
+        int* downList; // and propagating down
+        int numUp, numDown;
+        
+        float* rootTable; // numResistances rows of numWaves
+        int rootTableWaves, rootTableResistances;
+        float rootTableMaxWave, rootTableInvStep;
+        float rootTableMinResistance, rootTableMaxResistance, rootTableInvLogRange;
+        int rootRow, rootRowValid;
+        float rootRowFrac;
+    } _tWDFProgram;
+    
+    typedef _tWDFProgram* tWDFProgram;
+    
+    void    tWDFProgram_init            (tWDFProgram* const, tWDF* const root, tWDF* const outputPoint, LEAF* const leaf);
+    void    tWDFProgram_initToPool      (tWDFProgram* const, tWDF* const root, tWDF* const outputPoint, tMempool* const);
+    void    tWDFProgram_free            (tWDFProgram* const);
+    
+    float   tWDFProgram_tick            (tWDFProgram* const, float sample);
+    void    tWDFProgram_tickBlock       (tWDFProgram* const, const float* input, float* output, int size);
+    
+    int     tWDFProgram_getIndex        (tWDFProgram* const, tWDF* const node);
+    void    tWDFProgram_setValue        (tWDFProgram* const, int index, float value);
+    void    tWDFProgram_setSampleRate   (tWDFProgram* const, float sample_rate);
+    void    tWDFProgram_setRootTable    (tWDFProgram* const, int numWaves, float maxWave, int numResistances, float minResistance, float maxResistance);
+    
+    float   tWDFProgram_getVoltage      (tWDFProgram* const, int index);
+    float   tWDFProgram_getCurrent      (tWDFProgram* const, int index);
+    
+    
+    //==============================================================================
+
 #ifdef __cplusplus
 }
 #endif
@@ -54,6 +54,10 @@ extern "C" {
      @brief Free a tEnvelope from its mempool.
      @param envelope A pointer to the tEnvelope to free.
      
+     @fn size_t  tEnvelope_getRequiredSize (void)
+     @brief Get the bytes tEnvelope_initToPool() allocates from a first-fit mempool, as a constant expression that can size static memory.
+     @return The size in bytes.
+     
      @fn float   tEnvelope_tick          (tEnvelope* const)
      @brief
      @param envelope A pointer to the relevant tEnvelope.
@@ -81,8 +85,7 @@ extern "C" {
         
         tMempool mempool;
         
-        const float *exp_buff;
-        const float *inc_buff;
+        const leaf_table_t *exp_buff;
         uint32_t buff_size;
         
         float next;
@@ -104,6 +107,7 @@ extern "C" {
     void    tEnvelope_init          (tEnvelope* const, float attack, float decay, int loop, LEAF* const leaf);
     void    tEnvelope_initToPool    (tEnvelope* const, float attack, float decay, int loop, tMempool* const);
     void    tEnvelope_free          (tEnvelope* const);
+#define tEnvelope_getRequiredSize() LEAF_MEMPOOL_BLOCK_SIZE(sizeof(_tEnvelope))
     
     float   tEnvelope_tick          (tEnvelope* const);
     void    tEnvelope_setAttack     (tEnvelope* const, float attack);
@@ -134,6 +138,10 @@ extern "C" {
      @brief Free a tExpSmooth from its mempool.
      @param smooth A pointer to the tExpSmooth to free.
      
+     @fn size_t  tExpSmooth_getRequiredSize (void)
+     @brief Get the bytes tExpSmooth_initToPool() allocates from a first-fit mempool, as a constant expression that can size static memory.
+     @return The size in bytes.
+     
      @fn float   tExpSmooth_tick         (tExpSmooth* const)
      @brief
      @param smooth A pointer to the relevant tExpSmooth.
@@ -158,6 +166,17 @@ extern "C" {
      @brief
      @param smooth A pointer to the relevant tExpSmooth.
      
+     @fn void    tExpSmooth_tickBlock    (tExpSmooth* const, float* output, int size)
+     @brief Render a block, ticking once every control period and interpolating in between. Lags the per sample output by one control period when the control rate is above 1.
+     @param smooth A pointer to the relevant tExpSmooth.
+     @param output The buffer to write to.
+     @param size The number of samples to write.
+     
+     @fn void    tExpSmooth_setControlRate (tExpSmooth* const, int divider)
+     @brief Set the number of samples between ticks. Until set, the divider given by LEAF_setControlRate() before initialization is used. Only tExpSmooth_tickBlock() runs at the control rate. tExpSmooth_tick() always advances one sample.
+     @param smooth A pointer to the relevant tExpSmooth.
+     @param divider The control rate divider, 1 for audio rate.
+     
      @} */
     
     typedef struct _tExpSmooth
@@ -167,6 +186,7 @@ extern "C" {
         float baseFactor, factor, oneminusfactor;
         float curr,dest;
         float invSampleRate;
+        LEAFControlRate control;
     } _tExpSmooth;
     
     typedef _tExpSmooth* tExpSmooth;
@@ -174,6 +194,7 @@ extern "C" {
     void    tExpSmooth_init         (tExpSmooth* const, float val, float factor, LEAF* const leaf);
     void    tExpSmooth_initToPool   (tExpSmooth* const, float val, float factor, tMempool* const);
     void    tExpSmooth_free         (tExpSmooth* const);
+#define tExpSmooth_getRequiredSize() LEAF_MEMPOOL_BLOCK_SIZE(sizeof(_tExpSmooth))
     
     float   tExpSmooth_tick         (tExpSmooth* const);
     float   tExpSmooth_sample       (tExpSmooth* const);
@@ -182,6 +203,8 @@ extern "C" {
     void    tExpSmooth_setVal       (tExpSmooth* const, float val);
     void    tExpSmooth_setValAndDest(tExpSmooth* const, float val);
     void    tExpSmooth_setSampleRate(tExpSmooth* const, float sr);
+    void    tExpSmooth_tickBlock    (tExpSmooth* const, float* output, int size);
+    void    tExpSmooth_setControlRate (tExpSmooth* const, int divider);
     
     // ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~
     
@@ -208,6 +231,10 @@ extern "C" {
      @brief Free a tADSR from its mempool.
      @param adsr A pointer to the tADSR to free.
      
+     @fn size_t  tADSR_getRequiredSize (void)
+     @brief Get the bytes tADSR_initToPool() allocates from a first-fit mempool, as a constant expression that can size static memory.
+     @return The size in bytes.
+     
      @fn float   tADSR_tick          (tADSR* const)
      @brief
      @param adsr A pointer to the relevant tADSR.
@@ -240,6 +267,17 @@ extern "C" {
      @brief
      @param adsr A pointer to the relevant tADSR.
      
+     @fn void    tADSR_tickBlock    (tADSR* const, float* output, int size)
+     @brief Render a block, ticking once every control period and interpolating in between. Lags the per sample output by one control period when the control rate is above 1.
+     @param adsr A pointer to the relevant tADSR.
+     @param output The buffer to write to.
+     @param size The number of samples to write.
+     
+     @fn void    tADSR_setControlRate (tADSR* const, int divider)
+     @brief Set the number of samples between ticks. Until set, the divider given by LEAF_setControlRate() before initialization is used. Only tADSR_tickBlock() runs at the control rate. tADSR_tick() always advances one sample.
+     @param adsr A pointer to the relevant tADSR.
+     @param divider The control rate divider, 1 for audio rate.
+     
      @} */
     
     /* ADSR */
@@ -248,8 +286,7 @@ extern "C" {
         
         tMempool mempool;
         
-        const float *exp_buff;
-        const float *inc_buff;
+        const leaf_table_t *exp_buff;
         uint32_t buff_size;
         
         float next;
@@ -267,6 +304,7 @@ extern "C" {
         float baseLeakFactor, leakFactor;
         
         float invSampleRate;
+        LEAFControlRate control;
     } _tADSR;
     
     typedef _tADSR* tADSR;
@@ -274,6 +312,7 @@ extern "C" {
     void    tADSR_init    (tADSR* const adsrenv, float attack, float decay, float sustain, float release, LEAF* const leaf);
     void    tADSR_initToPool    (tADSR* const adsrenv, float attack, float decay, float sustain, float release, tMempool* const mp);
     void    tADSR_free          (tADSR* const);
+#define tADSR_getRequiredSize() LEAF_MEMPOOL_BLOCK_SIZE(sizeof(_tADSR))
     
     float   tADSR_tick          (tADSR* const);
     void    tADSR_setAttack     (tADSR* const, float attack);
@@ -284,6 +323,8 @@ extern "C" {
     void    tADSR_on            (tADSR* const, float velocity);
     void    tADSR_off           (tADSR* const);
     void    tADSR_setSampleRate (tADSR* const, float sr);
+    void    tADSR_tickBlock     (tADSR* const, float* output, int size);
+    void    tADSR_setControlRate (tADSR* const, int divider);
     
     // ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~
     
@@ -307,6 +348,10 @@ extern "C" {
      @brief Free a tADSRT from its mempool.
      @param adsr A pointer to the tADSRT to free.
      
+     @fn size_t  tADSRT_getRequiredSize (void)
+     @brief Get the bytes tADSRT_initToPool() allocates from a first-fit mempool, as a constant expression that can size static memory.
+     @return The size in bytes.
+     
      @fn float   tADSRT_tick          (tADSRT* const)
      @brief
      @param adsr A pointer to the relevant tADSRT.
@@ -343,6 +388,17 @@ extern "C" {
      @brief
      @param adsr A pointer to the relevant tADSRT.
      
+     @fn void    tADSRT_tickBlock    (tADSRT* const, float* output, int size)
+     @brief Render a block, ticking once every control period and interpolating in between. Lags the per sample output by one control period when the control rate is above 1.
+     @param adsr A pointer to the relevant tADSRT.
+     @param output The buffer to write to.
+     @param size The number of samples to write.
+     
+     @fn void    tADSRT_setControlRate (tADSRT* const, int divider)
+     @brief Set the number of samples between ticks. Until set, the divider given by LEAF_setControlRate() before initialization is used. Only tADSRT_tickBlock() runs at the control rate. tADSRT_tick() always advances one sample.
+     @param adsr A pointer to the relevant tADSRT.
+     @param divider The control rate divider, 1 for audio rate.
+     
      @} */
     
     typedef struct _tADSRT
@@ -368,6 +424,7 @@ extern "C" {
         float baseLeakFactor, leakFactor;
         
         float invSampleRate;
+        LEAFControlRate control;
     } _tADSRT;
     
     typedef _tADSRT* tADSRT;
@@ -375,6 +432,7 @@ extern "C" {
     void    tADSRT_init          (tADSRT* const, float attack, float decay, float sustain, float release, float* expBuffer, int bufferSize, LEAF* const leaf);
     void    tADSRT_initToPool    (tADSRT* const, float attack, float decay, float sustain, float release, float* expBuffer, int bufferSize, tMempool* const);
     void    tADSRT_free          (tADSRT* const);
+#define tADSRT_getRequiredSize() LEAF_MEMPOOL_BLOCK_SIZE(sizeof(_tADSRT))
     
     float   tADSRT_tick          (tADSRT* const);
     float   tADSRT_tickNoInterp  (tADSRT* const adsrenv);
@@ -386,6 +444,8 @@ extern "C" {
     void    tADSRT_on            (tADSRT* const, float velocity);
     void    tADSRT_off           (tADSRT* const);
     void    tADSRT_setSampleRate (tADSRT* const, float sr);
+    void    tADSRT_tickBlock     (tADSRT* const, float* output, int size);
+    void    tADSRT_setControlRate (tADSRT* const, int divider);
     
     // ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~
     
@@ -409,6 +469,10 @@ extern "C" {
      @brief Free a tADSRS from its mempool.
      @param adsr A pointer to the tADSRS to free.
      
+     @fn size_t  tADSRS_getRequiredSize (void)
+     @brief Get the bytes tADSRS_initToPool() allocates from a first-fit mempool, as a constant expression that can size static memory.
+     @return The size in bytes.
+     
      @fn float   tADSRS_tick          (tADSRS* const)
      @brief
      @param adsr A pointer to the relevant tADSRS.
@@ -441,6 +505,17 @@ extern "C" {
      @brief
      @param adsr A pointer to the relevant tADSRS.
      
+     @fn void    tADSRS_tickBlock    (tADSRS* const, float* output, int size)
+     @brief Render a block, ticking once every control period and interpolating in between. Lags the per sample output by one control period when the control rate is above 1.
+     @param adsr A pointer to the relevant tADSRS.
+     @param output The buffer to write to.
+     @param size The number of samples to write.
+     
+     @fn void    tADSRS_setControlRate (tADSRS* const, int divider)
+     @brief Set the number of samples between ticks. Until set, the divider given by LEAF_setControlRate() before initialization is used. Only tADSRS_tickBlock() runs at the control rate. tADSRS_tick() always advances one sample.
+     @param adsr A pointer to the relevant tADSRS.
+     @param divider The control rate divider, 1 for audio rate.
+     
      @} */
     
     enum envState {
@@ -481,6 +556,7 @@ extern "C" {
         float oneMinusFactor;
         float gain;
         float invSampleRate;
+        LEAFControlRate control;
     } _tADSRS;
     
     typedef _tADSRS* tADSRS;
@@ -488,6 +564,7 @@ extern "C" {
     void    tADSRS_init          (tADSRS* const, float attack, float decay, float sustain, float release, LEAF* const leaf);
     void    tADSRS_initToPool    (tADSRS* const, float attack, float decay, float sustain, float release, tMempool* const);
     void    tADSRS_free          (tADSRS* const);
+#define tADSRS_getRequiredSize() LEAF_MEMPOOL_BLOCK_SIZE(sizeof(_tADSRS))
     
     float   tADSRS_tick          (tADSRS* const);
     void    tADSRS_setAttack     (tADSRS* const, float attack);
@@ -498,6 +575,8 @@ extern "C" {
     void    tADSRS_on            (tADSRS* const, float velocity);
     void    tADSRS_off           (tADSRS* const);
     void    tADSRS_setSampleRate (tADSRS* const, float sr);
+    void    tADSRS_tickBlock     (tADSRS* const, float* output, int size);
+    void    tADSRS_setControlRate (tADSRS* const, int divider);
     
     // ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~
     
@@ -521,6 +600,10 @@ extern "C" {
      @brief Free a tRamp from its mempool.
      @param ramp A pointer to the tRamp to free.
      
+     @fn size_t  tRamp_getRequiredSize (void)
+     @brief Get the bytes tRamp_initToPool() allocates from a first-fit mempool, as a constant expression that can size static memory.
+     @return The size in bytes.
+     
      @fn float   tRamp_tick          (tRamp* const)
      @brief
      @param ramp A pointer to the relevant tRamp.
@@ -561,6 +644,7 @@ extern "C" {
     void    tRamp_init          (tRamp* const, float time, int samplesPerTick, LEAF* const leaf);
     void    tRamp_initToPool    (tRamp* const, float time, int samplesPerTick, tMempool* const);
     void    tRamp_free          (tRamp* const);
+#define tRamp_getRequiredSize() LEAF_MEMPOOL_BLOCK_SIZE(sizeof(_tRamp))
     
     float   tRamp_tick          (tRamp* const);
     float   tRamp_sample        (tRamp* const);
@@ -589,6 +673,10 @@ extern "C" {
      @brief Free a tRampUpDown from its mempool.
      @param ramp A pointer to the tRampUpDown to free.
      
+     @fn size_t  tRampUpDown_getRequiredSize (void)
+     @brief Get the bytes tRampUpDown_initToPool() allocates from a first-fit mempool, as a constant expression that can size static memory.
+     @return The size in bytes.
+     
      @fn float   tRampUpDown_tick          (tRampUpDown* const)
      @brief
      @param ramp A pointer to the relevant tRampUpDown.
@@ -634,6 +722,7 @@ extern "C" {
     void    tRampUpDown_init          (tRampUpDown* const, float upTime, float downTime, int samplesPerTick, LEAF* const leaf);
     void    tRampUpDown_initToPool    (tRampUpDown* const, float upTime, float downTime, int samplesPerTick, tMempool* const);
     void    tRampUpDown_free          (tRampUpDown* const);
+#define tRampUpDown_getRequiredSize() LEAF_MEMPOOL_BLOCK_SIZE(sizeof(_tRampUpDown))
     
     float   tRampUpDown_tick          (tRampUpDown* const);
     float   tRampUpDown_sample        (tRampUpDown* const);
@@ -663,6 +752,10 @@ extern "C" {
      @brief Free a tSlide from its mempool.
      @param slide A pointer to the tSlide to free.
      
+     @fn size_t  tSlide_getRequiredSize (void)
+     @brief Get the bytes tSlide_initToPool() allocates from a first-fit mempool, as a constant expression that can size static memory.
+     @return The size in bytes.
+     
      @fn float   tSlide_tick         (tSlide* const, float in)
      @brief
      @param slide A pointer to the relevant tSlide.
@@ -701,6 +794,7 @@ extern "C" {
     void    tSlide_init          (tSlide* const, float upSlide, float downSlide, LEAF* const leaf);
     void    tSlide_initToPool    (tSlide* const, float upSlide, float downSlide, tMempool* const);
     void    tSlide_free          (tSlide* const);
+#define tSlide_getRequiredSize() LEAF_MEMPOOL_BLOCK_SIZE(sizeof(_tSlide))
     
     float   tSlide_tick         (tSlide* const, float in);
     float   tSlide_tickNoInput    (tSlide* const sl);
@@ -708,6 +802,407 @@ extern "C" {
     void    tSlide_setDownSlide    (tSlide* const sl, float downSlide);
     void    tSlide_setDest        (tSlide* const sl, float dest);
     
+    // ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~
+    
+    /*!
+     @defgroup tsmootherbank tSmootherBank
+     @ingroup envelopes
+     @brief A bank of parameter smoothers that renders block-length ramps and skips parameters that have settled.
+     @details Each smoother owns a buffer of one block, ready to pass to block tick functions as a modulation input. Only smoothers that are moving are kept on the bank's active list, so a block costs nothing for a parameter that hasn't changed. A settled smoother's buffer holds its value until the next change.
+     @{
+     
+     @fn void    tSmootherBank_init          (tSmootherBank* const, int numSmoothers, int blockSize, LEAF* const leaf)
+     @brief Initialize a tSmootherBank to the default mempool of a LEAF instance.
+     @param bank A pointer to the tSmootherBank to initialize.
+     @param numSmoothers The number of smoothers in the bank.
+     @param blockSize The largest block the bank will be ticked with.
+     @param leaf A pointer to the leaf instance.
+     
+     @fn void    tSmootherBank_initToPool    (tSmootherBank* const, int numSmoothers, int blockSize, tMempool* const)
+     @brief Initialize a tSmootherBank to a specified mempool.
+     @param bank A pointer to the tSmootherBank to initialize.
+     @param numSmoothers The number of smoothers in the bank.
+     @param blockSize The largest block the bank will be ticked with.
+     @param mempool A pointer to the tMempool to use.
+     
+     @fn void    tSmootherBank_free          (tSmootherBank* const)
+     @brief Free a tSmootherBank from its mempool.
+     @param bank A pointer to the tSmootherBank to free.
+     
+     @fn size_t  tSmootherBank_getRequiredSize (int numSmoothers, int blockSize)
+     @brief Get the bytes tSmootherBank_initToPool() allocates from a first-fit mempool for the given parameters, as a constant expression that can size static memory.
+     @param numSmoothers The number of smoothers the tSmootherBank will be initialized with.
+     @param blockSize The block size the tSmootherBank will be initialized with.
+     @return The size in bytes.
+     
+     @fn int     tSmootherBank_tickBlock     (tSmootherBank* const, int size)
+     @brief Render the next block of every moving smoother.
+     @param bank A pointer to the relevant tSmootherBank.
+     @param size The block size, up to the size given at initialization.
+     @return The number of smoothers still moving.
+     
+     @fn float*  tSmootherBank_getBuffer     (tSmootherBank* const, int index)
+     @brief Get a smoother's buffer, filled by the last tSmootherBank_tickBlock().
+     @param bank A pointer to the relevant tSmootherBank.
+     @param index The smoother.
+     @return The buffer, which stays at the same address for the life of the bank.
+     
+     @fn float   tSmootherBank_getValue      (tSmootherBank* const, int index)
+     @brief Get a smoother's value at the end of the last block.
+     @param bank A pointer to the relevant tSmootherBank.
+     @param index The smoother.
+     
+     @fn int     tSmootherBank_isActive      (tSmootherBank* const, int index)
+     @brief Check whether a smoother will change over the next block.
+     @param bank A pointer to the relevant tSmootherBank.
+     @param index The smoother.
+     @return 1 if the smoother is on the active list, otherwise 0.
+     
+     @fn void    tSmootherBank_setType       (tSmootherBank* const, int index, SmootherType type)
+     @brief Choose between a linear ramp that arrives in a fixed time and an exponential approach. Defaults to SmootherLinear.
+     @param bank A pointer to the relevant tSmootherBank.
+     @param index The smoother.
+     @param type SmootherLinear or SmootherExponential.
+     
+     @fn void    tSmootherBank_setTime       (tSmootherBank* const, int index, float time)
+     @brief Set a smoother's time in milliseconds: the ramp length when linear, the time constant when exponential. Defaults to 10 ms.
+     @param bank A pointer to the relevant tSmootherBank.
+     @param index The smoother.
+     @param time The time in milliseconds.
+     
+     @fn void    tSmootherBank_setDest       (tSmootherBank* const, int index, float dest)
+     @brief Start a smoother moving towards a new value from the start of the next block.
+     @param bank A pointer to the relevant tSmootherBank.
+     @param index The smoother.
+     @param dest The new value.
+     
+     @fn void    tSmootherBank_setVal        (tSmootherBank* const, int index, float val)
+     @brief Jump a smoother straight to a value from the start of the next block.
+     @param bank A pointer to the relevant tSmootherBank.
+     @param index The smoother.
+     @param val The new value.
+     
+     @fn void    tSmootherBank_setThreshold  (tSmootherBank* const, float threshold)
+     @brief Set how close an exponential smoother has to get to its destination to count as settled. Defaults to 0.0001.
+     @param bank A pointer to the relevant tSmootherBank.
+     @param threshold The distance at which a smoother snaps to its destination.
+     
+     @} */
+    
+    typedef enum SmootherType
+    {
+        SmootherLinear = 0,
+        SmootherExponential,
+        SmootherTypeNil
+    } SmootherType;
+    
+    typedef struct _tSmootherBank
+    {
+        tMempool mempool;
+        
+        int numSmoothers;
+        int blockSize;
+        float* buffers;
+        
+        float* curr;
+        float* dest;
+        float* step; // per sample increment when linear, per sample decay of the distance when exponential
+        float* time;
+        int* remaining; // samples left of a linear ramp, zero once a smoother only needs its buffer flattened
+        uint8_t* type;
+        
+        int* active;
+        int* activePos;
+        int numActive;
+        
+        float threshold;
+        float sampleRate;
+    } _tSmootherBank;
+    
+    typedef _tSmootherBank* tSmootherBank;
+    
+    void    tSmootherBank_init          (tSmootherBank* const, int numSmoothers, int blockSize, LEAF* const leaf);
+    void    tSmootherBank_initToPool    (tSmootherBank* const, int numSmoothers, int blockSize, tMempool* const);
+    void    tSmootherBank_free          (tSmootherBank* const);
+#define tSmootherBank_getRequiredSize(numSmoothers, blockSize) (LEAF_MEMPOOL_BLOCK_SIZE(sizeof(_tSmootherBank)) + LEAF_MEMPOOL_BLOCK_SIZE(sizeof(float) * (numSmoothers) * (blockSize)) + 4 * LEAF_MEMPOOL_BLOCK_SIZE(sizeof(float) * (numSmoothers)) + 3 * LEAF_MEMPOOL_BLOCK_SIZE(sizeof(int) * (numSmoothers)) + LEAF_MEMPOOL_BLOCK_SIZE(sizeof(uint8_t) * (numSmoothers)))
+    
+    int     tSmootherBank_tickBlock     (tSmootherBank* const, int size);
+    float*  tSmootherBank_getBuffer     (tSmootherBank* const, int index);
+    float   tSmootherBank_getValue      (tSmootherBank* const, int index);
+    int     tSmootherBank_isActive      (tSmootherBank* const, int index);
+    void    tSmootherBank_setType       (tSmootherBank* const, int index, SmootherType type);
+    void    tSmootherBank_setTime       (tSmootherBank* const, int index, float time);
+    void    tSmootherBank_setDest       (tSmootherBank* const, int index, float dest);
+    void    tSmootherBank_setVal        (tSmootherBank* const, int index, float val);
+    void    tSmootherBank_setThreshold  (tSmootherBank* const, float threshold);
+    void    tSmootherBank_setSampleRate (tSmootherBank* const, float sr);
+
+    // ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~
+    
+    /*!
+     @defgroup tadsrtbank tADSRTBank
+     @ingroup envelopes
+     @brief A bank of table-based envelopes sharing one set of times, rendered a block at a time.
+     @details Produces the same output sample for sample as a tADSRT ticked with tADSRT_tick() for each envelope. Each envelope owns a buffer of one block, and envelopes that have finished their release drop off the bank's active list, so idle voices cost nothing.
+     @{
+     
+     @fn void    tADSRTBank_init          (tADSRTBank* const, int numEnvelopes, int blockSize, float attack, float decay, float sustain, float release, float* expBuffer, int bufferSize, LEAF* const leaf)
+     @brief Initialize a tADSRTBank to the default mempool of a LEAF instance.
+     @param bank A pointer to the tADSRTBank to initialize.
+     @param numEnvelopes The number of envelopes in the bank.
+     @param blockSize The largest block the bank will be ticked with.
+     @param attack The attack time in milliseconds.
+     @param decay The decay time in milliseconds.
+     @param sustain The sustain level, from 0 to 1.
+     @param release The release time in milliseconds.
+     @param expBuffer A decaying exponential table, as for tADSRT.
+     @param bufferSize The size of the table.
+     @param leaf A pointer to the leaf instance.
+     
+     @fn void    tADSRTBank_initToPool    (tADSRTBank* const, int numEnvelopes, int blockSize, float attack, float decay, float sustain, float release, float* expBuffer, int bufferSize, tMempool* const)
+     @brief Initialize a tADSRTBank to a specified mempool.
+     @param bank A pointer to the tADSRTBank to initialize.
+     @param mempool A pointer to the tMempool to use.
+     
+     @fn void    tADSRTBank_free          (tADSRTBank* const)
+     @brief Free a tADSRTBank from its mempool.
+     @param bank A pointer to the tADSRTBank to free.
+     
+     @fn int     tADSRTBank_tickBlock     (tADSRTBank* const, int size)
+     @brief Render the next block of every envelope that isn't idle.
+     @param bank A pointer to the relevant tADSRTBank.
+     @param size The block size, up to the size given at initialization.
+     @return The number of envelopes still active.
+     
+     @fn float*  tADSRTBank_getBuffer     (tADSRTBank* const, int index)
+     @brief Get an envelope's buffer, filled by the last tADSRTBank_tickBlock().
+     @param bank A pointer to the relevant tADSRTBank.
+     @param index The envelope.
+     
+     @fn float   tADSRTBank_getValue      (tADSRTBank* const, int index)
+     @brief Get an envelope's value at the end of the last block.
+     @param bank A pointer to the relevant tADSRTBank.
+     @param index The envelope.
+     
+     @fn int     tADSRTBank_isActive      (tADSRTBank* const, int index)
+     @brief Check whether an envelope will be rendered in the next block.
+     @param bank A pointer to the relevant tADSRTBank.
+     @param index The envelope.
+     @return 1 if the envelope is on the active list, otherwise 0.
+     
+     @fn void    tADSRTBank_on            (tADSRTBank* const, int index, float velocity)
+     @brief Trigger an envelope from the start of the next block.
+     @param bank A pointer to the relevant tADSRTBank.
+     @param index The envelope.
+     @param velocity The peak level of the envelope.
+     
+     @fn void    tADSRTBank_off           (tADSRTBank* const, int index)
+     @brief Release an envelope from the start of the next block.
+     @param bank A pointer to the relevant tADSRTBank.
+     @param index The envelope.
+     
+     @fn void    tADSRTBank_setAttack     (tADSRTBank* const, float attack)
+     @brief Set the attack time of every envelope in milliseconds.
+     @param bank A pointer to the relevant tADSRTBank.
+     
+     @fn void    tADSRTBank_setDecay      (tADSRTBank* const, float decay)
+     @brief Set the decay time of every envelope in milliseconds.
+     @param bank A pointer to the relevant tADSRTBank.
+     
+     @fn void    tADSRTBank_setSustain    (tADSRTBank* const, float sustain)
+     @brief Set the sustain level of every envelope, from 0 to 1.
+     @param bank A pointer to the relevant tADSRTBank.
+     
+     @fn void    tADSRTBank_setRelease    (tADSRTBank* const, float release)
+     @brief Set the release time of every envelope in milliseconds.
+     @param bank A pointer to the relevant tADSRTBank.
+     
+     @fn void    tADSRTBank_setLeakFactor (tADSRTBank* const, float leakFactor)
+     @brief Set the leak of every envelope while sustaining. 0.999999 is slow leak, 0.9 is fast leak.
+     @param bank A pointer to the relevant tADSRTBank.
+     
+     @} */
+    
+    typedef struct _tADSRTBank
+    {
+        tMempool mempool;
+        
+        int numEnvelopes;
+        int blockSize;
+        float* buffers;
+        
+        // Per envelope. Every stage starts from a phase of zero, so one phase covers them all
+        uint8_t* stage;
+        float* next;
+        float* phase;
+        float* gain;
+        float* peak; // the level the ramp or release falls from
+        
+        int* active;
+        int* activePos;
+        int numActive;
+        
+        const float* exp_buff;
+        uint32_t buff_size;
+        float maxPhase;
+        float sampleRate;
+        float bufferSizeDividedBySampleRateInMs;
+        
+        float attack, decay, sustain, release;
+        float attackInc, decayInc, releaseInc, rampInc;
+        float baseLeakFactor, leakFactor;
+    } _tADSRTBank;
+    
+    typedef _tADSRTBank* tADSRTBank;
+    
+    void    tADSRTBank_init          (tADSRTBank* const, int numEnvelopes, int blockSize, float attack, float decay, float sustain, float release, float* expBuffer, int bufferSize, LEAF* const leaf);
+    void    tADSRTBank_initToPool    (tADSRTBank* const, int numEnvelopes, int blockSize, float attack, float decay, float sustain, float release, float* expBuffer, int bufferSize, tMempool* const);
+    void    tADSRTBank_free          (tADSRTBank* const);
+    
+    int     tADSRTBank_tickBlock     (tADSRTBank* const, int size);
+    float*  tADSRTBank_getBuffer     (tADSRTBank* const, int index);
+    float   tADSRTBank_getValue      (tADSRTBank* const, int index);
+    int     tADSRTBank_isActive      (tADSRTBank* const, int index);
+    void    tADSRTBank_on            (tADSRTBank* const, int index, float velocity);
+    void    tADSRTBank_off           (tADSRTBank* const, int index);
+    void    tADSRTBank_setAttack     (tADSRTBank* const, float attack);
+    void    tADSRTBank_setDecay      (tADSRTBank* const, float decay);
+    void    tADSRTBank_setSustain    (tADSRTBank* const, float sustain);
+    void    tADSRTBank_setRelease    (tADSRTBank* const, float release);
+    void    tADSRTBank_setLeakFactor (tADSRTBank* const, float leakFactor);
+    void    tADSRTBank_setSampleRate (tADSRTBank* const, float sr);
+    
+    // ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~
+    
+    /*!
+     @defgroup tadsrsbank tADSRSBank
+     @ingroup envelopes
+     @brief A bank of tADSRS-style envelopes sharing one set of times, rendered a block at a time.
+     @details Produces the same output sample for sample as a tADSRS for each envelope. An idle envelope stays on the active list only until its smoothed gain has stopped moving.
+     @{
+     
+     @fn void    tADSRSBank_init          (tADSRSBank* const, int numEnvelopes, int blockSize, float attack, float decay, float sustain, float release, LEAF* const leaf)
+     @brief Initialize a tADSRSBank to the default mempool of a LEAF instance.
+     @param bank A pointer to the tADSRSBank to initialize.
+     @param numEnvelopes The number of envelopes in the bank.
+     @param blockSize The largest block the bank will be ticked with.
+     @param attack The attack time in milliseconds.
+     @param decay The decay time in milliseconds.
+     @param sustain The sustain level, from 0 to 1.
+     @param release The release time in milliseconds.
+     @param leaf A pointer to the leaf instance.
+     
+     @fn void    tADSRSBank_initToPool    (tADSRSBank* const, int numEnvelopes, int blockSize, float attack, float decay, float sustain, float release, tMempool* const)
+     @brief Initialize a tADSRSBank to a specified mempool.
+     @param bank A pointer to the tADSRSBank to initialize.
+     @param mempool A pointer to the tMempool to use.
+     
+     @fn void    tADSRSBank_free          (tADSRSBank* const)
+     @brief Free a tADSRSBank from its mempool.
+     @param bank A pointer to the tADSRSBank to free.
+     
+     @fn int     tADSRSBank_tickBlock     (tADSRSBank* const, int size)
+     @brief Render the next block of every envelope that isn't idle.
+     @param bank A pointer to the relevant tADSRSBank.
+     @param size The block size, up to the size given at initialization.
+     @return The number of envelopes still active.
+     
+     @fn float*  tADSRSBank_getBuffer     (tADSRSBank* const, int index)
+     @brief Get an envelope's buffer, filled by the last tADSRSBank_tickBlock().
+     @param bank A pointer to the relevant tADSRSBank.
+     @param index The envelope.
+     
+     @fn float   tADSRSBank_getValue      (tADSRSBank* const, int index)
+     @brief Get an envelope's value at the end of the last block.
+     @param bank A pointer to the relevant tADSRSBank.
+     @param index The envelope.
+     
+     @fn int     tADSRSBank_isActive      (tADSRSBank* const, int index)
+     @brief Check whether an envelope will be rendered in the next block.
+     @param bank A pointer to the relevant tADSRSBank.
+     @param index The envelope.
+     @return 1 if the envelope is on the active list, otherwise 0.
+     
+     @fn void    tADSRSBank_on            (tADSRSBank* const, int index, float velocity)
+     @brief Trigger an envelope from the start of the next block.
+     @param bank A pointer to the relevant tADSRSBank.
+     @param index The envelope.
+     @param velocity The velocity, whose square the envelope's gain is smoothed towards.
+     
+     @fn void    tADSRSBank_off           (tADSRSBank* const, int index)
+     @brief Release an envelope from the start of the next block.
+     @param bank A pointer to the relevant tADSRSBank.
+     @param index The envelope.
+     
+     @fn void    tADSRSBank_setAttack     (tADSRSBank* const, float attack)
+     @brief Set the attack time of every envelope in milliseconds.
+     @param bank A pointer to the relevant tADSRSBank.
+     
+     @fn void    tADSRSBank_setDecay      (tADSRSBank* const, float decay)
+     @brief Set the decay time of every envelope in milliseconds.
+     @param bank A pointer to the relevant tADSRSBank.
+     
+     @fn void    tADSRSBank_setSustain    (tADSRSBank* const, float sustain)
+     @brief Set the sustain level of every envelope, from 0 to 1.
+     @param bank A pointer to the relevant tADSRSBank.
+     
+     @fn void    tADSRSBank_setRelease    (tADSRSBank* const, float release)
+     @brief Set the release time of every envelope in milliseconds.
+     @param bank A pointer to the relevant tADSRSBank.
+     
+     @fn void    tADSRSBank_setLeakFactor (tADSRSBank* const, float leakFactor)
+     @brief Set the leak of every envelope while decaying and sustaining. 0.999999 is slow leak, 0.9 is fast leak.
+     @param bank A pointer to the relevant tADSRSBank.
+     
+     @} */
+    
+    typedef struct _tADSRSBank
+    {
+        tMempool mempool;
+        
+        int numEnvelopes;
+        int blockSize;
+        float* buffers;
+        
+        uint8_t* state;
+        float* output;
+        float* gain;
+        float* targetGainSquared;
+        
+        int* active;
+        int* activePos;
+        int numActive;
+        
+        float sampleRate;
+        float sampleRateInMs;
+        float invSampleRate;
+        float targetRatioA, targetRatioDR;
+        float attack, decay, sustainLevel, release;
+        float attackCoef, decayCoef, releaseCoef;
+        float attackBase, decayBase, releaseBase;
+        float factor, oneMinusFactor;
+        float baseLeakFactor, leakFactor;
+    } _tADSRSBank;
+    
+    typedef _tADSRSBank* tADSRSBank;
+    
+    void    tADSRSBank_init          (tADSRSBank* const, int numEnvelopes, int blockSize, float attack, float decay, float sustain, float release, LEAF* const leaf);
+    void    tADSRSBank_initToPool    (tADSRSBank* const, int numEnvelopes, int blockSize, float attack, float decay, float sustain, float release, tMempool* const);
+    void    tADSRSBank_free          (tADSRSBank* const);
+    
+    int     tADSRSBank_tickBlock     (tADSRSBank* const, int size);
+    float*  tADSRSBank_getBuffer     (tADSRSBank* const, int index);
+    float   tADSRSBank_getValue      (tADSRSBank* const, int index);
+    int     tADSRSBank_isActive      (tADSRSBank* const, int index);
+    void    tADSRSBank_on            (tADSRSBank* const, int index, float velocity);
+    void    tADSRSBank_off           (tADSRSBank* const, int index);
+    void    tADSRSBank_setAttack     (tADSRSBank* const, float attack);
+    void    tADSRSBank_setDecay      (tADSRSBank* const, float decay);
+    void    tADSRSBank_setSustain    (tADSRSBank* const, float sustain);
+    void    tADSRSBank_setRelease    (tADSRSBank* const, float release);
+    void    tADSRSBank_setLeakFactor (tADSRSBank* const, float leakFactor);
+    void    tADSRSBank_setSampleRate (tADSRSBank* const, float sr);
+
 #ifdef __cplusplus
 }
 #endif
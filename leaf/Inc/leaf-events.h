@@ -0,0 +1,187 @@
+/*==============================================================================
+
+ leaf-events.h
+ 
+ ==============================================================================*/
+
+#ifndef LEAF_EVENTS_H_INCLUDED
+#define LEAF_EVENTS_H_INCLUDED
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+    //==============================================================================
+
+#include "leaf-global.h"
+#include "leaf-mempool.h"
+
+    /*!
+     * @internal
+     * Header.
+     * @include basic-oscillators.h
+     * @example basic-oscillators.c
+     * An example.
+     */
+    
+    //==============================================================================
+    
+    /*!
+     @defgroup teventqueue tEventQueue
+     @ingroup events
+     @brief Lock-free queue of timestamped events from one control thread to the audio thread.
+     
+     One thread, such as the UI or MIDI thread, pushes events and the audio thread drains them. Neither
+     side takes a lock or waits on the other: a push into a full queue fails and returns 0, and the
+     audio thread only ever looks at what has already been pushed.
+     
+     Events are stamped in samples on the queue's own clock, which the audio thread advances by one block
+     each time it drains. Stamping an event with tEventQueue_getTime() applies it at the start of the next
+     block drained, adding to that schedules it further ahead, and anything already due is applied at
+     the start of the block. Events from one producer should be pushed in time order.
+     @{
+     
+     @fn void    tEventQueue_init            (tEventQueue* const queue, int capacity, LEAF* const leaf)
+     @brief Initialize a tEventQueue to the default mempool of a LEAF instance.
+     @param queue A pointer to the tEventQueue to initialize.
+     @param capacity The number of events the queue can hold, rounded up to a power of two.
+     @param leaf A pointer to the leaf instance.
+     
+     @fn void    tEventQueue_initToPool      (tEventQueue* const queue, int capacity, tMempool* const mempool)
+     @brief Initialize a tEventQueue to a specified mempool.
+     @param queue A pointer to the tEventQueue to initialize.
+     @param capacity The number of events the queue can hold, rounded up to a power of two.
+     @param mempool A pointer to the tMempool to use.
+     
+     @fn void    tEventQueue_free            (tEventQueue* const queue)
+     @brief Free a tEventQueue from its mempool.
+     @param queue A pointer to the tEventQueue to free.
+     
+     @fn int     tEventQueue_push            (tEventQueue* const queue, const LEAFEvent* const event)
+     @brief Push an event. Producer only.
+     @param queue A pointer to the relevant tEventQueue.
+     @param event The event to copy into the queue.
+     @return 1 if the event was queued, 0 if the queue was full.
+     
+     @fn int     tEventQueue_pushParam       (tEventQueue* const queue, uint32_t time, int param, float value)
+     @brief Push a parameter change. Producer only.
+     @param queue A pointer to the relevant tEventQueue.
+     @param time The time to apply the change at, from tEventQueue_getTime().
+     @param param An id for the parameter, for the apply callback to look up.
+     @param value The new value.
+     @return 1 if the event was queued, 0 if the queue was full.
+     
+     @fn int     tEventQueue_pushNoteOn      (tEventQueue* const queue, uint32_t time, int channel, int note, float velocity)
+     @brief Push a note on. Producer only.
+     @param queue A pointer to the relevant tEventQueue.
+     @param time The time to apply the note at, from tEventQueue_getTime().
+     @param channel The MIDI channel.
+     @param note The MIDI note number.
+     @param velocity The velocity.
+     @return 1 if the event was queued, 0 if the queue was full.
+     
+     @fn int     tEventQueue_pushNoteOff     (tEventQueue* const queue, uint32_t time, int channel, int note)
+     @brief Push a note off. Producer only.
+     @param queue A pointer to the relevant tEventQueue.
+     @param time The time to apply the note off at, from tEventQueue_getTime().
+     @param channel The MIDI channel.
+     @param note The MIDI note number.
+     @return 1 if the event was queued, 0 if the queue was full.
+     
+     @fn int     tEventQueue_pushControlChange (tEventQueue* const queue, uint32_t time, int channel, int controller, float value)
+     @brief Push a control change. Producer only.
+     @param queue A pointer to the relevant tEventQueue.
+     @param time The time to apply the change at, from tEventQueue_getTime().
+     @param channel The MIDI channel.
+     @param controller The controller number.
+     @param value The controller value.
+     @return 1 if the event was queued, 0 if the queue was full.
+     
+     @fn uint32_t tEventQueue_getTime        (tEventQueue* const queue)
+     @brief Get the queue's clock, the time of the start of the next block to be drained. Safe from either side.
+     @param queue A pointer to the relevant tEventQueue.
+     @return The time in samples.
+     
+     @fn int     tEventQueue_getNext         (tEventQueue* const queue, int size, LEAFEvent* const event)
+     @brief Take the next event due in the current block. Audio thread only.
+     @details Render up to the returned offset, apply the event, and repeat until it returns -1. Then render the rest of the block and call tEventQueue_advance().
+     @param queue A pointer to the relevant tEventQueue.
+     @param size The size of the current block.
+     @param event Set to the event taken.
+     @return The event's offset into the block, or -1 if nothing more is due in it.
+     
+     @fn void    tEventQueue_advance         (tEventQueue* const queue, int size)
+     @brief Move the queue's clock on to the next block. Audio thread only.
+     @param queue A pointer to the relevant tEventQueue.
+     @param size The size of the block just finished.
+     
+     @fn void    tEventQueue_processBlock    (tEventQueue* const queue, int size, tEventApplyCallback apply, tEventRenderCallback render, void* userData)
+     @brief Run one block, splitting it wherever an event is due. Audio thread only.
+     @details Calls render for each run of samples between events and apply for each event at its offset, then advances the clock.
+     @param queue A pointer to the relevant tEventQueue.
+     @param size The block size.
+     @param apply Called with each event as it comes due.
+     @param render Called with the offset and length of each run of samples to process.
+     @param userData Passed to both callbacks.
+     
+     @} */
+    
+    typedef enum EventType
+    {
+        EventParam = 0,
+        EventNoteOn,
+        EventNoteOff,
+        EventControlChange,
+        EventTypeNil
+    } EventType;
+    
+    typedef struct LEAFEvent
+    {
+        uint32_t time; //!< When to apply the event, in samples on the queue's clock.
+        uint8_t type; //!< An EventType.
+        uint8_t channel; //!< The MIDI channel, for note and controller events.
+        uint16_t id; //!< The parameter id, note number, or controller number.
+        float value; //!< The parameter value, velocity, or controller value.
+    } LEAFEvent;
+    
+    typedef void (*tEventApplyCallback)(void* userData, const LEAFEvent* event);
+    typedef void (*tEventRenderCallback)(void* userData, int offset, int size);
+    
+    typedef struct _tEventQueue
+    {
+        tMempool mempool;
+        
+        LEAFEvent* events;
+        uint32_t mask;
+        volatile uint32_t write;
+        volatile uint32_t read;
+        volatile uint32_t time;
+    } _tEventQueue;
+    
+    typedef _tEventQueue* tEventQueue;
+    
+    void    tEventQueue_init            (tEventQueue* const queue, int capacity, LEAF* const leaf);
+    void    tEventQueue_initToPool      (tEventQueue* const queue, int capacity, tMempool* const mempool);
+    void    tEventQueue_free            (tEventQueue* const queue);
+    
+    int     tEventQueue_push            (tEventQueue* const queue, const LEAFEvent* const event);
+    int     tEventQueue_pushParam       (tEventQueue* const queue, uint32_t time, int param, float value);
+    int     tEventQueue_pushNoteOn      (tEventQueue* const queue, uint32_t time, int channel, int note, float velocity);
+    int     tEventQueue_pushNoteOff     (tEventQueue* const queue, uint32_t time, int channel, int note);
+    int     tEventQueue_pushControlChange (tEventQueue* const queue, uint32_t time, int channel, int controller, float value);
+    uint32_t tEventQueue_getTime        (tEventQueue* const queue);
+    
+    int     tEventQueue_getNext         (tEventQueue* const queue, int size, LEAFEvent* const event);
+    void    tEventQueue_advance         (tEventQueue* const queue, int size);
+    void    tEventQueue_processBlock    (tEventQueue* const queue, int size, tEventApplyCallback apply, tEventRenderCallback render, void* userData);
+    
+    //==============================================================================
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LEAF_EVENTS_H_INCLUDED
+
+//==============================================================================
+
@@ -0,0 +1,121 @@
+/*==============================================================================
+
+ leaf-fft.h
+ 
+ ==============================================================================*/
+
+#ifndef LEAF_FFT_H_INCLUDED
+#define LEAF_FFT_H_INCLUDED
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+    //==============================================================================
+
+#include "leaf-global.h"
+#include "leaf-math.h"
+#include "leaf-mempool.h"
+
+#if LEAF_USE_CMSIS
+#include "arm_math.h"
+#endif
+
+    /*!
+     * @internal
+     * Header.
+     * @include basic-oscillators.h
+     * @example basic-oscillators.c
+     * An example.
+     */
+    
+    //==============================================================================
+    
+    /*!
+     @defgroup trealfft tRealFFT
+     @ingroup math
+     @brief In-place FFT of real signals, shared by the spectral and convolution objects.
+     
+     Twiddle factors and the bit reversal permutation are computed when the tRealFFT is initialized, so
+     transforms don't allocate or call trig functions. With LEAF_USE_CMSIS set, transforms use
+     arm_rfft_fast_f32 instead, which limits the size to what CMSIS-DSP supports (32 to 4096).
+     
+     Spectra are packed in the same layout as arm_rfft_fast_f32: buffer[0] holds the real DC bin,
+     buffer[1] holds the real Nyquist bin, and buffer[2k], buffer[2k+1] hold the real and imaginary parts of bin k.
+     @{
+     
+     @fn void    tRealFFT_init           (tRealFFT* const, int size, LEAF* const leaf)
+     @brief Initialize a tRealFFT to the default mempool of a LEAF instance.
+     @param fft A pointer to the tRealFFT to initialize.
+     @param size The transform size. Must be a power of two, at least 4.
+     @param leaf A pointer to the leaf instance.
+     
+     @fn void    tRealFFT_initToPool     (tRealFFT* const, int size, tMempool* const)
+     @brief Initialize a tRealFFT to a specified mempool.
+     @param fft A pointer to the tRealFFT to initialize.
+     @param size The transform size. Must be a power of two, at least 4.
+     @param mempool A pointer to the tMempool to use.
+     
+     @fn void    tRealFFT_free           (tRealFFT* const)
+     @brief Free a tRealFFT from its mempool.
+     @param fft A pointer to the tRealFFT to free.
+     
+     @fn size_t  tRealFFT_getRequiredSize (int size)
+     @brief Get the bytes tRealFFT_initToPool() allocates from a first-fit mempool for the given parameters, as a constant expression that can size static memory.
+     @param size The size the tRealFFT will be initialized with.
+     @return The size in bytes.
+     
+     @fn void    tRealFFT_forward        (tRealFFT* const, float* buffer)
+     @brief Transform size real samples to a packed spectrum in place. The transform is unnormalized.
+     @param fft A pointer to the relevant tRealFFT.
+     @param buffer The size samples to transform.
+     
+     @fn void    tRealFFT_inverse        (tRealFFT* const, float* buffer)
+     @brief Transform a packed spectrum back to size real samples in place, scaled by 1/size so that a forward and inverse transform give back the input.
+     @param fft A pointer to the relevant tRealFFT.
+     @param buffer The packed spectrum to transform.
+     
+     @fn int     tRealFFT_getSize        (tRealFFT* const)
+     @brief Get the transform size.
+     @param fft A pointer to the relevant tRealFFT.
+     
+     @} */
+    
+    typedef struct _tRealFFT
+    {
+        tMempool mempool;
+        int size;
+#if LEAF_USE_CMSIS
+        arm_rfft_fast_instance_f32 instance;
+        float* scratch;
+#else
+        float* twiddles; // e^(-2 pi i k / size) for k < size / 2, interleaved real and imaginary
+        int* bitrev; // bit reversal permutation of the size / 2 point complex transform
+#endif
+    } _tRealFFT;
+    
+    typedef _tRealFFT* tRealFFT;
+    
+    void    tRealFFT_init           (tRealFFT* const, int size, LEAF* const leaf);
+    void    tRealFFT_initToPool     (tRealFFT* const, int size, tMempool* const);
+    void    tRealFFT_free           (tRealFFT* const);
+#if LEAF_USE_CMSIS
+#define tRealFFT_getRequiredSize(size) (LEAF_MEMPOOL_BLOCK_SIZE(sizeof(_tRealFFT)) + LEAF_MEMPOOL_BLOCK_SIZE(sizeof(float) * (size)))
+#else
+#define tRealFFT_getRequiredSize(size) (LEAF_MEMPOOL_BLOCK_SIZE(sizeof(_tRealFFT)) + LEAF_MEMPOOL_BLOCK_SIZE(sizeof(float) * (size)) + LEAF_MEMPOOL_BLOCK_SIZE(sizeof(int) * ((size) / 2)))
+#endif
+    
+    void    tRealFFT_forward        (tRealFFT* const, float* buffer);
+    void    tRealFFT_inverse        (tRealFFT* const, float* buffer);
+    int     tRealFFT_getSize        (tRealFFT* const);
+    
+    //==============================================================================
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LEAF_FFT_H_INCLUDED
+
+//==============================================================================
+
@@ -19,6 +19,7 @@ extern "C" {
 #include "leaf-mempool.h"
 #include "leaf-delay.h"
 #include "leaf-tables.h"
+#include "leaf-fft.h"
     
     /*!
      * @internal
@@ -30,6 +31,16 @@ extern "C" {
     
     //==============================================================================
     
+    /*!
+     * The _tickBlock functions process a block of samples with the filter's coefficients
+     * and state held in locals for the whole block. They perform the same arithmetic as the
+     * per-sample _tick functions, so their output is bit-identical as long as the compiler
+     * doesn't contract or vectorize the two paths differently (e.g. -ffp-contract=fast with
+     * FMA and SLP vectorization enabled on desktop targets).
+     */
+    
+    //==============================================================================
+    
     /*!
      @defgroup tallpass tAllpass
      @ingroup filters
@@ -50,6 +61,11 @@ extern "C" {
      @brief Free a tAllpass from its mempool.
      @param filter A pointer to the tAllpass to free.
      
+     @fn size_t  tAllpass_getRequiredSize (uint32_t maxDelay)
+     @brief Get the bytes tAllpass_initToPool() allocates from a first-fit mempool for the given parameters, as a constant expression that can size static memory.
+     @param maxDelay The maxDelay the tAllpass will be initialized with.
+     @return The size in bytes.
+     
      @fn float   tAllpass_tick           (tAllpass* const, float input)
      @brief
      @param filter A pointer to the relevant tAllpass.
@@ -81,6 +97,7 @@ extern "C" {
     void    tAllpass_init           (tAllpass* const, float initDelay, uint32_t maxDelay, LEAF* const leaf);
     void    tAllpass_initToPool     (tAllpass* const, float initDelay, uint32_t maxDelay, tMempool* const);
     void    tAllpass_free           (tAllpass* const);
+#define tAllpass_getRequiredSize(maxDelay) (LEAF_MEMPOOL_BLOCK_SIZE(sizeof(_tAllpass)) + tLinearDelay_getRequiredSize(maxDelay))
     
     float   tAllpass_tick           (tAllpass* const, float input);
     void    tAllpass_setGain        (tAllpass* const, float gain);
@@ -109,10 +126,21 @@ extern "C" {
      @brief Free a tOnePole from its mempool.
      @param filter A pointer to the tOnePole to free.
      
+     @fn size_t  tOnePole_getRequiredSize (void)
+     @brief Get the bytes tOnePole_initToPool() allocates from a first-fit mempool, as a constant expression that can size static memory.
+     @return The size in bytes.
+     
      @fn float   tOnePole_tick           (tOnePole* const, float input)
      @brief
      @param filter A pointer to the relevant tOnePole.
      
+     @fn void    tOnePole_tickBlock (tOnePole* const, const float* input, float* output, int size)
+     @brief Process a block of samples. Output is identical to calling tOnePole_tick on each sample.
+     @param filter A pointer to the relevant tOnePole.
+     @param input A pointer to the input block.
+     @param output A pointer to the output block. May be the same as input.
+     @param size The number of samples to process.
+     
      @fn void    tOnePole_setB0          (tOnePole* const, float b0)
      @brief
      @param filter A pointer to the relevant tOnePole.
@@ -156,8 +184,10 @@ extern "C" {
     void    tOnePole_init           (tOnePole* const, float thePole, LEAF* const leaf);
     void    tOnePole_initToPool     (tOnePole* const, float thePole, tMempool* const);
     void    tOnePole_free           (tOnePole* const);
+#define tOnePole_getRequiredSize() LEAF_MEMPOOL_BLOCK_SIZE(sizeof(_tOnePole))
     
     float   tOnePole_tick           (tOnePole* const, float input);
+    void    tOnePole_tickBlock      (tOnePole* const, const float* input, float* output, int size);
     void    tOnePole_setB0          (tOnePole* const, float b0);
     void    tOnePole_setA1          (tOnePole* const, float a1);
     void    tOnePole_setPole        (tOnePole* const, float thePole);
@@ -188,10 +218,21 @@ extern "C" {
      @brief Free a tTwoPole from its mempool.
      @param filter A pointer to the tTwoPole to free.
      
+     @fn size_t  tTwoPole_getRequiredSize (void)
+     @brief Get the bytes tTwoPole_initToPool() allocates from a first-fit mempool, as a constant expression that can size static memory.
+     @return The size in bytes.
+     
      @fn float   tTwoPole_tick           (tTwoPole* const, float input)
      @brief
      @param filter A pointer to the relevant tTwoPole.
      
+     @fn void    tTwoPole_tickBlock (tTwoPole* const, const float* input, float* output, int size)
+     @brief Process a block of samples. Output is identical to calling tTwoPole_tick on each sample.
+     @param filter A pointer to the relevant tTwoPole.
+     @param input A pointer to the input block.
+     @param output A pointer to the output block. May be the same as input.
+     @param size The number of samples to process.
+     
      @fn void    tTwoPole_setB0          (tTwoPole* const, float b0)
      @brief
      @param filter A pointer to the relevant tTwoPole.
@@ -241,8 +282,10 @@ extern "C" {
     void    tTwoPole_init           (tTwoPole* const, LEAF* const leaf);
     void    tTwoPole_initToPool     (tTwoPole* const, tMempool* const);
     void    tTwoPole_free           (tTwoPole* const);
+#define tTwoPole_getRequiredSize() LEAF_MEMPOOL_BLOCK_SIZE(sizeof(_tTwoPole))
     
     float   tTwoPole_tick           (tTwoPole* const, float input);
+    void    tTwoPole_tickBlock      (tTwoPole* const, const float* input, float* output, int size);
     void    tTwoPole_setB0          (tTwoPole* const, float b0);
     void    tTwoPole_setA1          (tTwoPole* const, float a1);
     void    tTwoPole_setA2          (tTwoPole* const, float a2);
@@ -273,10 +316,21 @@ extern "C" {
      @brief Free a tOneZero from its mempool.
      @param filter A pointer to the tOneZero to free.
      
+     @fn size_t  tOneZero_getRequiredSize (void)
+     @brief Get the bytes tOneZero_initToPool() allocates from a first-fit mempool, as a constant expression that can size static memory.
+     @return The size in bytes.
+     
      @fn float   tOneZero_tick           (tOneZero* const, float input)
      @brief
      @param filter A pointer to the relevant tOneZero.
      
+     @fn void    tOneZero_tickBlock (tOneZero* const, const float* input, float* output, int size)
+     @brief Process a block of samples. Output is identical to calling tOneZero_tick on each sample.
+     @param filter A pointer to the relevant tOneZero.
+     @param input A pointer to the input block.
+     @param output A pointer to the output block. May be the same as input.
+     @param size The number of samples to process.
+     
      @fn void    tOneZero_setB0          (tOneZero* const, float b0)
      @brief
      @param filter A pointer to the relevant tOneZero.
@@ -317,8 +371,10 @@ extern "C" {
     void    tOneZero_init           (tOneZero* const, float theZero, LEAF* const leaf);
     void    tOneZero_initToPool     (tOneZero* const, float theZero, tMempool* const);
     void    tOneZero_free           (tOneZero* const);
+#define tOneZero_getRequiredSize() LEAF_MEMPOOL_BLOCK_SIZE(sizeof(_tOneZero))
     
     float   tOneZero_tick           (tOneZero* const, float input);
+    void    tOneZero_tickBlock      (tOneZero* const, const float* input, float* output, int size);
     void    tOneZero_setB0          (tOneZero* const, float b0);
     void    tOneZero_setB1          (tOneZero* const, float b1);
     void    tOneZero_setZero        (tOneZero* const, float theZero);
@@ -349,10 +405,21 @@ extern "C" {
      @brief Free a tTwoZero from its mempool.
      @param filter A pointer to the tTwoZero to free.
      
+     @fn size_t  tTwoZero_getRequiredSize (void)
+     @brief Get the bytes tTwoZero_initToPool() allocates from a first-fit mempool, as a constant expression that can size static memory.
+     @return The size in bytes.
+     
      @fn float   tTwoZero_tick           (tTwoZero* const, float input)
      @brief
      @param filter A pointer to the relevant tTwoZero.
      
+     @fn void    tTwoZero_tickBlock (tTwoZero* const, const float* input, float* output, int size)
+     @brief Process a block of samples. Output is identical to calling tTwoZero_tick on each sample.
+     @param filter A pointer to the relevant tTwoZero.
+     @param input A pointer to the input block.
+     @param output A pointer to the output block. May be the same as input.
+     @param size The number of samples to process.
+     
      @fn void    tTwoZero_setB0          (tTwoZero* const, float b0)
      @brief
      @param filter A pointer to the relevant tTwoZero.
@@ -396,8 +463,10 @@ extern "C" {
     void    tTwoZero_init           (tTwoZero* const, LEAF* const leaf);
     void    tTwoZero_initToPool     (tTwoZero* const, tMempool* const);
     void    tTwoZero_free           (tTwoZero* const);
+#define tTwoZero_getRequiredSize() LEAF_MEMPOOL_BLOCK_SIZE(sizeof(_tTwoZero))
     
     float   tTwoZero_tick           (tTwoZero* const, float input);
+    void    tTwoZero_tickBlock      (tTwoZero* const, const float* input, float* output, int size);
     void    tTwoZero_setB0          (tTwoZero* const, float b0);
     void    tTwoZero_setB1          (tTwoZero* const, float b1);
     void    tTwoZero_setB2          (tTwoZero* const, float b2);
@@ -428,11 +497,22 @@ extern "C" {
      @brief Free a tPoleZero from its mempool.
      @param filter A pointer to the tPoleZero to free.
      
+     @fn size_t  tPoleZero_getRequiredSize (void)
+     @brief Get the bytes tPoleZero_initToPool() allocates from a first-fit mempool, as a constant expression that can size static memory.
+     @return The size in bytes.
+     
      
      @fn float   tPoleZero_tick              (tPoleZero* const, float input)
      @brief
      @param filter A pointer to the relevant tPoleZero.
      
+     @fn void    tPoleZero_tickBlock (tPoleZero* const, const float* input, float* output, int size)
+     @brief Process a block of samples. Output is identical to calling tPoleZero_tick on each sample.
+     @param filter A pointer to the relevant tPoleZero.
+     @param input A pointer to the input block.
+     @param output A pointer to the output block. May be the same as input.
+     @param size The number of samples to process.
+     
      @fn void    tPoleZero_setB0             (tPoleZero* const, float b0)
      @brief
      @param filter A pointer to the relevant tPoleZero.
@@ -481,8 +561,10 @@ extern "C" {
     void    tPoleZero_init              (tPoleZero* const, LEAF* const leaf);
     void    tPoleZero_initToPool        (tPoleZero* const, tMempool* const);
     void    tPoleZero_free              (tPoleZero* const);
+#define tPoleZero_getRequiredSize() LEAF_MEMPOOL_BLOCK_SIZE(sizeof(_tPoleZero))
     
     float   tPoleZero_tick              (tPoleZero* const, float input);
+    void    tPoleZero_tickBlock         (tPoleZero* const, const float* input, float* output, int size);
     void    tPoleZero_setB0             (tPoleZero* const, float b0);
     void    tPoleZero_setB1             (tPoleZero* const, float b1);
     void    tPoleZero_setA1             (tPoleZero* const, float a1);
@@ -513,11 +595,28 @@ extern "C" {
      @brief Free a tBiQuad from its mempool.
      @param filter A pointer to the tBiQuad to free.
      
+     @fn size_t  tBiQuad_getRequiredSize (void)
+     @brief Get the bytes tBiQuad_initToPool() allocates from a first-fit mempool, as a constant expression that can size static memory.
+     @return The size in bytes.
+     
      
      @fn float   tBiQuad_tick           (tBiQuad* const, float input)
      @brief
      @param filter A pointer to the relevant tBiQuad.
      
+     @fn void    tBiQuad_tickBlock (tBiQuad* const, const float* input, float* output, int size)
+     @brief Process a block of samples. Output is identical to calling tBiQuad_tick on each sample.
+     @param filter A pointer to the relevant tBiQuad.
+     @param input A pointer to the input block.
+     @param output A pointer to the output block. May be the same as input.
+     @param size The number of samples to process.
+     
+     @fn void    tBiQuad_tickView (tBiQuad* const, LEAFBufferView input, LEAFBufferView output)
+     @brief Process channel 0 of a buffer view in place or into another view, such as one channel of an interleaved DMA buffer. Output is identical to tBiQuad_tickBlock.
+     @param filter A pointer to the relevant tBiQuad.
+     @param input The input view. All of its frames are processed.
+     @param output The output view, with at least as many frames. May be the same as input.
+     
      @fn void    tBiQuad_setB0          (tBiQuad* const, float b0)
      @brief
      @param filter A pointer to the relevant tBiQuad.
@@ -561,12 +660,12 @@ extern "C" {
     {
         tMempool mempool;
         
-        float gain;
-        float a0, a1, a2;
-        float b0, b1, b2;
+        leaf_coeff_t gain;
+        leaf_coeff_t a0, a1, a2;
+        leaf_coeff_t b0, b1, b2;
         
-        float lastIn[2];
-        float lastOut[2];
+        leaf_coeff_t lastIn[2];
+        leaf_coeff_t lastOut[2];
         
         float frequency, radius;
         int normalize;
@@ -580,8 +679,11 @@ extern "C" {
     void    tBiQuad_init           (tBiQuad* const, LEAF* const leaf);
     void    tBiQuad_initToPool     (tBiQuad* const, tMempool* const);
     void    tBiQuad_free           (tBiQuad* const);
+#define tBiQuad_getRequiredSize() LEAF_MEMPOOL_BLOCK_SIZE(sizeof(_tBiQuad))
     
     float   tBiQuad_tick           (tBiQuad* const, float input);
+    void    tBiQuad_tickBlock      (tBiQuad* const, const float* input, float* output, int size);
+    void    tBiQuad_tickView       (tBiQuad* const, LEAFBufferView input, LEAFBufferView output);
     void    tBiQuad_setB0          (tBiQuad* const, float b0);
     void    tBiQuad_setB1          (tBiQuad* const, float b1);
     void    tBiQuad_setB2          (tBiQuad* const, float b2);
@@ -615,10 +717,42 @@ extern "C" {
      @brief Free a tSVF from its mempool.
      @param filter A pointer to the tSVF to free.
      
+     @fn size_t  tSVF_getRequiredSize (void)
+     @brief Get the bytes tSVF_initToPool() allocates from a first-fit mempool, as a constant expression that can size static memory.
+     @return The size in bytes.
+     
      @fn float   tSVF_tick           (tSVF* const, float v0)
      @brief
      @param filter A pointer to the relevant tSVF.
      
+     @fn void    tSVF_tickBlock (tSVF* const, const float* input, float* output, int size)
+     @brief Process a block of samples. Output is identical to calling tSVF_tick on each sample.
+     @param filter A pointer to the relevant tSVF.
+     @param input A pointer to the input block.
+     @param output A pointer to the output block. May be the same as input.
+     @param size The number of samples to process.
+     
+     @fn void    tSVF_tickView (tSVF* const, LEAFBufferView input, LEAFBufferView output)
+     @brief Process channel 0 of a buffer view in place or into another view, such as one channel of an interleaved DMA buffer. Output is identical to tSVF_tickBlock.
+     @param filter A pointer to the relevant tSVF.
+     @param input The input view. All of its frames are processed.
+     @param output The output view, with at least as many frames. May be the same as input.
+     
+     @fn float   tSVF_tickWithFreq   (tSVF* const, float v0, float freq)
+     @brief Set the cutoff frequency and tick the filter. Intended for audio rate cutoff modulation; the prewarped gain is computed with fasttanpif() instead of tanf(), which has a relative error below 3e-7 for cutoffs up to Nyquist.
+     @param filter A pointer to the relevant tSVF.
+     @param input The input sample.
+     @param freq The cutoff frequency in Hz.
+     @return The filtered sample.
+     
+     @fn void    tSVF_tickBlockWithFreq (tSVF* const, const float* input, const float* freq, float* output, int size)
+     @brief Process a block of samples with a per sample cutoff frequency. Equivalent to calling tSVF_tickWithFreq on each sample.
+     @param filter A pointer to the relevant tSVF.
+     @param input A pointer to the input block.
+     @param freq A pointer to a block of cutoff frequencies in Hz.
+     @param output A pointer to the output block. May be the same as input.
+     @param size The number of samples to process.
+     
      @fn void    tSVF_setFreq        (tSVF* const, float freq)
      @brief
      @param filter A pointer to the relevant tSVF.
@@ -649,8 +783,8 @@ extern "C" {
         tMempool mempool;
         SVFType type;
         float cutoff, Q;
-        float ic1eq,ic2eq;
-        float g,k,a1,a2,a3,cH,cB,cL,cBK;
+        leaf_coeff_t ic1eq,ic2eq;
+        leaf_coeff_t g,k,a1,a2,a3,cH,cB,cL,cBK;
         float sampleRate;
         float invSampleRate;
     } _tSVF;
@@ -660,8 +794,13 @@ extern "C" {
     void    tSVF_init           (tSVF* const, SVFType type, float freq, float Q, LEAF* const leaf);
     void    tSVF_initToPool     (tSVF* const, SVFType type, float freq, float Q, tMempool* const);
     void    tSVF_free           (tSVF* const);
+#define tSVF_getRequiredSize() LEAF_MEMPOOL_BLOCK_SIZE(sizeof(_tSVF))
     
     float   tSVF_tick           (tSVF* const, float v0);
+    void    tSVF_tickBlock      (tSVF* const, const float* input, float* output, int size);
+    void    tSVF_tickView       (tSVF* const, LEAFBufferView input, LEAFBufferView output);
+    float   tSVF_tickWithFreq   (tSVF* const, float v0, float freq);
+    void    tSVF_tickBlockWithFreq (tSVF* const, const float* input, const float* freq, float* output, int size);
     void    tSVF_setFreq        (tSVF* const, float freq);
     void    tSVF_setQ           (tSVF* const, float Q);
     void    tSVF_setFreqAndQ    (tSVF* const svff, float freq, float Q);
@@ -689,10 +828,21 @@ extern "C" {
      @brief Free a tEfficientSVF from its mempool.
      @param filter A pointer to the tEfficientSVF to free.
      
+     @fn size_t  tEfficientSVF_getRequiredSize (void)
+     @brief Get the bytes tEfficientSVF_initToPool() allocates from a first-fit mempool, as a constant expression that can size static memory.
+     @return The size in bytes.
+     
      @fn float   tEfficientSVF_tick          (tEfficientSVF* const, float v0)
      @brief
      @param filter A pointer to the relevant tEfficientSVF.
      
+     @fn void    tEfficientSVF_tickBlock (tEfficientSVF* const, const float* input, float* output, int size)
+     @brief Process a block of samples. Output is identical to calling tEfficientSVF_tick on each sample.
+     @param filter A pointer to the relevant tEfficientSVF.
+     @param input A pointer to the input block.
+     @param output A pointer to the output block. May be the same as input.
+     @param size The number of samples to process.
+     
      @fn void    tEfficientSVF_setFreq       (tEfficientSVF* const, uint16_t controlFreq)
      @brief
      @param filter A pointer to the relevant tEfficientSVF.
@@ -718,8 +868,10 @@ extern "C" {
     void    tEfficientSVF_init          (tEfficientSVF* const, SVFType type, uint16_t input, float Q, LEAF* const leaf);
     void    tEfficientSVF_initToPool    (tEfficientSVF* const, SVFType type, uint16_t input, float Q, tMempool* const);
     void    tEfficientSVF_free          (tEfficientSVF* const);
+#define tEfficientSVF_getRequiredSize() LEAF_MEMPOOL_BLOCK_SIZE(sizeof(_tEfficientSVF))
     
     float   tEfficientSVF_tick          (tEfficientSVF* const, float v0);
+    void    tEfficientSVF_tickBlock     (tEfficientSVF* const, const float* input, float* output, int size);
     void    tEfficientSVF_setFreq       (tEfficientSVF* const, uint16_t controlFreq);
     void    tEfficientSVF_setQ          (tEfficientSVF* const, float Q);
     
@@ -745,10 +897,21 @@ extern "C" {
      @brief Free a tHighpass from its mempool.
      @param filter A pointer to the tHighpass to free.
      
+     @fn size_t  tHighpass_getRequiredSize (void)
+     @brief Get the bytes tHighpass_initToPool() allocates from a first-fit mempool, as a constant expression that can size static memory.
+     @return The size in bytes.
+     
      @fn float   tHighpass_tick          (tHighpass* const, float x)
      @brief
      @param filter A pointer to the relevant tHighpass.
      
+     @fn void    tHighpass_tickBlock (tHighpass* const, const float* input, float* output, int size)
+     @brief Process a block of samples. Output is identical to calling tHighpass_tick on each sample.
+     @param filter A pointer to the relevant tHighpass.
+     @param input A pointer to the input block.
+     @param output A pointer to the output block. May be the same as input.
+     @param size The number of samples to process.
+     
      @fn void    tHighpass_setFreq       (tHighpass* const, float freq)
      @brief
      @param filter A pointer to the relevant tHighpass.
@@ -772,8 +935,10 @@ extern "C" {
     void    tHighpass_init          (tHighpass* const, float freq, LEAF* const leaf);
     void    tHighpass_initToPool    (tHighpass* const, float freq, tMempool* const);
     void    tHighpass_free          (tHighpass* const);
+#define tHighpass_getRequiredSize() LEAF_MEMPOOL_BLOCK_SIZE(sizeof(_tHighpass))
     
     float   tHighpass_tick          (tHighpass* const, float x);
+    void    tHighpass_tickBlock     (tHighpass* const, const float* input, float* output, int size);
     void    tHighpass_setFreq       (tHighpass* const, float freq);
     float   tHighpass_getFreq       (tHighpass* const);
     void    tHighpass_setSampleRate (tHighpass* const, float sr);
@@ -810,6 +975,13 @@ extern "C" {
      @brief
      @param filter A pointer to the relevant tButterworth.
      
+     @fn void    tButterworth_tickBlock (tButterworth* const, const float* input, float* output, int size)
+     @brief Process a block of samples. Output is identical to calling tButterworth_tick on each sample.
+     @param filter A pointer to the relevant tButterworth.
+     @param input A pointer to the input block.
+     @param output A pointer to the output block. May be the same as input.
+     @param size The number of samples to process.
+     
      @fn void    tButterworth_setF1          (tButterworth* const, float in)
      @brief
      @param filter A pointer to the relevant tButterworth.
@@ -845,6 +1017,7 @@ extern "C" {
     void    tButterworth_free           (tButterworth* const);
     
     float   tButterworth_tick           (tButterworth* const, float input);
+    void    tButterworth_tickBlock      (tButterworth* const, const float* input, float* output, int size);
     void    tButterworth_setF1          (tButterworth* const, float in);
     void    tButterworth_setF2          (tButterworth* const, float in);
     void    tButterworth_setFreqs       (tButterworth* const, float f1, float f2);
@@ -872,9 +1045,21 @@ extern "C" {
      @brief Free a tFIR from its mempool.
      @param filter A pointer to the tFIR to free.
      
+     @fn size_t  tFIR_getRequiredSize (int numTaps)
+     @brief Get the bytes tFIR_initToPool() allocates from a first-fit mempool for the given parameters, as a constant expression that can size static memory.
+     @param numTaps The number of taps the tFIR will be initialized with.
+     @return The size in bytes.
+     
      @fn float   tFIR_tick           (tFIR* const, float input)
      @brief
      @param filter A pointer to the relevant tFIR.
+     
+     @fn void    tFIR_tickBlock (tFIR* const, const float* input, float* output, int size)
+     @brief Process a block of samples. Output is identical to calling tFIR_tick on each sample.
+     @param filter A pointer to the relevant tFIR.
+     @param input A pointer to the input block.
+     @param output A pointer to the output block. May be the same as input.
+     @param size The number of samples to process.
      ￼￼￼
      @} */
     
@@ -892,9 +1077,102 @@ extern "C" {
     void    tFIR_init           (tFIR* const, float* coeffs, int numTaps, LEAF* const leaf);
     void    tFIR_initToPool     (tFIR* const, float* coeffs, int numTaps, tMempool* const);
     void    tFIR_free           (tFIR* const);
+#define tFIR_getRequiredSize(numTaps) (LEAF_MEMPOOL_BLOCK_SIZE(sizeof(_tFIR)) + LEAF_MEMPOOL_BLOCK_SIZE(sizeof(float) * (numTaps)))
     
     float   tFIR_tick           (tFIR* const, float input);
+    void    tFIR_tickBlock      (tFIR* const, const float* input, float* output, int size);
+    
+    //==============================================================================
+    
+    /*!
+     @defgroup tconvolver tConvolver
+     @ingroup filters
+     @brief Partitioned FFT convolution for long impulse responses such as cabinet IRs and linear-phase EQs.
+     
+     Uses uniformly partitioned overlap-save convolution, so the cost grows with the number of partitions
+     rather than the number of taps. The output is delayed by the partition size. The FFT for each partition
+     runs when a partition of input has been collected, so for an even load use a partition size equal to
+     the audio block size.
+     @{
+     
+     @fn void    tConvolver_init         (tConvolver* const, const float* ir, int irLength, int partitionSize, LEAF* const leaf)
+     @brief Initialize a tConvolver to the default mempool of a LEAF instance.
+     @param convolver A pointer to the tConvolver to initialize.
+     @param ir The impulse response. It is copied, so it doesn't need to stay valid.
+     @param irLength The length of the impulse response in samples. This is also the maximum length for tConvolver_setImpulseResponse, rounded up to a whole partition.
+     @param partitionSize The partition size in samples, rounded up to a power of two.
+     @param leaf A pointer to the leaf instance.
+     
+     @fn void    tConvolver_initToPool   (tConvolver* const, const float* ir, int irLength, int partitionSize, tMempool* const)
+     @brief Initialize a tConvolver to a specified mempool.
+     @param convolver A pointer to the tConvolver to initialize.
+     @param ir The impulse response.
+     @param irLength The length of the impulse response in samples.
+     @param partitionSize The partition size in samples, rounded up to a power of two.
+     @param mempool A pointer to the tMempool to use.
+     
+     @fn void    tConvolver_free         (tConvolver* const)
+     @brief Free a tConvolver from its mempool.
+     @param convolver A pointer to the tConvolver to free.
+     
+     @fn float   tConvolver_tick         (tConvolver* const, float input)
+     @brief Process one sample.
+     @param convolver A pointer to the relevant tConvolver.
+     @param input The input sample.
+     @return The convolved sample, delayed by the partition size.
+     
+     @fn void    tConvolver_tickBlock    (tConvolver* const, const float* input, float* output, int size)
+     @brief Process a block of samples. Output is identical to calling tConvolver_tick on each sample.
+     @param convolver A pointer to the relevant tConvolver.
+     @param input A pointer to the input block.
+     @param output A pointer to the output block. May be the same as input.
+     @param size The number of samples to process.
+     
+     @fn void    tConvolver_setImpulseResponse (tConvolver* const, const float* ir, int irLength)
+     @brief Replace the impulse response. Transforms every partition, so avoid calling it from audio processing for long responses.
+     @param convolver A pointer to the relevant tConvolver.
+     @param ir The impulse response.
+     @param irLength The length of the impulse response, truncated to the length given at initialization.
+     
+     @fn int     tConvolver_getLatency   (tConvolver* const)
+     @brief Get the delay of the output in samples, equal to the partition size.
+     @param convolver A pointer to the relevant tConvolver.
+     
+     @fn void    tConvolver_clear        (tConvolver* const)
+     @brief Clear the input history and pending output.
+     @param convolver A pointer to the relevant tConvolver.
+     
+     @} */
     
+    typedef struct _tConvolver
+    {
+        tMempool mempool;
+        tRealFFT fft;
+        float* irSpectra;
+        float* fdl;
+        float* window;
+        float* accum;
+        float* inbuf;
+        float* outbuf;
+        int partitionSize;
+        int fftSize;
+        int numPartitions;
+        int maxLength;
+        int fdlIndex;
+        int position;
+    } _tConvolver;
+    
+    typedef _tConvolver* tConvolver;
+    
+    void    tConvolver_init         (tConvolver* const, const float* ir, int irLength, int partitionSize, LEAF* const leaf);
+    void    tConvolver_initToPool   (tConvolver* const, const float* ir, int irLength, int partitionSize, tMempool* const);
+    void    tConvolver_free         (tConvolver* const);
+    
+    float   tConvolver_tick         (tConvolver* const, float input);
+    void    tConvolver_tickBlock    (tConvolver* const, const float* input, float* output, int size);
+    void    tConvolver_setImpulseResponse (tConvolver* const, const float* ir, int irLength);
+    int     tConvolver_getLatency   (tConvolver* const);
+    void    tConvolver_clear        (tConvolver* const);
     
     //==============================================================================
     
@@ -902,6 +1180,7 @@ extern "C" {
      @defgroup tmedianfilter tMedianFilter
      @ingroup filters
      @brief Median filter.
+     @details The window is kept in a max heap and a min heap either side of the median, so each sample costs O(log size) however long the window is.
      @{
      
      @fn void    tMedianFilter_init           (tMedianFilter* const, int size, LEAF* const leaf)
@@ -918,9 +1197,16 @@ extern "C" {
      @brief Free a tMedianFilter from its mempool.
      @param filter A pointer to the tMedianFilter to free.
      
+     @fn size_t  tMedianFilter_getRequiredSize (int size)
+     @brief Get the bytes tMedianFilter_initToPool() allocates from a first-fit mempool for the given parameters, as a constant expression that can size static memory.
+     @param size The size the tMedianFilter will be initialized with, at least 1.
+     @return The size in bytes.
+     
      @fn float   tMedianFilter_tick           (tMedianFilter* const, float input)
-     @brief
+     @brief Add a sample to the window.
      @param filter A pointer to the relevant tMedianFilter.
+     @param input The new sample.
+     @return The median of the last size samples. With an even size this is the upper of the middle two.
      ￼￼￼
      @} */
     
@@ -928,12 +1214,13 @@ extern "C" {
     {
         
         tMempool mempool;
-        float* val;
-        int* age;
-        int m;
+        float* val;         // the window, oldest sample at pos
+        int* heapIndex;     // where each sample of the window is in the heap
+        int* heapMemory;
+        int* heap;          // samples ordered around heap[0], the median
         int size;
-        int middlePosition;
-        int last;
+        int maxCount;       // samples in the max heap at heap[-1] and below
+        int minCount;       // samples in the min heap at heap[1] and above
         int pos;
     } _tMedianFilter;
     
@@ -942,6 +1229,7 @@ extern "C" {
     void    tMedianFilter_init           (tMedianFilter* const, int size, LEAF* const leaf);
     void    tMedianFilter_initToPool     (tMedianFilter* const, int size, tMempool* const);
     void    tMedianFilter_free           (tMedianFilter* const);
+#define tMedianFilter_getRequiredSize(size) (LEAF_MEMPOOL_BLOCK_SIZE(sizeof(_tMedianFilter)) + LEAF_MEMPOOL_BLOCK_SIZE(sizeof(float) * (size)) + 2 * LEAF_MEMPOOL_BLOCK_SIZE(sizeof(int) * (size)))
     
     float   tMedianFilter_tick           (tMedianFilter* const, float input);
     
@@ -966,14 +1254,32 @@ extern "C" {
      @brief Free a tVZFilter from its mempool.
      @param filter A pointer to the tVZFilter to free.
      
+     @fn size_t  tVZFilter_getRequiredSize (void)
+     @brief Get the bytes tVZFilter_initToPool() allocates from a first-fit mempool, as a constant expression that can size static memory.
+     @return The size in bytes.
+     
      @fn float   tVZFilter_tick               (tVZFilter* const, float input)
      @brief
      @param filter A pointer to the relevant tVZFilter.
      
+     @fn void    tVZFilter_tickBlock (tVZFilter* const, const float* input, float* output, int size)
+     @brief Process a block of samples. Output is identical to calling tVZFilter_tick on each sample.
+     @param filter A pointer to the relevant tVZFilter.
+     @param input A pointer to the input block.
+     @param output A pointer to the output block. May be the same as input.
+     @param size The number of samples to process.
+     
      @fn float   tVZFilter_tickEfficient               (tVZFilter* const vf, float in)
      @brief
      @param filter A pointer to the relevant tVZFilter.
      
+     @fn void    tVZFilter_tickEfficientBlock (tVZFilter* const, const float* input, float* output, int size)
+     @brief Process a block of samples. Output is identical to calling tVZFilter_tickEfficient on each sample.
+     @param filter A pointer to the relevant tVZFilter.
+     @param input A pointer to the input block.
+     @param output A pointer to the output block. May be the same as input.
+     @param size The number of samples to process.
+     
      @fn void    tVZFilter_calcCoeffs           (tVZFilter* const)
      @brief
      @param filter A pointer to the relevant tVZFilter.
@@ -1054,10 +1360,13 @@ extern "C" {
     void    tVZFilter_init           (tVZFilter* const, VZFilterType type, float freq, float Q, LEAF* const leaf);
     void    tVZFilter_initToPool     (tVZFilter* const, VZFilterType type, float freq, float Q, tMempool* const);
     void    tVZFilter_free           (tVZFilter* const);
+#define tVZFilter_getRequiredSize() LEAF_MEMPOOL_BLOCK_SIZE(sizeof(_tVZFilter))
     
     void    tVZFilter_setSampleRate  (tVZFilter* const, float sampleRate);
     float   tVZFilter_tick               (tVZFilter* const, float input);
+    void    tVZFilter_tickBlock          (tVZFilter* const, const float* input, float* output, int size);
     float   tVZFilter_tickEfficient               (tVZFilter* const vf, float in);
+    void    tVZFilter_tickEfficientBlock          (tVZFilter* const, const float* input, float* output, int size);
     void    tVZFilter_calcCoeffs           (tVZFilter* const);
     void    tVZFilter_calcCoeffsEfficientBP           (tVZFilter* const);
     void    tVZFilter_setBandwidth            (tVZFilter* const, float bandWidth);
@@ -1090,14 +1399,30 @@ extern "C" {
      @brief Free a tDiodeFilter from its mempool.
      @param filter A pointer to the tDiodeFilter to free.
      
+     @fn size_t  tDiodeFilter_getRequiredSize (void)
+     @brief Get the bytes tDiodeFilter_initToPool() allocates from a first-fit mempool, as a constant expression that can size static memory.
+     @return The size in bytes.
+     
      @fn float   tDiodeFilter_tick               (tDiodeFilter* const, float input)
      @brief
      @param filter A pointer to the relevant tDiodeFilter.
      
+     @fn void    tDiodeFilter_tickBlock (tDiodeFilter* const, const float* input, float* output, int size)
+     @brief Process a block of samples. Output is identical to calling tDiodeFilter_tick on each sample.
+     @param filter A pointer to the relevant tDiodeFilter.
+     @param input A pointer to the input block.
+     @param output A pointer to the output block. May be the same as input.
+     @param size The number of samples to process.
+     
      @fn void    tDiodeFilter_setFreq     (tDiodeFilter* const vf, float cutoff)
      @brief
      @param filter A pointer to the relevant tDiodeFilter.
      
+     @fn void    tDiodeFilter_setFreqFast     (tDiodeFilter* const vf, float cutoff)
+     @brief Same as tDiodeFilter_setFreq but uses fasttanpif() instead of tanf(), for audio rate cutoff modulation.
+     @param filter A pointer to the relevant tDiodeFilter.
+     @param cutoff The cutoff frequency in Hz.
+     
      @fn void    tDiodeFilter_setQ     (tDiodeFilter* const vf, float resonance)
      @brief
      @param filter A pointer to the relevant tDiodeFilter.
@@ -1127,9 +1452,12 @@ extern "C" {
     void    tDiodeFilter_init           (tDiodeFilter* const, float freq, float Q, LEAF* const leaf);
     void    tDiodeFilter_initToPool     (tDiodeFilter* const, float freq, float Q, tMempool* const);
     void    tDiodeFilter_free           (tDiodeFilter* const);
+#define tDiodeFilter_getRequiredSize() LEAF_MEMPOOL_BLOCK_SIZE(sizeof(_tDiodeFilter))
     
     float   tDiodeFilter_tick               (tDiodeFilter* const, float input);
+    void    tDiodeFilter_tickBlock          (tDiodeFilter* const, const float* input, float* output, int size);
     void    tDiodeFilter_setFreq     (tDiodeFilter* const vf, float cutoff);
+    void    tDiodeFilter_setFreqFast     (tDiodeFilter* const vf, float cutoff);
     void    tDiodeFilter_setQ     (tDiodeFilter* const vf, float resonance);
     void    tDiodeFilter_setSampleRate(tDiodeFilter* const vf, float sr);
     
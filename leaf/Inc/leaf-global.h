@@ -14,15 +14,215 @@
 #ifdef __cplusplus
 extern "C" {
 #endif
-    
+
+#include <stdint.h>
 #include "leaf-mempool.h"
-    
+
 #if _WIN32 || _WIN64
 #include "..\leaf-config.h"
 #else
 #include "../leaf-config.h"
 #endif
-    
+
+    /*!
+     * @ingroup leaf
+     * @brief Sample type of the sine and envelope tables, set by LEAF_TABLE_PRECISION in leaf-config.h. Read entries with LEAF_TABLE_READ().
+     */
+#if LEAF_TABLE_PRECISION == LEAF_TABLE_Q15
+    typedef int16_t leaf_table_t;
+#else
+    typedef float leaf_table_t;
+#endif
+
+    /*!
+     * @ingroup leaf
+     * @brief Sample type of delay line buffers, set by LEAF_SAMPLE_PRECISION in leaf-config.h. Convert with LEAF_SAMPLE_FROM_FLOAT() and LEAF_SAMPLE_TO_FLOAT().
+     */
+#if LEAF_SAMPLE_PRECISION == LEAF_PRECISION_Q31
+    typedef int32_t leaf_sample_t;
+
+    static inline int32_t leaf_floatToQ31(float x)
+    {
+        if (x >= 1.0f) return INT32_MAX;
+        if (x < -1.0f) return INT32_MIN;
+        return (int32_t) (x * 2147483648.0f);
+    }
+
+#define LEAF_SAMPLE_FROM_FLOAT(x) leaf_floatToQ31(x)
+#define LEAF_SAMPLE_TO_FLOAT(x) ((float) (x) * (1.0f / 2147483648.0f))
+#elif LEAF_SAMPLE_PRECISION == LEAF_PRECISION_FLOAT64
+    typedef double leaf_sample_t;
+#define LEAF_SAMPLE_FROM_FLOAT(x) ((leaf_sample_t) (x))
+#define LEAF_SAMPLE_TO_FLOAT(x) ((float) (x))
+#else
+    typedef float leaf_sample_t;
+#define LEAF_SAMPLE_FROM_FLOAT(x) (x)
+#define LEAF_SAMPLE_TO_FLOAT(x) (x)
+#endif
+
+    /*!
+     * @ingroup leaf
+     * @brief Arithmetic type of filter coefficients and state and oscillator phase, set by LEAF_COEFF_PRECISION in leaf-config.h.
+     */
+#if LEAF_COEFF_PRECISION == LEAF_PRECISION_FLOAT64
+    typedef double leaf_coeff_t;
+#elif LEAF_COEFF_PRECISION == LEAF_PRECISION_FLOAT32
+    typedef float leaf_coeff_t;
+#else
+#error "LEAF_COEFF_PRECISION must be LEAF_PRECISION_FLOAT32 or LEAF_PRECISION_FLOAT64"
+#endif
+
+    /*!
+     * @ingroup leaf
+     * @brief 1 when objects check their recursive state for denormals on every tick, from LEAF_NO_DENORMAL_CHECK and LEAF_FLUSH_DENORMALS in leaf-config.h.
+     */
+#if LEAF_NO_DENORMAL_CHECK || LEAF_FLUSH_DENORMALS
+#define LEAF_DENORMAL_CHECK 0
+#else
+#define LEAF_DENORMAL_CHECK 1
+#endif
+
+    /*!
+     * @ingroup leaf
+     * @brief Added to the input or feedback of reverbs and strings when LEAF_DENORMAL_CHECK is off, with its sign flipped every block so DC blockers in the loop can't remove it. About -300 dB, which leaves room for objects that square their signal to track its level.
+     */
+#define LEAF_DENORMAL_OFFSET 1.0e-15f
+
+    /*!
+     * @ingroup leaf
+     * @brief Acquire/release access to an index shared between exactly two threads, used by the lock-free single-producer/single-consumer objects.
+     * @details Each index has one writer. The writer publishes with leaf_storeRelease() after filling the data the index covers, and the other side reads it with leaf_loadAcquire() before touching that data. Words written by more than two threads, like the allocation counters and the tVoiceRenderer deques, use leaf_fetchAdd() and leaf_compareExchange(), which return the value the word held before.
+     */
+#if defined(__GNUC__) || defined(__clang__)
+    static inline uint32_t leaf_loadAcquire(volatile uint32_t* const ptr) { return __atomic_load_n(ptr, __ATOMIC_ACQUIRE); }
+    static inline void leaf_storeRelease(volatile uint32_t* const ptr, uint32_t value) { __atomic_store_n(ptr, value, __ATOMIC_RELEASE); }
+    static inline uint32_t leaf_exchange(volatile uint32_t* const ptr, uint32_t value) { return __atomic_exchange_n(ptr, value, __ATOMIC_ACQ_REL); }
+    static inline uint32_t leaf_fetchAdd(volatile uint32_t* const ptr, uint32_t value) { return __atomic_fetch_add(ptr, value, __ATOMIC_ACQ_REL); }
+    static inline uint32_t leaf_compareExchange(volatile uint32_t* const ptr, uint32_t expected, uint32_t value) { __atomic_compare_exchange_n(ptr, &expected, value, 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE); return expected; }
+#elif defined(_MSC_VER)
+#include <intrin.h>
+#if defined(_M_IX86) || defined(_M_X64)
+    // x86 and x64 already order plain loads and stores this way, only the compiler needs holding back
+    static __forceinline uint32_t leaf_loadAcquire(volatile uint32_t* const ptr) { uint32_t value = *ptr; _ReadWriteBarrier(); return value; }
+    static __forceinline void leaf_storeRelease(volatile uint32_t* const ptr, uint32_t value) { _ReadWriteBarrier(); *ptr = value; }
+#elif defined(_M_ARM64)
+    // ARM64 reorders plain loads and stores, so use its load-acquire and store-release instructions
+    static __forceinline uint32_t leaf_loadAcquire(volatile uint32_t* const ptr) { return __ldar32((volatile unsigned __int32*) ptr); }
+    static __forceinline void leaf_storeRelease(volatile uint32_t* const ptr, uint32_t value) { __stlr32((volatile unsigned __int32*) ptr, value); }
+#else
+    // Interlocked operations are full barriers on every target
+    static __forceinline uint32_t leaf_loadAcquire(volatile uint32_t* const ptr) { return (uint32_t) _InterlockedOr((volatile long*) ptr, 0); }
+    static __forceinline void leaf_storeRelease(volatile uint32_t* const ptr, uint32_t value) { _InterlockedExchange((volatile long*) ptr, (long) value); }
+#endif
+    static __forceinline uint32_t leaf_exchange(volatile uint32_t* const ptr, uint32_t value) { return (uint32_t) _InterlockedExchange((volatile long*) ptr, (long) value); }
+    static __forceinline uint32_t leaf_fetchAdd(volatile uint32_t* const ptr, uint32_t value) { return (uint32_t) _InterlockedExchangeAdd((volatile long*) ptr, (long) value); }
+    static __forceinline uint32_t leaf_compareExchange(volatile uint32_t* const ptr, uint32_t expected, uint32_t value) { return (uint32_t) _InterlockedCompareExchange((volatile long*) ptr, (long) value, (long) expected); }
+#else
+    // Plain reads and writes can't make the read-modify-write operations atomic, so a silent fallback would race
+#error "LEAF needs atomic operations: build with GCC, Clang or MSVC, or add leaf_loadAcquire, leaf_storeRelease, leaf_exchange, leaf_fetchAdd and leaf_compareExchange for this compiler"
+#endif
+
+    /*!
+     * @ingroup leaf
+     * @brief A view onto multichannel float audio in memory owned by the caller, such as a DMA buffer, so view based block functions can process it in place.
+     * @details Sample i of channel c is data[i * frameStride + c * channelStride]. Make one with LEAF_viewInterleaved() or LEAF_viewPlanar() and pick out a channel with LEAF_viewChannel(). Mono objects process channel 0 of the views they're given.
+     */
+    typedef struct LEAFBufferView
+    {
+        float* data; //!< The first sample of channel 0.
+        int frames; //!< The number of samples in each channel.
+        int channels; //!< The number of channels.
+        int frameStride; //!< The distance in floats from one sample of a channel to the next.
+        int channelStride; //!< The distance in floats from one channel to the next.
+    } LEAFBufferView;
+
+    //! A view of frames of interleaved audio, channel 0 first in each frame.
+    static inline LEAFBufferView LEAF_viewInterleaved(float* data, int frames, int channels)
+    {
+        LEAFBufferView view;
+        view.data = data;
+        view.frames = frames;
+        view.channels = channels;
+        view.frameStride = channels;
+        view.channelStride = 1;
+        return view;
+    }
+
+    //! A view of planar audio, with each channel's frames contiguous and the channels one after another.
+    static inline LEAFBufferView LEAF_viewPlanar(float* data, int frames, int channels)
+    {
+        LEAFBufferView view;
+        view.data = data;
+        view.frames = frames;
+        view.channels = channels;
+        view.frameStride = 1;
+        view.channelStride = frames;
+        return view;
+    }
+
+    //! A one channel view of a channel of another view.
+    static inline LEAFBufferView LEAF_viewChannel(LEAFBufferView view, int channel)
+    {
+        view.data += channel * view.channelStride;
+        view.channels = 1;
+        return view;
+    }
+
+#if LEAF_PROFILE
+    /*!
+     * @ingroup leaf
+     * @brief Timing of one instrumented function, kept by a LEAF instance when LEAF_PROFILE is on. Times are in the units of the time-stamp callback given to LEAF_setProfileCallback().
+     */
+    typedef struct LEAFProfileEntry
+    {
+        const char* name; //!< The function, such as "tSVF_tickBlock".
+        uint32_t calls; //!< Calls timed since the last LEAF_resetProfile().
+        uint32_t minTime; //!< The shortest call.
+        uint32_t maxTime; //!< The longest call.
+        uint64_t totalTime; //!< All calls added up. Divide by calls for the mean.
+        uint32_t blockTime; //!< Time spent in this function since the last LEAF_profileEndBlock().
+        uint32_t worstBlockTime; //!< The most time spent in this function during one block.
+    } LEAFProfileEntry;
+
+    // Filled in at the start of an instrumented function and recorded when it returns
+    typedef struct LEAFProfileScope
+    {
+        LEAF* leaf;
+        const char* name;
+        int* slot;
+        uint32_t start;
+    } LEAFProfileScope;
+
+    void LEAF_profileEnter(LEAFProfileScope* const scope);
+    void LEAF_profileExit(LEAFProfileScope* const scope);
+
+#ifdef __cplusplus
+    struct LEAFProfileGuard
+    {
+        LEAFProfileScope scope;
+        LEAFProfileGuard(LEAF* leaf, const char* name, int* slot) { scope.leaf = leaf; scope.name = name; scope.slot = slot; scope.start = 0; LEAF_profileEnter(&scope); }
+        ~LEAFProfileGuard() { LEAF_profileExit(&scope); }
+    };
+#define LEAF_PROFILE_ENTER(leaf) static int leafProfileSlot = -1; LEAFProfileGuard leafProfileGuard((leaf), __func__, &leafProfileSlot)
+#elif defined(__GNUC__) || defined(__clang__)
+    // The cleanup attribute records the call on every return path
+#define LEAF_PROFILE_ENTER(leaf) static int leafProfileSlot = -1; \
+    LEAFProfileScope leafProfileScope __attribute__((cleanup(LEAF_profileExit))) = { (leaf), __func__, &leafProfileSlot, 0 }; \
+    LEAF_profileEnter(&leafProfileScope)
+#else
+#error "LEAF_PROFILE needs GCC, Clang or a C++ build of LEAF"
+#endif
+#else
+#define LEAF_PROFILE_ENTER(leaf)
+#endif
+
+    /*!
+     * @ingroup leaf
+     * @brief Time the rest of an object function when LEAF_PROFILE is on, or nothing when it's off. LEAF_PROFILE_OBJECT() takes the object handle passed to a tick or block function, and LEAF_PROFILE_POOL() the mempool passed to an init function. Every object struct starts with its tMempool, which leads to the LEAF instance.
+     */
+#define LEAF_PROFILE_OBJECT(obj) LEAF_PROFILE_ENTER((*(tMempool*) *(obj))->leaf)
+#define LEAF_PROFILE_POOL(mp) LEAF_PROFILE_ENTER((*(mp))->leaf)
+
     /*!
      * @ingroup leaf
      * @brief Struct for an instance of LEAF.
@@ -33,7 +233,8 @@ extern "C" {
         ///@{ 
         float   sampleRate; //!< The current audio sample rate. Set with LEAF_setSampleRate().
         float   invSampleRate; //!< The inverse of the current sample rate.
-        int     blockSize; //!< The audio block size.
+        int     blockSize; //!< The audio block size. Set with LEAF_setBlockSize().
+        int     controlRate; //!< The number of samples between ticks of control rate objects created from now on. Set with LEAF_setControlRate().
         float   twoPiTimesInvSampleRate; //!<  Two-pi times the inverse of the current sample rate.
         float   (*random)(void); //!< A pointer to the random() function provided on initialization.
         int     clearOnAllocation; //!< A flag that determines whether memory allocated from the LEAF memory pool will be cleared.
@@ -42,13 +243,23 @@ extern "C" {
         size_t header_size; //!< The size in bytes of memory region headers within mempools.
         void (*errorCallback)(LEAF* const, LEAFErrorType); //!< A pointer to the callback function for LEAF errors. Can be set by the user.
         int     errorState[LEAFErrorNil]; //!< An array of flags that indicate which errors have occurred.
-        unsigned int allocCount; //!< A count of LEAF memory allocations.
-        unsigned int freeCount; //!< A count of LEAF memory frees.
+        volatile uint32_t allocCount; //!< A count of LEAF memory allocations, counted atomically so mempools on different cores can allocate at once.
+        volatile uint32_t freeCount; //!< A count of LEAF memory frees, counted atomically so mempools on different cores can free at once.
+#if LEAF_PROFILE
+        uint32_t (*profileTime)(void); //!< The time-stamp callback set with LEAF_setProfileCallback(), or NULL to record nothing.
+        int     profileDepth; //!< How many instrumented calls are in progress. Only the outermost is recorded.
+        int     numProfileEntries; //!< The number of entries in profile.
+        LEAFProfileEntry profile[LEAF_PROFILE_MAX_ENTRIES]; //!< Per-function timing. Use LEAF_getProfileEntry().
+#endif
+#if LEAF_GENERATE_TABLES
+        leaf_table_t* sineTable; //!< The sine table built by LEAF_init(). Use LEAF_getSineTable().
+        leaf_table_t* expDecayTable; //!< The exponential decay table built by LEAF_init(). Use LEAF_getExpDecayTable().
+#endif
         ///@}
     };
     
     //==============================================================================
-    
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,234 @@
+/*==============================================================================
+
+ leaf-graph.h
+ 
+ ==============================================================================*/
+
+#ifndef LEAF_GRAPH_H_INCLUDED
+#define LEAF_GRAPH_H_INCLUDED
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+    //==============================================================================
+
+#include "leaf-global.h"
+#include "leaf-mempool.h"
+#include "leaf-oscillators.h"
+#include "leaf-filters.h"
+#include "leaf-dynamics.h"
+#include "leaf-reverb.h"
+
+    /*!
+     * @internal
+     * Header.
+     * @include basic-oscillators.h
+     * @example basic-oscillators.c
+     * An example.
+     */
+    
+    //==============================================================================
+    
+    /*!
+     @defgroup tgraph tGraph
+     @ingroup graph
+     @brief A patch of LEAF objects run a block at a time in dependency order.
+     @details Nodes wrap objects through block adapters, either the tGraph_add functions for common objects or tGraph_addNode() with a callback of your own. Edges go from a node's output port to another node's input port. tGraph_compile() sorts the nodes so every node runs after the nodes feeding it, and gives each output port a block buffer from the graph's mempool. A buffer is handed on to later nodes as soon as its last reader has run, so a patch needs about as many buffers as signals alive at once, not one per connection.
+     
+     tGraph_process() then runs the whole patch on a block. Blocks longer than the graph's maximum block size are run in pieces. The graph itself doesn't allocate or sort while processing, but tGraph_compile() does, so compile before audio starts and again after changing connections.
+     @{
+     
+     @fn void    tGraph_init             (tGraph* const graph, int maxNodes, int maxBlockSize, LEAF* const leaf)
+     @brief Initialize a tGraph to the default mempool of a LEAF instance.
+     @param graph A pointer to the tGraph to initialize.
+     @param maxNodes The largest number of nodes the graph can hold, including inputs and outputs.
+     @param maxBlockSize The largest block processed in one pass.
+     @param leaf A pointer to the leaf instance.
+     
+     @fn void    tGraph_initToPool       (tGraph* const graph, int maxNodes, int maxBlockSize, tMempool* const mempool)
+     @brief Initialize a tGraph to a specified mempool.
+     @param graph A pointer to the tGraph to initialize.
+     @param maxNodes The largest number of nodes the graph can hold, including inputs and outputs.
+     @param maxBlockSize The largest block processed in one pass.
+     @param mempool A pointer to the tMempool to use.
+     
+     @fn void    tGraph_free             (tGraph* const graph)
+     @brief Free a tGraph from its mempool. The objects its nodes wrap are not freed.
+     @param graph A pointer to the tGraph to free.
+     
+     @fn int     tGraph_addNode          (tGraph* const graph, void* object, tGraphProcessCallback process, int numInputs, int numOutputs, int inPlace)
+     @brief Add a node that runs a block callback on an object.
+     @param graph A pointer to the relevant tGraph.
+     @param object Passed to the callback, usually a pointer to a LEAF object.
+     @param process Called with the node's input and output blocks and the block size.
+     @param numInputs The number of input ports, up to LEAF_GRAPH_MAX_PORTS. Unconnected inputs read silence.
+     @param numOutputs The number of output ports, up to LEAF_GRAPH_MAX_PORTS.
+     @param inPlace 1 if the callback still works when any output block is the same as any input block, which lets the graph reuse buffers more.
+     @return The node's index, or -1 if the graph is full or the port counts are out of range.
+     
+     @fn int     tGraph_addInput         (tGraph* const graph)
+     @brief Add a node with one output that reads an input block of tGraph_process(). Inputs are numbered in the order they're added.
+     @param graph A pointer to the relevant tGraph.
+     @return The node's index, or -1 if the graph is full.
+     
+     @fn int     tGraph_addOutput        (tGraph* const graph)
+     @brief Add a node with one input that writes an output block of tGraph_process(). Outputs are numbered in the order they're added.
+     @param graph A pointer to the relevant tGraph.
+     @return The node's index, or -1 if the graph is full.
+     
+     @fn int     tGraph_addSum           (tGraph* const graph, int numInputs)
+     @brief Add a node with one output that sums its inputs.
+     @param graph A pointer to the relevant tGraph.
+     @param numInputs The number of input ports, up to LEAF_GRAPH_MAX_PORTS.
+     @return The node's index, or -1 if the graph is full.
+     
+     @fn int     tGraph_addCycle         (tGraph* const graph, tCycle* const osc)
+     @brief Add a node with no inputs and one output that runs tCycle_tickBlock().
+     @param graph A pointer to the relevant tGraph.
+     @param osc A pointer to a tCycle, which must outlive the graph.
+     @return The node's index, or -1 if the graph is full.
+     
+     @fn int     tGraph_addBiQuad        (tGraph* const graph, tBiQuad* const filter)
+     @brief Add a node with one input and one output that runs tBiQuad_tickBlock().
+     @param graph A pointer to the relevant tGraph.
+     @param filter A pointer to a tBiQuad, which must outlive the graph.
+     @return The node's index, or -1 if the graph is full.
+     
+     @fn int     tGraph_addSVF           (tGraph* const graph, tSVF* const filter)
+     @brief Add a node with one input and one output that runs tSVF_tickBlock().
+     @param graph A pointer to the relevant tGraph.
+     @param filter A pointer to a tSVF, which must outlive the graph.
+     @return The node's index, or -1 if the graph is full.
+     
+     @fn int     tGraph_addCompressor    (tGraph* const graph, tCompressor* const compressor)
+     @brief Add a node with one input and one output that runs tCompressor_tickBlock().
+     @param graph A pointer to the relevant tGraph.
+     @param compressor A pointer to a tCompressor, which must outlive the graph.
+     @return The node's index, or -1 if the graph is full.
+     
+     @fn int     tGraph_addDattorroReverb (tGraph* const graph, tDattorroReverb* const reverb)
+     @brief Add a node with one input and two outputs, left and right, that runs tDattorroReverb_tickStereoBlock().
+     @param graph A pointer to the relevant tGraph.
+     @param reverb A pointer to a tDattorroReverb, which must outlive the graph.
+     @return The node's index, or -1 if the graph is full.
+     
+     @fn int     tGraph_addFDNReverb     (tGraph* const graph, tFDNReverb* const reverb)
+     @brief Add a node with one input and two outputs, left and right, that runs tFDNReverb_tickStereoBlock().
+     @param graph A pointer to the relevant tGraph.
+     @param reverb A pointer to a tFDNReverb, which must outlive the graph.
+     @return The node's index, or -1 if the graph is full.
+     
+     @fn int     tGraph_connect          (tGraph* const graph, int source, int sourcePort, int dest, int destPort)
+     @brief Feed an output port of one node into an input port of another, replacing whatever fed that input before. An output can feed any number of inputs. Takes effect at the next tGraph_compile().
+     @param graph A pointer to the relevant tGraph.
+     @param source The index of the node to read from.
+     @param sourcePort The output port to read from.
+     @param dest The index of the node to feed.
+     @param destPort The input port to feed.
+     @return 1 if connected, 0 if a node or port is out of range.
+     
+     @fn void    tGraph_disconnect       (tGraph* const graph, int dest, int destPort)
+     @brief Leave an input port unconnected, so it reads silence. Takes effect at the next tGraph_compile().
+     @param graph A pointer to the relevant tGraph.
+     @param dest The index of the node.
+     @param destPort The input port.
+     
+     @fn int     tGraph_compile          (tGraph* const graph)
+     @brief Sort the nodes and assign their buffers. Allocates from the graph's mempool, so don't call it while the graph is processing.
+     @param graph A pointer to the relevant tGraph.
+     @return 1 on success, or 0 if the connections contain a cycle, in which case the graph outputs silence until it compiles.
+     
+     @fn int     tGraph_getNumBuffers    (tGraph* const graph)
+     @brief Get the number of block buffers the last tGraph_compile() needed.
+     @param graph A pointer to the relevant tGraph.
+     @return The number of buffers, not counting the graph's inputs and its silent buffer.
+     
+     @fn void    tGraph_process          (tGraph* const graph, float** inputs, float** outputs, int size)
+     @brief Run the patch on a block.
+     @param graph A pointer to the relevant tGraph.
+     @param inputs One input block for each tGraph_addInput() node, in the order they were added.
+     @param outputs One output block for each tGraph_addOutput() node, in the order they were added. Outputs may be the same as inputs.
+     @param size The number of samples in the block.
+     
+     @} */
+
+#define LEAF_GRAPH_MAX_PORTS 4
+
+    typedef void (*tGraphProcessCallback)(void* object, float** inputs, float** outputs, int size);
+    
+    typedef enum GraphNodeType
+    {
+        GraphNodeObject = 0,
+        GraphNodeInput,
+        GraphNodeOutput,
+        GraphNodeTypeNil
+    } GraphNodeType;
+    
+    typedef struct tGraphNode
+    {
+        void* object;
+        tGraphProcessCallback process;
+        int type; // A GraphNodeType
+        int io; // Which graph input or output, for those nodes
+        int numInputs, numOutputs;
+        int inPlace;
+        int source[LEAF_GRAPH_MAX_PORTS]; // The node feeding each input, or -1
+        int sourcePort[LEAF_GRAPH_MAX_PORTS];
+        int inBuffer[LEAF_GRAPH_MAX_PORTS]; // Buffers assigned by tGraph_compile
+        int outBuffer[LEAF_GRAPH_MAX_PORTS];
+    } tGraphNode;
+    
+    typedef struct _tGraph
+    {
+        tMempool mempool;
+        
+        tGraphNode* nodes;
+        int numNodes, maxNodes;
+        int numInputs, numOutputs;
+        int maxBlockSize;
+        
+        int* order;
+        int* scratch;
+        float** buffers; // Silence, then the graph inputs, then numBuffers pooled blocks
+        float* arena;
+        int numBuffers;
+        int compiled;
+    } _tGraph;
+    
+    typedef _tGraph* tGraph;
+    
+    void    tGraph_init             (tGraph* const graph, int maxNodes, int maxBlockSize, LEAF* const leaf);
+    void    tGraph_initToPool       (tGraph* const graph, int maxNodes, int maxBlockSize, tMempool* const mempool);
+    void    tGraph_free             (tGraph* const graph);
+    
+    int     tGraph_addNode          (tGraph* const graph, void* object, tGraphProcessCallback process, int numInputs, int numOutputs, int inPlace);
+    int     tGraph_addInput         (tGraph* const graph);
+    int     tGraph_addOutput        (tGraph* const graph);
+    int     tGraph_addSum           (tGraph* const graph, int numInputs);
+#if LEAF_INCLUDE_SINE_TABLE
+    int     tGraph_addCycle         (tGraph* const graph, tCycle* const osc);
+#endif
+    int     tGraph_addBiQuad        (tGraph* const graph, tBiQuad* const filter);
+    int     tGraph_addSVF           (tGraph* const graph, tSVF* const filter);
+    int     tGraph_addCompressor    (tGraph* const graph, tCompressor* const compressor);
+    int     tGraph_addDattorroReverb (tGraph* const graph, tDattorroReverb* const reverb);
+    int     tGraph_addFDNReverb     (tGraph* const graph, tFDNReverb* const reverb);
+    
+    int     tGraph_connect          (tGraph* const graph, int source, int sourcePort, int dest, int destPort);
+    void    tGraph_disconnect       (tGraph* const graph, int dest, int destPort);
+    int     tGraph_compile          (tGraph* const graph);
+    int     tGraph_getNumBuffers    (tGraph* const graph);
+    
+    void    tGraph_process          (tGraph* const graph, float** inputs, float** outputs, int size);
+    
+    //==============================================================================
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LEAF_GRAPH_H_INCLUDED
+
+//==============================================================================
+
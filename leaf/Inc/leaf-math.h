@@ -148,6 +148,9 @@ extern "C" {
 
     float fastertanf(float fAngle);
 
+    // tan(PI * x) for x in [0, 0.5), relative error < 3e-7
+    float fasttanpif(float x);
+
 
     // alternative implementation for abs()
     // REQUIRES: 32 bit integers
@@ -230,6 +233,7 @@ extern "C" {
     // or let the user pointer popcount() to whatever they want
     // something to look into...
     int popcount(unsigned int x);
+    int popcount64(uint64_t x);
     
     float median3f(float a, float b, float c);
 
@@ -237,6 +241,63 @@ extern "C" {
 
     void place_slope_dd(float *buffer, int index, float phase, float w, float slope_delta);
 
+    // Control rate state for an object that is ticked once every few samples and interpolated in between.
+    // An object holding one counts down to its next tick and ramps from its last output to the new one
+    // over the following divider samples, so its block output lags by one control period. Only block
+    // functions run at the control rate. The object's time coefficients are computed for scale samples
+    // per tick, and it switches them between 1 and the divider if its tick and block functions are mixed.
+    typedef struct LEAFControlRate
+    {
+        int divider; // samples per control tick, 1 for audio rate
+        int scale; // samples per tick the object's coefficients are currently computed for
+        int count; // samples left of the current ramp
+        float value, target, inc;
+    } LEAFControlRate;
+
+    void LEAF_controlRateInit(LEAFControlRate* const control, int divider, float value);
+    void LEAF_controlRateSetTarget(LEAFControlRate* const control, float target);
+    int LEAF_controlRateFill(LEAFControlRate* const control, float* output, int size);
+
+    // Tail detection for an object whose output dies away once its input stops. Its blocks hear their
+    // input and output, and once both have stayed under the threshold for holdSamples the object is
+    // quiescent: LEAF_quiescenceBegin() returns 1 and the object writes zeros instead of processing, until
+    // its input goes over the threshold or it is woken. holdSamples should be at least the longest time
+    // the object's state takes to reach its output, so nothing over the threshold is still inside it.
+    // A threshold of 0 turns this off, at the cost of one compare per block.
+    typedef struct LEAFQuiescence
+    {
+        float threshold; // absolute level, 0 for off
+        int holdSamples;
+        int quietSamples; // samples in a row under the threshold, up to holdSamples
+        int lastLoud; // last sample over the threshold in the current block, or -1
+    } LEAFQuiescence;
+
+    void LEAF_quiescenceInit(LEAFQuiescence* const q, float threshold, int holdSamples);
+    int LEAF_quiescenceBegin(LEAFQuiescence* const q, const float* input, int stride, int size);
+    void LEAF_quiescenceHear(LEAFQuiescence* const q, const float* x, int stride, int size);
+    void LEAF_quiescenceEnd(LEAFQuiescence* const q, int size);
+    void LEAF_quiescenceWake(LEAFQuiescence* const q);
+    int LEAF_quiescenceIsQuiet(LEAFQuiescence* const q);
+
+    // Block versions of the fast approximations, shared by the block processing in other modules. Each has
+    // NEON, Helium and SSE2 paths under LEAF_USE_SIMD and a scalar loop for the rest of a block or other
+    // targets. Output may be the same array as input.
+    //
+    // LEAF_exp2Block is 2^x with the polynomial of fastexp2f, relative error under 4e-6, with x clamped
+    // to [-126, 126]. LEAF_mtofBlock and LEAF_dbtoaBlock scale into it, so they have about the same relative
+    // error (0.007 cents for mtof) and clamp notes to about +/-1512 and levels to about +/-758 dB.
+    //
+    // LEAF_tanhBlock is LEAF_tanh, which is within 0.024 of tanhf. Paths without a vector divide
+    // (32-bit NEON and Helium) refine a reciprocal instead, and are within 3e-7 of LEAF_tanh.
+    //
+    // LEAF_interpolate_hermite_xBlock reads a circular buffer of the given length at each position, which
+    // must be in [0, length), with LEAF_interpolate_hermite_x.
+    void LEAF_exp2Block(const float* input, float* output, int size);
+    void LEAF_mtofBlock(const float* input, float* output, int size);
+    void LEAF_dbtoaBlock(const float* input, float* output, int size);
+    void LEAF_tanhBlock(const float* input, float* output, int size);
+    void LEAF_interpolate_hermite_xBlock(const float* buffer, int length, const float* position, float* output, int size);
+
     /*! @} */
 
     //==============================================================================
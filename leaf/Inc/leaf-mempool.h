@@ -47,6 +47,13 @@ extern "C" {
 #include <stdlib.h>
 #include <string.h>
 #include <stdbool.h>
+#include <stdint.h>
+
+#if _WIN32 || _WIN64
+#include "..\leaf-config.h"
+#else
+#include "../leaf-config.h"
+#endif
     
     //==============================================================================
     
@@ -59,6 +66,8 @@ extern "C" {
         LEAFMempoolOverrun = 0,
         LEAFMempoolFragmentation,
         LEAFInvalidFree,
+        LEAFInvalidImage,
+        LEAFInvalidBuffer,
         LEAFErrorNil
     } LEAFErrorType;
     
@@ -77,6 +86,64 @@ extern "C" {
         size_t size;
     } mpool_node_t;
     
+    //! Round a size up to the alignment of mempool allocations, as a constant expression.
+#define LEAF_MEMPOOL_ALIGN(size) (((size_t) (size) + (MPOOL_ALIGN_SIZE - 1)) & ~((size_t) (MPOOL_ALIGN_SIZE - 1)))
+    
+    //! The header in front of every allocation from a first-fit mempool, the same as the header_size of a LEAF instance.
+#define LEAF_MEMPOOL_HEADER_SIZE LEAF_MEMPOOL_ALIGN(sizeof(mpool_node_t))
+    
+    //! The bytes an allocation takes from a first-fit mempool, header included, as a constant expression.
+    /*!
+     Objects have tX_getRequiredSize() macros that add this up over every allocation their _initToPool function makes, so memory of the summed sizes holds exactly those objects in a first-fit pool. Arenas have no headers, so the same sizes are enough for a tArenaPool. TLSF pools round allocations up and keep their control structure in the pool, so they need more.
+     */
+#define LEAF_MEMPOOL_BLOCK_SIZE(size) (LEAF_MEMPOOL_HEADER_SIZE + LEAF_MEMPOOL_ALIGN(size))
+    
+    //! Allocation strategies for a tMempool.
+    typedef enum LEAFMempoolType
+    {
+        LEAFMempoolFirstFit = 0, //!< Single first-fit free list. Alloc and free are linear in the number of free blocks.
+        LEAFMempoolTLSF, //!< Two-level segregated fit. Alloc and free are O(1), and each request wastes at most 1/16 of its size to rounding.
+        LEAFMempoolSlab, //!< Fixed size blocks from an intrusive free list. See tSlabPool.
+        LEAFMempoolArena, //!< Bump pointer allocation. Freeing does nothing and mpool_reset() releases everything at once. See tArenaPool.
+        LEAFMempoolTypeNil
+    } LEAFMempoolType;
+    
+    // block header of a TLSF pool, same size as mpool_node_t so header_size applies to both pool types
+    typedef struct mpool_tlsf_block_t {
+        struct mpool_tlsf_block_t *prev_phys;  // physically previous block
+        struct mpool_tlsf_block_t *next_free;  // next block in the same size class, free blocks only
+        struct mpool_tlsf_block_t *prev_free;  // prev block in the same size class, free blocks only
+        size_t size;                           // size of the block's memory, low bits are status flags
+    } mpool_tlsf_block_t;
+    
+    // TLSF control structure, stored at the start of the pool's memory
+    typedef struct mpool_tlsf_t {
+        unsigned int         fl_bitmap;  // bit per first level class with any free block
+        int                  fl_count;   // number of first level classes needed for the pool size
+        unsigned int*        sl_bitmap;  // bit per second level class with any free block, one word per first level
+        mpool_tlsf_block_t** heads;      // free list heads, fl_count * second level count
+    } mpool_tlsf_t;
+    
+#if LEAF_POOL_STATS
+    //! Allocations made to a mempool while a tag was set with mpool_set_tag().
+    typedef struct LEAFMempoolTag {
+        const char*  name;       //!< The tag.
+        size_t       bytes;      //!< Total bytes requested under this tag.
+        unsigned int count;      //!< Number of allocations made under this tag.
+    } LEAFMempoolTag;
+    
+    //! Snapshot of a mempool's usage, filled in by mpool_get_stats().
+    typedef struct LEAFMempoolStats {
+        size_t       size;          //!< Total size of the mempool in bytes.
+        size_t       used;          //!< Bytes currently in use, including block headers.
+        size_t       peak;          //!< Highest value of used since the mempool was created or mpool_reset_peak() was called.
+        size_t       largestFree;   //!< Largest single allocation that could currently succeed.
+        int          freeBlocks;    //!< Number of free blocks. Many small free blocks means the mempool is fragmented.
+        unsigned int allocCount;    //!< Allocations made from this mempool.
+        unsigned int freeCount;     //!< Frees made to this mempool.
+    } LEAFMempoolStats;
+#endif
+
     typedef struct _tMempool _tMempool;
     typedef _tMempool* tMempool;
     struct _tMempool
@@ -87,6 +154,18 @@ extern "C" {
         size_t        usize;       // used size of the pool
         size_t        msize;       // max size of the pool
         mpool_node_t* head;        // first node of memory pool free list
+        LEAFMempoolType type;      // allocation strategy
+        mpool_tlsf_t* tlsf;        // TLSF control structure, NULL for first-fit pools
+        size_t        bsize;       // block size of a slab pool
+        char*         free_block;  // first block of a slab pool's free list
+#if LEAF_POOL_STATS
+        size_t        peak;        // high-water mark of usize
+        unsigned int  allocCount;  // allocations made from this pool
+        unsigned int  freeCount;   // frees made to this pool
+        const char*   tag;         // current allocation tag, NULL for untagged
+        int           numTags;
+        LEAFMempoolTag tags[LEAF_POOL_STATS_MAX_TAGS];
+#endif
     };
     
     //! Initialize a tMempool for a given memory location and size to the default mempool of a LEAF instance.
@@ -115,11 +194,273 @@ extern "C" {
      */
     void    tMempool_initToPool     (tMempool* const mp, char* memory, size_t size, tMempool* const mem);
 
+    
+    //! Initialize a tMempool with a given allocation strategy to the default mempool of a LEAF instance.
+    /*!
+     @param pool A pointer to the tMempool to initialize.
+     @param memory A pointer to the chunk of memory to be used as a mempool.
+     @param size The size of the chunk of memory to be used as a mempool.
+     @param type The allocation strategy. LEAFMempoolTLSF gives constant time allocation and freeing, which makes it suitable for allocating objects while audio is running. Its control structure is stored at the start of the given memory, so slightly less of it is available to objects (about 1 KB for a 1 MB pool on a 32-bit target).
+     @param leaf A pointer to the leaf instance.
+     */
+    void    tMempool_initWithType       (tMempool* const pool, char* memory, size_t size, LEAFMempoolType type, LEAF* const leaf);
+    
+    
+    //! Initialize a tMempool with a given allocation strategy to a specified mempool.
+    /*!
+     @param pool A pointer to the tMempool to initialize.
+     @param memory A pointer to the chunk of memory to be used as a mempool.
+     @param size The size of the chunk of memory to be used as a mempool.
+     @param type The allocation strategy.
+     @param poolTo A pointer to the tMempool to which this tMempool should be initialized.
+     */
+    void    tMempool_initToPoolWithType (tMempool* const mp, char* memory, size_t size, LEAFMempoolType type, tMempool* const mem);
+    
+    
+    //! Initialize a tMempool in storage the caller provides, allocating nothing from other mempools, e.g. to put a group of objects in tightly coupled memory.
+    /*!
+     With LEAF_USE_DYNAMIC_ALLOCATION on, only arenas keep their objects in the given memory, so use tArenaPool_initInPlace() to be sure of where objects go. Don't call tMempool_free() on the pool.
+     @param pool A pointer to the tMempool to initialize.
+     @param storage The struct for the tMempool itself, usually static.
+     @param memory The memory objects are allocated from, aligned to MPOOL_ALIGN_SIZE. The tX_getRequiredSize() macros of the objects it will hold add up to the size it needs.
+     @param size The size of memory.
+     @param type The allocation strategy. Slab pools need a block size, so use tSlabPool for those.
+     @param leaf A pointer to the leaf instance.
+     */
+    void    tMempool_initInPlace        (tMempool* const pool, _tMempool* const storage, char* memory, size_t size, LEAFMempoolType type, LEAF* const leaf);
+    
+    
+    //! Get the bytes tMempool_initToPool() allocates from a first-fit mempool, as a constant expression. The memory the new pool manages is passed in separately.
+#define tMempool_getRequiredSize() LEAF_MEMPOOL_BLOCK_SIZE(sizeof(_tMempool))
+    
     /*!￼￼￼
      @} */
     
     //==============================================================================
 
+    /*!
+     * @defgroup tslabpool tSlabPool
+     * @ingroup mempool
+     * @brief Pool of fixed size blocks for objects that are repeatedly initialized and freed, such as voices.
+     *
+     * A tSlabPool is a tMempool, so it can be passed to any _initToPool function. Allocations up to the
+     * block size pop a block off an intrusive free list and freeing pushes it back, both O(1) with no
+     * per-block header. Larger allocations (e.g. an object's internal buffers) are passed through to
+     * the parent mempool and are freed back to it, and only the parent's stats count them.
+     * @{
+     */
+    
+    typedef tMempool tSlabPool;
+    
+    //! Initialize a tSlabPool to the default mempool of a LEAF instance.
+    /*!
+     @param pool A pointer to the tSlabPool to initialize.
+     @param blockSize The size of each block, usually the sizeof of the object struct it will hold.
+     @param numBlocks The number of blocks.
+     @param leaf A pointer to the leaf instance.
+     */
+    void    tSlabPool_init          (tSlabPool* const pool, size_t blockSize, int numBlocks, LEAF* const leaf);
+    
+    
+    //! Initialize a tSlabPool to a specified mempool.
+    /*!
+     @param pool A pointer to the tSlabPool to initialize.
+     @param blockSize The size of each block, usually the sizeof of the object struct it will hold.
+     @param numBlocks The number of blocks.
+     @param mem A pointer to the tMempool the blocks and any larger allocations come from.
+     */
+    void    tSlabPool_initToPool    (tSlabPool* const pool, size_t blockSize, int numBlocks, tMempool* const mem);
+    
+    
+    //! Free a tSlabPool and its blocks from its mempool. Objects in the slab should be freed first.
+    /*!
+     @param pool A pointer to the tSlabPool to free.
+     */
+    void    tSlabPool_free          (tSlabPool* const pool);
+    
+    
+    //! Get the bytes tSlabPool_initToPool() allocates from a first-fit mempool, as a constant expression.
+#define tSlabPool_getRequiredSize(blockSize, numBlocks) (LEAF_MEMPOOL_BLOCK_SIZE(sizeof(_tMempool)) + LEAF_MEMPOOL_BLOCK_SIZE(LEAF_MEMPOOL_ALIGN((blockSize) < sizeof(char*) ? sizeof(char*) : (blockSize)) * (numBlocks)))
+    
+    /*! @} */
+    
+    //==============================================================================
+    
+    /*!
+     * @defgroup tarenapool tArenaPool
+     * @ingroup mempool
+     * @brief Bump pointer pool for a group of objects that are initialized together and discarded together, such as the objects of a preset.
+     *
+     * A tArenaPool is a tMempool, so it can be passed to any _initToPool function. Allocating moves a
+     * pointer along the arena, and freeing does nothing, so neither can fragment it or take longer as
+     * more objects are made. tArenaPool_reset() discards every object in the arena at once without
+     * calling their _free functions. Arenas bump allocate in LEAF_USE_DYNAMIC_ALLOCATION builds too,
+     * where only the arena's own memory comes from malloc().
+     * @{
+     */
+    
+    typedef tMempool tArenaPool;
+    
+    //! Initialize a tArenaPool to the default mempool of a LEAF instance.
+    /*!
+     @param pool A pointer to the tArenaPool to initialize.
+     @param size The size of the arena in bytes.
+     @param leaf A pointer to the leaf instance.
+     */
+    void    tArenaPool_init         (tArenaPool* const pool, size_t size, LEAF* const leaf);
+    
+    
+    //! Initialize a tArenaPool to a specified mempool.
+    /*!
+     @param pool A pointer to the tArenaPool to initialize.
+     @param size The size of the arena in bytes.
+     @param mem A pointer to the tMempool the arena is allocated from.
+     */
+    void    tArenaPool_initToPool   (tArenaPool* const pool, size_t size, tMempool* const mem);
+    
+    
+    //! Initialize a tArenaPool in storage the caller provides, allocating nothing from other mempools. Don't call tArenaPool_free() on it.
+    /*!
+     @param pool A pointer to the tArenaPool to initialize.
+     @param storage The struct for the tArenaPool itself, usually static.
+     @param memory The arena, aligned to MPOOL_ALIGN_SIZE.
+     @param size The size of the arena in bytes.
+     @param leaf A pointer to the leaf instance.
+     */
+    void    tArenaPool_initInPlace  (tArenaPool* const pool, _tMempool* const storage, char* memory, size_t size, LEAF* const leaf);
+    
+    
+    //! Free a tArenaPool and its memory from its mempool, discarding any objects still in it.
+    /*!
+     @param pool A pointer to the tArenaPool to free.
+     */
+    void    tArenaPool_free         (tArenaPool* const pool);
+    
+    
+    //! Discard every object in a tArenaPool so its whole size is available again. Takes constant time. Nothing may use the discarded objects afterwards.
+    /*!
+     @param pool A pointer to the tArenaPool to reset.
+     */
+    void    tArenaPool_reset        (tArenaPool* const pool);
+    
+    
+    //! Get the bytes tArenaPool_initToPool() allocates from a first-fit mempool for an arena of a given size, as a constant expression.
+#define tArenaPool_getRequiredSize(size) (LEAF_MEMPOOL_BLOCK_SIZE(sizeof(_tMempool)) + LEAF_MEMPOOL_BLOCK_SIZE(size))
+    
+    /*! @} */
+    
+    //==============================================================================
+    
+    /*!
+     * @defgroup tarenaswap tArenaSwap
+     * @ingroup mempool
+     * @brief Two tArenaPools for switching presets without freeing or initializing objects on the audio thread.
+     *
+     * The audio thread plays the preset in the active arena. A background thread calls
+     * tArenaSwap_beginBuild() to reset the other arena, initializes the next preset's objects into it,
+     * and hands the preset over with tArenaSwap_publish(). The audio thread calls tArenaSwap_swap()
+     * between blocks, which takes constant time: if a preset is waiting it becomes the active one, and
+     * the old preset's arena is left for the next build to reset. The preset is a pointer to whatever
+     * struct the application keeps its objects in, allocated from the same arena.
+     *
+     * Only one thread may build at a time. Objects built into the arenas mustn't be shared with the
+     * other arena or with other pools. The LEAF random function is called by objects that use it at
+     * initialization, so it must be safe to call from the background thread. LEAF_PROFILE timing
+     * isn't thread safe, so don't profile while a build runs.
+     * @{
+     */
+    
+    typedef struct _tArenaSwap
+    {
+        tMempool mempool;
+        
+        tArenaPool arenas[2];
+        void* presets[2];
+        int active; // Index of the arena the audio thread plays, only written by tArenaSwap_swap()
+        volatile uint32_t state; // Idle, building or published, handed between the two threads
+    } _tArenaSwap;
+    
+    typedef _tArenaSwap* tArenaSwap;
+    
+    //! Initialize a tArenaSwap to the default mempool of a LEAF instance.
+    /*!
+     @param swap A pointer to the tArenaSwap to initialize.
+     @param size The size of each of the two arenas in bytes.
+     @param leaf A pointer to the leaf instance.
+     */
+    void    tArenaSwap_init         (tArenaSwap* const swap, size_t size, LEAF* const leaf);
+    
+    
+    //! Initialize a tArenaSwap to a specified mempool.
+    /*!
+     @param swap A pointer to the tArenaSwap to initialize.
+     @param size The size of each of the two arenas in bytes.
+     @param mem A pointer to the tMempool both arenas are allocated from.
+     */
+    void    tArenaSwap_initToPool   (tArenaSwap* const swap, size_t size, tMempool* const mem);
+    
+    
+    //! Free a tArenaSwap and both of its arenas from its mempool. No build may be running.
+    /*!
+     @param swap A pointer to the tArenaSwap to free.
+     */
+    void    tArenaSwap_free         (tArenaSwap* const swap);
+    
+    
+    //! Start building the next preset, from a thread other than the audio thread.
+    /*!
+     @param swap A pointer to the relevant tArenaSwap.
+     @return The reset inactive arena to initialize the preset's objects to, or NULL if a build is already running or a published preset hasn't been swapped in yet.
+     */
+    tMempool* tArenaSwap_beginBuild (tArenaSwap* const swap);
+    
+    
+    //! Hand a built preset to the audio thread. Nothing in the arena may be touched by the building thread afterwards.
+    /*!
+     @param swap A pointer to the relevant tArenaSwap.
+     @param preset The preset, which tArenaSwap_getPreset() returns once it has been swapped in.
+     */
+    void    tArenaSwap_publish      (tArenaSwap* const swap, void* preset);
+    
+    
+    //! Abandon a build without publishing it. The arena is reset by the next build.
+    /*!
+     @param swap A pointer to the relevant tArenaSwap.
+     */
+    void    tArenaSwap_cancelBuild  (tArenaSwap* const swap);
+    
+    
+    //! Make a published preset the active one, from the audio thread between blocks. Takes constant time.
+    /*!
+     @param swap A pointer to the relevant tArenaSwap.
+     @return 1 if a new preset was swapped in, 0 if none was waiting.
+     */
+    int     tArenaSwap_swap         (tArenaSwap* const swap);
+    
+    
+    //! Get the active preset, from the audio thread.
+    /*!
+     @param swap A pointer to the relevant tArenaSwap.
+     @return The preset last swapped in, or NULL before the first swap.
+     */
+    void*   tArenaSwap_getPreset    (tArenaSwap* const swap);
+    
+    
+    //! Get the arena of the active preset, from the audio thread, e.g. to allocate more of its objects while it plays.
+    /*!
+     @param swap A pointer to the relevant tArenaSwap.
+     @return The active arena.
+     */
+    tMempool* tArenaSwap_getActivePool (tArenaSwap* const swap);
+    
+    
+    //! Get the bytes tArenaSwap_initToPool() allocates from a first-fit mempool for two arenas of a given size, as a constant expression.
+#define tArenaSwap_getRequiredSize(size) (LEAF_MEMPOOL_BLOCK_SIZE(sizeof(_tArenaSwap)) + 2 * tArenaPool_getRequiredSize(size))
+    
+    /*! @} */
+    
+    //==============================================================================
+    
     //    typedef struct mpool_t {
     //        char*         mpool;       // start of the mpool
     //        size_t        usize;       // used size of the pool
@@ -128,6 +469,10 @@ extern "C" {
     //    } mpool_t;
     
     void mpool_create (char* memory, size_t size, _tMempool* pool);
+    void mpool_create_tlsf (char* memory, size_t size, _tMempool* pool);
+    void mpool_create_slab (char* memory, size_t size, size_t blockSize, _tMempool* pool);
+    void mpool_create_arena (char* memory, size_t size, _tMempool* pool);
+    void mpool_reset (_tMempool* pool);
     
     char* mpool_alloc(size_t size, _tMempool* pool);
     char* mpool_calloc(size_t asize, _tMempool* pool);
@@ -149,6 +494,34 @@ extern "C" {
     
     char* leaf_pool_get_pool(LEAF* const leaf);
     
+#if LEAF_POOL_STATS
+    //! Get usage statistics for a mempool. Walks the free list, so it shouldn't be called from audio processing.
+    /*!
+     In dynamic allocation mode, allocations go to malloc() so only the alloc/free counts and tags are meaningful.
+     @param pool The mempool to report on.
+     @param stats A pointer to the LEAFMempoolStats to fill in.
+     */
+    void mpool_get_stats(_tMempool* pool, LEAFMempoolStats* stats);
+    
+    //! Reset the high-water mark of a mempool to its current usage.
+    void mpool_reset_peak(_tMempool* pool);
+    
+    //! Attribute following allocations from a mempool to a tag, e.g. around the initialization of a group of objects.
+    /*!
+     @param pool The mempool.
+     @param tag A string that stays valid while the mempool is in use, usually a literal. NULL stops tagging.
+     */
+    void mpool_set_tag(_tMempool* pool, const char* tag);
+    
+    //! Get the number of tags a mempool has recorded allocations under.
+    int mpool_get_num_tags(_tMempool* pool);
+    
+    //! Get a recorded tag of a mempool, in the order the tags were first used.
+    LEAFMempoolTag* mpool_get_tag(_tMempool* pool, int index);
+    
+    void leaf_pool_get_stats(LEAF* const leaf, LEAFMempoolStats* stats);
+#endif
+
 #ifdef __cplusplus
 }
 #endif
@@ -1,5 +1,5 @@
 /*==============================================================================
- 
+
  leaf-midi.h
  Created: 30 Nov 2018 11:29:26am
  Author:  airship
@@ -12,14 +12,14 @@
 #ifdef __cplusplus
 extern "C" {
 #endif
-    
+
     //==============================================================================
-    
+
 #include "leaf-global.h"
 #include "leaf-mempool.h"
 #include "leaf-math.h"
 #include "leaf-envelopes.h"
-    
+
     /*!
      * @internal
      * Header.
@@ -31,11 +31,11 @@ extern "C" {
     //==============================================================================
     
     // ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~
-
+    
     /*!
      @defgroup tstack tStack
      @ingroup midi
-     @brief A basic stack of integers with a fixed capacity of 128, used by tPoly to keep track of MIDI notes.
+     @brief A basic stack of integers with a fixed capacity of 128, used by tPoly to keep its notes in pitch order.
      @{
      
      @fn void    tStack_init                 (tStack* const stack, LEAF* const leaf)
@@ -52,6 +52,10 @@ extern "C" {
      @brief Free a tStack from its mempool.
      @param stack A pointer to the tStack to free.
      
+     @fn size_t  tStack_getRequiredSize (void)
+     @brief Get the bytes tStack_initToPool() allocates from a first-fit mempool, as a constant expression that can size static memory.
+     @return The size in bytes.
+     
      @fn void    tStack_setCapacity          (tStack* const stack, uint16_t cap)
      @brief Set the capacity of the stack.
      @param stack A pointer to the relevant tStack.
@@ -104,7 +108,7 @@ extern "C" {
      @return The value at the given index.
      
      @} */
-    
+
 #define STACK_SIZE 128
     typedef struct _tStack
     {
@@ -122,6 +126,7 @@ extern "C" {
     void    tStack_init                 (tStack* const stack, LEAF* const leaf);
     void    tStack_initToPool           (tStack* const stack, tMempool* const pool);
     void    tStack_free                 (tStack* const stack);
+#define tStack_getRequiredSize() LEAF_MEMPOOL_BLOCK_SIZE(sizeof(_tStack))
     
     void    tStack_setCapacity          (tStack* const stack, uint16_t cap);
     int     tStack_addIfNotAlreadyThere (tStack* const stack, uint16_t item);
@@ -134,6 +139,186 @@ extern "C" {
     int     tStack_next                 (tStack* const stack);
     int     tStack_get                  (tStack* const stack, int index);
     
+    //==============================================================================
+    
+    /*!
+     @defgroup tvoiceallocator tVoiceAllocator
+     @ingroup midi
+     @brief Assigns MIDI notes to voices in constant time, with a choice of how voices are stolen. Used by tPoly and tSimplePoly.
+     @details Every voice is on one of three lists: free, held or released. Each list is ordered from the oldest voice to the newest. A note-to-voice table replaces searches by note. A note that loses its voice to stealing stays held and waits on a list of stolen notes. The first voice to come free goes to the most recently stolen note. Note on, note off and freeing a voice take the same time however many voices or notes are in play. The one exception is stealing the quietest voice, which asks each candidate for its level.
+     @{
+     
+     @fn void    tVoiceAllocator_init          (tVoiceAllocator* const alloc, int maxNumVoices, LEAF* const leaf)
+     @brief Initialize a tVoiceAllocator to the default mempool of a LEAF instance.
+     @param alloc A pointer to the tVoiceAllocator to initialize.
+     @param maxNumVoices The maximum number of voices.
+     @param leaf A pointer to the leaf instance.
+     
+     @fn void    tVoiceAllocator_initToPool    (tVoiceAllocator* const alloc, int maxNumVoices, tMempool* const pool)
+     @brief Initialize a tVoiceAllocator to a specified mempool.
+     @param alloc A pointer to the tVoiceAllocator to initialize.
+     @param maxNumVoices The maximum number of voices.
+     @param mempool A pointer to the tMempool to use.
+     
+     @fn void    tVoiceAllocator_free          (tVoiceAllocator* const alloc)
+     @brief Free a tVoiceAllocator from its mempool.
+     @param alloc A pointer to the tVoiceAllocator to free.
+     
+     @fn int     tVoiceAllocator_noteOn        (tVoiceAllocator* const alloc, int note, int velocity)
+     @brief Give a note a voice: a free voice if there is one, then the oldest released voice, then a stolen one.
+     @details With VoiceStealSameNote, a voice still releasing the same note is reused first.
+     @param alloc A pointer to the relevant tVoiceAllocator.
+     @param note The MIDI note number, 0 to 127.
+     @param velocity The velocity.
+     @return The voice, or -1 if the note is already held or no voice could be had.
+     
+     @fn int     tVoiceAllocator_noteOff       (tVoiceAllocator* const alloc, int note)
+     @brief Stop holding a note and free its voice straight away.
+     @param alloc A pointer to the relevant tVoiceAllocator.
+     @param note The MIDI note number.
+     @return The freed voice, or -1 if the note had no voice or its voice went straight to a stolen note.
+     
+     @fn int     tVoiceAllocator_noteRelease   (tVoiceAllocator* const alloc, int note)
+     @brief Stop holding a note but leave its voice sounding on the released list until tVoiceAllocator_freeVoice().
+     @param alloc A pointer to the relevant tVoiceAllocator.
+     @param note The MIDI note number.
+     @return The released voice, or -1 if the note had no voice.
+     
+     @fn int     tVoiceAllocator_freeVoice     (tVoiceAllocator* const alloc, int voice)
+     @brief Free a released voice once it has finished sounding.
+     @param alloc A pointer to the relevant tVoiceAllocator.
+     @param voice The voice.
+     @return The stolen note the voice was given to, or -1 if it went on the free list.
+     
+     @fn void    tVoiceAllocator_setNumVoices  (tVoiceAllocator* const alloc, int numVoices)
+     @brief Set how many voices are available. Voices above the number finish what they are playing and are then left alone.
+     @param alloc A pointer to the relevant tVoiceAllocator.
+     @param numVoices The number of voices, up to the maximum given at initialization.
+     
+     @fn void    tVoiceAllocator_setStealMode  (tVoiceAllocator* const alloc, VoiceStealMode mode)
+     @brief Set which voice is taken when none is free or released. Defaults to VoiceStealOldest.
+     @param alloc A pointer to the relevant tVoiceAllocator.
+     @param mode VoiceStealOldest, VoiceStealQuietest, or VoiceStealSameNote.
+     
+     @fn void    tVoiceAllocator_setStealing   (tVoiceAllocator* const alloc, int stealing, int recoverStolen)
+     @brief Set whether held voices can be stolen, and whether stolen notes get the next voice to come free. Both default to on.
+     @param alloc A pointer to the relevant tVoiceAllocator.
+     @param stealing 1 to allow stealing.
+     @param recoverStolen 1 to give freed voices back to stolen notes.
+     
+     @fn void    tVoiceAllocator_setLevelCallback (tVoiceAllocator* const alloc, tVoiceLevelCallback callback, void* userData)
+     @brief Set the function that reports each voice's level for VoiceStealQuietest, usually its envelope value.
+     @param alloc A pointer to the relevant tVoiceAllocator.
+     @param callback The level callback, or NULL to steal the oldest voice instead.
+     @param userData Passed to the callback.
+     
+     @fn int     tVoiceAllocator_getVoice      (tVoiceAllocator* const alloc, int note)
+     @brief Get the voice holding or releasing a note.
+     @param alloc A pointer to the relevant tVoiceAllocator.
+     @param note The MIDI note number.
+     @return The voice, or -1 if no voice has the note.
+     
+     @fn int     tVoiceAllocator_getNote       (tVoiceAllocator* const alloc, int voice)
+     @brief Get the last note given to a voice, which it keeps through its release.
+     @param alloc A pointer to the relevant tVoiceAllocator.
+     @param voice The voice.
+     @return The MIDI note number, or -1 if the voice has never played.
+     
+     @fn int     tVoiceAllocator_getVelocity   (tVoiceAllocator* const alloc, int voice)
+     @brief Get the velocity of the note a voice is holding.
+     @param alloc A pointer to the relevant tVoiceAllocator.
+     @param voice The voice.
+     @return The velocity, or 0 if the voice isn't holding a note.
+     
+     @fn VoiceState tVoiceAllocator_getState   (tVoiceAllocator* const alloc, int voice)
+     @brief Get whether a voice is free, held, or released.
+     @param alloc A pointer to the relevant tVoiceAllocator.
+     @param voice The voice.
+     
+     @fn int     tVoiceAllocator_getNumHeld    (tVoiceAllocator* const alloc)
+     @brief Get the number of notes held, counting those waiting for a voice.
+     @param alloc A pointer to the relevant tVoiceAllocator.
+     
+     @fn int     tVoiceAllocator_getStolenNote (tVoiceAllocator* const alloc)
+     @brief Get the note that lost its voice to the last note on.
+     @param alloc A pointer to the relevant tVoiceAllocator.
+     @return The MIDI note number, or -1 if the last note on didn't steal.
+     
+     @} */
+    
+    typedef enum VoiceState
+    {
+        VoiceFree = 0,
+        VoiceHeld,
+        VoiceReleased,
+        VoiceStateNil
+    } VoiceState;
+    
+    typedef enum VoiceStealMode
+    {
+        VoiceStealOldest = 0,
+        VoiceStealQuietest,
+        VoiceStealSameNote,
+        VoiceStealModeNil
+    } VoiceStealMode;
+    
+    typedef float (*tVoiceLevelCallback)(void* userData, int voice);
+    
+    typedef struct _tVoiceAllocator
+    {
+        tMempool mempool;
+        
+        int numVoices;
+        int maxNumVoices;
+        
+        // Per voice, with prev and next linking it into the list for its state
+        int* voiceNote;
+        int* voiceVelocity;
+        uint8_t* voiceState;
+        int8_t* voiceList; // the list the voice is on, or -1 if it is above numVoices and on none
+        int* prev;
+        int* next;
+        int head[VoiceStateNil];
+        int tail[VoiceStateNil];
+        
+        // Per note
+        int noteVoice[128];
+        int noteVelocity[128];
+        uint8_t noteHeld[128];
+        int stolenPrev[128];
+        int stolenNext[128];
+        int stolenHead;
+        int numHeld;
+        int stolenNote;
+        
+        VoiceStealMode stealMode;
+        int stealing;
+        int recoverStolen;
+        tVoiceLevelCallback levelCallback;
+        void* levelUserData;
+    } _tVoiceAllocator;
+    
+    typedef _tVoiceAllocator* tVoiceAllocator;
+    
+    void    tVoiceAllocator_init          (tVoiceAllocator* const alloc, int maxNumVoices, LEAF* const leaf);
+    void    tVoiceAllocator_initToPool    (tVoiceAllocator* const alloc, int maxNumVoices, tMempool* const pool);
+    void    tVoiceAllocator_free          (tVoiceAllocator* const alloc);
+    
+    int     tVoiceAllocator_noteOn        (tVoiceAllocator* const alloc, int note, int velocity);
+    int     tVoiceAllocator_noteOff       (tVoiceAllocator* const alloc, int note);
+    int     tVoiceAllocator_noteRelease   (tVoiceAllocator* const alloc, int note);
+    int     tVoiceAllocator_freeVoice     (tVoiceAllocator* const alloc, int voice);
+    void    tVoiceAllocator_setNumVoices  (tVoiceAllocator* const alloc, int numVoices);
+    void    tVoiceAllocator_setStealMode  (tVoiceAllocator* const alloc, VoiceStealMode mode);
+    void    tVoiceAllocator_setStealing   (tVoiceAllocator* const alloc, int stealing, int recoverStolen);
+    void    tVoiceAllocator_setLevelCallback (tVoiceAllocator* const alloc, tVoiceLevelCallback callback, void* userData);
+    int     tVoiceAllocator_getVoice      (tVoiceAllocator* const alloc, int note);
+    int     tVoiceAllocator_getNote       (tVoiceAllocator* const alloc, int voice);
+    int     tVoiceAllocator_getVelocity   (tVoiceAllocator* const alloc, int voice);
+    VoiceState tVoiceAllocator_getState   (tVoiceAllocator* const alloc, int voice);
+    int     tVoiceAllocator_getNumHeld    (tVoiceAllocator* const alloc);
+    int     tVoiceAllocator_getStolenNote (tVoiceAllocator* const alloc);
+    
     /*! @} 
      @defgroup tpoly tPoly
      @ingroup midi
@@ -212,6 +397,62 @@ extern "C" {
      @brief Execute the tick-rate change of the poly handler's pitch bend.
      @param poly A pointer to the relevant tPoly.
      
+     @fn void    tPoly_tickPitchBlock        (tPoly* const poly, float** output, int size)
+     @brief Execute size ticks of glide and bend for every voice, the same as calling tPoly_tickPitch() size times.
+     @param poly A pointer to the relevant tPoly.
+     @param output An array of one buffer per voice, filled with each voice's pitch after every tick, or NULL to only advance.
+     @param size The number of ticks.
+     
+     @fn int     tPoly_noteOnMPE             (tPoly* const poly, int channel, int note, uint8_t vel)
+     @brief Add a note that arrived on its own MPE member channel, so that the channel's bend, pressure and timbre follow the voice.
+     @details Like tPoly_noteOn(). A note number already held on another channel is ignored.
+     @param poly A pointer to the relevant tPoly.
+     @param channel The MIDI channel, 0 to 15.
+     @param note The MIDI note number.
+     @param vel The MIDI velocity.
+     @return The voice that will play the note.
+     
+     @fn int     tPoly_noteOffMPE            (tPoly* const poly, int channel, int note)
+     @brief Remove a note added with tPoly_noteOnMPE().
+     @param poly A pointer to the relevant tPoly.
+     @param channel The MIDI channel, 0 to 15.
+     @param note The MIDI note number.
+     @return The voice that was playing the removed note.
+     
+     @fn void    tPoly_setChannelPitchBend   (tPoly* const poly, int channel, float pitchBend)
+     @brief Set the pitch bend of an MPE member channel, which glides in over the bend glide time on top of tPoly_setPitchBend().
+     @param poly A pointer to the relevant tPoly.
+     @param channel The MIDI channel, 0 to 15.
+     @param pitchBend The bend in semitones.
+     
+     @fn void    tPoly_setChannelPressure    (tPoly* const poly, int channel, float pressure)
+     @brief Set the pressure of an MPE member channel.
+     @param poly A pointer to the relevant tPoly.
+     @param channel The MIDI channel, 0 to 15.
+     @param pressure The pressure, usually 0 to 1.
+     
+     @fn void    tPoly_setChannelTimbre      (tPoly* const poly, int channel, float timbre)
+     @brief Set the timbre (CC 74) of an MPE member channel.
+     @param poly A pointer to the relevant tPoly.
+     @param channel The MIDI channel, 0 to 15.
+     @param timbre The timbre, usually 0 to 1.
+     
+     @fn int     tPoly_getChannel            (tPoly* const poly, uint8_t voice)
+     @brief Get the MPE channel of the note a voice was last given.
+     @param poly A pointer to the relevant tPoly.
+     @param voice The voice.
+     @return The channel, or -1 if the note came from tPoly_noteOn().
+     
+     @fn float   tPoly_getPressure           (tPoly* const poly, uint8_t voice)
+     @brief Get the pressure of a voice's MPE channel.
+     @param poly A pointer to the relevant tPoly.
+     @param voice The voice.
+     
+     @fn float   tPoly_getTimbre             (tPoly* const poly, uint8_t voice)
+     @brief Get the timbre of a voice's MPE channel.
+     @param poly A pointer to the relevant tPoly.
+     @param voice The voice.
+     
      @fn int     tPoly_getNumVoices          (tPoly* const poly)
      @brief Get the current number of voices available to play notes.
      @param poly A pointer to the relevant tPoly.
@@ -246,29 +487,69 @@ extern "C" {
      @param voice The voice to get the state of.
      @return The current play state of the given voice.
      
+     @fn void    tPoly_setQuiescence         (tPoly* const poly, float threshold, int holdSamples)
+     @brief Let released voices sleep once they have died away. After a voice's note is released and the output it reports to tPoly_endVoiceBlock() has stayed under the threshold for holdSamples, tPoly_beginVoiceBlock() skips it until it is given a new note. Render each voice between the two calls, and only when tPoly_beginVoiceBlock() returns 0.
+     @param poly A pointer to the relevant tPoly.
+     @param threshold The absolute level under which a voice counts as silent, such as 0.0001 for -80 dB, or 0 to always render. Off by default.
+     @param holdSamples How long a voice must be quiet first. This should be at least the longest delay or reverb in a voice, or one block for a voice without one.
+     
+     @fn int     tPoly_beginVoiceBlock       (tPoly* const poly, uint8_t voice, float* output, int size)
+     @brief Start a block of a voice. A sleeping voice gets a block of zeros.
+     @param poly A pointer to the relevant tPoly.
+     @param voice The voice.
+     @param output The voice's output block, zeroed if the voice is sleeping.
+     @param size The number of samples in the block.
+     @return 1 if the voice is sleeping and shouldn't be rendered, otherwise 0.
+     
+     @fn void    tPoly_endVoiceBlock         (tPoly* const poly, uint8_t voice, const float* output, int size)
+     @brief Report the block a voice rendered after tPoly_beginVoiceBlock() returned 0.
+     @param poly A pointer to the relevant tPoly.
+     @param voice The voice.
+     @param output The voice's output block.
+     @param size The number of samples in the block.
+     
+     @fn int     tPoly_isVoiceQuiescent      (tPoly* const poly, uint8_t voice)
+     @brief Check whether a voice is sleeping.
+     @param poly A pointer to the relevant tPoly.
+     @param voice The voice.
+     @return 1 if the voice is released and has died away, otherwise 0.
+     
      @} */
-
+    
     typedef struct _tPoly
     {
         
         tMempool mempool;
         
-        tStack stack;
+        tVoiceAllocator alloc;
         tStack orderStack;
         
-        tRamp* ramps;
         float* rampVals;
         int* firstReceived;
         float glideTime;
         int pitchGlideIsActive;
         
-        int numVoices;
-        int maxNumVoices;
+        // Per voice glide and MPE bend ramps, stepped like tRamp
+        float* glideCurr;
+        float* glideDest;
+        float* glideInc;
+        float glideFactor;
+        float* bendCurr;
+        float* bendDest;
+        float* bendInc;
+        int* voiceChannel;
+        float* voicePressure;
+        float* voiceTimbre;
+        LEAFQuiescence* voiceQuiet;
+        float invSampleRateMs;
         
-        //int voices[POLY_NUM_MAX_VOICES][2];
-        int** voices;
+        int noteChannel[128];
+        float channelBend[16];
+        float channelPressure[16];
+        float channelTimbre[16];
         
-        int notes[128][2];
+        int numVoices;
+        int maxNumVoices;
         
         int CCs[128];
         
@@ -303,16 +584,29 @@ extern "C" {
     void    tPoly_tickPitch             (tPoly* const poly);
     void    tPoly_tickPitchGlide        (tPoly* const poly);
     void    tPoly_tickPitchBend         (tPoly* const poly);
+    void    tPoly_tickPitchBlock        (tPoly* const poly, float** output, int size);
+    int     tPoly_noteOnMPE             (tPoly* const poly, int channel, int note, uint8_t vel);
+    int     tPoly_noteOffMPE            (tPoly* const poly, int channel, int note);
+    void    tPoly_setChannelPitchBend   (tPoly* const poly, int channel, float pitchBend);
+    void    tPoly_setChannelPressure    (tPoly* const poly, int channel, float pressure);
+    void    tPoly_setChannelTimbre      (tPoly* const poly, int channel, float timbre);
+    int     tPoly_getChannel            (tPoly* const poly, uint8_t voice);
+    float   tPoly_getPressure           (tPoly* const poly, uint8_t voice);
+    float   tPoly_getTimbre             (tPoly* const poly, uint8_t voice);
     int     tPoly_getNumVoices          (tPoly* const poly);
     int     tPoly_getNumActiveVoices    (tPoly* const poly);
     float   tPoly_getPitch              (tPoly* const poly, uint8_t voice);
     int     tPoly_getKey                (tPoly* const poly, uint8_t voice);
     int     tPoly_getVelocity           (tPoly* const poly, uint8_t voice);
     int     tPoly_isOn                  (tPoly* const poly, uint8_t voice);
+    void    tPoly_setQuiescence         (tPoly* const poly, float threshold, int holdSamples);
+    int     tPoly_beginVoiceBlock       (tPoly* const poly, uint8_t voice, float* output, int size);
+    void    tPoly_endVoiceBlock         (tPoly* const poly, uint8_t voice, const float* output, int size);
+    int     tPoly_isVoiceQuiescent      (tPoly* const poly, uint8_t voice);
     void    tPoly_setSampleRate         (tPoly* const poly, float sr);
     
     //==============================================================================
-
+    
     /*! @}
      @defgroup tsimplepoly tSimplePoly
      @ingroup midi
@@ -400,19 +694,16 @@ extern "C" {
     {
         tMempool mempool;
         
-        tStack stack;
-
+        tVoiceAllocator alloc;
+        
         int numVoices;
         int maxNumVoices;
-        int** voices;
         int stealing_on;
         int recover_stolen;
-
-        int notes[128][2];
     } _tSimplePoly;
-
+    
     typedef _tSimplePoly* tSimplePoly;
-
+    
     void    tSimplePoly_init                  (tSimplePoly* const poly, int maxNumVoices, LEAF* const leaf);
     void    tSimplePoly_initToPool            (tSimplePoly* const poly, int maxNumVoices, tMempool* const pool);
     void    tSimplePoly_free                  (tSimplePoly* const poly);
@@ -429,9 +720,9 @@ extern "C" {
     int     tSimplePoly_getPitchAndCheckActive(tSimplePoly* const polyh, uint8_t voice);
     int     tSimplePoly_getVelocity           (tSimplePoly* const poly, uint8_t voice);
     int     tSimplePoly_isOn                  (tSimplePoly* const poly, uint8_t voice);
-
-    //==============================================================================
     
+    //==============================================================================
+
 #ifdef __cplusplus
 }
 #endif
@@ -48,6 +48,10 @@ extern "C" {
      @brief Free a tCycle from its mempool.
      @param osc A pointer to the tCycle to free.
      
+     @fn size_t  tCycle_getRequiredSize (void)
+     @brief Get the bytes tCycle_initToPool() allocates from a first-fit mempool, as a constant expression that can size static memory.
+     @return The size in bytes.
+     
      @fn float   tCycle_tick         (tCycle* const osc)
      @brief Tick a tCycle oscillator.
      @param osc A pointer to the relevant tCycle.
@@ -58,16 +62,30 @@ extern "C" {
      @param osc A pointer to the relevant tCycle.
      @param freq The frequency to set the oscillator to.
      
+     @fn void    tCycle_tickBlock    (tCycle* const osc, float* output, int size)
+     @brief Render a block, ticking once every control period and interpolating in between. Meant for LFOs; lags the per sample output by one control period when the control rate is above 1.
+     @param osc A pointer to the relevant tCycle.
+     @param output The buffer to write to.
+     @param size The number of samples to write.
+     
+     @fn void    tCycle_setControlRate (tCycle* const osc, int divider)
+     @brief Set the number of samples between ticks. Until set, the divider given by LEAF_setControlRate() before initialization is used. Only tCycle_tickBlock() runs at the control rate. tCycle_tick() always advances one sample.
+     @param osc A pointer to the relevant tCycle.
+     @param divider The control rate divider, 1 for audio rate.
+    
     ￼￼￼
      @} */
     
     typedef struct _tCycle
     {
         tMempool mempool;
+        const leaf_table_t* table;
         // Underlying phasor
-        float phase;
-        float inc,freq;
+        leaf_coeff_t phase;
+        leaf_coeff_t inc;
+        float freq;
         float invSampleRate;
+        LEAFControlRate control;
     } _tCycle;
     
     typedef _tCycle* tCycle;
@@ -75,10 +93,13 @@ extern "C" {
     void    tCycle_init         (tCycle* const osc, LEAF* const leaf);
     void    tCycle_initToPool   (tCycle* const osc, tMempool* const mempool);
     void    tCycle_free         (tCycle* const osc);
+#define tCycle_getRequiredSize() LEAF_MEMPOOL_BLOCK_SIZE(sizeof(_tCycle))
     
     float   tCycle_tick         (tCycle* const osc);
     void    tCycle_setFreq      (tCycle* const osc, float freq);
     void    tCycle_setSampleRate(tCycle* const osc, float sr);
+    void    tCycle_tickBlock    (tCycle* const osc, float* output, int size);
+    void    tCycle_setControlRate (tCycle* const osc, int divider);
     
     //==============================================================================
     
@@ -102,6 +123,10 @@ extern "C" {
      @brief Free a tTriangle from its mempool.
      @param osc A pointer to the tTriangle to free.
      
+     @fn size_t  tTriangle_getRequiredSize (void)
+     @brief Get the bytes tTriangle_initToPool() allocates from a first-fit mempool, as a constant expression that can size static memory.
+     @return The size in bytes.
+     
      @fn float   tTriangle_tick         (tTriangle* const osc)
      @brief Tick a tTriangle oscillator.
      @param osc A pointer to the relevant tTriangle.
@@ -131,6 +156,7 @@ extern "C" {
     void    tTriangle_init          (tTriangle* const osc, LEAF* const leaf);
     void    tTriangle_initToPool    (tTriangle* const osc, tMempool* const mempool);
     void    tTriangle_free          (tTriangle* const osc);
+#define tTriangle_getRequiredSize() LEAF_MEMPOOL_BLOCK_SIZE(sizeof(_tTriangle))
     
     float   tTriangle_tick          (tTriangle* const osc);
     void    tTriangle_setFreq       (tTriangle* const osc, float freq);
@@ -158,6 +184,10 @@ extern "C" {
      @brief Free a tSquare from its mempool.
      @param osc A pointer to the tSquare to free.
      
+     @fn size_t  tSquare_getRequiredSize (void)
+     @brief Get the bytes tSquare_initToPool() allocates from a first-fit mempool, as a constant expression that can size static memory.
+     @return The size in bytes.
+     
      @fn float   tSquare_tick         (tSquare* const osc)
      @brief Tick a tSquare oscillator.
      @param osc A pointer to the relevant tSquare.
@@ -187,6 +217,7 @@ extern "C" {
     void    tSquare_init        (tSquare* const osc, LEAF* const leaf);
     void    tSquare_initToPool  (tSquare* const osc, tMempool* const);
     void    tSquare_free        (tSquare* const osc);
+#define tSquare_getRequiredSize() LEAF_MEMPOOL_BLOCK_SIZE(sizeof(_tSquare))
 
     float   tSquare_tick        (tSquare* const osc);
     void    tSquare_setFreq     (tSquare* const osc, float freq);
@@ -217,6 +248,10 @@ extern "C" {
      @brief Free a tSawtooth from its mempool.
      @param osc A pointer to the tSawtooth to free.
      
+     @fn size_t  tSawtooth_getRequiredSize (void)
+     @brief Get the bytes tSawtooth_initToPool() allocates from a first-fit mempool, as a constant expression that can size static memory.
+     @return The size in bytes.
+     
      @fn float   tSawtooth_tick         (tSawtooth* const osc)
      @brief Tick a tSawtooth oscillator.
      @param osc A pointer to the relevant tSawtooth.
@@ -246,6 +281,7 @@ extern "C" {
     void    tSawtooth_init          (tSawtooth* const osc, LEAF* const leaf);
     void    tSawtooth_initToPool    (tSawtooth* const osc, tMempool* const mempool);
     void    tSawtooth_free          (tSawtooth* const osc);
+#define tSawtooth_getRequiredSize() LEAF_MEMPOOL_BLOCK_SIZE(sizeof(_tSawtooth))
 
     float   tSawtooth_tick          (tSawtooth* const osc);
     void    tSawtooth_setFreq       (tSawtooth* const osc, float freq);
@@ -273,6 +309,10 @@ extern "C" {
      @brief Free a tTri from its mempool.
      @param osc A pointer to the tPBTriangle to free.
      
+     @fn size_t  tPBTriangle_getRequiredSize (void)
+     @brief Get the bytes tPBTriangle_initToPool() allocates from a first-fit mempool, as a constant expression that can size static memory.
+     @return The size in bytes.
+     
      @fn float   tPBTriangle_tick          (tPBTriangle* const osc)
      @brief
      @param osc A pointer to the relevant tPBTriangle.
@@ -302,6 +342,7 @@ extern "C" {
     void    tPBTriangle_init          (tPBTriangle* const osc, LEAF* const leaf);
     void    tPBTriangle_initToPool    (tPBTriangle* const osc, tMempool* const mempool);
     void    tPBTriangle_free          (tPBTriangle* const osc);
+#define tPBTriangle_getRequiredSize() LEAF_MEMPOOL_BLOCK_SIZE(sizeof(_tPBTriangle))
     
     float   tPBTriangle_tick          (tPBTriangle* const osc);
     void    tPBTriangle_setFreq       (tPBTriangle* const osc, float freq);
@@ -330,6 +371,10 @@ extern "C" {
      @brief Free a tPBPulse from its mempool.
      @param osc A pointer to the tPBPulse to free.
      
+     @fn size_t  tPBPulse_getRequiredSize (void)
+     @brief Get the bytes tPBPulse_initToPool() allocates from a first-fit mempool, as a constant expression that can size static memory.
+     @return The size in bytes.
+     
      @fn float   tPBPulse_tick        (tPBPulse* const osc)
      @brief
      @param osc A pointer to the relevant tPBPulse.
@@ -358,6 +403,7 @@ extern "C" {
     void    tPBPulse_init        (tPBPulse* const osc, LEAF* const leaf);
     void    tPBPulse_initToPool  (tPBPulse* const osc, tMempool* const);
     void    tPBPulse_free        (tPBPulse* const osc);
+#define tPBPulse_getRequiredSize() LEAF_MEMPOOL_BLOCK_SIZE(sizeof(_tPBPulse))
     
     float   tPBPulse_tick        (tPBPulse* const osc);
     void    tPBPulse_setFreq     (tPBPulse* const osc, float freq);
@@ -386,6 +432,10 @@ extern "C" {
      @brief Free a tPBSaw from its mempool.
      @param osc A pointer to the tPBSaw to free.
      
+     @fn size_t  tPBSaw_getRequiredSize (void)
+     @brief Get the bytes tPBSaw_initToPool() allocates from a first-fit mempool, as a constant expression that can size static memory.
+     @return The size in bytes.
+     
      @fn float   tPBSaw_tick          (tPBSaw* const osc)
      @brief
      @param osc A pointer to the relevant tPBSaw.
@@ -409,6 +459,7 @@ extern "C" {
     void    tPBSaw_init          (tPBSaw* const osc, LEAF* const leaf);
     void    tPBSaw_initToPool    (tPBSaw* const osc, tMempool* const mempool);
     void    tPBSaw_free          (tPBSaw* const osc);
+#define tPBSaw_getRequiredSize() LEAF_MEMPOOL_BLOCK_SIZE(sizeof(_tPBSaw))
     
     float   tPBSaw_tick          (tPBSaw* const osc);
     void    tPBSaw_setFreq       (tPBSaw* const osc, float freq);
@@ -436,6 +487,10 @@ extern "C" {
      @brief Free a tPhasor from its mempool.
      @param osc A pointer to the tPhasor to free.
      
+     @fn size_t  tPhasor_getRequiredSize (void)
+     @brief Get the bytes tPhasor_initToPool() allocates from a first-fit mempool, as a constant expression that can size static memory.
+     @return The size in bytes.
+     
      @fn float   tPhasor_tick        (tPhasor* const osc)
      @brief
      @param osc A pointer to the relevant tPhasor.
@@ -461,6 +516,7 @@ extern "C" {
     void    tPhasor_init        (tPhasor* const osc, LEAF* const leaf);
     void    tPhasor_initToPool  (tPhasor* const osc, tMempool* const);
     void    tPhasor_free        (tPhasor* const osc);
+#define tPhasor_getRequiredSize() LEAF_MEMPOOL_BLOCK_SIZE(sizeof(_tPhasor))
     
     float   tPhasor_tick        (tPhasor* const osc);
     void    tPhasor_setFreq     (tPhasor* const osc, float freq);
@@ -472,6 +528,7 @@ extern "C" {
      @defgroup tnoise tNoise
      @ingroup oscillators
      @brief Noise generator, capable of producing white or pink noise.
+     @details Each tNoise has its own xorshift generator, inlined into the tick and run four lanes at a time by tNoise_tickBlock(). The generator is seeded from the LEAF random function at initialization. Give each voice a seed with tNoise_setSeed() to get the same noise on every run. tNoise_setRandomFunction() switches back to calling a function for each sample.
      @{
      
      @fn void    tNoise_init         (tNoise* const noise, NoiseType type, LEAF* const leaf)
@@ -488,9 +545,30 @@ extern "C" {
      @brief Free a tNoise from its mempool.
      @param noise A pointer to the tNoise to free.
      
+     @fn size_t  tNoise_getRequiredSize (void)
+     @brief Get the bytes tNoise_initToPool() allocates from a first-fit mempool, as a constant expression that can size static memory.
+     @return The size in bytes.
+     
      @fn float   tNoise_tick         (tNoise* const noise)
-     @brief
+     @brief Tick a tNoise.
+     @param noise A pointer to the relevant tNoise.
+     @return The current sample, in [-1, 1) for white noise.
+     
+     @fn void    tNoise_tickBlock    (tNoise* const noise, float* output, int size)
+     @brief Render a block of noise. Gives the same samples as calling tNoise_tick() size times.
+     @param noise A pointer to the relevant tNoise.
+     @param output The buffer to write to.
+     @param size The number of samples to write.
+     
+     @fn void    tNoise_setSeed      (tNoise* const noise, uint32_t seed)
+     @brief Restart the built-in generator from a seed. Two tNoise with the same seed and type produce the same samples.
+     @param noise A pointer to the relevant tNoise.
+     @param seed Any value, including 0.
+     
+     @fn void    tNoise_setRandomFunction (tNoise* const noise, float (*random)(void))
+     @brief Take samples from a function returning values in [0, 1), such as the one given to LEAF_init(), instead of the built-in generator.
      @param noise A pointer to the relevant tNoise.
+     @param random The function to call once per sample, or NULL to go back to the built-in generator.
      */
     
     /* tNoise. WhiteNoise, PinkNoise. */
@@ -514,7 +592,9 @@ extern "C" {
         tMempool mempool;
         NoiseType type;
         float pinkb0, pinkb1, pinkb2;
-        float(*rand)(void);
+        float(*rand)(void); // NULL for the built-in generator
+        uint32_t state[4]; // xorshift32 lanes, taken in turn
+        int lane;
     } _tNoise;
     
     typedef _tNoise* tNoise;
@@ -522,8 +602,12 @@ extern "C" {
     void    tNoise_init         (tNoise* const noise, NoiseType type, LEAF* const leaf);
     void    tNoise_initToPool   (tNoise* const noise, NoiseType type, tMempool* const);
     void    tNoise_free         (tNoise* const noise);
+#define tNoise_getRequiredSize() LEAF_MEMPOOL_BLOCK_SIZE(sizeof(_tNoise))
     
     float   tNoise_tick         (tNoise* const noise);
+    void    tNoise_tickBlock    (tNoise* const noise, float* output, int size);
+    void    tNoise_setSeed      (tNoise* const noise, uint32_t seed);
+    void    tNoise_setRandomFunction (tNoise* const noise, float (*random)(void));
     
     //==============================================================================
     
@@ -547,6 +631,10 @@ extern "C" {
      @brief Free a tNeuron from its mempool.
      @param neuron A pointer to the tNeuron to free.
      
+     @fn size_t  tNeuron_getRequiredSize (void)
+     @brief Get the bytes tNeuron_initToPool() allocates from a first-fit mempool, as a constant expression that can size static memory.
+     @return The size in bytes.
+     
      @fn void    tNeuron_reset       (tNeuron* const neuron)
      @brief Reset the neuron model.
      @param neuron A pointer to the relevant tNeuron.
@@ -644,6 +732,7 @@ extern "C" {
     void    tNeuron_init        (tNeuron* const neuron, LEAF* const leaf);
     void    tNeuron_initToPool  (tNeuron* const neuron, tMempool* const mempool);
     void    tNeuron_free        (tNeuron* const neuron);
+#define tNeuron_getRequiredSize() (LEAF_MEMPOOL_BLOCK_SIZE(sizeof(_tNeuron)) + tPoleZero_getRequiredSize())
     
     void    tNeuron_reset       (tNeuron* const neuron);
     float   tNeuron_tick        (tNeuron* const neuron);
@@ -682,10 +771,20 @@ extern "C" {
      @brief Free a tMBPulse from its mempool.
      @param osc A pointer to the tMBPulse to free.
      
+     @fn size_t  tMBPulse_getRequiredSize (void)
+     @brief Get the bytes tMBPulse_initToPool() allocates from a first-fit mempool, as a constant expression that can size static memory.
+     @return The size in bytes.
+     
      @fn float tMBPulse_tick(tMBPulse* const osc)
      @brief
      @param osc A pointer to the relevant tMBPulse.
      
+     @fn void tMBPulse_tickBlock(tMBPulse* const osc, float* output, int size)
+     @brief Render a block. Without sync, the discontinuities of the whole block are found first and their BLEPs added with vector table reads, which is cheaper than ticking and matches it to within rounding. While a sync input from tMBPulse_sync() is set, the block is ticked.
+     @param osc A pointer to the relevant tMBPulse.
+     @param output The buffer to write to.
+     @param size The number of samples to write.
+     
      @fn void tMBPulse_setFreq(tMBPulse* const osc, float f)
      @brief
      @param osc A pointer to the relevant tMBPulse.
@@ -729,8 +828,10 @@ extern "C" {
     void tMBPulse_init(tMBPulse* const osc, LEAF* const leaf);
     void tMBPulse_initToPool(tMBPulse* const osc, tMempool* const mempool);
     void tMBPulse_free(tMBPulse* const osc);
+#define tMBPulse_getRequiredSize() LEAF_MEMPOOL_BLOCK_SIZE(sizeof(_tMBPulse))
     
     float tMBPulse_tick(tMBPulse* const osc);
+    void tMBPulse_tickBlock(tMBPulse* const osc, float* output, int size);
     void tMBPulse_setFreq(tMBPulse* const osc, float f);
     void tMBPulse_setWidth(tMBPulse* const osc, float w);
     float tMBPulse_sync(tMBPulse* const osc, float sync);
@@ -755,10 +856,20 @@ extern "C" {
      @brief Free a tMBTriangle from its mempool.
      @param osc A pointer to the tMBTriangle to free.
      
+     @fn size_t  tMBTriangle_getRequiredSize (void)
+     @brief Get the bytes tMBTriangle_initToPool() allocates from a first-fit mempool, as a constant expression that can size static memory.
+     @return The size in bytes.
+     
      @fn float tMBTriangle_tick(tMBTriangle* const osc)
      @brief
      @param osc A pointer to the relevant tMBTriangle.
      
+     @fn void tMBTriangle_tickBlock(tMBTriangle* const osc, float* output, int size)
+     @brief Render a block. Without sync, the discontinuities of the whole block are found first and their BLEPs added with vector table reads, which is cheaper than ticking and matches it to within rounding. While a sync input from tMBTriangle_sync() is set, the block is ticked.
+     @param osc A pointer to the relevant tMBTriangle.
+     @param output The buffer to write to.
+     @param size The number of samples to write.
+     
      @fn void tMBTriangle_setFreq(tMBTriangle* const osc, float f)
      @brief
      @param osc A pointer to the relevant tMBTriangle.
@@ -802,8 +913,10 @@ extern "C" {
     void tMBTriangle_init(tMBTriangle* const osc, LEAF* const leaf);
     void tMBTriangle_initToPool(tMBTriangle* const osc, tMempool* const mempool);
     void tMBTriangle_free(tMBTriangle* const osc);
+#define tMBTriangle_getRequiredSize() LEAF_MEMPOOL_BLOCK_SIZE(sizeof(_tMBTriangle))
     
     float tMBTriangle_tick(tMBTriangle* const osc);
+    void tMBTriangle_tickBlock(tMBTriangle* const osc, float* output, int size);
     void tMBTriangle_setFreq(tMBTriangle* const osc, float f);
     void tMBTriangle_setWidth(tMBTriangle* const osc, float w);
     float tMBTriangle_sync(tMBTriangle* const osc, float sync);
@@ -829,11 +942,21 @@ extern "C" {
      @brief Free a tMBSaw from its mempool.
      @param osc A pointer to the tMBSaw to free.
      
+     @fn size_t  tMBSaw_getRequiredSize (void)
+     @brief Get the bytes tMBSaw_initToPool() allocates from a first-fit mempool, as a constant expression that can size static memory.
+     @return The size in bytes.
+     
      @fn float tMBSaw_tick(tMBSaw* const osc)
      @brief Tick the oscillator.
      @param osc A pointer to the relevant tMBSaw.
      @return The ticked sample.
      
+     @fn void tMBSaw_tickBlock(tMBSaw* const osc, float* output, int size)
+     @brief Render a block. Without sync, the discontinuities of the whole block are found first and their BLEPs added with vector table reads, which is cheaper than ticking and matches it to within rounding. While a sync input from tMBSaw_sync() is set, the block is ticked.
+     @param osc A pointer to the relevant tMBSaw.
+     @param output The buffer to write to.
+     @param size The number of samples to write.
+     
      @fn void tMBSaw_setFreq(tMBSaw* const osc, float f)
      @brief Set the frequency of the oscillator.
      @param osc A pointer to the relevant tMBSaw.
@@ -874,8 +997,10 @@ extern "C" {
     void tMBSaw_init(tMBSaw* const osc, LEAF* const leaf);
     void tMBSaw_initToPool(tMBSaw* const osc, tMempool* const mempool);
     void tMBSaw_free(tMBSaw* const osc);
+#define tMBSaw_getRequiredSize() LEAF_MEMPOOL_BLOCK_SIZE(sizeof(_tMBSaw))
     
     float tMBSaw_tick(tMBSaw* const osc);
+    void tMBSaw_tickBlock(tMBSaw* const osc, float* output, int size);
     void tMBSaw_setFreq(tMBSaw* const osc, float f);
     float tMBSaw_sync(tMBSaw* const osc, float sync);
     void tMBSaw_setSyncMode(tMBSaw* const osc, int hardOrSoft);
@@ -883,6 +1008,326 @@ extern "C" {
     
     //==============================================================================
     
+    /*!
+     @defgroup tcyclebank tCycleBank
+     @ingroup oscillators
+     @brief A bank of wavetable sine oscillators stored as contiguous per-voice arrays and ticked together with SIMD.
+     @{
+     
+     @fn void    tCycleBank_init         (tCycleBank* const bank, int numVoices, LEAF* const leaf)
+     @brief Initialize a tCycleBank to the default mempool of a LEAF instance.
+     @param bank A pointer to the tCycleBank to initialize.
+     @param numVoices The number of oscillators in the bank.
+     @param leaf A pointer to the leaf instance.
+     
+     @fn void    tCycleBank_initToPool   (tCycleBank* const bank, int numVoices, tMempool* const mempool)
+     @brief Initialize a tCycleBank to a specified mempool.
+     @param bank A pointer to the tCycleBank to initialize.
+     @param numVoices The number of oscillators in the bank.
+     @param mempool A pointer to the tMempool to use.
+     
+     @fn void    tCycleBank_free         (tCycleBank* const bank)
+     @brief Free a tCycleBank from its mempool.
+     @param bank A pointer to the tCycleBank to free.
+     
+     @fn void    tCycleBank_tick         (tCycleBank* const bank, float* output)
+     @brief Tick every oscillator in the bank once. Matches ticking a tCycle per voice.
+     @param bank A pointer to the relevant tCycleBank.
+     @param output An array of at least numVoices floats to receive one sample per voice.
+     
+     @fn void    tCycleBank_tickBlock    (tCycleBank* const bank, float** outputs, int size)
+     @brief Tick every oscillator in the bank for a block of samples.
+     @param bank A pointer to the relevant tCycleBank.
+     @param outputs An array of numVoices output buffers, each at least size samples long.
+     @param size The number of samples to generate per voice.
+     
+     @fn void    tCycleBank_setFreq      (tCycleBank* const bank, int voice, float freq)
+     @brief Set the frequency of one oscillator in the bank.
+     @param bank A pointer to the relevant tCycleBank.
+     @param voice The index of the oscillator.
+     @param freq The frequency to set the oscillator to.
+     
+     @fn void    tCycleBank_setSampleRate(tCycleBank* const bank, float sr)
+     @brief Set the sample rate of every oscillator in the bank.
+     @param bank A pointer to the relevant tCycleBank.
+     @param sr The new sample rate.
+     
+     @} */
+    
+    typedef struct _tCycleBank
+    {
+        tMempool mempool;
+        int numVoices;
+        int numLanes; // numVoices rounded up to a multiple of 4
+        const leaf_table_t* table;
+        float* phase;
+        float* inc;
+        float* freq;
+        float* frame;
+        float invSampleRate;
+    } _tCycleBank;
+    
+    typedef _tCycleBank* tCycleBank;
+    
+    void    tCycleBank_init         (tCycleBank* const bank, int numVoices, LEAF* const leaf);
+    void    tCycleBank_initToPool   (tCycleBank* const bank, int numVoices, tMempool* const mempool);
+    void    tCycleBank_free         (tCycleBank* const bank);
+    
+    void    tCycleBank_tick         (tCycleBank* const bank, float* output);
+    void    tCycleBank_tickBlock    (tCycleBank* const bank, float** outputs, int size);
+    void    tCycleBank_setFreq      (tCycleBank* const bank, int voice, float freq);
+    void    tCycleBank_setSampleRate(tCycleBank* const bank, float sr);
+    
+    //==============================================================================
+    
+    /*!
+     @defgroup tmbsawbank tMBSawBank
+     @ingroup oscillators
+     @brief A bank of minBLEP saw oscillators stored as contiguous per-voice arrays and ticked together with SIMD.
+     @details The voices share one interleaved minBLEP buffer, so the phase update, residual accumulation and output filter run across voices at once. Only the band-limited steps are placed per voice. Sync is not supported; use tMBSaw for synced voices.
+     @{
+     
+     @fn void tMBSawBank_init(tMBSawBank* const bank, int numVoices, LEAF* const leaf)
+     @brief Initialize a tMBSawBank to the default mempool of a LEAF instance.
+     @param bank A pointer to the tMBSawBank to initialize.
+     @param numVoices The number of oscillators in the bank.
+     @param leaf A pointer to the leaf instance.
+     
+     @fn void tMBSawBank_initToPool(tMBSawBank* const bank, int numVoices, tMempool* const mempool)
+     @brief Initialize a tMBSawBank to a specified mempool.
+     @param bank A pointer to the tMBSawBank to initialize.
+     @param numVoices The number of oscillators in the bank.
+     @param mempool A pointer to the tMempool to use.
+     
+     @fn void tMBSawBank_free(tMBSawBank* const bank)
+     @brief Free a tMBSawBank from its mempool.
+     @param bank A pointer to the tMBSawBank to free.
+     
+     @fn void tMBSawBank_tick(tMBSawBank* const bank, float* output)
+     @brief Tick every oscillator in the bank once. Matches ticking an unsynced tMBSaw per voice.
+     @param bank A pointer to the relevant tMBSawBank.
+     @param output An array of at least numVoices floats to receive one sample per voice.
+     
+     @fn void tMBSawBank_tickBlock(tMBSawBank* const bank, float** outputs, int size)
+     @brief Tick every oscillator in the bank for a block of samples.
+     @param bank A pointer to the relevant tMBSawBank.
+     @param outputs An array of numVoices output buffers, each at least size samples long.
+     @param size The number of samples to generate per voice.
+     
+     @fn void tMBSawBank_setFreq(tMBSawBank* const bank, int voice, float f)
+     @brief Set the frequency of one oscillator in the bank.
+     @param bank A pointer to the relevant tMBSawBank.
+     @param voice The index of the oscillator.
+     @param f The new frequency.
+     
+     @fn void tMBSawBank_setSampleRate(tMBSawBank* const bank, float sr)
+     @brief Set the sample rate of every oscillator in the bank.
+     @param bank A pointer to the relevant tMBSawBank.
+     @param sr The new sample rate.
+     
+     @} */
+    
+    typedef struct _tMBSawBank
+    {
+        tMempool mempool;
+        int numVoices;
+        int numLanes;
+        float* freq;
+        float* w;       // phase increment
+        float* inc;     // fractional part of the phase increment
+        float* p;       // phase [0, 1)
+        float* x;       // naive waveform for this sample
+        float* z;       // low pass filter state
+        float* f;       // [FILLEN + STEP_DD_PULSE_LENGTH][numLanes]
+        float* frame;
+        int j;
+        float invSampleRate;
+    } _tMBSawBank;
+    
+    typedef _tMBSawBank* tMBSawBank;
+    
+    void tMBSawBank_init(tMBSawBank* const bank, int numVoices, LEAF* const leaf);
+    void tMBSawBank_initToPool(tMBSawBank* const bank, int numVoices, tMempool* const mempool);
+    void tMBSawBank_free(tMBSawBank* const bank);
+    
+    void tMBSawBank_tick(tMBSawBank* const bank, float* output);
+    void tMBSawBank_tickBlock(tMBSawBank* const bank, float** outputs, int size);
+    void tMBSawBank_setFreq(tMBSawBank* const bank, int voice, float f);
+    void tMBSawBank_setSampleRate(tMBSawBank* const bank, float sr);
+    
+    /*!
+     @defgroup tmbpulsebank tMBPulseBank
+     @ingroup oscillators
+     @brief A bank of minBLEP pulse oscillators stored as contiguous per-voice arrays and ticked together with SIMD.
+     @details Laid out like tMBSawBank. Sync is not supported; use tMBPulse for synced voices.
+     @{
+     
+     @fn void tMBPulseBank_init(tMBPulseBank* const bank, int numVoices, LEAF* const leaf)
+     @brief Initialize a tMBPulseBank to the default mempool of a LEAF instance.
+     @param bank A pointer to the tMBPulseBank to initialize.
+     @param numVoices The number of oscillators in the bank.
+     @param leaf A pointer to the leaf instance.
+     
+     @fn void tMBPulseBank_initToPool(tMBPulseBank* const bank, int numVoices, tMempool* const mempool)
+     @brief Initialize a tMBPulseBank to a specified mempool.
+     @param bank A pointer to the tMBPulseBank to initialize.
+     @param numVoices The number of oscillators in the bank.
+     @param mempool A pointer to the tMempool to use.
+     
+     @fn void tMBPulseBank_free(tMBPulseBank* const bank)
+     @brief Free a tMBPulseBank from its mempool.
+     @param bank A pointer to the tMBPulseBank to free.
+     
+     @fn void tMBPulseBank_tick(tMBPulseBank* const bank, float* output)
+     @brief Tick every oscillator in the bank once. Matches ticking an unsynced tMBPulse per voice.
+     @param bank A pointer to the relevant tMBPulseBank.
+     @param output An array of at least numVoices floats to receive one sample per voice.
+     
+     @fn void tMBPulseBank_tickBlock(tMBPulseBank* const bank, float** outputs, int size)
+     @brief Tick every oscillator in the bank for a block of samples.
+     @param bank A pointer to the relevant tMBPulseBank.
+     @param outputs An array of numVoices output buffers, each at least size samples long.
+     @param size The number of samples to generate per voice.
+     
+     @fn void tMBPulseBank_setFreq(tMBPulseBank* const bank, int voice, float f)
+     @brief Set the frequency of one oscillator in the bank.
+     @param bank A pointer to the relevant tMBPulseBank.
+     @param voice The index of the oscillator.
+     @param f The new frequency.
+     
+     @fn void tMBPulseBank_setWidth(tMBPulseBank* const bank, int voice, float w)
+     @brief Set the pulse width of one oscillator in the bank.
+     @param bank A pointer to the relevant tMBPulseBank.
+     @param voice The index of the oscillator.
+     @param w The new width, from -1 to 1 as in tMBPulse_setWidth.
+     
+     @fn void tMBPulseBank_setSampleRate(tMBPulseBank* const bank, float sr)
+     @brief Set the sample rate of every oscillator in the bank.
+     @param bank A pointer to the relevant tMBPulseBank.
+     @param sr The new sample rate.
+     
+     @} */
+    
+    typedef struct _tMBPulseBank
+    {
+        tMempool mempool;
+        int numVoices;
+        int numLanes;
+        float* freq;
+        float* w;       // phase increment
+        float* inc;     // fractional part of the phase increment
+        float* b;       // duty cycle (0, 1)
+        float* p;       // phase [0, 1)
+        float* x;       // naive waveform, 0.5 or -0.5
+        float* z;       // low pass filter state
+        int* k;         // output state, 0 = high, 1 = low
+        float* f;       // [FILLEN + STEP_DD_PULSE_LENGTH][numLanes]
+        float* frame;
+        int j;
+        float invSampleRate;
+    } _tMBPulseBank;
+    
+    typedef _tMBPulseBank* tMBPulseBank;
+    
+    void tMBPulseBank_init(tMBPulseBank* const bank, int numVoices, LEAF* const leaf);
+    void tMBPulseBank_initToPool(tMBPulseBank* const bank, int numVoices, tMempool* const mempool);
+    void tMBPulseBank_free(tMBPulseBank* const bank);
+    
+    void tMBPulseBank_tick(tMBPulseBank* const bank, float* output);
+    void tMBPulseBank_tickBlock(tMBPulseBank* const bank, float** outputs, int size);
+    void tMBPulseBank_setFreq(tMBPulseBank* const bank, int voice, float f);
+    void tMBPulseBank_setWidth(tMBPulseBank* const bank, int voice, float w);
+    void tMBPulseBank_setSampleRate(tMBPulseBank* const bank, float sr);
+    
+    /*!
+     @defgroup tmbtrianglebank tMBTriangleBank
+     @ingroup oscillators
+     @brief A bank of minBLEP triangle oscillators stored as contiguous per-voice arrays and ticked together with SIMD.
+     @details Laid out like tMBSawBank. Sync is not supported; use tMBTriangle for synced voices.
+     @{
+     
+     @fn void tMBTriangleBank_init(tMBTriangleBank* const bank, int numVoices, LEAF* const leaf)
+     @brief Initialize a tMBTriangleBank to the default mempool of a LEAF instance.
+     @param bank A pointer to the tMBTriangleBank to initialize.
+     @param numVoices The number of oscillators in the bank.
+     @param leaf A pointer to the leaf instance.
+     
+     @fn void tMBTriangleBank_initToPool(tMBTriangleBank* const bank, int numVoices, tMempool* const mempool)
+     @brief Initialize a tMBTriangleBank to a specified mempool.
+     @param bank A pointer to the tMBTriangleBank to initialize.
+     @param numVoices The number of oscillators in the bank.
+     @param mempool A pointer to the tMempool to use.
+     
+     @fn void tMBTriangleBank_free(tMBTriangleBank* const bank)
+     @brief Free a tMBTriangleBank from its mempool.
+     @param bank A pointer to the tMBTriangleBank to free.
+     
+     @fn void tMBTriangleBank_tick(tMBTriangleBank* const bank, float* output)
+     @brief Tick every oscillator in the bank once. Matches ticking an unsynced tMBTriangle per voice.
+     @param bank A pointer to the relevant tMBTriangleBank.
+     @param output An array of at least numVoices floats to receive one sample per voice.
+     
+     @fn void tMBTriangleBank_tickBlock(tMBTriangleBank* const bank, float** outputs, int size)
+     @brief Tick every oscillator in the bank for a block of samples.
+     @param bank A pointer to the relevant tMBTriangleBank.
+     @param outputs An array of numVoices output buffers, each at least size samples long.
+     @param size The number of samples to generate per voice.
+     
+     @fn void tMBTriangleBank_setFreq(tMBTriangleBank* const bank, int voice, float f)
+     @brief Set the frequency of one oscillator in the bank.
+     @param bank A pointer to the relevant tMBTriangleBank.
+     @param voice The index of the oscillator.
+     @param f The new frequency.
+     
+     @fn void tMBTriangleBank_setWidth(tMBTriangleBank* const bank, int voice, float w)
+     @brief Set the symmetry of one oscillator in the bank.
+     @param bank A pointer to the relevant tMBTriangleBank.
+     @param voice The index of the oscillator.
+     @param w The new width, from -1 to 1 as in tMBTriangle_setWidth.
+     
+     @fn void tMBTriangleBank_setSampleRate(tMBTriangleBank* const bank, float sr)
+     @brief Set the sample rate of every oscillator in the bank.
+     @param bank A pointer to the relevant tMBTriangleBank.
+     @param sr The new sample rate.
+     
+     @} */
+    
+    typedef struct _tMBTriangleBank
+    {
+        tMempool mempool;
+        int numVoices;
+        int numLanes;
+        float* freq;
+        float* w;       // phase increment
+        float* inc;     // fractional part of the phase increment
+        float* b;       // duty cycle (0, 1)
+        float* ib;      // 1 / b
+        float* ib1;     // 1 / (1 - b)
+        float* p;       // phase [0, 1)
+        float* x;       // naive waveform for this sample
+        float* z;       // low pass filter state
+        int* k;         // output state, 0 = positive slope, 1 = negative slope
+        float* f;       // [FILLEN + LONGEST_DD_PULSE_LENGTH][numLanes]
+        float* frame;
+        int j;
+        bool _init;
+        float invSampleRate;
+    } _tMBTriangleBank;
+    
+    typedef _tMBTriangleBank* tMBTriangleBank;
+    
+    void tMBTriangleBank_init(tMBTriangleBank* const bank, int numVoices, LEAF* const leaf);
+    void tMBTriangleBank_initToPool(tMBTriangleBank* const bank, int numVoices, tMempool* const mempool);
+    void tMBTriangleBank_free(tMBTriangleBank* const bank);
+    
+    void tMBTriangleBank_tick(tMBTriangleBank* const bank, float* output);
+    void tMBTriangleBank_tickBlock(tMBTriangleBank* const bank, float** outputs, int size);
+    void tMBTriangleBank_setFreq(tMBTriangleBank* const bank, int voice, float f);
+    void tMBTriangleBank_setWidth(tMBTriangleBank* const bank, int voice, float w);
+    void tMBTriangleBank_setSampleRate(tMBTriangleBank* const bank, float sr);
+    
+    //==============================================================================
+    
     /*!
      @defgroup ttable tTable
      @ingroup oscillators
@@ -907,6 +1352,10 @@ extern "C" {
      @brief Free a tTable from its mempool.
      @param osc A pointer to the tTable to free.
      
+     @fn size_t  tTable_getRequiredSize (void)
+     @brief Get the bytes tTable_initToPool() allocates from a first-fit mempool, as a constant expression that can size static memory.
+     @return The size in bytes.
+     
      @fn float   tTable_tick         (tTable* const osc)
      @brief Tick a tTable oscillator.
      @param osc A pointer to the relevant tTable.
@@ -935,6 +1384,7 @@ extern "C" {
     void    tTable_init(tTable* const osc, float* table, int size, LEAF* const leaf);
     void    tTable_initToPool(tTable* const osc, float* table, int size, tMempool* const mempool);
     void    tTable_free(tTable* const osc);
+#define tTable_getRequiredSize() LEAF_MEMPOOL_BLOCK_SIZE(sizeof(_tTable))
     
     float   tTable_tick(tTable* const osc);
     void    tTable_setFreq(tTable* const osc, float freq);
@@ -942,6 +1392,43 @@ extern "C" {
     
     //==============================================================================
     
+    /*!
+     @defgroup wavetableimage Wavetable images
+     @ingroup oscillators
+     @brief Binary format for wavetable sets with precomputed band-limited levels, as written by wtgenerator.
+     @details An image is a LEAFWaveTableImageHeader followed by numLevels LEAFWaveTableImageLevel entries and the level data. All fields are little-endian. The image itself must be at least 4-byte aligned. Each level's data starts at its byte offset from the start of the image, aligned to 16 bytes, and must lie inside the image; images that break these rules are rejected. Float32 images are used in place by tWaveTable_initFromImage and tWaveTableS_initFromImage, so the image must stay valid and unmodified for the life of the table. Int16 images are converted into the mempool, with each sample scaled by the header's scale.
+     @{
+     @} */
+
+#define LEAF_WAVETABLE_IMAGE_MAGIC "LWTI"
+#define LEAF_WAVETABLE_IMAGE_VERSION 1
+
+    typedef enum LEAFWaveTableImageFormat
+    {
+        LEAFWaveTableImageFloat32 = 0,
+        LEAFWaveTableImageInt16
+    } LEAFWaveTableImageFormat;
+    
+    typedef struct LEAFWaveTableImageHeader
+    {
+        char magic[4];          // LEAF_WAVETABLE_IMAGE_MAGIC
+        uint16_t version;       // LEAF_WAVETABLE_IMAGE_VERSION
+        uint16_t format;        // LEAFWaveTableImageFormat
+        uint32_t numLevels;     // Level 0 is the full-band table, each level after has half the bandwidth
+        float sampleRate;       // Sample rate the levels were designed for
+        float maxFreq;          // Maximum expected oscillator frequency
+        float scale;            // Int16 sample scale
+        uint32_t reserved[2];
+    } LEAFWaveTableImageHeader;
+    
+    typedef struct LEAFWaveTableImageLevel
+    {
+        uint32_t size;          // Number of samples
+        uint32_t offset;        // Byte offset of the data from the start of the image
+    } LEAFWaveTableImageLevel;
+    
+    //==============================================================================
+    
     /*!
      @defgroup twavetable tWaveTable
      @ingroup oscillators
@@ -964,10 +1451,51 @@ extern "C" {
      @param maxFreq The maximum expected frequency of the oscillator. The higher this is, the more memory will be needed.
      @param mempool A pointer to the tMempool to use.
      
+     @fn void    tWaveTable_initDeferred  (tWaveTable* const osc, float* table, int size, float maxFreq, LEAF* const leaf)
+     @brief Initialize a tWaveTable to the default mempool of a LEAF instance without building its band-limited levels. Call tWaveTable_buildStep until it returns 1 to build them; oscillators read the highest level built so far in the meantime, starting from the base table.
+     @param osc A pointer to the tWaveTable to initialize.
+     @param table A pointer to the wavetable data.
+     @param size The number of samples in the wavetable.
+     @param maxFreq The maximum expected frequency of the oscillator. The higher this is, the more memory will be needed.
+     @param leaf A pointer to the leaf instance.
+     
+     @fn void    tWaveTable_initToPoolDeferred   (tWaveTable* const osc, float* table, int size, float maxFreq, tMempool* const mempool)
+     @brief Initialize a tWaveTable to a specified mempool without building its band-limited levels.
+     @param osc A pointer to the tWaveTable to initialize.
+     @param table A pointer to the wavetable data.
+     @param size The number of samples in the wave table.
+     @param maxFreq The maximum expected frequency of the oscillator. The higher this is, the more memory will be needed.
+     @param mempool A pointer to the tMempool to use.
+     
      @fn void    tWaveTable_free         (tWaveTable* const osc)
      @brief Free a tWaveTable from its mempool.
      @param osc A pointer to the tWaveTable to free.
      
+     @fn int     tWaveTable_buildStep    (tWaveTable* const osc, int budgetSamples)
+     @brief Build part of the band-limited levels of a tWaveTable, for example from an idle task. Each level becomes readable as soon as it is finished. Call from the thread that ticks the oscillators, or from a task that the audio callback preempts on the same core.
+     @param osc A pointer to the relevant tWaveTable.
+     @param budgetSamples The maximum number of samples to filter in this call.
+     @return 1 if every level is built, otherwise 0.
+     
+     @fn void    tWaveTable_initFromImage (tWaveTable* const osc, const void* image, size_t imageSize, LEAF* const leaf)
+     @brief Initialize a tWaveTable from a wavetable image to the default mempool of a LEAF instance. Float32 level data is read in place, from flash or a memory-mapped file for example, and nothing needs to be built. All levels must have the same size. An invalid image reports LEAFInvalidImage and gives a silent table.
+     @param osc A pointer to the tWaveTable to initialize.
+     @param image A pointer to the image. See @ref wavetableimage.
+     @param imageSize The size of the image in bytes.
+     @param leaf A pointer to the leaf instance.
+     
+     @fn void    tWaveTable_initToPoolFromImage (tWaveTable* const osc, const void* image, size_t imageSize, tMempool* const mempool)
+     @brief Initialize a tWaveTable from a wavetable image to a specified mempool.
+     @param osc A pointer to the tWaveTable to initialize.
+     @param image A pointer to the image. See @ref wavetableimage.
+     @param imageSize The size of the image in bytes.
+     @param mempool A pointer to the tMempool to use.
+     
+     @fn float   tWaveTable_getBuildProgress (tWaveTable* const osc)
+     @brief Get how much of the band-limited levels have been built.
+     @param osc A pointer to the relevant tWaveTable.
+     @return The progress from 0.0 to 1.0.
+     
      @} */
     
     typedef struct _tWaveTable
@@ -982,6 +1510,16 @@ extern "C" {
         float baseFreq, invBaseFreq;
         tButterworth bl;
         float sampleRate;
+        
+        // Incremental build state
+        volatile int numReady;
+        int buildLevel, buildPass, buildIndex;
+        int buildDone, buildTotal;
+        float buildFreq;
+        
+        // Levels come from an image and are not rebuilt; ownsLevels is 0 when they are all read in place
+        int fromImage;
+        int ownsLevels;
     } _tWaveTable;
     
     typedef _tWaveTable* tWaveTable;
@@ -990,7 +1528,15 @@ extern "C" {
                             float maxFreq, LEAF* const leaf);
     void    tWaveTable_initToPool(tWaveTable* const osc, float* table, int size,
                                   float maxFreq, tMempool* const mempool);
+    void    tWaveTable_initDeferred(tWaveTable* const osc, float* table, int size,
+                                    float maxFreq, LEAF* const leaf);
+    void    tWaveTable_initToPoolDeferred(tWaveTable* const osc, float* table, int size,
+                                          float maxFreq, tMempool* const mempool);
+    void    tWaveTable_initFromImage(tWaveTable* const osc, const void* image, size_t imageSize, LEAF* const leaf);
+    void    tWaveTable_initToPoolFromImage(tWaveTable* const osc, const void* image, size_t imageSize, tMempool* const mempool);
     void    tWaveTable_free(tWaveTable* const osc);
+    int     tWaveTable_buildStep(tWaveTable* const osc, int budgetSamples);
+    float   tWaveTable_getBuildProgress(tWaveTable* const osc);
     void    tWaveTable_setSampleRate (tWaveTable* const osc, float sr);
    
     //==============================================================================
@@ -1032,6 +1578,7 @@ extern "C" {
     void    tWaveOsc_init(tWaveOsc* const osc, tWaveTable* const table, LEAF* const leaf);
     void    tWaveOsc_initToPool(tWaveOsc* const osc, tWaveTable* const table, tMempool* const mempool);
     void    tWaveOsc_free(tWaveOsc* const osc);
+#define tWaveOsc_getRequiredSize() LEAF_MEMPOOL_BLOCK_SIZE(sizeof(_tWaveOsc))
     
     float   tWaveOsc_tick(tWaveOsc* const osc);
     void    tWaveOsc_setFreq(tWaveOsc* const osc, float freq);
@@ -1045,23 +1592,26 @@ extern "C" {
      @defgroup twavesynth tWaveSynth
      @ingroup oscillators
      @brief Set of anti-aliased wavetable oscillators that can be faded between.
+     @details Every voice reads the same band-limited tables, and voice state is kept as per-voice arrays so all voices tick together. Only the two tables being faded between are read on each tick.
      @{
      
-     @fn void    tWaveSynth_init(tWaveSynth* const osc, const float** tables, int n, int size, float maxFreq, LEAF* const leaf)
+     @fn void    tWaveSynth_init(tWaveSynth* const osc, int numVoices, float** tables, int* sizes, int numTables, float maxFreq, LEAF* const leaf)
      @brief Initialize a tWaveSynth to the default mempool of a LEAF instance.
      @param osc A pointer to the tWaveSynth to initialize.
+     @param numVoices The number of voices.
      @param tables An array of pointers to wavetable data.
-     @param n The number of wavetables.
-     @param size The number of samples in each of the wavetables.
+     @param sizes The number of samples in each of the wavetables. Tables with a size of 0 are skipped.
+     @param numTables The number of wavetables.
      @param maxFreq The maximum expected frequency of the oscillator. The higher this is, the more memory will be needed.
      @param leaf A pointer to the leaf instance.
      
-     @fn void  tWaveSynth_initToPool(tWaveSynth* const osc, const float** tables, int n, int size, float maxFreq, tMempool* const mempool)
+     @fn void  tWaveSynth_initToPool(tWaveSynth* const osc, int numVoices, float** tables, int* sizes, int numTables, float maxFreq, tMempool* const mempool)
      @brief Initialize a tWaveSynth to a specified mempool.
      @param osc A pointer to the tWaveTable to initialize.
+     @param numVoices The number of voices.
      @param tables An array of pointers to wavetable data.
-     @param n The number of wavetables.
-     @param size The number of samples in each of the wavetables.
+     @param sizes The number of samples in each of the wavetables. Tables with a size of 0 are skipped.
+     @param numTables The number of wavetables.
      @param maxFreq The maximum expected frequency of the oscillator. The higher this is, the more memory will be needed.
      @param mempool A pointer to the tMempool to use.
      
@@ -1070,13 +1620,37 @@ extern "C" {
      @param osc A pointer to the tWaveSynth to free.
      
      @fn float   tWaveSynth_tick         (tWaveSynth* const osc)
-     @brief Tick a tWaveSynth oscillator.
+     @brief Tick every voice of a tWaveSynth and return their sum.
+     @param osc A pointer to the relevant tWaveSynth.
+     @return The ticked sample.
+     
+     @fn float   tWaveSynth_tickVoice    (tWaveSynth* const osc, int voice)
+     @brief Tick a single voice of a tWaveSynth.
      @param osc A pointer to the relevant tWaveSynth.
+     @param voice The index of the voice.
      @return The ticked sample as a float from -1 to 1.
      
-     @fn void    tWaveSynth_setFreq      (tWaveSynth* const osc, float freq)
-     @brief Set the frequency of a tWaveSynth oscillator.
+     @fn void    tWaveSynth_tickVoices   (tWaveSynth* const osc, float* output)
+     @brief Tick every voice of a tWaveSynth once.
+     @param osc A pointer to the relevant tWaveSynth.
+     @param output An array of at least numVoices floats to receive one sample per voice.
+     
+     @fn void    tWaveSynth_tickBlock    (tWaveSynth* const osc, float* output, int size)
+     @brief Fill a block with the summed output of every voice, as from repeated calls to tWaveSynth_tick.
      @param osc A pointer to the relevant tWaveSynth.
+     @param output The buffer to write to.
+     @param size The number of samples to generate.
+     
+     @fn void    tWaveSynth_tickVoicesBlock (tWaveSynth* const osc, float** outputs, int size)
+     @brief Tick every voice of a tWaveSynth for a block of samples.
+     @param osc A pointer to the relevant tWaveSynth.
+     @param outputs An array of numVoices output buffers, each at least size samples long.
+     @param size The number of samples to generate per voice.
+     
+     @fn void    tWaveSynth_setFreq      (tWaveSynth* const osc, int voice, float freq)
+     @brief Set the frequency of a voice of a tWaveSynth.
+     @param osc A pointer to the relevant tWaveSynth.
+     @param voice The index of the voice.
      @param freq The frequency to set the oscillator to.
      
      @fn void    tWaveSynth_setIndex(tWaveSynth* const osc, float index)
@@ -1090,12 +1664,24 @@ extern "C" {
         tMempool mempool;
         
         tWaveTable* tables;
-        tWaveOsc** oscs;
         int numTables;
         int numVoices;
+        int numLanes;
         float* g;
         float index;
         float maxFreq;
+        
+        // Per-voice state, numLanes long
+        float* phase;
+        float* inc;
+        float* freq;
+        // Per-table, per-voice octave selection, numTables * numLanes long
+        int* oct;
+        float* w;
+        float* phaseOffset;
+        float* scratch;
+        float aa;
+        float invSampleRate;
     } _tWaveSynth;
     
     typedef _tWaveSynth* tWaveSynth;
@@ -1108,6 +1694,9 @@ extern "C" {
     
     float   tWaveSynth_tick(tWaveSynth* const osc);
     float   tWaveSynth_tickVoice(tWaveSynth* const cy, int voice);
+    void    tWaveSynth_tickVoices(tWaveSynth* const osc, float* output);
+    void    tWaveSynth_tickBlock(tWaveSynth* const osc, float* output, int size);
+    void    tWaveSynth_tickVoicesBlock(tWaveSynth* const osc, float** outputs, int size);
     void    tWaveSynth_setFreq(tWaveSynth* const osc, int voice, float freq);
     void    tWaveSynth_setAntiAliasing(tWaveSynth* const osc, float aa);
     void    tWaveSynth_setIndex(tWaveSynth* const osc, float index);
@@ -1140,10 +1729,51 @@ extern "C" {
      @param maxFreq The maximum expected frequency of the oscillator. The higher this is, the more memory will be needed.
      @param mempool A pointer to the tMempool to use.
      
+     @fn void    tWaveTableS_initDeferred  (tWaveTableS* const osc, float* table, int size, float maxFreq, LEAF* const leaf)
+     @brief Initialize a tWaveTableS to the default mempool of a LEAF instance without building its band-limited levels. Call tWaveTableS_buildStep until it returns 1 to build them; oscillators read the highest level built so far in the meantime, starting from the base table.
+     @param osc A pointer to the tWaveTableS to initialize.
+     @param table A pointer to the wavetable data.
+     @param size The number of samples in the wavetable.
+     @param maxFreq The maximum expected frequency of the oscillator. The higher this is, the more memory will be needed.
+     @param leaf A pointer to the leaf instance.
+     
+     @fn void    tWaveTableS_initToPoolDeferred   (tWaveTableS* const osc, float* table, int size, float maxFreq, tMempool* const mempool)
+     @brief Initialize a tWaveTableS to a specified mempool without building its band-limited levels.
+     @param osc A pointer to the tWaveTableS to initialize.
+     @param table A pointer to the wavetable data.
+     @param size The number of samples in the wave table.
+     @param maxFreq The maximum expected frequency of the oscillator. The higher this is, the more memory will be needed.
+     @param mempool A pointer to the tMempool to use.
+     
      @fn void    tWaveTableS_free         (tWaveTableS* const osc)
      @brief Free a tWaveTableS from its mempool.
      @param osc A pointer to the tWaveTableS to free.
      
+     @fn int     tWaveTableS_buildStep    (tWaveTableS* const osc, int budgetSamples)
+     @brief Build part of the band-limited levels of a tWaveTableS, for example from an idle task. Each level becomes readable as soon as it is finished. Call from the thread that ticks the oscillators, or from a task that the audio callback preempts on the same core.
+     @param osc A pointer to the relevant tWaveTableS.
+     @param budgetSamples The maximum number of samples to filter in this call.
+     @return 1 if every level is built, otherwise 0.
+     
+     @fn void    tWaveTableS_initFromImage (tWaveTableS* const osc, const void* image, size_t imageSize, LEAF* const leaf)
+     @brief Initialize a tWaveTableS from a wavetable image to the default mempool of a LEAF instance. Float32 level data is read in place, from flash or a memory-mapped file for example, and nothing needs to be built. Each level is usually half the size of the one before it. An invalid image reports LEAFInvalidImage and gives a silent table.
+     @param osc A pointer to the tWaveTableS to initialize.
+     @param image A pointer to the image. See @ref wavetableimage.
+     @param imageSize The size of the image in bytes.
+     @param leaf A pointer to the leaf instance.
+     
+     @fn void    tWaveTableS_initToPoolFromImage (tWaveTableS* const osc, const void* image, size_t imageSize, tMempool* const mempool)
+     @brief Initialize a tWaveTableS from a wavetable image to a specified mempool.
+     @param osc A pointer to the tWaveTableS to initialize.
+     @param image A pointer to the image. See @ref wavetableimage.
+     @param imageSize The size of the image in bytes.
+     @param mempool A pointer to the tMempool to use.
+     
+     @fn float   tWaveTableS_getBuildProgress (tWaveTableS* const osc)
+     @brief Get how much of the band-limited levels have been built.
+     @param osc A pointer to the relevant tWaveTableS.
+     @return The progress from 0.0 to 1.0.
+     
      @} */
     
     typedef struct _tWaveTableS
@@ -1160,13 +1790,28 @@ extern "C" {
         float dsBuffer[2];
         tOversampler ds;
         float sampleRate;
+        
+        // Incremental build state
+        volatile int numReady;
+        int buildLevel, buildPass, buildIndex;
+        int buildDone, buildTotal;
+        
+        // Levels come from an image and are not rebuilt; ownsLevels is 0 when they are all read in place
+        int fromImage;
+        int ownsLevels;
     } _tWaveTableS;
     
     typedef _tWaveTableS* tWaveTableS;
     
     void    tWaveTableS_init(tWaveTableS* const osc, float* table, int size, float maxFreq, LEAF* const leaf);
     void    tWaveTableS_initToPool(tWaveTableS* const osc, float* table, int size, float maxFreq, tMempool* const mempool);
+    void    tWaveTableS_initDeferred(tWaveTableS* const osc, float* table, int size, float maxFreq, LEAF* const leaf);
+    void    tWaveTableS_initToPoolDeferred(tWaveTableS* const osc, float* table, int size, float maxFreq, tMempool* const mempool);
+    void    tWaveTableS_initFromImage(tWaveTableS* const osc, const void* image, size_t imageSize, LEAF* const leaf);
+    void    tWaveTableS_initToPoolFromImage(tWaveTableS* const osc, const void* image, size_t imageSize, tMempool* const mempool);
     void    tWaveTableS_free(tWaveTableS* const osc);
+    int     tWaveTableS_buildStep(tWaveTableS* const osc, int budgetSamples);
+    float   tWaveTableS_getBuildProgress(tWaveTableS* const osc);
     void    tWaveTableS_setSampleRate (tWaveTableS* const osc, float sr);
     
     /*!
@@ -1195,6 +1840,10 @@ extern "C" {
      @brief Free a tWaveOscS from its mempool.
      @param osc A pointer to the tWaveOscS to free.
      
+     @fn size_t  tWaveOscS_getRequiredSize (void)
+     @brief Get the bytes tWaveOscS_initToPool() allocates from a first-fit mempool, as a constant expression that can size static memory.
+     @return The size in bytes.
+     
      @fn float  tWaveOscS_tick         (tWaveOscS* const osc)
      @brief Tick a tWaveOscS oscillator.
      @param osc A pointer to the relevant tWaveOscS.
@@ -1225,6 +1874,7 @@ extern "C" {
     void    tWaveOscS_init(tWaveOscS* const osc, tWaveTableS* const table, LEAF* const leaf);
     void    tWaveOscS_initToPool(tWaveOscS* const osc, tWaveTableS* const table, tMempool* const mempool);
     void    tWaveOscS_free(tWaveOscS* const osc);
+#define tWaveOscS_getRequiredSize() LEAF_MEMPOOL_BLOCK_SIZE(sizeof(_tWaveOscS))
     
     float   tWaveOscS_tick(tWaveOscS* const osc);
     void    tWaveOscS_setFreq(tWaveOscS* const osc, float freq);
@@ -0,0 +1,128 @@
+/*==============================================================================
+
+ leaf-parallel.h
+ 
+ ==============================================================================*/
+
+#ifndef LEAF_PARALLEL_H_INCLUDED
+#define LEAF_PARALLEL_H_INCLUDED
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+    //==============================================================================
+
+#include "leaf-global.h"
+#include "leaf-mempool.h"
+
+    /*!
+     * @internal
+     * Header.
+     * @include basic-oscillators.h
+     * @example basic-oscillators.c
+     * An example.
+     */
+    
+    //==============================================================================
+    
+    /*!
+     @defgroup tvoicerenderer tVoiceRenderer
+     @ingroup parallel
+     @brief Renders the voices of a synth on several cores a block at a time.
+     @details Each worker is a core or thread. Each block, tVoiceRenderer_process() splits the voices into contiguous runs, one per worker, and puts each run in that worker's deque. A worker renders voices from the back of its own deque. Once its deque is empty, it steals from the front of the others. Voices that cost more than others, or a core slowed by an interrupt, don't hold up the block while another core is idle.
+     
+     Each voice renders into its own block. The blocks are summed in voice order once every voice is done, so the mix is bit for bit the same as rendering the voices in a plain loop, whatever the number of workers and whichever core got which voice.
+     
+     LEAF creates no threads. The thread that calls tVoiceRenderer_process() is worker 0 and renders voices too. Each other worker, from 1 to numWorkers - 1, needs a core or thread of its own that keeps calling tVoiceRenderer_work() with its index. On a dual core STM32H7 that means the M4 polling in its main loop. On a desktop it means one thread per extra core. Call LEAF_enterAudioThread() once on each of them.
+     
+     Objects belonging to voices that render on different cores shouldn't share a mempool. Give each worker a tMempool of its own, made from the main mempool before audio starts, and init its voices' objects to that mempool. The LEAF allocation counters are atomic, so pools on different cores can allocate at the same time. Objects that use the LEAF random function call it from whichever core they run on, so that function must be safe to call from several threads. tNoise only calls it at initialization, unless told to use it with tNoise_setRandomFunction().
+     @{
+     
+     @fn void    tVoiceRenderer_init         (tVoiceRenderer* const renderer, int maxVoices, int numWorkers, int maxBlockSize, LEAF* const leaf)
+     @brief Initialize a tVoiceRenderer to the default mempool of a LEAF instance.
+     @param renderer A pointer to the tVoiceRenderer to initialize.
+     @param maxVoices The largest number of voices to render, up to 65535.
+     @param numWorkers The number of cores or threads rendering, including the one calling tVoiceRenderer_process().
+     @param maxBlockSize The largest block processed in one call.
+     @param leaf A pointer to the leaf instance.
+     
+     @fn void    tVoiceRenderer_initToPool   (tVoiceRenderer* const renderer, int maxVoices, int numWorkers, int maxBlockSize, tMempool* const mempool)
+     @brief Initialize a tVoiceRenderer to a specified mempool.
+     @param renderer A pointer to the tVoiceRenderer to initialize.
+     @param maxVoices The largest number of voices to render, up to 65535.
+     @param numWorkers The number of cores or threads rendering, including the one calling tVoiceRenderer_process().
+     @param maxBlockSize The largest block processed in one call.
+     @param mempool A pointer to the tMempool to use.
+     
+     @fn void    tVoiceRenderer_free         (tVoiceRenderer* const renderer)
+     @brief Free a tVoiceRenderer from its mempool. Workers must have stopped calling tVoiceRenderer_work() first.
+     @param renderer A pointer to the tVoiceRenderer to free.
+     
+     @fn void    tVoiceRenderer_setNumVoices (tVoiceRenderer* const renderer, int numVoices)
+     @brief Set how many voices are rendered, starting from voice 0, so the voice count can follow the number of cores available. Call it from the thread calling tVoiceRenderer_process(), between blocks.
+     @param renderer A pointer to the relevant tVoiceRenderer.
+     @param numVoices The number of voices, up to maxVoices.
+     
+     @fn int     tVoiceRenderer_getNumVoices (tVoiceRenderer* const renderer)
+     @brief Get how many voices are rendered.
+     @param renderer A pointer to the relevant tVoiceRenderer.
+     @return The number of voices.
+     
+     @fn void    tVoiceRenderer_process      (tVoiceRenderer* const renderer, tVoiceRenderCallback render, void* userData, float* output, int size)
+     @brief Render every voice and write their sum to output, working on voices as worker 0 and returning once all of them are done.
+     @param renderer A pointer to the relevant tVoiceRenderer.
+     @param render Called once for each voice, from whichever worker takes it, to write size samples of that voice into the block it's given.
+     @param userData Passed to the render callback.
+     @param output The block to write the mix to.
+     @param size The number of samples in the block. Blocks longer than maxBlockSize are run in pieces.
+     
+     @fn int     tVoiceRenderer_work         (tVoiceRenderer* const renderer, int worker)
+     @brief Render voices of the current block for a worker other than worker 0, first from its own deque and then from the others, until none are left. Returns straight away between blocks.
+     @param renderer A pointer to the relevant tVoiceRenderer.
+     @param worker The worker's index, from 1 to numWorkers - 1. Each index must only be used by one thread.
+     @return The number of voices this call rendered.
+     
+     @} */
+    
+    typedef void (*tVoiceRenderCallback)(void* userData, int voice, float* output, int size);
+    
+    typedef struct _tVoiceRenderer
+    {
+        tMempool mempool;
+        
+        int maxVoices, numVoices;
+        int numWorkers;
+        int maxBlockSize;
+        
+        float* voiceBlocks; // maxBlockSize samples for each voice
+        volatile uint32_t* deques; // One per worker, the front in the low 16 bits and the back in the high 16
+        volatile uint32_t done; // Voices finished this block
+        
+        tVoiceRenderCallback render;
+        void* userData;
+        int size;
+    } _tVoiceRenderer;
+    
+    typedef _tVoiceRenderer* tVoiceRenderer;
+    
+    void    tVoiceRenderer_init         (tVoiceRenderer* const renderer, int maxVoices, int numWorkers, int maxBlockSize, LEAF* const leaf);
+    void    tVoiceRenderer_initToPool   (tVoiceRenderer* const renderer, int maxVoices, int numWorkers, int maxBlockSize, tMempool* const mempool);
+    void    tVoiceRenderer_free         (tVoiceRenderer* const renderer);
+    
+    void    tVoiceRenderer_setNumVoices (tVoiceRenderer* const renderer, int numVoices);
+    int     tVoiceRenderer_getNumVoices (tVoiceRenderer* const renderer);
+    
+    void    tVoiceRenderer_process      (tVoiceRenderer* const renderer, tVoiceRenderCallback render, void* userData, float* output, int size);
+    int     tVoiceRenderer_work         (tVoiceRenderer* const renderer, int worker);
+    
+    //==============================================================================
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LEAF_PARALLEL_H_INCLUDED
+
+//==============================================================================
+
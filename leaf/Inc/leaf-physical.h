@@ -14,9 +14,9 @@
 #ifdef __cplusplus
 extern "C" {
 #endif
-    
+
     //==============================================================================
-    
+
 #include "leaf-global.h"
 #include "leaf-math.h"
 #include "leaf-mempool.h"
@@ -25,7 +25,7 @@ extern "C" {
 #include "leaf-oscillators.h"
 #include "leaf-envelopes.h"
 #include "leaf-dynamics.h"
-    
+
     /*!
      * @internal
      * Header.
@@ -337,6 +337,179 @@ extern "C" {
     
     // ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~
     
+    /*!
+     @defgroup tsimplelivingstringbank tSimpleLivingStringBank
+     @ingroup physical
+     @brief A bank of simplified string models, rendered a block at a time.
+     @details Each string produces the same output sample for sample as a tSimpleLivingString with the same settings. The delay lines of all the strings share one arena and the strings are processed side by side, one sample at a time across the whole bank, so the filter and leveler updates run as independent lanes instead of one long dependency chain per string. Strings are excited with tSimpleLivingStringBank_pluck() or tSimpleLivingStringBank_excite(), which add into the input of the next block at a given offset.
+     @{
+     
+     @fn void    tSimpleLivingStringBank_init           (tSimpleLivingStringBank* const, int numStrings, int blockSize, float freq, float dampFreq, float decay, float targetLev, float levSmoothFactor, float levStrength, int levMode, LEAF* const leaf)
+     @brief Initialize a tSimpleLivingStringBank to the default mempool of a LEAF instance.
+     @param bank A pointer to the tSimpleLivingStringBank to initialize.
+     @param numStrings The number of strings in the bank.
+     @param blockSize The largest block the bank will be ticked with.
+     @param freq The starting frequency of every string.
+     @param dampFreq The cutoff of the loop filter in Hz.
+     @param decay The amplitude damping factor, only used in leveler mode 0.
+     @param targetLev The target level of the feedback leveler.
+     @param levSmoothFactor The smoothing factor of the leveler's power follower.
+     @param levStrength How strongly the leveler acts.
+     @param levMode 0 to only limit upwards, 1 to hold the string at the target level.
+     @param leaf A pointer to the leaf instance.
+     
+     @fn void    tSimpleLivingStringBank_initToPool     (tSimpleLivingStringBank* const, int numStrings, int blockSize, float freq, float dampFreq, float decay, float targetLev, float levSmoothFactor, float levStrength, int levMode, tMempool* const)
+     @brief Initialize a tSimpleLivingStringBank to a specified mempool.
+     @param bank A pointer to the tSimpleLivingStringBank to initialize.
+     @param mempool A pointer to the tMempool to use.
+     
+     @fn void    tSimpleLivingStringBank_free           (tSimpleLivingStringBank* const)
+     @brief Free a tSimpleLivingStringBank from its mempool.
+     @param bank A pointer to the tSimpleLivingStringBank to free.
+     
+     @fn void    tSimpleLivingStringBank_tickBlock      (tSimpleLivingStringBank* const, float* output, int size)
+     @brief Render the next block of every string and clear the pending excitation.
+     @param bank A pointer to the relevant tSimpleLivingStringBank.
+     @param output A block to write the sum of all the strings to, or NULL to only fill each string's buffer.
+     @param size The block size, up to the size given at initialization.
+     
+     @fn float*  tSimpleLivingStringBank_getBuffer      (tSimpleLivingStringBank* const, int index)
+     @brief Get a string's buffer, filled by the last tSimpleLivingStringBank_tickBlock().
+     @param bank A pointer to the relevant tSimpleLivingStringBank.
+     @param index The string.
+     
+     @fn float   tSimpleLivingStringBank_sample         (tSimpleLivingStringBank* const, int index)
+     @brief Get a string's last output sample.
+     @param bank A pointer to the relevant tSimpleLivingStringBank.
+     @param index The string.
+     
+     @fn void    tSimpleLivingStringBank_pluck          (tSimpleLivingStringBank* const, int index, int offset, float amplitude)
+     @brief Add an impulse to a string's input in the next block.
+     @param bank A pointer to the relevant tSimpleLivingStringBank.
+     @param index The string.
+     @param offset The sample in the next block to pluck at.
+     @param amplitude The size of the impulse.
+     
+     @fn void    tSimpleLivingStringBank_excite         (tSimpleLivingStringBank* const, int index, int offset, const float* input, int size)
+     @brief Add a signal to a string's input in the next block. Anything past the end of the block is dropped.
+     @param bank A pointer to the relevant tSimpleLivingStringBank.
+     @param index The string.
+     @param offset The sample in the next block the signal starts at.
+     @param input The excitation signal.
+     @param size The length of the signal.
+     
+     @fn void    tSimpleLivingStringBank_setFreq        (tSimpleLivingStringBank* const, int index, float freq)
+     @brief Set the frequency of a string, from 20 to 10000 Hz. The wavelength glides there.
+     @param bank A pointer to the relevant tSimpleLivingStringBank.
+     @param index The string.
+     
+     @fn void    tSimpleLivingStringBank_setWaveLength  (tSimpleLivingStringBank* const, int index, float waveLength)
+     @brief Set the wavelength of a string in samples, from 4.8 to 2400.
+     @param bank A pointer to the relevant tSimpleLivingStringBank.
+     @param index The string.
+     
+     @fn void    tSimpleLivingStringBank_setDampFreq    (tSimpleLivingStringBank* const, int index, float dampFreq)
+     @brief Set the cutoff of a string's loop filter in Hz.
+     @param bank A pointer to the relevant tSimpleLivingStringBank.
+     @param index The string.
+     
+     @fn void    tSimpleLivingStringBank_setDecay       (tSimpleLivingStringBank* const, int index, float decay)
+     @brief Set a string's amplitude damping factor. Should be near 1.0.
+     @param bank A pointer to the relevant tSimpleLivingStringBank.
+     @param index The string.
+     
+     @fn void    tSimpleLivingStringBank_setTargetLev   (tSimpleLivingStringBank* const, int index, float targetLev)
+     @brief Set the target level of a string's feedback leveler.
+     @param bank A pointer to the relevant tSimpleLivingStringBank.
+     @param index The string.
+     
+     @fn void    tSimpleLivingStringBank_setLevSmoothFactor (tSimpleLivingStringBank* const, int index, float levSmoothFactor)
+     @brief Set the smoothing factor of a string's leveler.
+     @param bank A pointer to the relevant tSimpleLivingStringBank.
+     @param index The string.
+     
+     @fn void    tSimpleLivingStringBank_setLevStrength (tSimpleLivingStringBank* const, int index, float levStrength)
+     @brief Set how strongly a string's leveler acts.
+     @param bank A pointer to the relevant tSimpleLivingStringBank.
+     @param index The string.
+     
+     @fn void    tSimpleLivingStringBank_setLevMode     (tSimpleLivingStringBank* const, int index, int levMode)
+     @brief Set a string's leveler mode.
+     @param bank A pointer to the relevant tSimpleLivingStringBank.
+     @param index The string.
+     
+     @} */
+    
+    typedef struct _tSimpleLivingStringBank
+    {
+        tMempool mempool;
+        
+        int numStrings;
+        int blockSize;
+        float* buffers;
+        float* excitation; // interleaved by sample, numStrings wide
+        int excited;
+        
+        // Every delay line is the same power of two size and they all move together, so they share an input point
+        float* arena;
+        uint32_t delaySize, delayMask, inPoint;
+        
+        // Per string
+        uint32_t* outPoint;
+        float* alpha;
+        float* omAlpha;
+        float* waveLength;
+        float* wlCurr;
+        float* dampFreq;
+        float* b0;
+        float* a1;
+        float* lpOut;
+        float* decay;
+        float* loopGain; // decay in leveler mode 0, otherwise 1
+        int* levMode;
+        float* targetLevel;
+        float* factor;
+        float* oneminusfactor;
+        float* strength;
+        float* power;
+        float* xs;
+        float* ys;
+        float* curr;
+        
+        float wlFactor, wlOneMinusFactor;
+        float R;
+        float sampleRate;
+        float twoPiTimesInvSampleRate;
+        float denormalOffset;
+    } _tSimpleLivingStringBank;
+    
+    typedef _tSimpleLivingStringBank* tSimpleLivingStringBank;
+    
+    void    tSimpleLivingStringBank_init            (tSimpleLivingStringBank* const, int numStrings, int blockSize, float freq,
+                                                     float dampFreq, float decay, float targetLev, float levSmoothFactor,
+                                                     float levStrength, int levMode, LEAF* const leaf);
+    void    tSimpleLivingStringBank_initToPool      (tSimpleLivingStringBank* const, int numStrings, int blockSize, float freq,
+                                                     float dampFreq, float decay, float targetLev, float levSmoothFactor,
+                                                     float levStrength, int levMode, tMempool* const);
+    void    tSimpleLivingStringBank_free            (tSimpleLivingStringBank* const);
+    
+    void    tSimpleLivingStringBank_tickBlock       (tSimpleLivingStringBank* const, float* output, int size);
+    float*  tSimpleLivingStringBank_getBuffer       (tSimpleLivingStringBank* const, int index);
+    float   tSimpleLivingStringBank_sample          (tSimpleLivingStringBank* const, int index);
+    void    tSimpleLivingStringBank_pluck           (tSimpleLivingStringBank* const, int index, int offset, float amplitude);
+    void    tSimpleLivingStringBank_excite          (tSimpleLivingStringBank* const, int index, int offset, const float* input, int size);
+    void    tSimpleLivingStringBank_setFreq         (tSimpleLivingStringBank* const, int index, float freq);
+    void    tSimpleLivingStringBank_setWaveLength   (tSimpleLivingStringBank* const, int index, float waveLength); // in samples
+    void    tSimpleLivingStringBank_setDampFreq     (tSimpleLivingStringBank* const, int index, float dampFreq);
+    void    tSimpleLivingStringBank_setDecay        (tSimpleLivingStringBank* const, int index, float decay); // should be near 1.0
+    void    tSimpleLivingStringBank_setTargetLev    (tSimpleLivingStringBank* const, int index, float targetLev);
+    void    tSimpleLivingStringBank_setLevSmoothFactor (tSimpleLivingStringBank* const, int index, float levSmoothFactor);
+    void    tSimpleLivingStringBank_setLevStrength  (tSimpleLivingStringBank* const, int index, float levStrength);
+    void    tSimpleLivingStringBank_setLevMode      (tSimpleLivingStringBank* const, int index, int levMode);
+    void    tSimpleLivingStringBank_setSampleRate   (tSimpleLivingStringBank* const, float sr);
+    
+    // ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~
+    
     /*!
      @defgroup tlivingstring tLivingString
      @ingroup physical
@@ -405,6 +578,25 @@ extern "C" {
      @brief
      @param string A pointer to the relevant tLivingString.
      
+     @fn void    tLivingString_tickBlock             (tLivingString* const, const float* input, float* output, int size)
+     @brief Process a block of samples, the same as calling tLivingString_tick() on each.
+     @details The delay lines, filters and smoothers are read into locals once per block and written back at the end, so the whole string runs as one loop. Parameters set between blocks take effect at the start of the next one.
+     @param string A pointer to the relevant tLivingString.
+     @param input The excitation, or NULL for none.
+     @param output The block to write to.
+     @param size The number of samples to process.
+     
+     @fn void    tLivingString_setQuiescence     (tLivingString* const, float threshold, int holdSamples)
+     @brief Let tLivingString_tickBlock() sleep once the string has died away. After the excitation and output have stayed under the threshold for holdSamples, each block writes zeros and skips the string, until the excitation goes over the threshold again. A string held up by the feedback leveler never gets quiet enough.
+     @param string A pointer to the relevant tLivingString.
+     @param threshold The absolute level under which the string counts as silent, such as 0.0001 for -80 dB, or 0 to always process. Off by default.
+     @param holdSamples How long it must be quiet first. This should be at least the wavelength in samples at the lowest frequency the string plays.
+     
+     @fn int     tLivingString_isQuiescent       (tLivingString* const)
+     @brief Check whether the string is sleeping.
+     @param string A pointer to the relevant tLivingString.
+     @return 1 if blocks with a quiet excitation are skipped, otherwise 0.
+     
      @} */
     
     typedef struct _tLivingString
@@ -423,6 +615,8 @@ extern "C" {
         tFeedbackLeveler fbLevU, fbLevL;
         tExpSmooth wlSmooth, ppSmooth;
         float sampleRate;
+        float denormalOffset;
+        LEAFQuiescence quiet;
     } _tLivingString;
     
     typedef _tLivingString* tLivingString;
@@ -448,6 +642,9 @@ extern "C" {
     void    tLivingString_setLevStrength        (tLivingString* const, float levStrength);
     void    tLivingString_setLevMode            (tLivingString* const, int levMode);
     void    tLivingString_setSampleRate         (tLivingString* const, float sr);
+    void    tLivingString_tickBlock             (tLivingString* const, const float* input, float* output, int size);
+    void    tLivingString_setQuiescence         (tLivingString* const, float threshold, int holdSamples);
+    int     tLivingString_isQuiescent           (tLivingString* const);
     
     // ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~
     
@@ -651,6 +848,13 @@ extern "C" {
      @brief
      @param string A pointer to the relevant tComplexLivingString.
      
+     @fn void    tComplexLivingString_tickBlock             (tComplexLivingString* const, const float* input, float* output, int size)
+     @brief Process a block of samples, the same as calling tComplexLivingString_tick() on each.
+     @param string A pointer to the relevant tComplexLivingString.
+     @param input The excitation, or NULL for none.
+     @param output The block to write to.
+     @param size The number of samples to process.
+     
      @} */
     
     typedef struct _tComplexLivingString
@@ -671,6 +875,7 @@ extern "C" {
         tFeedbackLeveler fbLevU, fbLevL;
         tExpSmooth wlSmooth, pickPosSmooth, prepPosSmooth;
         float sampleRate;
+        float denormalOffset;
     } _tComplexLivingString;
     
     typedef _tComplexLivingString* tComplexLivingString;
@@ -699,6 +904,7 @@ extern "C" {
     void    tComplexLivingString_setLevStrength        (tComplexLivingString* const, float levStrength);
     void    tComplexLivingString_setLevMode            (tComplexLivingString* const, int levMode);
     void    tComplexLivingString_setSampleRate         (tComplexLivingString* const, float sr);
+    void    tComplexLivingString_tickBlock             (tComplexLivingString* const, const float* input, float* output, int size);
     
     // ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~
     
@@ -723,6 +929,10 @@ extern "C" {
      @brief Free a tReedTable from its mempool.
      @param reed A pointer to the tReedTable to free.
      
+     @fn size_t  tReedTable_getRequiredSize (void)
+     @brief Get the bytes tReedTable_initToPool() allocates from a first-fit mempool, as a constant expression that can size static memory.
+     @return The size in bytes.
+     
      @fn float   tReedTable_tick         (tReedTable* const, float input)
      @brief
      @param reed A pointer to the relevant tReedTable.
@@ -753,6 +963,7 @@ extern "C" {
     void    tReedTable_init         (tReedTable* const, float offset, float slope, LEAF* const leaf);
     void    tReedTable_initToPool   (tReedTable* const, float offset, float slope, tMempool* const);
     void    tReedTable_free         (tReedTable* const);
+#define tReedTable_getRequiredSize() LEAF_MEMPOOL_BLOCK_SIZE(sizeof(_tReedTable))
     
     float   tReedTable_tick         (tReedTable* const, float input);
     float   tReedTable_tanh_tick    (tReedTable* const, float input); //tanh softclip version of reed table - replacing the hard clip in original stk code
@@ -760,7 +971,7 @@ extern "C" {
     void    tReedTable_setSlope     (tReedTable* const, float slope);
     
     //==============================================================================
-    
+
 #ifdef __cplusplus
 }
 #endif
@@ -182,6 +182,7 @@ extern "C" {
      @defgroup tdattorroreverb tDattorroReverb
      @ingroup reverb
      @brief Dattorro plate reverb.
+     @details The delay lines of the reverb are all kept in one contiguous block of memory allocated from its mempool, and tick, tickStereo and the block functions all run the same loop over them.
      @{
      
      @fn void    tDattorroReverb_init              (tDattorroReverb* const, LEAF* const leaf)
@@ -210,6 +211,37 @@ extern "C" {
      @brief
      @param reverb A pointer to the relevant tDattorroReverb.
      
+     @fn void    tDattorroReverb_tickBlock         (tDattorroReverb* const, const float* input, float* output, int size)
+     @brief Process a block of samples, with the same output as calling tDattorroReverb_tick() for each of them.
+     @param reverb A pointer to the relevant tDattorroReverb.
+     @param input The input block.
+     @param output The output block, which may be the same as input.
+     @param size The number of samples in the block.
+     
+     @fn void    tDattorroReverb_tickStereoBlock   (tDattorroReverb* const, const float* input, float** outputs, int size)
+     @brief Process a block of samples, with the same output as calling tDattorroReverb_tickStereo() for each of them.
+     @param reverb A pointer to the relevant tDattorroReverb.
+     @param input The input block.
+     @param outputs The left and right output blocks. The left block may be the same as input.
+     @param size The number of samples in the block.
+     
+     @fn void    tDattorroReverb_tickView          (tDattorroReverb* const, LEAFBufferView input, LEAFBufferView output)
+     @brief Process channel 0 of a buffer view, such as an interleaved DMA buffer, in place or into another view. A view with two or more channels gets the output of tDattorroReverb_tickStereoBlock() in channels 0 and 1, and a one channel view gets the output of tDattorroReverb_tickBlock().
+     @param reverb A pointer to the relevant tDattorroReverb.
+     @param input The input view. All of its frames are processed.
+     @param output The output view, with at least as many frames. May be the same as input.
+     
+     @fn void    tDattorroReverb_setQuiescence (tDattorroReverb* const, float threshold, int holdSamples)
+     @brief Let the reverb sleep once its tail has died away. After the input and output have stayed under the threshold for holdSamples, each block writes zeros and skips the tank, until the input goes over the threshold again. Never sleeps while frozen.
+     @param reverb A pointer to the relevant tDattorroReverb.
+     @param threshold The absolute level under which the reverb counts as silent, such as 0.0001 for -80 dB, or 0 to always process. Off by default.
+     @param holdSamples How long it must be quiet first. This should be at least the input delay plus one trip around the tank, which is about 0.7 seconds at size 1 and twice that at the largest size.
+     
+     @fn int     tDattorroReverb_isQuiescent   (tDattorroReverb* const)
+     @brief Check whether the reverb is sleeping.
+     @param reverb A pointer to the relevant tDattorroReverb.
+     @return 1 if blocks with a quiet input are skipped, otherwise 0.
+     
      @fn void    tDattorroReverb_setMix            (tDattorroReverb* const, float mix)
      @brief
      @param reverb A pointer to the relevant tDattorroReverb.
@@ -244,6 +276,27 @@ extern "C" {
      
      @} */
     
+    // Delay lines of tDattorroReverb, which work as tTapeDelay and a tAllpass on a tLinearDelay do
+    typedef struct _tDattorroTape
+    {
+        float* buff;
+        uint32_t maxDelay;
+        uint32_t inPoint;
+        float delay, idx;
+    } _tDattorroTape;
+    
+    typedef struct _tDattorroAllpass
+    {
+        float* buff;
+        uint32_t maxDelay;
+        uint32_t inPoint, outPoint;
+        float delay, alpha, omAlpha;
+        float gain;
+        float lastOut;
+    } _tDattorroAllpass;
+
+#define DATTORRO_BLOCK 64
+
     typedef struct _tDattorroReverb
     {
         
@@ -265,30 +318,36 @@ extern "C" {
         float   f1_last,
         f2_last;
         
+        // Memory for all the delay lines below
+        char* arena;
+        
         // INPUT
-        tTapeDelay  in_delay;
-        tOnePole    in_filter;
-        tAllpass    in_allpass[4];
+        _tDattorroTape      in_delay;
+        tOnePole            in_filter;
+        _tDattorroAllpass   in_allpass[4];
         
         // FEEDBACK 1
-        tAllpass    f1_allpass;
-        tTapeDelay  f1_delay_1;
-        tOnePole    f1_filter;
-        tTapeDelay  f1_delay_2;
-        tTapeDelay  f1_delay_3;
-        tHighpass   f1_hp;
+        _tDattorroAllpass   f1_allpass;
+        _tDattorroTape      f1_delay_1;
+        tOnePole            f1_filter;
+        _tDattorroTape      f1_delay_2;
+        _tDattorroTape      f1_delay_3;
+        tHighpass           f1_hp;
         
         tCycle      f1_lfo;
         
         // FEEDBACK 2
-        tAllpass    f2_allpass;
-        tTapeDelay  f2_delay_1;
-        tOnePole    f2_filter;
-        tTapeDelay  f2_delay_2;
-        tTapeDelay  f2_delay_3;
-        tHighpass   f2_hp;
+        _tDattorroAllpass   f2_allpass;
+        _tDattorroTape      f2_delay_1;
+        tOnePole            f2_filter;
+        _tDattorroTape      f2_delay_2;
+        _tDattorroTape      f2_delay_3;
+        tHighpass           f2_hp;
         
         tCycle      f2_lfo;
+        
+        float       denormalOffset;
+        LEAFQuiescence quiet;
     } _tDattorroReverb;
     
     typedef _tDattorroReverb* tDattorroReverb;
@@ -300,6 +359,11 @@ extern "C" {
     void    tDattorroReverb_clear             (tDattorroReverb* const);
     float   tDattorroReverb_tick              (tDattorroReverb* const, float input);
     void    tDattorroReverb_tickStereo        (tDattorroReverb* const rev, float input, float* output);
+    void    tDattorroReverb_tickBlock         (tDattorroReverb* const, const float* input, float* output, int size);
+    void    tDattorroReverb_tickStereoBlock   (tDattorroReverb* const, const float* input, float** outputs, int size);
+    void    tDattorroReverb_tickView          (tDattorroReverb* const, LEAFBufferView input, LEAFBufferView output);
+    void    tDattorroReverb_setQuiescence (tDattorroReverb* const, float threshold, int holdSamples);
+    int     tDattorroReverb_isQuiescent   (tDattorroReverb* const);
     void    tDattorroReverb_setMix            (tDattorroReverb* const, float mix);
     void    tDattorroReverb_setFreeze         (tDattorroReverb* const rev, int freeze);
     void    tDattorroReverb_setHP             (tDattorroReverb* const, float freq);
@@ -310,6 +374,162 @@ extern "C" {
     void    tDattorroReverb_setFeedbackGain   (tDattorroReverb* const, float gain);
     void    tDattorroReverb_setSampleRate     (tDattorroReverb* const, float sr);
     
+    //==============================================================================
+    
+    /*!
+     @defgroup tfdnreverb tFDNReverb
+     @ingroup reverb
+     @brief Feedback delay network reverb with 4, 8 or 16 lines.
+     @details Each line has its own one-pole damping filter and a gain set from the decay time, and the lines are mixed through a Hadamard or Householder matrix. Samples are worked on in blocks of up to FDN_BLOCK, which no line is shorter than, so the mixing runs as vector operations across each block. Fewer lines use less memory and time and give a sparser tail; the API is the same for any count.
+     @{
+     
+     @fn void    tFDNReverb_init              (tFDNReverb* const, int numLines, LEAF* const leaf)
+     @brief Initialize a tFDNReverb to the default mempool of a LEAF instance.
+     @param reverb A pointer to the tFDNReverb to initialize.
+     @param numLines The number of delay lines, rounded up to 4, 8 or 16.
+     @param leaf A pointer to the leaf instance.
+     
+     @fn void    tFDNReverb_initToPool        (tFDNReverb* const, int numLines, tMempool* const)
+     @brief Initialize a tFDNReverb to a specified mempool.
+     @param reverb A pointer to the tFDNReverb to initialize.
+     @param numLines The number of delay lines, rounded up to 4, 8 or 16.
+     @param mempool A pointer to the tMempool to use.
+     
+     @fn void    tFDNReverb_free              (tFDNReverb* const)
+     @brief Free a tFDNReverb from its mempool.
+     @param reverb A pointer to the tFDNReverb to free.
+     
+     @fn void    tFDNReverb_clear             (tFDNReverb* const)
+     @brief Clear the delay lines and damping filters.
+     @param reverb A pointer to the relevant tFDNReverb.
+     
+     @fn float   tFDNReverb_tick              (tFDNReverb* const, float input)
+     @brief Process one sample to a mono output.
+     @param reverb A pointer to the relevant tFDNReverb.
+     @param input The input sample.
+     @return The output sample.
+     
+     @fn void    tFDNReverb_tickStereo        (tFDNReverb* const, float input, float* output)
+     @brief Process one sample to a stereo output.
+     @param reverb A pointer to the relevant tFDNReverb.
+     @param input The input sample.
+     @param output An array of two floats for the left and right outputs.
+     
+     @fn void    tFDNReverb_tickBlock         (tFDNReverb* const, const float* input, float* output, int size)
+     @brief Process a block of samples, with the same output as calling tFDNReverb_tick() for each of them.
+     @param reverb A pointer to the relevant tFDNReverb.
+     @param input The input block.
+     @param output The output block, which may be the same as input.
+     @param size The number of samples in the block.
+     
+     @fn void    tFDNReverb_tickStereoBlock   (tFDNReverb* const, const float* input, float** outputs, int size)
+     @brief Process a block of samples, with the same output as calling tFDNReverb_tickStereo() for each of them.
+     @param reverb A pointer to the relevant tFDNReverb.
+     @param input The input block.
+     @param outputs The left and right output blocks. The left block may be the same as input.
+     @param size The number of samples in the block.
+     
+     @fn void    tFDNReverb_tickView          (tFDNReverb* const, LEAFBufferView input, LEAFBufferView output)
+     @brief Process channel 0 of a buffer view, such as an interleaved DMA buffer, in place or into another view. A view with two or more channels gets the output of tFDNReverb_tickStereoBlock() in channels 0 and 1, and a one channel view gets the output of tFDNReverb_tickBlock().
+     @param reverb A pointer to the relevant tFDNReverb.
+     @param input The input view. All of its frames are processed.
+     @param output The output view, with at least as many frames. May be the same as input.
+     
+     @fn void    tFDNReverb_setMatrix         (tFDNReverb* const, FDNMatrix matrix)
+     @brief Set the feedback matrix. FDNHadamard mixes every line equally into every other and gives the densest tail; FDNHouseholder is cheaper and keeps more of each line in itself.
+     @param reverb A pointer to the relevant tFDNReverb.
+     @param matrix FDNHadamard or FDNHouseholder.
+     
+     @fn void    tFDNReverb_setT60            (tFDNReverb* const, float t60)
+     @brief Set the time in seconds for the tail to decay by 60 dB at low frequencies.
+     @param reverb A pointer to the relevant tFDNReverb.
+     @param t60 The decay time, from 0.1 to 100 seconds.
+     
+     @fn void    tFDNReverb_setSize           (tFDNReverb* const, float size)
+     @brief Set the size of the room by scaling all the delay lengths.
+     @param reverb A pointer to the relevant tFDNReverb.
+     @param size The size from 0.1 to 1.0. Defaults to 1.0.
+     
+     @fn void    tFDNReverb_setDamping        (tFDNReverb* const, float freq)
+     @brief Set the cutoff of the damping filters in the feedback path.
+     @param reverb A pointer to the relevant tFDNReverb.
+     @param freq The cutoff frequency in Hz.
+     
+     @fn void    tFDNReverb_setQuiescence (tFDNReverb* const, float threshold, int holdSamples)
+     @brief Let the reverb sleep once its tail has died away. After the input and output have stayed under the threshold for holdSamples, each block writes zeros and skips the lines, until the input goes over the threshold again.
+     @param reverb A pointer to the relevant tFDNReverb.
+     @param threshold The absolute level under which the reverb counts as silent, such as 0.0001 for -80 dB, or 0 to always process. Off by default.
+     @param holdSamples How long it must be quiet first. This should be at least the longest line, which is under 0.1 seconds at full size.
+     
+     @fn int     tFDNReverb_isQuiescent   (tFDNReverb* const)
+     @brief Check whether the reverb is sleeping.
+     @param reverb A pointer to the relevant tFDNReverb.
+     @return 1 if blocks with a quiet input are skipped, otherwise 0.
+     
+     @fn void    tFDNReverb_setMix            (tFDNReverb* const, float mix)
+     @brief Set the dry/wet mix.
+     @param reverb A pointer to the relevant tFDNReverb.
+     @param mix The mix from 0.0 (dry) to 1.0 (wet).
+     
+     @} */
+    
+    typedef enum FDNMatrix
+    {
+        FDNHadamard = 0,
+        FDNHouseholder,
+        FDNMatrixNil
+    } FDNMatrix;
+
+#define FDN_MAX_LINES 16
+#define FDN_BLOCK 32
+
+    typedef struct _tFDNReverb
+    {
+        
+        tMempool mempool;
+        
+        float   sampleRate;
+        int     numLines;
+        FDNMatrix matrix;
+        
+        float   size, t60, damping, mix;
+        float   dampCoeff;
+        
+        // Memory for all the delay lines, each a power of two long
+        char* arena;
+        float* buff[FDN_MAX_LINES];
+        uint32_t mask[FDN_MAX_LINES];
+        uint32_t length[FDN_MAX_LINES];
+        uint32_t writePos;
+        
+        float   gain[FDN_MAX_LINES];
+        float   lp[FDN_MAX_LINES];
+        
+        float   denormalOffset;
+        LEAFQuiescence quiet;
+    } _tFDNReverb;
+    
+    typedef _tFDNReverb* tFDNReverb;
+    
+    void    tFDNReverb_init              (tFDNReverb* const, int numLines, LEAF* const leaf);
+    void    tFDNReverb_initToPool        (tFDNReverb* const, int numLines, tMempool* const);
+    void    tFDNReverb_free              (tFDNReverb* const);
+    
+    void    tFDNReverb_clear             (tFDNReverb* const);
+    float   tFDNReverb_tick              (tFDNReverb* const, float input);
+    void    tFDNReverb_tickStereo        (tFDNReverb* const, float input, float* output);
+    void    tFDNReverb_tickBlock         (tFDNReverb* const, const float* input, float* output, int size);
+    void    tFDNReverb_tickStereoBlock   (tFDNReverb* const, const float* input, float** outputs, int size);
+    void    tFDNReverb_tickView          (tFDNReverb* const, LEAFBufferView input, LEAFBufferView output);
+    void    tFDNReverb_setMatrix         (tFDNReverb* const, FDNMatrix matrix);
+    void    tFDNReverb_setT60            (tFDNReverb* const, float t60);
+    void    tFDNReverb_setSize           (tFDNReverb* const, float size);
+    void    tFDNReverb_setDamping        (tFDNReverb* const, float freq);
+    void    tFDNReverb_setQuiescence (tFDNReverb* const, float threshold, int holdSamples);
+    int     tFDNReverb_isQuiescent   (tFDNReverb* const);
+    void    tFDNReverb_setMix            (tFDNReverb* const, float mix);
+    void    tFDNReverb_setSampleRate     (tFDNReverb* const, float sr);
+
 #ifdef __cplusplus
 }
 #endif
@@ -52,6 +52,58 @@ extern "C" {
      @param length The length of the buffer in samples.
      @param mempool A pointer to the tMempool to use.
      
+     @fn void  tBuffer_initWithFormat        (tBuffer* const, uint32_t length, BufferFormat format, LEAF* const leaf)
+     @brief Initialize a tBuffer that stores its samples in a given format to the default mempool of a LEAF instance.
+     @details BufferInt16 stores each sample in 16 bits and BufferMuLaw in 8 bits (G.711 µ-law), halving or quartering the memory of a float buffer. Samples are converted when they're written and read, so everything else about the buffer, including playback with tSampler, tMBSampler and tSamplerPoly, works the same as in float.
+     @param sampler A pointer to the tBuffer to initialize.
+     @param length The length of the buffer in samples.
+     @param format The sample format, BufferFloat, BufferInt16 or BufferMuLaw.
+     @param leaf A pointer to the leaf instance.
+     
+     @fn void  tBuffer_initToPoolWithFormat  (tBuffer* const, uint32_t length, BufferFormat format, tMempool* const)
+     @brief Initialize a tBuffer that stores its samples in a given format to a specified mempool.
+     @param sampler A pointer to the tBuffer to initialize.
+     @param length The length of the buffer in samples.
+     @param format The sample format, BufferFloat, BufferInt16 or BufferMuLaw.
+     @param mempool A pointer to the tMempool to use.
+     
+     @fn void  tBuffer_initStreaming         (tBuffer* const, uint32_t length, uint32_t channels, uint32_t sampleRate, uint32_t residentLength, uint32_t chunkLength, uint32_t numChunks, tBufferReadCallback read, void* userData, LEAF* const leaf)
+     @brief Initialize a streaming tBuffer to the default mempool of a LEAF instance.
+     @details A streaming buffer keeps only its first residentLength frames in memory and serves the rest from numChunks chunks of chunkLength frames, which are refilled through the read callback by tBuffer_serviceStream(). A tSampler playing the buffer requests the chunks it will need next, so tSampler_tick() and tSampler_tickStereo() behave exactly as they do with an in-memory buffer as long as the service calls keep up. Reads of frames that haven't arrived yet return 0 and are counted as underruns. The resident frames and the first chunks are read during initialization. A streaming buffer can't be recorded into and should be played by one tSampler at a time.
+     @param sampler A pointer to the tBuffer to initialize.
+     @param length The total length of the sample in frames.
+     @param channels The number of interleaved channels, 1 or 2.
+     @param sampleRate The sample rate of the sample.
+     @param residentLength The number of frames from the start of the sample to keep in memory.
+     @param chunkLength The length of each streamed chunk in frames, rounded up to a power of two.
+     @param numChunks The number of chunks.
+     @param read The callback that reads numFrames interleaved frames starting at startFrame into dest and returns the number of frames read.
+     @param userData A pointer passed to the read callback.
+     @param leaf A pointer to the leaf instance.
+     
+     @fn void  tBuffer_initToPoolStreaming   (tBuffer* const, uint32_t length, uint32_t channels, uint32_t sampleRate, uint32_t residentLength, uint32_t chunkLength, uint32_t numChunks, tBufferReadCallback read, void* userData, tMempool* const)
+     @brief Initialize a streaming tBuffer to a specified mempool.
+     @param sampler A pointer to the tBuffer to initialize.
+     @param length The total length of the sample in frames.
+     @param channels The number of interleaved channels, 1 or 2.
+     @param sampleRate The sample rate of the sample.
+     @param residentLength The number of frames from the start of the sample to keep in memory.
+     @param chunkLength The length of each streamed chunk in frames, rounded up to a power of two.
+     @param numChunks The number of chunks.
+     @param read The callback that reads frames into dest.
+     @param userData A pointer passed to the read callback.
+     @param mempool A pointer to the tMempool to use.
+     
+     @fn int   tBuffer_serviceStream         (tBuffer* const)
+     @brief Read any chunks requested by the sampler playing a streaming buffer. Call this regularly from a thread other than the audio thread, or when a refill DMA completes. Only one thread may service a given buffer.
+     @param sampler A pointer to the relevant tBuffer.
+     @return The number of chunks read.
+     
+     @fn uint32_t tBuffer_getUnderruns       (tBuffer* const)
+     @brief Get the number of sample reads from a streaming buffer that found their chunk not yet loaded.
+     @param sampler A pointer to the relevant tBuffer.
+     @return The number of underrun reads since initialization.
+     
      @fn void  tBuffer_free                  (tBuffer* const)
      @brief Free a tBuffer from its mempool.
      @param sampler A pointer to the tBuffer to free.
@@ -61,12 +113,24 @@ extern "C" {
      @param sampler A pointer to the relevant tBuffer.
      @param input The input sample.
      
+     @fn void  tBuffer_tickBlock             (tBuffer* const, const float* input, int size)
+     @brief Add a block of samples to the buffer if recording, the same as calling tBuffer_tick() for each of them.
+     @param sampler A pointer to the relevant tBuffer.
+     @param input The input samples.
+     @param size The number of samples.
+     
      @fn void  tBuffer_read                  (tBuffer* const, float* buff, uint32_t len)
      @brief Read an input buffer into the buffer.
      @param sampler A pointer to the relevant tBuffer.
      @param inputBuffer The input buffer.
      @param length The length of the input buffer.
      
+     @fn void  tBuffer_readInt16             (tBuffer* const, const int16_t* buff, uint32_t len)
+     @brief Read a 16-bit input buffer into the buffer, converting it to the buffer's format.
+     @param sampler A pointer to the relevant tBuffer.
+     @param inputBuffer The input buffer.
+     @param length The length of the input buffer.
+     
      @fn float tBuffer_get                   (tBuffer* const, int idx)
      @brief Get the sample recorded at a given position in the buffer.
      @param sampler A pointer to the relevant tBuffer.
@@ -81,6 +145,19 @@ extern "C" {
      @brief Stop recordings samples into the buffer.
      @param sampler A pointer to the relevant tBuffer.
      
+     @fn void  tBuffer_setBufferInt16        (tBuffer* const, int16_t* externalBuffer, int length, int channels, int sampleRate)
+     @brief Play 16-bit samples from an external buffer in place, for example samples loaded into SDRAM or kept in flash. The buffer becomes a BufferInt16 buffer.
+     @param sampler A pointer to the relevant tBuffer.
+     @param externalBuffer The interleaved samples.
+     @param length The total number of samples in externalBuffer.
+     @param channels The number of channels.
+     @param sampleRate The sample rate of the samples.
+     
+     @fn BufferFormat tBuffer_getFormat      (tBuffer* const)
+     @brief Get the format the buffer stores its samples in.
+     @param sampler A pointer to the relevant tBuffer.
+     @return The sample format.
+     
      @fn int   tBuffer_getRecordPosition     (tBuffer* const)
      @brief Get the recording position, from where the buffer will next add samples.
      @param sampler A pointer to the relevant tBuffer.
@@ -129,12 +206,61 @@ extern "C" {
         RecordModeNil
     } RecordMode;
     
+    typedef enum BufferFormat
+    {
+        BufferFloat = 0,
+        BufferInt16,
+        BufferMuLaw,
+        BufferFormatNil
+    } BufferFormat;
+    
+    typedef uint32_t (*tBufferReadCallback)(void* userData, float* dest, uint32_t startFrame, uint32_t numFrames);
+    
+    typedef enum BufferChunkState
+    {
+        BufferChunkEmpty = 0,
+        BufferChunkRequested, // owned by the servicing thread until it's ready
+        BufferChunkReady
+    } BufferChunkState;
+    
+    typedef struct _tBufferChunk
+    {
+        volatile int32_t state;
+        int32_t chunk;
+        uint32_t order;
+        float* data;
+    } _tBufferChunk;
+    
+    typedef struct _tBufferStream
+    {
+        tBufferReadCallback read;
+        void* userData;
+        
+        uint32_t residentLength;
+        uint32_t chunkLength;
+        uint32_t chunkShift;
+        uint32_t chunkSamples; // chunkLength frames of interleaved channels
+        uint32_t numChunks;
+        
+        _tBufferChunk* chunks;
+        int32_t* wanted;
+        int lastChunk;
+        uint32_t requestOrder;
+        
+        volatile uint32_t underruns;
+    } _tBufferStream;
+    
     typedef struct _tBuffer
     {
         
         tMempool mempool;
         
+        BufferFormat format;
         float* buff;
+        int16_t* buff16;
+        uint8_t* buff8;
+        int ownsBuffer;
+        _tBufferStream* stream;
         
         uint32_t idx;
         uint32_t bufferLength;
@@ -150,14 +276,26 @@ extern "C" {
     
     void  tBuffer_init                  (tBuffer* const, uint32_t length, LEAF* const leaf);
     void  tBuffer_initToPool             (tBuffer* const sb, uint32_t length, tMempool* const mp);
+    void  tBuffer_initWithFormat        (tBuffer* const sb, uint32_t length, BufferFormat format, LEAF* const leaf);
+    void  tBuffer_initToPoolWithFormat  (tBuffer* const sb, uint32_t length, BufferFormat format, tMempool* const mp);
+    void  tBuffer_initStreaming         (tBuffer* const sb, uint32_t length, uint32_t channels, uint32_t sampleRate,
+                                         uint32_t residentLength, uint32_t chunkLength, uint32_t numChunks,
+                                         tBufferReadCallback read, void* userData, LEAF* const leaf);
+    void  tBuffer_initToPoolStreaming   (tBuffer* const sb, uint32_t length, uint32_t channels, uint32_t sampleRate,
+                                         uint32_t residentLength, uint32_t chunkLength, uint32_t numChunks,
+                                         tBufferReadCallback read, void* userData, tMempool* const mp);
     void  tBuffer_free                  (tBuffer* const);
     
     void  tBuffer_tick                  (tBuffer* const, float sample);
+    void  tBuffer_tickBlock             (tBuffer* const, const float* input, int size);
     void  tBuffer_read                  (tBuffer* const, float* buff, uint32_t len);
+    void  tBuffer_readInt16             (tBuffer* const, const int16_t* buff, uint32_t len);
     float tBuffer_get                   (tBuffer* const, int idx);
     void  tBuffer_record                (tBuffer* const);
     void  tBuffer_stop                  (tBuffer* const);
     void tBuffer_setBuffer                (tBuffer* const sb, float* externalBuffer, int length, int channels, int sampleRate);
+    void tBuffer_setBufferInt16           (tBuffer* const sb, int16_t* externalBuffer, int length, int channels, int sampleRate);
+    BufferFormat tBuffer_getFormat      (tBuffer* const sb);
     int   tBuffer_getRecordPosition     (tBuffer* const);
     void   tBuffer_setRecordPosition    (tBuffer* const, int pos);
     void  tBuffer_setRecordMode         (tBuffer* const, RecordMode mode);
@@ -166,6 +304,8 @@ extern "C" {
     uint32_t tBuffer_getRecordedLength  (tBuffer* const sb);
     void     tBuffer_setRecordedLength    (tBuffer* const sb, int length);
     int     tBuffer_isActive            (tBuffer* const sb);
+    int     tBuffer_serviceStream       (tBuffer* const sb);
+    uint32_t tBuffer_getUnderruns       (tBuffer* const sb);
     
     //==============================================================================
     
@@ -231,6 +371,13 @@ extern "C" {
      @brief
      @param sampler A pointer to the relevant tSampler.
      
+     @fn void    tSampler_setInterpolation   (tSampler* const, SamplerInterpolation interpolation, int taps)
+     @brief Choose how the sampler interpolates between samples.
+     @details SamplerHermite is the default 4-point interpolation. SamplerSinc uses a Blackman-windowed sinc with the given number of taps read from a precomputed polyphase table, which is allocated from the sampler's mempool. When the sample is played faster than its own rate, the kernel is widened by the rate, up to SAMPLER_SINC_MAX_STRETCH times, so transposing up doesn't alias. The cost per sample grows with the taps and, above the original pitch, with the rate.
+     @param sampler A pointer to the relevant tSampler.
+     @param interpolation SamplerHermite or SamplerSinc.
+     @param taps The number of taps for SamplerSinc, rounded up to a multiple of 4 between 4 and SAMPLER_SINC_MAX_TAPS. Ignored for SamplerHermite.
+     
      @} */
     
     typedef enum PlayMode
@@ -241,6 +388,17 @@ extern "C" {
         PlayModeNil
     } PlayMode;
     
+    typedef enum SamplerInterpolation
+    {
+        SamplerHermite = 0,
+        SamplerSinc,
+        SamplerInterpolationNil
+    } SamplerInterpolation;
+
+#define SAMPLER_SINC_PHASES 64
+#define SAMPLER_SINC_MAX_TAPS 64
+#define SAMPLER_SINC_MAX_STRETCH 4
+    
     typedef struct _tSampler
     {
         tMempool mempool;
@@ -278,6 +436,15 @@ extern "C" {
         
         float flipStart;
         float flipIdx;
+        
+        // Last position chunks were requested for, when playing a streaming tBuffer
+        int32_t streamChunk, streamState;
+        int32_t streamStart, streamEnd;
+        
+        // Polyphase table for SamplerSinc, SAMPLER_SINC_PHASES + 1 rows of sincTaps coefficients
+        SamplerInterpolation interpolation;
+        int sincTaps;
+        float* sincTable;
     } _tSampler;
     
     typedef _tSampler* tSampler;
@@ -298,6 +465,7 @@ extern "C" {
     void    tSampler_setCrossfadeLength (tSampler* const, uint32_t length);
     void    tSampler_setRate            (tSampler* const, float rate);
     void    tSampler_setSampleRate      (tSampler* const, float sr);
+    void    tSampler_setInterpolation   (tSampler* const, SamplerInterpolation interpolation, int taps);
     
     //==============================================================================
     
@@ -325,6 +493,20 @@ extern "C" {
      @brief
      @param sampler A pointer to the relevant tAutoSampler.
      
+     @fn void    tAutoSampler_tickBlock          (tAutoSampler* const, const float* input, float* output, int size)
+     @brief Process a block, the same as calling tAutoSampler_tick() for each sample except that the sampler can play back samples recorded later in the same block.
+     @details While waiting for a trigger the block is checked for a peak that could cross the threshold in one vectorized pass, and when there isn't one the envelope's decay over the block is applied at once. Recording copies whole runs of the block into the buffer.
+     @param sampler A pointer to the relevant tAutoSampler.
+     @param input The input block.
+     @param output The output block, which may be the same as input.
+     @param size The number of samples in the block.
+     
+     @fn void    tAutoSampler_setPreRoll         (tAutoSampler* const, uint32_t length)
+     @brief Keep the last length input samples so that a recording starts with the audio just before it was triggered.
+     @details The samples are kept in a circular buffer allocated from the autosampler's mempool. A length of 0 frees it. The pre-roll is limited to half the length of the tBuffer.
+     @param sampler A pointer to the relevant tAutoSampler.
+     @param length The number of samples to keep.
+     
      @fn void    tAutoSampler_setBuffer          (tAutoSampler* const, tBuffer* const)
      @brief
      @param sampler A pointer to the relevant tAutoSampler.
@@ -371,6 +553,15 @@ extern "C" {
         uint32_t sampleCounter;
         uint32_t powerCounter;
         uint8_t sampleTriggered;
+        
+        // Circular buffer of the most recent input, copied to the start of each recording
+        float* preRollBuffer;
+        uint32_t preRollLength;
+        uint32_t preRollIdx;
+        
+        // Envelope decay over a block, for the last block size seen by tAutoSampler_tickBlock
+        float blockDecay;
+        int blockDecaySize;
     } _tAutoSampler;
     
     typedef _tAutoSampler* tAutoSampler;
@@ -380,6 +571,8 @@ extern "C" {
     void    tAutoSampler_free               (tAutoSampler* const);
     
     float   tAutoSampler_tick               (tAutoSampler* const, float input);
+    void    tAutoSampler_tickBlock          (tAutoSampler* const, const float* input, float* output, int size);
+    void    tAutoSampler_setPreRoll         (tAutoSampler* const, uint32_t length);
     void    tAutoSampler_setBuffer          (tAutoSampler* const, tBuffer* const);
     void    tAutoSampler_setMode            (tAutoSampler* const, PlayMode mode);
     void    tAutoSampler_play               (tAutoSampler* const);
@@ -495,6 +688,182 @@ extern "C" {
     void    tMBSampler_setLength          (tMBSampler* const, int32_t length);
     void    tMBSampler_setRate            (tMBSampler* const, float rate);
     
+    //==============================================================================
+    
+    /*!
+     @defgroup tsamplerpoly tSamplerPoly
+     @ingroup sampling
+     @brief Polyphonic sampler with a fixed pool of voices sharing one tBuffer.
+     @details Voices share the sample's start, end, play mode and crossfade, and each has its own rate and gain. tSamplerPoly_tickBlock() renders every active voice into a block, working out positions, loop crossfades and envelopes for a run of samples before interpolating them all at once, and reads both channels of a stereo buffer from one set of positions. When every voice is busy a new note takes over the oldest or the quietest voice, and what that voice was playing fades out over a few milliseconds under the new note instead of being cut off. The buffer must be in memory; a streaming buffer reports LEAFInvalidBuffer and the sampler stays silent.
+     @{
+     
+     @fn void    tSamplerPoly_init               (tSamplerPoly* const, tBuffer* const, int numVoices, LEAF* const leaf)
+     @brief Initialize a tSamplerPoly to the default mempool of a LEAF instance.
+     @param sampler A pointer to the tSamplerPoly to initialize.
+     @param buffer A pointer to the tBuffer to play. Mono and stereo buffers are supported.
+     @param numVoices The number of voices.
+     @param leaf A pointer to the leaf instance.
+     
+     @fn void    tSamplerPoly_initToPool         (tSamplerPoly* const, tBuffer* const, int numVoices, tMempool* const)
+     @brief Initialize a tSamplerPoly to a specified mempool.
+     @param sampler A pointer to the tSamplerPoly to initialize.
+     @param buffer A pointer to the tBuffer to play.
+     @param numVoices The number of voices.
+     @param mempool A pointer to the tMempool to use.
+     
+     @fn void    tSamplerPoly_free               (tSamplerPoly* const)
+     @brief Free a tSamplerPoly from its mempool.
+     @param sampler A pointer to the tSamplerPoly to free.
+     
+     @fn void    tSamplerPoly_tickBlock          (tSamplerPoly* const, float** outputs, int size)
+     @brief Render all active voices, overwriting the output block.
+     @param sampler A pointer to the relevant tSamplerPoly.
+     @param outputs One output array per channel of the buffer.
+     @param size The number of samples to render.
+     
+     @fn int     tSamplerPoly_noteOn             (tSamplerPoly* const, int note, float rate, float gain)
+     @brief Start a voice, stealing one if all are busy.
+     @param sampler A pointer to the relevant tSamplerPoly.
+     @param note An identifier for the voice, used by tSamplerPoly_noteOff().
+     @param rate The playback rate, where 1 is the original pitch and negative rates play backwards.
+     @param gain The gain of the voice.
+     @return The voice that was started.
+     
+     @fn void    tSamplerPoly_noteOff            (tSamplerPoly* const, int note)
+     @brief Fade out every voice playing a note.
+     @param sampler A pointer to the relevant tSamplerPoly.
+     @param note The identifier passed to tSamplerPoly_noteOn().
+     
+     @fn void    tSamplerPoly_allNotesOff        (tSamplerPoly* const)
+     @brief Fade out every voice.
+     @param sampler A pointer to the relevant tSamplerPoly.
+     
+     @fn void    tSamplerPoly_setVoiceRate       (tSamplerPoly* const, int voice, float rate)
+     @brief Set the playback rate of a playing voice, for example for pitch bend.
+     @param sampler A pointer to the relevant tSamplerPoly.
+     @param voice The voice returned by tSamplerPoly_noteOn().
+     @param rate The playback rate.
+     
+     @fn void    tSamplerPoly_setVoiceGain       (tSamplerPoly* const, int voice, float gain)
+     @brief Set the gain of a playing voice.
+     @param sampler A pointer to the relevant tSamplerPoly.
+     @param voice The voice returned by tSamplerPoly_noteOn().
+     @param gain The gain.
+     
+     @fn void    tSamplerPoly_setStealMode       (tSamplerPoly* const, SamplerStealMode mode)
+     @brief Set which voice a note takes over when every voice is busy.
+     @param sampler A pointer to the relevant tSamplerPoly.
+     @param mode StealOldest takes the voice that started longest ago, StealQuietest the one with the lowest recent output level.
+     
+     @fn int     tSamplerPoly_getNumActiveVoices (tSamplerPoly* const)
+     @brief Get the number of voices that are playing or fading out.
+     @param sampler A pointer to the relevant tSamplerPoly.
+     @return The number of active voices.
+     
+     @fn void    tSamplerPoly_setSample          (tSamplerPoly* const, tBuffer* const)
+     @brief Change the sample. Stops all voices and resets start and end to the whole buffer.
+     @param sampler A pointer to the relevant tSamplerPoly.
+     @param buffer A pointer to the new tBuffer.
+     
+     @fn void    tSamplerPoly_setMode            (tSamplerPoly* const, PlayMode mode)
+     @brief Set the play mode of all voices.
+     @param sampler A pointer to the relevant tSamplerPoly.
+     @param mode PlayNormal, PlayLoop or PlayBackAndForth.
+     
+     @fn void    tSamplerPoly_setStart           (tSamplerPoly* const, int32_t start)
+     @brief Set the start point in frames. Voices play from start towards end, so a start after the end plays backwards.
+     @param sampler A pointer to the relevant tSamplerPoly.
+     @param start The start point.
+     
+     @fn void    tSamplerPoly_setEnd             (tSamplerPoly* const, int32_t end)
+     @brief Set the end point in frames.
+     @param sampler A pointer to the relevant tSamplerPoly.
+     @param end The end point.
+     
+     @fn void    tSamplerPoly_setCrossfadeLength (tSamplerPoly* const, uint32_t length)
+     @brief Set the loop crossfade length in frames. Limited to a quarter of the loop and to the material available outside it.
+     @param sampler A pointer to the relevant tSamplerPoly.
+     @param length The crossfade length.
+     
+     @fn void    tSamplerPoly_setSampleRate      (tSamplerPoly* const, float sr)
+     @brief Set the output sample rate.
+     @param sampler A pointer to the relevant tSamplerPoly.
+     @param sr The sample rate.
+     
+     @} */
+    
+    typedef enum SamplerStealMode
+    {
+        StealOldest = 0,
+        StealQuietest,
+        SamplerStealModeNil
+    } SamplerStealMode;
+
+#define SAMPLERPOLY_RUN 32
+
+    typedef struct _tSamplerPolyVoice
+    {
+        int note;
+        int state; // 0 free, 1 playing, 2 fading out
+        float pos;
+        float inc;
+        float rate;
+        int bnf;
+        float gain;
+        float env;
+        float envInc;
+        float level;
+        uint32_t age;
+    } _tSamplerPolyVoice;
+    
+    typedef struct _tSamplerPoly
+    {
+        tMempool mempool;
+        
+        tBuffer samp;
+        
+        int numVoices;
+        _tSamplerPolyVoice* voices;
+        _tSamplerPolyVoice* tails; // what each voice was playing when it was last stolen, fading out
+        uint32_t age;
+        SamplerStealMode stealMode;
+        
+        float sampleRate;
+        float rateFactor;
+        float fadeInc;
+        float fadeTicks;
+        
+        PlayMode mode;
+        int32_t start, end;
+        uint32_t cfxlen;
+        
+        // One run of gathered interpolation points, per channel
+        float x[2][4][SAMPLERPOLY_RUN];
+        float alpha[SAMPLERPOLY_RUN];
+        float amp[SAMPLERPOLY_RUN];
+    } _tSamplerPoly;
+    
+    typedef _tSamplerPoly* tSamplerPoly;
+    
+    void    tSamplerPoly_init               (tSamplerPoly* const, tBuffer* const, int numVoices, LEAF* const leaf);
+    void    tSamplerPoly_initToPool         (tSamplerPoly* const, tBuffer* const, int numVoices, tMempool* const);
+    void    tSamplerPoly_free               (tSamplerPoly* const);
+    
+    void    tSamplerPoly_tickBlock          (tSamplerPoly* const, float** outputs, int size);
+    int     tSamplerPoly_noteOn             (tSamplerPoly* const, int note, float rate, float gain);
+    void    tSamplerPoly_noteOff            (tSamplerPoly* const, int note);
+    void    tSamplerPoly_allNotesOff        (tSamplerPoly* const);
+    void    tSamplerPoly_setVoiceRate       (tSamplerPoly* const, int voice, float rate);
+    void    tSamplerPoly_setVoiceGain       (tSamplerPoly* const, int voice, float gain);
+    void    tSamplerPoly_setStealMode       (tSamplerPoly* const, SamplerStealMode mode);
+    int     tSamplerPoly_getNumActiveVoices (tSamplerPoly* const);
+    void    tSamplerPoly_setSample          (tSamplerPoly* const, tBuffer* const);
+    void    tSamplerPoly_setMode            (tSamplerPoly* const, PlayMode mode);
+    void    tSamplerPoly_setStart           (tSamplerPoly* const, int32_t start);
+    void    tSamplerPoly_setEnd             (tSamplerPoly* const, int32_t end);
+    void    tSamplerPoly_setCrossfadeLength (tSamplerPoly* const, uint32_t length);
+    void    tSamplerPoly_setSampleRate      (tSamplerPoly* const, float sr);
+
 #ifdef __cplusplus
 }
 #endif
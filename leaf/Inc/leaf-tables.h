@@ -64,11 +64,12 @@ extern "C" {
 #define MTOF1_TABLE_SIZE 4096
     extern const float __leaf_table_mtof1[MTOF1_TABLE_SIZE];
 
-#define EXP_DECAY_TABLE_SIZE 65536
-    extern const float __leaf_table_exp_decay[EXP_DECAY_TABLE_SIZE];
-    
+#define EXP_DECAY_TABLE_SIZE LEAF_EXP_DECAY_TABLE_SIZE
 #define ATTACK_DECAY_INC_TABLE_SIZE 65536
+#if !LEAF_GENERATE_TABLES
+    extern const float __leaf_table_exp_decay[EXP_DECAY_TABLE_SIZE];
     extern const float __leaf_table_attack_decay_inc[ATTACK_DECAY_INC_TABLE_SIZE];
+#endif
     
 #define FILTERTAN_TABLE_SIZE 4096
     extern const float __leaf_table_filtertan[FILTERTAN_TABLE_SIZE];
@@ -79,8 +80,10 @@ extern "C" {
     //==============================================================================
     
     /* Sine wave table ripped from http://aquaticus.info/pwm-sine-wave. */
-#define SINE_TABLE_SIZE 2048
+#define SINE_TABLE_SIZE LEAF_SINE_TABLE_SIZE
+#if !LEAF_GENERATE_TABLES
     extern const float __leaf_table_sinewave[SINE_TABLE_SIZE];
+#endif
     
 #define TRI_TABLE_SIZE 2048
     extern const float __leaf_table_triangle[11][TRI_TABLE_SIZE];
@@ -116,6 +119,49 @@ extern "C" {
     extern const float_value_delta step_dd_table[];
     extern const float             slope_dd_table[];
     
+    //==============================================================================
+    
+    /* Sine and envelope table access. These are specialized at compile time by the table
+     options in leaf-config.h, so objects read the same way whether the tables are the
+     precomputed ones above or were built by LEAF_init(). */
+
+#if !LEAF_GENERATE_TABLES && (LEAF_SINE_TABLE_SIZE != 2048 || LEAF_EXP_DECAY_TABLE_SIZE != 65536 || LEAF_TABLE_PRECISION != LEAF_TABLE_FLOAT32)
+#error "Non-default table sizes or precision require LEAF_GENERATE_TABLES"
+#endif
+
+#if (LEAF_SINE_TABLE_SIZE & (LEAF_SINE_TABLE_SIZE - 1)) || (LEAF_EXP_DECAY_TABLE_SIZE & (LEAF_EXP_DECAY_TABLE_SIZE - 1)) || LEAF_EXP_DECAY_TABLE_SIZE > 65536
+#error "LEAF_SINE_TABLE_SIZE and LEAF_EXP_DECAY_TABLE_SIZE must be powers of two, and LEAF_EXP_DECAY_TABLE_SIZE at most 65536"
+#endif
+
+    //! Reads entry index of a sine or envelope table as a float.
+#if LEAF_TABLE_PRECISION == LEAF_TABLE_Q15
+#define LEAF_TABLE_READ(table, index) ((float) (table)[index] * (1.0f / 32767.0f))
+#else
+#define LEAF_TABLE_READ(table, index) ((table)[index])
+#endif
+
+    //! Maps a 16-bit envelope phase onto the exponential decay table.
+#define LEAF_EXP_DECAY_INDEX(phase) (((uint32_t) (phase) * EXP_DECAY_TABLE_SIZE) >> 16)
+
+#if LEAF_GENERATE_TABLES
+#define LEAF_getSineTable(leaf) ((const leaf_table_t*) (leaf)->sineTable)
+#define LEAF_getExpDecayTable(leaf) ((const leaf_table_t*) (leaf)->expDecayTable)
+    // The increment table is just 32768 / (3 * index), so it's computed rather than stored
+#define LEAF_ATTACK_DECAY_INC(index) ((index) == 0 ? 18000.0f : 32768.0f / (3.0f * (float) (index)))
+#else
+#define LEAF_getSineTable(leaf) ((const leaf_table_t*) __leaf_table_sinewave)
+#define LEAF_getExpDecayTable(leaf) ((const leaf_table_t*) __leaf_table_exp_decay)
+#define LEAF_ATTACK_DECAY_INC(index) (__leaf_table_attack_decay_inc[index])
+#endif
+
+    /*!
+     @brief Builds the sine and exponential decay tables into the default mempool at the size and precision set in leaf-config.h. Called by LEAF_init() when LEAF_GENERATE_TABLES is on.
+     @param leaf A pointer to the leaf instance.
+     */
+#if LEAF_GENERATE_TABLES
+    void LEAF_generateTables(LEAF* const leaf);
+#endif
+
     /*! @} */
     
     //==============================================================================
@@ -22,6 +22,16 @@
 #include "../../TestPlugin/JuceLibraryCode/JuceHeader.h"
 #endif
 
+#if LEAF_USE_SIMD
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define LEAF_SIMD_NEON 1
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define LEAF_SIMD_SSE2 1
+#endif
+#endif
+
 //===========================================================================
 /* Envelope Follower */
 //===========================================================================
@@ -33,6 +43,7 @@ void    tEnvelopeFollower_init(tEnvelopeFollower* const ef, float attackThreshol
 
 void    tEnvelopeFollower_initToPool    (tEnvelopeFollower* const ef, float attackThreshold, float decayCoeff, tMempool* const mp)
 {
+    LEAF_PROFILE_POOL(mp);
     _tMempool* m = *mp;
     _tEnvelopeFollower* e = *ef = (_tEnvelopeFollower*) mpool_alloc(sizeof(_tEnvelopeFollower), m);
     e->mempool = m;
@@ -51,6 +62,7 @@ void    tEnvelopeFollower_free  (tEnvelopeFollower* const ef)
 
 float   tEnvelopeFollower_tick(tEnvelopeFollower* const ef, float x)
 {
+    LEAF_PROFILE_OBJECT(ef);
     _tEnvelopeFollower* e = *ef;
     
     if (x < 0.0f ) x = -x;  /* Absolute value. */
@@ -62,8 +74,7 @@ float   tEnvelopeFollower_tick(tEnvelopeFollower* const ef, float x)
     //ef->y = envelope_pow[(uint16_t)(ef->y * (float)UINT16_MAX)] * ef->d_coeff; //not quite the right behavior - too much loss of precision?
     //ef->y = powf(ef->y, 1.000009f) * ef->d_coeff;  // too expensive
     
-#ifdef NO_DENORMAL_CHECK
-#else
+#if LEAF_DENORMAL_CHECK
     if( e->y < VSF)   e->y = 0.0f;
 #endif
     return e->y;
@@ -94,6 +105,7 @@ void    tZeroCrossingCounter_init         (tZeroCrossingCounter* const zc, int m
 
 void    tZeroCrossingCounter_initToPool   (tZeroCrossingCounter* const zc, int maxWindowSize, tMempool* const mp)
 {
+    LEAF_PROFILE_POOL(mp);
     _tMempool* m = *mp;
     _tZeroCrossingCounter* z = *zc = (_tZeroCrossingCounter*) mpool_alloc(sizeof(_tZeroCrossingCounter), m);
     z->mempool = m;
@@ -120,6 +132,7 @@ void    tZeroCrossingCounter_free (tZeroCrossingCounter* const zc)
 //returns proportion of zero crossings within window size (0.0 would be none in window, 1.0 would be all zero crossings)
 float   tZeroCrossingCounter_tick         (tZeroCrossingCounter* const zc, float input)
 {
+    LEAF_PROFILE_OBJECT(zc);
     _tZeroCrossingCounter* z = *zc;
     
     z->inBuffer[z->position] = input;
@@ -185,6 +198,7 @@ void    tPowerFollower_init(tPowerFollower* const pf, float factor, LEAF* const
 
 void    tPowerFollower_initToPool   (tPowerFollower* const pf, float factor, tMempool* const mp)
 {
+    LEAF_PROFILE_POOL(mp);
     _tMempool* m = *mp;
     _tPowerFollower* p = *pf = (_tPowerFollower*) mpool_alloc(sizeof(_tPowerFollower), m);
     p->mempool = m;
@@ -213,6 +227,7 @@ void tPowerFollower_setFactor(tPowerFollower* const pf, float factor)
 
 float tPowerFollower_tick(tPowerFollower* const pf, float input)
 {
+    LEAF_PROFILE_OBJECT(pf);
     _tPowerFollower* p = *pf;
     p->curr = p->factor*input*input+p->oneminusfactor*p->curr;
     return p->curr;
@@ -224,6 +239,371 @@ float tPowerFollower_getPower(tPowerFollower* const pf)
     return p->curr;
 }
 
+//===========================================================================
+/* Follower banks */
+//===========================================================================
+
+// The banks run four followers side by side per SIMD vector. The kernels step every group of four
+// channels one frame at a time so the groups' dependency chains overlap, reading group g of frame t
+// from x[t * stride + g * 4]. Whole groups of interleaved input are read in place, anything else is
+// first gathered into the bank's scratch buffer.
+#define FOLLOWER_BANK_FRAMES 64
+
+typedef void (*followerBankKernel)(void* bank, int firstGroup, int numGroups, const float* x, int stride, int n);
+
+static void followerBank_gather(const float* interleaved, const float* const* planar, int numChannels,
+                                int channel, int start, int n, float* x, int stride)
+{
+    for (int c = channel; c < ((numChannels + 3) & ~3); c++)
+    {
+        float* out = x + (c - channel);
+        if (c >= numChannels)
+            for (int t = 0; t < n; t++) out[t * stride] = 0.0f;
+        else if (interleaved != NULL)
+        {
+            const float* in = interleaved + start * numChannels + c;
+            for (int t = 0; t < n; t++) out[t * stride] = in[t * numChannels];
+        }
+        else
+        {
+            const float* in = planar[c] + start;
+            for (int t = 0; t < n; t++) out[t * stride] = in[t];
+        }
+    }
+}
+
+// Runs the kernel over every group, cutting the block at meter updates. Returns the number of updates.
+static int followerBank_process(void* bank, followerBankKernel kernel, int numChannels, float* scratch,
+                                float* peak, float* meter, int interval, int* count,
+                                const float* interleaved, const float* const* planar, int size)
+{
+    int numGroups = (numChannels + 3) / 4;
+    int updates = 0;
+    int start = 0;
+    while (start < size)
+    {
+        int n = size - start;
+        if (n > FOLLOWER_BANK_FRAMES) n = FOLLOWER_BANK_FRAMES;
+        if (n > interval - *count) n = interval - *count;
+        
+        if (interleaved != NULL)
+        {
+            int whole = numChannels / 4;
+            if (whole > 0)
+                kernel(bank, 0, whole, interleaved + start * numChannels, numChannels, n);
+            if (whole < numGroups)
+            {
+                followerBank_gather(interleaved, planar, numChannels, whole * 4, start, n, scratch, 4);
+                kernel(bank, whole, 1, scratch, 4, n);
+            }
+        }
+        else
+        {
+            followerBank_gather(interleaved, planar, numChannels, 0, start, n, scratch, numGroups * 4);
+            kernel(bank, 0, numGroups, scratch, numGroups * 4, n);
+        }
+        
+        *count += n;
+        if (*count >= interval)
+        {
+            for (int c = 0; c < numChannels; c++)
+            {
+                meter[c] = peak[c];
+                peak[c] = 0.0f;
+            }
+            *count = 0;
+            updates++;
+        }
+        start += n;
+    }
+    return updates;
+}
+
+static int followerBank_interval(float sampleRate, float rate)
+{
+    int interval = rate > 0.0f ? (int)(sampleRate / rate + 0.5f) : 1;
+    return interval < 1 ? 1 : interval;
+}
+
+void    tEnvelopeFollowerBank_init          (tEnvelopeFollowerBank* const fb, int numChannels, float attackThreshold, float decayCoeff, LEAF* const leaf)
+{
+    tEnvelopeFollowerBank_initToPool(fb, numChannels, attackThreshold, decayCoeff, &leaf->mempool);
+}
+
+void    tEnvelopeFollowerBank_initToPool    (tEnvelopeFollowerBank* const fb, int numChannels, float attackThreshold, float decayCoeff, tMempool* const mp)
+{
+    LEAF_PROFILE_POOL(mp);
+    _tMempool* m = *mp;
+    _tEnvelopeFollowerBank* e = *fb = (_tEnvelopeFollowerBank*) mpool_alloc(sizeof(_tEnvelopeFollowerBank), m);
+    e->mempool = m;
+    LEAF* leaf = e->mempool->leaf;
+    
+    int lanes = (numChannels + 3) & ~3;
+    e->numChannels = numChannels;
+    e->y = (float*) mpool_calloc(sizeof(float) * lanes, m);
+    e->peak = (float*) mpool_calloc(sizeof(float) * lanes, m);
+    e->meter = (float*) mpool_calloc(sizeof(float) * lanes, m);
+    e->scratch = (float*) mpool_alloc(sizeof(float) * lanes * FOLLOWER_BANK_FRAMES, m);
+    e->a_thresh = attackThreshold;
+    e->d_coeff = decayCoeff;
+    e->sampleRate = leaf->sampleRate;
+    e->meterCount = 0;
+    tEnvelopeFollowerBank_setMeterRate(fb, 30.0f);
+}
+
+void    tEnvelopeFollowerBank_free          (tEnvelopeFollowerBank* const fb)
+{
+    _tEnvelopeFollowerBank* e = *fb;
+    
+    mpool_free((char*)e->y, e->mempool);
+    mpool_free((char*)e->peak, e->mempool);
+    mpool_free((char*)e->meter, e->mempool);
+    mpool_free((char*)e->scratch, e->mempool);
+    mpool_free((char*)e, e->mempool);
+}
+
+// Same as tEnvelopeFollower_tick on each lane, except that NaN inputs are treated as no peak
+static void tEnvelopeFollowerBank_kernel(void* bank, int firstGroup, int numGroups, const float* x, int stride, int n)
+{
+    _tEnvelopeFollowerBank* e = (_tEnvelopeFollowerBank*) bank;
+    float* y = e->y + firstGroup * 4;
+    float* peak = e->peak + firstGroup * 4;
+#if LEAF_SIMD_SSE2
+    const __m128 thresh = _mm_set1_ps(e->a_thresh), decay = _mm_set1_ps(e->d_coeff);
+    const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+#if LEAF_DENORMAL_CHECK
+    const __m128 vsf = _mm_set1_ps(VSF);
+#endif
+    for (int t = 0; t < n; t++)
+    {
+        const float* xt = x + t * stride;
+        for (int g = 0; g < numGroups * 4; g += 4)
+        {
+            __m128 vy = _mm_loadu_ps(y + g);
+            __m128 in = _mm_and_ps(_mm_loadu_ps(xt + g), absMask);
+            __m128 hit = _mm_and_ps(_mm_cmpge_ps(in, vy), _mm_cmpgt_ps(in, thresh));
+            vy = _mm_or_ps(_mm_and_ps(hit, in), _mm_andnot_ps(hit, _mm_mul_ps(vy, decay)));
+#if LEAF_DENORMAL_CHECK
+            vy = _mm_and_ps(vy, _mm_cmpge_ps(vy, vsf));
+#endif
+            _mm_storeu_ps(y + g, vy);
+            _mm_storeu_ps(peak + g, _mm_max_ps(_mm_loadu_ps(peak + g), vy));
+        }
+    }
+#elif LEAF_SIMD_NEON
+    const float32x4_t thresh = vdupq_n_f32(e->a_thresh), decay = vdupq_n_f32(e->d_coeff);
+#if LEAF_DENORMAL_CHECK
+    const float32x4_t vsf = vdupq_n_f32(VSF);
+#endif
+    for (int t = 0; t < n; t++)
+    {
+        const float* xt = x + t * stride;
+        for (int g = 0; g < numGroups * 4; g += 4)
+        {
+            float32x4_t vy = vld1q_f32(y + g);
+            float32x4_t in = vabsq_f32(vld1q_f32(xt + g));
+            uint32x4_t hit = vandq_u32(vcgeq_f32(in, vy), vcgtq_f32(in, thresh));
+            vy = vbslq_f32(hit, in, vmulq_f32(vy, decay));
+#if LEAF_DENORMAL_CHECK
+            vy = vreinterpretq_f32_u32(vandq_u32(vreinterpretq_u32_f32(vy), vcgeq_f32(vy, vsf)));
+#endif
+            vst1q_f32(y + g, vy);
+            vst1q_f32(peak + g, vmaxq_f32(vld1q_f32(peak + g), vy));
+        }
+    }
+#else
+    for (int t = 0; t < n; t++)
+    {
+        const float* xt = x + t * stride;
+        for (int c = 0; c < numGroups * 4; c++)
+        {
+            float in = fabsf(xt[c]);
+            float v = y[c];
+            if ((in >= v) && (in > e->a_thresh)) v = in;
+            else v = v * e->d_coeff;
+#if LEAF_DENORMAL_CHECK
+            if (v < VSF) v = 0.0f;
+#endif
+            y[c] = v;
+            if (v > peak[c]) peak[c] = v;
+        }
+    }
+#endif
+}
+
+int     tEnvelopeFollowerBank_tickInterleaved (tEnvelopeFollowerBank* const fb, const float* input, int size)
+{
+    LEAF_PROFILE_OBJECT(fb);
+    _tEnvelopeFollowerBank* e = *fb;
+    return followerBank_process(e, tEnvelopeFollowerBank_kernel, e->numChannels, e->scratch, e->peak, e->meter,
+                                e->meterInterval, &e->meterCount, input, NULL, size);
+}
+
+int     tEnvelopeFollowerBank_tickPlanar    (tEnvelopeFollowerBank* const fb, const float* const* input, int size)
+{
+    LEAF_PROFILE_OBJECT(fb);
+    _tEnvelopeFollowerBank* e = *fb;
+    return followerBank_process(e, tEnvelopeFollowerBank_kernel, e->numChannels, e->scratch, e->peak, e->meter,
+                                e->meterInterval, &e->meterCount, NULL, input, size);
+}
+
+float*  tEnvelopeFollowerBank_getValues     (tEnvelopeFollowerBank* const fb)
+{
+    _tEnvelopeFollowerBank* e = *fb;
+    return e->y;
+}
+
+float*  tEnvelopeFollowerBank_getMeters     (tEnvelopeFollowerBank* const fb)
+{
+    _tEnvelopeFollowerBank* e = *fb;
+    return e->meter;
+}
+
+void    tEnvelopeFollowerBank_setMeterRate  (tEnvelopeFollowerBank* const fb, float rate)
+{
+    _tEnvelopeFollowerBank* e = *fb;
+    e->meterInterval = followerBank_interval(e->sampleRate, rate);
+    if (e->meterCount >= e->meterInterval) e->meterCount = e->meterInterval - 1;
+}
+
+void    tEnvelopeFollowerBank_setDecayCoefficient    (tEnvelopeFollowerBank* const fb, float decayCoeff)
+{
+    _tEnvelopeFollowerBank* e = *fb;
+    e->d_coeff = decayCoeff;
+}
+
+void    tEnvelopeFollowerBank_setAttackThreshold  (tEnvelopeFollowerBank* const fb, float attackThresh)
+{
+    _tEnvelopeFollowerBank* e = *fb;
+    e->a_thresh = attackThresh;
+}
+
+void    tPowerFollowerBank_init         (tPowerFollowerBank* const pb, int numChannels, float factor, LEAF* const leaf)
+{
+    tPowerFollowerBank_initToPool(pb, numChannels, factor, &leaf->mempool);
+}
+
+void    tPowerFollowerBank_initToPool   (tPowerFollowerBank* const pb, int numChannels, float factor, tMempool* const mp)
+{
+    LEAF_PROFILE_POOL(mp);
+    _tMempool* m = *mp;
+    _tPowerFollowerBank* p = *pb = (_tPowerFollowerBank*) mpool_alloc(sizeof(_tPowerFollowerBank), m);
+    p->mempool = m;
+    LEAF* leaf = p->mempool->leaf;
+    
+    int lanes = (numChannels + 3) & ~3;
+    p->numChannels = numChannels;
+    p->curr = (float*) mpool_calloc(sizeof(float) * lanes, m);
+    p->peak = (float*) mpool_calloc(sizeof(float) * lanes, m);
+    p->meter = (float*) mpool_calloc(sizeof(float) * lanes, m);
+    p->scratch = (float*) mpool_alloc(sizeof(float) * lanes * FOLLOWER_BANK_FRAMES, m);
+    p->sampleRate = leaf->sampleRate;
+    p->meterCount = 0;
+    tPowerFollowerBank_setFactor(pb, factor);
+    tPowerFollowerBank_setMeterRate(pb, 30.0f);
+}
+
+void    tPowerFollowerBank_free         (tPowerFollowerBank* const pb)
+{
+    _tPowerFollowerBank* p = *pb;
+    
+    mpool_free((char*)p->curr, p->mempool);
+    mpool_free((char*)p->peak, p->mempool);
+    mpool_free((char*)p->meter, p->mempool);
+    mpool_free((char*)p->scratch, p->mempool);
+    mpool_free((char*)p, p->mempool);
+}
+
+static void tPowerFollowerBank_kernel(void* bank, int firstGroup, int numGroups, const float* x, int stride, int n)
+{
+    _tPowerFollowerBank* p = (_tPowerFollowerBank*) bank;
+    float* curr = p->curr + firstGroup * 4;
+    float* peak = p->peak + firstGroup * 4;
+#if LEAF_SIMD_SSE2
+    const __m128 factor = _mm_set1_ps(p->factor), oneminusfactor = _mm_set1_ps(p->oneminusfactor);
+    for (int t = 0; t < n; t++)
+    {
+        const float* xt = x + t * stride;
+        for (int g = 0; g < numGroups * 4; g += 4)
+        {
+            __m128 in = _mm_loadu_ps(xt + g);
+            __m128 vc = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(factor, in), in), _mm_mul_ps(oneminusfactor, _mm_loadu_ps(curr + g)));
+            _mm_storeu_ps(curr + g, vc);
+            _mm_storeu_ps(peak + g, _mm_max_ps(_mm_loadu_ps(peak + g), vc));
+        }
+    }
+#elif LEAF_SIMD_NEON
+    const float32x4_t factor = vdupq_n_f32(p->factor), oneminusfactor = vdupq_n_f32(p->oneminusfactor);
+    for (int t = 0; t < n; t++)
+    {
+        const float* xt = x + t * stride;
+        for (int g = 0; g < numGroups * 4; g += 4)
+        {
+            float32x4_t in = vld1q_f32(xt + g);
+            float32x4_t vc = vaddq_f32(vmulq_f32(vmulq_f32(factor, in), in), vmulq_f32(oneminusfactor, vld1q_f32(curr + g)));
+            vst1q_f32(curr + g, vc);
+            vst1q_f32(peak + g, vmaxq_f32(vld1q_f32(peak + g), vc));
+        }
+    }
+#else
+    for (int t = 0; t < n; t++)
+    {
+        const float* xt = x + t * stride;
+        for (int c = 0; c < numGroups * 4; c++)
+        {
+            float in = xt[c];
+            curr[c] = p->factor*in*in+p->oneminusfactor*curr[c];
+            if (curr[c] > peak[c]) peak[c] = curr[c];
+        }
+    }
+#endif
+}
+
+int     tPowerFollowerBank_tickInterleaved (tPowerFollowerBank* const pb, const float* input, int size)
+{
+    LEAF_PROFILE_OBJECT(pb);
+    _tPowerFollowerBank* p = *pb;
+    return followerBank_process(p, tPowerFollowerBank_kernel, p->numChannels, p->scratch, p->peak, p->meter,
+                                p->meterInterval, &p->meterCount, input, NULL, size);
+}
+
+int     tPowerFollowerBank_tickPlanar   (tPowerFollowerBank* const pb, const float* const* input, int size)
+{
+    LEAF_PROFILE_OBJECT(pb);
+    _tPowerFollowerBank* p = *pb;
+    return followerBank_process(p, tPowerFollowerBank_kernel, p->numChannels, p->scratch, p->peak, p->meter,
+                                p->meterInterval, &p->meterCount, NULL, input, size);
+}
+
+float*  tPowerFollowerBank_getValues    (tPowerFollowerBank* const pb)
+{
+    _tPowerFollowerBank* p = *pb;
+    return p->curr;
+}
+
+float*  tPowerFollowerBank_getMeters    (tPowerFollowerBank* const pb)
+{
+    _tPowerFollowerBank* p = *pb;
+    return p->meter;
+}
+
+void    tPowerFollowerBank_setMeterRate (tPowerFollowerBank* const pb, float rate)
+{
+    _tPowerFollowerBank* p = *pb;
+    p->meterInterval = followerBank_interval(p->sampleRate, rate);
+    if (p->meterCount >= p->meterInterval) p->meterCount = p->meterInterval - 1;
+}
+
+void    tPowerFollowerBank_setFactor    (tPowerFollowerBank* const pb, float factor)
+{
+    _tPowerFollowerBank* p = *pb;
+    
+    if (factor<0) factor=0;
+    if (factor>1) factor=1;
+    p->factor=factor;
+    p->oneminusfactor=1.0f-factor;
+}
+
 
 
 
@@ -238,6 +618,7 @@ void tEnvPD_init(tEnvPD* const xpd, int ws, int hs, int bs, LEAF* const leaf)
 
 void    tEnvPD_initToPool       (tEnvPD* const xpd, int ws, int hs, int bs, tMempool* const mp)
 {
+    LEAF_PROFILE_POOL(mp);
     _tMempool* m = *mp;
     _tEnvPD* x = *xpd = (_tEnvPD*) mpool_calloc(sizeof(_tEnvPD), m);
     x->mempool = m;
@@ -289,30 +670,29 @@ void tEnvPD_free (tEnvPD* const xpd)
 
 float tEnvPD_tick (tEnvPD* const xpd)
 {
+    LEAF_PROFILE_OBJECT(xpd);
     _tEnvPD* x = *xpd;
     return powtodb(x->x_result);
 }
 
-void tEnvPD_processBlock(tEnvPD* const xpd, float* in)
+static inline void envpd_process(_tEnvPD* const x, const float* in, int stride)
 {
-    _tEnvPD* x = *xpd;
-    
     int n = x->blockSize;
     
     int count;
     t_sample *sump;
-    in += n;
+    in += n * stride;
     for (count = x->x_phase, sump = x->x_sumbuf;
          count < x->x_npoints; count += x->x_realperiod, sump++)
     {
         t_sample *hp = x->buf + count;
-        t_sample *fp = in;
+        const t_sample *fp = in;
         t_sample sum = *sump;
         int i;
         
         for (i = 0; i < n; i++)
         {
-            fp--;
+            fp -= stride;
             sum += *hp++ * (*fp * *fp);
         }
         *sump = sum;
@@ -330,6 +710,18 @@ void tEnvPD_processBlock(tEnvPD* const xpd, float* in)
     }
 }
 
+void tEnvPD_processBlock(tEnvPD* const xpd, float* in)
+{
+    LEAF_PROFILE_OBJECT(xpd);
+    envpd_process(*xpd, in, 1);
+}
+
+void tEnvPD_processView(tEnvPD* const xpd, LEAFBufferView in)
+{
+    LEAF_PROFILE_OBJECT(xpd);
+    envpd_process(*xpd, in.data, in.frameStride);
+}
+
 //===========================================================================
 // ATTACKDETECTION
 //===========================================================================
@@ -346,6 +738,7 @@ void tAttackDetection_init(tAttackDetection* const ad, int blocksize, int atk, i
 
 void tAttackDetection_initToPool     (tAttackDetection* const ad, int blocksize, int atk, int rel, tMempool* const mp)
 {
+    LEAF_PROFILE_POOL(mp);
     _tMempool* m = *mp;
     _tAttackDetection* a = *ad = (_tAttackDetection*) mpool_alloc(sizeof(_tAttackDetection), m);
     a->mempool = m;
@@ -458,9 +851,6 @@ static void atkdtk_envelope(tAttackDetection* const ad, float *in)
 /***************************** private procedures *****************************/
 /******************************************************************************/
 
-#define REALFFT mayer_realfft
-#define REALIFFT mayer_realifft
-
 static void snac_analyzeframe(tSNAC* const s);
 static void snac_autocorrelation(tSNAC* const s);
 static void snac_normalize(tSNAC* const s);
@@ -482,6 +872,18 @@ void tSNAC_init(tSNAC* const snac, int overlaparg, LEAF* const leaf)
 
 void    tSNAC_initToPool    (tSNAC* const snac, int overlaparg, tMempool* const mp)
 {
+    LEAF_PROFILE_POOL(mp);
+    tSNAC_initToPoolWithFrameSize(snac, overlaparg, SNAC_FRAME_SIZE, mp);
+}
+
+void    tSNAC_initWithFrameSize (tSNAC* const snac, int overlaparg, int framesize, LEAF* const leaf)
+{
+    tSNAC_initToPoolWithFrameSize(snac, overlaparg, framesize, &leaf->mempool);
+}
+
+void    tSNAC_initToPoolWithFrameSize (tSNAC* const snac, int overlaparg, int framesize, tMempool* const mp)
+{
+    LEAF_PROFILE_POOL(mp);
     _tMempool* m = *mp;
     _tSNAC* s = *snac = (_tSNAC*) mpool_alloc(sizeof(_tSNAC), m);
     s->mempool = m;
@@ -492,12 +894,17 @@ void    tSNAC_initToPool    (tSNAC* const snac, int overlaparg, tMempool* const
     s->periodlength = 0.;
     s->fidelity = 0.;
     s->minrms = DEFMINRMS;
-    s->framesize = SNAC_FRAME_SIZE;
     
-    s->inputbuf = (float*) mpool_calloc(sizeof(float) * SNAC_FRAME_SIZE, m);
-    s->processbuf = (float*) mpool_calloc(sizeof(float) * (SNAC_FRAME_SIZE * 2), m);
-    s->spectrumbuf = (float*) mpool_calloc(sizeof(float) * (SNAC_FRAME_SIZE / 2), m);
-    s->biasbuf = (float*) mpool_calloc(sizeof(float) * SNAC_FRAME_SIZE, m);
+    // The analysis buffers are indexed with masks, so the frame size needs to be a power of two
+    int size = 64;
+    while (size < framesize && size < SNAC_MAX_FRAME_SIZE) size <<= 1;
+    s->framesize = size;
+    
+    s->inputbuf = (float*) mpool_calloc(sizeof(float) * s->framesize, m);
+    s->processbuf = (float*) mpool_calloc(sizeof(float) * (s->framesize * 2), m);
+    s->spectrumbuf = (float*) mpool_calloc(sizeof(float) * (s->framesize / 2), m);
+    s->biasbuf = (float*) mpool_calloc(sizeof(float) * s->framesize, m);
+    tRealFFT_initToPool(&s->fft, s->framesize * 2, mp);
     
     snac_biasbuf(snac);
     tSNAC_setOverlap(snac, overlaparg);
@@ -511,6 +918,7 @@ void tSNAC_free (tSNAC* const snac)
     mpool_free((char*)s->processbuf, s->mempool);
     mpool_free((char*)s->spectrumbuf, s->mempool);
     mpool_free((char*)s->biasbuf, s->mempool);
+    tRealFFT_free(&s->fft);
     mpool_free((char*)s, s->mempool);
 }
 
@@ -599,15 +1007,15 @@ static void snac_analyzeframe(tSNAC* const snac)
     int n, tindex = s->timeindex;
     int framesize = s->framesize;
     int mask = framesize - 1;
-    float norm = 1.f / sqrtf((float)(framesize * 2));
     
     float *inputbuf = s->inputbuf;
     float *processbuf = s->processbuf;
     
     // copy input to processing buffers
+    // the inverse FFT is normalized, so the autocorrelation comes out unscaled without normalizing the input
     for(n=0; n<framesize; n++)
     {
-        processbuf[n] = inputbuf[tindex] * norm;
+        processbuf[n] = inputbuf[tindex];
         tindex++;
         tindex &= mask;
     }
@@ -633,27 +1041,29 @@ static void snac_autocorrelation(tSNAC* const snac)
     float *processbuf = s->processbuf;
     float *spectrumbuf = s->spectrumbuf;
     
-    REALFFT(fftsize, processbuf);
+    tRealFFT_forward(&s->fft, processbuf);
     
     // compute power spectrum
     processbuf[0] *= processbuf[0];                      // DC
-    processbuf[framesize] *= processbuf[framesize];      // Nyquist
+    processbuf[1] *= processbuf[1];                      // Nyquist
     
-    for(n=1; n<framesize; n++)
+    for(n=2; n<fftsize; n+=2)
     {
         processbuf[n] = processbuf[n] * processbuf[n]
-        + processbuf[fftsize-n] * processbuf[fftsize-n]; // imag coefficients appear reversed
-        processbuf[fftsize-n] = 0.f;
+        + processbuf[n+1] * processbuf[n+1];
+        processbuf[n+1] = 0.f;
     }
     
-    // store power spectrum up to SR/4 for possible later use
-    for(m=0; m<(framesize>>1); m++)
+    // store power spectrum up to SR/4 for possible later use, scaled as the spectrum of the frame normalized by 1/sqrt(fftsize)
+    float norm = 1.f / (float)fftsize;
+    spectrumbuf[0] = processbuf[0] * norm;
+    for(m=1; m<(framesize>>1); m++)
     {
-        spectrumbuf[m] = processbuf[m];
+        spectrumbuf[m] = processbuf[2*m] * norm;
     }
     
     // transform power spectrum to autocorrelation function
-    REALIFFT(fftsize, processbuf);
+    tRealFFT_inverse(&s->fft, processbuf);
     return;
 }
 
@@ -835,6 +1245,18 @@ void tPeriodDetection_init (tPeriodDetection* const pd, float* in, int bufSize,
 
 void tPeriodDetection_initToPool (tPeriodDetection* const pd, float* in, int bufSize, int frameSize, tMempool* const mp)
 {
+    LEAF_PROFILE_POOL(mp);
+    tPeriodDetection_initToPoolWithAnalysisSize(pd, in, bufSize, frameSize, SNAC_FRAME_SIZE, mp);
+}
+
+void tPeriodDetection_initWithAnalysisSize (tPeriodDetection* const pd, float* in, int bufSize, int frameSize, int analysisSize, LEAF* const leaf)
+{
+    tPeriodDetection_initToPoolWithAnalysisSize(pd, in, bufSize, frameSize, analysisSize, &leaf->mempool);
+}
+
+void tPeriodDetection_initToPoolWithAnalysisSize (tPeriodDetection* const pd, float* in, int bufSize, int frameSize, int analysisSize, tMempool* const mp)
+{
+    LEAF_PROFILE_POOL(mp);
     _tMempool* m = *mp;
     _tPeriodDetection* p = *pd = (_tPeriodDetection*) mpool_calloc(sizeof(_tPeriodDetection), m);
     p->mempool = m;
@@ -855,7 +1277,10 @@ void tPeriodDetection_initToPool (tPeriodDetection* const pd, float* in, int buf
     
     tEnvPD_initToPool(&p->env, p->windowSize, p->hopSize, p->frameSize, mp);
     
-    tSNAC_initToPool(&p->snac, DEFOVERLAP, mp);
+    // Scale the overlap with the analysis size so longer frames are still analyzed as often
+    int overlap = DEFOVERLAP;
+    while (overlap < 8 && (overlap * SNAC_FRAME_SIZE) / DEFOVERLAP < analysisSize) overlap <<= 1;
+    tSNAC_initToPoolWithFrameSize(&p->snac, overlap, analysisSize, mp);
     
     p->history = 0.0f;
     p->alpha = 1.0f;
@@ -876,6 +1301,7 @@ void tPeriodDetection_free (tPeriodDetection* const pd)
 
 float tPeriodDetection_tick (tPeriodDetection* const pd, float sample)
 {
+    LEAF_PROFILE_OBJECT(pd);
     _tPeriodDetection* p = *pd;
     
     int i, iLast;
@@ -968,6 +1394,7 @@ void    tZeroCrossingInfo_init  (tZeroCrossingInfo* const zc, LEAF* const leaf)
 
 void    tZeroCrossingInfo_initToPool    (tZeroCrossingInfo* const zc, tMempool* const mp)
 {
+    LEAF_PROFILE_POOL(mp);
     _tMempool* m = *mp;
     _tZeroCrossingInfo* z = *zc = (_tZeroCrossingInfo*) mpool_calloc(sizeof(_tZeroCrossingInfo), m);
     z->mempool = m;
@@ -1041,6 +1468,7 @@ void    tZeroCrossingCollector_init  (tZeroCrossingCollector* const zc, int wind
 
 void    tZeroCrossingCollector_initToPool    (tZeroCrossingCollector* const zc, int windowSize, float hysteresis, tMempool* const mp)
 {
+    LEAF_PROFILE_POOL(mp);
     _tMempool* m = *mp;
     _tZeroCrossingCollector* z = *zc = (_tZeroCrossingCollector*) mpool_alloc(sizeof(_tZeroCrossingCollector), m);
     z->mempool = m;
@@ -1088,6 +1516,7 @@ void    tZeroCrossingCollector_free  (tZeroCrossingCollector* const zc)
 
 int     tZeroCrossingCollector_tick(tZeroCrossingCollector* const zc, float s)
 {
+    LEAF_PROFILE_OBJECT(zc);
     _tZeroCrossingCollector* z = *zc;
     
     // Offset s by half of hysteresis, so that zero cross detection is
@@ -1281,6 +1710,7 @@ void    tBitset_init    (tBitset* const bitset, int numBits, LEAF* const leaf)
 
 void    tBitset_initToPool  (tBitset* const bitset, int numBits, tMempool* const mempool)
 {
+    LEAF_PROFILE_POOL(mempool);
     _tMempool* m = *mempool;
     _tBitset* b = *bitset = (_tBitset*) mpool_alloc(sizeof(_tBitset), m);
     b->mempool = m;
@@ -1313,7 +1743,7 @@ int     tBitset_get     (tBitset* const bitset, int index)
     if (index > b->_bit_size)
         return -1;
     
-    unsigned int mask = 1 << (index % b->_value_size);
+    unsigned int mask = 1U << (index % b->_value_size);
     return (b->_bits[index / b->_value_size] & mask) != 0;
 }
 
@@ -1331,7 +1761,7 @@ void     tBitset_set     (tBitset* const bitset, int index, unsigned int val)
     if (index > b->_bit_size)
         return;
     
-    unsigned int mask = 1 << (index % b->_value_size);
+    unsigned int mask = 1U << (index % b->_value_size);
     int i = index / b->_value_size;
     b->_bits[i] ^= (-val ^ b->_bits[i]) & mask;
 }
@@ -1398,7 +1828,7 @@ void     tBitset_setMultiple (tBitset* const bitset, int index, int n, unsigned
         mod = n & (b->_value_size - 1);
         
         // Calculate the mask
-        unsigned int mask = (1 << mod) - 1;
+        unsigned int mask = (1U << mod) - 1;
         
         if (val)
             b->_bits[i] |= mask;
@@ -1431,6 +1861,7 @@ void    tBACF_init  (tBACF* const bacf, tBitset* const bitset, LEAF* const leaf)
 
 void    tBACF_initToPool    (tBACF* const bacf, tBitset* const bitset, tMempool* const mempool)
 {
+    LEAF_PROFILE_POOL(mempool);
     _tMempool* m = *mempool;
     _tBACF* b = *bacf = (_tBACF*) mpool_alloc(sizeof(_tBACF), m);
     b->mempool = m;
@@ -1446,54 +1877,121 @@ void    tBACF_free  (tBACF* const bacf)
     mpool_free((char*) b, b->mempool);
 }
 
-int    tBACF_getCorrelation  (tBACF* const bacf, int pos)
+// Built in compiler popcount functions use the hardware instruction where there is one,
+// popcount() and popcount64() from leaf-math are the portable fallbacks
+static inline int tBACF_popcount(unsigned int x)
 {
-    _tBACF* b = *bacf;
-    
-    int value_size = b->_bitset->_value_size;
-    const int index = pos / value_size;
-    const int shift = pos % value_size;
-    
-    const unsigned int* p1 = b->_bitset->_bits;
-    const unsigned int* p2 = b->_bitset->_bits + index;
-    int count = 0;
-    
-    if (shift == 0)
-    {
-        for (unsigned i = 0; i != b->_mid_array; ++i)
-        {
-            // built in compiler popcount functions should be faster but we want this to be portable
-            // could try to add some define that call the correct function depending on compiler
-            // or let the user pointer popcount() to whatever they want
-            // something to look into...
 #ifdef __GNUC__
-            count += __builtin_popcount(*p1++ ^ *p2++);
+    return __builtin_popcount(x);
 #elif _MSC_VER
-            count += __popcnt(*p1++ ^ *p2++);
+    return __popcnt(x);
 #else
-            count += popcount(*p1++ ^ *p2++);
+    return popcount(x);
 #endif
+}
+
+static inline int tBACF_popcount64(uint64_t x)
+{
+#ifdef __GNUC__
+    return __builtin_popcountll(x);
+#elif _MSC_VER && _WIN64
+    return (int) __popcnt64(x);
+#else
+    return popcount64(x);
+#endif
+}
+
+// Counts the bits that differ between the first n words of p1 and the bitstream starting shift
+// bits into p2. Reads one word past p2 + n when shift is not 0. Assumes 32 bit words.
+static inline int tBACF_count(const unsigned int* p1, const unsigned int* p2, int shift, unsigned n)
+{
+    unsigned i = 0;
+    int count = 0;
+#if LEAF_SIMD_SSE2
+    // Nothing faster than a parallel bit count in SSE2, summed over bytes with psadbw.
+    // Shifts of 32 give 0, so the unshifted case needs no branch.
+    const __m128i s1 = _mm_cvtsi32_si128(shift), s2 = _mm_cvtsi32_si128(32 - shift);
+    const __m128i m1 = _mm_set1_epi8(0x55), m2 = _mm_set1_epi8(0x33), m4 = _mm_set1_epi8(0x0f);
+    __m128i acc = _mm_setzero_si128();
+    for (; i + 4 <= n; i += 4)
+    {
+        __m128i a = _mm_loadu_si128((const __m128i*)(p1 + i));
+        __m128i v = _mm_or_si128(_mm_srl_epi32(_mm_loadu_si128((const __m128i*)(p2 + i)), s1),
+                                 _mm_sll_epi32(_mm_loadu_si128((const __m128i*)(p2 + i + (shift != 0))), s2));
+        __m128i x = _mm_xor_si128(a, v);
+        x = _mm_sub_epi8(x, _mm_and_si128(_mm_srli_epi16(x, 1), m1));
+        x = _mm_add_epi8(_mm_and_si128(x, m2), _mm_and_si128(_mm_srli_epi16(x, 2), m2));
+        x = _mm_and_si128(_mm_add_epi8(x, _mm_srli_epi16(x, 4)), m4);
+        acc = _mm_add_epi64(acc, _mm_sad_epu8(x, _mm_setzero_si128()));
+    }
+    count = _mm_cvtsi128_si32(acc) + _mm_cvtsi128_si32(_mm_unpackhi_epi64(acc, acc));
+#elif LEAF_SIMD_NEON
+    // VCNT counts each byte, then the counts are widened and summed
+    const int32_t s1 = -shift, s2 = 32 - shift;
+    const int32x4_t vs1 = vdupq_n_s32(s1), vs2 = vdupq_n_s32(s2);
+    uint32x4_t acc = vdupq_n_u32(0);
+    for (; i + 4 <= n; i += 4)
+    {
+        uint32x4_t a = vld1q_u32(p1 + i);
+        uint32x4_t v = vorrq_u32(vshlq_u32(vld1q_u32(p2 + i), vs1),
+                                 vshlq_u32(vld1q_u32(p2 + i + (shift != 0)), vs2));
+        uint8x16_t c = vcntq_u8(vreinterpretq_u8_u32(veorq_u32(a, v)));
+        acc = vpadalq_u16(acc, vpaddlq_u8(c));
+    }
+    uint64x2_t sum = vpaddlq_u32(acc);
+    count = (int) (vgetq_lane_u64(sum, 0) + vgetq_lane_u64(sum, 1));
+#endif
+    // Two words at a time, the unshifted and shifted bitstreams are the same as for 32 bit words
+    if (shift == 0)
+    {
+        for (; i + 2 <= n; i += 2)
+        {
+            uint64_t a = (uint64_t) p1[i] | ((uint64_t) p1[i + 1] << 32);
+            uint64_t b = (uint64_t) p2[i] | ((uint64_t) p2[i + 1] << 32);
+            count += tBACF_popcount64(a ^ b);
         }
+        for (; i < n; ++i)
+            count += tBACF_popcount(p1[i] ^ p2[i]);
     }
     else
     {
-        const int shift2 = value_size - shift;
-        for (unsigned i = 0; i != b->_mid_array; ++i)
+        for (; i + 2 <= n; i += 2)
         {
-            unsigned int v = *p2++ >> shift;
-            v |= *p2 << shift2;
-#ifdef __GNUC__
-            count += __builtin_popcount(*p1++ ^ v++);
-#elif _MSC_VER
-            count += __popcnt(*p1++ ^ v++);
-#else
-            count += popcount(*p1++ ^ v++);
-#endif
+            uint64_t a = (uint64_t) p1[i] | ((uint64_t) p1[i + 1] << 32);
+            uint64_t b = (uint64_t) p2[i] | ((uint64_t) p2[i + 1] << 32);
+            uint64_t v = (b >> shift) | ((uint64_t) p2[i + 2] << (64 - shift));
+            count += tBACF_popcount64(a ^ v);
         }
+        for (; i < n; ++i)
+            count += tBACF_popcount(p1[i] ^ ((p2[i] >> shift) | (p2[i + 1] << (32 - shift))));
     }
     return count;
 }
 
+int    tBACF_getCorrelation  (tBACF* const bacf, int pos)
+{
+    _tBACF* b = *bacf;
+    
+    int value_size = b->_bitset->_value_size;
+    const int index = pos / value_size;
+    const int shift = pos % value_size;
+    
+    return tBACF_count(b->_bitset->_bits, b->_bitset->_bits + index, shift, b->_mid_array);
+}
+
+// Fills counts[0 .. end - start - 1] with the correlation at each lag from start up to end
+void    tBACF_getCorrelations   (tBACF* const bacf, int start, int end, int* counts)
+{
+    _tBACF* b = *bacf;
+    
+    int value_size = b->_bitset->_value_size;
+    for (int pos = start; pos < end; ++pos)
+    {
+        counts[pos - start] = tBACF_count(b->_bitset->_bits, b->_bitset->_bits + pos / value_size,
+                                          pos % value_size, b->_mid_array);
+    }
+}
+
 void    tBACF_set  (tBACF* const bacf, tBitset* const bitset)
 {
     _tBACF* b = *bacf;
@@ -1520,6 +2018,7 @@ void    tPeriodDetector_init    (tPeriodDetector* const detector, float lowestFr
 
 void    tPeriodDetector_initToPool  (tPeriodDetector* const detector, float lowestFreq, float highestFreq, float hysteresis, tMempool* const mempool)
 {
+    LEAF_PROFILE_POOL(mempool);
     _tMempool* m = *mempool;
     _tPeriodDetector* p = *detector = (_tPeriodDetector*) mpool_alloc(sizeof(_tPeriodDetector), m);
     p->mempool = m;
@@ -1546,6 +2045,9 @@ void    tPeriodDetector_initToPool  (tPeriodDetector* const detector, float lowe
     p->_num_pulses = 0;
     p->_half_empty = 0;
     
+    p->_search_min = 0;
+    p->_search_max = 0;
+    
     tBACF_initToPool(&p->_bacf, &p->_bits, mempool);
 }
 
@@ -1562,6 +2064,7 @@ void    tPeriodDetector_free    (tPeriodDetector* const detector)
 
 int   tPeriodDetector_tick    (tPeriodDetector* const detector, float s)
 {
+    LEAF_PROFILE_OBJECT(detector);
     _tPeriodDetector* p = *detector;
     
     // Zero crossing
@@ -1690,6 +2193,14 @@ void    tPeriodDetector_setSampleRate   (tPeriodDetector* const detector, float
     p->_min_period = (1.0f / p->highestFreq) * p->sampleRate;
 }
 
+void    tPeriodDetector_setSearchRange  (tPeriodDetector* const detector, float minPeriod, float maxPeriod)
+{
+    _tPeriodDetector* p = *detector;
+    
+    p->_search_min = minPeriod > 0.0f ? (int) minPeriod : 0;
+    p->_search_max = maxPeriod > 0.0f ? (int) ceilf(maxPeriod) : 0;
+}
+
 static inline void set_bitstream(tPeriodDetector* const detector)
 {
     _tPeriodDetector* p = *detector;
@@ -1750,12 +2261,17 @@ static inline void autocorrelate(tPeriodDetector* const detector)
                         int period = tZeroCrossingInfo_period(&curr, &next);
                         if (period > p->_mid_point)
                             break;
-                        if (period >= p->_min_period)
+                        if (p->_search_max > 0 && period > p->_search_max)
+                            break;
+                        if (period >= p->_min_period && period >= p->_search_min)
                         {
                             
                             int count = tBACF_getCorrelation(&p->_bacf, period);
                             
                             int mid = p->_bacf->_mid_array * CHAR_BIT * sizeof(unsigned int);
+                            if (p->_search_max > 0 && p->_search_max + 1 < mid)
+                                mid = p->_search_max + 1;
+                            int lowest = (int) p->_min_period > p->_search_min ? (int) p->_min_period : p->_search_min;
                             
                             int start = period;
                             
@@ -1776,7 +2292,7 @@ static inline void autocorrelate(tPeriodDetector* const detector)
                                     period = d;
                                 }
                                 // Search downwards for the minimum autocorrelation count
-                                for (int d = start - 1; d > p->_min_period; --d)
+                                for (int d = start - 1; d > lowest; --d)
                                 {
                                     int c = tBACF_getCorrelation(&p->_bacf, d);
                                     if (c > count)
@@ -1918,6 +2434,7 @@ void    tPitchDetector_init (tPitchDetector* const detector, float lowestFreq, f
 
 void    tPitchDetector_initToPool   (tPitchDetector* const detector, float lowestFreq, float highestFreq, tMempool* const mempool)
 {
+    LEAF_PROFILE_POOL(mempool);
     _tMempool* m = *mempool;
     _tPitchDetector* p = *detector = (_tPitchDetector*) mpool_alloc(sizeof(_tPitchDetector), m);
     p->mempool = m;
@@ -1940,6 +2457,7 @@ void    tPitchDetector_free (tPitchDetector* const detector)
 
 int     tPitchDetector_tick    (tPitchDetector* const detector, float s)
 {
+    LEAF_PROFILE_OBJECT(detector);
     _tPitchDetector* p = *detector;
     tPeriodDetector_tick(&p->_pd, s);
     
@@ -2040,6 +2558,14 @@ void    tPitchDetector_setSampleRate    (tPitchDetector* const detector, float s
     tPeriodDetector_setSampleRate(&p->_pd, p->sampleRate);
 }
 
+void    tPitchDetector_setSearchRange   (tPitchDetector* const detector, float lowFreq, float highFreq)
+{
+    _tPitchDetector* p = *detector;
+    
+    tPeriodDetector_setSearchRange(&p->_pd, highFreq > 0.0f ? p->sampleRate / highFreq : 0.0f,
+                                   lowFreq > 0.0f ? p->sampleRate / lowFreq : 0.0f);
+}
+
 static inline float calculate_frequency(tPitchDetector* const detector)
 {
     _tPitchDetector* p = *detector;
@@ -2154,12 +2680,16 @@ void    tDualPitchDetector_init (tDualPitchDetector* const detector, float lowes
 
 void    tDualPitchDetector_initToPool   (tDualPitchDetector* const detector, float lowestFreq, float highestFreq, float* inBuffer, int bufSize, tMempool* const mempool)
 {
+    LEAF_PROFILE_POOL(mempool);
     _tMempool* m = *mempool;
     _tDualPitchDetector* p = *detector = (_tDualPitchDetector*) mpool_alloc(sizeof(_tDualPitchDetector), m);
     p->mempool = m;
     LEAF* leaf = p->mempool->leaf;
     
-    tPeriodDetection_initToPool(&p->_pd1, inBuffer, bufSize, bufSize / 2, mempool);
+    // Use a longer SNAC frame when the lowest frequency has a period too long for the default one
+    int analysisSize = SNAC_FRAME_SIZE;
+    while (analysisSize < SNAC_MAX_FRAME_SIZE && analysisSize * SEEK * lowestFreq < leaf->sampleRate) analysisSize <<= 1;
+    tPeriodDetection_initToPoolWithAnalysisSize(&p->_pd1, inBuffer, bufSize, bufSize / 2, analysisSize, mempool);
     tPitchDetector_initToPool(&p->_pd2, lowestFreq, highestFreq, mempool);
     
     p->sampleRate = leaf->sampleRate;
@@ -2173,6 +2703,16 @@ void    tDualPitchDetector_initToPool   (tDualPitchDetector* const detector, flo
     
     p->lowest = lowestFreq;
     p->highest = highestFreq;
+    
+    p->capture = NULL;
+    p->captureMask = 0;
+    p->captureWrite = 0;
+    p->captureRead = 0;
+    
+    for (int i = 0; i < 3; ++i) p->mailbox[i] = p->_current;
+    p->mailboxWrite = 0;
+    p->mailboxShared = 1;
+    p->mailboxRead = 2;
 }
 
 void    tDualPitchDetector_free (tDualPitchDetector* const detector)
@@ -2181,12 +2721,14 @@ void    tDualPitchDetector_free (tDualPitchDetector* const detector)
     
     tPeriodDetection_free(&p->_pd1);
     tPitchDetector_free(&p->_pd2);
+    if (p->capture != NULL) mpool_free((char*) p->capture, p->mempool);
     
     mpool_free((char*) p, p->mempool);
 }
 
 int     tDualPitchDetector_tick    (tDualPitchDetector* const detector, float sample)
 {
+    LEAF_PROFILE_OBJECT(detector);
     _tDualPitchDetector* p = *detector;
     
     tPeriodDetection_tick(&p->_pd1, sample);
@@ -2312,6 +2854,88 @@ void    tDualPitchDetector_setSampleRate (tDualPitchDetector* const detector, fl
     tPitchDetector_setSampleRate(&p->_pd2, p->sampleRate);
 }
 
+void    tDualPitchDetector_setCaptureSize (tDualPitchDetector* const detector, int size)
+{
+    _tDualPitchDetector* p = *detector;
+    
+    if (p->capture != NULL) mpool_free((char*) p->capture, p->mempool);
+    p->capture = NULL;
+    p->captureMask = 0;
+    p->captureWrite = 0;
+    p->captureRead = 0;
+    if (size <= 0) return;
+    
+    uint32_t capacity = 1;
+    while (capacity < (uint32_t) size) capacity <<= 1;
+    p->capture = (float*) mpool_calloc(sizeof(float) * capacity, p->mempool);
+    p->captureMask = capacity - 1;
+}
+
+int     tDualPitchDetector_capture (tDualPitchDetector* const detector, const float* input, int size)
+{
+    _tDualPitchDetector* p = *detector;
+    
+    if (p->capture == NULL || size <= 0) return 0;
+    
+    uint32_t write = p->captureWrite;
+    uint32_t space = p->captureMask + 1 - (write - leaf_loadAcquire(&p->captureRead));
+    if ((uint32_t) size > space) size = (int) space;
+    
+    // Copy in at most two runs either side of the wrap
+    uint32_t start = write & p->captureMask;
+    uint32_t first = p->captureMask + 1 - start;
+    if (first > (uint32_t) size) first = (uint32_t) size;
+    memcpy(p->capture + start, input, sizeof(float) * first);
+    memcpy(p->capture, input + first, sizeof(float) * (size - first));
+    
+    leaf_storeRelease(&p->captureWrite, write + (uint32_t) size);
+    return size;
+}
+
+int     tDualPitchDetector_analyse (tDualPitchDetector* const detector)
+{
+    _tDualPitchDetector* p = *detector;
+    
+    if (p->capture == NULL) return 0;
+    
+    uint32_t read = p->captureRead;
+    uint32_t write = leaf_loadAcquire(&p->captureWrite);
+    int hops = 0;
+    while (read != write)
+    {
+        float sample = p->capture[read & p->captureMask];
+        read++;
+        if (tDualPitchDetector_tick(detector, sample))
+        {
+            // Publish into our own slot and swap it for the shared one
+            p->mailbox[p->mailboxWrite] = p->_current;
+            p->mailboxWrite = leaf_exchange(&p->mailboxShared, p->mailboxWrite | 4) & 3;
+            // Give the space back at every hop so a long catch up doesn't starve capture
+            leaf_storeRelease(&p->captureRead, read);
+            hops++;
+        }
+    }
+    leaf_storeRelease(&p->captureRead, read);
+    
+    return hops;
+}
+
+int     tDualPitchDetector_receive (tDualPitchDetector* const detector, float* frequency, float* periodicity)
+{
+    _tDualPitchDetector* p = *detector;
+    
+    int fresh = 0;
+    if (leaf_loadAcquire(&p->mailboxShared) & 4)
+    {
+        p->mailboxRead = leaf_exchange(&p->mailboxShared, p->mailboxRead) & 3;
+        fresh = 1;
+    }
+    if (frequency != NULL) *frequency = p->mailbox[p->mailboxRead].frequency;
+    if (periodicity != NULL) *periodicity = p->mailbox[p->mailboxRead].periodicity;
+    
+    return fresh;
+}
+
 static inline void compute_predicted_frequency(tDualPitchDetector* const detector)
 {
     _tDualPitchDetector* p = *detector;
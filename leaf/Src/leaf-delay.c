@@ -18,6 +18,20 @@
 
 #endif
 
+// Rounds a delay capacity up to a power of two, as tHermiteDelay does
+static uint32_t delay_nextPow2(uint32_t maxDelay)
+{
+    if (maxDelay < 2) return 2;
+    maxDelay--;
+    maxDelay |= maxDelay >> 1;
+    maxDelay |= maxDelay >> 2;
+    maxDelay |= maxDelay >> 4;
+    maxDelay |= maxDelay >> 8;
+    maxDelay |= maxDelay >> 16;
+    maxDelay++;
+    return maxDelay;
+}
+
 // ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ Delay ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ //
 void    tDelay_init (tDelay* const dl, uint32_t delay, uint32_t maxDelay, LEAF* const leaf)
 {
@@ -26,15 +40,17 @@ void    tDelay_init (tDelay* const dl, uint32_t delay, uint32_t maxDelay, LEAF*
 
 void    tDelay_initToPool   (tDelay* const dl, uint32_t delay, uint32_t maxDelay, tMempool* const mp)
 {
+    LEAF_PROFILE_POOL(mp);
     _tMempool* m = *mp;
     _tDelay* d = *dl = (_tDelay*) mpool_alloc(sizeof(_tDelay), m);
     d->mempool = m;
 
     d->maxDelay = maxDelay;
+    d->bufferMask = 0;
 
     d->delay = delay;
 
-    d->buff = (float*) mpool_alloc(sizeof(float) * maxDelay, m);
+    d->buff = (leaf_sample_t*) mpool_alloc(sizeof(leaf_sample_t) * maxDelay, m);
     
     d->inPoint = 0;
     d->outPoint = 0;
@@ -47,6 +63,19 @@ void    tDelay_initToPool   (tDelay* const dl, uint32_t delay, uint32_t maxDelay
     tDelay_setDelay(dl, d->delay);
 }
 
+void    tDelay_initPow2 (tDelay* const dl, uint32_t delay, uint32_t maxDelay, LEAF* const leaf)
+{
+    tDelay_initToPoolPow2(dl, delay, maxDelay, &leaf->mempool);
+}
+
+void    tDelay_initToPoolPow2   (tDelay* const dl, uint32_t delay, uint32_t maxDelay, tMempool* const mp)
+{
+    LEAF_PROFILE_POOL(mp);
+    maxDelay = delay_nextPow2(maxDelay);
+    tDelay_initToPool(dl, delay, maxDelay, mp);
+    (*dl)->bufferMask = maxDelay - 1;
+}
+
 void tDelay_free (tDelay* const dl)
 {
     _tDelay* d = *dl;
@@ -66,16 +95,26 @@ void    tDelay_clear(tDelay* const dl)
 
 float   tDelay_tick (tDelay* const dl, float input)
 {
+    LEAF_PROFILE_OBJECT(dl);
     _tDelay* d = *dl;
 
     // Input
     d->lastIn = input;
-    d->buff[d->inPoint] = input * d->gain;
-    if (++(d->inPoint) == d->maxDelay)     d->inPoint = 0;
+    d->buff[d->inPoint] = LEAF_SAMPLE_FROM_FLOAT(input * d->gain);
 
     // Output
-    d->lastOut = d->buff[d->outPoint];
-    if (++(d->outPoint) == d->maxDelay)    d->outPoint = 0;
+    d->lastOut = LEAF_SAMPLE_TO_FLOAT(d->buff[d->outPoint]);
+
+    if (d->bufferMask)
+    {
+        d->inPoint = (d->inPoint + 1) & d->bufferMask;
+        d->outPoint = (d->outPoint + 1) & d->bufferMask;
+    }
+    else
+    {
+        if (++(d->inPoint) == d->maxDelay)     d->inPoint = 0;
+        if (++(d->outPoint) == d->maxDelay)    d->outPoint = 0;
+    }
 
     return d->lastOut;
 }
@@ -98,9 +137,10 @@ float tDelay_tapOut (tDelay* const dl, uint32_t tapDelay)
     int32_t tap = d->inPoint - tapDelay - 1;
 
     // Check for wraparound.
-    while ( tap < 0 )   tap += d->maxDelay;
+    if (d->bufferMask)  tap &= d->bufferMask;
+    else while ( tap < 0 )   tap += d->maxDelay;
 
-    return d->buff[tap];
+    return LEAF_SAMPLE_TO_FLOAT(d->buff[tap]);
 
 }
 
@@ -111,9 +151,10 @@ void tDelay_tapIn (tDelay* const dl, float value, uint32_t tapDelay)
     int32_t tap = d->inPoint - tapDelay - 1;
     
     // Check for wraparound.
-    while ( tap < 0 )   tap += d->maxDelay;
+    if (d->bufferMask)  tap &= d->bufferMask;
+    else while ( tap < 0 )   tap += d->maxDelay;
     
-    d->buff[tap] = value;
+    d->buff[tap] = LEAF_SAMPLE_FROM_FLOAT(value);
 }
 
 float tDelay_addTo (tDelay* const dl, float value, uint32_t tapDelay)
@@ -123,9 +164,11 @@ float tDelay_addTo (tDelay* const dl, float value, uint32_t tapDelay)
     int32_t tap = d->inPoint - tapDelay - 1;
     
     // Check for wraparound.
-    while ( tap < 0 )   tap += d->maxDelay;
+    if (d->bufferMask)  tap &= d->bufferMask;
+    else while ( tap < 0 )   tap += d->maxDelay;
     
-    return (d->buff[tap] += value);
+    d->buff[tap] = LEAF_SAMPLE_FROM_FLOAT(LEAF_SAMPLE_TO_FLOAT(d->buff[tap]) + value);
+    return LEAF_SAMPLE_TO_FLOAT(d->buff[tap]);
 }
 
 uint32_t   tDelay_getDelay (tDelay* const dl)
@@ -167,17 +210,19 @@ void   tLinearDelay_init (tLinearDelay* const dl, float delay, uint32_t maxDelay
 
 void tLinearDelay_initToPool  (tLinearDelay* const dl, float delay, uint32_t maxDelay, tMempool* const mp)
 {
+    LEAF_PROFILE_POOL(mp);
     _tMempool* m = *mp;
     _tLinearDelay* d = *dl = (_tLinearDelay*) mpool_alloc(sizeof(_tLinearDelay), m);
     d->mempool = m;
 
     d->maxDelay = maxDelay;
+    d->bufferMask = 0;
 
     if (delay > maxDelay)   d->delay = maxDelay;
     else if (delay < 0.0f)  d->delay = 0.0f;
     else                    d->delay = delay;
 
-    d->buff = (float*) mpool_alloc(sizeof(float) * maxDelay, m);
+    d->buff = (leaf_sample_t*) mpool_alloc(sizeof(leaf_sample_t) * maxDelay, m);
 
     d->gain = 1.0f;
 
@@ -190,6 +235,19 @@ void tLinearDelay_initToPool  (tLinearDelay* const dl, float delay, uint32_t max
     tLinearDelay_setDelay(dl, d->delay);
 }
 
+void   tLinearDelay_initPow2 (tLinearDelay* const dl, float delay, uint32_t maxDelay, LEAF* const leaf)
+{
+    tLinearDelay_initToPoolPow2(dl, delay, maxDelay, &leaf->mempool);
+}
+
+void tLinearDelay_initToPoolPow2  (tLinearDelay* const dl, float delay, uint32_t maxDelay, tMempool* const mp)
+{
+    LEAF_PROFILE_POOL(mp);
+    maxDelay = delay_nextPow2(maxDelay);
+    tLinearDelay_initToPool(dl, delay, maxDelay, mp);
+    (*dl)->bufferMask = maxDelay - 1;
+}
+
 void tLinearDelay_free (tLinearDelay* const dl)
 {
     _tLinearDelay* d = *dl;
@@ -209,21 +267,31 @@ void    tLinearDelay_clear(tLinearDelay* const dl)
 
 float   tLinearDelay_tick (tLinearDelay* const dl, float input)
 {
+    LEAF_PROFILE_OBJECT(dl);
     _tLinearDelay* d = *dl;
 
-    d->buff[d->inPoint] = input * d->gain;
+    d->buff[d->inPoint] = LEAF_SAMPLE_FROM_FLOAT(input * d->gain);
 
     // Increment input pointer modulo length.
-    if (++(d->inPoint) == d->maxDelay )    d->inPoint = 0;
+    if (d->bufferMask) d->inPoint = (d->inPoint + 1) & d->bufferMask;
+    else if (++(d->inPoint) == d->maxDelay )    d->inPoint = 0;
 
     uint32_t idx = (uint32_t) d->outPoint;
+
+    if (d->bufferMask)
+    {
+        d->lastOut = LEAF_SAMPLE_TO_FLOAT(d->buff[idx]) * d->omAlpha + LEAF_SAMPLE_TO_FLOAT(d->buff[(idx + 1) & d->bufferMask]) * d->alpha;
+        d->outPoint = (idx + 1) & d->bufferMask;
+        return d->lastOut;
+    }
+
     // First 1/2 of interpolation
-    d->lastOut = d->buff[idx] * d->omAlpha;
+    d->lastOut = LEAF_SAMPLE_TO_FLOAT(d->buff[idx]) * d->omAlpha;
         // Second 1/2 of interpolation
     if ((idx + 1) < d->maxDelay)
-        d->lastOut += d->buff[idx+1] * d->alpha;
+        d->lastOut += LEAF_SAMPLE_TO_FLOAT(d->buff[idx+1]) * d->alpha;
     else
-        d->lastOut += d->buff[0] * d->alpha;
+        d->lastOut += LEAF_SAMPLE_TO_FLOAT(d->buff[0]) * d->alpha;
 
     // Increment output pointer modulo length
     if ( (++d->outPoint) >= d->maxDelay )   d->outPoint = 0;
@@ -233,26 +301,37 @@ float   tLinearDelay_tick (tLinearDelay* const dl, float input)
 
 void   tLinearDelay_tickIn (tLinearDelay* const dl, float input)
 {
+    LEAF_PROFILE_OBJECT(dl);
     _tLinearDelay* d = *dl;
 
-    d->buff[d->inPoint] = input * d->gain;
+    d->buff[d->inPoint] = LEAF_SAMPLE_FROM_FLOAT(input * d->gain);
 
     // Increment input pointer modulo length.
-    if (++(d->inPoint) == d->maxDelay )    d->inPoint = 0;
+    if (d->bufferMask) d->inPoint = (d->inPoint + 1) & d->bufferMask;
+    else if (++(d->inPoint) == d->maxDelay )    d->inPoint = 0;
 }
 
 float   tLinearDelay_tickOut (tLinearDelay* const dl)
 {
+    LEAF_PROFILE_OBJECT(dl);
     _tLinearDelay* d = *dl;
 
     uint32_t idx = (uint32_t) d->outPoint;
+
+    if (d->bufferMask)
+    {
+        d->lastOut = LEAF_SAMPLE_TO_FLOAT(d->buff[idx]) * d->omAlpha + LEAF_SAMPLE_TO_FLOAT(d->buff[(idx + 1) & d->bufferMask]) * d->alpha;
+        d->outPoint = (idx + 1) & d->bufferMask;
+        return d->lastOut;
+    }
+
     // First 1/2 of interpolation
-    d->lastOut = d->buff[idx] * d->omAlpha;
+    d->lastOut = LEAF_SAMPLE_TO_FLOAT(d->buff[idx]) * d->omAlpha;
         // Second 1/2 of interpolation
     if ((idx + 1) < d->maxDelay)
-        d->lastOut += d->buff[idx+1] * d->alpha;
+        d->lastOut += LEAF_SAMPLE_TO_FLOAT(d->buff[idx+1]) * d->alpha;
     else
-        d->lastOut += d->buff[0] * d->alpha;
+        d->lastOut += LEAF_SAMPLE_TO_FLOAT(d->buff[0]) * d->alpha;
 
     // Increment output pointer modulo length
     if ( (++d->outPoint) >= d->maxDelay )   d->outPoint = 0;
@@ -285,9 +364,10 @@ float tLinearDelay_tapOut (tLinearDelay* const dl, uint32_t tapDelay)
 
     int32_t tap = d->inPoint - tapDelay - 1;
     // Check for wraparound.
-    while ( tap < 0 )   tap += d->maxDelay;
+    if (d->bufferMask)  tap &= d->bufferMask;
+    else while ( tap < 0 )   tap += d->maxDelay;
 
-    return d->buff[tap];
+    return LEAF_SAMPLE_TO_FLOAT(d->buff[tap]);
 }
 
 void tLinearDelay_tapIn (tLinearDelay* const dl, float value, uint32_t tapDelay)
@@ -297,9 +377,10 @@ void tLinearDelay_tapIn (tLinearDelay* const dl, float value, uint32_t tapDelay)
     int32_t tap = d->inPoint - tapDelay - 1;
 
     // Check for wraparound.
-    while ( tap < 0 )   tap += d->maxDelay;
+    if (d->bufferMask)  tap &= d->bufferMask;
+    else while ( tap < 0 )   tap += d->maxDelay;
 
-    d->buff[tap] = value;
+    d->buff[tap] = LEAF_SAMPLE_FROM_FLOAT(value);
 }
 
 float tLinearDelay_addTo (tLinearDelay* const dl, float value, uint32_t tapDelay)
@@ -309,9 +390,11 @@ float tLinearDelay_addTo (tLinearDelay* const dl, float value, uint32_t tapDelay
     int32_t tap = d->inPoint - tapDelay - 1;
 
     // Check for wraparound.
-    while ( tap < 0 )   tap += d->maxDelay;
+    if (d->bufferMask)  tap &= d->bufferMask;
+    else while ( tap < 0 )   tap += d->maxDelay;
     
-    return (d->buff[tap] += value);
+    d->buff[tap] = LEAF_SAMPLE_FROM_FLOAT(LEAF_SAMPLE_TO_FLOAT(d->buff[tap]) + value);
+    return LEAF_SAMPLE_TO_FLOAT(d->buff[tap]);
 }
 
 float   tLinearDelay_getDelay (tLinearDelay* const dl)
@@ -355,6 +438,7 @@ void tHermiteDelay_init (tHermiteDelay* const dl, float delay, uint32_t maxDelay
 
 void tHermiteDelay_initToPool  (tHermiteDelay* const dl, float delay, uint32_t maxDelay, tMempool* const mp)
 {
+    LEAF_PROFILE_POOL(mp);
     _tMempool* m = *mp;
     _tHermiteDelay* d = *dl = (_tHermiteDelay*) mpool_alloc(sizeof(_tHermiteDelay), m);
     d->mempool = m;
@@ -384,7 +468,7 @@ void tHermiteDelay_initToPool  (tHermiteDelay* const dl, float delay, uint32_t m
         d->maxDelay = maxDelay;
         d->bufferMask = maxDelay - 1;
     }
-    d->buff = (float*) mpool_alloc(sizeof(float) * maxDelay, m);
+    d->buff = (leaf_sample_t*) mpool_alloc(sizeof(leaf_sample_t) * maxDelay, m);
 
     d->gain = 1.0f;
 
@@ -417,9 +501,10 @@ void    tHermiteDelay_clear(tHermiteDelay* const dl)
 
 float   tHermiteDelay_tick (tHermiteDelay* const dl, float input)
 {
+    LEAF_PROFILE_OBJECT(dl);
     _tHermiteDelay* d = *dl;
 
-    d->buff[d->inPoint] = input * d->gain;
+    d->buff[d->inPoint] = LEAF_SAMPLE_FROM_FLOAT(input * d->gain);
 
     
     // Increment input pointer modulo length.
@@ -427,10 +512,10 @@ float   tHermiteDelay_tick (tHermiteDelay* const dl, float input)
     
     
     uint32_t idx = (uint32_t) d->outPoint;
-    d->lastOut =    LEAF_interpolate_hermite_x (d->buff[((idx - 1) + d->maxDelay) & d->bufferMask],
-                                                d->buff[idx],
-                                                d->buff[(idx + 1) & d->bufferMask],
-                                                d->buff[(idx + 2) & d->bufferMask],
+    d->lastOut =    LEAF_interpolate_hermite_x (LEAF_SAMPLE_TO_FLOAT(d->buff[((idx - 1) + d->maxDelay) & d->bufferMask]),
+                                                LEAF_SAMPLE_TO_FLOAT(d->buff[idx]),
+                                                LEAF_SAMPLE_TO_FLOAT(d->buff[(idx + 1) & d->bufferMask]),
+                                                LEAF_SAMPLE_TO_FLOAT(d->buff[(idx + 2) & d->bufferMask]),
                                                 d->alpha);
     
     // Increment output pointer modulo length
@@ -441,9 +526,10 @@ float   tHermiteDelay_tick (tHermiteDelay* const dl, float input)
 
 void   tHermiteDelay_tickIn (tHermiteDelay* const dl, float input)
 {
+    LEAF_PROFILE_OBJECT(dl);
     _tHermiteDelay* d = *dl;
     
-    d->buff[d->inPoint] = input;
+    d->buff[d->inPoint] = LEAF_SAMPLE_FROM_FLOAT(input);
     
     // Increment input pointer modulo length.
     d->inPoint = (d->inPoint + 1) & d->bufferMask;
@@ -451,16 +537,17 @@ void   tHermiteDelay_tickIn (tHermiteDelay* const dl, float input)
 
 float   tHermiteDelay_tickOut (tHermiteDelay* const dl)
 {
+    LEAF_PROFILE_OBJECT(dl);
     _tHermiteDelay* d = *dl;
     
     uint32_t idx = (uint32_t) d->outPoint;
     
     
     
-    d->lastOut =    LEAF_interpolate_hermite_x (d->buff[((idx - 1) + d->maxDelay) & d->bufferMask],
-                                                d->buff[idx],
-                                                d->buff[(idx + 1) & d->bufferMask],
-                                                d->buff[(idx + 2) & d->bufferMask],
+    d->lastOut =    LEAF_interpolate_hermite_x (LEAF_SAMPLE_TO_FLOAT(d->buff[((idx - 1) + d->maxDelay) & d->bufferMask]),
+                                                LEAF_SAMPLE_TO_FLOAT(d->buff[idx]),
+                                                LEAF_SAMPLE_TO_FLOAT(d->buff[(idx + 1) & d->bufferMask]),
+                                                LEAF_SAMPLE_TO_FLOAT(d->buff[(idx + 2) & d->bufferMask]),
                                                 d->alpha);
     
     // Increment output pointer modulo length
@@ -492,7 +579,7 @@ float tHermiteDelay_tapOut (tHermiteDelay* const dl, uint32_t tapDelay)
     
     int32_t tap = (d->inPoint - tapDelay - 1) & d->bufferMask;
     
-    return d->buff[tap];
+    return LEAF_SAMPLE_TO_FLOAT(d->buff[tap]);
 
 }
 
@@ -502,10 +589,10 @@ float   tHermiteDelay_tapOutInterpolated (tHermiteDelay* const dl, uint32_t tapD
     
     int32_t idx = (d->inPoint - tapDelay - 1) & d->bufferMask;
     
-    return    LEAF_interpolate_hermite_x (d->buff[((idx - 1) + d->maxDelay) & d->bufferMask],
-                                          d->buff[idx],
-                                          d->buff[(idx + 1) & d->bufferMask],
-                                          d->buff[(idx + 2) & d->bufferMask],
+    return    LEAF_interpolate_hermite_x (LEAF_SAMPLE_TO_FLOAT(d->buff[((idx - 1) + d->maxDelay) & d->bufferMask]),
+                                          LEAF_SAMPLE_TO_FLOAT(d->buff[idx]),
+                                          LEAF_SAMPLE_TO_FLOAT(d->buff[(idx + 1) & d->bufferMask]),
+                                          LEAF_SAMPLE_TO_FLOAT(d->buff[(idx + 2) & d->bufferMask]),
                                           alpha);
 }
 
@@ -515,7 +602,7 @@ void tHermiteDelay_tapIn (tHermiteDelay* const dl, float value, uint32_t tapDela
     
     int32_t tap = (d->inPoint - tapDelay - 1)  & d->bufferMask;
     
-    d->buff[tap] = value;
+    d->buff[tap] = LEAF_SAMPLE_FROM_FLOAT(value);
 }
 
 float tHermiteDelay_addTo (tHermiteDelay* const dl, float value, uint32_t tapDelay)
@@ -524,7 +611,8 @@ float tHermiteDelay_addTo (tHermiteDelay* const dl, float value, uint32_t tapDel
     
     int32_t tap = (d->inPoint - tapDelay - 1)  & d->bufferMask;
     
-    return (d->buff[tap] += value);
+    d->buff[tap] = LEAF_SAMPLE_FROM_FLOAT(LEAF_SAMPLE_TO_FLOAT(d->buff[tap]) + value);
+    return LEAF_SAMPLE_TO_FLOAT(d->buff[tap]);
 }
 
 float   tHermiteDelay_getDelay (tHermiteDelay* const dl)
@@ -570,17 +658,19 @@ void tAllpassDelay_init (tAllpassDelay* const dl, float delay, uint32_t maxDelay
 
 void tAllpassDelay_initToPool  (tAllpassDelay* const dl, float delay, uint32_t maxDelay, tMempool* const mp)
 {
+    LEAF_PROFILE_POOL(mp);
     _tMempool* m = *mp;
     _tAllpassDelay* d = *dl = (_tAllpassDelay*) mpool_alloc(sizeof(_tAllpassDelay), m);
     d->mempool = m;
 
     d->maxDelay = maxDelay;
+    d->bufferMask = 0;
 
     if (delay > maxDelay)   d->delay = maxDelay;
     else if (delay < 0.0f)  d->delay = 0.0f;
     else                    d->delay = delay;
 
-    d->buff = (float*) mpool_alloc(sizeof(float) * maxDelay, m);
+    d->buff = (leaf_sample_t*) mpool_alloc(sizeof(leaf_sample_t) * maxDelay, m);
 
     d->gain = 1.0f;
     
@@ -595,6 +685,19 @@ void tAllpassDelay_initToPool  (tAllpassDelay* const dl, float delay, uint32_t m
     d->apInput = 0.0f;
 }
 
+void tAllpassDelay_initPow2 (tAllpassDelay* const dl, float delay, uint32_t maxDelay, LEAF* const leaf)
+{
+    tAllpassDelay_initToPoolPow2(dl, delay, maxDelay, &leaf->mempool);
+}
+
+void tAllpassDelay_initToPoolPow2  (tAllpassDelay* const dl, float delay, uint32_t maxDelay, tMempool* const mp)
+{
+    LEAF_PROFILE_POOL(mp);
+    maxDelay = delay_nextPow2(maxDelay);
+    tAllpassDelay_initToPool(dl, delay, maxDelay, mp);
+    (*dl)->bufferMask = maxDelay - 1;
+}
+
 void tAllpassDelay_free (tAllpassDelay* const dl)
 {
     _tAllpassDelay* d = *dl;
@@ -614,23 +717,26 @@ void tAllpassDelay_clear(tAllpassDelay* const dl)
 
 float tAllpassDelay_tick (tAllpassDelay* const dl, float input)
 {
+    LEAF_PROFILE_OBJECT(dl);
     _tAllpassDelay* d = *dl;
 
-    d->buff[d->inPoint] = input * d->gain;
+    d->buff[d->inPoint] = LEAF_SAMPLE_FROM_FLOAT(input * d->gain);
 
     // Increment input pointer modulo length.
-    if ( ++(d->inPoint) >= d->maxDelay )    d->inPoint = 0;
+    if (d->bufferMask) d->inPoint = (d->inPoint + 1) & d->bufferMask;
+    else if ( ++(d->inPoint) >= d->maxDelay )    d->inPoint = 0;
 
     // Do allpass interpolation delay.
     float out = d->lastOut * -d->coeff;
-    out += d->apInput + ( d->coeff * d->buff[d->outPoint] );
+    out += d->apInput + ( d->coeff * LEAF_SAMPLE_TO_FLOAT(d->buff[d->outPoint]) );
     d->lastOut = out;
 
     // Save allpass input
-    d->apInput = d->buff[d->outPoint];
+    d->apInput = LEAF_SAMPLE_TO_FLOAT(d->buff[d->outPoint]);
 
     // Increment output pointer modulo length.
-    if (++(d->outPoint) >= d->maxDelay )   d->outPoint = 0;
+    if (d->bufferMask) d->outPoint = (d->outPoint + 1) & d->bufferMask;
+    else if (++(d->outPoint) >= d->maxDelay )   d->outPoint = 0;
 
     return d->lastOut;
 }
@@ -674,9 +780,10 @@ float tAllpassDelay_tapOut (tAllpassDelay* const dl, uint32_t tapDelay)
     int32_t tap = d->inPoint - tapDelay - 1;
 
     // Check for wraparound.
-    while ( tap < 0 )   tap += d->maxDelay;
+    if (d->bufferMask)  tap &= d->bufferMask;
+    else while ( tap < 0 )   tap += d->maxDelay;
 
-    return d->buff[tap];
+    return LEAF_SAMPLE_TO_FLOAT(d->buff[tap]);
 
 }
 
@@ -687,9 +794,10 @@ void tAllpassDelay_tapIn (tAllpassDelay* const dl, float value, uint32_t tapDela
     int32_t tap = d->inPoint - tapDelay - 1;
 
     // Check for wraparound.
-    while ( tap < 0 )   tap += d->maxDelay;
+    if (d->bufferMask)  tap &= d->bufferMask;
+    else while ( tap < 0 )   tap += d->maxDelay;
 
-    d->buff[tap] = value;
+    d->buff[tap] = LEAF_SAMPLE_FROM_FLOAT(value);
 }
 
 float tAllpassDelay_addTo (tAllpassDelay* const dl, float value, uint32_t tapDelay)
@@ -699,9 +807,11 @@ float tAllpassDelay_addTo (tAllpassDelay* const dl, float value, uint32_t tapDel
     int32_t tap = d->inPoint - tapDelay - 1;
 
     // Check for wraparound.
-    while ( tap < 0 )   tap += d->maxDelay;
+    if (d->bufferMask)  tap &= d->bufferMask;
+    else while ( tap < 0 )   tap += d->maxDelay;
 
-    return (d->buff[tap] += value);
+    d->buff[tap] = LEAF_SAMPLE_FROM_FLOAT(LEAF_SAMPLE_TO_FLOAT(d->buff[tap]) + value);
+    return LEAF_SAMPLE_TO_FLOAT(d->buff[tap]);
 }
 
 float   tAllpassDelay_getDelay (tAllpassDelay* const dl)
@@ -743,13 +853,15 @@ void tTapeDelay_init (tTapeDelay* const dl, float delay, uint32_t maxDelay, LEAF
 
 void tTapeDelay_initToPool (tTapeDelay* const dl, float delay, uint32_t maxDelay, tMempool* const mp)
 {
+    LEAF_PROFILE_POOL(mp);
     _tMempool* m = *mp;
     _tTapeDelay* d = *dl = (_tTapeDelay*) mpool_alloc(sizeof(_tTapeDelay), m);
     d->mempool = m;
 
     d->maxDelay = maxDelay;
+    d->bufferMask = 0;
 
-    d->buff = (float*) mpool_alloc(sizeof(float) * maxDelay, m);
+    d->buff = (leaf_sample_t*) mpool_alloc(sizeof(leaf_sample_t) * maxDelay, m);
 
     d->gain = 1.0f;
 
@@ -763,6 +875,19 @@ void tTapeDelay_initToPool (tTapeDelay* const dl, float delay, uint32_t maxDelay
     tTapeDelay_setDelay(dl, delay);
 }
 
+void tTapeDelay_initPow2 (tTapeDelay* const dl, float delay, uint32_t maxDelay, LEAF* const leaf)
+{
+    tTapeDelay_initToPoolPow2(dl, delay, maxDelay, &leaf->mempool);
+}
+
+void tTapeDelay_initToPoolPow2 (tTapeDelay* const dl, float delay, uint32_t maxDelay, tMempool* const mp)
+{
+    LEAF_PROFILE_POOL(mp);
+    maxDelay = delay_nextPow2(maxDelay);
+    tTapeDelay_initToPool(dl, delay, maxDelay, mp);
+    (*dl)->bufferMask = maxDelay - 1;
+}
+
 void tTapeDelay_free (tTapeDelay* const dl)
 {
     _tTapeDelay* d = *dl;
@@ -784,21 +909,35 @@ void tTapeDelay_clear(tTapeDelay* const dl)
 
 float   tTapeDelay_tick (tTapeDelay* const dl, float input)
 {
+    LEAF_PROFILE_OBJECT(dl);
     _tTapeDelay* d = *dl;
 
-    d->buff[d->inPoint] = input * d->gain;
-
-    // Increment input pointer modulo length.
-    if (++(d->inPoint) == d->maxDelay )    d->inPoint = 0;
+    d->buff[d->inPoint] = LEAF_SAMPLE_FROM_FLOAT(input * d->gain);
 
     int idx =  (int) d->idx;
     float alpha = d->idx - idx;
 
-    d->lastOut =    LEAF_interpolate_hermite_x (d->buff[((idx - 1) + d->maxDelay) % d->maxDelay],
-                                              d->buff[idx],
-                                              d->buff[(idx + 1) % d->maxDelay],
-                                              d->buff[(idx + 2) % d->maxDelay],
-                                              alpha);
+    if (d->bufferMask)
+    {
+        uint32_t mask = d->bufferMask;
+        d->inPoint = (d->inPoint + 1) & mask;
+        d->lastOut =    LEAF_interpolate_hermite_x (LEAF_SAMPLE_TO_FLOAT(d->buff[(idx - 1) & mask]),
+                                                  LEAF_SAMPLE_TO_FLOAT(d->buff[idx]),
+                                                  LEAF_SAMPLE_TO_FLOAT(d->buff[(idx + 1) & mask]),
+                                                  LEAF_SAMPLE_TO_FLOAT(d->buff[(idx + 2) & mask]),
+                                                  alpha);
+    }
+    else
+    {
+        // Increment input pointer modulo length.
+        if (++(d->inPoint) == d->maxDelay )    d->inPoint = 0;
+
+        d->lastOut =    LEAF_interpolate_hermite_x (LEAF_SAMPLE_TO_FLOAT(d->buff[((idx - 1) + d->maxDelay) % d->maxDelay]),
+                                                  LEAF_SAMPLE_TO_FLOAT(d->buff[idx]),
+                                                  LEAF_SAMPLE_TO_FLOAT(d->buff[(idx + 1) % d->maxDelay]),
+                                                  LEAF_SAMPLE_TO_FLOAT(d->buff[(idx + 2) % d->maxDelay]),
+                                                  alpha);
+    }
 
     float diff = (d->inPoint - d->idx);
     while (diff < 0.f) diff += d->maxDelay;
@@ -818,7 +957,8 @@ void  tTapeDelay_incrementInPoint(tTapeDelay* const dl)
 {
     _tTapeDelay* d = *dl;
     // Increment input pointer modulo length.
-    if (++(d->inPoint) == d->maxDelay )    d->inPoint = 0;
+    if (d->bufferMask) d->inPoint = (d->inPoint + 1) & d->bufferMask;
+    else if (++(d->inPoint) == d->maxDelay )    d->inPoint = 0;
 }
 
 
@@ -847,10 +987,20 @@ float tTapeDelay_tapOut (tTapeDelay* const dl, float tapDelay)
 
     float alpha = tap - idx;
 
-    float samp =    LEAF_interpolate_hermite_x (d->buff[((idx - 1) + d->maxDelay) % d->maxDelay],
-                                              d->buff[idx],
-                                              d->buff[(idx + 1) % d->maxDelay],
-                                              d->buff[(idx + 2) % d->maxDelay],
+    if (d->bufferMask)
+    {
+        uint32_t mask = d->bufferMask;
+        return LEAF_interpolate_hermite_x (LEAF_SAMPLE_TO_FLOAT(d->buff[(idx - 1) & mask]),
+                                           LEAF_SAMPLE_TO_FLOAT(d->buff[idx & mask]),
+                                           LEAF_SAMPLE_TO_FLOAT(d->buff[(idx + 1) & mask]),
+                                           LEAF_SAMPLE_TO_FLOAT(d->buff[(idx + 2) & mask]),
+                                           alpha);
+    }
+
+    float samp =    LEAF_interpolate_hermite_x (LEAF_SAMPLE_TO_FLOAT(d->buff[((idx - 1) + d->maxDelay) % d->maxDelay]),
+                                              LEAF_SAMPLE_TO_FLOAT(d->buff[idx]),
+                                              LEAF_SAMPLE_TO_FLOAT(d->buff[(idx + 1) % d->maxDelay]),
+                                              LEAF_SAMPLE_TO_FLOAT(d->buff[(idx + 2) % d->maxDelay]),
                                               alpha);
 
     return samp;
@@ -864,9 +1014,10 @@ void tTapeDelay_tapIn (tTapeDelay* const dl, float value, uint32_t tapDelay)
     int32_t tap = d->inPoint - tapDelay - 1;
     
     // Check for wraparound.
-    while ( tap < 0 )   tap += d->maxDelay;
+    if (d->bufferMask)  tap &= d->bufferMask;
+    else while ( tap < 0 )   tap += d->maxDelay;
     
-    d->buff[tap] = value;
+    d->buff[tap] = LEAF_SAMPLE_FROM_FLOAT(value);
 }
 
 float tTapeDelay_addTo (tTapeDelay* const dl, float value, uint32_t tapDelay)
@@ -876,9 +1027,11 @@ float tTapeDelay_addTo (tTapeDelay* const dl, float value, uint32_t tapDelay)
     int32_t tap = d->inPoint - tapDelay - 1;
     
     // Check for wraparound.
-    while ( tap < 0 )   tap += d->maxDelay;
+    if (d->bufferMask)  tap &= d->bufferMask;
+    else while ( tap < 0 )   tap += d->maxDelay;
     
-    return (d->buff[tap] += value);
+    d->buff[tap] = LEAF_SAMPLE_FROM_FLOAT(LEAF_SAMPLE_TO_FLOAT(d->buff[tap]) + value);
+    return LEAF_SAMPLE_TO_FLOAT(d->buff[tap]);
 }
 
 float   tTapeDelay_getDelay (tTapeDelay *dl)
@@ -921,6 +1074,7 @@ void    tRingBuffer_init     (tRingBuffer* const ring, int size, LEAF* const lea
 
 void    tRingBuffer_initToPool   (tRingBuffer* const ring, int size, tMempool* const mempool)
 {
+    LEAF_PROFILE_POOL(mempool);
     _tMempool* m = *mempool;
     _tRingBuffer* r = *ring = (_tRingBuffer*) mpool_alloc(sizeof(_tRingBuffer), m);
     r->mempool = m;
@@ -978,3 +1132,221 @@ int     tRingBuffer_getSize  (tRingBuffer* const ring)
     
     return r->size;
 }
+
+// ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ MultiTapDelay ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ //
+void    tMultiTapDelay_init        (tMultiTapDelay* const dl, uint32_t maxDelay, int numTaps, LEAF* const leaf)
+{
+    tMultiTapDelay_initToPool(dl, maxDelay, numTaps, &leaf->mempool);
+}
+
+void    tMultiTapDelay_initToPool  (tMultiTapDelay* const dl, uint32_t maxDelay, int numTaps, tMempool* const mp)
+{
+    LEAF_PROFILE_POOL(mp);
+    _tMempool* m = *mp;
+    _tMultiTapDelay* d = *dl = (_tMultiTapDelay*) mpool_alloc(sizeof(_tMultiTapDelay), m);
+    d->mempool = m;
+
+    if (numTaps < 1) numTaps = 1;
+    d->numTaps = numTaps;
+    d->maxDelay = maxDelay;
+
+    // Room for a whole block plus the hermite neighbours on top of the longest delay
+    tRingBuffer_initToPool(&d->ring, maxDelay + MULTITAP_BLOCK + 3, mp);
+
+    d->delays = (float*) mpool_alloc(sizeof(float) * numTaps, m);
+    d->gains = (float*) mpool_alloc(sizeof(float) * numTaps, m);
+    d->interpolation = (MultiTapInterpolation*) mpool_alloc(sizeof(MultiTapInterpolation) * numTaps, m);
+
+    for (int i = 0; i < numTaps; i++)
+    {
+        d->delays[i] = (float) maxDelay * (float) (i + 1) / (float) numTaps;
+        d->gains[i] = 1.0f;
+        d->interpolation[i] = MultiTapLinear;
+    }
+}
+
+void    tMultiTapDelay_free        (tMultiTapDelay* const dl)
+{
+    _tMultiTapDelay* d = *dl;
+
+    mpool_free((char*)d->interpolation, d->mempool);
+    mpool_free((char*)d->gains, d->mempool);
+    mpool_free((char*)d->delays, d->mempool);
+    tRingBuffer_free(&d->ring);
+    mpool_free((char*)d, d->mempool);
+}
+
+void    tMultiTapDelay_clear       (tMultiTapDelay* const dl)
+{
+    _tMultiTapDelay* d = *dl;
+    _tRingBuffer* r = d->ring;
+
+    for (unsigned i = 0; i < r->size; i++)
+    {
+        r->buffer[i] = 0.0f;
+    }
+}
+
+// Pushes n samples the same way tRingBuffer_push does
+static inline void multitap_write(_tRingBuffer* const r, const float* input, int n)
+{
+    float* buf = r->buffer;
+    unsigned int mask = r->mask;
+    unsigned int pos = r->pos;
+
+    for (int j = 0; j < n; j++)
+    {
+        pos = (pos - 1) & mask;
+        buf[pos] = input[j];
+    }
+    r->pos = pos;
+}
+
+// Reads one tap for each of the last n samples written, oldest first. The tap's delay is
+// fixed for the block, so its interpolation weights are worked out once up front.
+static inline void multitap_readTap(_tMultiTapDelay* const d, int tap, float* out, int n, int accumulate)
+{
+    _tRingBuffer* r = d->ring;
+    const float* buf = r->buffer;
+    unsigned int mask = r->mask;
+
+    MultiTapInterpolation mode = d->interpolation[tap];
+    float delay = d->delays[tap];
+    float g = d->gains[tap];
+
+    if (mode == MultiTapHermite && delay < 1.0f) delay = 1.0f;
+
+    unsigned int i = (unsigned int) delay;
+    float a = delay - (float) i;
+    unsigned int k = r->pos + (unsigned int) (n - 1) + i;
+
+    if (mode == MultiTapNone || (mode == MultiTapLinear && a == 0.0f))
+    {
+        for (int j = 0; j < n; j++)
+        {
+            float v = g * buf[(k - j) & mask];
+            if (accumulate) out[j] += v;
+            else out[j] = v;
+        }
+    }
+    else if (mode == MultiTapLinear)
+    {
+        float w0 = g * (1.0f - a);
+        float w1 = g * a;
+        for (int j = 0; j < n; j++)
+        {
+            unsigned int p = k - j;
+            float v = w0 * buf[p & mask] + w1 * buf[(p + 1) & mask];
+            if (accumulate) out[j] += v;
+            else out[j] = v;
+        }
+    }
+    else
+    {
+        // LEAF_interpolate_hermite_x as weights on its four points
+        float a2 = a * a;
+        float a3 = a2 * a;
+        float w0 = g * (-0.5f * a + a2 - 0.5f * a3);
+        float w1 = g * (1.0f - 2.5f * a2 + 1.5f * a3);
+        float w2 = g * (0.5f * a + 2.0f * a2 - 1.5f * a3);
+        float w3 = g * (-0.5f * a2 + 0.5f * a3);
+        for (int j = 0; j < n; j++)
+        {
+            unsigned int p = k - j;
+            float v = w0 * buf[(p - 1) & mask] + w1 * buf[p & mask]
+                    + w2 * buf[(p + 1) & mask] + w3 * buf[(p + 2) & mask];
+            if (accumulate) out[j] += v;
+            else out[j] = v;
+        }
+    }
+}
+
+float   tMultiTapDelay_tick        (tMultiTapDelay* const dl, float input)
+{
+    LEAF_PROFILE_OBJECT(dl);
+    _tMultiTapDelay* d = *dl;
+
+    float out = 0.0f;
+
+    multitap_write(d->ring, &input, 1);
+    for (int t = 0; t < d->numTaps; t++)
+    {
+        multitap_readTap(d, t, &out, 1, 1);
+    }
+
+    return out;
+}
+
+float   tMultiTapDelay_tapOut      (tMultiTapDelay* const dl, int tap)
+{
+    _tMultiTapDelay* d = *dl;
+
+    float out;
+    multitap_readTap(d, tap, &out, 1, 0);
+    return out;
+}
+
+void    tMultiTapDelay_tickBlock   (tMultiTapDelay* const dl, const float* input, float* output, int size)
+{
+    LEAF_PROFILE_OBJECT(dl);
+    _tMultiTapDelay* d = *dl;
+
+    for (int offset = 0; offset < size; offset += MULTITAP_BLOCK)
+    {
+        int n = size - offset < MULTITAP_BLOCK ? size - offset : MULTITAP_BLOCK;
+
+        multitap_write(d->ring, input + offset, n);
+        for (int t = 0; t < d->numTaps; t++)
+        {
+            multitap_readTap(d, t, output + offset, n, t > 0);
+        }
+    }
+}
+
+void    tMultiTapDelay_tickBlockTaps   (tMultiTapDelay* const dl, const float* input, float** outputs, int size)
+{
+    LEAF_PROFILE_OBJECT(dl);
+    _tMultiTapDelay* d = *dl;
+
+    for (int offset = 0; offset < size; offset += MULTITAP_BLOCK)
+    {
+        int n = size - offset < MULTITAP_BLOCK ? size - offset : MULTITAP_BLOCK;
+
+        multitap_write(d->ring, input + offset, n);
+        for (int t = 0; t < d->numTaps; t++)
+        {
+            multitap_readTap(d, t, outputs[t] + offset, n, 0);
+        }
+    }
+}
+
+void    tMultiTapDelay_setTapDelay (tMultiTapDelay* const dl, int tap, float delay)
+{
+    _tMultiTapDelay* d = *dl;
+    d->delays[tap] = LEAF_clip(0.0f, delay, (float) d->maxDelay);
+}
+
+float   tMultiTapDelay_getTapDelay (tMultiTapDelay* const dl, int tap)
+{
+    _tMultiTapDelay* d = *dl;
+    return d->delays[tap];
+}
+
+void    tMultiTapDelay_setTapGain  (tMultiTapDelay* const dl, int tap, float gain)
+{
+    _tMultiTapDelay* d = *dl;
+    d->gains[tap] = gain;
+}
+
+void    tMultiTapDelay_setTapInterpolation (tMultiTapDelay* const dl, int tap, MultiTapInterpolation interpolation)
+{
+    _tMultiTapDelay* d = *dl;
+    if (interpolation >= MultiTapInterpolationNil) interpolation = MultiTapLinear;
+    d->interpolation[tap] = interpolation;
+}
+
+int     tMultiTapDelay_getNumTaps  (tMultiTapDelay* const dl)
+{
+    _tMultiTapDelay* d = *dl;
+    return d->numTaps;
+}
@@ -18,6 +18,18 @@
 
 #endif
 
+#if LEAF_USE_CMSIS
+#include "arm_math.h"
+#elif LEAF_USE_SIMD
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define LEAF_SIMD_NEON 1
+#elif defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define LEAF_SIMD_SSE 1
+#endif
+#endif
+
 //============================================================================================================
 // Sample-Rate reducer
 //============================================================================================================
@@ -29,6 +41,7 @@ void tSampleReducer_init (tSampleReducer* const sr, LEAF* const leaf)
 
 void tSampleReducer_initToPool (tSampleReducer* const sr, tMempool* const mp)
 {
+    LEAF_PROFILE_POOL(mp);
     _tMempool* m = *mp;
     _tSampleReducer* s = *sr = (_tSampleReducer*) mpool_alloc(sizeof(_tSampleReducer), m);
     s->mempool = m;
@@ -47,6 +60,7 @@ void tSampleReducer_free (tSampleReducer* const sr)
 
 float tSampleReducer_tick(tSampleReducer* const sr, float input)
 {
+    LEAF_PROFILE_OBJECT(sr);
     _tSampleReducer* s = *sr;
     if (s->count > s->invRatio)
     {
@@ -71,6 +85,27 @@ void tSampleReducer_setRatio(tSampleReducer* const sr, float ratio)
 //============================================================================================================
 // Oversampler
 //============================================================================================================
+// Uses the current ratio and quality to pick the coefficient table
+static void tOversampler_updateCoeffs(_tOversampler* os)
+{
+    int idx = (int)(log2f(os->ratio))-1+os->offset;
+    os->numTaps = __leaf_tablesize_firNumTaps[idx];
+    os->phaseLength = os->numTaps / os->ratio;
+    os->pCoeffs = (float*) __leaf_tableref_firCoeffs[idx];
+
+#if !LEAF_USE_CMSIS
+    // Regroup the taps so that each output phase reads its coefficients contiguously.
+    // Phase p of the interpolator uses every ratio-th tap starting at ratio - 1 - p.
+    for (int p = 0; p < os->ratio; ++p)
+    {
+        for (int t = 0; t < os->phaseLength; ++t)
+        {
+            os->phaseCoeffs[p * os->phaseLength + t] = os->pCoeffs[(os->ratio - 1 - p) + t * os->ratio];
+        }
+    }
+#endif
+}
+
 // Latency is equal to the phase length (numTaps / ratio)
 void tOversampler_init (tOversampler* const osr, int ratio, int extraQuality, LEAF* const leaf)
 {
@@ -79,6 +114,7 @@ void tOversampler_init (tOversampler* const osr, int ratio, int extraQuality, LE
 
 void tOversampler_initToPool (tOversampler* const osr, int maxRatio, int extraQuality, tMempool* const mp)
 {
+    LEAF_PROFILE_POOL(mp);
     _tMempool* m = *mp;
     int offset = 0;
     if (extraQuality) offset = 6;
@@ -92,12 +128,22 @@ void tOversampler_initToPool (tOversampler* const osr, int maxRatio, int extraQu
         os->maxRatio = maxRatio;
         os->allowHighQuality = extraQuality;
         os->ratio = os->maxRatio;
+        
+        // The initial ratio and quality use the most taps, so size everything for them.
+        // Room is added for a block of LEAF's block size so the block functions shift the state once per block.
         int idx = (int)(log2f(os->ratio))-1+os->offset;
-        os->numTaps = __leaf_tablesize_firNumTaps[idx];
-        os->phaseLength = os->numTaps / os->ratio;
-        os->pCoeffs = (float*) __leaf_tableref_firCoeffs[idx];
-        os->upState = (float*) mpool_alloc(sizeof(float) * os->numTaps * 2, m);
-        os->downState = (float*) mpool_alloc(sizeof(float) * os->numTaps * 2, m);
+        int maxTaps = __leaf_tablesize_firNumTaps[idx];
+        os->stateSize = maxTaps * 2 + (m->leaf->blockSize - 1) * os->maxRatio;
+        os->upState = (float*) mpool_alloc(sizeof(float) * os->stateSize, m);
+        os->downState = (float*) mpool_alloc(sizeof(float) * os->stateSize, m);
+        os->bufferSize = m->leaf->blockSize * os->maxRatio;
+        os->buffer = (float*) mpool_alloc(sizeof(float) * os->bufferSize, m);
+#if LEAF_USE_CMSIS
+        os->phaseCoeffs = NULL;
+#else
+        os->phaseCoeffs = (float*) mpool_alloc(sizeof(float) * maxTaps, m);
+#endif
+        tOversampler_updateCoeffs(os);
     }
 }
 
@@ -107,6 +153,10 @@ void tOversampler_free (tOversampler* const osr)
     
     mpool_free((char*)os->upState, os->mempool);
     mpool_free((char*)os->downState, os->mempool);
+    mpool_free((char*)os->buffer, os->mempool);
+#if !LEAF_USE_CMSIS
+    mpool_free((char*)os->phaseCoeffs, os->mempool);
+#endif
     mpool_free((char*)os, os->mempool);
 }
 
@@ -123,190 +173,178 @@ float tOversampler_tick(tOversampler* const osr, float input, float* oversample,
     return tOversampler_downsample(osr, oversample);
 }
 
-// From CMSIS DSP Library
-void tOversampler_upsample(tOversampler* const osr, float input, float* output)
+// Dot product of a state window and a contiguous run of coefficients, oldest sample first
+static inline float tOversampler_dot(const float* x, const float* c, uint32_t n)
 {
-    _tOversampler* os = *osr;
-    
-    if (os->ratio == 1)
+    uint32_t i = 0;
+    float sum = 0.0f;
+#if LEAF_SIMD_SSE
+    __m128 acc0 = _mm_setzero_ps();
+    __m128 acc1 = _mm_setzero_ps();
+    for (; i + 8U <= n; i += 8U)
     {
-        output[0] = input;
-        return;
+        acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(x + i), _mm_loadu_ps(c + i)));
+        acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_loadu_ps(x + i + 4), _mm_loadu_ps(c + i + 4)));
     }
+    float lanes[4];
+    _mm_storeu_ps(lanes, _mm_add_ps(acc0, acc1));
+    sum = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+#elif LEAF_SIMD_NEON
+    float32x4_t acc0 = vdupq_n_f32(0.0f);
+    float32x4_t acc1 = vdupq_n_f32(0.0f);
+    for (; i + 8U <= n; i += 8U)
+    {
+        acc0 = vmlaq_f32(acc0, vld1q_f32(x + i), vld1q_f32(c + i));
+        acc1 = vmlaq_f32(acc1, vld1q_f32(x + i + 4), vld1q_f32(c + i + 4));
+    }
+    float32x4_t acc = vaddq_f32(acc0, acc1);
+    float32x2_t half = vadd_f32(vget_low_f32(acc), vget_high_f32(acc));
+    sum = vget_lane_f32(vpadd_f32(half, half), 0);
+#endif
+    for (; i < n; ++i) sum += x[i] * c[i];
+    return sum;
+}
+
+// Based on arm_fir_interpolate_f32 from the CMSIS DSP Library.
+// Interpolates size input samples, which must fit in the state buffer after the previous phaseLength - 1 samples.
+static void tOversampler_upsampleChunk(_tOversampler* os, const float* input, float* output, uint32_t size)
+{
+    uint32_t phaseLen = os->phaseLength;        /* Length of each polyphase filter component */
+    uint32_t ratio = os->ratio;
+    float* pState = os->upState;                /* os->upState contains the previous phaseLen - 1 samples */
+
+#if LEAF_USE_CMSIS
+    arm_fir_interpolate_instance_f32 S = { (uint8_t) ratio, (uint16_t) phaseLen, os->pCoeffs, pState };
+    arm_fir_interpolate_f32(&S, input, output, size);
+    arm_scale_f32(output, (float) ratio, output, size * ratio);
+#else
+    /* Copy new input samples into the state buffer after the previous frame */
+    memcpy(pState + (phaseLen - 1U), input, sizeof(float) * size);
     
-    float *pState = os->upState;                 /* State pointer */
-    float *pCoeffs = os->pCoeffs;               /* Coefficient pointer */
-    float *pStateCur;
-    float *ptr1;                               /* Temporary pointer for state buffer */
-    float *ptr2;                               /* Temporary pointer for coefficient buffer */
-    float sum0;                                /* Accumulators */
-    uint32_t i, tapCnt;                    /* Loop counters */
-    uint32_t phaseLen = os->phaseLength;            /* Length of each polyphase filter component */
-    uint32_t j;
-    
-    /* os->pState buffer contains previous frame (phaseLen - 1) samples */
-    /* pStateCur points to the location where the new input data should be written */
-    pStateCur = os->upState + (phaseLen - 1U);
-    
-    /* Copy new input sample into the state buffer */
-    *pStateCur = input;
-    
-    /* Address modifier index of coefficient buffer */
-    j = 1U;
-    
-    /* Loop over the Interpolation factor. */
-    i = os->ratio;
-    
-    while (i > 0U)
+    for (uint32_t n = 0; n < size; ++n)
     {
-        /* Set accumulator to zero */
-        sum0 = 0.0f;
-        
-        /* Initialize state pointer */
-        ptr1 = pState;
-        
-        /* Initialize coefficient pointer */
-        ptr2 = pCoeffs + (os->ratio - j);
-        
-        /* Loop over the polyPhase length.
-         Repeat until we've computed numTaps-(4*os->L) coefficients. */
-        
-        /* Initialize tapCnt with number of samples */
-        tapCnt = phaseLen;
-        
-        while (tapCnt > 0U)
+        const float* pCoeffs = os->phaseCoeffs;
+        for (uint32_t p = 0; p < ratio; ++p)
         {
-            /* Perform the multiply-accumulate */
-            sum0 += *ptr1++ * *ptr2;
-            
-            /* Upsampling is done by stuffing L-1 zeros between each sample.
-             * So instead of multiplying zeros with coefficients,
-             * Increment the coefficient pointer by interpolation factor times. */
-            ptr2 += os->ratio;
-            
-            /* Decrement loop counter */
-            tapCnt--;
+            *output++ = tOversampler_dot(pState + n, pCoeffs, phaseLen) * ratio;
+            pCoeffs += phaseLen;
         }
-        
-        /* The result is in the accumulator, store in the destination buffer. */
-        *output++ = sum0 * os->ratio;
-        
-        /* Increment the address modifier index of coefficient buffer */
-        j++;
-        
-        /* Decrement the loop counter */
-        i--;
     }
     
-    /* Advance the state pointer by 1
-     * to process the next group of interpolation factor number samples */
-    pState = pState + 1;
-    
-    /* Processing is complete.
-     Now copy the last phaseLen - 1 samples to the satrt of the state buffer.
-     This prepares the state buffer for the next function call. */
+    /* Copy the last phaseLen - 1 samples to the start of the state buffer for the next call */
+    memmove(pState, pState + size, sizeof(float) * (phaseLen - 1U));
+#endif
+}
+
+// Based on arm_fir_decimate_f32 from the CMSIS DSP Library.
+// Decimates size * ratio input samples, which must fit in the state buffer after the previous numTaps - 1 samples.
+static void tOversampler_downsampleChunk(_tOversampler* os, const float* input, float* output, uint32_t size)
+{
+    uint32_t numTaps = os->numTaps;             /* Number of filter coefficients in the filter */
+    uint32_t ratio = os->ratio;
+    float* pState = os->downState;              /* os->downState contains the previous numTaps - 1 samples */
+
+#if LEAF_USE_CMSIS
+    arm_fir_decimate_instance_f32 S = { (uint16_t) ratio, (uint16_t) numTaps, os->pCoeffs, pState };
+    arm_fir_decimate_f32(&S, input, output, size * ratio);
+#else
+    /* Copy decimation factor number of new input samples per output into the state buffer */
+    memcpy(pState + (numTaps - 1U), input, sizeof(float) * size * ratio);
     
-    /* Points to the start of the state buffer */
-    pStateCur = os->upState;
+    for (uint32_t n = 0; n < size; ++n)
+    {
+        output[n] = tOversampler_dot(pState + n * ratio, os->pCoeffs, numTaps);
+    }
     
-    /* Initialize tapCnt with number of samples */
-    tapCnt = (phaseLen - 1U);
+    /* Copy the last numTaps - 1 samples to the start of the state buffer for the next call */
+    memmove(pState, pState + size * ratio, sizeof(float) * (numTaps - 1U));
+#endif
+}
+
+void tOversampler_upsample(tOversampler* const osr, float input, float* output)
+{
+    _tOversampler* os = *osr;
     
-    /* Copy data */
-    while (tapCnt > 0U)
+    if (os->ratio == 1)
     {
-        *pStateCur++ = *pState++;
-        
-        /* Decrement loop counter */
-        tapCnt--;
+        output[0] = input;
+        return;
     }
+    
+    tOversampler_upsampleChunk(os, &input, output, 1U);
 }
 
-// From CMSIS DSP Library
 float tOversampler_downsample(tOversampler *const osr, float* input)
 {
     _tOversampler* os = *osr;
     
     if (os->ratio == 1) return input[0];
     
-    float *pState = os->downState;                 /* State pointer */
-    float *pCoeffs = os->pCoeffs;               /* Coefficient pointer */
-    float *pStateCur;                          /* Points to the current sample of the state */
-    float *px0;                                /* Temporary pointer for state buffer */
-    float *pb;                                 /* Temporary pointer for coefficient buffer */
-    float x0, c0;                              /* Temporary variables to hold state and coefficient values */
-    float acc0;                                /* Accumulator */
-    uint32_t numTaps = os->numTaps;                 /* Number of filter coefficients in the filter */
-    uint32_t i, tapCnt;
     float output;
+    tOversampler_downsampleChunk(os, input, &output, 1U);
+    return output;
+}
+
+void tOversampler_upsampleBlock(tOversampler* const osr, const float* input, float* output, int size)
+{
+    _tOversampler* os = *osr;
     
-    /* os->pState buffer contains previous frame (numTaps - 1) samples */
-    /* pStateCur points to the location where the new input data should be written */
-    pStateCur = os->downState + (numTaps - 1U);
-    
-    /* Copy decimation factor number of new input samples into the state buffer */
-    i = os->ratio;
-    
-    do
+    if (os->ratio == 1)
     {
-        *pStateCur++ = *input++;
-        
-    } while (--i);
-    
-    /* Set accumulator to zero */
-    acc0 = 0.0f;
-    
-    /* Initialize state pointer */
-    px0 = pState;
-    
-    /* Initialize coeff pointer */
-    pb = pCoeffs;
-    
-    /* Initialize tapCnt with number of taps */
-    tapCnt = numTaps;
+        if (output != input) memmove(output, input, sizeof(float) * size);
+        return;
+    }
     
-    while (tapCnt > 0U)
+    // As many samples as fit in the state buffer are filtered between each state shift
+    int chunk = os->stateSize - os->phaseLength + 1;
+    while (size > 0)
     {
-        /* Read coefficients */
-        c0 = *pb++;
-        
-        /* Fetch 1 state variable */
-        x0 = *px0++;
-        
-        /* Perform the multiply-accumulate */
-        acc0 += x0 * c0;
-        
-        /* Decrement loop counter */
-        tapCnt--;
+        int n = size < chunk ? size : chunk;
+        tOversampler_upsampleChunk(os, input, output, n);
+        input += n;
+        output += n * os->ratio;
+        size -= n;
     }
+}
+
+void tOversampler_downsampleBlock(tOversampler* const osr, const float* input, float* output, int size)
+{
+    _tOversampler* os = *osr;
     
-    /* Advance the state pointer by the decimation factor
-     * to process the next group of decimation factor number samples */
-    pState = pState + os->ratio;
-    
-    /* The result is in the accumulator, store in the destination buffer. */
-    output = acc0;
-    
-    /* Processing is complete.
-     Now copy the last numTaps - 1 samples to the start of the state buffer.
-     This prepares the state buffer for the next function call. */
-    
-    /* Points to the start of the state buffer */
-    pStateCur = os->downState;
-    
-    /* Initialize tapCnt with number of taps */
-    tapCnt = (numTaps - 1U);
-    
-    /* Copy data */
-    while (tapCnt > 0U)
+    if (os->ratio == 1)
     {
-        *pStateCur++ = *pState++;
-        
-        /* Decrement loop counter */
-        tapCnt--;
+        if (output != input) memmove(output, input, sizeof(float) * size);
+        return;
     }
     
-    return output;
+    int chunk = (os->stateSize - os->numTaps + 1) / os->ratio;
+    while (size > 0)
+    {
+        int n = size < chunk ? size : chunk;
+        tOversampler_downsampleChunk(os, input, output, n);
+        input += n * os->ratio;
+        output += n;
+        size -= n;
+    }
+}
+
+void tOversampler_processBlock(tOversampler* const osr, const float* input, float* output, int size,
+                               void (*effectBlock)(void* ctx, float* buffer, int size), void* ctx)
+{
+    _tOversampler* os = *osr;
+
+    // Blocks longer than the internal buffer are processed in pieces that fill it
+    int chunk = os->bufferSize / os->ratio;
+    while (size > 0)
+    {
+        int n = size < chunk ? size : chunk;
+        tOversampler_upsampleBlock(osr, input, os->buffer, n);
+        effectBlock(ctx, os->buffer, n * os->ratio);
+        tOversampler_downsampleBlock(osr, os->buffer, output, n);
+        input += n;
+        output += n;
+        size -= n;
+    }
 }
 
 void    tOversampler_setRatio       (tOversampler* const osr, int ratio)
@@ -320,10 +358,7 @@ void    tOversampler_setRatio       (tOversampler* const osr, int ratio)
         ratio == 16 || ratio == 32 || ratio == 64)
     {
         os->ratio = ratio;
-        int idx = (int)(log2f(os->ratio))-1+os->offset;
-        os->numTaps = __leaf_tablesize_firNumTaps[idx];
-        os->phaseLength = os->numTaps / os->ratio;
-        os->pCoeffs = (float*) __leaf_tableref_firCoeffs[idx];
+        tOversampler_updateCoeffs(os);
     }
 }
 
@@ -338,10 +373,7 @@ void    tOversampler_setQuality     (tOversampler* const osr, int quality)
     
     if (os->ratio == 1) return;
     
-    int idx = (int)(log2f(os->ratio))-1+os->offset;
-    os->numTaps = __leaf_tablesize_firNumTaps[idx];
-    os->phaseLength = os->numTaps / os->ratio;
-    os->pCoeffs = (float*) __leaf_tableref_firCoeffs[idx];
+    tOversampler_updateCoeffs(os);
 }
 
 int tOversampler_getLatency(tOversampler* const osr)
@@ -366,6 +398,7 @@ void tLockhartWavefolder_init (tLockhartWavefolder* const wf, LEAF* const leaf)
 
 void tLockhartWavefolder_initToPool (tLockhartWavefolder* const wf, tMempool* const mp)
 {
+    LEAF_PROFILE_POOL(mp);
     _tMempool* m = *mp;
     _tLockhartWavefolder* w = *wf = (_tLockhartWavefolder*) mpool_alloc(sizeof(_tLockhartWavefolder), m);
     w->mempool = m;
@@ -507,6 +540,7 @@ double tLockhartWavefolderLambert(tLockhartWavefolder* const wf, double x, doubl
 
 float tLockhartWavefolder_tick(tLockhartWavefolder* const wf, float in)
 {
+    LEAF_PROFILE_OBJECT(wf);
     _tLockhartWavefolder* w = *wf;
 
     float out = 0.0f;
@@ -596,6 +630,12 @@ float tLockhartWavefolder_tick(tLockhartWavefolder* const wf, float in)
     return out;
 }
 
+void tLockhartWavefolder_tickBlock(tLockhartWavefolder* const wf, const float* input, float* output, int size)
+{
+    LEAF_PROFILE_OBJECT(wf);
+    for (int i = 0; i < size; i++) output[i] = tLockhartWavefolder_tick(wf, input[i]);
+}
+
 //============================================================================================================
 // CRUSHER
 //============================================================================================================
@@ -608,6 +648,7 @@ void tCrusher_init (tCrusher* const cr, LEAF* const leaf)
 
 void tCrusher_initToPool (tCrusher* const cr, tMempool* const mp)
 {
+    LEAF_PROFILE_POOL(mp);
     _tMempool* m = *mp;
     _tCrusher* c = *cr = (_tCrusher*) mpool_alloc(sizeof(_tCrusher), m);
     c->mempool = m;
@@ -630,6 +671,7 @@ void tCrusher_free (tCrusher* const cr)
 
 float tCrusher_tick (tCrusher* const cr, float input)
 {
+    LEAF_PROFILE_OBJECT(cr);
     _tCrusher* c = *cr;
     
     float sample = input;
@@ -684,3 +726,494 @@ void    tCrusher_setSamplingRatio (tCrusher* const cr, float ratio)
     tSampleReducer_setRatio(&c->sReducer, ratio);
 
 }
+
+//============================================================================================================
+// Antiderivative antialiasing
+//============================================================================================================
+
+// Every shaper here is a static curve f with closed form first and second antiderivatives F1 and F2.
+// First order ADAA outputs the mean of f over the line between the last two inputs,
+//     y[n] = (F1(x[n]) - F1(x[n-1])) / (x[n] - x[n-1]),
+// and second order outputs the mean of that over the last three. When the inputs are too close to divide
+// by, the mean is taken at the midpoint instead. The first order path is all float, with a threshold that
+// scales with the input to keep rounding in F1 down. The second order path divides by a difference twice,
+// which float can't hold up to at any useful drive, so it works in double like tLockhartWavefolder.
+
+#define ADAA_FOLD       8
+#define ADAA_QUANTIZE   9
+
+#define ADAA_THRESH     0.001f
+#define ADAA_THRESH2    0.00001
+
+static void adaa_init (ADAAState* const s, int shape, int order)
+{
+    s->shape = shape;
+    s->order = order;
+    s->step = 0.0f;
+    s->x1 = 0.0;
+    s->x2 = 0.0;
+    s->F1 = 0.0;
+    s->D1 = 0.0;
+}
+
+// f, with the quantizer rounding to a multiple of step after clipping to +/-1
+static inline float adaa_shape (const ADAAState* const s, float u)
+{
+    switch (s->shape)
+    {
+        case ADAATanh:
+            return LEAF_tanh(u);
+        case ADAASoftClip:
+            if (fabsf(u) >= 1.0f) return u < 0.0f ? -1.0f : 1.0f;
+            return u * (1.5f - 0.5f * u * u);
+        case ADAAHardClip:
+            return LEAF_clip(-1.0f, u, 1.0f);
+        case ADAA_FOLD:
+            return sinf(HALF_PI * u);
+        default:
+            return s->step * roundf(LEAF_clip(-1.0f, u, 1.0f) / s->step);
+    }
+}
+
+// The staircase integrates to G(v) = n v - n^2 / 2 with n = round(v), in units of the step
+static inline float adaa_F1 (const ADAAState* const s, float u)
+{
+    float a = fabsf(u);
+    switch (s->shape)
+    {
+        case ADAATanh:
+            if (a > 3.0f) return a - 0.651607518506813f;
+            return u * u * (1.0f / 18.0f) + (4.0f / 3.0f) * logf(1.0f + u * u * (1.0f / 3.0f));
+        case ADAASoftClip:
+            if (a > 1.0f) return a - 0.375f;
+            return u * u * (0.75f - 0.125f * u * u);
+        case ADAAHardClip:
+            if (a > 1.0f) return a - 0.5f;
+            return 0.5f * u * u;
+        case ADAA_FOLD:
+            return cosf(HALF_PI * u) * (-1.0f / HALF_PI);
+        default:
+        {
+            float step = s->step;
+            float v = fminf(a, 1.0f) / step;
+            float n = roundf(v);
+            float F = step * step * (n * v - 0.5f * n * n);
+            if (a > 1.0f) F += step * roundf(1.0f / step) * (a - 1.0f);
+            return F;
+        }
+    }
+}
+
+static inline double adaa_F1d (const ADAAState* const s, double u)
+{
+    double a = fabs(u);
+    switch (s->shape)
+    {
+        case ADAATanh:
+            if (a > 3.0) return a - 0.651607518506813;
+            return u * u * (1.0 / 18.0) + (4.0 / 3.0) * log(1.0 + u * u * (1.0 / 3.0));
+        case ADAASoftClip:
+            if (a > 1.0) return a - 0.375;
+            return u * u * (0.75 - 0.125 * u * u);
+        case ADAAHardClip:
+            if (a > 1.0) return a - 0.5;
+            return 0.5 * u * u;
+        case ADAA_FOLD:
+            return cos(HALF_PI * u) * (-1.0 / HALF_PI);
+        default:
+        {
+            double step = s->step;
+            double v = fmin(a, 1.0) / step;
+            double n = round(v);
+            double F = step * step * (n * v - 0.5 * n * n);
+            if (a > 1.0) F += step * round(1.0 / step) * (a - 1.0);
+            return F;
+        }
+    }
+}
+
+// Past the clip point t each F2 carries on as F2(t) + F1(t) (|u| - t) + f(t) (|u| - t)^2 / 2, mirrored
+// for negative u. The staircase's second integral is H(v) = v^3 / 6 - n / 24 - (v - n)^3 / 6.
+static inline double adaa_F2d (const ADAAState* const s, double u)
+{
+    double a = fabs(u);
+    double sign = u < 0.0 ? -1.0 : 1.0;
+    switch (s->shape)
+    {
+        case ADAATanh:
+            if (a > 3.0)
+            {
+                a -= 3.0;
+                return sign * (2.881975749104142 + 2.348392481493187 * a + 0.5 * a * a);
+            }
+            return u * u * u * (1.0 / 54.0) + (4.0 / 3.0) * (u * log(1.0 + u * u * (1.0 / 3.0)) - 2.0 * u
+                                                             + 3.464101615137754 * atan(u * 0.5773502691896258));
+        case ADAASoftClip:
+            if (a > 1.0)
+            {
+                a -= 1.0;
+                return sign * (0.225 + 0.625 * a + 0.5 * a * a);
+            }
+            return u * u * u * (0.25 - 0.025 * u * u);
+        case ADAAHardClip:
+            if (a > 1.0)
+            {
+                a -= 1.0;
+                return sign * (1.0 / 6.0 + 0.5 * a + 0.5 * a * a);
+            }
+            return u * u * u * (1.0 / 6.0);
+        case ADAA_FOLD:
+            return sin(HALF_PI * u) * (-1.0 / (HALF_PI * HALF_PI));
+        default:
+        {
+            double step = s->step;
+            double v = fmin(a, 1.0) / step;
+            double n = round(v);
+            double r = v - n;
+            double F = step * step * step * (v * v * v - 0.25 * n - r * r * r) * (1.0 / 6.0);
+            if (a > 1.0)
+            {
+                n = round(1.0 / step);
+                r = 1.0 / step;
+                a -= 1.0;
+                F += step * step * (n * r - 0.5 * n * n) * a + step * n * 0.5 * a * a;
+            }
+            return sign * F;
+        }
+    }
+}
+
+// Divided difference of F2, the mean of F1 between two inputs
+static inline double adaa_D (const ADAAState* const s, double x, double x1, double Fx, double Fx1)
+{
+    double d = x - x1;
+    if (fabs(d) > ADAA_THRESH2 * (1.0 + fabs(x))) return (Fx - Fx1) / d;
+    return adaa_F1d(s, 0.5 * (x + x1));
+}
+
+// Recompute what's cached about the last inputs, after the order or the curve changes
+static void adaa_refresh (ADAAState* const s)
+{
+    if (s->order == 1)
+    {
+        s->F1 = adaa_F1(s, (float) s->x1);
+    }
+    else if (s->order == 2)
+    {
+        double F2 = adaa_F2d(s, s->x2);
+        s->F1 = adaa_F2d(s, s->x1);
+        s->D1 = adaa_D(s, s->x1, s->x2, s->F1, F2);
+    }
+}
+
+static void adaa_setOrder (ADAAState* const s, int order)
+{
+    s->order = LEAF_clipInt(0, order, 2);
+    adaa_refresh(s);
+}
+
+// Runs the curve over a block of inputs scaled by drive and shifted by offset
+static void adaa_process (ADAAState* const s, const float* input, float* output, int size, float drive, float offset)
+{
+    if (s->order == 0)
+    {
+        // Keep the last inputs so switching order later doesn't click
+        if (size > 0)
+        {
+            s->x2 = size > 1 ? input[size - 2] * drive + offset : s->x1;
+            s->x1 = input[size - 1] * drive + offset;
+        }
+        for (int i = 0; i < size; i++) output[i] = adaa_shape(s, input[i] * drive + offset);
+    }
+    else if (s->order == 1)
+    {
+        float x1 = (float) s->x1, x2 = (float) s->x2;
+        float F1 = (float) s->F1;
+        for (int i = 0; i < size; i++)
+        {
+            float x = input[i] * drive + offset;
+            float F = adaa_F1(s, x);
+            float d = x - x1;
+            if (fabsf(d) > ADAA_THRESH * (1.0f + fabsf(x))) output[i] = (F - F1) / d;
+            else output[i] = adaa_shape(s, 0.5f * (x + x1));
+            x2 = x1;
+            x1 = x;
+            F1 = F;
+        }
+        s->x1 = x1;
+        s->x2 = x2;
+        s->F1 = F1;
+    }
+    else
+    {
+        double x1 = s->x1, x2 = s->x2;
+        double F1 = s->F1, D1 = s->D1;
+        for (int i = 0; i < size; i++)
+        {
+            double x = input[i] * drive + offset;
+            double F = adaa_F2d(s, x);
+            double D = adaa_D(s, x, x1, F, F1);
+            double d = x - x2;
+            double y;
+            if (fabs(d) > ADAA_THRESH2 * (1.0 + fabs(x))) y = 2.0 * (D - D1) / d;
+            else
+            {
+                // The newest and oldest inputs coincide, so take the limit around their midpoint
+                double xbar = 0.5 * (x + x2);
+                double delta = xbar - x1;
+                if (fabs(delta) > ADAA_THRESH2 * (1.0 + fabs(xbar)))
+                    y = 2.0 / delta * (adaa_F1d(s, xbar) + (F1 - adaa_F2d(s, xbar)) / delta);
+                else y = adaa_shape(s, (float) (0.5 * (xbar + x1)));
+            }
+            output[i] = (float) y;
+            x2 = x1;
+            x1 = x;
+            F1 = F;
+            D1 = D;
+        }
+        s->x1 = x1;
+        s->x2 = x2;
+        s->F1 = F1;
+        s->D1 = D1;
+    }
+}
+
+//============================================================================================================
+// ADAA Saturator
+//============================================================================================================
+
+void    tADAASaturator_init         (tADAASaturator* const sat, LEAF* const leaf)
+{
+    tADAASaturator_initToPool(sat, &leaf->mempool);
+}
+
+void    tADAASaturator_initToPool   (tADAASaturator* const sat, tMempool* const mp)
+{
+    LEAF_PROFILE_POOL(mp);
+    _tMempool* m = *mp;
+    _tADAASaturator* s = *sat = (_tADAASaturator*) mpool_alloc(sizeof(_tADAASaturator), m);
+    s->mempool = m;
+
+    s->drive = 1.0f;
+    adaa_init(&s->adaa, ADAATanh, 1);
+}
+
+void    tADAASaturator_free         (tADAASaturator* const sat)
+{
+    _tADAASaturator* s = *sat;
+
+    mpool_free((char*)s, s->mempool);
+}
+
+float   tADAASaturator_tick         (tADAASaturator* const sat, float input)
+{
+    LEAF_PROFILE_OBJECT(sat);
+    _tADAASaturator* s = *sat;
+
+    float output;
+    adaa_process(&s->adaa, &input, &output, 1, s->drive, 0.0f);
+    return output;
+}
+
+void    tADAASaturator_tickBlock    (tADAASaturator* const sat, const float* input, float* output, int size)
+{
+    LEAF_PROFILE_OBJECT(sat);
+    _tADAASaturator* s = *sat;
+
+    adaa_process(&s->adaa, input, output, size, s->drive, 0.0f);
+}
+
+void    tADAASaturator_setType      (tADAASaturator* const sat, ADAASaturatorType type)
+{
+    _tADAASaturator* s = *sat;
+
+    s->adaa.shape = LEAF_clipInt(0, type, ADAASaturatorTypeNil - 1);
+    adaa_refresh(&s->adaa);
+}
+
+void    tADAASaturator_setOrder     (tADAASaturator* const sat, int order)
+{
+    _tADAASaturator* s = *sat;
+
+    adaa_setOrder(&s->adaa, order);
+}
+
+void    tADAASaturator_setDrive     (tADAASaturator* const sat, float drive)
+{
+    _tADAASaturator* s = *sat;
+
+    s->drive = drive;
+}
+
+//============================================================================================================
+// ADAA Wavefolder
+//============================================================================================================
+
+void    tADAAWavefolder_init        (tADAAWavefolder* const wf, LEAF* const leaf)
+{
+    tADAAWavefolder_initToPool(wf, &leaf->mempool);
+}
+
+void    tADAAWavefolder_initToPool  (tADAAWavefolder* const wf, tMempool* const mp)
+{
+    LEAF_PROFILE_POOL(mp);
+    _tMempool* m = *mp;
+    _tADAAWavefolder* w = *wf = (_tADAAWavefolder*) mpool_alloc(sizeof(_tADAAWavefolder), m);
+    w->mempool = m;
+
+    w->drive = 1.0f;
+    w->offset = 0.0f;
+    adaa_init(&w->adaa, ADAA_FOLD, 1);
+}
+
+void    tADAAWavefolder_free        (tADAAWavefolder* const wf)
+{
+    _tADAAWavefolder* w = *wf;
+
+    mpool_free((char*)w, w->mempool);
+}
+
+float   tADAAWavefolder_tick        (tADAAWavefolder* const wf, float input)
+{
+    LEAF_PROFILE_OBJECT(wf);
+    _tADAAWavefolder* w = *wf;
+
+    float output;
+    adaa_process(&w->adaa, &input, &output, 1, w->drive, w->offset);
+    return output;
+}
+
+void    tADAAWavefolder_tickBlock   (tADAAWavefolder* const wf, const float* input, float* output, int size)
+{
+    LEAF_PROFILE_OBJECT(wf);
+    _tADAAWavefolder* w = *wf;
+
+    adaa_process(&w->adaa, input, output, size, w->drive, w->offset);
+}
+
+void    tADAAWavefolder_setOrder    (tADAAWavefolder* const wf, int order)
+{
+    _tADAAWavefolder* w = *wf;
+
+    adaa_setOrder(&w->adaa, order);
+}
+
+void    tADAAWavefolder_setDrive    (tADAAWavefolder* const wf, float drive)
+{
+    _tADAAWavefolder* w = *wf;
+
+    w->drive = drive;
+}
+
+void    tADAAWavefolder_setOffset   (tADAAWavefolder* const wf, float offset)
+{
+    _tADAAWavefolder* w = *wf;
+
+    w->offset = offset;
+}
+
+//============================================================================================================
+// ADAA Crusher
+//============================================================================================================
+
+void    tADAACrusher_init           (tADAACrusher* const cr, LEAF* const leaf)
+{
+    tADAACrusher_initToPool(cr, &leaf->mempool);
+}
+
+void    tADAACrusher_initToPool     (tADAACrusher* const cr, tMempool* const mp)
+{
+    LEAF_PROFILE_POOL(mp);
+    _tMempool* m = *mp;
+    _tADAACrusher* c = *cr = (_tADAACrusher*) mpool_alloc(sizeof(_tADAACrusher), m);
+    c->mempool = m;
+
+    c->div = SCALAR;
+    c->drive = SCALAR / c->div;
+    c->gain = (c->div / SCALAR) * 0.7f + 0.3f;
+    c->srr = 1.0f;
+    adaa_init(&c->adaa, ADAA_QUANTIZE, 1);
+    c->adaa.step = 0.25f;
+    tSampleReducer_initToPool(&c->sReducer, mp);
+}
+
+void    tADAACrusher_free           (tADAACrusher* const cr)
+{
+    _tADAACrusher* c = *cr;
+
+    tSampleReducer_free(&c->sReducer);
+    mpool_free((char*)c, c->mempool);
+}
+
+float   tADAACrusher_tick           (tADAACrusher* const cr, float input)
+{
+    LEAF_PROFILE_OBJECT(cr);
+    _tADAACrusher* c = *cr;
+
+    float output;
+    adaa_process(&c->adaa, &input, &output, 1, c->drive, 0.0f);
+    if (c->srr != 1.0f) output = tSampleReducer_tick(&c->sReducer, output);
+    return output * c->gain;
+}
+
+void    tADAACrusher_tickBlock      (tADAACrusher* const cr, const float* input, float* output, int size)
+{
+    LEAF_PROFILE_OBJECT(cr);
+    _tADAACrusher* c = *cr;
+
+    adaa_process(&c->adaa, input, output, size, c->drive, 0.0f);
+
+    float gain = c->gain;
+    if (c->srr != 1.0f)
+    {
+        for (int i = 0; i < size; i++) output[i] = tSampleReducer_tick(&c->sReducer, output[i]) * gain;
+    }
+    else
+    {
+        for (int i = 0; i < size; i++) output[i] *= gain;
+    }
+}
+
+void    tADAACrusher_setOrder       (tADAACrusher* const cr, int order)
+{
+    _tADAACrusher* c = *cr;
+
+    adaa_setOrder(&c->adaa, order);
+}
+
+// 0.0 - 1.0
+void    tADAACrusher_setQuality     (tADAACrusher* const cr, float val)
+{
+    _tADAACrusher* c = *cr;
+
+    val = LEAF_clip(0.0f, val, 1.0f);
+
+    c->div = 0.01f + val * SCALAR;
+    c->drive = SCALAR / c->div;
+    c->gain = (c->div / SCALAR) * 0.7f + 0.3f;
+}
+
+// what decimal to round to
+void    tADAACrusher_setRound       (tADAACrusher* const cr, float rnd)
+{
+    _tADAACrusher* c = *cr;
+
+    rnd = fabsf(rnd);
+
+    // No rounding is a plain clip, which saves dividing by a vanishing step
+    if (rnd <= 0.0000001f) c->adaa.shape = ADAAHardClip;
+    else
+    {
+        c->adaa.shape = ADAA_QUANTIZE;
+        c->adaa.step = rnd;
+    }
+    adaa_refresh(&c->adaa);
+}
+
+void    tADAACrusher_setSamplingRatio (tADAACrusher* const cr, float ratio)
+{
+    _tADAACrusher* c = *cr;
+
+    c->srr = ratio;
+    tSampleReducer_setRatio(&c->sReducer, ratio);
+}
@@ -16,6 +16,16 @@
 
 #endif
 
+#if LEAF_USE_SIMD
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define LEAF_SIMD_NEON 1
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define LEAF_SIMD_SSE2 1
+#endif
+#endif
+
 //==============================================================================
 
 // ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ Compressor ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ //
@@ -48,6 +58,7 @@ void tCompressor_init (tCompressor* const comp, LEAF* const leaf)
 
 void tCompressor_initToPool (tCompressor* const comp, tMempool* const mp)
 {
+    LEAF_PROFILE_POOL(mp);
     _tMempool* m = *mp;
     _tCompressor* c = *comp = (_tCompressor*) mpool_alloc(sizeof(_tCompressor), m);
     c->mempool = m;
@@ -63,6 +74,13 @@ void tCompressor_initToPool (tCompressor* const comp, tMempool* const mp)
     c->M = 3.0f; // decibel Width of knee transition
     c->W = 1.0f; // decibel Make-up gain
     
+    c->x_T[0] = c->x_T[1] = 0.0f;
+    c->y_T[0] = c->y_T[1] = 0.0f;
+
+    c->lookahead = NULL;
+    c->lookaheadSize = 0;
+    c->lookaheadPos = 0;
+
     c->sampleRate = leaf->sampleRate;
 }
 
@@ -70,11 +88,13 @@ void tCompressor_free (tCompressor* const comp)
 {
     _tCompressor* c = *comp;
     
+    if (c->lookahead != NULL) mpool_free((char*)c->lookahead, c->mempool);
     mpool_free((char*)c, c->mempool);
 }
 
 float tCompressor_tick(tCompressor* const comp, float in)
 {
+    LEAF_PROFILE_OBJECT(comp);
     _tCompressor* c = *comp;
     
     float slope, overshoot;
@@ -122,6 +142,202 @@ float tCompressor_tick(tCompressor* const comp, float in)
     return attenuation * in;
 }
 
+// The block functions work in log2 rather than dB. This is log2f_approx() done with bit operations
+// instead of frexpf() so that it vectorizes, and the gain goes back through LEAF_dbtoaBlock().
+// The detector is within 0.01dB and the gain within 0.0001dB.
+#define COMPRESSOR_DB_PER_LOG2 6.02059991327962f    // 20 * log10(2)
+
+static inline float tCompressor_log2(float x)
+{
+    union {float f; int32_t i;} b = { x };
+    float e = (float)(((b.i >> 23) & 0xff) - 126);
+    b.i = (b.i & 0x007fffff) | 0x3f000000;
+    float y = 1.23149591368684f * b.f;
+    y += -4.11852516267426f;
+    y *= b.f;
+    y += 6.02197014179219f;
+    y *= b.f;
+    y += -3.13396450166353f;
+    return y + e;
+}
+
+// level[] holds detector levels coming in and the gain computer's x_T going out
+static inline void tCompressor_gainComputer(_tCompressor* const c, float* level, int n)
+{
+    float slope = c->R - 1.0f;
+    float halfW = c->W * 0.5f;
+    float invTwoW = c->W > 0.0f ? 1.0f / (2.0f * c->W) : 0.0f;
+    int t = 0;
+#if LEAF_SIMD_SSE2
+    const __m128 vmin = _mm_set1_ps(0.000001f), vT = _mm_set1_ps(c->T);
+    const __m128 vslope = _mm_set1_ps(slope), vhalfW = _mm_set1_ps(halfW), vinv = _mm_set1_ps(invTwoW);
+    const __m128 vnegHalfW = _mm_set1_ps(-halfW), vdb = _mm_set1_ps(COMPRESSOR_DB_PER_LOG2);
+    const __m128i mant = _mm_set1_epi32(0x007fffff), half = _mm_set1_epi32(0x3f000000), bias = _mm_set1_epi32(126);
+    for (; t + 4 <= n; t += 4)
+    {
+        __m128 x = _mm_max_ps(_mm_loadu_ps(level + t), vmin);
+        __m128i bits = _mm_castps_si128(x);
+        __m128 e = _mm_cvtepi32_ps(_mm_sub_epi32(_mm_srli_epi32(bits, 23), bias));
+        __m128 f = _mm_castsi128_ps(_mm_or_si128(_mm_and_si128(bits, mant), half));
+        __m128 y = _mm_mul_ps(_mm_set1_ps(1.23149591368684f), f);
+        y = _mm_mul_ps(_mm_add_ps(y, _mm_set1_ps(-4.11852516267426f)), f);
+        y = _mm_mul_ps(_mm_add_ps(y, _mm_set1_ps(6.02197014179219f)), f);
+        y = _mm_add_ps(_mm_add_ps(y, _mm_set1_ps(-3.13396450166353f)), e);
+
+        __m128 overshoot = _mm_sub_ps(_mm_mul_ps(y, vdb), vT);
+        __m128 k = _mm_add_ps(overshoot, vhalfW);
+        __m128 knee = _mm_mul_ps(vslope, _mm_mul_ps(_mm_mul_ps(k, k), vinv));
+        __m128 over = _mm_mul_ps(vslope, overshoot);
+        __m128 inKnee = _mm_cmplt_ps(overshoot, vhalfW);
+        __m128 out = _mm_or_ps(_mm_and_ps(inKnee, knee), _mm_andnot_ps(inKnee, over));
+        _mm_storeu_ps(level + t, _mm_and_ps(_mm_cmpgt_ps(overshoot, vnegHalfW), out));
+    }
+#elif LEAF_SIMD_NEON
+    const float32x4_t vmin = vdupq_n_f32(0.000001f), vT = vdupq_n_f32(c->T);
+    const float32x4_t vslope = vdupq_n_f32(slope), vhalfW = vdupq_n_f32(halfW), vinv = vdupq_n_f32(invTwoW);
+    const float32x4_t vnegHalfW = vdupq_n_f32(-halfW), vdb = vdupq_n_f32(COMPRESSOR_DB_PER_LOG2);
+    const float32x4_t zero = vdupq_n_f32(0.0f);
+    for (; t + 4 <= n; t += 4)
+    {
+        float32x4_t x = vmaxq_f32(vld1q_f32(level + t), vmin);
+        uint32x4_t bits = vreinterpretq_u32_f32(x);
+        float32x4_t e = vcvtq_f32_s32(vsubq_s32(vreinterpretq_s32_u32(vshrq_n_u32(bits, 23)), vdupq_n_s32(126)));
+        float32x4_t f = vreinterpretq_f32_u32(vorrq_u32(vandq_u32(bits, vdupq_n_u32(0x007fffff)), vdupq_n_u32(0x3f000000)));
+        float32x4_t y = vmulq_f32(vdupq_n_f32(1.23149591368684f), f);
+        y = vmulq_f32(vaddq_f32(y, vdupq_n_f32(-4.11852516267426f)), f);
+        y = vmulq_f32(vaddq_f32(y, vdupq_n_f32(6.02197014179219f)), f);
+        y = vaddq_f32(vaddq_f32(y, vdupq_n_f32(-3.13396450166353f)), e);
+
+        float32x4_t overshoot = vsubq_f32(vmulq_f32(y, vdb), vT);
+        float32x4_t k = vaddq_f32(overshoot, vhalfW);
+        float32x4_t knee = vmulq_f32(vslope, vmulq_f32(vmulq_f32(k, k), vinv));
+        float32x4_t over = vmulq_f32(vslope, overshoot);
+        float32x4_t out = vbslq_f32(vcltq_f32(overshoot, vhalfW), knee, over);
+        vst1q_f32(level + t, vbslq_f32(vcgtq_f32(overshoot, vnegHalfW), out, zero));
+    }
+#endif
+    for (; t < n; t++)
+    {
+        float overshoot = tCompressor_log2(fmaxf(level[t], 0.000001f)) * COMPRESSOR_DB_PER_LOG2 - c->T;
+        float k = overshoot + halfW;
+        if (overshoot <= -halfW) level[t] = 0.0f;
+        else if (overshoot < halfW) level[t] = slope * ((k * k) * invTwoW);
+        else level[t] = slope * overshoot;
+    }
+}
+
+// gain[] holds the smoothed y_T coming in and linear gains going out
+static inline void tCompressor_gains(_tCompressor* const c, float* gain, int n)
+{
+    for (int t = 0; t < n; t++) gain[t] = c->M - gain[t];
+    LEAF_dbtoaBlock(gain, gain, n);
+}
+
+// Detects on the larger of detL and detR (if there is one) and applies the gain to inL and inR
+static void tCompressor_processBlock(_tCompressor* const c, const float* detL, const float* detR,
+                                     const float* inL, const float* inR, float* outL, float* outR, int size)
+{
+    float alphaAtt = expf(-1.0f/(0.001f * c->tauAttack * c->sampleRate));
+    float alphaRel = expf(-1.0f/(0.001f * c->tauRelease * c->sampleRate));
+    float* level = c->level;
+    float* gain = c->gain;
+
+    for (int offset = 0; offset < size; offset += COMPRESSOR_BLOCK)
+    {
+        int n = size - offset;
+        if (n > COMPRESSOR_BLOCK) n = COMPRESSOR_BLOCK;
+
+        for (int t = 0; t < n; t++) level[t] = fabsf(detL[offset + t]);
+        if (detR != NULL)
+            for (int t = 0; t < n; t++) level[t] = fmaxf(level[t], fabsf(detR[offset + t]));
+
+        tCompressor_gainComputer(c, level, n);
+
+        // The smoothing is the only serial part
+        float x = c->x_T[0];
+        float y = c->y_T[0], yPrev = c->y_T[1];
+        for (int t = 0; t < n; t++)
+        {
+            x = level[t];
+            yPrev = y;
+            if (x > y) y = alphaAtt * y + (1-alphaAtt) * x;
+            else y = alphaRel * y + (1-alphaRel) * x;
+            gain[t] = y;
+        }
+        c->x_T[0] = x;
+        c->y_T[0] = y;
+        c->y_T[1] = yPrev;
+        c->isActive = x != 0.0f;
+
+        tCompressor_gains(c, gain, n);
+
+        if (c->lookaheadSize > 0)
+        {
+            // The signal is delayed so the gain reacts to peaks before they reach the output
+            int pos = c->lookaheadPos, len = c->lookaheadSize;
+            float* bufL = c->lookahead;
+            float* bufR = c->lookahead + len;
+            for (int t = 0; t < n; t++)
+            {
+                float l = inL[offset + t];
+                outL[offset + t] = gain[t] * bufL[pos];
+                bufL[pos] = l;
+                if (inR != NULL)
+                {
+                    float r = inR[offset + t];
+                    outR[offset + t] = gain[t] * bufR[pos];
+                    bufR[pos] = r;
+                }
+                if (++pos >= len) pos = 0;
+            }
+            c->lookaheadPos = pos;
+        }
+        else
+        {
+            for (int t = 0; t < n; t++) outL[offset + t] = gain[t] * inL[offset + t];
+            if (inR != NULL)
+                for (int t = 0; t < n; t++) outR[offset + t] = gain[t] * inR[offset + t];
+        }
+    }
+}
+
+void tCompressor_tickBlock(tCompressor* const comp, const float* input, float* output, int size)
+{
+    LEAF_PROFILE_OBJECT(comp);
+    _tCompressor* c = *comp;
+    tCompressor_processBlock(c, input, NULL, input, NULL, output, NULL, size);
+}
+
+void tCompressor_tickSidechainBlock(tCompressor* const comp, const float* input, const float* sidechain, float* output, int size)
+{
+    LEAF_PROFILE_OBJECT(comp);
+    _tCompressor* c = *comp;
+    tCompressor_processBlock(c, sidechain, NULL, input, NULL, output, NULL, size);
+}
+
+void tCompressor_tickStereoBlock(tCompressor* const comp, const float* inL, const float* inR, float* outL, float* outR, int size)
+{
+    LEAF_PROFILE_OBJECT(comp);
+    _tCompressor* c = *comp;
+    tCompressor_processBlock(c, inL, inR, inL, inR, outL, outR, size);
+}
+
+void tCompressor_setLookahead(tCompressor* const comp, int samples)
+{
+    _tCompressor* c = *comp;
+
+    if (c->lookahead != NULL) mpool_free((char*)c->lookahead, c->mempool);
+    c->lookahead = NULL;
+    c->lookaheadSize = 0;
+    c->lookaheadPos = 0;
+
+    if (samples > 0)
+    {
+        c->lookahead = (float*) mpool_calloc(sizeof(float) * samples * 2, c->mempool);
+        c->lookaheadSize = samples;
+    }
+}
+
 /* Feedback Leveler */
 
 void tFeedbackLeveler_init (tFeedbackLeveler* const fb, float targetLevel, float factor, float strength, int mode, LEAF* const leaf)
@@ -131,6 +347,7 @@ void tFeedbackLeveler_init (tFeedbackLeveler* const fb, float targetLevel, float
 
 void tFeedbackLeveler_initToPool (tFeedbackLeveler* const fb, float targetLevel, float factor, float strength, int mode, tMempool* const mp)
 {
+    LEAF_PROFILE_POOL(mp);
     _tMempool* m = *mp;
     _tFeedbackLeveler* p = *fb = (_tFeedbackLeveler*) mpool_alloc(sizeof(_tFeedbackLeveler), m);
     p->mempool = m;
@@ -171,6 +388,7 @@ void     tFeedbackLeveler_setMode(tFeedbackLeveler* const fb, int mode)
 
 float   tFeedbackLeveler_tick(tFeedbackLeveler* const fb, float input)
 {
+    LEAF_PROFILE_OBJECT(fb);
     _tFeedbackLeveler* p = *fb;
     float levdiff=(tPowerFollower_tick(&p->pwrFlw, input)-p->targetLevel);
     if (p->mode==0 && levdiff<0.0f) levdiff=0.0f;
@@ -200,6 +418,7 @@ void tThreshold_init (tThreshold* const th, float low, float high, LEAF* const l
 
 void tThreshold_initToPool (tThreshold* const th, float low, float high, tMempool* const mp)
 {
+    LEAF_PROFILE_POOL(mp);
     _tMempool* m = *mp;
     _tThreshold* t = *th = (_tThreshold*) mpool_alloc(sizeof(_tThreshold), m);
     t->mempool = m;
@@ -219,6 +438,7 @@ void tThreshold_free (tThreshold* const th)
 
 int tThreshold_tick(tThreshold* const th, float in)
 {
+    LEAF_PROFILE_OBJECT(th);
     _tThreshold* t = *th;
 
     if (in >= t->highThresh)
@@ -246,3 +466,247 @@ void tThreshold_setHigh(tThreshold* const th, float high)
 
     t->highThresh = high;
 }
+
+//==============================================================================
+
+static void tLimiter_freeBuffers(_tLimiter* const l)
+{
+    mpool_free((char*)l->delay, l->mempool);
+    mpool_free((char*)l->peakValue, l->mempool);
+    mpool_free((char*)l->peakTime, l->mempool);
+    mpool_free((char*)l->gains, l->mempool);
+}
+
+static void tLimiter_allocBuffers(_tLimiter* const l)
+{
+    l->window = l->lookahead + l->truePeakDelay + 1;
+    l->delaySize = l->lookahead + l->truePeakDelay;
+    l->delay = (float*) mpool_calloc(sizeof(float) * l->delaySize * 2, l->mempool);
+    l->peakValue = (float*) mpool_calloc(sizeof(float) * l->window, l->mempool);
+    l->peakTime = (uint32_t*) mpool_calloc(sizeof(uint32_t) * l->window, l->mempool);
+    l->gains = (float*) mpool_calloc(sizeof(float) * l->lookahead, l->mempool);
+
+    for (int i = 0; i < l->lookahead; i++) l->gains[i] = 1.0f;
+    l->gainSum = l->lookahead;
+    l->gainPos = 0;
+    l->gain = 1.0f;
+    l->delayPos = 0;
+    l->peakFront = 0;
+    l->peakCount = 0;
+    l->time = 0;
+}
+
+void tLimiter_init (tLimiter* const lim, int lookahead, LEAF* const leaf)
+{
+    tLimiter_initToPool(lim, lookahead, &leaf->mempool);
+}
+
+void tLimiter_initToPool (tLimiter* const lim, int lookahead, tMempool* const mp)
+{
+    LEAF_PROFILE_POOL(mp);
+    _tMempool* m = *mp;
+    _tLimiter* l = *lim = (_tLimiter*) mpool_alloc(sizeof(_tLimiter), m);
+    l->mempool = m;
+    LEAF* leaf = l->mempool->leaf;
+
+    l->sampleRate = leaf->sampleRate;
+    l->ceiling = 1.0f;
+    tLimiter_setRelease(lim, 50.0f);
+
+    l->lookahead = lookahead < 1 ? 1 : lookahead;
+    l->truePeakDelay = 0;
+    l->ratio = 1;
+    l->oversampled = NULL;
+    tLimiter_allocBuffers(l);
+}
+
+void tLimiter_free (tLimiter* const lim)
+{
+    _tLimiter* l = *lim;
+
+    tLimiter_setTruePeak(lim, 1);
+    tLimiter_freeBuffers(l);
+    mpool_free((char*)l, l->mempool);
+}
+
+// Takes the detector level for the newest sample and returns the gain for the sample leaving the delay
+static inline float tLimiter_nextGain(_tLimiter* const l, float peak)
+{
+    int window = l->window;
+    uint32_t now = l->time++;
+
+    // Drop the oldest peak if it has left the window, then the queued peaks the new one hides
+    if (l->peakCount > 0 && now - l->peakTime[l->peakFront] >= (uint32_t)window)
+    {
+        if (++l->peakFront >= window) l->peakFront = 0;
+        l->peakCount--;
+    }
+    int back = l->peakFront + l->peakCount - 1;
+    if (back >= window) back -= window;
+    while (l->peakCount > 0 && l->peakValue[back] <= peak)
+    {
+        l->peakCount--;
+        if (--back < 0) back = window - 1;
+    }
+    if (++back >= window) back = 0;
+    l->peakValue[back] = peak;
+    l->peakTime[back] = now;
+    l->peakCount++;
+    peak = l->peakValue[l->peakFront];
+
+    // The lowest gain needed in the window, released smoothly upward
+    float target = peak > l->ceiling ? l->ceiling / peak : 1.0f;
+    float g = l->gain;
+    if (target < g) g = target;
+    else g = target + l->releaseCoeff * (g - target);
+    l->gain = g;
+
+    // Average over the look-ahead so the gain ramps down ahead of each peak
+    l->gainSum += g - l->gains[l->gainPos];
+    l->gains[l->gainPos] = g;
+    if (++l->gainPos >= l->lookahead)
+    {
+        // Resum once per lap so rounding can't build up and push the gain over the ceiling
+        double sum = 0.0;
+        for (int i = 0; i < l->lookahead; i++) sum += l->gains[i];
+        l->gainSum = sum;
+        l->gainPos = 0;
+    }
+
+    return (float)(l->gainSum / l->lookahead);
+}
+
+// Delays the input, optionally oversamples the detector and applies the gain
+static void tLimiter_processBlock(_tLimiter* const l, const float* inL, const float* inR,
+                                  float* outL, float* outR, int size)
+{
+    float* delayL = l->delay;
+    float* delayR = l->delay + l->delaySize;
+    int ratio = l->ratio;
+
+    for (int offset = 0; offset < size; offset += LIMITER_BLOCK)
+    {
+        int n = size - offset;
+        if (n > LIMITER_BLOCK) n = LIMITER_BLOCK;
+        const float* xL = inL + offset;
+        const float* xR = inR != NULL ? inR + offset : NULL;
+
+#if LEAF_INCLUDE_OVERSAMPLER_TABLES
+        if (ratio > 1)
+        {
+            tOversampler_upsampleBlock(&l->oversampler[0], xL, l->oversampled, n);
+            if (xR != NULL)
+                tOversampler_upsampleBlock(&l->oversampler[1], xR, l->oversampled + LIMITER_BLOCK * ratio, n);
+        }
+#endif
+
+        for (int t = 0; t < n; t++)
+        {
+            float peak = fabsf(xL[t]);
+            if (xR != NULL) peak = fmaxf(peak, fabsf(xR[t]));
+            if (ratio > 1)
+            {
+                const float* os = l->oversampled + t * ratio;
+                for (int r = 0; r < ratio; r++) peak = fmaxf(peak, fabsf(os[r]));
+                if (xR != NULL)
+                {
+                    os += LIMITER_BLOCK * ratio;
+                    for (int r = 0; r < ratio; r++) peak = fmaxf(peak, fabsf(os[r]));
+                }
+            }
+
+            float g = tLimiter_nextGain(l, peak);
+
+            int pos = l->delayPos;
+            float left = xL[t];
+            outL[offset + t] = g * delayL[pos];
+            delayL[pos] = left;
+            if (xR != NULL)
+            {
+                float right = xR[t];
+                outR[offset + t] = g * delayR[pos];
+                delayR[pos] = right;
+            }
+            if (++pos >= l->delaySize) pos = 0;
+            l->delayPos = pos;
+        }
+    }
+}
+
+float tLimiter_tick (tLimiter* const lim, float input)
+{
+    LEAF_PROFILE_OBJECT(lim);
+    _tLimiter* l = *lim;
+    float output;
+    tLimiter_processBlock(l, &input, NULL, &output, NULL, 1);
+    return output;
+}
+
+void tLimiter_tickBlock (tLimiter* const lim, const float* input, float* output, int size)
+{
+    LEAF_PROFILE_OBJECT(lim);
+    _tLimiter* l = *lim;
+    tLimiter_processBlock(l, input, NULL, output, NULL, size);
+}
+
+void tLimiter_tickStereoBlock (tLimiter* const lim, const float* inL, const float* inR, float* outL, float* outR, int size)
+{
+    LEAF_PROFILE_OBJECT(lim);
+    _tLimiter* l = *lim;
+    tLimiter_processBlock(l, inL, inR, outL, outR, size);
+}
+
+void tLimiter_setCeiling (tLimiter* const lim, float ceiling)
+{
+    _tLimiter* l = *lim;
+    l->ceiling = ceiling;
+}
+
+void tLimiter_setRelease (tLimiter* const lim, float release)
+{
+    _tLimiter* l = *lim;
+    l->release = release;
+    l->releaseCoeff = release > 0.0f ? expf(-1.0f / (0.001f * release * l->sampleRate)) : 0.0f;
+}
+
+void tLimiter_setTruePeak (tLimiter* const lim, int ratio)
+{
+    _tLimiter* l = *lim;
+
+    // tOversampler only takes powers of two up to 64
+    if (ratio < 2 || ratio > 64 || (ratio & (ratio - 1)) != 0) ratio = 1;
+#if !LEAF_INCLUDE_OVERSAMPLER_TABLES
+    ratio = 1;
+#endif
+    if (ratio == l->ratio) return;
+
+#if LEAF_INCLUDE_OVERSAMPLER_TABLES
+    if (l->ratio > 1)
+    {
+        tOversampler_free(&l->oversampler[0]);
+        tOversampler_free(&l->oversampler[1]);
+        mpool_free((char*)l->oversampled, l->mempool);
+        l->oversampled = NULL;
+    }
+
+    l->truePeakDelay = 0;
+    if (ratio > 1)
+    {
+        tOversampler_initToPool(&l->oversampler[0], ratio, 1, &l->mempool);
+        tOversampler_initToPool(&l->oversampler[1], ratio, 1, &l->mempool);
+        l->oversampled = (float*) mpool_calloc(sizeof(float) * LIMITER_BLOCK * ratio * 2, l->mempool);
+        // The high quality filters are linear phase, so the oversampled peaks lag the input by half their length
+        l->truePeakDelay = (tOversampler_getLatency(&l->oversampler[0]) + 1) / 2;
+    }
+#endif
+    l->ratio = ratio;
+
+    tLimiter_freeBuffers(l);
+    tLimiter_allocBuffers(l);
+}
+
+int tLimiter_getLatency (tLimiter* const lim)
+{
+    _tLimiter* l = *lim;
+    return l->lookahead + l->truePeakDelay;
+}
@@ -1,5 +1,5 @@
 /*==============================================================================
- 
+
  leaf-vocoder.c
  Created: 20 Jan 2017 12:01:54pm
  Author:  Michael R Mulshine
@@ -18,6 +18,16 @@
 
 #endif
 
+#if LEAF_USE_SIMD
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define LEAF_SIMD_NEON 1
+#elif defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define LEAF_SIMD_SSE 1
+#endif
+#endif
+
 
 
 //============================================================================================================
@@ -32,6 +42,8 @@
 // -JS
 
 
+static void tTalkbox_resetAnalysis(_tTalkbox* const v, int s, int32_t count);
+
 void tTalkbox_init (tTalkbox* const voc, int bufsize, LEAF* const leaf)
 {
     tTalkbox_initToPool(voc, bufsize, &leaf->mempool);
@@ -39,6 +51,7 @@ void tTalkbox_init (tTalkbox* const voc, int bufsize, LEAF* const leaf)
 
 void tTalkbox_initToPool (tTalkbox* const voc, int bufsize, tMempool* const mp)
 {
+    LEAF_PROFILE_POOL(mp);
     _tMempool* m = *mp;
     _tTalkbox* v = *voc = (_tTalkbox*) mpool_alloc(sizeof(_tTalkbox), m);
     v->mempool = m;
@@ -61,11 +74,17 @@ void tTalkbox_initToPool (tTalkbox* const voc, int bufsize, tMempool* const mp)
     
     v->dl = (double*) mpool_alloc(sizeof(double) * v->bufsize, m);
     v->Rt = (double*) mpool_alloc(sizeof(double) * v->bufsize, m);
-
+    
     v->k = (float*) mpool_alloc(sizeof(float) * ORD_MAX, m);
+    v->synthK = (float*) mpool_alloc(sizeof(float) * ORD_MAX * 2, m);
+    v->synthZ = (float*) mpool_alloc(sizeof(float) * ORD_MAX * 2, m);
+    v->acR = (float*) mpool_alloc(sizeof(float) * ORD_MAX * 2, m);
+    v->acRt = (double*) mpool_alloc(sizeof(double) * ORD_MAX * 2, m);
+    v->acR1 = (double*) mpool_alloc(sizeof(double) * ORD_MAX * 2, m);
+    v->acR2 = (double*) mpool_alloc(sizeof(double) * ORD_MAX * 2, m);
     
     v->sampleRate = leaf->sampleRate;
-
+    
     tTalkbox_update(voc);
     tTalkbox_suspend(voc);
 }
@@ -83,6 +102,12 @@ void tTalkbox_free (tTalkbox* const voc)
     mpool_free((char*)v->dl, v->mempool);
     mpool_free((char*)v->Rt, v->mempool);
     mpool_free((char*)v->k, v->mempool);
+    mpool_free((char*)v->synthK, v->mempool);
+    mpool_free((char*)v->synthZ, v->mempool);
+    mpool_free((char*)v->acR, v->mempool);
+    mpool_free((char*)v->acRt, v->mempool);
+    mpool_free((char*)v->acR1, v->mempool);
+    mpool_free((char*)v->acR2, v->mempool);
     mpool_free((char*)v, v->mempool);
 }
 
@@ -93,7 +118,7 @@ void tTalkbox_update(tTalkbox* const voc) ///update internal parameters...
     float fs = v->sampleRate;
 //    if(fs <  8000.0f) fs =  8000.0f;
 //    if(fs > 96000.0f) fs = 96000.0f;
-    
+
     int32_t n = (int32_t)(0.01633f * fs); //this sets the window time to 16ms if the buffer is large enough. Buffer needs to be at least 784 samples at 48000
     if(n > v->bufsize) n = v->bufsize;
     
@@ -130,6 +155,13 @@ void tTalkbox_suspend(tTalkbox* const voc) ///clear any buffers...
     v->u0 = v->u1 = v->u2 = v->u3 = v->u4 = 0.0f;
     v->d0 = v->d1 = v->d2 = v->d3 = v->d4 = 0.0f;
     
+    v->synthO[0] = v->synthO[1] = -1;
+    for (int32_t i = 0; i < ORD_MAX * 2; i++) v->synthZ[i] = 0.0f;
+    
+    //the second frame starts half way in, after samples that are all zero
+    tTalkbox_resetAnalysis(v, 0, 0);
+    tTalkbox_resetAnalysis(v, 1, v->N / 2);
+    
     for (int32_t i = 0; i < v->bufsize; i++)
     {
         v->buf0[i] = 0;
@@ -153,7 +185,7 @@ void tTalkbox_warpedAutocorrelate(float * x, double* dl, double* Rt, unsigned in
     for(uint32_t m=0; m<L;m++)
     {
                     Rt[0] += (double)(x[m]) * (double)(x[m]);
-
+                    
                     dl[m]= r1 - (double)(lambda) * (double)(x[m]-r2);
                     r1 = x[m];
                     r2 = dl[m];
@@ -166,7 +198,7 @@ void tTalkbox_warpedAutocorrelate(float * x, double* dl, double* Rt, unsigned in
             for(unsigned int m=0; m<L;m++)
             {
                     Rt[i] += (double) (dl[m]) * (double)(x[m]);
-
+                    
                     r1t = dl[m];
                     dl[m]= r1 - (double)(lambda) * (double)(r1t-r2);
                     r1 = r1t;
@@ -177,14 +209,14 @@ void tTalkbox_warpedAutocorrelate(float * x, double* dl, double* Rt, unsigned in
     {
             R[i]=(float)(Rt[i]);
     }
-
+    
 }
 
 void tTalkbox_lpcDurbin(float *r, int p, float *k, float *g)
 {
     int i, j;
     float a[ORD_MAX], at[ORD_MAX], e=r[0];
-
+    
     for(i=0; i<=p; i++)
     {
         a[i] = 0.0f; //probably don't need to clear at[] or k[]
@@ -194,7 +226,7 @@ void tTalkbox_lpcDurbin(float *r, int p, float *k, float *g)
     for(i=1; i<=p; i++)
     {
         k[i] = -r[i];
-
+        
         for(j=1; j<i; j++)
         {
             at[j] = a[j];
@@ -202,19 +234,181 @@ void tTalkbox_lpcDurbin(float *r, int p, float *k, float *g)
         }
         if(fabs(e) < 1.0e-20f) { e = 0.0f;  break; }
         k[i] /= e;
-
+        
         a[i] = k[i];
         for(j=1; j<i; j++) a[j] = at[j] + k[i] * at[i-j];
-
+        
         e *= 1.0f - k[i] * k[i];
     }
-
+    
     if(e < 1.0e-20f) e = 0.0f;
     *g = sqrtf(e);
 }
 
+//turns the autocorrelation r[] into reflection coefficients and gain, or returns 0 if it's too quiet to use
+static int tTalkbox_lpcSolve(float *r, int32_t o, float *k, int freeze, float *G)
+{
+    int32_t i;
+    
+    r[0] *= 1.001f;  //stability fix
+    
+    float min = 0.000001f;
+    if (!freeze)
+    {
+        if(r[0] < min)
+        {
+            return 0;
+        }
+        
+        tTalkbox_lpcDurbin(r, o, k, G);  //calc reflection coeffs
+        
+        //this is for stability to keep reflection coefficients inside the unit circle
+        //in mda's code it's .995 but in Harma's papers I've seen 0.998.  just needs to be less than 1 it seems but maybe some wiggle room to avoid instability from floating point precision -JS
+        for(i=0; i<=o; i++)
+        {
+            if(k[i] > 0.998f) k[i] = 0.998f; else if(k[i] < -0.998f) k[i] = -.998f;
+        }
+    }
+    return 1;
+}
+
+//finds the reflection coefficients and gain for buf[], or returns 0 if it's too quiet to analyse
+static int tTalkbox_lpcAnalyse(float *buf, double* dl, double* Rt, int32_t n, int32_t o, float warp, int warpOn, float *k, int freeze, float *G)
+{
+    float r[ORD_MAX];
+    int32_t i, j, nn=n;
+    
+    if (warpOn == 0)
+    {
+        for(j=0; j<=o; j++, nn--)  //buf[] is already emphasized and windowed
+        {
+            r[j] = 0.0f;
+            for(i=0; i<nn; i++) r[j] += buf[i] * buf[i+j]; //autocorrelation
+        }
+    }
+    else
+    {
+        for(j=0; j<=o; j++, nn--)  //buf[] is already emphasized and windowed
+        {
+            r[j] = 0.0f;
+        }
+        tTalkbox_warpedAutocorrelate(buf, dl, Rt, n, r, o, warp);
+    }
+    
+    return tTalkbox_lpcSolve(r, o, k, freeze, G);
+}
+
+//starts accumulating the autocorrelation of frame s over again, count samples in
+static void tTalkbox_resetAnalysis(_tTalkbox* const v, int s, int32_t count)
+{
+    v->acN[s] = v->N;
+    v->acO[s] = v->O;
+    v->acWarpOn[s] = v->warpOn;
+    v->acWarp[s] = v->warpFactor;
+    v->acCount[s] = count;
+    
+    float* r = v->acR + s * ORD_MAX;
+    double* Rt = v->acRt + s * ORD_MAX;
+    double* r1 = v->acR1 + s * ORD_MAX;
+    double* r2 = v->acR2 + s * ORD_MAX;
+    for (int32_t j = 0; j < ORD_MAX; j++)
+    {
+        r[j] = 0.0f;
+        Rt[j] = r1[j] = r2[j] = 0;
+    }
+}
+
+//adds the terms of the autocorrelation of frame s that buf[p] completes, in the same order
+//and with the same arithmetic as the whole-buffer versions
+static inline void tTalkbox_accumulate(_tTalkbox* const v, int s, float* buf, int32_t p)
+{
+    float x = buf[p];
+    int32_t o = v->acO[s];
+    
+    if (v->acWarpOn[s] == 0)
+    {
+        float* r = v->acR + s * ORD_MAX;
+        int32_t last = p < o ? p : o;
+        for(int32_t j=0; j<=last; j++) r[j] += buf[p-j] * x;
+    }
+    else
+    {
+        double* Rt = v->acRt + s * ORD_MAX;
+        double* r1 = v->acR1 + s * ORD_MAX;
+        double* r2 = v->acR2 + s * ORD_MAX;
+        double lambda = (double)(v->acWarp[s]);
+        
+        double d = r1[0] - lambda * (double)(x-r2[0]);
+        Rt[0] += (double)(x) * (double)(x);
+        r1[0] = x;
+        r2[0] = d;
+        for(int32_t i=1; i<=o; i++)
+        {
+            Rt[i] += d * (double)(x);
+            double dn = r1[i] - lambda * (double)(d-r2[i]);
+            r1[i] = d;
+            r2[i] = dn;
+            d = dn;
+        }
+    }
+    v->acCount[s]++;
+}
+
+
+//resynthesizes one carrier sample of frame s through the lattice filter from its last analysis
+static inline float tTalkbox_synthesize(_tTalkbox* const v, int s, float car)
+{
+    int32_t o = v->synthO[s];
+    if (o < 0) return 0.0f;
+    
+    float* k = v->synthK + s * ORD_MAX;
+    float* z = v->synthZ + s * ORD_MAX;
+    float x = v->synthG[s] * car;
+    for(int32_t j=o; j>0; j--)  //lattice filter
+    {
+        x -= k[j] * z[j-1];
+        z[j] = z[j-1] + k[j] * x;
+    }
+    z[0] = x;
+    return x;
+}
+
+//analyses the frame that just filled and sets it up to be resynthesized over the next one
+static void tTalkbox_startFrame(_tTalkbox* const v, int s)
+{
+    float* buf = s ? v->buf1 : v->buf0;
+    int voiced;
+    
+    if (v->acCount[s] == v->N && v->acN[s] == v->N && v->acO[s] == v->O &&
+        v->acWarpOn[s] == v->warpOn && v->acWarp[s] == v->warpFactor)
+    {
+        float r[ORD_MAX];
+        for (int32_t j = 0; j <= v->O; j++)
+            r[j] = (v->warpOn == 0) ? v->acR[s * ORD_MAX + j] : (float)(v->acRt[s * ORD_MAX + j]);
+        voiced = tTalkbox_lpcSolve(r, v->O, v->k, v->freeze, &v->G);
+    }
+    //the settings changed partway through the frame, so analyse it all at once
+    else voiced = tTalkbox_lpcAnalyse(buf, v->dl, v->Rt, v->N, v->O, v->warpFactor, v->warpOn, v->k, v->freeze, &v->G);
+    tTalkbox_resetAnalysis(v, s, 0);
+    
+    if (voiced)
+    {
+        float* k = v->synthK + s * ORD_MAX;
+        float* z = v->synthZ + s * ORD_MAX;
+        for (int32_t j = 0; j <= v->O; j++)
+        {
+            k[j] = v->k[j];
+            z[j] = 0.0f;
+        }
+        v->synthG[s] = v->G;
+        v->synthO[s] = v->O;
+    }
+    else v->synthO[s] = -1;
+}
+
 float tTalkbox_tick(tTalkbox* const voc, float synth, float voice)
 {
+    LEAF_PROFILE_OBJECT(voc);
     _tTalkbox* v = *voc;
     
     int32_t  p0=v->pos, p1 = (v->pos + v->N/2) % v->N;
@@ -224,8 +418,8 @@ float tTalkbox_tick(tTalkbox* const voc, float synth, float voice)
     o = voice;
     x = synth;
     
-
-
+    
+    
     p = v->d0 + h0 *  x; v->d0 = v->d1;  v->d1 = x  - h0 * p;
     q = v->d2 + h1 * v->d4; v->d2 = v->d3;  v->d3 = v->d4 - h1 * q;
     v->d4 = x;
@@ -235,15 +429,21 @@ float tTalkbox_tick(tTalkbox* const voc, float synth, float voice)
     {
         v->K = 0;
         
+        //each frame's autocorrelation is accumulated as it fills and its carrier goes through
+        //the lattice a sample at a time as it's replaced, so the end of a frame only solves for k
+        float y0 = tTalkbox_synthesize(v, 0, v->car0[p0]);
+        float y1 = tTalkbox_synthesize(v, 1, v->car1[p1]);
         v->car0[p0] = v->car1[p1] = x; //carrier input
         
         x = o - e;  e = o;  //6dB/oct pre-emphasis
         
-        w = v->window[p0]; fx = v->buf0[p0] * w;  v->buf0[p0] = x * w;  //50% overlapping hanning windows
-        if(++p0 >= v->N) { tTalkbox_lpc(v->buf0, v->car0, v->dl, v->Rt, v->N, v->O, v->warpFactor, v->warpOn, v->k, v->freeze, &v->G);  p0 = 0; }
+        w = v->window[p0]; fx = y0 * w;  v->buf0[p0] = x * w;  //50% overlapping hanning windows
+        tTalkbox_accumulate(v, 0, v->buf0, p0);
+        if(++p0 >= v->N) { tTalkbox_startFrame(v, 0);  p0 = 0; }
         
-        w = 1.0f - w;  fx += v->buf1[p1] * w;  v->buf1[p1] = x * w;
-        if(++p1 >= v->N) { tTalkbox_lpc(v->buf1, v->car1, v->dl, v->Rt, v->N, v->O, v->warpFactor, v->warpOn, v->k, v->freeze, &v->G);  p1 = 0; }
+        w = 1.0f - w;  fx += y1 * w;  v->buf1[p1] = x * w;
+        tTalkbox_accumulate(v, 1, v->buf1, p1);
+        if(++p1 >= v->N) { tTalkbox_startFrame(v, 1);  p1 = 0; }
     }
     
     p = v->u0 + h0 * fx; v->u0 = v->u1;  v->u1 = fx - h0 * p;
@@ -257,39 +457,17 @@ float tTalkbox_tick(tTalkbox* const voc, float synth, float voice)
     v->pos = p0;
     v->FX = fx;
     
-
+    
     return o;
 }
 
 
 void tTalkbox_lpc(float *buf, float *car, double* dl, double* Rt, int32_t n, int32_t o, float warp, int warpOn, float *k, int freeze, float *G)
 {
-    float z[ORD_MAX], r[ORD_MAX], x;
-    int32_t i, j, nn=n;
-
-    if (warpOn == 0)
-    {
-        for(j=0; j<=o; j++, nn--)  //buf[] is already emphasized and windowed
-        {
-            z[j] = r[j] = 0.0f;
-            for(i=0; i<nn; i++) r[j] += buf[i] * buf[i+j]; //autocorrelation
-        }
-    }
-    else
-    {
-        for(j=0; j<=o; j++, nn--)  //buf[] is already emphasized and windowed
-        {
-            z[j] = r[j] = 0.0f;
-        }
-        tTalkbox_warpedAutocorrelate(buf, dl, Rt, n, r, o, warp);
-    }
-
-    r[0] *= 1.001f;  //stability fix
-
-    float min = 0.000001f;
-    if (!freeze)
-    {
-        if(r[0] < min)
+    float z[ORD_MAX], x;
+    int32_t i, j;
+    
+    if (!tTalkbox_lpcAnalyse(buf, dl, Rt, n, o, warp, warpOn, k, freeze, G))
         {
             for(i=0; i<n; i++)
             {
@@ -297,16 +475,7 @@ void tTalkbox_lpc(float *buf, float *car, double* dl, double* Rt, int32_t n, int
             }
             return;
         }
-
-        tTalkbox_lpcDurbin(r, o, k, G);  //calc reflection coeffs
-
-        //this is for stability to keep reflection coefficients inside the unit circle
-        //in mda's code it's .995 but in Harma's papers I've seen 0.998.  just needs to be less than 1 it seems but maybe some wiggle room to avoid instability from floating point precision -JS
-        for(i=0; i<=o; i++)
-        {
-            if(k[i] > 0.998f) k[i] = 0.998f; else if(k[i] < -0.998f) k[i] = -.998f;
-        }
-    }
+    for(j=0; j<=o; j++) z[j] = 0.0f;
     for(i=0; i<n; i++)
     {
         x = G[0] * car[i];
@@ -334,21 +503,21 @@ void tTalkbox_setQuality(tTalkbox* const voc, float quality)
 void tTalkbox_setWarpFactor(tTalkbox* const voc, float warpFactor)
 {
     _tTalkbox* v = *voc;
-
+    
     v->warpFactor = warpFactor;
 }
 
 void tTalkbox_setWarpOn(tTalkbox* const voc, float warpOn)
 {
     _tTalkbox* v = *voc;
-
+    
     v->warpOn = warpOn;
 }
 
 void tTalkbox_setFreeze(tTalkbox* const voc, float freeze)
 {
     _tTalkbox* v = *voc;
-
+    
     v->freeze = freeze;
 }
 
@@ -370,6 +539,8 @@ void tTalkbox_setSampleRate(tTalkbox* const voc, float sr)
 // -JS
 
 
+static void tTalkboxFloat_resetAnalysis(_tTalkboxFloat* const v, int s, int32_t count);
+
 void tTalkboxFloat_init (tTalkboxFloat* const voc, int bufsize, LEAF* const leaf)
 {
     tTalkboxFloat_initToPool(voc, bufsize, &leaf->mempool);
@@ -377,11 +548,12 @@ void tTalkboxFloat_init (tTalkboxFloat* const voc, int bufsize, LEAF* const leaf
 
 void tTalkboxFloat_initToPool (tTalkboxFloat* const voc, int bufsize, tMempool* const mp)
 {
+    LEAF_PROFILE_POOL(mp);
     _tMempool* m = *mp;
     _tTalkboxFloat* v = *voc = (_tTalkboxFloat*) mpool_alloc(sizeof(_tTalkboxFloat), m);
     v->mempool = m;
     LEAF* leaf = v->mempool->leaf;
-
+    
     v->param[0] = 0.5f;  //wet
     v->param[1] = 0.0f;  //dry
     v->param[2] = 0; // Swap
@@ -396,14 +568,20 @@ void tTalkboxFloat_initToPool (tTalkboxFloat* const voc, int bufsize, tMempool*
     v->window = (float*) mpool_alloc(sizeof(float) * v->bufsize, m);
     v->buf0 =   (float*) mpool_alloc(sizeof(float) * v->bufsize, m);
     v->buf1 =   (float*) mpool_alloc(sizeof(float) * v->bufsize, m);
-
+    
     v->dl = (float*) mpool_alloc(sizeof(float) * v->bufsize, m);
     v->Rt = (float*) mpool_alloc(sizeof(float) * v->bufsize, m);
-
+    
     v->k = (float*) mpool_alloc(sizeof(float) * ORD_MAX, m);
+    v->synthK = (float*) mpool_alloc(sizeof(float) * ORD_MAX * 2, m);
+    v->synthZ = (float*) mpool_alloc(sizeof(float) * ORD_MAX * 2, m);
+    v->acR = (float*) mpool_alloc(sizeof(float) * ORD_MAX * 2, m);
+    v->acRt = (float*) mpool_alloc(sizeof(float) * ORD_MAX * 2, m);
+    v->acR1 = (float*) mpool_alloc(sizeof(float) * ORD_MAX * 2, m);
+    v->acR2 = (float*) mpool_alloc(sizeof(float) * ORD_MAX * 2, m);
     
     v->sampleRate = leaf->sampleRate;
-
+    
     tTalkboxFloat_update(voc);
     tTalkboxFloat_suspend(voc);
 }
@@ -411,16 +589,22 @@ void tTalkboxFloat_initToPool (tTalkboxFloat* const voc, int bufsize, tMempool*
 void tTalkboxFloat_free (tTalkboxFloat* const voc)
 {
     _tTalkboxFloat* v = *voc;
-
+    
     mpool_free((char*)v->buf1, v->mempool);
     mpool_free((char*)v->buf0, v->mempool);
     mpool_free((char*)v->window, v->mempool);
     mpool_free((char*)v->car1, v->mempool);
     mpool_free((char*)v->car0, v->mempool);
-
+    
     mpool_free((char*)v->dl, v->mempool);
     mpool_free((char*)v->Rt, v->mempool);
     mpool_free((char*)v->k, v->mempool);
+    mpool_free((char*)v->synthK, v->mempool);
+    mpool_free((char*)v->synthZ, v->mempool);
+    mpool_free((char*)v->acR, v->mempool);
+    mpool_free((char*)v->acRt, v->mempool);
+    mpool_free((char*)v->acR1, v->mempool);
+    mpool_free((char*)v->acR2, v->mempool);
     mpool_free((char*)v, v->mempool);
 }
 
@@ -434,14 +618,14 @@ void tTalkboxFloat_update(tTalkboxFloat* const voc) ///update internal parameter
 
     int32_t n = (int32_t)(0.01633f * fs); //this sets the window time to 16ms if the buffer is large enough. Buffer needs to be at least 784 samples at 48000
     if(n > v->bufsize) n = v->bufsize;
-
+    
     //O = (VstInt32)(0.0005f * fs);
     v->O = (int32_t)((0.0001f + 0.0004f * v->param[3]) * fs);
     if (v->O >= ORD_MAX)
     {
         v->O = ORD_MAX-1;
     }
-
+    
     if(n != v->N) //recalc hanning window
     {
         v->N = n;
@@ -460,14 +644,21 @@ void tTalkboxFloat_update(tTalkboxFloat* const voc) ///update internal parameter
 void tTalkboxFloat_suspend(tTalkboxFloat* const voc) ///clear any buffers...
 {
     _tTalkboxFloat* v = *voc;
-
+    
     v->pos = v->K = 0;
     v->emphasis = 0.0f;
     v->FX = 0;
-
+    
     v->u0 = v->u1 = v->u2 = v->u3 = v->u4 = 0.0f;
     v->d0 = v->d1 = v->d2 = v->d3 = v->d4 = 0.0f;
-
+    
+    v->synthO[0] = v->synthO[1] = -1;
+    for (int32_t i = 0; i < ORD_MAX * 2; i++) v->synthZ[i] = 0.0f;
+    
+    //the second frame starts half way in, after samples that are all zero
+    tTalkboxFloat_resetAnalysis(v, 0, 0);
+    tTalkboxFloat_resetAnalysis(v, 1, v->N / 2);
+    
     for (int32_t i = 0; i < v->bufsize; i++)
     {
         v->buf0[i] = 0;
@@ -491,7 +682,7 @@ void tTalkboxFloat_warpedAutocorrelate(float * x, float* dl, float* Rt, unsigned
     for(uint32_t m=0; m<L;m++)
     {
                     Rt[0] += (x[m]) * (x[m]);
-
+                    
                     dl[m]= r1 - lambda * (x[m]-r2);
                     r1 = x[m];
                     r2 = dl[m];
@@ -504,7 +695,7 @@ void tTalkboxFloat_warpedAutocorrelate(float * x, float* dl, float* Rt, unsigned
             for(unsigned int m=0; m<L;m++)
             {
                     Rt[i] +=  (dl[m]) * (x[m]);
-
+                    
                     r1t = dl[m];
                     dl[m]= r1 - lambda * (r1t-r2);
                     r1 = r1t;
@@ -515,25 +706,25 @@ void tTalkboxFloat_warpedAutocorrelate(float * x, float* dl, float* Rt, unsigned
     {
             R[i]=Rt[i];
     }
-
+    
 }
 
 void tTalkboxFloat_lpcDurbin(float *r, int p, float *k, float *g)
 {
     int i, j;
     float a[ORD_MAX], at[ORD_MAX], e=r[0];
-
+    
     for(i=0; i<=p; i++)
     {
         a[i] = 0.0f; //probably don't need to clear at[]
-
+        
     }
     k[0] = 0.0f;
     at[0] = 0.0f;
     for(i=1; i<=p; i++)
     {
         k[i] = -r[i];
-
+        
         for(j=1; j<i; j++)
         {
             at[j] = a[j];
@@ -541,114 +732,246 @@ void tTalkboxFloat_lpcDurbin(float *r, int p, float *k, float *g)
         }
         if(fabs(e) < 1.0e-20f) { e = 0.0f;  break; }
         k[i] /= e;
-
+        
         a[i] = k[i];
         for(j=1; j<i; j++) a[j] = at[j] + k[i] * at[i-j];
-
+        
         e *= 1.0f - k[i] * k[i];
     }
-
+    
     if(e < 1.0e-20f) e = 0.0f;
     *g = sqrtf(e);
 }
 
+//turns the autocorrelation r[] into reflection coefficients and gain, or returns 0 if it's too quiet to use
+static int tTalkboxFloat_lpcSolve(float *r, int32_t o, float *k, int freeze, float *G)
+{
+    r[0] *= 1.001f;  //stability fix
+    
+    float min = 0.000001f;
+    if (!freeze)
+    {
+        if(r[0] < min)
+        {
+            return 0;
+        }
+        
+        tTalkbox_lpcDurbin(r, o, k, G);  //calc reflection coeffs
+        
+        //this is for stability to keep reflection coefficients inside the unit circle
+        //but in Harma's papers I've seen 0.998.  just needs to be less than 1 it seems but maybe some wiggle room to avoid instability from floating point precision -JS
+        for(int i = 0; i <= o; i++)
+        {
+            if(k[i] > 0.998f) k[i] = 0.998f; else if(k[i] < -0.998f) k[i] = -.998f;
+        }
+    }
+    return 1;
+}
+
+//finds the reflection coefficients and gain for buf[], or returns 0 if it's too quiet to analyse
+static int tTalkboxFloat_lpcAnalyse(float *buf, float* dl, float* Rt, int32_t n, int32_t o, float warp, int warpOn, float *k, int freeze, float *G)
+{
+    float r[ORD_MAX];
+    
+    if (warpOn == 0)
+    {
+        int nn = n;
+        for(int j = 0; j <= o; j++, nn--)  //buf[] is already emphasized and windowed
+        {
+            r[j] = 0.0f;
+            for(int i = 0; i < nn; i++) r[j] += buf[i] * buf[i+j]; //autocorrelation
+        }
+    }
+    else
+    {
+        int nn = n;
+        for(int j = 0; j <= o; j++, nn--)  //buf[] is already emphasized and windowed
+        {
+            r[j] = 0.0f;
+        }
+        tTalkboxFloat_warpedAutocorrelate(buf, dl, Rt, n, r, o, warp);
+    }
+    
+    return tTalkboxFloat_lpcSolve(r, o, k, freeze, G);
+}
+
+//starts accumulating the autocorrelation of frame s over again, count samples in
+static void tTalkboxFloat_resetAnalysis(_tTalkboxFloat* const v, int s, int32_t count)
+{
+    v->acN[s] = v->N;
+    v->acO[s] = v->O;
+    v->acWarpOn[s] = v->warpOn;
+    v->acWarp[s] = v->warpFactor;
+    v->acCount[s] = count;
+    
+    float* r = v->acR + s * ORD_MAX;
+    float* Rt = v->acRt + s * ORD_MAX;
+    float* r1 = v->acR1 + s * ORD_MAX;
+    float* r2 = v->acR2 + s * ORD_MAX;
+    for (int32_t j = 0; j < ORD_MAX; j++)
+    {
+        r[j] = 0.0f;
+        Rt[j] = r1[j] = r2[j] = 0;
+    }
+}
+
+//adds the terms of the autocorrelation of frame s that buf[p] completes, in the same order
+//and with the same arithmetic as the whole-buffer versions
+static inline void tTalkboxFloat_accumulate(_tTalkboxFloat* const v, int s, float* buf, int32_t p)
+{
+    float x = buf[p];
+    int32_t o = v->acO[s];
+    
+    if (v->acWarpOn[s] == 0)
+    {
+        float* r = v->acR + s * ORD_MAX;
+        int32_t last = p < o ? p : o;
+        for(int32_t j=0; j<=last; j++) r[j] += buf[p-j] * x;
+    }
+    else
+    {
+        float* Rt = v->acRt + s * ORD_MAX;
+        float* r1 = v->acR1 + s * ORD_MAX;
+        float* r2 = v->acR2 + s * ORD_MAX;
+        float lambda = (float)(v->acWarp[s]);
+        
+        float d = r1[0] - lambda * (float)(x-r2[0]);
+        Rt[0] += (float)(x) * (float)(x);
+        r1[0] = x;
+        r2[0] = d;
+        for(int32_t i=1; i<=o; i++)
+        {
+            Rt[i] += d * (float)(x);
+            float dn = r1[i] - lambda * (float)(d-r2[i]);
+            r1[i] = d;
+            r2[i] = dn;
+            d = dn;
+        }
+    }
+    v->acCount[s]++;
+}
+
+
+//resynthesizes one carrier sample of frame s through the lattice filter from its last analysis
+static inline float tTalkboxFloat_synthesize(_tTalkboxFloat* const v, int s, float car)
+{
+    int32_t o = v->synthO[s];
+    if (o < 0) return 0.0f;
+    
+    float* k = v->synthK + s * ORD_MAX;
+    float* z = v->synthZ + s * ORD_MAX;
+    float x = v->synthG[s] * car;
+    for(int32_t j=o; j>0; j--)  //lattice filter
+    {
+        x -= k[j] * z[j-1];
+        z[j] = z[j-1] + k[j] * x;
+    }
+    z[0] = x;
+    return x;
+}
+
+//analyses the frame that just filled and sets it up to be resynthesized over the next one
+static void tTalkboxFloat_startFrame(_tTalkboxFloat* const v, int s)
+{
+    float* buf = s ? v->buf1 : v->buf0;
+    int voiced;
+    
+    if (v->acCount[s] == v->N && v->acN[s] == v->N && v->acO[s] == v->O &&
+        v->acWarpOn[s] == v->warpOn && v->acWarp[s] == v->warpFactor)
+    {
+        float r[ORD_MAX];
+        for (int32_t j = 0; j <= v->O; j++)
+            r[j] = (v->warpOn == 0) ? v->acR[s * ORD_MAX + j] : (float)(v->acRt[s * ORD_MAX + j]);
+        voiced = tTalkboxFloat_lpcSolve(r, v->O, v->k, v->freeze, &v->G);
+    }
+    //the settings changed partway through the frame, so analyse it all at once
+    else voiced = tTalkboxFloat_lpcAnalyse(buf, v->dl, v->Rt, v->N, v->O, v->warpFactor, v->warpOn, v->k, v->freeze, &v->G);
+    tTalkboxFloat_resetAnalysis(v, s, 0);
+    
+    if (voiced)
+    {
+        float* k = v->synthK + s * ORD_MAX;
+        float* z = v->synthZ + s * ORD_MAX;
+        for (int32_t j = 0; j <= v->O; j++)
+        {
+            k[j] = v->k[j];
+            z[j] = 0.0f;
+        }
+        v->synthG[s] = v->G;
+        v->synthO[s] = v->O;
+    }
+    else v->synthO[s] = -1;
+}
+
 float tTalkboxFloat_tick(tTalkboxFloat* const voc, float synth, float voice)
 {
+    LEAF_PROFILE_OBJECT(voc);
     _tTalkboxFloat* v = *voc;
-
+    
     int32_t  p0=v->pos, p1 = (v->pos + v->N/2) % v->N;
     float e=v->emphasis, w, o, x, fx=v->FX;
     float p, q, h0=0.3f, h1=0.77f;
-
+    
     o = voice;
     x = synth;
-
-
-
+    
+    
+    
     p = v->d0 + h0 *  x; v->d0 = v->d1;  v->d1 = x  - h0 * p;
     q = v->d2 + h1 * v->d4; v->d2 = v->d3;  v->d3 = v->d4 - h1 * q;
     v->d4 = x;
     x = p + q;
-
+    
     if(v->K++)
     {
         v->K = 0;
-
+        
+        //each frame's autocorrelation is accumulated as it fills and its carrier goes through
+        //the lattice a sample at a time as it's replaced, so the end of a frame only solves for k
+        float y0 = tTalkboxFloat_synthesize(v, 0, v->car0[p0]);
+        float y1 = tTalkboxFloat_synthesize(v, 1, v->car1[p1]);
         v->car0[p0] = v->car1[p1] = x; //carrier input
-
+        
         x = o - e;  e = o;  //6dB/oct pre-emphasis
-
-        w = v->window[p0]; fx = v->buf0[p0] * w;  v->buf0[p0] = x * w;  //50% overlapping hanning windows
-        if(++p0 >= v->N) { tTalkboxFloat_lpc(v->buf0, v->car0, v->dl, v->Rt, v->N, v->O, v->warpFactor, v->warpOn, v->k, v->freeze, &v->G);  p0 = 0; }
-
-        w = 1.0f - w;  fx += v->buf1[p1] * w;  v->buf1[p1] = x * w;
-        if(++p1 >= v->N) { tTalkboxFloat_lpc(v->buf1, v->car1, v->dl, v->Rt, v->N, v->O, v->warpFactor, v->warpOn, v->k, v->freeze, &v->G);  p1 = 0; }
+        
+        w = v->window[p0]; fx = y0 * w;  v->buf0[p0] = x * w;  //50% overlapping hanning windows
+        tTalkboxFloat_accumulate(v, 0, v->buf0, p0);
+        if(++p0 >= v->N) { tTalkboxFloat_startFrame(v, 0);  p0 = 0; }
+        
+        w = 1.0f - w;  fx += y1 * w;  v->buf1[p1] = x * w;
+        tTalkboxFloat_accumulate(v, 1, v->buf1, p1);
+        if(++p1 >= v->N) { tTalkboxFloat_startFrame(v, 1);  p1 = 0; }
     }
-
+    
     p = v->u0 + h0 * fx; v->u0 = v->u1;  v->u1 = fx - h0 * p;
     q = v->u2 + h1 * v->u4; v->u2 = v->u3;  v->u3 = v->u4 - h1 * q;
     v->u4 = fx;
     x = p + q;
-
+    
     o = x;
-
+    
     v->emphasis = e;
     v->pos = p0;
     v->FX = fx;
-
-
+    
+    
     return o;
 }
 
 
 void tTalkboxFloat_lpc(float *buf, float *car, float* dl, float* Rt, int32_t n, int32_t o, float warp, int warpOn, float *k, int freeze, float *G)
 {
-    float z[ORD_MAX], r[ORD_MAX], x;
+    float z[ORD_MAX], x;
     
-    if (warpOn == 0)
+    if (!tTalkboxFloat_lpcAnalyse(buf, dl, Rt, n, o, warp, warpOn, k, freeze, G))
     {
-        int nn = n;
-        for(int j = 0; j <= o; j++, nn--)  //buf[] is already emphasized and windowed
-        {
-            z[j] = r[j] = 0.0f;
-            for(int i = 0; i < nn; i++) r[j] += buf[i] * buf[i+j]; //autocorrelation
-        }
-    }
-    else
-    {
-        int nn = n;
-        for(int j = 0; j <= o; j++, nn--)  //buf[] is already emphasized and windowed
-        {
-            z[j] = r[j] = 0.0f;
-        }
-        tTalkboxFloat_warpedAutocorrelate(buf, dl, Rt, n, r, o, warp);
-    }
-
-    r[0] *= 1.001f;  //stability fix
-
-    float min = 0.000001f;
-    if (!freeze)
-    {
-        if(r[0] < min)
-        {
-
             for(int i = 0; i < n; i++)
             {
                 buf[i] = 0.0f;
             }
             return;
-
-        }
-
-        tTalkbox_lpcDurbin(r, o, k, G);  //calc reflection coeffs
-
-        //this is for stability to keep reflection coefficients inside the unit circle
-        //but in Harma's papers I've seen 0.998.  just needs to be less than 1 it seems but maybe some wiggle room to avoid instability from floating point precision -JS
-        for(int i = 0; i <= o; i++)
-        {
-            if(k[i] > 0.998f) k[i] = 0.998f; else if(k[i] < -0.998f) k[i] = -.998f;
         }
-    }
+    for(int j = 0; j <= o; j++) z[j] = 0.0f;
     for(int i = 0; i < n; i++)
     {
         x = G[0] * car[i];
@@ -676,21 +999,21 @@ void tTalkboxFloat_setQuality(tTalkboxFloat* const voc, float quality)
 void tTalkboxFloat_setWarpFactor(tTalkboxFloat* const voc, float warpFactor)
 {
     _tTalkboxFloat* v = *voc;
-
+    
     v->warpFactor = warpFactor;
 }
 
 void tTalkboxFloat_setWarpOn(tTalkboxFloat* const voc, int warpOn)
 {
     _tTalkboxFloat* v = *voc;
-
+    
     v->warpOn = warpOn;
 }
 
 void tTalkboxFloat_setFreeze(tTalkboxFloat* const voc, int freeze)
 {
     _tTalkboxFloat* v = *voc;
-
+    
     v->freeze = freeze;
 }
 
@@ -712,6 +1035,7 @@ void tVocoder_init (tVocoder* const voc, LEAF* const leaf)
 
 void tVocoder_initToPool (tVocoder* const voc, tMempool* const mp)
 {
+    LEAF_PROFILE_POOL(mp);
     _tMempool* m = *mp;
     _tVocoder* v = *voc = (_tVocoder*) mpool_alloc(sizeof(_tVocoder), m);
     v->mempool = m;
@@ -729,6 +1053,7 @@ void tVocoder_initToPool (tVocoder* const voc, tMempool* const mp)
     v->param[7] = 0.33f;  //num bands
     
     tVocoder_update(voc);
+    tVocoder_suspend(voc);
 }
 
 void tVocoder_free (tVocoder* const voc)
@@ -759,142 +1084,267 @@ void        tVocoder_update      (tVocoder* const voc)
     if(v->param[7]<0.5f)
     {
         v->nbnd=8;
-
-        v->f[1][2] = 3000.0f;
+        
+        v->f[2][1] = 3000.0f;
         v->f[2][2] = 2200.0f;
-        v->f[3][2] = 1500.0f;
-        v->f[4][2] = 1080.0f;
-        v->f[5][2] = 700.0f;
-        v->f[6][2] = 390.0f;
-        v->f[7][2] = 190.0f;
+        v->f[2][3] = 1500.0f;
+        v->f[2][4] = 1080.0f;
+        v->f[2][5] = 700.0f;
+        v->f[2][6] = 390.0f;
+        v->f[2][7] = 190.0f;
     }
     else
     {
         v->nbnd=16;
-
-        v->f[ 1][2] = 5000.0f; //+1000
-        v->f[ 2][2] = 4000.0f; //+750
-        v->f[ 3][2] = 3250.0f; //+500
-        v->f[ 4][2] = 2750.0f; //+450
-        v->f[ 5][2] = 2300.0f; //+300
-        v->f[ 6][2] = 2000.0f; //+250
-        v->f[ 7][2] = 1750.0f; //+250
-        v->f[ 8][2] = 1500.0f; //+250
-        v->f[ 9][2] = 1250.0f; //+250
-        v->f[10][2] = 1000.0f; //+250
-        v->f[11][2] =  750.0f; //+210
-        v->f[12][2] =  540.0f; //+190
-        v->f[13][2] =  350.0f; //+155
-        v->f[14][2] =  195.0f; //+100
-        v->f[15][2] =   95.0f;
+        
+        v->f[2][1] = 5000.0f; //+1000
+        v->f[2][2] = 4000.0f; //+750
+        v->f[2][3] = 3250.0f; //+500
+        v->f[2][4] = 2750.0f; //+450
+        v->f[2][5] = 2300.0f; //+300
+        v->f[2][6] = 2000.0f; //+250
+        v->f[2][7] = 1750.0f; //+250
+        v->f[2][8] = 1500.0f; //+250
+        v->f[2][9] = 1250.0f; //+250
+        v->f[2][10] = 1000.0f; //+250
+        v->f[2][11] =  750.0f; //+210
+        v->f[2][12] =  540.0f; //+190
+        v->f[2][13] =  350.0f; //+155
+        v->f[2][14] =  195.0f; //+100
+        v->f[2][15] =   95.0f;
     }
     
     if(v->param[4]<0.05f) //freeze
     {
-        for(i=0;i<v->nbnd;i++) v->f[i][12]=0.0f;
+        for(i=0;i<v->nbnd;i++) v->f[12][i]=0.0f;
     }
     else
     {
-        v->f[0][12] = powf(10.0f, -1.7f - 2.7f * v->param[4]); //envelope speed
+        v->f[12][0] = powf(10.0f, -1.7f - 2.7f * v->param[4]); //envelope speed
+        
+        rr = 0.022f / (float)v->nbnd; //minimum proportional to frequency to stop distortion
+        for(i=1;i<v->nbnd;i++)
+        {
+            v->f[12][i] = (float)(0.025f - rr * (float)i);
+            if(v->f[12][0] < v->f[12][i]) v->f[12][i] = v->f[12][0];
+        }
+        v->f[12][0] = 0.5f * v->f[12][0]; //only top band is at full rate
+    }
+    
+    rr = 1.0f - powf(10.0f, -1.0f - 1.2f * v->param[5]);
+    sh = (float)pow(2.0f, 3.0f * v->param[6] - 1.0f); //filter bank range shift
+    
+    //lanes past the last band run along with the filter bank, so keep them silent
+    for(i=v->nbnd;i<VOCODER_LANES;i++) for(int j=0; j<13; j++) v->f[j][i] = 0.0f;
+    
+    for(i=1;i<v->nbnd;i++)
+    {
+        v->f[2][i] *= sh;
+        th = acosf((2.0f * rr * cosf(tpofs * v->f[2][i])) / (1.0f + rr * rr));
+        v->f[0][i] = (2.0f * rr * cosf(th)); //a0
+        v->f[1][i] = (-rr * rr);           //a1
+        //was .98
+        v->f[2][i] *= 0.96f; //shift 2nd stage slightly to stop high resonance peaks
+        th = acosf((2.0f * rr * cosf(tpofs * v->f[2][i])) / (1.0f + rr * rr));
+        v->f[2][i] = (2.0f * rr * cosf(th));
+    }
+}
+
+// One step of the filter bank at half rate. The bands are SIMD lanes, in groups of
+// four from band 1, and the lanes past the last band have zero coefficients.
+static inline float tVocoder_bands(_tVocoder* const v, float aa, float bb)
+{
+    float oo = 0.0f;
+    int i = 1, nb = v->nbnd;
+#if LEAF_SIMD_SSE
+    const __m128 vaa = _mm_set1_ps(aa);
+    const __m128 vbb = _mm_set1_ps(bb);
+    const __m128 sign = _mm_set1_ps(-0.0f);
+#if LEAF_DENORMAL_CHECK
+    const __m128 tiny = _mm_set1_ps(1.0e-10f);
+#endif
+    __m128 acc = _mm_setzero_ps();
+    for (; i < nb; i += 4)
+    {
+        __m128 a0 = _mm_loadu_ps(&v->f[0][i]);
+        __m128 a1 = _mm_loadu_ps(&v->f[1][i]);
+        __m128 a2 = _mm_loadu_ps(&v->f[2][i]);
+        __m128 s3 = _mm_loadu_ps(&v->f[3][i]), s4 = _mm_loadu_ps(&v->f[4][i]);
+        __m128 s5 = _mm_loadu_ps(&v->f[5][i]), s6 = _mm_loadu_ps(&v->f[6][i]);
+        __m128 s7 = _mm_loadu_ps(&v->f[7][i]), s8 = _mm_loadu_ps(&v->f[8][i]);
+        __m128 s9 = _mm_loadu_ps(&v->f[9][i]), s10 = _mm_loadu_ps(&v->f[10][i]);
+        __m128 env = _mm_loadu_ps(&v->f[11][i]);
+        __m128 rate = _mm_loadu_ps(&v->f[12][i]);
+        
+        __m128 tmp = _mm_add_ps(_mm_add_ps(_mm_mul_ps(a0, s3), _mm_mul_ps(a1, s4)), vbb);
+        s4 = s3; s3 = tmp;
+        tmp = _mm_add_ps(tmp, _mm_add_ps(_mm_mul_ps(a2, s5), _mm_mul_ps(a1, s6)));
+        s6 = s5; s5 = tmp;
+        
+        tmp = _mm_add_ps(_mm_add_ps(_mm_mul_ps(a0, s7), _mm_mul_ps(a1, s8)), vaa);
+        s8 = s7; s7 = tmp;
+        tmp = _mm_add_ps(tmp, _mm_add_ps(_mm_mul_ps(a2, s9), _mm_mul_ps(a1, s10)));
+        s10 = s9; s9 = tmp;
+        
+        tmp = _mm_andnot_ps(sign, tmp);
+        env = _mm_sub_ps(env, _mm_mul_ps(rate, _mm_sub_ps(env, tmp)));
+        acc = _mm_add_ps(acc, _mm_mul_ps(s5, env));
+
+#if LEAF_DENORMAL_CHECK
+        // catch reson & envelope denormals
+        __m128 keep = _mm_and_ps(_mm_cmpge_ps(_mm_andnot_ps(sign, s3), tiny),
+                                 _mm_cmpge_ps(_mm_andnot_ps(sign, s7), tiny));
+        s3 = _mm_and_ps(s3, keep); s4 = _mm_and_ps(s4, keep);
+        s5 = _mm_and_ps(s5, keep); s6 = _mm_and_ps(s6, keep);
+        s7 = _mm_and_ps(s7, keep); s8 = _mm_and_ps(s8, keep);
+        s9 = _mm_and_ps(s9, keep); s10 = _mm_and_ps(s10, keep);
+        env = _mm_and_ps(env, keep);
+#endif
+        _mm_storeu_ps(&v->f[3][i], s3); _mm_storeu_ps(&v->f[4][i], s4);
+        _mm_storeu_ps(&v->f[5][i], s5); _mm_storeu_ps(&v->f[6][i], s6);
+        _mm_storeu_ps(&v->f[7][i], s7); _mm_storeu_ps(&v->f[8][i], s8);
+        _mm_storeu_ps(&v->f[9][i], s9); _mm_storeu_ps(&v->f[10][i], s10);
+        _mm_storeu_ps(&v->f[11][i], env);
+    }
+    acc = _mm_add_ps(acc, _mm_movehl_ps(acc, acc));
+    acc = _mm_add_ss(acc, _mm_shuffle_ps(acc, acc, 1));
+    oo = _mm_cvtss_f32(acc);
+#elif LEAF_SIMD_NEON
+    const float32x4_t vaa = vdupq_n_f32(aa);
+    const float32x4_t vbb = vdupq_n_f32(bb);
+    const float32x4_t zero = vdupq_n_f32(0.0f);
+#if LEAF_DENORMAL_CHECK
+    const float32x4_t tiny = vdupq_n_f32(1.0e-10f);
+#endif
+    float32x4_t acc = zero;
+    for (; i < nb; i += 4)
+    {
+        float32x4_t a0 = vld1q_f32(&v->f[0][i]);
+        float32x4_t a1 = vld1q_f32(&v->f[1][i]);
+        float32x4_t a2 = vld1q_f32(&v->f[2][i]);
+        float32x4_t s3 = vld1q_f32(&v->f[3][i]), s4 = vld1q_f32(&v->f[4][i]);
+        float32x4_t s5 = vld1q_f32(&v->f[5][i]), s6 = vld1q_f32(&v->f[6][i]);
+        float32x4_t s7 = vld1q_f32(&v->f[7][i]), s8 = vld1q_f32(&v->f[8][i]);
+        float32x4_t s9 = vld1q_f32(&v->f[9][i]), s10 = vld1q_f32(&v->f[10][i]);
+        float32x4_t env = vld1q_f32(&v->f[11][i]);
+        float32x4_t rate = vld1q_f32(&v->f[12][i]);
+        
+        float32x4_t tmp = vaddq_f32(vaddq_f32(vmulq_f32(a0, s3), vmulq_f32(a1, s4)), vbb);
+        s4 = s3; s3 = tmp;
+        tmp = vaddq_f32(tmp, vaddq_f32(vmulq_f32(a2, s5), vmulq_f32(a1, s6)));
+        s6 = s5; s5 = tmp;
+        
+        tmp = vaddq_f32(vaddq_f32(vmulq_f32(a0, s7), vmulq_f32(a1, s8)), vaa);
+        s8 = s7; s7 = tmp;
+        tmp = vaddq_f32(tmp, vaddq_f32(vmulq_f32(a2, s9), vmulq_f32(a1, s10)));
+        s10 = s9; s9 = tmp;
+        
+        tmp = vabsq_f32(tmp);
+        env = vsubq_f32(env, vmulq_f32(rate, vsubq_f32(env, tmp)));
+        acc = vaddq_f32(acc, vmulq_f32(s5, env));
+
+#if LEAF_DENORMAL_CHECK
+        // catch reson & envelope denormals
+        uint32x4_t clear = vorrq_u32(vcltq_f32(vabsq_f32(s3), tiny), vcltq_f32(vabsq_f32(s7), tiny));
+        s3 = vbslq_f32(clear, zero, s3); s4 = vbslq_f32(clear, zero, s4);
+        s5 = vbslq_f32(clear, zero, s5); s6 = vbslq_f32(clear, zero, s6);
+        s7 = vbslq_f32(clear, zero, s7); s8 = vbslq_f32(clear, zero, s8);
+        s9 = vbslq_f32(clear, zero, s9); s10 = vbslq_f32(clear, zero, s10);
+        env = vbslq_f32(clear, zero, env);
+#endif
+        vst1q_f32(&v->f[3][i], s3); vst1q_f32(&v->f[4][i], s4);
+        vst1q_f32(&v->f[5][i], s5); vst1q_f32(&v->f[6][i], s6);
+        vst1q_f32(&v->f[7][i], s7); vst1q_f32(&v->f[8][i], s8);
+        vst1q_f32(&v->f[9][i], s9); vst1q_f32(&v->f[10][i], s10);
+        vst1q_f32(&v->f[11][i], env);
+    }
+    float32x2_t half = vadd_f32(vget_low_f32(acc), vget_high_f32(acc));
+    oo = vget_lane_f32(vpadd_f32(half, half), 0);
+#else
+    float tmp;
+    for(; i<nb; i++) //filter bank: 4th-order band pass
+    {
+        tmp = v->f[0][i] * v->f[3][i] + v->f[1][i] * v->f[4][i] + bb;
+        v->f[4][i] = v->f[3][i];
+        v->f[3][i] = tmp;
+        tmp += v->f[2][i] * v->f[5][i] + v->f[1][i] * v->f[6][i];
+        v->f[6][i] = v->f[5][i];
+        v->f[5][i] = tmp;
+        
+        tmp = v->f[0][i] * v->f[7][i] + v->f[1][i] * v->f[8][i] + aa;
+        v->f[8][i] = v->f[7][i];
+        v->f[7][i] = tmp;
+        tmp += v->f[2][i] * v->f[9][i] + v->f[1][i] * v->f[10][i];
+        v->f[10][i] = v->f[9][i];
+        v->f[9][i] = tmp;
         
-        rr = 0.022f / (float)v->nbnd; //minimum proportional to frequency to stop distortion
-        for(i=1;i<v->nbnd;i++)
-        {
-            v->f[i][12] = (float)(0.025f - rr * (float)i);
-            if(v->f[0][12] < v->f[i][12]) v->f[i][12] = v->f[0][12];
-        }
-        v->f[0][12] = 0.5f * v->f[0][12]; //only top band is at full rate
-    }
-    
-    rr = 1.0f - powf(10.0f, -1.0f - 1.2f * v->param[5]);
-    sh = (float)pow(2.0f, 3.0f * v->param[6] - 1.0f); //filter bank range shift
-    
-    for(i=1;i<v->nbnd;i++)
-    {
-        v->f[i][2] *= sh;
-        th = acosf((2.0f * rr * cosf(tpofs * v->f[i][2])) / (1.0f + rr * rr));
-        v->f[i][0] = (2.0f * rr * cosf(th)); //a0
-        v->f[i][1] = (-rr * rr);           //a1
-        //was .98
-        v->f[i][2] *= 0.96f; //shift 2nd stage slightly to stop high resonance peaks
-        th = acosf((2.0f * rr * cosf(tpofs * v->f[i][2])) / (1.0f + rr * rr));
-        v->f[i][2] = (2.0f * rr * cosf(th));
+        if(tmp<0.0f) tmp = -tmp;
+        v->f[11][i] -= v->f[12][i] * (v->f[11][i] - tmp);
+        oo += v->f[5][i] * v->f[11][i];
+#if LEAF_DENORMAL_CHECK
+        if(fabs(v->f[3][i])<1.0e-10 || fabs(v->f[7][i])<1.0e-10)
+            for(int k=3; k<12; k++) v->f[k][i] = 0.0f; //catch reson & envelope denormals
+#endif
     }
+#endif
+    return oo;
 }
 
 float       tVocoder_tick        (tVocoder* const voc, float synth, float voice)
 {
+    LEAF_PROFILE_OBJECT(voc);
     _tVocoder* v = *voc;
     
     float a, b, o=0.0f, aa, bb, oo = v->kout, g = v->gain, ht = v->thru, hh = v->high, tmp;
-    uint32_t i, k = v->kval, nb = v->nbnd;
+    uint32_t k = v->kval;
     
     a = voice; //speech
     b = synth; //synth
     
-    tmp = a - v->f[0][7]; //integrate modulator for HF band and filter bank pre-emphasis
-    v->f[0][7] = a;
+    tmp = a - v->f[7][0]; //integrate modulator for HF band and filter bank pre-emphasis
+    v->f[7][0] = a;
     a = tmp;
     
     if(tmp<0.0f) tmp = -tmp;
-    v->f[0][11] -= v->f[0][12] * (v->f[0][11] - tmp);      //high band envelope
-    o = v->f[0][11] * (ht * a + hh * (b - v->f[0][3])); //high band + high thru
+    v->f[11][0] -= v->f[12][0] * (v->f[11][0] - tmp);      //high band envelope
+    o = v->f[11][0] * (ht * a + hh * (b - v->f[3][0])); //high band + high thru
     
-    v->f[0][3] = b; //integrate carrier for HF band
+    v->f[3][0] = b; //integrate carrier for HF band
     
     if(++k & 0x1) //this block runs at half sample rate
     {
-        oo = 0.0f;
-        aa = a + v->f[0][9] - v->f[0][8] - v->f[0][8];  //apply zeros here instead of in each reson
-        v->f[0][9] = v->f[0][8];  v->f[0][8] = a;
-        bb = b + v->f[0][5] - v->f[0][4] - v->f[0][4];
-        v->f[0][5] = v->f[0][4];  v->f[0][4] = b;
+        aa = a + v->f[9][0] - v->f[8][0] - v->f[8][0];  //apply zeros here instead of in each reson
+        v->f[9][0] = v->f[8][0];  v->f[8][0] = a;
+        bb = b + v->f[5][0] - v->f[4][0] - v->f[4][0];
+        v->f[5][0] = v->f[4][0];  v->f[4][0] = b;
         
-        for(i=1; i<nb; i++) //filter bank: 4th-order band pass
-        {
-            tmp = v->f[i][0] * v->f[i][3] + v->f[i][1] * v->f[i][4] + bb;
-            v->f[i][4] = v->f[i][3];
-            v->f[i][3] = tmp;
-            tmp += v->f[i][2] * v->f[i][5] + v->f[i][1] * v->f[i][6];
-            v->f[i][6] = v->f[i][5];
-            v->f[i][5] = tmp;
-            
-            tmp = v->f[i][0] * v->f[i][7] + v->f[i][1] * v->f[i][8] + aa;
-            v->f[i][8] = v->f[i][7];
-            v->f[i][7] = tmp;
-            tmp += v->f[i][2] * v->f[i][9] + v->f[i][1] * v->f[i][10];
-            v->f[i][10] = v->f[i][9];
-            v->f[i][9] = tmp;
-            
-            if(tmp<0.0f) tmp = -tmp;
-            v->f[i][11] -= v->f[i][12] * (v->f[i][11] - tmp);
-            oo += v->f[i][5] * v->f[i][11];
-        }
+        oo = tVocoder_bands(v, aa, bb);
     }
     o += oo * g; //effect of interpolating back up to Fs would be minimal (aliasing >16kHz)
     
     v->kout = oo;
     v->kval = k & 0x1;
-#ifdef NO_DENORMAL_CHECK
-#else
-    if(fabs(v->f[0][11])<1.0e-10) v->f[0][11] = 0.0f; //catch HF envelope denormal
-    
-    for(i=1;i<nb;i++)
-        if(fabs(v->f[i][3])<1.0e-10 || fabs(v->f[i][7])<1.0e-10)
-            for(k=3; k<12; k++) v->f[i][k] = 0.0f; //catch reson & envelope denormals
+#if LEAF_DENORMAL_CHECK
+    if(fabs(v->f[11][0])<1.0e-10) v->f[11][0] = 0.0f; //catch HF envelope denormal
 #endif
     if(fabs(o)>10.0f) tVocoder_suspend(voc); //catch instability
     
     return o;
 }
 
+void        tVocoder_tickBlock   (tVocoder* const voc, const float* synth, const float* voice, float* output, int size)
+{
+    LEAF_PROFILE_OBJECT(voc);
+    for (int i = 0; i < size; i++) output[i] = tVocoder_tick(voc, synth[i], voice[i]);
+}
+
 void        tVocoder_suspend     (tVocoder* const voc)
 {
     _tVocoder* v = *voc;
     
     int32_t i, j;
     
-    for(i=0; i<v->nbnd; i++) for(j=3; j<12; j++) v->f[i][j] = 0.0f; //zero band filters and envelopes
+    for(i=0; i<v->nbnd; i++) for(j=3; j<12; j++) v->f[j][i] = 0.0f; //zero band filters and envelopes
     v->kout = 0.0f;
     v->kval = 0;
 }
@@ -916,13 +1366,14 @@ void tRosenbergGlottalPulse_init (tRosenbergGlottalPulse* const gp, LEAF* const
 
 void tRosenbergGlottalPulse_initToPool (tRosenbergGlottalPulse* const gp, tMempool* const mp)
 {
+    LEAF_PROFILE_POOL(mp);
      _tMempool* m = *mp;
     _tRosenbergGlottalPulse* g = *gp = (_tRosenbergGlottalPulse*) mpool_alloc(sizeof(_tRosenbergGlottalPulse), m);
     g->mempool = m;
     LEAF* leaf = g->mempool->leaf;
     
     g->invSampleRate = leaf->invSampleRate;
-
+    
     g->phase  = 0.0f;
     g->openLength = 0.0f;
     g->pulseLength = 0.0f;
@@ -938,25 +1389,26 @@ void tRosenbergGlottalPulse_free (tRosenbergGlottalPulse* const gp)
 
 float   tRosenbergGlottalPulse_tick           (tRosenbergGlottalPulse* const gp)
 {
+    LEAF_PROFILE_OBJECT(gp);
     _tRosenbergGlottalPulse* g = *gp;
-
+    
     float output = 0.0f;
-
+    
     // Phasor increment
     g->phase += g->inc;
     while (g->phase >= 1.0f) g->phase -= 1.0f;
     while (g->phase < 0.0f) g->phase += 1.0f;
-
+    
     if (g->phase < g->openLength)
     {
         output = 0.5f*(1.0f-fastercosf(PI * g->phase));
     }
-
+    
     else if (g->phase < g->pulseLength)
     {
         output = fastercosf(HALF_PI * (g->phase-g->openLength)* g->invPulseLengthMinusOpenLength);
     }
-
+    
     else
     {
         output = 0.0f;
@@ -967,25 +1419,26 @@ float   tRosenbergGlottalPulse_tick           (tRosenbergGlottalPulse* const gp)
 
 float   tRosenbergGlottalPulse_tickHQ           (tRosenbergGlottalPulse* const gp)
 {
+    LEAF_PROFILE_OBJECT(gp);
     _tRosenbergGlottalPulse* g = *gp;
-
+    
     float output = 0.0f;
-
+    
     // Phasor increment
     g->phase += g->inc;
     while (g->phase >= 1.0f) g->phase -= 1.0f;
     while (g->phase < 0.0f) g->phase += 1.0f;
-
+    
     if (g->phase < g->openLength)
     {
         output = 0.5f*(1.0f-cosf(PI * g->phase));
     }
-
+    
     else if (g->phase < g->pulseLength)
     {
         output = cosf(HALF_PI * (g->phase-g->openLength)* g->invPulseLengthMinusOpenLength);
     }
-
+    
     else
     {
         output = 0.0f;
@@ -1055,6 +1508,7 @@ void tSOLAD_init (tSOLAD* const wp, int loopSize, LEAF* const leaf)
 
 void tSOLAD_initToPool (tSOLAD* const wp, int loopSize, tMempool* const mp)
 {
+    LEAF_PROFILE_POOL(mp);
     _tMempool* m = *mp;
     _tSOLAD* w = *wp = (_tSOLAD*) mpool_calloc(sizeof(_tSOLAD), m);
     w->mempool = m;
@@ -1062,24 +1516,55 @@ void tSOLAD_initToPool (tSOLAD* const wp, int loopSize, tMempool* const mp)
     w->loopSize = loopSize;
     w->pitchfactor = 1.;
     w->delaybuf = (float*) mpool_calloc(sizeof(float) * (w->loopSize+1), m);
-
+    
     w->timeindex = 0;
     w->xfadevalue = -1;
     w->period = INITPERIOD;
     w->readlag = INITPERIOD;
     w->blocksize = INITPERIOD;
-
+    
     tAttackDetection_initToPool(&w->ad, INITPERIOD, 5, 5, mp);
     tHighpass_initToPool(&w->hp, 20.0f, mp);
 }
 
+void tSOLAD_initShared (tSOLAD* const wp, tSOLAD* const source, LEAF* const leaf)
+{
+    tSOLAD_initToPoolShared(wp, source, &leaf->mempool);
+}
+
+void tSOLAD_initToPoolShared (tSOLAD* const wp, tSOLAD* const source, tMempool* const mp)
+{
+    LEAF_PROFILE_POOL(mp);
+    _tMempool* m = *mp;
+    _tSOLAD* w = *wp = (_tSOLAD*) mpool_calloc(sizeof(_tSOLAD), m);
+    w->mempool = m;
+    
+    // Always point at the owner so a chain of shared ones still reads one buffer
+    _tSOLAD* s = *source;
+    if (s->source != NULL) s = s->source;
+    w->source = s;
+    
+    w->loopSize = s->loopSize;
+    w->pitchfactor = 1.;
+    w->delaybuf = s->delaybuf;
+    
+    w->timeindex = 0;
+    w->xfadevalue = -1;
+    w->period = INITPERIOD;
+    w->readlag = INITPERIOD;
+    w->blocksize = INITPERIOD;
+}
+
 void tSOLAD_free (tSOLAD* const wp)
 {
     _tSOLAD* w = *wp;
     
+    if (w->source == NULL)
+    {
     tAttackDetection_free(&w->ad);
     tHighpass_free(&w->hp);
     mpool_free((char*)w->delaybuf, w->mempool);
+    }
     mpool_free((char*)w, w->mempool);
 }
 
@@ -1088,6 +1573,19 @@ void tSOLAD_ioSamples(tSOLAD* const wp, float* in, float* out, int blocksize)
 {
     _tSOLAD* w = *wp;
     
+    if (w->source != NULL)
+    {
+        // The source has already written this block and moved on, so step back to it
+        _tSOLAD* s = w->source;
+        w->blocksize = blocksize;
+        w->timeindex = (s->timeindex - blocksize) & (w->loopSize - 1);
+        if (s->attack) tSOLAD_setReadLag(wp, w->blocksize);
+        
+        if(w->pitchfactor > 1) pitchup(w, out);
+        else pitchdown(w, out);
+        return;
+    }
+    
     int i = w->timeindex;
     int n = w->blocksize = blocksize;
     
@@ -1103,7 +1601,8 @@ void tSOLAD_ioSamples(tSOLAD* const wp, float* in, float* out, int blocksize)
     while(n--) w->delaybuf[i++] = tHighpass_tick(&w->hp, *in++);    // copy one input block to delay buffer
     
     tAttackDetection_setBlocksize(&w->ad, n);
-    if (tAttackDetection_detect(&w->ad, in))
+    w->attack = tAttackDetection_detect(&w->ad, in);
+    if (w->attack)
     {
         tSOLAD_setReadLag(wp, w->blocksize);
     }
@@ -1160,7 +1659,8 @@ void tSOLAD_resetState(tSOLAD* const wp)
     int n = w->loopSize;
     float *buf = w->delaybuf;
     
-    while(n--) *buf++ = 0;
+    // A shared tSOLAD leaves the buffer to its source
+    if (w->source == NULL) while(n--) *buf++ = 0;
     
     w->timeindex = 0;
     w->xfadevalue = -1;
@@ -1172,6 +1672,7 @@ void tSOLAD_resetState(tSOLAD* const wp)
 void tSOLAD_setSampleRate(tSOLAD* const wp, float sr)
 {
     _tSOLAD* w = *wp;
+    if (w->source != NULL) return;
     tAttackDetection_setSampleRate(&w->ad, sr);
     tHighpass_setSampleRate(&w->hp, sr);
 }
@@ -1413,6 +1914,7 @@ void tPitchShift_init (tPitchShift* const psr, tDualPitchDetector* const dpd, in
 
 void tPitchShift_initToPool (tPitchShift* const psr, tDualPitchDetector* const dpd, int bufSize, tMempool* const mp)
 {
+    LEAF_PROFILE_POOL(mp);
     _tMempool* m = *mp;
     _tPitchShift* ps = *psr = (_tPitchShift*) mpool_alloc(sizeof(_tPitchShift), m);
     ps->mempool = m;
@@ -1428,6 +1930,29 @@ void tPitchShift_initToPool (tPitchShift* const psr, tDualPitchDetector* const d
     tSOLAD_setPitchFactor(&ps->sola, DEFPITCHRATIO);
 }
 
+void tPitchShift_initShared (tPitchShift* const psr, tPitchShift* const source, LEAF* const leaf)
+{
+    tPitchShift_initToPoolShared(psr, source, &leaf->mempool);
+}
+
+void tPitchShift_initToPoolShared (tPitchShift* const psr, tPitchShift* const source, tMempool* const mp)
+{
+    LEAF_PROFILE_POOL(mp);
+    _tMempool* m = *mp;
+    _tPitchShift* ps = *psr = (_tPitchShift*) mpool_alloc(sizeof(_tPitchShift), m);
+    ps->mempool = m;
+    _tPitchShift* src = *source;
+    
+    ps->pd = src->pd;
+    ps->bufSize = src->bufSize;
+    ps->pickiness = 0.0f;
+    
+    ps->sampleRate = src->sampleRate;
+    
+    tSOLAD_initToPoolShared(&ps->sola, &src->sola, mp);
+    tSOLAD_setPitchFactor(&ps->sola, DEFPITCHRATIO);
+}
+
 void tPitchShift_free (tPitchShift* const psr)
 {
     _tPitchShift* ps = *psr;
@@ -1448,7 +1973,7 @@ void tPitchShift_shiftBy (tPitchShift* const psr, float factor, float* in, float
         tSOLAD_setPeriod(&ps->sola, period);
         tSOLAD_setPitchFactor(&ps->sola, factor);
     }
-        
+    
     tSOLAD_ioSamples(&ps->sola, in, out, ps->bufSize);
 }
 
@@ -1482,6 +2007,300 @@ void    tPitchShift_setSampleRate(tPitchShift* const psr, float sr)
 }
 
 
+//============================================================================================================
+// PHASEVOCODER
+//============================================================================================================
+
+void tPhaseVocoder_init (tPhaseVocoder* const pvr, int fftSize, int overlap, int numVoices, LEAF* const leaf)
+{
+    tPhaseVocoder_initToPool(pvr, fftSize, overlap, numVoices, &leaf->mempool);
+}
+
+void tPhaseVocoder_initToPool (tPhaseVocoder* const pvr, int fftSize, int overlap, int numVoices, tMempool* const mp)
+{
+    LEAF_PROFILE_POOL(mp);
+    _tMempool* m = *mp;
+    _tPhaseVocoder* pv = *pvr = (_tPhaseVocoder*) mpool_alloc(sizeof(_tPhaseVocoder), m);
+    pv->mempool = m;
+    
+    int n = 64;
+    while (n < fftSize && n < 8192) n <<= 1;
+    if (overlap < 8) overlap = 4;
+    else overlap = 8;
+    if (numVoices < 1) numVoices = 1;
+    
+    pv->fftSize = n;
+    pv->hopSize = n / overlap;
+    pv->mask = n - 1;
+    pv->numVoices = numVoices;
+    pv->writePos = 0;
+    pv->hopCount = 0;
+    pv->transientThreshold = 0.3f;
+    
+    tRealFFT_initToPool(&pv->fft, n, mp);
+    
+    int bins = n / 2 + 1;
+    pv->window = (float*) mpool_alloc(sizeof(float) * n, m);
+    pv->inBuffer = (float*) mpool_calloc(sizeof(float) * n, m);
+    pv->frame = (float*) mpool_alloc(sizeof(float) * n, m);
+    pv->magnitude = (float*) mpool_alloc(sizeof(float) * bins, m);
+    pv->frequency = (float*) mpool_alloc(sizeof(float) * bins, m);
+    pv->phase = (float*) mpool_alloc(sizeof(float) * bins, m);
+    pv->lastPhase = (float*) mpool_calloc(sizeof(float) * bins, m);
+    pv->lastMagnitude = (float*) mpool_calloc(sizeof(float) * bins, m);
+    pv->shiftedMagnitude = (float*) mpool_alloc(sizeof(float) * bins, m);
+    pv->shiftedPhase = (float*) mpool_alloc(sizeof(float) * bins, m);
+    pv->peaks = (int*) mpool_alloc(sizeof(int) * bins, m);
+    pv->strongest = (float*) mpool_alloc(sizeof(float) * bins, m);
+    
+    pv->factors = (float*) mpool_alloc(sizeof(float) * numVoices, m);
+    pv->output = (float*) mpool_calloc(sizeof(float) * numVoices, m);
+    pv->synthPhase = (float**) mpool_alloc(sizeof(float*) * numVoices, m);
+    pv->outAccum = (float**) mpool_alloc(sizeof(float*) * numVoices, m);
+    for (int v = 0; v < numVoices; v++)
+    {
+        pv->factors[v] = 1.0f;
+        pv->synthPhase[v] = (float*) mpool_calloc(sizeof(float) * bins, m);
+        pv->outAccum[v] = (float*) mpool_calloc(sizeof(float) * n, m);
+    }
+    
+    // Hann analysis and synthesis windows overlap-add to 3/8 of the overlap
+    for (int i = 0; i < n; i++)
+    {
+        pv->window[i] = 0.5f - 0.5f * cosf(TWO_PI * (float) i / (float) n);
+    }
+    pv->outGain = 1.0f / (0.375f * (float) overlap);
+}
+
+void tPhaseVocoder_free (tPhaseVocoder* const pvr)
+{
+    _tPhaseVocoder* pv = *pvr;
+    
+    for (int v = 0; v < pv->numVoices; v++)
+    {
+        mpool_free((char*)pv->outAccum[v], pv->mempool);
+        mpool_free((char*)pv->synthPhase[v], pv->mempool);
+    }
+    mpool_free((char*)pv->outAccum, pv->mempool);
+    mpool_free((char*)pv->synthPhase, pv->mempool);
+    mpool_free((char*)pv->output, pv->mempool);
+    mpool_free((char*)pv->factors, pv->mempool);
+    mpool_free((char*)pv->strongest, pv->mempool);
+    mpool_free((char*)pv->peaks, pv->mempool);
+    mpool_free((char*)pv->shiftedPhase, pv->mempool);
+    mpool_free((char*)pv->shiftedMagnitude, pv->mempool);
+    mpool_free((char*)pv->lastMagnitude, pv->mempool);
+    mpool_free((char*)pv->lastPhase, pv->mempool);
+    mpool_free((char*)pv->phase, pv->mempool);
+    mpool_free((char*)pv->frequency, pv->mempool);
+    mpool_free((char*)pv->magnitude, pv->mempool);
+    mpool_free((char*)pv->frame, pv->mempool);
+    mpool_free((char*)pv->inBuffer, pv->mempool);
+    mpool_free((char*)pv->window, pv->mempool);
+    tRealFFT_free(&pv->fft);
+    mpool_free((char*)pv, pv->mempool);
+}
+
+// Windows and transforms the last fftSize samples, and works out each bin's magnitude, phase and
+// true frequency from how far its phase moved since the last hop. Returns whether the frame is a transient.
+static int tPhaseVocoder_analyse(_tPhaseVocoder* const pv)
+{
+    int n = pv->fftSize;
+    int bins = n / 2 + 1;
+    float* frame = pv->frame;
+    
+    for (int i = 0; i < n; i++)
+    {
+        frame[i] = pv->inBuffer[(pv->writePos + i) & pv->mask] * pv->window[i];
+    }
+    
+    tRealFFT_forward(&pv->fft, frame);
+    
+    float expected = TWO_PI * (float) pv->hopSize / (float) n;
+    float toBins = (float) n / (TWO_PI * (float) pv->hopSize);
+    float flux = 0.0f, total = 0.0f;
+    
+    for (int k = 0; k < bins; k++)
+    {
+        float re, im;
+        if (k == 0)             { re = frame[0]; im = 0.0f; }
+        else if (k == n / 2)    { re = frame[1]; im = 0.0f; }
+        else                    { re = frame[2 * k]; im = frame[2 * k + 1]; }
+        
+        float mag = sqrtf(re * re + im * im);
+        float ph = atan2f(im, re);
+        
+        float delta = ph - pv->lastPhase[k] - (float) k * expected;
+        delta -= TWO_PI * floorf(delta / TWO_PI + 0.5f);
+        
+        pv->magnitude[k] = mag;
+        pv->phase[k] = ph;
+        pv->frequency[k] = (float) k + delta * toBins;
+        pv->lastPhase[k] = ph;
+        
+        float rise = mag - pv->lastMagnitude[k];
+        if (rise > 0.0f) flux += rise;
+        total += mag;
+        pv->lastMagnitude[k] = mag;
+    }
+    
+    return total > 0.0f && flux > pv->transientThreshold * total;
+}
+
+// Builds one voice's spectrum in frame, inverse transforms it and adds it into the voice's output
+static void tPhaseVocoder_synthesize(_tPhaseVocoder* const pv, int v, int transient)
+{
+    int n = pv->fftSize;
+    int half = n / 2;
+    float factor = pv->factors[v];
+    float* synthPhase = pv->synthPhase[v];
+    float* frame = pv->frame;
+    float* mag;
+    
+    if (factor == 1.0f)
+    {
+        // Straight resynthesis, keeping the phases in step for when the factor moves again
+        mag = pv->magnitude;
+        for (int k = 0; k <= half; k++) synthPhase[k] = pv->phase[k];
+    }
+    else
+    {
+        // Each peak moves with the bins around it as a block, and those bins keep their phases
+        // relative to the peak's, so partials keep their shape and amplitude
+        float* smag = pv->shiftedMagnitude;
+        float* sphase = pv->shiftedPhase;
+        float* strongest = pv->strongest;
+        int* peaks = pv->peaks;
+        float* amag = pv->magnitude;
+        float* aphase = pv->phase;
+        float advance = TWO_PI * (float) pv->hopSize / (float) n;
+        
+        int numPeaks = 0;
+        for (int k = 1; k < half; k++)
+        {
+            if (amag[k] > amag[k - 1] && amag[k] >= amag[k + 1]) peaks[numPeaks++] = k;
+        }
+        
+        for (int k = 0; k <= half; k++)
+        {
+            smag[k] = 0.0f;
+            sphase[k] = synthPhase[k];
+            strongest[k] = 0.0f;
+        }
+        
+        for (int i = 0; i < numPeaks; i++)
+        {
+            int p = peaks[i];
+            int lo = (i == 0) ? 0 : (peaks[i - 1] + p) / 2 + 1;
+            int hi = (i == numPeaks - 1) ? half : (p + peaks[i + 1]) / 2;
+            int target = (int) ((float) p * factor + 0.5f);
+            if (target > half) break;
+            int shift = target - p;
+            
+            float peakPhase;
+            if (transient) peakPhase = aphase[p];
+            else peakPhase = synthPhase[target] + pv->frequency[p] * factor * advance;
+            
+            for (int k = lo; k <= hi; k++)
+            {
+                int t = k + shift;
+                if (t < 0) continue;
+                if (t > half) break;
+                float m = amag[k];
+                smag[t] += m;
+                if (m > strongest[t])
+                {
+                    strongest[t] = m;
+                    sphase[t] = peakPhase + (aphase[k] - aphase[p]);
+                }
+            }
+        }
+        
+        for (int k = 0; k <= half; k++)
+        {
+            float ph = sphase[k];
+            synthPhase[k] = ph - TWO_PI * floorf(ph / TWO_PI + 0.5f);
+        }
+        mag = smag;
+    }
+    
+    frame[0] = mag[0] * cosf(synthPhase[0]);
+    frame[1] = mag[half] * cosf(synthPhase[half]);
+    for (int k = 1; k < half; k++)
+    {
+        frame[2 * k] = mag[k] * cosf(synthPhase[k]);
+        frame[2 * k + 1] = mag[k] * sinf(synthPhase[k]);
+    }
+    
+    tRealFFT_inverse(&pv->fft, frame);
+    
+    // The frame ending on the newest input sample comes out a full frame later
+    float* acc = pv->outAccum[v];
+    float g = pv->outGain;
+    for (int i = 0; i < n; i++)
+    {
+        acc[(pv->writePos + i) & pv->mask] += frame[i] * pv->window[i] * g;
+    }
+}
+
+float* tPhaseVocoder_tick (tPhaseVocoder* const pvr, float input)
+{
+    LEAF_PROFILE_OBJECT(pvr);
+    _tPhaseVocoder* pv = *pvr;
+    
+    int w = pv->writePos;
+    for (int v = 0; v < pv->numVoices; v++)
+    {
+        pv->output[v] = pv->outAccum[v][w];
+        pv->outAccum[v][w] = 0.0f;
+    }
+    
+    pv->inBuffer[w] = input;
+    pv->writePos = (w + 1) & pv->mask;
+    
+    if (++pv->hopCount >= pv->hopSize)
+    {
+        pv->hopCount = 0;
+        int transient = tPhaseVocoder_analyse(pv);
+        for (int v = 0; v < pv->numVoices; v++)
+        {
+            tPhaseVocoder_synthesize(pv, v, transient);
+        }
+    }
+    
+    return pv->output;
+}
+
+void tPhaseVocoder_tickBlock (tPhaseVocoder* const pvr, const float* input, float** outputs, int size)
+{
+    LEAF_PROFILE_OBJECT(pvr);
+    _tPhaseVocoder* pv = *pvr;
+    
+    for (int i = 0; i < size; i++)
+    {
+        float* out = tPhaseVocoder_tick(pvr, input[i]);
+        for (int v = 0; v < pv->numVoices; v++) outputs[v][i] = out[v];
+    }
+}
+
+void tPhaseVocoder_setPitchFactor (tPhaseVocoder* const pvr, int voice, float factor)
+{
+    _tPhaseVocoder* pv = *pvr;
+    pv->factors[voice] = LEAF_clip(0.25f, factor, 4.0f);
+}
+
+void tPhaseVocoder_setTransientThreshold (tPhaseVocoder* const pvr, float threshold)
+{
+    _tPhaseVocoder* pv = *pvr;
+    pv->transientThreshold = LEAF_clip(0.0f, threshold, 1.0f);
+}
+
+int tPhaseVocoder_getLatency (tPhaseVocoder* const pvr)
+{
+    _tPhaseVocoder* pv = *pvr;
+    return pv->fftSize;
+}
+
 //============================================================================================================
 // SIMPLERETUNE
 //============================================================================================================
@@ -1493,6 +2312,7 @@ void tSimpleRetune_init (tSimpleRetune* const rt, int numVoices, float minInputF
 
 void tSimpleRetune_initToPool (tSimpleRetune* const rt, int numVoices, float minInputFreq, float maxInputFreq, int bufSize, tMempool* const mp)
 {
+    LEAF_PROFILE_POOL(mp);
     _tMempool* m = *mp;
     _tSimpleRetune* r = *rt = (_tSimpleRetune*) mpool_calloc(sizeof(_tSimpleRetune), m);
     r->mempool = *mp;
@@ -1513,9 +2333,11 @@ void tSimpleRetune_initToPool (tSimpleRetune* const rt, int numVoices, float min
     r->maxInputFreq = maxInputFreq;
     tDualPitchDetector_initToPool(&r->dp, r->minInputFreq, r->maxInputFreq, r->pdBuffer, 2048, mp);
     
-    for (int i = 0; i < r->numVoices; ++i)
+    // Every voice reads the first one's input buffer, which must be shifted first
+    tPitchShift_initToPool(&r->ps[0], &r->dp, r->bufSize, mp);
+    for (int i = 1; i < r->numVoices; ++i)
     {
-        tPitchShift_initToPool(&r->ps[i], &r->dp, r->bufSize, mp);
+        tPitchShift_initToPoolShared(&r->ps[i], &r->ps[0], mp);
     }
     
     r->shiftFunction = &tPitchShift_shiftBy;
@@ -1532,6 +2354,7 @@ void tSimpleRetune_free (tSimpleRetune* const rt)
     }
     mpool_free((char*)r->shiftValues, r->mempool);
     mpool_free((char*)r->ps, r->mempool);
+    mpool_free((char*)r->pdBuffer, r->mempool);
     mpool_free((char*)r->inBuffer, r->mempool);
     mpool_free((char*)r->outBuffer, r->mempool);
     mpool_free((char*)r, r->mempool);
@@ -1539,6 +2362,7 @@ void tSimpleRetune_free (tSimpleRetune* const rt)
 
 float tSimpleRetune_tick(tSimpleRetune* const rt, float sample)
 {
+    LEAF_PROFILE_OBJECT(rt);
     _tSimpleRetune* r = *rt;
     
     tDualPitchDetector_tick(&r->dp, sample);
@@ -1578,7 +2402,7 @@ void tSimpleRetune_setNumVoices(tSimpleRetune* const rt, int numVoices)
     tMempool mempool = r->mempool;
     
     tSimpleRetune_free(rt);
-    tSimpleRetune_initToPool(rt, minInputFreq, maxInputFreq, numVoices, bufSize, &mempool);
+    tSimpleRetune_initToPool(rt, numVoices, minInputFreq, maxInputFreq, bufSize, &mempool);
 }
 
 void tSimpleRetune_setPickiness (tSimpleRetune* const rt, float p)
@@ -1636,6 +2460,7 @@ void tRetune_init(tRetune* const rt, int numVoices, float minInputFreq, float ma
 
 void tRetune_initToPool (tRetune* const rt, int numVoices, float minInputFreq, float maxInputFreq, int bufSize, tMempool* const mp)
 {
+    LEAF_PROFILE_POOL(mp);
     _tMempool* m = *mp;
     _tRetune* r = *rt = (_tRetune*) mpool_calloc(sizeof(_tRetune), m);
     r->mempool = *mp;
@@ -1645,21 +2470,24 @@ void tRetune_initToPool (tRetune* const rt, int numVoices, float minInputFreq, f
     
     r->pdBuffer = (float*) mpool_alloc(sizeof(float) * 2048, m);
     r->inBuffer = (float*) mpool_calloc(sizeof(float) * r->bufSize, m);
-
+    
     r->index = 0;
-
+    
     r->ps = (tPitchShift*) mpool_calloc(sizeof(tPitchShift) * r->numVoices, m);
     r->shiftValues = (float*) mpool_calloc(sizeof(float) * r->numVoices, m);
     r->outBuffers = (float**) mpool_calloc(sizeof(float*) * r->numVoices, m);
     r->output = (float*) mpool_calloc(sizeof(float) * r->numVoices, m);
+    r->blockOutputs = (float**) mpool_calloc(sizeof(float*) * r->numVoices, m);
     
     r->minInputFreq = minInputFreq;
     r->maxInputFreq = maxInputFreq;
     tDualPitchDetector_initToPool(&r->dp, r->minInputFreq, r->maxInputFreq, r->pdBuffer, 2048, mp);
-
+    
+    // Every voice reads the first one's input buffer, which must be shifted first
     for (int i = 0; i < r->numVoices; ++i)
     {
-        tPitchShift_initToPool(&r->ps[i], &r->dp, r->bufSize, mp);
+        if (i == 0) tPitchShift_initToPool(&r->ps[i], &r->dp, r->bufSize, mp);
+        else tPitchShift_initToPoolShared(&r->ps[i], &r->ps[0], mp);
         r->outBuffers[i] = (float*) mpool_calloc(sizeof(float) * r->bufSize, m);
     }
     
@@ -1671,6 +2499,7 @@ void tRetune_free (tRetune* const rt)
     _tRetune* r = *rt;
     
     tDualPitchDetector_free(&r->dp);
+    if (r->pvSize > 0) tPhaseVocoder_free(&r->pv);
     for (int i = 0; i < r->numVoices; ++i)
     {
         tPitchShift_free(&r->ps[i]);
@@ -1682,22 +2511,48 @@ void tRetune_free (tRetune* const rt)
     mpool_free((char*)r->inBuffer, r->mempool);
     mpool_free((char*)r->outBuffers, r->mempool);
     mpool_free((char*)r->output, r->mempool);
+    mpool_free((char*)r->blockOutputs, r->mempool);
     mpool_free((char*)r, r->mempool);
 }
 
+        // Factors are updated once a buffer, as the tPitchShift engine does
+static void tRetune_setVocoderFactors(_tRetune* const r)
+        {
+            float detected = tDualPitchDetector_getFrequency(&r->dp);
+            float periodicity = tDualPitchDetector_getPeriodicity(&r->dp);
+            int tuneTo = r->shiftFunction == &tPitchShift_shiftTo;
+            for (int i = 0; i < r->numVoices; ++i)
+            {
+                if (!tuneTo) tPhaseVocoder_setPitchFactor(&r->pv, i, r->shiftValues[i]);
+                else if (detected > 0.0f && periodicity > 0.0f)
+                    tPhaseVocoder_setPitchFactor(&r->pv, i, r->shiftValues[i] / detected);
+            }
+        }
+
 float* tRetune_tick(tRetune* const rt, float sample)
 {
+    LEAF_PROFILE_OBJECT(rt);
     _tRetune* r = *rt;
     
     tDualPitchDetector_tick(&r->dp, sample);
     
+    if (r->pvSize > 0)
+    {
+        if (r->index == 0) tRetune_setVocoderFactors(r);
+        if (++r->index >= r->bufSize) r->index = 0;
+        
+        float* out = tPhaseVocoder_tick(&r->pv, sample);
+        for (int i = 0; i < r->numVoices; ++i) r->output[i] = out[i];
+        return r->output;
+    }
+    
     r->inBuffer[r->index] = sample;
     for (int i = 0; i < r->numVoices; ++i)
     {
         r->output[i] = r->outBuffers[i][r->index];
         r->outBuffers[i][r->index] = 0.0f;
     }
-
+    
     r->index++;
     if (r->index >= r->bufSize)
     {
@@ -1707,10 +2562,67 @@ float* tRetune_tick(tRetune* const rt, float sample)
         }
         r->index = 0;
     }
-     
+    
     return r->output;
 }
 
+void tRetune_tickBlock(tRetune* const rt, const float* input, float** outputs, int size)
+{
+    LEAF_PROFILE_OBJECT(rt);
+    _tRetune* r = *rt;
+    
+    // Run up to each buffer boundary, where the voices are shifted or the factors updated
+    int done = 0;
+    while (done < size)
+    {
+        int n = r->bufSize - r->index;
+        if (n > size - done) n = size - done;
+        const float* in = input + done;
+        
+        if (r->pvSize > 0)
+        {
+            tDualPitchDetector_tick(&r->dp, in[0]);
+            if (r->index == 0) tRetune_setVocoderFactors(r);
+            for (int j = 1; j < n; ++j) tDualPitchDetector_tick(&r->dp, in[j]);
+            
+            for (int i = 0; i < r->numVoices; ++i) r->blockOutputs[i] = outputs[i] + done;
+            tPhaseVocoder_tickBlock(&r->pv, in, r->blockOutputs, n);
+            
+            r->index += n;
+            if (r->index >= r->bufSize) r->index = 0;
+        }
+        else
+        {
+            for (int j = 0; j < n; ++j)
+            {
+                tDualPitchDetector_tick(&r->dp, in[j]);
+                r->inBuffer[r->index + j] = in[j];
+            }
+            for (int i = 0; i < r->numVoices; ++i)
+            {
+                float* buf = r->outBuffers[i] + r->index;
+                float* out = outputs[i] + done;
+                for (int j = 0; j < n; ++j)
+                {
+                    out[j] = buf[j];
+                    buf[j] = 0.0f;
+                }
+            }
+            
+            r->index += n;
+            if (r->index >= r->bufSize)
+            {
+                for (int i = 0; i < r->numVoices; ++i)
+                {
+                    r->shiftFunction(&r->ps[i], r->shiftValues[i], r->inBuffer, r->outBuffers[i]);
+                }
+                r->index = 0;
+            }
+        }
+        done += n;
+    }
+}
+
 void tRetune_setMode (tRetune* const rt, int mode)
 {
     _tRetune* r = *rt;
@@ -1733,10 +2645,13 @@ void tRetune_setNumVoices(tRetune* const rt, int numVoices)
     int bufSize = r->bufSize;
     float minInputFreq = r->minInputFreq;
     float maxInputFreq = r->maxInputFreq;
+    int pvSize = r->pvSize;
+    int pvOverlap = r->pvOverlap;
     tMempool mempool = r->mempool;
     
     tRetune_free(rt);
-    tRetune_initToPool(rt, minInputFreq, maxInputFreq, numVoices, bufSize, &mempool);
+    tRetune_initToPool(rt, numVoices, minInputFreq, maxInputFreq, bufSize, &mempool);
+    tRetune_setPhaseVocoder(rt, pvSize, pvOverlap);
 }
 
 void tRetune_tuneVoices(tRetune* const rt, float* t)
@@ -1773,6 +2688,21 @@ void tRetune_setSampleRate(tRetune* const rt, float sr)
     }
 }
 
+void tRetune_setPhaseVocoder(tRetune* const rt, int fftSize, int overlap)
+{
+    _tRetune* r = *rt;
+    
+    if (r->pvSize > 0) tPhaseVocoder_free(&r->pv);
+    r->pvSize = 0;
+    
+    if (fftSize > 0)
+    {
+        tPhaseVocoder_initToPool(&r->pv, fftSize, overlap, r->numVoices, &r->mempool);
+        r->pvSize = fftSize;
+        r->pvOverlap = overlap;
+    }
+}
+
 //============================================================================================================
 // FORMANTSHIFTER
 //============================================================================================================
@@ -1785,6 +2715,7 @@ void tFormantShifter_init (tFormantShifter* const fsr, int order, LEAF* const le
 
 void tFormantShifter_initToPool (tFormantShifter* const fsr, int order, tMempool* const mp)
 {
+    LEAF_PROFILE_POOL(mp);
     _tMempool* m = *mp;
     _tFormantShifter* fs = *fsr = (_tFormantShifter*) mpool_alloc(sizeof(_tFormantShifter), m);
     fs->mempool = m;
@@ -1802,7 +2733,7 @@ void tFormantShifter_initToPool (tFormantShifter* const fsr, int order, tMempool
     fs->ftvec = (float*) mpool_calloc(sizeof(float) * fs->ford, m);
     
     fs->fbuff = (float*) mpool_calloc(sizeof(float*) * fs->ford, m);
-
+    
     fs->sampleRate = leaf->sampleRate;
     fs->invSampleRate = leaf->invSampleRate;
     
@@ -1844,6 +2775,7 @@ void tFormantShifter_free (tFormantShifter* const fsr)
 
 float tFormantShifter_tick(tFormantShifter* const fsr, float in)
 {
+    LEAF_PROFILE_OBJECT(fsr);
     return tFormantShifter_add(fsr, tFormantShifter_remove(fsr, in));
 }
 
@@ -1853,9 +2785,9 @@ float tFormantShifter_remove(tFormantShifter* const fsr, float in)
     in = tFeedbackLeveler_tick(&fs->fbl1, in);
     in = tHighpass_tick(&fs->hp, in * fs->intensity);
     
-
+    
     float fa, fb, fc, foma, falph, ford, flamb, tf, fk;
-
+    
     ford = fs->ford;
     falph = fs->falph;
     foma = (1.0f - falph);
@@ -1881,7 +2813,7 @@ float tFormantShifter_remove(tFormantShifter* const fsr, float in)
         fb = fc - tf*fa;
         fa = fa - tf*fc;
     }
-
+    
     //return fa * 0.1f;
     return fa;
 }
@@ -1892,7 +2824,7 @@ float tFormantShifter_add(tFormantShifter* const fsr, float in)
     
     float fa, fb, fc, ford, flpa, flamb, tf, tf2, f0resp, f1resp, frlamb;
     ford = fs->ford;
-
+    
     flpa = fs->flpa;
     flamb = fs->flamb;
     tf = fs->shiftFactor * (1.0f+flamb)/(1.0f-flamb);
@@ -1979,7 +2911,7 @@ float tFormantShifter_add(tFormantShifter* const fsr, float in)
     // ...and we're done messing with formants
     //tf = tFeedbackLeveler_tick(&fs->fbl2, tf);
     tf = tHighpass_tick(&fs->hp2, tanhf(tf));
-
+    
     return tf * fs->invIntensity;
 }
 
@@ -1993,9 +2925,9 @@ void tFormantShifter_setShiftFactor(tFormantShifter* const fsr, float shiftFacto
 void tFormantShifter_setIntensity(tFormantShifter* const fsr, float intensity)
 {
     _tFormantShifter* fs = *fsr;
-
+    
     fs->intensity = LEAF_clip(1.0f, intensity, 100.0f);
-
+   
    // tFeedbackLeveler_setTargetLevel(&fs->fbl1, fs->intensity);
     //tFeedbackLeveler_setTargetLevel(&fs->fbl2, fs->intensity);
     //make sure you don't divide by zero, doofies
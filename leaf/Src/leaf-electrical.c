@@ -172,8 +172,10 @@ void tWDF_init(tWDF* const wdf, WDFComponentType type, float value, tWDF* const
 
 void    tWDF_initToPool(tWDF* const wdf, WDFComponentType type, float value, tWDF* const rL, tWDF* const rR, tMempool* const mp)
 {
+    LEAF_PROFILE_POOL(mp);
     _tMempool* m = *mp;
-    *wdf = (_tWDF*) mpool_alloc(sizeof(_tWDF), m);
+    _tWDF* r = *wdf = (_tWDF*) mpool_alloc(sizeof(_tWDF), m);
+    r->mempool = m;
     
     wdf_init(wdf, type, value, rL, rR);
 }
@@ -187,6 +189,7 @@ void    tWDF_free (tWDF* const wdf)
 
 float tWDF_tick(tWDF* const wdf, float sample, tWDF* const outputPoint, uint8_t paramsChanged)
 {
+    LEAF_PROFILE_OBJECT(wdf);
     _tWDF* r = *wdf;
     
     tWDF* child;
@@ -195,19 +198,19 @@ float tWDF_tick(tWDF* const wdf, float sample, tWDF* const outputPoint, uint8_t
     
     //step 0 : update port resistances if something changed
     if (paramsChanged) tWDF_getPortResistance(wdf);
-
+    
     //step 1 : set inputs to what they should be
     float input = sample;
-
+    
     //step 2 : scan the waves up the tree
     r->incident_wave_up = tWDF_getReflectedWaveUp(child, input);
-
+    
     //step 3 : do root scattering computation
     r->reflected_wave_up = tWDF_getReflectedWaveDown(wdf, input, r->incident_wave_up);
-
+    
     //step 4 : propogate waves down the tree
     tWDF_setIncidentWave(child, r->reflected_wave_up, input);
-
+    
     //step 5 : grab whatever voltages or currents we want as outputs
     return tWDF_getVoltage(outputPoint);
 }
@@ -287,7 +290,7 @@ static float get_port_resistance_for_resistor(tWDF* const wdf)
     
     r->port_resistance_up = r->value;
     r->port_conductance_up = 1.0f / r->value;
-
+    
     return r->port_resistance_up;
 }
 
@@ -297,7 +300,7 @@ static float get_port_resistance_for_capacitor(tWDF* const wdf)
     
     r->port_conductance_up = r->sample_rate * 2.0f * r->value; //based on trapezoidal discretization
     r->port_resistance_up = (1.0f / r->port_conductance_up);
-
+    
     return r->port_resistance_up;
 }
 
@@ -342,7 +345,7 @@ static float get_port_resistance_for_series(tWDF* const wdf)
     r->port_conductance_left = 1.0f / r->port_resistance_left;
     r->port_conductance_right = 1.0f / r->port_resistance_right;
     r->gamma_zero = 1.0f / (r->port_resistance_right + r->port_resistance_left);
-
+    
     return r->port_resistance_up;
 }
 
@@ -357,7 +360,7 @@ static float get_port_resistance_for_parallel(tWDF* const wdf)
     r->port_conductance_left = 1.0f / r->port_resistance_left;
     r->port_conductance_right = 1.0f / r->port_resistance_right;
     r->gamma_zero = 1.0f / (r->port_conductance_right + r->port_conductance_left);
-
+    
     return r->port_resistance_up;
 }
 
@@ -522,23 +525,461 @@ static float lambertW(float a, float r, float I, float iVT)
 
 #define Is_DIODE    2.52e-9f
 #define VT_DIODE    0.02585f
-static float get_reflected_wave_for_diode(tWDF* const wdf, float input, float incident_wave)
+static float wdf_diode(float a, float r)
 {
-    _tWDF* n = *wdf;
-    
-    float a = incident_wave;
-    float r = n->port_resistance_up;
     return a + 2.0f*r*Is_DIODE - 2.0f*VT_DIODE*lambertW(a, r, Is_DIODE, 1.0f/VT_DIODE);
 }
 
-static float get_reflected_wave_for_diode_pair(tWDF* const wdf, float input, float incident_wave)
+static float wdf_diode_pair(float a, float r)
 {
-    _tWDF* n = *wdf;
-    
-    float a = incident_wave;
     float sgn = 0.0f;
     if (a > 0.0f) sgn = 1.0f;
     else if (a < 0.0f) sgn = -1.0f;
-    float r = n->port_resistance_up;
     return a + 2 * sgn * (r*Is_DIODE - VT_DIODE*lambertW(sgn*a, r, Is_DIODE, 1.0f/VT_DIODE));
 }
+
+static float get_reflected_wave_for_diode(tWDF* const wdf, float input, float incident_wave)
+{
+    _tWDF* n = *wdf;
+    return wdf_diode(incident_wave, n->port_resistance_up);
+}
+
+static float get_reflected_wave_for_diode_pair(tWDF* const wdf, float input, float incident_wave)
+{
+    _tWDF* n = *wdf;
+    return wdf_diode_pair(incident_wave, n->port_resistance_up);
+}
+
+//===================================================================
+//================ Compiled WDF =====================================
+
+// Nodes are stored children first, so the root is always last. Scanning up the tree is one pass forwards
+// through the arrays and propagating down is one pass backwards, with each node's reflected wave kept
+// from the way up instead of asking the children for it again.
+
+static int wdfProgram_countNodes(tWDF* const wdf)
+{
+    _tWDF* r = *wdf;
+    int count = 1;
+    if (r->child_left != NULL) count += wdfProgram_countNodes(r->child_left);
+    if (r->child_right != NULL) count += wdfProgram_countNodes(r->child_right);
+    return count;
+}
+
+static int wdfProgram_addNode(_tWDFProgram* const p, tWDF* const wdf, int* numNodes)
+{
+    _tWDF* r = *wdf;
+    int left = -1;
+    int right = -1;
+    if (r->child_left != NULL) left = wdfProgram_addNode(p, r->child_left, numNodes);
+    if (r->child_right != NULL) right = wdfProgram_addNode(p, r->child_right, numNodes);
+    
+    int i = (*numNodes)++;
+    p->nodes[i] = wdf;
+    p->type[i] = (uint8_t) r->type;
+    p->left[i] = left;
+    p->right[i] = right;
+    p->value[i] = r->value;
+    p->sampleRate[i] = r->sample_rate;
+    // Start from the tree's current coefficients and waves, so the program picks up exactly where it left off
+    p->resistance[i] = r->port_resistance_up;
+    p->conductance[i] = r->port_conductance_up;
+    p->resistanceLeft[i] = r->port_resistance_left;
+    p->resistanceRight[i] = r->port_resistance_right;
+    p->conductanceLeft[i] = r->port_conductance_left;
+    p->conductanceRight[i] = r->port_conductance_right;
+    p->gammaZero[i] = r->gamma_zero;
+    p->incident[i] = r->incident_wave_up;
+    p->reflected[i] = r->reflected_wave_up;
+    return i;
+}
+
+static void wdfProgram_setGammas(_tWDFProgram* const p, int i)
+{
+    if (p->type[i] == SeriesAdaptor)
+    {
+        p->gammaLeft[i] = p->resistanceLeft[i] * p->gammaZero[i];
+        p->gammaRight[i] = p->resistanceRight[i] * p->gammaZero[i];
+    }
+    else if (p->type[i] == ParallelAdaptor)
+    {
+        p->gammaLeft[i] = p->conductanceLeft[i] * p->gammaZero[i];
+        p->gammaRight[i] = p->conductanceRight[i] * p->gammaZero[i];
+    }
+}
+
+static float wdfProgram_solveRoot(_tWDFProgram* const p, float a, float r)
+{
+    if (p->type[p->numNodes - 1] == DiodePair) return wdf_diode_pair(a, r);
+    return wdf_diode(a, r);
+}
+
+static void wdfProgram_fillRootRow(_tWDFProgram* const p, float* row, float r)
+{
+    float step = (2.0f * p->rootTableMaxWave) / (p->rootTableWaves - 1);
+    for (int j = 0; j < p->rootTableWaves; ++j)
+        row[j] = wdfProgram_solveRoot(p, -p->rootTableMaxWave + j * step, r);
+}
+
+// Find the port resistance of the root in the root table, or rebuild a single row table for it
+static void wdfProgram_placeRootTable(_tWDFProgram* const p)
+{
+    float r = p->resistance[p->numNodes - 1];
+    p->rootRowValid = 1;
+    if (p->rootTableResistances == 1)
+    {
+        wdfProgram_fillRootRow(p, p->rootTable, r);
+        p->rootRow = 0;
+        p->rootRowFrac = 0.0f;
+        return;
+    }
+    // Resistances are spaced logarithmically, and anything off the grid goes back to the solver
+    if (r < p->rootTableMinResistance || r > p->rootTableMaxResistance)
+    {
+        p->rootRowValid = 0;
+        return;
+    }
+    float pos = logf(r / p->rootTableMinResistance) * p->rootTableInvLogRange * (p->rootTableResistances - 1);
+    int row = (int) pos;
+    if (row >= p->rootTableResistances - 1) row = p->rootTableResistances - 2;
+    p->rootRow = row;
+    p->rootRowFrac = pos - row;
+}
+
+static inline float wdfProgram_readRootTable(_tWDFProgram* const p, float a)
+{
+    float x = (a + p->rootTableMaxWave) * p->rootTableInvStep;
+    int j = (int) x;
+    if (j >= p->rootTableWaves - 1) j = p->rootTableWaves - 2;
+    float frac = x - j;
+    
+    const float* row = p->rootTable + p->rootRow * p->rootTableWaves;
+    float b = row[j] + frac * (row[j + 1] - row[j]);
+    if (p->rootRowFrac > 0.0f)
+    {
+        row += p->rootTableWaves;
+        float b1 = row[j] + frac * (row[j + 1] - row[j]);
+        b += p->rootRowFrac * (b1 - b);
+    }
+    return b;
+}
+
+// Same as tWDF_getPortResistance on the root, children first
+static void wdfProgram_updateResistances(_tWDFProgram* const p)
+{
+    for (int i = 0; i < p->numNodes; ++i)
+    {
+        int left = p->left[i];
+        int right = p->right[i];
+        switch (p->type[i])
+        {
+            case Resistor:
+            case ResistiveSource:
+                p->resistance[i] = p->value[i];
+                p->conductance[i] = 1.0f / p->resistance[i];
+                break;
+            
+            case Capacitor:
+                p->conductance[i] = p->sampleRate[i] * 2.0f * p->value[i];
+                p->resistance[i] = (1.0f / p->conductance[i]);
+                break;
+            
+            case Inductor:
+                p->resistance[i] = p->sampleRate[i] * 2.0f * p->value[i];
+                p->conductance[i] = (1.0f / p->resistance[i]);
+                break;
+            
+            case Inverter:
+                p->resistance[i] = p->resistance[left];
+                p->conductance[i] = 1.0f / p->resistance[i];
+                break;
+            
+            case SeriesAdaptor:
+                p->resistanceLeft[i] = p->resistance[left];
+                p->resistanceRight[i] = p->resistance[right];
+                p->resistance[i] = p->resistanceLeft[i] + p->resistanceRight[i];
+                p->conductance[i] = 1.0f / p->resistance[i];
+                p->conductanceLeft[i] = 1.0f / p->resistanceLeft[i];
+                p->conductanceRight[i] = 1.0f / p->resistanceRight[i];
+                p->gammaZero[i] = 1.0f / (p->resistanceRight[i] + p->resistanceLeft[i]);
+                break;
+            
+            case ParallelAdaptor:
+                p->resistanceLeft[i] = p->resistance[left];
+                p->resistanceRight[i] = p->resistance[right];
+                p->resistance[i] = (p->resistanceLeft[i] * p->resistanceRight[i]) / (p->resistanceLeft[i] + p->resistanceRight[i]);
+                p->conductance[i] = 1.0f / p->resistance[i];
+                p->conductanceLeft[i] = 1.0f / p->resistanceLeft[i];
+                p->conductanceRight[i] = 1.0f / p->resistanceRight[i];
+                p->gammaZero[i] = 1.0f / (p->conductanceRight[i] + p->conductanceLeft[i]);
+                break;
+            
+            default: // roots
+                p->resistance[i] = p->resistance[left >= 0 ? left : right];
+                p->conductance[i] = 1.0f / p->resistance[i];
+                break;
+        }
+        wdfProgram_setGammas(p, i);
+    }
+    if (p->rootTable != NULL) wdfProgram_placeRootTable(p);
+    p->dirty = 0;
+}
+
+void    tWDFProgram_init            (tWDFProgram* const prog, tWDF* const root, tWDF* const outputPoint, LEAF* const leaf)
+{
+    tWDFProgram_initToPool(prog, root, outputPoint, &leaf->mempool);
+}
+
+void    tWDFProgram_initToPool      (tWDFProgram* const prog, tWDF* const root, tWDF* const outputPoint, tMempool* const mp)
+{
+    LEAF_PROFILE_POOL(mp);
+    _tMempool* m = *mp;
+    _tWDFProgram* p = *prog = (_tWDFProgram*) mpool_alloc(sizeof(_tWDFProgram), m);
+    p->mempool = m;
+    
+    int n = wdfProgram_countNodes(root);
+    p->nodes = (tWDF**) mpool_alloc(sizeof(tWDF*) * n, m);
+    p->type = (uint8_t*) mpool_alloc(sizeof(uint8_t) * n, m);
+    p->left = (int*) mpool_alloc(sizeof(int) * n, m);
+    p->right = (int*) mpool_alloc(sizeof(int) * n, m);
+    p->value = (float*) mpool_alloc(sizeof(float) * n, m);
+    p->sampleRate = (float*) mpool_alloc(sizeof(float) * n, m);
+    p->resistance = (float*) mpool_alloc(sizeof(float) * n, m);
+    p->conductance = (float*) mpool_alloc(sizeof(float) * n, m);
+    p->resistanceLeft = (float*) mpool_alloc(sizeof(float) * n, m);
+    p->resistanceRight = (float*) mpool_alloc(sizeof(float) * n, m);
+    p->conductanceLeft = (float*) mpool_alloc(sizeof(float) * n, m);
+    p->conductanceRight = (float*) mpool_alloc(sizeof(float) * n, m);
+    p->gammaZero = (float*) mpool_alloc(sizeof(float) * n, m);
+    p->gammaLeft = (float*) mpool_calloc(sizeof(float) * n, m);
+    p->gammaRight = (float*) mpool_calloc(sizeof(float) * n, m);
+    p->incident = (float*) mpool_alloc(sizeof(float) * n, m);
+    p->reflected = (float*) mpool_alloc(sizeof(float) * n, m);
+    
+    p->numNodes = 0;
+    wdfProgram_addNode(p, root, &p->numNodes);
+    for (int i = 0; i < n; ++i) wdfProgram_setGammas(p, i);
+    
+    // Only the nodes that do something on each pass go on its list. A resistor never reflects anything
+    // and leaves other than inductors just take the wave their parent gives them
+    p->upList = (int*) mpool_alloc(sizeof(int) * n, m);
+    p->downList = (int*) mpool_alloc(sizeof(int) * n, m);
+    p->numUp = 0;
+    p->numDown = 0;
+    for (int i = 0; i < n - 1; ++i)
+    {
+        if (p->type[i] == Resistor) p->reflected[i] = 0.0f;
+        else p->upList[p->numUp++] = i;
+    }
+    for (int i = n - 2; i >= 0; --i)
+    {
+        if (p->type[i] == Inductor || p->type[i] == Inverter ||
+            p->type[i] == SeriesAdaptor || p->type[i] == ParallelAdaptor)
+            p->downList[p->numDown++] = i;
+    }
+    p->dirty = 0;
+    p->outputIndex = tWDFProgram_getIndex(prog, outputPoint);
+    
+    p->rootTable = NULL;
+    p->rootTableWaves = 0;
+    p->rootTableResistances = 0;
+}
+
+void    tWDFProgram_free            (tWDFProgram* const prog)
+{
+    _tWDFProgram* p = *prog;
+    
+    if (p->rootTable != NULL) mpool_free((char*)p->rootTable, p->mempool);
+    mpool_free((char*)p->downList, p->mempool);
+    mpool_free((char*)p->upList, p->mempool);
+    mpool_free((char*)p->reflected, p->mempool);
+    mpool_free((char*)p->incident, p->mempool);
+    mpool_free((char*)p->gammaRight, p->mempool);
+    mpool_free((char*)p->gammaLeft, p->mempool);
+    mpool_free((char*)p->gammaZero, p->mempool);
+    mpool_free((char*)p->conductanceRight, p->mempool);
+    mpool_free((char*)p->conductanceLeft, p->mempool);
+    mpool_free((char*)p->resistanceRight, p->mempool);
+    mpool_free((char*)p->resistanceLeft, p->mempool);
+    mpool_free((char*)p->conductance, p->mempool);
+    mpool_free((char*)p->resistance, p->mempool);
+    mpool_free((char*)p->sampleRate, p->mempool);
+    mpool_free((char*)p->value, p->mempool);
+    mpool_free((char*)p->right, p->mempool);
+    mpool_free((char*)p->left, p->mempool);
+    mpool_free((char*)p->type, p->mempool);
+    mpool_free((char*)p->nodes, p->mempool);
+    mpool_free((char*)p, p->mempool);
+}
+
+static inline float wdfProgram_tick(_tWDFProgram* const p, float input)
+{
+    const uint8_t* type = p->type;
+    const int* left = p->left;
+    const int* right = p->right;
+    float* a = p->incident;
+    float* b = p->reflected;
+    int root = p->numNodes - 1;
+    
+    //scan the waves up the tree
+    for (int k = 0; k < p->numUp; ++k)
+    {
+        int i = p->upList[k];
+        switch (type[i])
+        {
+            case Capacitor:
+            case Inductor:          b[i] = a[i]; break;
+            case ResistiveSource:   b[i] = input; break;
+            case Inverter:          b[i] = -1.0f * b[left[i]]; break;
+            case SeriesAdaptor:     b[i] = (-1.0f * (b[left[i]] + b[right[i]])); break;
+            case ParallelAdaptor:   b[i] = (p->gammaLeft[i] * b[left[i]] + p->gammaRight[i] * b[right[i]]); break;
+            default: break;
+        }
+    }
+    
+    //root scattering
+    int child = left[root] >= 0 ? left[root] : right[root];
+    a[root] = b[child];
+    switch (type[root])
+    {
+        case IdealSource:   b[root] = (2.0f * input) - a[root]; break;
+        case Diode:
+        case DiodePair:
+            if (p->rootTable != NULL && p->rootRowValid &&
+                a[root] >= -p->rootTableMaxWave && a[root] <= p->rootTableMaxWave)
+                b[root] = wdfProgram_readRootTable(p, a[root]);
+            else b[root] = wdfProgram_solveRoot(p, a[root], p->resistance[root]);
+            break;
+        default:            b[root] = 0.0f; break;
+    }
+    a[child] = b[root];
+    
+    //propagate the waves down the tree, each node's incident wave having been set by its parent
+    for (int k = 0; k < p->numDown; ++k)
+    {
+        int i = p->downList[k];
+        float wave = a[i];
+        int l = left[i];
+        int r = right[i];
+        switch (type[i])
+        {
+            case Inductor:
+                a[i] = -1.0f * wave;
+                break;
+            
+            case Inverter:
+                a[l] = -1.0f * wave;
+                break;
+            
+            case SeriesAdaptor:
+            {
+                float gamma_left = p->gammaLeft[i];
+                float gamma_right = p->gammaRight[i];
+                a[l] = (-1.0f * gamma_left * wave) + (gamma_right * b[l]) - (gamma_left * b[r]);
+                a[r] = (-1.0f * gamma_right * wave) + (gamma_left * b[r]) - (gamma_right * b[l]);
+                break;
+            }
+            
+            case ParallelAdaptor:
+            {
+                float gamma_left = p->gammaLeft[i];
+                float gamma_right = p->gammaRight[i];
+                a[l] = (gamma_left - 1.0f) * b[l] + gamma_right * b[r] + wave;
+                a[r] = gamma_left * b[l] + (gamma_right - 1.0f) * b[r] + wave;
+                break;
+            }
+            
+            default: break;
+        }
+    }
+    
+    int out = p->outputIndex;
+    return ((a[out] * 0.5f) + (b[out] * 0.5f));
+}
+
+float   tWDFProgram_tick            (tWDFProgram* const prog, float sample)
+{
+    LEAF_PROFILE_OBJECT(prog);
+    _tWDFProgram* p = *prog;
+    
+    if (p->dirty) wdfProgram_updateResistances(p);
+    return wdfProgram_tick(p, sample);
+}
+
+void    tWDFProgram_tickBlock       (tWDFProgram* const prog, const float* input, float* output, int size)
+{
+    LEAF_PROFILE_OBJECT(prog);
+    _tWDFProgram* p = *prog;
+    
+    if (p->dirty) wdfProgram_updateResistances(p);
+    for (int i = 0; i < size; ++i) output[i] = wdfProgram_tick(p, input[i]);
+}
+
+int     tWDFProgram_getIndex        (tWDFProgram* const prog, tWDF* const node)
+{
+    _tWDFProgram* p = *prog;
+    
+    for (int i = 0; i < p->numNodes; ++i)
+        if (*p->nodes[i] == *node) return i;
+    return -1;
+}
+
+void    tWDFProgram_setValue        (tWDFProgram* const prog, int index, float value)
+{
+    _tWDFProgram* p = *prog;
+    
+    if (p->value[index] == value) return;
+    p->value[index] = value;
+    p->dirty = 1;
+}
+
+void    tWDFProgram_setSampleRate   (tWDFProgram* const prog, float sample_rate)
+{
+    _tWDFProgram* p = *prog;
+    
+    for (int i = 0; i < p->numNodes; ++i) p->sampleRate[i] = sample_rate;
+    p->dirty = 1;
+}
+
+void    tWDFProgram_setRootTable    (tWDFProgram* const prog, int numWaves, float maxWave, int numResistances, float minResistance, float maxResistance)
+{
+    _tWDFProgram* p = *prog;
+    
+    if (p->rootTable != NULL) mpool_free((char*)p->rootTable, p->mempool);
+    p->rootTable = NULL;
+    
+    WDFComponentType type = (WDFComponentType) p->type[p->numNodes - 1];
+    if (numWaves < 2 || maxWave <= 0.0f || (type != Diode && type != DiodePair)) return;
+    if (numResistances < 2 || minResistance <= 0.0f || maxResistance <= minResistance) numResistances = 1;
+    
+    p->rootTableWaves = numWaves;
+    p->rootTableResistances = numResistances;
+    p->rootTableMaxWave = maxWave;
+    p->rootTableInvStep = (numWaves - 1) / (2.0f * maxWave);
+    p->rootTableMinResistance = minResistance;
+    p->rootTableMaxResistance = maxResistance;
+    p->rootTable = (float*) mpool_alloc(sizeof(float) * numWaves * numResistances, p->mempool);
+    
+    if (numResistances > 1)
+    {
+        p->rootTableInvLogRange = 1.0f / logf(maxResistance / minResistance);
+        for (int i = 0; i < numResistances; ++i)
+        {
+            float r = minResistance * expf(logf(maxResistance / minResistance) * i / (numResistances - 1));
+            wdfProgram_fillRootRow(p, p->rootTable + i * numWaves, r);
+        }
+    }
+    wdfProgram_placeRootTable(p);
+}
+
+float   tWDFProgram_getVoltage      (tWDFProgram* const prog, int index)
+{
+    _tWDFProgram* p = *prog;
+    return ((p->incident[index] * 0.5f) + (p->reflected[index] * 0.5f));
+}
+
+float   tWDFProgram_getCurrent      (tWDFProgram* const prog, int index)
+{
+    _tWDFProgram* p = *prog;
+    return (((p->incident[index] * 0.5f) - (p->reflected[index] * 0.5f)) * p->conductance[index]);
+}
@@ -32,13 +32,13 @@ void    tEnvelope_init(tEnvelope* const envlp, float attack, float decay, int lo
 
 void    tEnvelope_initToPool    (tEnvelope* const envlp, float attack, float decay, int loop, tMempool* const mp)
 {
+    LEAF_PROFILE_POOL(mp);
     _tMempool* m = *mp;
     _tEnvelope* env = *envlp = (_tEnvelope*) mpool_alloc(sizeof(_tEnvelope), m);
     env->mempool = m;
     
-    env->exp_buff = __leaf_table_exp_decay;
-    env->inc_buff = __leaf_table_attack_decay_inc;
-    env->buff_size = sizeof(__leaf_table_exp_decay);
+    env->exp_buff = LEAF_getExpDecayTable(m->leaf);
+    env->buff_size = sizeof(leaf_table_t) * EXP_DECAY_TABLE_SIZE;
     
     env->loop = loop;
     
@@ -67,9 +67,9 @@ void    tEnvelope_initToPool    (tEnvelope* const envlp, float attack, float dec
     env->inAttack = 0;
     env->inDecay = 0;
     
-    env->attackInc = env->inc_buff[attackIndex];
-    env->decayInc = env->inc_buff[decayIndex];
-    env->rampInc = env->inc_buff[rampIndex];
+    env->attackInc = LEAF_ATTACK_DECAY_INC(attackIndex);
+    env->decayInc = LEAF_ATTACK_DECAY_INC(decayIndex);
+    env->rampInc = LEAF_ATTACK_DECAY_INC(rampIndex);
 }
 
 void    tEnvelope_free  (tEnvelope* const envlp)
@@ -92,7 +92,7 @@ void     tEnvelope_setAttack(tEnvelope* const envlp, float attack)
         attackIndex = ((int32_t)(8192.0f * 8.0f))-1;
     }
     
-    env->attackInc = env->inc_buff[attackIndex];
+    env->attackInc = LEAF_ATTACK_DECAY_INC(attackIndex);
 }
 
 void     tEnvelope_setDecay(tEnvelope* const envlp, float decay)
@@ -109,7 +109,7 @@ void     tEnvelope_setDecay(tEnvelope* const envlp, float decay)
         decayIndex = ((int32_t)(8192.0f * 8.0f)) - 1; 
     }
     
-    env->decayInc = env->inc_buff[decayIndex];
+    env->decayInc = LEAF_ATTACK_DECAY_INC(decayIndex);
 }
 
 void     tEnvelope_loop(tEnvelope* const envlp, int loop)
@@ -142,6 +142,7 @@ void     tEnvelope_on(tEnvelope* const envlp, float velocity)
 
 float   tEnvelope_tick(tEnvelope* const envlp)
 {
+    LEAF_PROFILE_OBJECT(envlp);
     _tEnvelope* env = *envlp;
     
     if (env->inRamp)
@@ -154,7 +155,7 @@ float   tEnvelope_tick(tEnvelope* const envlp)
         }
         else
         {
-            env->next = env->rampPeak * env->exp_buff[(uint32_t)env->rampPhase];
+            env->next = env->rampPeak * LEAF_TABLE_READ(env->exp_buff, LEAF_EXP_DECAY_INDEX((uint32_t)env->rampPhase));
         }
         
         env->rampPhase += env->rampInc;
@@ -173,7 +174,7 @@ float   tEnvelope_tick(tEnvelope* const envlp)
         else
         {
             // do interpolation !
-            env->next = env->gain * env->exp_buff[UINT16_MAX - (uint32_t)env->attackPhase]; // inverted and backwards to get proper rising exponential shape/perception
+            env->next = env->gain * LEAF_TABLE_READ(env->exp_buff, LEAF_EXP_DECAY_INDEX(UINT16_MAX - (uint32_t)env->attackPhase)); // inverted and backwards to get proper rising exponential shape/perception
         }
         
         // Increment envelope attack.
@@ -202,7 +203,7 @@ float   tEnvelope_tick(tEnvelope* const envlp)
             
         } else {
             
-            env->next = env->gain * (env->exp_buff[(uint32_t)env->decayPhase]); // do interpolation !
+            env->next = env->gain * (LEAF_TABLE_READ(env->exp_buff, LEAF_EXP_DECAY_INDEX((uint32_t)env->decayPhase))); // do interpolation !
         }
         
         // Increment envelope decay;
@@ -222,13 +223,13 @@ void    tADSR_init(tADSR* const adsrenv, float attack, float decay, float sustai
 
 void    tADSR_initToPool    (tADSR* const adsrenv, float attack, float decay, float sustain, float release, tMempool* const mp)
 {
+    LEAF_PROFILE_POOL(mp);
     _tMempool* m = *mp;
     _tADSR* adsr = *adsrenv = (_tADSR*) mpool_alloc(sizeof(_tADSR), m);
     adsr->mempool = m;
 
-    adsr->exp_buff = __leaf_table_exp_decay;
-    adsr->inc_buff = __leaf_table_attack_decay_inc;
-    adsr->buff_size = sizeof(__leaf_table_exp_decay);
+    adsr->exp_buff = LEAF_getExpDecayTable(m->leaf);
+    adsr->buff_size = sizeof(leaf_table_t) * EXP_DECAY_TABLE_SIZE;
 
     if (attack > 8192.0f)
         attack = 8192.0f;
@@ -277,14 +278,17 @@ void    tADSR_initToPool    (tADSR* const adsrenv, float attack, float decay, fl
 
     adsr->sustain = sustain;
 
-    adsr->attackInc = adsr->inc_buff[attackIndex];
-    adsr->decayInc = adsr->inc_buff[decayIndex];
-    adsr->releaseInc = adsr->inc_buff[releaseIndex];
-    adsr->rampInc = adsr->inc_buff[rampIndex];
+    adsr->attackInc = LEAF_ATTACK_DECAY_INC(attackIndex);
+    adsr->decayInc = LEAF_ATTACK_DECAY_INC(decayIndex);
+    adsr->releaseInc = LEAF_ATTACK_DECAY_INC(releaseIndex);
+    adsr->rampInc = LEAF_ATTACK_DECAY_INC(rampIndex);
 
     adsr->baseLeakFactor = 1.0f;
     adsr->leakFactor = 1.0f;
     adsr->invSampleRate = adsr->mempool->leaf->invSampleRate;
+    
+    LEAF_controlRateInit(&adsr->control, 1, 0.0f);
+    if (adsr->mempool->leaf->controlRate > 1) tADSR_setControlRate(adsrenv, adsr->mempool->leaf->controlRate);
 }
 
 void    tADSR_free (tADSR* const adsrenv)
@@ -309,7 +313,7 @@ void     tADSR_setAttack(tADSR* const adsrenv, float attack)
         attackIndex = ((int32_t)(8192.0f * 8.0f))-1;
     }
 
-    adsr->attackInc = adsr->inc_buff[attackIndex] * (44100.f * adsr->invSampleRate);
+    adsr->attackInc = LEAF_ATTACK_DECAY_INC(attackIndex) * (44100.f * adsr->invSampleRate);
 }
 
 void     tADSR_setDecay(tADSR* const adsrenv, float decay)
@@ -328,7 +332,7 @@ void     tADSR_setDecay(tADSR* const adsrenv, float decay)
         decayIndex = ((int32_t)(8192.0f * 8.0f)) - 1;
     }
 
-    adsr->decayInc = adsr->inc_buff[decayIndex] * (44100.f * adsr->invSampleRate);
+    adsr->decayInc = LEAF_ATTACK_DECAY_INC(decayIndex) * (44100.f * adsr->invSampleRate);
 }
 
 void     tADSR_setSustain(tADSR* const adsrenv, float sustain)
@@ -356,7 +360,7 @@ void     tADSR_setRelease(tADSR* const adsrenv, float release)
         releaseIndex = ((int32_t)(8192.0f * 8.0f)) - 1;
     }
 
-    adsr->releaseInc = adsr->inc_buff[releaseIndex] * (44100.f * adsr->invSampleRate);
+    adsr->releaseInc = LEAF_ATTACK_DECAY_INC(releaseIndex) * (44100.f * adsr->invSampleRate);
 }
 
 // 0.999999 is slow leak, 0.9 is fast leak
@@ -405,11 +409,8 @@ void tADSR_off(tADSR* const adsrenv)
     adsr->releasePeak = adsr->next;
 }
 
-float   tADSR_tick(tADSR* const adsrenv)
+static inline float adsr_tick(_tADSR* const adsr)
 {
-    _tADSR* adsr = *adsrenv;
-
-
     if (adsr->inRamp)
     {
         if (adsr->rampPhase > UINT16_MAX)
@@ -420,7 +421,7 @@ float   tADSR_tick(tADSR* const adsrenv)
         }
         else
         {
-            adsr->next = adsr->rampPeak * adsr->exp_buff[(uint32_t)adsr->rampPhase];
+            adsr->next = adsr->rampPeak * LEAF_TABLE_READ(adsr->exp_buff, LEAF_EXP_DECAY_INDEX((uint32_t)adsr->rampPhase));
         }
 
         adsr->rampPhase += adsr->rampInc;
@@ -439,7 +440,7 @@ float   tADSR_tick(tADSR* const adsrenv)
         else
         {
             // do interpolation !
-            adsr->next = adsr->gain * adsr->exp_buff[UINT16_MAX - (uint32_t)adsr->attackPhase]; // inverted and backwards to get proper rising exponential shape/perception
+            adsr->next = adsr->gain * LEAF_TABLE_READ(adsr->exp_buff, LEAF_EXP_DECAY_INDEX(UINT16_MAX - (uint32_t)adsr->attackPhase)); // inverted and backwards to get proper rising exponential shape/perception
         }
 
         // Increment ADSR attack.
@@ -460,7 +461,7 @@ float   tADSR_tick(tADSR* const adsrenv)
 
         else
         {
-            adsr->next = (adsr->gain * (adsr->sustain + ((adsr->exp_buff[(uint32_t)adsr->decayPhase]) * (1.0f - adsr->sustain)))) * adsr->leakFactor; // do interpolation !
+            adsr->next = (adsr->gain * (adsr->sustain + ((LEAF_TABLE_READ(adsr->exp_buff, LEAF_EXP_DECAY_INDEX((uint32_t)adsr->decayPhase))) * (1.0f - adsr->sustain)))) * adsr->leakFactor; // do interpolation !
         }
 
         // Increment ADSR decay.
@@ -482,7 +483,7 @@ float   tADSR_tick(tADSR* const adsrenv)
         }
         else {
 
-            adsr->next = adsr->releasePeak * (adsr->exp_buff[(uint32_t)adsr->releasePhase]); // do interpolation !
+            adsr->next = adsr->releasePeak * (LEAF_TABLE_READ(adsr->exp_buff, LEAF_EXP_DECAY_INDEX((uint32_t)adsr->releasePhase))); // do interpolation !
         }
 
         // Increment envelope release;
@@ -493,11 +494,30 @@ float   tADSR_tick(tADSR* const adsrenv)
     return adsr->next;
 }
 
+// Recompute the time coefficients so each tick covers scale samples, restarting the control ramp from the current output
+static void adsr_setScale(_tADSR* adsr, int scale)
+{
+    LEAF_controlRateInit(&adsr->control, adsr->control.divider, adsr->next);
+    adsr->control.scale = scale;
+    tADSR_setSampleRate(&adsr, adsr->mempool->leaf->sampleRate);
+}
+
+float   tADSR_tick(tADSR* const adsrenv)
+{
+    LEAF_PROFILE_OBJECT(adsrenv);
+    _tADSR* adsr = *adsrenv;
+    
+    if (adsr->control.scale != 1) adsr_setScale(adsr, 1);
+    return adsr_tick(adsr);
+}
+
 void tADSR_setSampleRate(tADSR* const adsrenv, float sr)
 {
     _tADSR* adsr = *adsrenv;
     
-    adsr->invSampleRate = 1.0f/sr;
+    adsr->invSampleRate = (float) adsr->control.scale / sr;
+    // The retrigger ramp has a fixed increment per sample, so only the control rate scales it
+    adsr->rampInc = LEAF_ATTACK_DECAY_INC(((int16_t)(2.0f * 8.0f))-1) * (float) adsr->control.scale;
     
     tADSR_setAttack(adsrenv, adsr->attack);
     tADSR_setDecay(adsrenv, adsr->decay);
@@ -505,6 +525,35 @@ void tADSR_setSampleRate(tADSR* const adsrenv, float sr)
     tADSR_setLeakFactor(adsrenv, adsr->baseLeakFactor);
 }
 
+void    tADSR_tickBlock (tADSR* const adsrenv, float* output, int size)
+{
+    LEAF_PROFILE_OBJECT(adsrenv);
+    _tADSR* adsr = *adsrenv;
+    int divider = adsr->control.divider;
+    
+    if (adsr->control.scale != divider) adsr_setScale(adsr, divider);
+    
+    if (divider == 1)
+    {
+        for (int i = 0; i < size; i++) output[i] = adsr_tick(adsr);
+        return;
+    }
+    
+    for (int i = 0; i < size; )
+    {
+        if (adsr->control.count == 0) LEAF_controlRateSetTarget(&adsr->control, adsr_tick(adsr));
+        i += LEAF_controlRateFill(&adsr->control, output + i, size - i);
+    }
+}
+
+void    tADSR_setControlRate (tADSR* const adsrenv, int divider)
+{
+    _tADSR* adsr = *adsrenv;
+    
+    LEAF_controlRateInit(&adsr->control, divider, adsr->control.value);
+    tADSR_setSampleRate(adsrenv, adsr->mempool->leaf->sampleRate);
+}
+
 #endif // LEAF_INCLUDE_ADSR_TABLES
 
 
@@ -524,6 +573,7 @@ void    tADSRS_init(tADSRS* const adsrenv, float attack, float decay, float sust
 
 void    tADSRS_initToPool    (tADSRS* const adsrenv, float attack, float decay, float sustain, float release, tMempool* const mp)
 {
+    LEAF_PROFILE_POOL(mp);
     _tMempool* m = *mp;
     _tADSRS* adsr = *adsrenv = (_tADSRS*) mpool_alloc(sizeof(_tADSRS), m);
     adsr->mempool = m;
@@ -563,6 +613,9 @@ void    tADSRS_initToPool    (tADSRS* const adsrenv, float attack, float decay,
     adsr->leakFactor = 1.0f;
     
     adsr->invSampleRate = leaf->invSampleRate;
+    
+    LEAF_controlRateInit(&adsr->control, 1, 0.0f);
+    if (leaf->controlRate > 1) tADSRS_setControlRate(adsrenv, leaf->controlRate);
 }
 
 void    tADSRS_free  (tADSRS* const adsrenv)
@@ -634,10 +687,8 @@ void tADSRS_off(tADSRS* const adsrenv)
     }
 }
 
-float   tADSRS_tick(tADSRS* const adsrenv)
+static inline float adsrs_tick(_tADSRS* const adsr)
 {
-    _tADSRS* adsr = *adsrenv;
-
     switch (adsr->state) {
         case env_idle:
             break;
@@ -672,13 +723,42 @@ float   tADSRS_tick(tADSRS* const adsrenv)
     return adsr->output * adsr->gain;
 }
 
+// Recompute the time coefficients so each tick covers scale samples, restarting the control ramp from the current output
+static void adsrs_setScale(_tADSRS* adsr, int scale)
+{
+    LEAF_controlRateInit(&adsr->control, adsr->control.divider, adsr->output * adsr->gain);
+    adsr->control.scale = scale;
+    tADSRS_setSampleRate(&adsr, adsr->sampleRate);
+}
+
+float   tADSRS_tick(tADSRS* const adsrenv)
+{
+    LEAF_PROFILE_OBJECT(adsrenv);
+    _tADSRS* adsr = *adsrenv;
+    
+    if (adsr->control.scale != 1) adsrs_setScale(adsr, 1);
+    return adsrs_tick(adsr);
+}
+
 void tADSRS_setSampleRate(tADSRS* const adsrenv, float sr)
 {
     _tADSRS* adsr = *adsrenv;
     
     adsr->sampleRate = sr;
-    adsr->sampleRateInMs =  adsr->sampleRate * 0.001f;
-    adsr->invSampleRate = 1.0f/sr;
+    adsr->sampleRateInMs =  (adsr->sampleRate / adsr->control.scale) * 0.001f;
+    adsr->invSampleRate = (float) adsr->control.scale / sr;
+    
+    // Keep the velocity smoothing at the same speed when ticked less often
+    if (adsr->control.scale > 1)
+    {
+        adsr->oneMinusFactor = powf(0.99f, (float) adsr->control.scale);
+        adsr->factor = 1.0f - adsr->oneMinusFactor;
+    }
+    else
+    {
+        adsr->factor = 0.01f;
+        adsr->oneMinusFactor = 0.99f;
+    }
     
     tADSRS_setAttack(adsrenv, adsr->attack);
     tADSRS_setDecay(adsrenv, adsr->decay);
@@ -686,6 +766,35 @@ void tADSRS_setSampleRate(tADSRS* const adsrenv, float sr)
     tADSRS_setLeakFactor(adsrenv, adsr->baseLeakFactor);
 }
 
+void    tADSRS_tickBlock (tADSRS* const adsrenv, float* output, int size)
+{
+    LEAF_PROFILE_OBJECT(adsrenv);
+    _tADSRS* adsr = *adsrenv;
+    int divider = adsr->control.divider;
+    
+    if (adsr->control.scale != divider) adsrs_setScale(adsr, divider);
+    
+    if (divider == 1)
+    {
+        for (int i = 0; i < size; i++) output[i] = adsrs_tick(adsr);
+        return;
+    }
+    
+    for (int i = 0; i < size; )
+    {
+        if (adsr->control.count == 0) LEAF_controlRateSetTarget(&adsr->control, adsrs_tick(adsr));
+        i += LEAF_controlRateFill(&adsr->control, output + i, size - i);
+    }
+}
+
+void    tADSRS_setControlRate (tADSRS* const adsrenv, int divider)
+{
+    _tADSRS* adsr = *adsrenv;
+    
+    LEAF_controlRateInit(&adsr->control, divider, adsr->control.value);
+    tADSRS_setSampleRate(adsrenv, adsr->sampleRate);
+}
+
 //================================================================================
 
 /* ADSR 4 */ // new version of our original table-based ADSR but with the table passed in by the user
@@ -699,6 +808,7 @@ void    tADSRT_init    (tADSRT* const adsrenv, float attack, float decay, float
 //times are in ms
 void    tADSRT_initToPool    (tADSRT* const adsrenv, float attack, float decay, float sustain, float release, float* expBuffer, int bufferSize, tMempool* const mp)
 {
+    LEAF_PROFILE_POOL(mp);
     _tMempool* m = *mp;
     _tADSRT* adsr = *adsrenv = (_tADSRT*) mpool_alloc(sizeof(_tADSRT), m);
     adsr->mempool = m;
@@ -743,6 +853,9 @@ void    tADSRT_initToPool    (tADSRT* const adsrenv, float attack, float decay,
     adsr->baseLeakFactor = 1.0f;
     adsr->leakFactor = 1.0f;
     adsr->invSampleRate = leaf->invSampleRate;
+    
+    LEAF_controlRateInit(&adsr->control, 1, 0.0f);
+    if (leaf->controlRate > 1) tADSRT_setControlRate(adsrenv, leaf->controlRate);
 }
 
 void    tADSRT_free  (tADSRT* const adsrenv)
@@ -840,10 +953,8 @@ void tADSRT_off(tADSRT* const adsrenv)
     }
 }
 
-float   tADSRT_tick(tADSRT* const adsrenv)
+static inline float adsrt_tick(_tADSRT* const adsr)
 {
-    _tADSRT* adsr = *adsrenv;
-
     switch (adsr->whichStage)
     {
         case env_ramp:
@@ -965,8 +1076,26 @@ float   tADSRT_tick(tADSRT* const adsrenv)
     return adsr->next;
 }
 
+// Recompute the time coefficients so each tick covers scale samples, restarting the control ramp from the current output
+static void adsrt_setScale(_tADSRT* adsr, int scale)
+{
+    LEAF_controlRateInit(&adsr->control, adsr->control.divider, adsr->next);
+    adsr->control.scale = scale;
+    tADSRT_setSampleRate(&adsr, adsr->sampleRate);
+}
+
+float   tADSRT_tick(tADSRT* const adsrenv)
+{
+    LEAF_PROFILE_OBJECT(adsrenv);
+    _tADSRT* adsr = *adsrenv;
+    
+    if (adsr->control.scale != 1) adsrt_setScale(adsr, 1);
+    return adsrt_tick(adsr);
+}
+
 float   tADSRT_tickNoInterp(tADSRT* const adsrenv)
 {
+    LEAF_PROFILE_OBJECT(adsrenv);
     _tADSRT* adsr = *adsrenv;
 
     switch (adsr->whichStage)
@@ -1048,8 +1177,8 @@ void    tADSRT_setSampleRate(tADSRT* const adsrenv, float sr)
     _tADSRT* adsr = *adsrenv;
     
     adsr->sampleRate = sr;
-    adsr->invSampleRate = 1.0f/sr;
-    adsr->bufferSizeDividedBySampleRateInMs = adsr->buff_size / (adsr->sampleRate * 0.001f);
+    adsr->invSampleRate = (float) adsr->control.scale / sr;
+    adsr->bufferSizeDividedBySampleRateInMs = adsr->buff_size / ((adsr->sampleRate / adsr->control.scale) * 0.001f);
     adsr->attackInc = adsr->bufferSizeDividedBySampleRateInMs / adsr->attack;
     adsr->decayInc = adsr->bufferSizeDividedBySampleRateInMs / adsr->decay;
     adsr->releaseInc = adsr->bufferSizeDividedBySampleRateInMs / adsr->release;
@@ -1057,6 +1186,35 @@ void    tADSRT_setSampleRate(tADSRT* const adsrenv, float sr)
     adsr->leakFactor = powf(adsr->baseLeakFactor, 44100.0f * adsr->invSampleRate);
 }
 
+void    tADSRT_tickBlock (tADSRT* const adsrenv, float* output, int size)
+{
+    LEAF_PROFILE_OBJECT(adsrenv);
+    _tADSRT* adsr = *adsrenv;
+    int divider = adsr->control.divider;
+    
+    if (adsr->control.scale != divider) adsrt_setScale(adsr, divider);
+    
+    if (divider == 1)
+    {
+        for (int i = 0; i < size; i++) output[i] = adsrt_tick(adsr);
+        return;
+    }
+    
+    for (int i = 0; i < size; )
+    {
+        if (adsr->control.count == 0) LEAF_controlRateSetTarget(&adsr->control, adsrt_tick(adsr));
+        i += LEAF_controlRateFill(&adsr->control, output + i, size - i);
+    }
+}
+
+void    tADSRT_setControlRate (tADSRT* const adsrenv, int divider)
+{
+    _tADSRT* adsr = *adsrenv;
+    
+    LEAF_controlRateInit(&adsr->control, divider, adsr->control.value);
+    tADSRT_setSampleRate(adsrenv, adsr->sampleRate);
+}
+
 /////-----------------
 /* Ramp */
 void    tRamp_init(tRamp* const r, float time, int samples_per_tick, LEAF* const leaf)
@@ -1066,6 +1224,7 @@ void    tRamp_init(tRamp* const r, float time, int samples_per_tick, LEAF* const
 
 void    tRamp_initToPool    (tRamp* const r, float time, int samples_per_tick, tMempool* const mp)
 {
+    LEAF_PROFILE_POOL(mp);
     _tMempool* m = *mp;
     _tRamp* ramp = *r = (_tRamp*) mpool_alloc(sizeof(_tRamp), m);
     ramp->mempool = m;
@@ -1130,6 +1289,7 @@ void     tRamp_setVal(tRamp* const ramp, float val)
 
 float   tRamp_tick(tRamp* const ramp)
 {
+    LEAF_PROFILE_OBJECT(ramp);
     _tRamp* r = *ramp;
     
     r->curr += r->inc;
@@ -1169,6 +1329,7 @@ void    tRampUpDown_init(tRampUpDown* const r, float upTime, float downTime, int
 
 void    tRampUpDown_initToPool(tRampUpDown* const r, float upTime, float downTime, int samples_per_tick, tMempool* const mp)
 {
+    LEAF_PROFILE_POOL(mp);
     _tMempool* m = *mp;
     _tRampUpDown* ramp = *r = (_tRampUpDown*) mpool_alloc(sizeof(_tRampUpDown), m);
     ramp->mempool = m;
@@ -1259,6 +1420,7 @@ void     tRampUpDown_setVal(tRampUpDown* const ramp, float val)
 
 float   tRampUpDown_tick(tRampUpDown* const ramp)
 {
+    LEAF_PROFILE_OBJECT(ramp);
     _tRampUpDown* r = *ramp;
     float test;
 
@@ -1310,6 +1472,7 @@ void    tExpSmooth_init(tExpSmooth* const expsmooth, float val, float factor, LE
 
 void    tExpSmooth_initToPool   (tExpSmooth* const expsmooth, float val, float factor, tMempool* const mp)
 {
+    LEAF_PROFILE_POOL(mp);
     _tMempool* m = *mp;
     _tExpSmooth* smooth = *expsmooth = (_tExpSmooth*) mpool_alloc(sizeof(_tExpSmooth), m);
     smooth->mempool = m;
@@ -1322,6 +1485,9 @@ void    tExpSmooth_initToPool   (tExpSmooth* const expsmooth, float val, float f
     smooth->factor = factor;
     smooth->oneminusfactor = 1.0f - factor;
     smooth->invSampleRate = smooth->mempool->leaf->invSampleRate;
+    
+    LEAF_controlRateInit(&smooth->control, 1, val);
+    if (smooth->mempool->leaf->controlRate > 1) tExpSmooth_setControlRate(expsmooth, smooth->mempool->leaf->controlRate);
 }
 
 void    tExpSmooth_free (tExpSmooth* const expsmooth)
@@ -1330,6 +1496,14 @@ void    tExpSmooth_free (tExpSmooth* const expsmooth)
     mpool_free((char*)smooth, smooth->mempool);
 }
 
+// Make one tick cover a whole control period, as if the per sample factor had been applied that many times
+static inline void tExpSmooth_applyControlRate(_tExpSmooth* const smooth)
+{
+    if (smooth->control.scale <= 1) return;
+    smooth->oneminusfactor = powf(1.0f - smooth->factor, (float) smooth->control.scale);
+    smooth->factor = 1.0f - smooth->oneminusfactor;
+}
+
 void     tExpSmooth_setFactor(tExpSmooth* const expsmooth, float factor)
 {   // factor is usually a value between 0 and 0.1. Lower value is slower. 0.01 for example gives you a smoothing time of about 10ms
     _tExpSmooth* smooth = *expsmooth;
@@ -1340,6 +1514,7 @@ void     tExpSmooth_setFactor(tExpSmooth* const expsmooth, float factor)
     smooth->baseFactor = factor;
     smooth->factor = powf(factor, 44100.f * smooth->invSampleRate);
     smooth->oneminusfactor = 1.0f - factor;
+    tExpSmooth_applyControlRate(smooth);
 }
 
 void     tExpSmooth_setDest(tExpSmooth* const expsmooth, float dest)
@@ -1361,13 +1536,29 @@ void     tExpSmooth_setValAndDest(tExpSmooth* const expsmooth, float val)
     smooth->dest=val;
 }
 
-float   tExpSmooth_tick(tExpSmooth* const expsmooth)
+static inline float expsmooth_tick(_tExpSmooth* const smooth)
 {
-    _tExpSmooth* smooth = *expsmooth;
     smooth->curr = smooth->factor * smooth->dest + smooth->oneminusfactor * smooth->curr;
     return smooth->curr;
 }
 
+// Recompute the factor so each tick covers scale samples, restarting the control ramp from the current output
+static void expsmooth_setScale(_tExpSmooth* smooth, int scale)
+{
+    LEAF_controlRateInit(&smooth->control, smooth->control.divider, smooth->curr);
+    smooth->control.scale = scale;
+    tExpSmooth_setSampleRate(&smooth, smooth->mempool->leaf->sampleRate);
+}
+
+float   tExpSmooth_tick(tExpSmooth* const expsmooth)
+{
+    LEAF_PROFILE_OBJECT(expsmooth);
+    _tExpSmooth* smooth = *expsmooth;
+    
+    if (smooth->control.scale != 1) expsmooth_setScale(smooth, 1);
+    return expsmooth_tick(smooth);
+}
+
 float   tExpSmooth_sample(tExpSmooth* const expsmooth)
 {
     _tExpSmooth* smooth = *expsmooth;
@@ -1380,6 +1571,36 @@ void    tExpSmooth_setSampleRate(tExpSmooth* const expsmooth, float sr)
     smooth->invSampleRate = 1.0f/sr;
     smooth->factor = powf(smooth->baseFactor, 44100.f * smooth->invSampleRate);
     smooth->oneminusfactor = 1.0f - smooth->factor;
+    tExpSmooth_applyControlRate(smooth);
+}
+
+void    tExpSmooth_tickBlock (tExpSmooth* const expsmooth, float* output, int size)
+{
+    LEAF_PROFILE_OBJECT(expsmooth);
+    _tExpSmooth* smooth = *expsmooth;
+    int divider = smooth->control.divider;
+    
+    if (smooth->control.scale != divider) expsmooth_setScale(smooth, divider);
+    
+    if (divider == 1)
+    {
+        for (int i = 0; i < size; i++) output[i] = expsmooth_tick(smooth);
+        return;
+    }
+    
+    for (int i = 0; i < size; )
+    {
+        if (smooth->control.count == 0) LEAF_controlRateSetTarget(&smooth->control, expsmooth_tick(smooth));
+        i += LEAF_controlRateFill(&smooth->control, output + i, size - i);
+    }
+}
+
+void    tExpSmooth_setControlRate (tExpSmooth* const expsmooth, int divider)
+{
+    _tExpSmooth* smooth = *expsmooth;
+    
+    LEAF_controlRateInit(&smooth->control, divider, smooth->control.value);
+    tExpSmooth_setSampleRate(expsmooth, smooth->mempool->leaf->sampleRate);
 }
 
 //tSlide is based on the max/msp slide~ object
@@ -1392,6 +1613,7 @@ void    tSlide_init          (tSlide* const sl, float upSlide, float downSlide,
 
 void    tSlide_initToPool    (tSlide* const sl, float upSlide, float downSlide, tMempool* const mp)
 {
+    LEAF_PROFILE_POOL(mp);
     _tMempool* m = *mp;
     _tSlide* s = *sl = (_tSlide*) mpool_alloc(sizeof(_tSlide), m);
     s->mempool = m;
@@ -1439,6 +1661,7 @@ void tSlide_setDest(tSlide* const sl, float dest)
 
 float tSlide_tickNoInput(tSlide* const sl)
 {
+    LEAF_PROFILE_OBJECT(sl);
     _tSlide* s = *sl;
     float in = s->dest;
 
@@ -1450,8 +1673,7 @@ float tSlide_tickNoInput(tSlide* const sl)
     {
         s->currentOut = s->prevOut + ((in - s->prevOut) * s->invDownSlide);
     }
-#ifdef NO_DENORMAL_CHECK
-#else
+#if LEAF_DENORMAL_CHECK
     if (s->currentOut < VSF) s->currentOut = 0.0f;
 #endif
     s->prevIn = in;
@@ -1461,6 +1683,7 @@ float tSlide_tickNoInput(tSlide* const sl)
 
 float tSlide_tick(tSlide* const sl, float in)
 {
+    LEAF_PROFILE_OBJECT(sl);
     _tSlide* s = *sl;
 
 
@@ -1472,8 +1695,7 @@ float tSlide_tick(tSlide* const sl, float in)
     {
         s->currentOut = s->prevOut + ((in - s->prevOut) * s->invDownSlide);
     }
-#ifdef NO_DENORMAL_CHECK
-#else
+#if LEAF_DENORMAL_CHECK
     if (s->currentOut < VSF) s->currentOut = 0.0f;
 #endif
     s->prevIn = in;
@@ -1481,3 +1703,808 @@ float tSlide_tick(tSlide* const sl, float in)
     return s->currentOut;
 }
 
+//===========================================================================================
+/* Smoother bank */
+
+static inline void smootherBank_activate(_tSmootherBank* const s, int index)
+{
+    if (s->activePos[index] >= 0) return;
+    s->activePos[index] = s->numActive;
+    s->active[s->numActive++] = index;
+}
+
+static inline void smootherBank_deactivate(_tSmootherBank* const s, int index)
+{
+    // Swap the last active smoother into the gap
+    int pos = s->activePos[index];
+    int last = s->active[--s->numActive];
+    s->active[pos] = last;
+    s->activePos[last] = pos;
+    s->activePos[index] = -1;
+}
+
+// Work out the ramp from the current value to the destination and put the smoother on the active list
+static inline void smootherBank_start(_tSmootherBank* const s, int index)
+{
+    if (s->type[index] == SmootherLinear)
+    {
+        int length = (int) (s->time[index] * 0.001f * s->sampleRate + 0.5f);
+        if (length < 1) length = 1;
+        s->remaining[index] = length;
+        s->step[index] = (s->dest[index] - s->curr[index]) / (float) length;
+    }
+    else
+    {
+        s->remaining[index] = 1;
+    }
+    if (s->curr[index] == s->dest[index]) s->remaining[index] = 0;
+    smootherBank_activate(s, index);
+}
+
+static inline float smootherBank_decay(_tSmootherBank* const s, int index)
+{
+    float samples = s->time[index] * 0.001f * s->sampleRate;
+    return samples > 0.0f ? expf(-1.0f / samples) : 0.0f;
+}
+
+void    tSmootherBank_init          (tSmootherBank* const sb, int numSmoothers, int blockSize, LEAF* const leaf)
+{
+    tSmootherBank_initToPool(sb, numSmoothers, blockSize, &leaf->mempool);
+}
+
+void    tSmootherBank_initToPool    (tSmootherBank* const sb, int numSmoothers, int blockSize, tMempool* const mp)
+{
+    LEAF_PROFILE_POOL(mp);
+    _tMempool* m = *mp;
+    _tSmootherBank* s = *sb = (_tSmootherBank*) mpool_alloc(sizeof(_tSmootherBank), m);
+    s->mempool = m;
+    LEAF* leaf = s->mempool->leaf;
+    
+    s->numSmoothers = numSmoothers;
+    s->blockSize = blockSize;
+    s->buffers = (float*) mpool_calloc(sizeof(float) * numSmoothers * blockSize, m);
+    s->curr = (float*) mpool_calloc(sizeof(float) * numSmoothers, m);
+    s->dest = (float*) mpool_calloc(sizeof(float) * numSmoothers, m);
+    s->step = (float*) mpool_calloc(sizeof(float) * numSmoothers, m);
+    s->time = (float*) mpool_alloc(sizeof(float) * numSmoothers, m);
+    s->remaining = (int*) mpool_calloc(sizeof(int) * numSmoothers, m);
+    s->type = (uint8_t*) mpool_calloc(sizeof(uint8_t) * numSmoothers, m);
+    s->active = (int*) mpool_alloc(sizeof(int) * numSmoothers, m);
+    s->activePos = (int*) mpool_alloc(sizeof(int) * numSmoothers, m);
+    s->numActive = 0;
+    
+    s->threshold = 0.0001f;
+    s->sampleRate = leaf->sampleRate;
+    
+    for (int i = 0; i < numSmoothers; ++i)
+    {
+        s->time[i] = 10.0f;
+        s->type[i] = SmootherLinear;
+        s->activePos[i] = -1;
+    }
+}
+
+void    tSmootherBank_free          (tSmootherBank* const sb)
+{
+    _tSmootherBank* s = *sb;
+    
+    mpool_free((char*) s->activePos, s->mempool);
+    mpool_free((char*) s->active, s->mempool);
+    mpool_free((char*) s->type, s->mempool);
+    mpool_free((char*) s->remaining, s->mempool);
+    mpool_free((char*) s->time, s->mempool);
+    mpool_free((char*) s->step, s->mempool);
+    mpool_free((char*) s->dest, s->mempool);
+    mpool_free((char*) s->curr, s->mempool);
+    mpool_free((char*) s->buffers, s->mempool);
+    mpool_free((char*) s, s->mempool);
+}
+
+int     tSmootherBank_tickBlock     (tSmootherBank* const sb, int size)
+{
+    LEAF_PROFILE_OBJECT(sb);
+    _tSmootherBank* s = *sb;
+    
+    if (size > s->blockSize) size = s->blockSize;
+    
+    for (int k = 0; k < s->numActive; )
+    {
+        int i = s->active[k];
+        float* out = s->buffers + i * s->blockSize;
+        float curr = s->curr[i];
+        float dest = s->dest[i];
+        int moving = s->remaining[i] > 0;
+        int n = 0;
+        
+        if (!moving)
+        {
+            // Settled last block, flatten the whole buffer once and drop off the list
+            for (n = 0; n < s->blockSize; ++n) out[n] = dest;
+            s->curr[i] = dest;
+            smootherBank_deactivate(s, i);
+            continue;
+        }
+        
+        if (s->type[i] == SmootherLinear)
+        {
+            int length = s->remaining[i] < size ? s->remaining[i] : size;
+            float step = s->step[i];
+            for (; n < length; ++n)
+            {
+                curr += step;
+                out[n] = curr;
+            }
+            s->remaining[i] -= length;
+            if (s->remaining[i] == 0)
+            {
+                // Land exactly on the destination
+                curr = dest;
+                out[length - 1] = dest;
+            }
+        }
+        else
+        {
+            float decay = s->step[i];
+            float distance = curr - dest;
+            for (; n < size; ++n)
+            {
+                distance *= decay;
+                out[n] = dest + distance;
+            }
+            if (fabsf(distance) < s->threshold)
+            {
+                s->remaining[i] = 0;
+                curr = dest;
+            }
+            else curr = dest + distance;
+        }
+        for (; n < size; ++n) out[n] = curr;
+        
+        s->curr[i] = curr;
+        k++;
+    }
+    
+    return s->numActive;
+}
+
+float*  tSmootherBank_getBuffer     (tSmootherBank* const sb, int index)
+{
+    _tSmootherBank* s = *sb;
+    return s->buffers + index * s->blockSize;
+}
+
+float   tSmootherBank_getValue      (tSmootherBank* const sb, int index)
+{
+    _tSmootherBank* s = *sb;
+    return s->curr[index];
+}
+
+int     tSmootherBank_isActive      (tSmootherBank* const sb, int index)
+{
+    _tSmootherBank* s = *sb;
+    return s->activePos[index] >= 0;
+}
+
+void    tSmootherBank_setType       (tSmootherBank* const sb, int index, SmootherType type)
+{
+    _tSmootherBank* s = *sb;
+    
+    s->type[index] = (uint8_t) type;
+    if (type == SmootherExponential) s->step[index] = smootherBank_decay(s, index);
+    if (s->activePos[index] >= 0 && s->remaining[index] > 0) smootherBank_start(s, index);
+}
+
+void    tSmootherBank_setTime       (tSmootherBank* const sb, int index, float time)
+{
+    _tSmootherBank* s = *sb;
+    
+    if (time < 0.0f) time = 0.0f;
+    s->time[index] = time;
+    if (s->type[index] == SmootherExponential) s->step[index] = smootherBank_decay(s, index);
+    // A linear ramp in progress restarts from where it is with the new time
+    else if (s->activePos[index] >= 0 && s->remaining[index] > 0) smootherBank_start(s, index);
+}
+
+void    tSmootherBank_setDest       (tSmootherBank* const sb, int index, float dest)
+{
+    _tSmootherBank* s = *sb;
+    
+    if (dest == s->dest[index]) return;
+    s->dest[index] = dest;
+    smootherBank_start(s, index);
+}
+
+void    tSmootherBank_setVal        (tSmootherBank* const sb, int index, float val)
+{
+    _tSmootherBank* s = *sb;
+    
+    s->curr[index] = val;
+    s->dest[index] = val;
+    s->remaining[index] = 0;
+    smootherBank_activate(s, index);
+}
+
+void    tSmootherBank_setThreshold  (tSmootherBank* const sb, float threshold)
+{
+    _tSmootherBank* s = *sb;
+    s->threshold = threshold;
+}
+
+void    tSmootherBank_setSampleRate (tSmootherBank* const sb, float sr)
+{
+    _tSmootherBank* s = *sb;
+    
+    s->sampleRate = sr;
+    for (int i = 0; i < s->numSmoothers; ++i)
+    {
+        if (s->type[i] == SmootherExponential) s->step[i] = smootherBank_decay(s, i);
+    }
+}
+
+
+/* ADSR banks */
+
+static inline void envBank_activate(int* const active, int* const activePos, int* const numActive, int index)
+{
+    if (activePos[index] >= 0) return;
+    activePos[index] = *numActive;
+    active[(*numActive)++] = index;
+}
+
+static inline void envBank_deactivate(int* const active, int* const activePos, int* const numActive, int index)
+{
+    int pos = activePos[index];
+    int last = active[--(*numActive)];
+    active[pos] = last;
+    activePos[last] = pos;
+    activePos[index] = -1;
+}
+
+// Same interpolated read as tADSRT_tick
+static inline float adsrtBank_read(_tADSRTBank* const b, float phase)
+{
+    uint32_t intPart = (uint32_t)phase;
+    float floatPart = phase - intPart;
+    float secondValue = (phase + 1.0f > b->maxPhase) ? 0.0f : b->exp_buff[(uint32_t)(phase + 1)];
+    float out = b->exp_buff[intPart] * (1.0f - floatPart);
+    out += secondValue * floatPart;
+    return out;
+}
+
+void    tADSRTBank_init          (tADSRTBank* const bank, int numEnvelopes, int blockSize, float attack, float decay, float sustain, float release, float* expBuffer, int bufferSize, LEAF* const leaf)
+{
+    tADSRTBank_initToPool(bank, numEnvelopes, blockSize, attack, decay, sustain, release, expBuffer, bufferSize, &leaf->mempool);
+}
+
+void    tADSRTBank_initToPool    (tADSRTBank* const bank, int numEnvelopes, int blockSize, float attack, float decay, float sustain, float release, float* expBuffer, int bufferSize, tMempool* const mp)
+{
+    LEAF_PROFILE_POOL(mp);
+    _tMempool* m = *mp;
+    _tADSRTBank* b = *bank = (_tADSRTBank*) mpool_alloc(sizeof(_tADSRTBank), m);
+    b->mempool = m;
+    LEAF* leaf = b->mempool->leaf;
+    
+    b->numEnvelopes = numEnvelopes;
+    b->blockSize = blockSize;
+    b->buffers = (float*) mpool_calloc(sizeof(float) * numEnvelopes * blockSize, m);
+    b->stage = (uint8_t*) mpool_calloc(sizeof(uint8_t) * numEnvelopes, m);
+    b->next = (float*) mpool_calloc(sizeof(float) * numEnvelopes, m);
+    b->phase = (float*) mpool_calloc(sizeof(float) * numEnvelopes, m);
+    b->gain = (float*) mpool_calloc(sizeof(float) * numEnvelopes, m);
+    b->peak = (float*) mpool_calloc(sizeof(float) * numEnvelopes, m);
+    b->active = (int*) mpool_alloc(sizeof(int) * numEnvelopes, m);
+    b->activePos = (int*) mpool_alloc(sizeof(int) * numEnvelopes, m);
+    b->numActive = 0;
+    for (int i = 0; i < numEnvelopes; ++i) b->activePos[i] = -1;
+    
+    b->exp_buff = expBuffer;
+    b->buff_size = bufferSize;
+    b->maxPhase = (float) (uint32_t) (bufferSize - 1);
+    b->baseLeakFactor = 1.0f;
+    b->leakFactor = 1.0f;
+    b->attack = attack;
+    b->decay = decay;
+    b->release = release;
+    
+    tADSRTBank_setSustain(bank, sustain);
+    tADSRTBank_setSampleRate(bank, leaf->sampleRate);
+}
+
+void    tADSRTBank_free          (tADSRTBank* const bank)
+{
+    _tADSRTBank* b = *bank;
+    
+    mpool_free((char*) b->activePos, b->mempool);
+    mpool_free((char*) b->active, b->mempool);
+    mpool_free((char*) b->peak, b->mempool);
+    mpool_free((char*) b->gain, b->mempool);
+    mpool_free((char*) b->phase, b->mempool);
+    mpool_free((char*) b->next, b->mempool);
+    mpool_free((char*) b->stage, b->mempool);
+    mpool_free((char*) b->buffers, b->mempool);
+    mpool_free((char*) b, b->mempool);
+}
+
+int     tADSRTBank_tickBlock     (tADSRTBank* const bank, int size)
+{
+    LEAF_PROFILE_OBJECT(bank);
+    _tADSRTBank* b = *bank;
+    
+    if (size > b->blockSize) size = b->blockSize;
+    
+    for (int k = 0; k < b->numActive; )
+    {
+        int i = b->active[k];
+        float* out = b->buffers + i * b->blockSize;
+        int stage = b->stage[i];
+        float next = b->next[i];
+        float phase = b->phase[i];
+        float gain = b->gain[i];
+        float peak = b->peak[i];
+        
+        if (stage == env_idle)
+        {
+            // Finished last block, flatten the whole buffer once and drop off the list
+            for (int n = 0; n < b->blockSize; ++n) out[n] = next;
+            envBank_deactivate(b->active, b->activePos, &b->numActive, i);
+            continue;
+        }
+        
+        // Run each stage as a tight loop up to the sample where it hands over to the next
+        int n = 0;
+        while (n < size)
+        {
+            switch (stage)
+            {
+                case env_ramp:
+                    for (; n < size; ++n)
+                    {
+                        if (phase > b->maxPhase)
+                        {
+                            stage = env_attack;
+                            phase = 0.0f;
+                            next = 0.0f;
+                            out[n++] = next;
+                            break;
+                        }
+                        next = peak * adsrtBank_read(b, phase);
+                        out[n] = next;
+                        phase += b->rampInc;
+                    }
+                    break;
+                
+                case env_attack:
+                    for (; n < size; ++n)
+                    {
+                        if (phase > b->maxPhase)
+                        {
+                            stage = env_decay;
+                            phase = 0.0f;
+                            next = gain;
+                            out[n++] = next;
+                            break;
+                        }
+                        next = gain * (1.0f - adsrtBank_read(b, phase));
+                        out[n] = next;
+                        phase += b->attackInc;
+                    }
+                    break;
+                
+                case env_decay:
+                {
+                    float sustain = b->sustain;
+                    float depth = 1.0f - sustain;
+                    for (; n < size; ++n)
+                    {
+                        if (phase > b->maxPhase)
+                        {
+                            stage = env_sustain;
+                            next = gain * sustain;
+                            out[n++] = next;
+                            break;
+                        }
+                        next = (gain * (sustain + (adsrtBank_read(b, phase) * depth))) * b->leakFactor;
+                        out[n] = next;
+                        phase += b->decayInc;
+                    }
+                    break;
+                }
+                
+                case env_sustain:
+                    if (b->leakFactor == 1.0f) for (; n < size; ++n) out[n] = next;
+                    else for (; n < size; ++n)
+                    {
+                        next = next * b->leakFactor;
+                        out[n] = next;
+                    }
+                    break;
+                
+                case env_release:
+                    for (; n < size; ++n)
+                    {
+                        if (phase > b->maxPhase)
+                        {
+                            stage = env_idle;
+                            next = 0.0f;
+                            out[n++] = next;
+                            break;
+                        }
+                        next = peak * adsrtBank_read(b, phase);
+                        out[n] = next;
+                        phase += b->releaseInc;
+                    }
+                    break;
+                
+                default:
+                    for (; n < size; ++n) out[n] = next;
+                    break;
+            }
+        }
+        
+        b->stage[i] = stage;
+        b->next[i] = next;
+        b->phase[i] = phase;
+        k++;
+    }
+    
+    return b->numActive;
+}
+
+float*  tADSRTBank_getBuffer     (tADSRTBank* const bank, int index)
+{
+    _tADSRTBank* b = *bank;
+    return b->buffers + index * b->blockSize;
+}
+
+float   tADSRTBank_getValue      (tADSRTBank* const bank, int index)
+{
+    _tADSRTBank* b = *bank;
+    return b->next[index];
+}
+
+int     tADSRTBank_isActive      (tADSRTBank* const bank, int index)
+{
+    _tADSRTBank* b = *bank;
+    return b->activePos[index] >= 0;
+}
+
+void    tADSRTBank_on            (tADSRTBank* const bank, int index, float velocity)
+{
+    _tADSRTBank* b = *bank;
+    
+    if (b->stage[index] != env_idle) // In case ADSR retriggered while it is still happening.
+    {
+        b->stage[index] = env_ramp;
+        b->peak[index] = b->next[index];
+    }
+    else b->stage[index] = env_attack;
+    
+    b->phase[index] = 0.0f;
+    b->gain[index] = velocity;
+    envBank_activate(b->active, b->activePos, &b->numActive, index);
+}
+
+void    tADSRTBank_off           (tADSRTBank* const bank, int index)
+{
+    _tADSRTBank* b = *bank;
+    
+    if (b->stage[index] == env_idle) return;
+    
+    // Releasing again carries on down the same release from the current level
+    if (b->stage[index] != env_release) b->phase[index] = 0.0f;
+    b->stage[index] = env_release;
+    b->peak[index] = b->next[index];
+}
+
+void    tADSRTBank_setAttack     (tADSRTBank* const bank, float attack)
+{
+    _tADSRTBank* b = *bank;
+    
+    if (attack < 0.0f) attack = 0.0f;
+    b->attack = attack;
+    b->attackInc = b->bufferSizeDividedBySampleRateInMs / attack;
+}
+
+void    tADSRTBank_setDecay      (tADSRTBank* const bank, float decay)
+{
+    _tADSRTBank* b = *bank;
+    
+    if (decay < 0.0f) decay = 0.0f;
+    b->decay = decay;
+    b->decayInc = b->bufferSizeDividedBySampleRateInMs / decay;
+}
+
+void    tADSRTBank_setSustain    (tADSRTBank* const bank, float sustain)
+{
+    _tADSRTBank* b = *bank;
+    
+    if (sustain > 1.0f)      b->sustain = 1.0f;
+    else if (sustain < 0.0f) b->sustain = 0.0f;
+    else                     b->sustain = sustain;
+}
+
+void    tADSRTBank_setRelease    (tADSRTBank* const bank, float release)
+{
+    _tADSRTBank* b = *bank;
+    
+    if (release < 0.0f) release = 0.0f;
+    b->release = release;
+    b->releaseInc = b->bufferSizeDividedBySampleRateInMs / release;
+}
+
+void    tADSRTBank_setLeakFactor (tADSRTBank* const bank, float leakFactor)
+{
+    _tADSRTBank* b = *bank;
+    
+    b->baseLeakFactor = leakFactor;
+    b->leakFactor = powf(leakFactor, 44100.0f * (1.0f / b->sampleRate));
+}
+
+void    tADSRTBank_setSampleRate (tADSRTBank* const bank, float sr)
+{
+    _tADSRTBank* b = *bank;
+    
+    b->sampleRate = sr;
+    b->bufferSizeDividedBySampleRateInMs = b->buff_size / (sr * 0.001f);
+    b->rampInc = b->bufferSizeDividedBySampleRateInMs / 8.0f;
+    tADSRTBank_setAttack(bank, b->attack);
+    tADSRTBank_setDecay(bank, b->decay);
+    tADSRTBank_setRelease(bank, b->release);
+    tADSRTBank_setLeakFactor(bank, b->baseLeakFactor);
+}
+
+void    tADSRSBank_init          (tADSRSBank* const bank, int numEnvelopes, int blockSize, float attack, float decay, float sustain, float release, LEAF* const leaf)
+{
+    tADSRSBank_initToPool(bank, numEnvelopes, blockSize, attack, decay, sustain, release, &leaf->mempool);
+}
+
+void    tADSRSBank_initToPool    (tADSRSBank* const bank, int numEnvelopes, int blockSize, float attack, float decay, float sustain, float release, tMempool* const mp)
+{
+    LEAF_PROFILE_POOL(mp);
+    _tMempool* m = *mp;
+    _tADSRSBank* b = *bank = (_tADSRSBank*) mpool_alloc(sizeof(_tADSRSBank), m);
+    b->mempool = m;
+    LEAF* leaf = b->mempool->leaf;
+    
+    b->numEnvelopes = numEnvelopes;
+    b->blockSize = blockSize;
+    b->buffers = (float*) mpool_calloc(sizeof(float) * numEnvelopes * blockSize, m);
+    b->state = (uint8_t*) mpool_calloc(sizeof(uint8_t) * numEnvelopes, m);
+    b->output = (float*) mpool_calloc(sizeof(float) * numEnvelopes, m);
+    b->gain = (float*) mpool_alloc(sizeof(float) * numEnvelopes, m);
+    b->targetGainSquared = (float*) mpool_alloc(sizeof(float) * numEnvelopes, m);
+    b->active = (int*) mpool_alloc(sizeof(int) * numEnvelopes, m);
+    b->activePos = (int*) mpool_alloc(sizeof(int) * numEnvelopes, m);
+    b->numActive = 0;
+    for (int i = 0; i < numEnvelopes; ++i)
+    {
+        b->gain[i] = 1.0f;
+        b->targetGainSquared[i] = 1.0f;
+        b->activePos[i] = -1;
+    }
+    
+    b->targetRatioA = 0.3f;
+    b->targetRatioDR = 0.0001f;
+    b->factor = 0.01f;
+    b->oneMinusFactor = 0.99f;
+    b->baseLeakFactor = 1.0f;
+    b->attack = attack;
+    b->decay = decay;
+    b->sustainLevel = sustain;
+    b->release = release;
+    
+    tADSRSBank_setSampleRate(bank, leaf->sampleRate);
+}
+
+void    tADSRSBank_free          (tADSRSBank* const bank)
+{
+    _tADSRSBank* b = *bank;
+    
+    mpool_free((char*) b->activePos, b->mempool);
+    mpool_free((char*) b->active, b->mempool);
+    mpool_free((char*) b->targetGainSquared, b->mempool);
+    mpool_free((char*) b->gain, b->mempool);
+    mpool_free((char*) b->output, b->mempool);
+    mpool_free((char*) b->state, b->mempool);
+    mpool_free((char*) b->buffers, b->mempool);
+    mpool_free((char*) b, b->mempool);
+}
+
+int     tADSRSBank_tickBlock     (tADSRSBank* const bank, int size)
+{
+    LEAF_PROFILE_OBJECT(bank);
+    _tADSRSBank* b = *bank;
+    
+    if (size > b->blockSize) size = b->blockSize;
+    
+    float factor = b->factor;
+    float oneMinusFactor = b->oneMinusFactor;
+    
+    for (int k = 0; k < b->numActive; )
+    {
+        int i = b->active[k];
+        float* out = b->buffers + i * b->blockSize;
+        int state = b->state[i];
+        float output = b->output[i];
+        float gain = b->gain[i];
+        float target = factor * b->targetGainSquared[i];
+        
+        // The gain is smoothed even while idle, so an idle envelope can only be dropped once the
+        // smoothing has stopped changing it
+        if ((state == env_idle) && (target + oneMinusFactor * gain == gain))
+        {
+            for (int n = 0; n < b->blockSize; ++n) out[n] = output * gain;
+            envBank_deactivate(b->active, b->activePos, &b->numActive, i);
+            continue;
+        }
+        
+        int n = 0;
+        while (n < size)
+        {
+            switch (state)
+            {
+                case env_attack:
+                    for (; n < size; )
+                    {
+                        output = b->attackBase + output * b->attackCoef;
+                        gain = target + oneMinusFactor * gain;
+                        if (output >= 1.0f)
+                        {
+                            output = 1.0f;
+                            state = env_decay;
+                            out[n++] = output * gain;
+                            break;
+                        }
+                        out[n++] = output * gain;
+                    }
+                    break;
+                
+                case env_decay:
+                    for (; n < size; )
+                    {
+                        output = b->decayBase + output * b->decayCoef * b->leakFactor;
+                        gain = target + oneMinusFactor * gain;
+                        if (output <= b->sustainLevel)
+                        {
+                            output = b->sustainLevel;
+                            state = env_sustain;
+                            out[n++] = output * gain;
+                            break;
+                        }
+                        out[n++] = output * gain;
+                    }
+                    break;
+                
+                case env_sustain:
+                    for (; n < size; ++n)
+                    {
+                        output = output * b->leakFactor;
+                        gain = target + oneMinusFactor * gain;
+                        out[n] = output * gain;
+                    }
+                    break;
+                
+                case env_release:
+                    for (; n < size; )
+                    {
+                        output = b->releaseBase + output * b->releaseCoef;
+                        gain = target + oneMinusFactor * gain;
+                        if (output <= 0.0f)
+                        {
+                            output = 0.0f;
+                            state = env_idle;
+                            out[n++] = output * gain;
+                            break;
+                        }
+                        out[n++] = output * gain;
+                    }
+                    break;
+                
+                default:
+                    for (; n < size; ++n)
+                    {
+                        gain = target + oneMinusFactor * gain;
+                        out[n] = output * gain;
+                    }
+                    break;
+            }
+        }
+        
+        b->state[i] = state;
+        b->output[i] = output;
+        b->gain[i] = gain;
+        k++;
+    }
+    
+    return b->numActive;
+}
+
+float*  tADSRSBank_getBuffer     (tADSRSBank* const bank, int index)
+{
+    _tADSRSBank* b = *bank;
+    return b->buffers + index * b->blockSize;
+}
+
+float   tADSRSBank_getValue      (tADSRSBank* const bank, int index)
+{
+    _tADSRSBank* b = *bank;
+    return b->output[index] * b->gain[index];
+}
+
+int     tADSRSBank_isActive      (tADSRSBank* const bank, int index)
+{
+    _tADSRSBank* b = *bank;
+    return b->activePos[index] >= 0;
+}
+
+void    tADSRSBank_on            (tADSRSBank* const bank, int index, float velocity)
+{
+    _tADSRSBank* b = *bank;
+    
+    b->state[index] = env_attack;
+    b->targetGainSquared[index] = velocity * velocity;
+    envBank_activate(b->active, b->activePos, &b->numActive, index);
+}
+
+void    tADSRSBank_off           (tADSRSBank* const bank, int index)
+{
+    _tADSRSBank* b = *bank;
+    
+    if (b->state[index] != env_idle) b->state[index] = env_release;
+}
+
+void    tADSRSBank_setAttack     (tADSRSBank* const bank, float attack)
+{
+    _tADSRSBank* b = *bank;
+    
+    b->attack = attack;
+    b->attackCoef = calcADSR3Coef(attack * b->sampleRateInMs, b->targetRatioA);
+    b->attackBase = (1.0f + b->targetRatioA) * (1.0f - b->attackCoef);
+}
+
+void    tADSRSBank_setDecay      (tADSRSBank* const bank, float decay)
+{
+    _tADSRSBank* b = *bank;
+    
+    b->decay = decay;
+    b->decayCoef = calcADSR3Coef(decay * b->sampleRateInMs, b->targetRatioDR);
+    b->decayBase = (b->sustainLevel - b->targetRatioDR) * (1.0f - b->decayCoef);
+}
+
+void    tADSRSBank_setSustain    (tADSRSBank* const bank, float sustain)
+{
+    _tADSRSBank* b = *bank;
+    
+    b->sustainLevel = sustain;
+    b->decayBase = (b->sustainLevel - b->targetRatioDR) * (1.0f - b->decayCoef);
+}
+
+void    tADSRSBank_setRelease    (tADSRSBank* const bank, float release)
+{
+    _tADSRSBank* b = *bank;
+    
+    b->release = release;
+    b->releaseCoef = calcADSR3Coef(release * b->sampleRateInMs, b->targetRatioDR);
+    b->releaseBase = -b->targetRatioDR * (1.0f - b->releaseCoef);
+}
+
+void    tADSRSBank_setLeakFactor (tADSRSBank* const bank, float leakFactor)
+{
+    _tADSRSBank* b = *bank;
+    
+    b->baseLeakFactor = leakFactor;
+    b->leakFactor = powf(leakFactor, 44100.0f * b->invSampleRate);
+}
+
+void    tADSRSBank_setSampleRate (tADSRSBank* const bank, float sr)
+{
+    _tADSRSBank* b = *bank;
+    
+    b->sampleRate = sr;
+    b->sampleRateInMs = sr * 0.001f;
+    b->invSampleRate = 1.0f / sr;
+    tADSRSBank_setAttack(bank, b->attack);
+    tADSRSBank_setDecay(bank, b->decay);
+    tADSRSBank_setRelease(bank, b->release);
+    tADSRSBank_setLeakFactor(bank, b->baseLeakFactor);
+}
@@ -0,0 +1,138 @@
+/*==============================================================================
+
+ leaf-events.c
+ 
+ ==============================================================================*/
+
+#if _WIN32 || _WIN64
+
+#include "..\Inc\leaf-events.h"
+
+#else
+
+#include "../Inc/leaf-events.h"
+
+#endif
+
+//==============================================================================
+// Event queue
+//==============================================================================
+
+// write is only stored by the producer and read and time only by the audio thread, so each index has
+// one writer and the ring needs no lock. An event slot is filled before write is released past it and
+// not reused until read has been released past it.
+
+void    tEventQueue_init            (tEventQueue* const queue, int capacity, LEAF* const leaf)
+{
+    tEventQueue_initToPool(queue, capacity, &leaf->mempool);
+}
+
+void    tEventQueue_initToPool      (tEventQueue* const queue, int capacity, tMempool* const mp)
+{
+    _tMempool* m = *mp;
+    _tEventQueue* q = *queue = (_tEventQueue*) mpool_alloc(sizeof(_tEventQueue), m);
+    q->mempool = m;
+    
+    uint32_t size = 2;
+    while (size < (uint32_t) capacity) size <<= 1;
+    q->events = (LEAFEvent*) mpool_calloc(sizeof(LEAFEvent) * size, m);
+    q->mask = size - 1;
+    q->write = 0;
+    q->read = 0;
+    q->time = 0;
+}
+
+void    tEventQueue_free            (tEventQueue* const queue)
+{
+    _tEventQueue* q = *queue;
+    
+    mpool_free((char*) q->events, q->mempool);
+    mpool_free((char*) q, q->mempool);
+}
+
+int     tEventQueue_push            (tEventQueue* const queue, const LEAFEvent* const event)
+{
+    _tEventQueue* q = *queue;
+    
+    uint32_t write = q->write;
+    if (write - leaf_loadAcquire(&q->read) > q->mask) return 0;
+    
+    q->events[write & q->mask] = *event;
+    leaf_storeRelease(&q->write, write + 1);
+    return 1;
+}
+
+int     tEventQueue_pushParam       (tEventQueue* const queue, uint32_t time, int param, float value)
+{
+    LEAFEvent event = { time, EventParam, 0, (uint16_t) param, value };
+    return tEventQueue_push(queue, &event);
+}
+
+int     tEventQueue_pushNoteOn      (tEventQueue* const queue, uint32_t time, int channel, int note, float velocity)
+{
+    LEAFEvent event = { time, EventNoteOn, (uint8_t) channel, (uint16_t) note, velocity };
+    return tEventQueue_push(queue, &event);
+}
+
+int     tEventQueue_pushNoteOff     (tEventQueue* const queue, uint32_t time, int channel, int note)
+{
+    LEAFEvent event = { time, EventNoteOff, (uint8_t) channel, (uint16_t) note, 0.0f };
+    return tEventQueue_push(queue, &event);
+}
+
+int     tEventQueue_pushControlChange (tEventQueue* const queue, uint32_t time, int channel, int controller, float value)
+{
+    LEAFEvent event = { time, EventControlChange, (uint8_t) channel, (uint16_t) controller, value };
+    return tEventQueue_push(queue, &event);
+}
+
+uint32_t tEventQueue_getTime        (tEventQueue* const queue)
+{
+    _tEventQueue* q = *queue;
+    
+    return leaf_loadAcquire(&q->time);
+}
+
+int     tEventQueue_getNext         (tEventQueue* const queue, int size, LEAFEvent* const event)
+{
+    _tEventQueue* q = *queue;
+    
+    uint32_t read = q->read;
+    if (read == leaf_loadAcquire(&q->write)) return -1;
+    
+    // Compare as a signed difference so the clock can wrap
+    LEAFEvent* next = &q->events[read & q->mask];
+    int32_t offset = (int32_t) (next->time - q->time);
+    if (offset >= size) return -1;
+    if (offset < 0) offset = 0;
+    
+    *event = *next;
+    leaf_storeRelease(&q->read, read + 1);
+    return (int) offset;
+}
+
+void    tEventQueue_advance         (tEventQueue* const queue, int size)
+{
+    _tEventQueue* q = *queue;
+    
+    leaf_storeRelease(&q->time, q->time + (uint32_t) size);
+}
+
+void    tEventQueue_processBlock    (tEventQueue* const queue, int size, tEventApplyCallback apply, tEventRenderCallback render, void* userData)
+{
+    LEAFEvent event;
+    int pos = 0;
+    int offset;
+    while ((offset = tEventQueue_getNext(queue, size, &event)) >= 0)
+    {
+        if (offset > pos)
+        {
+            render(userData, pos, offset - pos);
+            pos = offset;
+        }
+        apply(userData, &event);
+    }
+    if (pos < size) render(userData, pos, size - pos);
+    
+    tEventQueue_advance(queue, size);
+}
@@ -0,0 +1,281 @@
+/*==============================================================================
+
+ leaf-fft.c
+ 
+ ==============================================================================*/
+
+#if _WIN32 || _WIN64
+
+#include "..\Inc\leaf-fft.h"
+
+#else
+
+#include "../Inc/leaf-fft.h"
+
+#endif
+
+//==============================================================================
+// Real FFT
+//==============================================================================
+
+// A size point real transform is done as a size / 2 point complex transform of the even samples
+// as the real parts and the odd samples as the imaginary parts, followed by a split step that
+// separates the two spectra and combines them into the spectrum of the real signal.
+
+void    tRealFFT_init           (tRealFFT* const fftr, int size, LEAF* const leaf)
+{
+    tRealFFT_initToPool(fftr, size, &leaf->mempool);
+}
+
+void    tRealFFT_initToPool     (tRealFFT* const fftr, int size, tMempool* const mp)
+{
+    LEAF_PROFILE_POOL(mp);
+    _tMempool* m = *mp;
+    _tRealFFT* f = *fftr = (_tRealFFT*) mpool_alloc(sizeof(_tRealFFT), m);
+    f->mempool = m;
+    
+    f->size = size;
+
+#if LEAF_USE_CMSIS
+    arm_rfft_fast_init_f32(&f->instance, size);
+    f->scratch = (float*) mpool_alloc(sizeof(float) * size, m);
+#else
+    int half = size / 2;
+    
+    f->twiddles = (float*) mpool_alloc(sizeof(float) * size, m);
+    for (int k = 0; k < half; ++k)
+    {
+        double phase = -2.0 * 3.14159265358979323846 * (double) k / (double) size;
+        f->twiddles[2 * k] = (float) cos(phase);
+        f->twiddles[2 * k + 1] = (float) sin(phase);
+    }
+    
+    int bits = 0;
+    while ((1 << bits) < half) bits++;
+    f->bitrev = (int*) mpool_alloc(sizeof(int) * half, m);
+    for (int i = 0; i < half; ++i)
+    {
+        int r = 0;
+        for (int b = 0; b < bits; ++b) r |= ((i >> b) & 1) << (bits - 1 - b);
+        f->bitrev[i] = r;
+    }
+#endif
+}
+
+void    tRealFFT_free           (tRealFFT* const fftr)
+{
+    _tRealFFT* f = *fftr;
+
+#if LEAF_USE_CMSIS
+    mpool_free((char*)f->scratch, f->mempool);
+#else
+    mpool_free((char*)f->bitrev, f->mempool);
+    mpool_free((char*)f->twiddles, f->mempool);
+#endif
+    mpool_free((char*)f, f->mempool);
+}
+
+#if !LEAF_USE_CMSIS
+// In-place radix-2 complex transform of size / 2 interleaved points. Inverse uses conjugate twiddles and is unscaled.
+static void tRealFFT_complex(_tRealFFT* f, float* x, int inverse)
+{
+    int n = f->size / 2;
+    const float* tw = f->twiddles;
+    const int* bitrev = f->bitrev;
+    
+    for (int i = 0; i < n; ++i)
+    {
+        int j = bitrev[i];
+        if (j > i)
+        {
+            float tr = x[2 * i], ti = x[2 * i + 1];
+            x[2 * i] = x[2 * j];
+            x[2 * i + 1] = x[2 * j + 1];
+            x[2 * j] = tr;
+            x[2 * j + 1] = ti;
+        }
+    }
+    
+    float sign = inverse ? -1.0f : 1.0f;
+    
+    // First two stages as radix-4 butterflies, where the twiddles are 1 and -i (or i for the inverse)
+    if (n >= 4)
+    {
+        for (int start = 0; start < n; start += 4)
+        {
+            float* p = &x[2 * start];
+            float ar = p[0] + p[2], ai = p[1] + p[3];
+            float br = p[0] - p[2], bi = p[1] - p[3];
+            float cr = p[4] + p[6], ci = p[5] + p[7];
+            float dr = p[4] - p[6], di = p[5] - p[7];
+            // d * -i for forward, d * i for inverse
+            float tr = di * sign, ti = -dr * sign;
+            p[0] = ar + cr; p[1] = ai + ci;
+            p[4] = ar - cr; p[5] = ai - ci;
+            p[2] = br + tr; p[3] = bi + ti;
+            p[6] = br - tr; p[7] = bi - ti;
+        }
+    }
+    else if (n == 2)
+    {
+        float ar = x[0], ai = x[1];
+        x[0] = ar + x[2]; x[1] = ai + x[3];
+        x[2] = ar - x[2]; x[3] = ai - x[3];
+    }
+    
+    // Remaining stages, two at a time where possible. The twiddle table is for the real size,
+    // so W_len^k for a stage of length len is entry k * size / len.
+    int len = 8;
+    int size = f->size;
+    for (; 2 * len <= n; len <<= 2)
+    {
+        // Stages of length len and 2 * len fused: elements k, k + h, k + 2h, k + 3h of each group of 4h, with h = len / 2
+        int h = len >> 1;
+        int step = size / (2 * len);
+        for (int k = 0; k < h; ++k)
+        {
+            float w1r = tw[2 * k * step], w1i = tw[2 * k * step + 1] * sign;
+            float w2r = tw[4 * k * step], w2i = tw[4 * k * step + 1] * sign;
+            for (int start = k; start < n; start += 4 * h)
+            {
+                float* p0 = &x[2 * start];
+                float* p1 = &x[2 * (start + h)];
+                float* p2 = &x[2 * (start + 2 * h)];
+                float* p3 = &x[2 * (start + 3 * h)];
+                
+                float br = p1[0] * w2r - p1[1] * w2i, bi = p1[0] * w2i + p1[1] * w2r;
+                float dr = p3[0] * w2r - p3[1] * w2i, di = p3[0] * w2i + p3[1] * w2r;
+                float a0r = p0[0] + br, a0i = p0[1] + bi;
+                float a1r = p0[0] - br, a1i = p0[1] - bi;
+                float c0r = p2[0] + dr, c0i = p2[1] + di;
+                float c1r = p2[0] - dr, c1i = p2[1] - di;
+                
+                float tr = c0r * w1r - c0i * w1i, ti = c0r * w1i + c0i * w1r;
+                // W_4h^(k + h) = W_4h^k * -i (i for the inverse)
+                float ur = c1r * w1r - c1i * w1i, ui = c1r * w1i + c1i * w1r;
+                float vr = ui * sign, vi = -ur * sign;
+                
+                p0[0] = a0r + tr; p0[1] = a0i + ti;
+                p2[0] = a0r - tr; p2[1] = a0i - ti;
+                p1[0] = a1r + vr; p1[1] = a1i + vi;
+                p3[0] = a1r - vr; p3[1] = a1i - vi;
+            }
+        }
+    }
+    
+    // A last single stage when the number of stages is odd
+    if (len <= n)
+    {
+        int h = len >> 1;
+        int step = size / len;
+        for (int k = 0; k < h; ++k)
+        {
+            float wr = tw[2 * k * step];
+            float wi = tw[2 * k * step + 1] * sign;
+            float* a = &x[2 * k];
+            float* b = &x[2 * (k + h)];
+            float br = b[0] * wr - b[1] * wi;
+            float bi = b[0] * wi + b[1] * wr;
+            b[0] = a[0] - br;
+            b[1] = a[1] - bi;
+            a[0] += br;
+            a[1] += bi;
+        }
+    }
+}
+#endif
+
+void    tRealFFT_forward        (tRealFFT* const fftr, float* buffer)
+{
+    _tRealFFT* f = *fftr;
+
+#if LEAF_USE_CMSIS
+    float* scratch = f->scratch;
+    for (int i = 0; i < f->size; ++i) scratch[i] = buffer[i];
+    arm_rfft_fast_f32(&f->instance, scratch, buffer, 0);
+#else
+    int n = f->size / 2;
+    const float* tw = f->twiddles;
+    
+    tRealFFT_complex(f, buffer, 0);
+    
+    // Split: X[k] = (Z[k] + conj(Z[n-k])) / 2 - i/2 * W^k * (Z[k] - conj(Z[n-k]))
+    float z0r = buffer[0], z0i = buffer[1];
+    buffer[0] = z0r + z0i;
+    buffer[1] = z0r - z0i;
+    
+    for (int k = 1; k <= n / 2; ++k)
+    {
+        float* a = &buffer[2 * k];
+        float* b = &buffer[2 * (n - k)];
+        
+        float er = 0.5f * (a[0] + b[0]);
+        float ei = 0.5f * (a[1] - b[1]);
+        float or_ = 0.5f * (a[1] + b[1]);
+        float oi = -0.5f * (a[0] - b[0]);
+        
+        float wr = tw[2 * k];
+        float wi = tw[2 * k + 1];
+        float tr = or_ * wr - oi * wi;
+        float ti = or_ * wi + oi * wr;
+        
+        // Bin n - k is the conjugate symmetric partner, W^(n-k) = -conj(W^k)
+        a[0] = er + tr;
+        a[1] = ei + ti;
+        b[0] = er - tr;
+        b[1] = -(ei - ti);
+    }
+#endif
+}
+
+void    tRealFFT_inverse        (tRealFFT* const fftr, float* buffer)
+{
+    _tRealFFT* f = *fftr;
+
+#if LEAF_USE_CMSIS
+    float* scratch = f->scratch;
+    for (int i = 0; i < f->size; ++i) scratch[i] = buffer[i];
+    arm_rfft_fast_f32(&f->instance, scratch, buffer, 1);
+#else
+    int n = f->size / 2;
+    const float* tw = f->twiddles;
+    
+    // Undo the split: Z[k] = E[k] + i O[k], with E[k] = (X[k] + conj(X[n-k])) / 2 and O[k] = (X[k] - conj(X[n-k])) / 2 * conj(W^k)
+    float dc = buffer[0], nyq = buffer[1];
+    buffer[0] = 0.5f * (dc + nyq);
+    buffer[1] = 0.5f * (dc - nyq);
+    
+    for (int k = 1; k <= n / 2; ++k)
+    {
+        float* a = &buffer[2 * k];
+        float* b = &buffer[2 * (n - k)];
+        
+        float er = 0.5f * (a[0] + b[0]);
+        float ei = 0.5f * (a[1] - b[1]);
+        float dr = 0.5f * (a[0] - b[0]);
+        float di = 0.5f * (a[1] + b[1]);
+        
+        float wr = tw[2 * k];
+        float wi = -tw[2 * k + 1];
+        float or_ = dr * wr - di * wi;
+        float oi = dr * wi + di * wr;
+        
+        // Z[k] = E + iO, Z[n-k] = conj(E) + i conj(O)
+        a[0] = er - oi;
+        a[1] = ei + or_;
+        b[0] = er + oi;
+        b[1] = -ei + or_;
+    }
+    
+    tRealFFT_complex(f, buffer, 1);
+    
+    float scale = 1.0f / (float) n;
+    for (int i = 0; i < f->size; ++i) buffer[i] *= scale;
+#endif
+}
+
+int     tRealFFT_getSize        (tRealFFT* const fftr)
+{
+    _tRealFFT* f = *fftr;
+    return f->size;
+}
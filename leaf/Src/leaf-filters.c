@@ -28,6 +28,7 @@ void    tAllpass_init(tAllpass* const ft, float initDelay, uint32_t maxDelay, LE
 
 void    tAllpass_initToPool     (tAllpass* const ft, float initDelay, uint32_t maxDelay, tMempool* const mp)
 {
+    LEAF_PROFILE_POOL(mp);
     _tMempool* m = *mp;
     _tAllpass* f = *ft = (_tAllpass*) mpool_alloc(sizeof(_tAllpass), m);
     f->mempool = m;
@@ -63,6 +64,7 @@ void    tAllpass_setGain(tAllpass* const ft, float gain)
 
 float   tAllpass_tick(tAllpass* const ft, float input)
 {
+    LEAF_PROFILE_OBJECT(ft);
     _tAllpass* f = *ft;
     
     float s1 = (-f->gain) * f->lastOut + input;
@@ -82,6 +84,7 @@ void    tOnePole_init(tOnePole* const ft, float freq, LEAF* const leaf)
 
 void    tOnePole_initToPool     (tOnePole* const ft, float freq, tMempool* const mp)
 {
+    LEAF_PROFILE_POOL(mp);
     _tMempool* m = *mp;
     _tOnePole* f = *ft = (_tOnePole*) mpool_alloc(sizeof(_tOnePole), m);
     f->mempool = m;
@@ -157,6 +160,7 @@ void    tOnePole_setGain(tOnePole* const ft, float gain)
 
 float   tOnePole_tick(tOnePole* const ft, float input)
 {
+    LEAF_PROFILE_OBJECT(ft);
     _tOnePole* f = *ft;
     
     float in = input * f->gain;
@@ -168,6 +172,28 @@ float   tOnePole_tick(tOnePole* const ft, float input)
     return out;
 }
 
+void    tOnePole_tickBlock(tOnePole* const ft, const float* input, float* output, int size)
+{
+    LEAF_PROFILE_OBJECT(ft);
+    _tOnePole* f = *ft;
+    
+    float gain = f->gain;
+    float b0 = f->b0;
+    float a1 = f->a1;
+    float in = f->lastIn;
+    float out = f->lastOut;
+    
+    for (int i = 0; i < size; ++i)
+    {
+        in = input[i] * gain;
+        out = (b0 * in) + (a1 * out);
+        output[i] = out;
+    }
+    
+    f->lastIn = in;
+    f->lastOut = out;
+}
+
 void tOnePole_setSampleRate(tOnePole* const ft, float sr)
 {
     _tOnePole* f = *ft;
@@ -185,6 +211,7 @@ void    tTwoPole_init(tTwoPole* const ft, LEAF* const leaf)
 
 void    tTwoPole_initToPool     (tTwoPole* const ft, tMempool* const mp)
 {
+    LEAF_PROFILE_POOL(mp);
     _tMempool* m = *mp;
     _tTwoPole* f = *ft = (_tTwoPole*) mpool_alloc(sizeof(_tTwoPole), m);
     f->mempool = m;
@@ -209,6 +236,7 @@ void    tTwoPole_free  (tTwoPole* const ft)
 
 float   tTwoPole_tick(tTwoPole* const ft, float input)
 {
+    LEAF_PROFILE_OBJECT(ft);
     _tTwoPole* f = *ft;
     
     float in = input * f->gain;
@@ -220,6 +248,31 @@ float   tTwoPole_tick(tTwoPole* const ft, float input)
     return out;
 }
 
+void    tTwoPole_tickBlock(tTwoPole* const ft, const float* input, float* output, int size)
+{
+    LEAF_PROFILE_OBJECT(ft);
+    _tTwoPole* f = *ft;
+    
+    float gain = f->gain;
+    float b0 = f->b0;
+    float a1 = f->a1;
+    float a2 = f->a2;
+    float y1 = f->lastOut[0];
+    float y2 = f->lastOut[1];
+    
+    for (int i = 0; i < size; ++i)
+    {
+        float in = input[i] * gain;
+        float out = (b0 * in) - (a1 * y1) - (a2 * y2);
+        y2 = y1;
+        y1 = out;
+        output[i] = out;
+    }
+    
+    f->lastOut[0] = y1;
+    f->lastOut[1] = y2;
+}
+
 void    tTwoPole_setB0(tTwoPole* const ft, float b0)
 {
     _tTwoPole* f = *ft;
@@ -306,6 +359,7 @@ void    tOneZero_init(tOneZero* const ft, float theZero, LEAF* const leaf)
 
 void    tOneZero_initToPool     (tOneZero* const ft, float theZero, tMempool* const mp)
 {
+    LEAF_PROFILE_POOL(mp);
     _tMempool* m = *mp;
     _tOneZero* f = *ft = (_tOneZero*) mpool_alloc(sizeof(_tOneZero), m);
     f->mempool = m;
@@ -326,6 +380,7 @@ void    tOneZero_free   (tOneZero* const ft)
 
 float   tOneZero_tick(tOneZero* const ft, float input)
 {
+    LEAF_PROFILE_OBJECT(ft);
     _tOneZero* f = *ft;
     
     float in = input * f->gain;
@@ -336,6 +391,26 @@ float   tOneZero_tick(tOneZero* const ft, float input)
     return out;
 }
 
+void    tOneZero_tickBlock(tOneZero* const ft, const float* input, float* output, int size)
+{
+    LEAF_PROFILE_OBJECT(ft);
+    _tOneZero* f = *ft;
+    
+    float gain = f->gain;
+    float b0 = f->b0;
+    float b1 = f->b1;
+    float x1 = f->lastIn;
+    
+    for (int i = 0; i < size; ++i)
+    {
+        float in = input[i] * gain;
+        output[i] = b1 * x1 + b0 * in;
+        x1 = in;
+    }
+    
+    f->lastIn = x1;
+}
+
 void    tOneZero_setZero(tOneZero* const ft, float theZero)
 {
     _tOneZero* f = *ft;
@@ -417,6 +492,7 @@ void    tTwoZero_init(tTwoZero* const ft, LEAF* const leaf)
 
 void    tTwoZero_initToPool     (tTwoZero* const ft, tMempool* const mp)
 {
+    LEAF_PROFILE_POOL(mp);
     _tMempool* m = *mp;
     _tTwoZero* f = *ft = (_tTwoZero*) mpool_alloc(sizeof(_tTwoZero), m);
     f->mempool = m;
@@ -436,6 +512,7 @@ void    tTwoZero_free   (tTwoZero* const ft)
 
 float   tTwoZero_tick(tTwoZero* const ft, float input)
 {
+    LEAF_PROFILE_OBJECT(ft);
     _tTwoZero* f = *ft;
     
     float in = input * f->gain;
@@ -447,6 +524,30 @@ float   tTwoZero_tick(tTwoZero* const ft, float input)
     return out;
 }
 
+void    tTwoZero_tickBlock(tTwoZero* const ft, const float* input, float* output, int size)
+{
+    LEAF_PROFILE_OBJECT(ft);
+    _tTwoZero* f = *ft;
+    
+    float gain = f->gain;
+    float b0 = f->b0;
+    float b1 = f->b1;
+    float b2 = f->b2;
+    float x1 = f->lastIn[0];
+    float x2 = f->lastIn[1];
+    
+    for (int i = 0; i < size; ++i)
+    {
+        float in = input[i] * gain;
+        output[i] = b2 * x2 + b1 * x1 + b0 * in;
+        x2 = x1;
+        x1 = in;
+    }
+    
+    f->lastIn[0] = x1;
+    f->lastIn[1] = x2;
+}
+
 void    tTwoZero_setNotch(tTwoZero* const ft, float freq, float radius)
 {
     _tTwoZero* f = *ft;
@@ -513,6 +614,7 @@ void   tPoleZero_init(tPoleZero* const pzf, LEAF* const leaf)
 
 void    tPoleZero_initToPool        (tPoleZero* const pzf, tMempool* const mp)
 {
+    LEAF_PROFILE_POOL(mp);
     _tMempool* m = *mp;
     _tPoleZero* f = *pzf = (_tPoleZero*) mpool_alloc(sizeof(_tPoleZero), m);
     f->mempool = m;
@@ -607,6 +709,7 @@ void    tPoleZero_setGain(tPoleZero* const pzf, float gain)
 
 float   tPoleZero_tick(tPoleZero* const pzf, float input)
 {
+    LEAF_PROFILE_OBJECT(pzf);
     _tPoleZero* f = *pzf;
     
     float in = input * f->gain;
@@ -618,6 +721,39 @@ float   tPoleZero_tick(tPoleZero* const pzf, float input)
     return out;
 }
 
+void    tPoleZero_tickBlock(tPoleZero* const pzf, const float* input, float* output, int size)
+{
+    LEAF_PROFILE_OBJECT(pzf);
+    _tPoleZero* f = *pzf;
+    
+    float gain = f->gain;
+    float b0 = f->b0;
+    float b1 = f->b1;
+    float a1 = f->a1;
+    float x1 = f->lastIn;
+    float y1 = f->lastOut;
+    
+    for (int i = 0; i < size; ++i)
+    {
+        float in = input[i] * gain;
+        y1 = (b0 * in) + (b1 * x1) - (a1 * y1);
+        x1 = in;
+        output[i] = y1;
+    }
+    
+    f->lastIn = x1;
+    f->lastOut = y1;
+}
+
+// tBiQuad and tSVF work in leaf_coeff_t, so their trig is done to the same precision
+#if LEAF_COEFF_PRECISION == LEAF_PRECISION_FLOAT64
+#define leaf_coeff_cos cos
+#define leaf_coeff_tan tan
+#else
+#define leaf_coeff_cos cosf
+#define leaf_coeff_tan tanf
+#endif
+
 // ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ BiQuad Filter ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ //
 void    tBiQuad_init(tBiQuad* const ft, LEAF* const leaf)
 {
@@ -626,6 +762,7 @@ void    tBiQuad_init(tBiQuad* const ft, LEAF* const leaf)
 
 void    tBiQuad_initToPool     (tBiQuad* const ft, tMempool* const mp)
 {
+    LEAF_PROFILE_POOL(mp);
     _tMempool* m = *mp;
     _tBiQuad* f = *ft = (_tBiQuad*) mpool_alloc(sizeof(_tBiQuad), m);
     f->mempool = m;
@@ -652,10 +789,11 @@ void    tBiQuad_free   (tBiQuad* const ft)
 
 float   tBiQuad_tick(tBiQuad* const ft, float input)
 {
+    LEAF_PROFILE_OBJECT(ft);
     _tBiQuad* f = *ft;
     
-    float in = input * f->gain;
-    float out = f->b0 * in + f->b1 * f->lastIn[0] + f->b2 * f->lastIn[1];
+    leaf_coeff_t in = input * f->gain;
+    leaf_coeff_t out = f->b0 * in + f->b1 * f->lastIn[0] + f->b2 * f->lastIn[1];
     out -= f->a2 * f->lastOut[1] + f->a1 * f->lastOut[0];
     
     f->lastIn[1] = f->lastIn[0];
@@ -664,7 +802,48 @@ float   tBiQuad_tick(tBiQuad* const ft, float input)
     f->lastOut[1] = f->lastOut[0];
     f->lastOut[0] = out;
     
-    return out;
+    return (float) out;
+}
+
+// Strided so tickBlock and tickView share it. Inlined, tickBlock's strides of 1 are constants.
+static inline void biquad_process(_tBiQuad* const f, const float* input, int inStride, float* output, int outStride, int size)
+{
+    leaf_coeff_t gain = f->gain;
+    leaf_coeff_t b0 = f->b0, b1 = f->b1, b2 = f->b2;
+    leaf_coeff_t a1 = f->a1, a2 = f->a2;
+    leaf_coeff_t x1 = f->lastIn[0], x2 = f->lastIn[1];
+    leaf_coeff_t y1 = f->lastOut[0], y2 = f->lastOut[1];
+    
+    for (int i = 0; i < size; ++i)
+    {
+        leaf_coeff_t in = input[i * inStride] * gain;
+        leaf_coeff_t out = b0 * in + b1 * x1 + b2 * x2;
+        out -= a2 * y2 + a1 * y1;
+        
+        x2 = x1;
+        x1 = in;
+        y2 = y1;
+        y1 = out;
+        
+        output[i * outStride] = (float) out;
+    }
+    
+    f->lastIn[0] = x1;
+    f->lastIn[1] = x2;
+    f->lastOut[0] = y1;
+    f->lastOut[1] = y2;
+}
+
+void    tBiQuad_tickBlock(tBiQuad* const ft, const float* input, float* output, int size)
+{
+    LEAF_PROFILE_OBJECT(ft);
+    biquad_process(*ft, input, 1, output, 1, size);
+}
+
+void    tBiQuad_tickView(tBiQuad* const ft, LEAFBufferView input, LEAFBufferView output)
+{
+    LEAF_PROFILE_OBJECT(ft);
+    biquad_process(*ft, input.data, input.frameStride, output.data, output.frameStride, input.frames);
 }
 
 void    tBiQuad_setResonance(tBiQuad* const ft, float freq, float radius, int normalize)
@@ -681,8 +860,8 @@ void    tBiQuad_setResonance(tBiQuad* const ft, float freq, float radius, int no
     f->radius = radius;
     f->normalize = normalize;
     
-    f->a2 = radius * radius;
-    f->a1 = -2.0f * radius * cosf(freq * f->twoPiTimesInvSampleRate);
+    f->a2 = (leaf_coeff_t) radius * radius;
+    f->a1 = -2.0f * (leaf_coeff_t) radius * leaf_coeff_cos((leaf_coeff_t) freq * f->twoPiTimesInvSampleRate);
     
     if (normalize)
     {
@@ -701,8 +880,8 @@ void    tBiQuad_setNotch(tBiQuad* const ft, float freq, float radius)
         freq = f->sampleRate * 0.49f;
     if (radius < 0.0f)  radius = 0.0f;
     
-    f->b2 = radius * radius;
-    f->b1 = -2.0f * radius * cosf(freq * f->twoPiTimesInvSampleRate); // OPTIMIZE with LOOKUP or APPROXIMATION
+    f->b2 = (leaf_coeff_t) radius * radius;
+    f->b1 = -2.0f * (leaf_coeff_t) radius * leaf_coeff_cos((leaf_coeff_t) freq * f->twoPiTimesInvSampleRate); // OPTIMIZE with LOOKUP or APPROXIMATION
     
     // Does not attempt to normalize filter gain.
 }
@@ -768,8 +947,8 @@ void    tBiQuad_setSampleRate(tBiQuad* const ft, float sr)
     f->sampleRate = sr;
     f->twoPiTimesInvSampleRate = TWO_PI * (1.0f/f->sampleRate);
     
-    f->a2 = f->radius * f->radius;
-    f->a1 = -2.0f * f->radius * cosf(f->frequency * f->twoPiTimesInvSampleRate);
+    f->a2 = (leaf_coeff_t) f->radius * f->radius;
+    f->a1 = -2.0f * (leaf_coeff_t) f->radius * leaf_coeff_cos((leaf_coeff_t) f->frequency * f->twoPiTimesInvSampleRate);
     
     if (f->normalize)
     {
@@ -792,6 +971,7 @@ void tSVF_init(tSVF* const svff, SVFType type, float freq, float Q, LEAF* const
 
 void    tSVF_initToPool     (tSVF* const svff, SVFType type, float freq, float Q, tMempool* const mp)
 {
+    LEAF_PROFILE_POOL(mp);
     _tMempool* m = *mp;
     _tSVF* svf = *svff = (_tSVF*) mpool_alloc(sizeof(_tSVF), m);
     svf->mempool = m;
@@ -807,7 +987,7 @@ void    tSVF_initToPool     (tSVF* const svff, SVFType type, float freq, float Q
     svf->ic2eq = 0;
     svf->Q = Q;
     svf->cutoff = freq;
-    svf->g = tanf(PI * freq * svf->invSampleRate);
+    svf->g = leaf_coeff_tan((leaf_coeff_t) PI * freq * svf->invSampleRate);
     svf->k = 1.0f/Q;
     svf->a1 = 1.0f/(1.0f + svf->g * (svf->g + svf->k));
     svf->a2 = svf->g*svf->a1;
@@ -866,9 +1046,10 @@ void    tSVF_free   (tSVF* const svff)
 
 float   tSVF_tick(tSVF* const svff, float v0)
 {
+    LEAF_PROFILE_OBJECT(svff);
     _tSVF* svf = *svff;
     
-    float v1,v2,v3;
+    leaf_coeff_t v1,v2,v3;
     v3 = v0 - svf->ic2eq;
     v1 = (svf->a1 * svf->ic1eq) + (svf->a2 * v3);
     v2 = svf->ic2eq + (svf->a2 * svf->ic1eq) + (svf->a3 * v3);
@@ -880,7 +1061,99 @@ float   tSVF_tick(tSVF* const svff, float v0)
         return 0.0f;
     }
     
-    return (v0 * svf->cH) + (v1 * svf->cB) + (svf->k * v1 * svf->cBK) + (v2 * svf->cL);
+    return (float) ((v0 * svf->cH) + (v1 * svf->cB) + (svf->k * v1 * svf->cBK) + (v2 * svf->cL));
+}
+
+static inline void svf_process(_tSVF* const svf, const float* input, int inStride, float* output, int outStride, int size)
+{
+    leaf_coeff_t a1 = svf->a1, a2 = svf->a2, a3 = svf->a3, k = svf->k;
+    leaf_coeff_t cH = svf->cH, cB = svf->cB, cBK = svf->cBK, cL = svf->cL;
+    leaf_coeff_t ic1eq = svf->ic1eq, ic2eq = svf->ic2eq;
+    
+    for (int i = 0; i < size; ++i)
+    {
+        float v0 = input[i * inStride];
+        leaf_coeff_t v1,v2,v3;
+        v3 = v0 - ic2eq;
+        v1 = (a1 * ic1eq) + (a2 * v3);
+        v2 = ic2eq + (a2 * ic1eq) + (a3 * v3);
+        ic1eq = (2.0f * v1) - ic1eq;
+        ic2eq = (2.0f * v2) - ic2eq;
+        
+        if (isnan(ic1eq)) output[i * outStride] = 0.0f;
+        else output[i * outStride] = (float) ((v0 * cH) + (v1 * cB) + (k * v1 * cBK) + (v2 * cL));
+    }
+    
+    svf->ic1eq = ic1eq;
+    svf->ic2eq = ic2eq;
+}
+
+void    tSVF_tickBlock(tSVF* const svff, const float* input, float* output, int size)
+{
+    LEAF_PROFILE_OBJECT(svff);
+    svf_process(*svff, input, 1, output, 1, size);
+}
+
+void    tSVF_tickView(tSVF* const svff, LEAFBufferView input, LEAFBufferView output)
+{
+    LEAF_PROFILE_OBJECT(svff);
+    svf_process(*svff, input.data, input.frameStride, output.data, output.frameStride, input.frames);
+}
+
+float   tSVF_tickWithFreq(tSVF* const svff, float v0, float freq)
+{
+    LEAF_PROFILE_OBJECT(svff);
+    _tSVF* svf = *svff;
+    
+    svf->cutoff = LEAF_clip(0.0f, freq, svf->sampleRate * 0.5f);
+    svf->g = fasttanpif(svf->cutoff * svf->invSampleRate);
+    svf->a1 = 1.0f/(1.0f + svf->g * (svf->g + svf->k));
+    svf->a2 = svf->g * svf->a1;
+    svf->a3 = svf->g * svf->a2;
+    
+    return tSVF_tick(svff, v0);
+}
+
+void    tSVF_tickBlockWithFreq(tSVF* const svff, const float* input, const float* freq, float* output, int size)
+{
+    LEAF_PROFILE_OBJECT(svff);
+    _tSVF* svf = *svff;
+    
+    leaf_coeff_t k = svf->k;
+    leaf_coeff_t cH = svf->cH, cB = svf->cB, cBK = svf->cBK, cL = svf->cL;
+    leaf_coeff_t ic1eq = svf->ic1eq, ic2eq = svf->ic2eq;
+    float maxFreq = svf->sampleRate * 0.5f;
+    float invSampleRate = svf->invSampleRate;
+    float cutoff = svf->cutoff;
+    leaf_coeff_t g = svf->g, a1 = svf->a1, a2 = svf->a2, a3 = svf->a3;
+    
+    for (int i = 0; i < size; ++i)
+    {
+        cutoff = LEAF_clip(0.0f, freq[i], maxFreq);
+        g = fasttanpif(cutoff * invSampleRate);
+        a1 = 1.0f/(1.0f + g * (g + k));
+        a2 = g * a1;
+        a3 = g * a2;
+        
+        float v0 = input[i];
+        leaf_coeff_t v1,v2,v3;
+        v3 = v0 - ic2eq;
+        v1 = (a1 * ic1eq) + (a2 * v3);
+        v2 = ic2eq + (a2 * ic1eq) + (a3 * v3);
+        ic1eq = (2.0f * v1) - ic1eq;
+        ic2eq = (2.0f * v2) - ic2eq;
+        
+        if (isnan(ic1eq)) output[i] = 0.0f;
+        else output[i] = (float) ((v0 * cH) + (v1 * cB) + (k * v1 * cBK) + (v2 * cL));
+    }
+    
+    svf->cutoff = cutoff;
+    svf->g = g;
+    svf->a1 = a1;
+    svf->a2 = a2;
+    svf->a3 = a3;
+    svf->ic1eq = ic1eq;
+    svf->ic2eq = ic2eq;
 }
 
 void     tSVF_setFreq(tSVF* const svff, float freq)
@@ -888,7 +1161,7 @@ void     tSVF_setFreq(tSVF* const svff, float freq)
     _tSVF* svf = *svff;
     
     svf->cutoff = LEAF_clip(0.0f, freq, svf->sampleRate * 0.5f);
-    svf->g = tanf(PI * svf->cutoff * svf->invSampleRate);
+    svf->g = leaf_coeff_tan((leaf_coeff_t) PI * svf->cutoff * svf->invSampleRate);
     svf->a1 = 1.0f/(1.0f + svf->g * (svf->g + svf->k));
     svf->a2 = svf->g * svf->a1;
     svf->a3 = svf->g * svf->a2;
@@ -911,7 +1184,7 @@ void    tSVF_setFreqAndQ(tSVF* const svff, float freq, float Q)
     
     svf->cutoff = LEAF_clip(0.0f, freq, svf->sampleRate * 0.5f);
     svf->k = 1.0f/Q;
-    svf->g = tanf(PI * svf->cutoff * svf->invSampleRate);
+    svf->g = leaf_coeff_tan((leaf_coeff_t) PI * svf->cutoff * svf->invSampleRate);
     svf->a1 = 1.0f/(1.0f + svf->g * (svf->g + svf->k));
     svf->a2 = svf->g * svf->a1;
     svf->a3 = svf->g * svf->a2;
@@ -934,6 +1207,7 @@ void   tEfficientSVF_init(tEfficientSVF* const svff, SVFType type, uint16_t inpu
 
 void    tEfficientSVF_initToPool    (tEfficientSVF* const svff, SVFType type, uint16_t input, float Q, tMempool* const mp)
 {
+    LEAF_PROFILE_POOL(mp);
     _tMempool* m = *mp;
     _tEfficientSVF* svf = *svff = (_tEfficientSVF*) mpool_alloc(sizeof(_tEfficientSVF), m);
     svf->mempool = m;
@@ -958,6 +1232,7 @@ void    tEfficientSVF_free (tEfficientSVF* const svff)
 
 float   tEfficientSVF_tick(tEfficientSVF* const svff, float v0)
 {
+    LEAF_PROFILE_OBJECT(svff);
     _tEfficientSVF* svf = *svff;
     
     float v1,v2,v3;
@@ -976,6 +1251,37 @@ float   tEfficientSVF_tick(tEfficientSVF* const svff, float v0)
     
 }
 
+void    tEfficientSVF_tickBlock(tEfficientSVF* const svff, const float* input, float* output, int size)
+{
+    LEAF_PROFILE_OBJECT(svff);
+    _tEfficientSVF* svf = *svff;
+    
+    SVFType type = svf->type;
+    float a1 = svf->a1, a2 = svf->a2, a3 = svf->a3, k = svf->k;
+    float ic1eq = svf->ic1eq, ic2eq = svf->ic2eq;
+    
+    for (int i = 0; i < size; ++i)
+    {
+        float v0 = input[i];
+        float v1,v2,v3;
+        v3 = v0 - ic2eq;
+        v1 = (a1 * ic1eq) + (a2 * v3);
+        v2 = ic2eq + (a2 * ic1eq) + (a3 * v3);
+        ic1eq = (2.0f * v1) - ic1eq;
+        ic2eq = (2.0f * v2) - ic2eq;
+        
+        if (type == SVFTypeLowpass)        output[i] = v2;
+        else if (type == SVFTypeBandpass)  output[i] = v1;
+        else if (type == SVFTypeHighpass)  output[i] = v0 - (k * v1) - v2;
+        else if (type == SVFTypeNotch)     output[i] = v0 - (k * v1);
+        else if (type == SVFTypePeak)      output[i] = v0 - (k * v1) - (2.0f * v2);
+        else                               output[i] = 0.0f;
+    }
+    
+    svf->ic1eq = ic1eq;
+    svf->ic2eq = ic2eq;
+}
+
 void     tEfficientSVF_setFreq(tEfficientSVF* const svff, uint16_t input)
 {
     _tEfficientSVF* svf = *svff;
@@ -1005,6 +1311,7 @@ void tHighpass_init(tHighpass* const ft, float freq, LEAF* const leaf)
 
 void tHighpass_initToPool    (tHighpass* const ft, float freq, tMempool* const mp)
 {
+    LEAF_PROFILE_POOL(mp);
     _tMempool* m = *mp;
     _tHighpass* f = *ft = (_tHighpass*) mpool_calloc(sizeof(_tHighpass), m);
     f->mempool = m;
@@ -1041,12 +1348,34 @@ float tHighpass_getFreq(tHighpass* const ft)
 // From JOS DC Blocker
 float tHighpass_tick(tHighpass* const ft, float x)
 {
+    LEAF_PROFILE_OBJECT(ft);
     _tHighpass* f = *ft;
     f->ys = x - f->xs + f->R * f->ys;
     f->xs = x;
     return f->ys;
 }
 
+void tHighpass_tickBlock(tHighpass* const ft, const float* input, float* output, int size)
+{
+    LEAF_PROFILE_OBJECT(ft);
+    _tHighpass* f = *ft;
+    
+    float R = f->R;
+    float xs = f->xs;
+    float ys = f->ys;
+    
+    for (int i = 0; i < size; ++i)
+    {
+        float x = input[i];
+        ys = x - xs + R * ys;
+        xs = x;
+        output[i] = ys;
+    }
+    
+    f->xs = xs;
+    f->ys = ys;
+}
+
 void tHighpass_setSampleRate(tHighpass* const ft, float sr)
 {
     _tHighpass* f = *ft;
@@ -1061,6 +1390,7 @@ void tButterworth_init(tButterworth* const ft, int order, float f1, float f2, LE
 
 void    tButterworth_initToPool     (tButterworth* const ft, int order, float f1, float f2, tMempool* const mp)
 {
+    LEAF_PROFILE_POOL(mp);
     _tMempool* m = *mp;
     _tButterworth* f = *ft = (_tButterworth*) mpool_alloc(sizeof(_tButterworth), m);
     f->mempool = m;
@@ -1097,6 +1427,7 @@ void    tButterworth_free   (tButterworth* const ft)
 
 float tButterworth_tick(tButterworth* const ft, float samp)
 {
+    LEAF_PROFILE_OBJECT(ft);
     _tButterworth* f = *ft;
     
     for(int i = 0; i < f->numSVF; ++i)
@@ -1105,6 +1436,24 @@ float tButterworth_tick(tButterworth* const ft, float samp)
     return samp;
 }
 
+void tButterworth_tickBlock(tButterworth* const ft, const float* input, float* output, int size)
+{
+    LEAF_PROFILE_OBJECT(ft);
+    _tButterworth* f = *ft;
+    
+    // Each stage only depends on the output of the previous one,
+    // so running the cascade stage by stage gives the same result as per sample
+    if (f->numSVF < 1)
+    {
+        if (output != input) memmove(output, input, sizeof(float) * size);
+        return;
+    }
+    
+    tSVF_tickBlock(&f->svf[0], input, output, size);
+    for (int i = 1; i < f->numSVF; ++i)
+        tSVF_tickBlock(&f->svf[i], output, output, size);
+}
+
 void tButterworth_setF1(tButterworth* const ft, float f1)
 {
     _tButterworth* f = *ft;
@@ -1148,6 +1497,7 @@ void    tFIR_init(tFIR* const firf, float* coeffs, int numTaps, LEAF* const leaf
 
 void    tFIR_initToPool     (tFIR* const firf, float* coeffs, int numTaps, tMempool* const mp)
 {
+    LEAF_PROFILE_POOL(mp);
     _tMempool* m = *mp;
     _tFIR* fir = *firf = (_tFIR*) mpool_alloc(sizeof(_tFIR), m);
     fir->mempool = m;
@@ -1168,6 +1518,7 @@ void    tFIR_free   (tFIR* const firf)
 
 float   tFIR_tick(tFIR* const firf, float input)
 {
+    LEAF_PROFILE_OBJECT(firf);
     _tFIR* fir = *firf;
     
     fir->past[0] = input;
@@ -1177,10 +1528,221 @@ float   tFIR_tick(tFIR* const firf, float input)
     return y;
 }
 
+void    tFIR_tickBlock(tFIR* const firf, const float* input, float* output, int size)
+{
+    LEAF_PROFILE_OBJECT(firf);
+    _tFIR* fir = *firf;
+    
+    float* past = fir->past;
+    const float* coeff = fir->coeff;
+    int numTaps = fir->numTaps;
+    
+    for (int n = 0; n < size; ++n)
+    {
+        past[0] = input[n];
+        float y = 0.0f;
+        for (int i = 0; i < numTaps; ++i) y += past[i]*coeff[i];
+        for (int i = numTaps-1; i > 0; --i) past[i] = past[i-1];
+        output[n] = y;
+    }
+}
+
+//================================================================================
+
+// Uniformly partitioned overlap-save convolution.
+// The impulse response is split into partitions of partitionSize taps and each is stored as a
+// 2 * partitionSize point spectrum. Every partitionSize input samples, the last two partitions of input
+// are transformed into a frequency-domain delay line, and each delayed input spectrum is multiplied with
+// its partition's spectrum and summed. The work for each partition of output is one forward FFT, one
+// inverse FFT and numPartitions spectrum multiplies, and nothing is allocated after initialization.
+
+void    tConvolver_init         (tConvolver* const conv, const float* ir, int irLength, int partitionSize, LEAF* const leaf)
+{
+    tConvolver_initToPool(conv, ir, irLength, partitionSize, &leaf->mempool);
+}
+
+void    tConvolver_initToPool   (tConvolver* const conv, const float* ir, int irLength, int partitionSize, tMempool* const mp)
+{
+    LEAF_PROFILE_POOL(mp);
+    _tMempool* m = *mp;
+    _tConvolver* c = *conv = (_tConvolver*) mpool_alloc(sizeof(_tConvolver), m);
+    c->mempool = m;
+    
+    // The FFT needs a power of two
+    int size = 1;
+    while (size < partitionSize) size <<= 1;
+    if (size < 4) size = 4;
+    if (irLength < 1) irLength = 1;
+    
+    c->partitionSize = size;
+    c->fftSize = size * 2;
+    c->numPartitions = (irLength + size - 1) / size;
+    c->maxLength = c->numPartitions * size;
+    
+    c->irSpectra = (float*) mpool_calloc(sizeof(float) * c->fftSize * c->numPartitions, m);
+    c->fdl = (float*) mpool_calloc(sizeof(float) * c->fftSize * c->numPartitions, m);
+    c->window = (float*) mpool_calloc(sizeof(float) * c->fftSize, m);
+    c->accum = (float*) mpool_calloc(sizeof(float) * c->fftSize, m);
+    c->inbuf = (float*) mpool_calloc(sizeof(float) * c->partitionSize, m);
+    c->outbuf = (float*) mpool_calloc(sizeof(float) * c->partitionSize, m);
+    c->fdlIndex = 0;
+    c->position = 0;
+    tRealFFT_initToPool(&c->fft, c->fftSize, mp);
+    
+    tConvolver_setImpulseResponse(conv, ir, irLength);
+}
+
+void    tConvolver_free         (tConvolver* const conv)
+{
+    _tConvolver* c = *conv;
+    
+    mpool_free((char*)c->outbuf, c->mempool);
+    mpool_free((char*)c->inbuf, c->mempool);
+    mpool_free((char*)c->accum, c->mempool);
+    mpool_free((char*)c->window, c->mempool);
+    mpool_free((char*)c->fdl, c->mempool);
+    mpool_free((char*)c->irSpectra, c->mempool);
+    tRealFFT_free(&c->fft);
+    mpool_free((char*)c, c->mempool);
+}
+
+void    tConvolver_setImpulseResponse (tConvolver* const conv, const float* ir, int irLength)
+{
+    _tConvolver* c = *conv;
+    
+    int B = c->partitionSize;
+    int N = c->fftSize;
+    if (irLength > c->maxLength) irLength = c->maxLength;
+    
+    for (int p = 0; p < c->numPartitions; ++p)
+    {
+        float* h = &c->irSpectra[p * N];
+        for (int i = 0; i < N; ++i) h[i] = 0.0f;
+        for (int i = 0; i < B; ++i)
+        {
+            int k = p * B + i;
+            if (k < irLength && ir != NULL) h[i] = ir[k];
+        }
+        tRealFFT_forward(&c->fft, h);
+    }
+}
+
+static void tConvolver_processPartition(_tConvolver* c)
+{
+    int B = c->partitionSize;
+    int N = c->fftSize;
+    int P = c->numPartitions;
+    
+    // Slide the input window along by one partition and transform it into the delay line
+    float* window = c->window;
+    for (int i = 0; i < B; ++i)
+    {
+        window[i] = window[i + B];
+        window[i + B] = c->inbuf[i];
+    }
+    float* x = &c->fdl[c->fdlIndex * N];
+    for (int i = 0; i < N; ++i) x[i] = window[i];
+    tRealFFT_forward(&c->fft, x);
+    
+    // Multiply and accumulate each delayed input spectrum with its partition of the impulse response
+    float* acc = c->accum;
+    for (int i = 0; i < N; ++i) acc[i] = 0.0f;
+    int slot = c->fdlIndex;
+    for (int p = 0; p < P; ++p)
+    {
+        const float* X = &c->fdl[slot * N];
+        const float* H = &c->irSpectra[p * N];
+        
+        // DC and Nyquist are real and packed into the first two entries
+        acc[0] += X[0] * H[0];
+        acc[1] += X[1] * H[1];
+        for (int k = 2; k < N; k += 2)
+        {
+            float xr = X[k], xi = X[k + 1];
+            float hr = H[k], hi = H[k + 1];
+            acc[k] += xr * hr - xi * hi;
+            acc[k + 1] += xr * hi + xi * hr;
+        }
+        
+        if (--slot < 0) slot = P - 1;
+    }
+    
+    // The second half of the circular convolution is the linear convolution of the new partition
+    tRealFFT_inverse(&c->fft, acc);
+    for (int i = 0; i < B; ++i) c->outbuf[i] = acc[i + B];
+    
+    if (++c->fdlIndex >= P) c->fdlIndex = 0;
+}
+
+float   tConvolver_tick         (tConvolver* const conv, float input)
+{
+    LEAF_PROFILE_OBJECT(conv);
+    _tConvolver* c = *conv;
+    
+    c->inbuf[c->position] = input;
+    float y = c->outbuf[c->position];
+    if (++c->position >= c->partitionSize)
+    {
+        tConvolver_processPartition(c);
+        c->position = 0;
+    }
+    return y;
+}
+
+void    tConvolver_tickBlock    (tConvolver* const conv, const float* input, float* output, int size)
+{
+    LEAF_PROFILE_OBJECT(conv);
+    _tConvolver* c = *conv;
+    
+    int B = c->partitionSize;
+    while (size > 0)
+    {
+        int n = B - c->position;
+        if (n > size) n = size;
+        for (int i = 0; i < n; ++i)
+        {
+            float x = input[i];
+            output[i] = c->outbuf[c->position + i];
+            c->inbuf[c->position + i] = x;
+        }
+        c->position += n;
+        if (c->position >= B)
+        {
+            tConvolver_processPartition(c);
+            c->position = 0;
+        }
+        input += n;
+        output += n;
+        size -= n;
+    }
+}
+
+int     tConvolver_getLatency   (tConvolver* const conv)
+{
+    _tConvolver* c = *conv;
+    return c->partitionSize;
+}
+
+void    tConvolver_clear        (tConvolver* const conv)
+{
+    _tConvolver* c = *conv;
+    
+    for (int i = 0; i < c->fftSize * c->numPartitions; ++i) c->fdl[i] = 0.0f;
+    for (int i = 0; i < c->fftSize; ++i) c->window[i] = 0.0f;
+    for (int i = 0; i < c->partitionSize; ++i)
+    {
+        c->inbuf[i] = 0.0f;
+        c->outbuf[i] = 0.0f;
+    }
+    c->position = 0;
+}
+
 //---------------------------------------------
 ////
-/// Median filter implemented based on James McCartney's median filter in Supercollider,
-/// translated from a Gen~ port of the Supercollider code that I believe was made by Rodrigo Costanzo and which I got from PA Tremblay - JS
+/// Median filter keeping the window in a double heap, after the "mediator" running median: heap[0] is the median,
+/// heap[-1], heap[-2]... is a max heap of the samples below it and heap[1], heap[2]... a min heap of the samples above.
+/// The children of i are 2i and 2i+1 (2i and 2i-1 on the max side) and the only child of the median on each side is 1 or -1.
+/// Each new sample replaces the oldest one in place and moves up or down O(log size) levels.
 
 
 void    tMedianFilter_init           (tMedianFilter* const f, int size, LEAF* const leaf)
@@ -1190,69 +1752,133 @@ void    tMedianFilter_init           (tMedianFilter* const f, int size, LEAF* co
 
 void    tMedianFilter_initToPool     (tMedianFilter* const mf, int size, tMempool* const mp)
 {
+    LEAF_PROFILE_POOL(mp);
     _tMempool* m = *mp;
     _tMedianFilter* f = *mf = (_tMedianFilter*) mpool_alloc(sizeof(_tMedianFilter), m);
     f->mempool = m;
     
+    if (size < 1) size = 1;
     f->size = size;
-    f->middlePosition = size / 2;
-    f->last = size - 1;
-    f->pos = -1;
+    // The median has size / 2 samples below it, so it's the upper middle sample for even sizes
+    f->maxCount = size / 2;
+    f->minCount = (size - 1) / 2;
+    f->pos = 0;
     f->val = (float*) mpool_alloc(sizeof(float) * size, m);
-    f->age = (int*) mpool_alloc(sizeof(int) * size, m);
+    f->heapIndex = (int*) mpool_alloc(sizeof(int) * size, m);
+    f->heapMemory = (int*) mpool_alloc(sizeof(int) * size, m);
+    f->heap = f->heapMemory + f->maxCount;
+    
+    // The window starts full of zeros, so any order is a valid heap
     for (int i = 0; i < f->size; ++i)
     {
         f->val[i] = 0.0f;
-        f->age[i] = i;
+        f->heapIndex[i] = i - f->maxCount;
+        f->heap[i - f->maxCount] = i;
+    }
     }
     
-}
 void    tMedianFilter_free   (tMedianFilter* const mf)
 {
     _tMedianFilter* f = *mf;
     
     mpool_free((char*)f->val, f->mempool);
-    mpool_free((char*)f->age, f->mempool);
+    mpool_free((char*)f->heapIndex, f->mempool);
+    mpool_free((char*)f->heapMemory, f->mempool);
     mpool_free((char*)f, f->mempool);
 }
 
+static inline int tMedianFilter_less(_tMedianFilter* const f, int i, int j)
+{
+    return f->val[f->heap[i]] < f->val[f->heap[j]];
+}
+
+static inline void tMedianFilter_swap(_tMedianFilter* const f, int i, int j)
+{
+    int t = f->heap[i];
+    f->heap[i] = f->heap[j];
+    f->heap[j] = t;
+    f->heapIndex[f->heap[i]] = i;
+    f->heapIndex[f->heap[j]] = j;
+}
+
+// Move the sample at i down the min heap while it is greater than its smaller child
+static inline void tMedianFilter_minDown(_tMedianFilter* const f, int i)
+{
+    while (1)
+    {
+        int c = i == 0 ? 1 : i * 2;
+        if (c > f->minCount) break;
+        if (i != 0 && c < f->minCount && tMedianFilter_less(f, c + 1, c)) ++c;
+        if (!tMedianFilter_less(f, c, i)) break;
+        tMedianFilter_swap(f, c, i);
+        i = c;
+    }
+}
+
+// Move the sample at i down the max heap while it is less than its greater child
+static inline void tMedianFilter_maxDown(_tMedianFilter* const f, int i)
+{
+    while (1)
+    {
+        int c = i == 0 ? -1 : i * 2;
+        if (c < -f->maxCount) break;
+        if (i != 0 && c > -f->maxCount && tMedianFilter_less(f, c, c - 1)) --c;
+        if (!tMedianFilter_less(f, i, c)) break;
+        tMedianFilter_swap(f, c, i);
+        i = c;
+    }
+}
+
+// Move the sample at i up the min heap, returns 1 if it became the median
+static inline int tMedianFilter_minUp(_tMedianFilter* const f, int i)
+{
+    while (i > 0 && tMedianFilter_less(f, i, i / 2))
+    {
+        tMedianFilter_swap(f, i, i / 2);
+        i /= 2;
+    }
+    return i == 0;
+}
+
+// Move the sample at i up the max heap, returns 1 if it became the median
+static inline int tMedianFilter_maxUp(_tMedianFilter* const f, int i)
+{
+    while (i < 0 && tMedianFilter_less(f, i / 2, i))
+    {
+        tMedianFilter_swap(f, i, i / 2);
+        i /= 2;
+    }
+    return i == 0;
+}
+
 float   tMedianFilter_tick           (tMedianFilter* const mf, float input)
 {
+    LEAF_PROFILE_OBJECT(mf);
     _tMedianFilter* f = *mf;
     
-    for(int i=0; i<f->size; i++) {
-        int thisAge = f->age[i];
-        if(thisAge == f->last) {
-            f->pos = i;
+    // The new sample takes the oldest sample's place in the heap and is moved from there
+    int i = f->heapIndex[f->pos];
+    float old = f->val[f->pos];
+    f->val[f->pos] = input;
+    if (++f->pos >= f->size) f->pos = 0;
+    
+    if (i > 0)
+    {
+        if (input > old) tMedianFilter_minDown(f, i);
+        else if (tMedianFilter_minUp(f, i)) tMedianFilter_maxDown(f, 0);
         }
-        else {
-            thisAge++;
-            f->age[i] = thisAge;
+    else if (i < 0)
+    {
+        if (input < old) tMedianFilter_maxDown(f, i);
+        else if (tMedianFilter_maxUp(f, i)) tMedianFilter_minDown(f, 0);
         }
+    else
+    {
+        tMedianFilter_maxDown(f, 0);
+        tMedianFilter_minDown(f, 0);
     }
     
-    while( f->pos!=0 ) {
-        float test = f->val[f->pos-1];
-        if(input < test) {
-            f->val[f->pos]=test;
-            f->age[f->pos]=f->age[f->pos-1];
-            f->pos -= 1;
-        } else {break;}
-    }
-    
-    while(f->pos != f->last) {
-        float test = f->val[f->pos+1];
-        if( input > test) {
-            f->val[f->pos] = test;
-            f->age[f->pos] = f->age[f->pos+1];
-            f->pos += 1;
-        } else {break;}
-    }
-    
-    f->val[f->pos] = input;
-    f->age[f->pos] = 0;
-    
-    return  f->val[f->middlePosition];
+    return f->val[f->heap[0]];
 }
 
 /////
@@ -1264,6 +1890,7 @@ void    tVZFilter_init  (tVZFilter* const vf, VZFilterType type, float freq, flo
 
 void    tVZFilter_initToPool     (tVZFilter* const vf, VZFilterType type, float freq, float bandWidth, tMempool* const mp)
 {
+    LEAF_PROFILE_POOL(mp);
     _tMempool* m = *mp;
     _tVZFilter* f = *vf = (_tVZFilter*) mpool_alloc(sizeof(_tVZFilter), m);
     f->mempool = m;
@@ -1292,6 +1919,7 @@ void    tVZFilter_free   (tVZFilter* const vf)
 
 float   tVZFilter_tick              (tVZFilter* const vf, float in)
 {
+    LEAF_PROFILE_OBJECT(vf);
     _tVZFilter* f = *vf;
     
     float yL, yB, yH;
@@ -1322,6 +1950,7 @@ float   tVZFilter_tick              (tVZFilter* const vf, float in)
 
 float   tVZFilter_tickEfficient             (tVZFilter* const vf, float in)
 {
+    LEAF_PROFILE_OBJECT(vf);
     _tVZFilter* f = *vf;
     
     float yL, yB, yH;
@@ -1350,6 +1979,62 @@ float   tVZFilter_tickEfficient             (tVZFilter* const vf, float in)
     return f->cL*yL + f->cB*yB + f->cH*yH;
 }
 
+void    tVZFilter_tickBlock         (tVZFilter* const vf, const float* input, float* output, int size)
+{
+    LEAF_PROFILE_OBJECT(vf);
+    _tVZFilter* f = *vf;
+    
+    float g = f->g, R2 = f->R2, h = f->h;
+    float cL = f->cL, cB = f->cB, cH = f->cH;
+    float s1 = f->s1, s2 = f->s2;
+    
+    for (int i = 0; i < size; ++i)
+    {
+        float yL, yB, yH;
+        
+        yH = (input[i] - R2*s1 - g*s1 - s2) * h;
+        
+        yB = tanhf(g*yH) + s1;
+        s1 = g*yH + yB;
+        
+        yL = tanhf(g*yB) + s2;
+        s2 = g*yB + yL;
+        
+        output[i] = cL*yL + cB*yB + cH*yH;
+    }
+    
+    f->s1 = s1;
+    f->s2 = s2;
+}
+
+void    tVZFilter_tickEfficientBlock(tVZFilter* const vf, const float* input, float* output, int size)
+{
+    LEAF_PROFILE_OBJECT(vf);
+    _tVZFilter* f = *vf;
+    
+    float g = f->g, R2 = f->R2, h = f->h;
+    float cL = f->cL, cB = f->cB, cH = f->cH;
+    float s1 = f->s1, s2 = f->s2;
+    
+    for (int i = 0; i < size; ++i)
+    {
+        float yL, yB, yH;
+        
+        yH = (input[i] - R2*s1 - g*s1 - s2) * h;
+        
+        yB = (g*yH) + s1;
+        s1 = g*yH + yB;
+        
+        yL = (g*yB) + s2;
+        s2 = g*yB + yL;
+        
+        output[i] = cL*yL + cB*yB + cH*yH;
+    }
+    
+    f->s1 = s1;
+    f->s2 = s2;
+}
+
 void   tVZFilter_calcCoeffs           (tVZFilter* const vf)
 {
     _tVZFilter* f = *vf;
@@ -1555,6 +2240,7 @@ void    tDiodeFilter_init           (tDiodeFilter* const vf, float cutoff, float
 
 void    tDiodeFilter_initToPool     (tDiodeFilter* const vf, float cutoff, float resonance, tMempool* const mp)
 {
+    LEAF_PROFILE_POOL(mp);
     _tMempool* m = *mp;
     _tDiodeFilter* f = *vf = (_tDiodeFilter*) mpool_alloc(sizeof(_tDiodeFilter), m);
     f->mempool = m;
@@ -1602,6 +2288,7 @@ float tanhXdX(float x)
 
 float   tDiodeFilter_tick               (tDiodeFilter* const vf, float in)
 {
+    LEAF_PROFILE_OBJECT(vf);
     _tDiodeFilter* f = *vf;
     
     int errorCheck = 0;
@@ -1673,6 +2360,57 @@ float   tDiodeFilter_tick               (tDiodeFilter* const vf, float in)
     return y3*f->r;
 }
 
+void    tDiodeFilter_tickBlock          (tDiodeFilter* const vf, const float* input, float* output, int size)
+{
+    LEAF_PROFILE_OBJECT(vf);
+    _tDiodeFilter* f = *vf;
+    
+    float ff = f->f, r = f->r;
+    float g0inv = f->g0inv, g1inv = f->g1inv, g2inv = f->g2inv;
+    float s0 = f->s0, s1 = f->s1, s2 = f->s2, s3 = f->s3;
+    float zi = f->zi;
+    
+    for (int i = 0; i < size; ++i)
+    {
+        float in = input[i];
+        float ih = 0.5f * (in + zi);
+        
+        float t0 = ff*tanhXdX((ih - r * s3)*g0inv)*g0inv;
+        float t1 = ff*tanhXdX((s1-s0)*g1inv)*g1inv;
+        float t2 = ff*tanhXdX((s2-s1)*g1inv)*g1inv;
+        float t3 = ff*tanhXdX((s3-s2)*g1inv)*g1inv;
+        float t4 = ff*tanhXdX((s3)*g2inv)*g2inv;
+        
+        float y3 = (s2 + s3 + t2*(s1 + s2 + s3 + t1*(s0 + s1 + s2 + s3 + t0*in)) + t1*(2.0f*s2 + 2.0f*s3))*t3 + s3 + 2.0f*s3*t1 + t2*(2.0f*s3 + 3.0f*s3*t1);
+        float tempy3denom = (t4 + t1*(2.0f*t4 + 4.0f) + t2*(t4 + t1*(t4 + r*t0 + 4.0f) + 3.0f) + 2.0f)*t3 + t4 + t1*(2.0f*t4 + 2.0f) + t2*(2.0f*t4 + t1*(3.0f*t4 + 3.0f) + 2.0f) + 1.0f;
+        if (tempy3denom == 0.0f) tempy3denom = 0.000001f;
+        y3 = y3 / tempy3denom;
+        
+        if (t1 == 0.0f) t1 = 0.000001f;
+        if (t2 == 0.0f) t2 = 0.000001f;
+        if (t3 == 0.0f) t3 = 0.000001f;
+        
+        float y2 = (s3 - (1+t4+t3)*y3) / (-t3);
+        float y1 = (s2 - (1+t3+t2)*y2 + t3*y3) / (-t2);
+        float y0 = (s1 - (1+t2+t1)*y1 + t2*y2) / (-t1);
+        float xx = (in - r*y3);
+        
+        s0 += 2.0f * (t0*xx + t1*(y1-y0));
+        s1 += 2.0f * (t2*(y2-y1) - t1*(y1-y0));
+        s2 += 2.0f * (t3*(y3-y2) - t2*(y2-y1));
+        s3 += 2.0f * (-t4*(y3) - t3*(y3-y2));
+        
+        zi = in;
+        output[i] = y3*r;
+    }
+    
+    f->s0 = s0;
+    f->s1 = s1;
+    f->s2 = s2;
+    f->s3 = s3;
+    f->zi = zi;
+}
+
 void    tDiodeFilter_setFreq     (tDiodeFilter* const vf, float cutoff)
 {
     _tDiodeFilter* f = *vf;
@@ -1681,6 +2419,14 @@ void    tDiodeFilter_setFreq     (tDiodeFilter* const vf, float cutoff)
     f->f = tanf(PI * f->cutoff * f->invSampleRate);
 }
 
+void    tDiodeFilter_setFreqFast     (tDiodeFilter* const vf, float cutoff)
+{
+    _tDiodeFilter* f = *vf;
+    
+    f->cutoff = LEAF_clip(10.0f, cutoff, 20000.0f);
+    f->f = fasttanpif(f->cutoff * f->invSampleRate);
+}
+
 void    tDiodeFilter_setQ     (tDiodeFilter* const vf, float resonance)
 {
     _tDiodeFilter* f = *vf;
@@ -0,0 +1,385 @@
+/*==============================================================================
+
+ leaf-graph.c
+ 
+ ==============================================================================*/
+
+#if _WIN32 || _WIN64
+
+#include "..\Inc\leaf-graph.h"
+
+#else
+
+#include "../Inc/leaf-graph.h"
+
+#endif
+
+//==============================================================================
+// Graph
+//==============================================================================
+
+// The buffer table holds the silent block, then the graph's inputs, then the pooled blocks. Inputs are
+// at most every node, and pooled blocks at most every output port, so it's sized for that at init.
+#define GRAPH_SILENCE 0
+
+void    tGraph_init             (tGraph* const graph, int maxNodes, int maxBlockSize, LEAF* const leaf)
+{
+    tGraph_initToPool(graph, maxNodes, maxBlockSize, &leaf->mempool);
+}
+
+void    tGraph_initToPool       (tGraph* const graph, int maxNodes, int maxBlockSize, tMempool* const mp)
+{
+    _tMempool* m = *mp;
+    _tGraph* g = *graph = (_tGraph*) mpool_alloc(sizeof(_tGraph), m);
+    g->mempool = m;
+    
+    int tableSize = 1 + maxNodes + maxNodes * LEAF_GRAPH_MAX_PORTS;
+    g->nodes = (tGraphNode*) mpool_calloc(sizeof(tGraphNode) * maxNodes, m);
+    g->order = (int*) mpool_alloc(sizeof(int) * maxNodes, m);
+    g->scratch = (int*) mpool_alloc(sizeof(int) * (maxNodes + 2 * tableSize), m);
+    g->buffers = (float**) mpool_calloc(sizeof(float*) * tableSize, m);
+    g->arena = NULL;
+    
+    g->maxNodes = maxNodes;
+    g->maxBlockSize = maxBlockSize;
+    g->numNodes = 0;
+    g->numInputs = 0;
+    g->numOutputs = 0;
+    g->numBuffers = 0;
+    g->compiled = 0;
+}
+
+void    tGraph_free             (tGraph* const graph)
+{
+    _tGraph* g = *graph;
+    
+    if (g->arena != NULL) mpool_free((char*) g->arena, g->mempool);
+    mpool_free((char*) g->buffers, g->mempool);
+    mpool_free((char*) g->scratch, g->mempool);
+    mpool_free((char*) g->order, g->mempool);
+    mpool_free((char*) g->nodes, g->mempool);
+    mpool_free((char*) g, g->mempool);
+}
+
+static int graph_newNode(_tGraph* const g, int type, int numInputs, int numOutputs)
+{
+    if (g->numNodes >= g->maxNodes) return -1;
+    if (numInputs < 0 || numInputs > LEAF_GRAPH_MAX_PORTS) return -1;
+    if (numOutputs < 0 || numOutputs > LEAF_GRAPH_MAX_PORTS) return -1;
+    
+    int index = g->numNodes++;
+    tGraphNode* n = &g->nodes[index];
+    n->object = NULL;
+    n->process = NULL;
+    n->type = type;
+    n->io = 0;
+    n->numInputs = numInputs;
+    n->numOutputs = numOutputs;
+    n->inPlace = 0;
+    for (int p = 0; p < LEAF_GRAPH_MAX_PORTS; p++)
+    {
+        n->source[p] = -1;
+        n->sourcePort[p] = 0;
+        n->inBuffer[p] = GRAPH_SILENCE;
+        n->outBuffer[p] = GRAPH_SILENCE;
+    }
+    g->compiled = 0;
+    return index;
+}
+
+int     tGraph_addNode          (tGraph* const graph, void* object, tGraphProcessCallback process, int numInputs, int numOutputs, int inPlace)
+{
+    _tGraph* g = *graph;
+    
+    int index = graph_newNode(g, GraphNodeObject, numInputs, numOutputs);
+    if (index < 0) return -1;
+    g->nodes[index].object = object;
+    g->nodes[index].process = process;
+    g->nodes[index].inPlace = inPlace;
+    return index;
+}
+
+int     tGraph_addInput         (tGraph* const graph)
+{
+    _tGraph* g = *graph;
+    
+    int index = graph_newNode(g, GraphNodeInput, 0, 1);
+    if (index < 0) return -1;
+    g->nodes[index].io = g->numInputs++;
+    return index;
+}
+
+int     tGraph_addOutput        (tGraph* const graph)
+{
+    _tGraph* g = *graph;
+    
+    int index = graph_newNode(g, GraphNodeOutput, 1, 0);
+    if (index < 0) return -1;
+    g->nodes[index].io = g->numOutputs++;
+    return index;
+}
+
+// Block adapters. The object is a pointer to the handle the caller initialized.
+
+static void graph_sum(void* object, float** inputs, float** outputs, int size)
+{
+    tGraphNode* n = (tGraphNode*) object;
+    
+    // Read every input before writing, so the output can share a buffer with any of them
+    for (int i = 0; i < size; i++)
+    {
+        float sum = 0.0f;
+        for (int p = 0; p < n->numInputs; p++) sum += inputs[p][i];
+        outputs[0][i] = sum;
+    }
+}
+
+int     tGraph_addSum           (tGraph* const graph, int numInputs)
+{
+    _tGraph* g = *graph;
+    
+    int index = graph_newNode(g, GraphNodeObject, numInputs, 1);
+    if (index < 0) return -1;
+    g->nodes[index].object = &g->nodes[index];
+    g->nodes[index].process = &graph_sum;
+    g->nodes[index].inPlace = 1;
+    return index;
+}
+
+#if LEAF_INCLUDE_SINE_TABLE
+static void graph_cycle(void* object, float** inputs, float** outputs, int size)
+{
+    (void) inputs;
+    tCycle_tickBlock((tCycle*) object, outputs[0], size);
+}
+
+int     tGraph_addCycle         (tGraph* const graph, tCycle* const osc)
+{
+    return tGraph_addNode(graph, osc, &graph_cycle, 0, 1, 1);
+}
+#endif
+
+static void graph_biquad(void* object, float** inputs, float** outputs, int size)
+{
+    tBiQuad_tickBlock((tBiQuad*) object, inputs[0], outputs[0], size);
+}
+
+int     tGraph_addBiQuad        (tGraph* const graph, tBiQuad* const filter)
+{
+    return tGraph_addNode(graph, filter, &graph_biquad, 1, 1, 1);
+}
+
+static void graph_svf(void* object, float** inputs, float** outputs, int size)
+{
+    tSVF_tickBlock((tSVF*) object, inputs[0], outputs[0], size);
+}
+
+int     tGraph_addSVF           (tGraph* const graph, tSVF* const filter)
+{
+    return tGraph_addNode(graph, filter, &graph_svf, 1, 1, 1);
+}
+
+static void graph_compressor(void* object, float** inputs, float** outputs, int size)
+{
+    tCompressor_tickBlock((tCompressor*) object, inputs[0], outputs[0], size);
+}
+
+int     tGraph_addCompressor    (tGraph* const graph, tCompressor* const compressor)
+{
+    return tGraph_addNode(graph, compressor, &graph_compressor, 1, 1, 1);
+}
+
+// Both reverbs read each input sample before writing either output at it, so either output can share
+// the input's buffer
+static void graph_dattorro(void* object, float** inputs, float** outputs, int size)
+{
+    tDattorroReverb_tickStereoBlock((tDattorroReverb*) object, inputs[0], outputs, size);
+}
+
+int     tGraph_addDattorroReverb (tGraph* const graph, tDattorroReverb* const reverb)
+{
+    return tGraph_addNode(graph, reverb, &graph_dattorro, 1, 2, 1);
+}
+
+static void graph_fdn(void* object, float** inputs, float** outputs, int size)
+{
+    tFDNReverb_tickStereoBlock((tFDNReverb*) object, inputs[0], outputs, size);
+}
+
+int     tGraph_addFDNReverb     (tGraph* const graph, tFDNReverb* const reverb)
+{
+    return tGraph_addNode(graph, reverb, &graph_fdn, 1, 2, 1);
+}
+
+int     tGraph_connect          (tGraph* const graph, int source, int sourcePort, int dest, int destPort)
+{
+    _tGraph* g = *graph;
+    
+    if (source < 0 || source >= g->numNodes || dest < 0 || dest >= g->numNodes) return 0;
+    if (sourcePort < 0 || sourcePort >= g->nodes[source].numOutputs) return 0;
+    if (destPort < 0 || destPort >= g->nodes[dest].numInputs) return 0;
+    
+    g->nodes[dest].source[destPort] = source;
+    g->nodes[dest].sourcePort[destPort] = sourcePort;
+    g->compiled = 0;
+    return 1;
+}
+
+void    tGraph_disconnect       (tGraph* const graph, int dest, int destPort)
+{
+    _tGraph* g = *graph;
+    
+    if (dest < 0 || dest >= g->numNodes) return;
+    if (destPort < 0 || destPort >= g->nodes[dest].numInputs) return;
+    
+    g->nodes[dest].source[destPort] = -1;
+    g->compiled = 0;
+}
+
+// Takes a reader off a buffer, and returns a pooled buffer to the free stack once nothing else reads it
+static inline void graph_release(_tGraph* const g, int buffer, int* remaining, int* freeList, int* numFree)
+{
+    if (buffer <= g->numInputs) return;
+    if (--remaining[buffer] == 0) freeList[(*numFree)++] = buffer;
+}
+
+int     tGraph_compile          (tGraph* const graph)
+{
+    _tGraph* g = *graph;
+    
+    int N = g->numNodes;
+    int tableSize = 1 + g->maxNodes + g->maxNodes * LEAF_GRAPH_MAX_PORTS;
+    int* pending = g->scratch;
+    int* remaining = g->scratch + g->maxNodes;
+    int* freeList = remaining + tableSize;
+    
+    g->compiled = 0;
+    
+    // Kahn's algorithm, with the order array as the queue. Each connected input is one pending edge.
+    int count = 0;
+    for (int v = 0; v < N; v++)
+    {
+        pending[v] = 0;
+        for (int p = 0; p < g->nodes[v].numInputs; p++)
+            if (g->nodes[v].source[p] >= 0) pending[v]++;
+        if (pending[v] == 0) g->order[count++] = v;
+    }
+    for (int head = 0; head < count; head++)
+    {
+        int u = g->order[head];
+        for (int v = 0; v < N; v++)
+        {
+            if (pending[v] == 0) continue;
+            for (int p = 0; p < g->nodes[v].numInputs; p++)
+            {
+                if (g->nodes[v].source[p] == u && --pending[v] == 0) g->order[count++] = v;
+            }
+        }
+    }
+    if (count < N) return 0;
+    
+    // Assign buffers in running order. A node's inputs are released once it has run, or before its
+    // outputs are assigned if it can run in place, so outputs can take over their inputs' buffers.
+    int numFree = 0;
+    int numBuffers = 0;
+    for (int i = 0; i < N; i++)
+    {
+        tGraphNode* n = &g->nodes[g->order[i]];
+        
+        for (int p = 0; p < n->numInputs; p++)
+        {
+            n->inBuffer[p] = n->source[p] >= 0 ? g->nodes[n->source[p]].outBuffer[n->sourcePort[p]] : GRAPH_SILENCE;
+        }
+        
+        if (n->inPlace)
+            for (int p = 0; p < n->numInputs; p++) graph_release(g, n->inBuffer[p], remaining, freeList, &numFree);
+        
+        for (int p = 0; p < n->numOutputs; p++)
+        {
+            int readers = 0;
+            for (int v = 0; v < N; v++)
+            {
+                for (int q = 0; q < g->nodes[v].numInputs; q++)
+                    if (g->nodes[v].source[q] == g->order[i] && g->nodes[v].sourcePort[q] == p) readers++;
+            }
+            
+            int buffer;
+            if (n->type == GraphNodeInput) buffer = 1 + n->io;
+            else if (numFree > 0) buffer = freeList[--numFree];
+            else buffer = 1 + g->numInputs + numBuffers++;
+            
+            n->outBuffer[p] = buffer;
+            remaining[buffer] = readers;
+        }
+        
+        // Outputs nothing reads are free again straight away
+        for (int p = 0; p < n->numOutputs; p++)
+        {
+            int buffer = n->outBuffer[p];
+            if (buffer > g->numInputs && remaining[buffer] == 0) freeList[numFree++] = buffer;
+        }
+        
+        // Outputs are copied out after everything else has run, in case they're the same memory as an
+        // input, so what they read is never released
+        if (!n->inPlace && n->type != GraphNodeOutput)
+            for (int p = 0; p < n->numInputs; p++) graph_release(g, n->inBuffer[p], remaining, freeList, &numFree);
+    }
+    
+    // One arena for the silent block and the pooled blocks
+    if (g->arena != NULL) mpool_free((char*) g->arena, g->mempool);
+    g->arena = (float*) mpool_calloc(sizeof(float) * g->maxBlockSize * (1 + numBuffers), g->mempool);
+    g->buffers[GRAPH_SILENCE] = g->arena;
+    for (int b = 0; b < numBuffers; b++)
+        g->buffers[1 + g->numInputs + b] = g->arena + g->maxBlockSize * (1 + b);
+    g->numBuffers = numBuffers;
+    
+    g->compiled = 1;
+    return 1;
+}
+
+int     tGraph_getNumBuffers    (tGraph* const graph)
+{
+    _tGraph* g = *graph;
+    return g->numBuffers;
+}
+
+void    tGraph_process          (tGraph* const graph, float** inputs, float** outputs, int size)
+{
+    _tGraph* g = *graph;
+    
+    if (!g->compiled)
+    {
+        for (int o = 0; o < g->numOutputs; o++)
+            for (int i = 0; i < size; i++) outputs[o][i] = 0.0f;
+        return;
+    }
+    
+    float* in[LEAF_GRAPH_MAX_PORTS];
+    float* out[LEAF_GRAPH_MAX_PORTS];
+    
+    for (int offset = 0; offset < size; offset += g->maxBlockSize)
+    {
+        int n = size - offset < g->maxBlockSize ? size - offset : g->maxBlockSize;
+        
+        for (int i = 0; i < g->numInputs; i++) g->buffers[1 + i] = inputs[i] + offset;
+        
+        for (int i = 0; i < g->numNodes; i++)
+        {
+            tGraphNode* node = &g->nodes[g->order[i]];
+            
+            if (node->type == GraphNodeObject)
+            {
+                for (int p = 0; p < node->numInputs; p++) in[p] = g->buffers[node->inBuffer[p]];
+                for (int p = 0; p < node->numOutputs; p++) out[p] = g->buffers[node->outBuffer[p]];
+                node->process(node->object, in, out, n);
+            }
+        }
+        
+        for (int i = 0; i < g->numNodes; i++)
+        {
+            tGraphNode* node = &g->nodes[i];
+            if (node->type == GraphNodeOutput)
+                memmove(outputs[node->io] + offset, g->buffers[node->inBuffer[0]], sizeof(float) * n);
+        }
+    }
+}
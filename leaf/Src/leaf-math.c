@@ -17,6 +17,19 @@
 
 #endif
 
+#if LEAF_USE_SIMD
+#if defined(__ARM_FEATURE_MVE) && (__ARM_FEATURE_MVE & 2)
+#include <arm_mve.h>
+#define LEAF_SIMD_HELIUM 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define LEAF_SIMD_NEON 1
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define LEAF_SIMD_SSE2 1
+#endif
+#endif
+
 
 #define EXPONENTIAL_TABLE_SIZE 65536
 
@@ -131,6 +144,24 @@ float fastertanf(float fAngle)
     return fResult;
 }
 
+// tan(PI * x) for x in [0, 0.5), i.e. the prewarped cutoff tan(PI * fc / fs) used by the SVF style filters.
+// The half above PI/4 is folded with tan(w) = 1 / tan(PI/2 - w) so a [5/4] Pade approximant only has to
+// cover [0, PI/4]. Max relative error is below 3e-7 over the whole range, i.e. float precision.
+// The input is clamped just below 0.5 so the result stays finite.
+float fasttanpif(float x)
+{
+    if (x < 0.0f) x = 0.0f;
+    else if (x > 0.4999f) x = 0.4999f;
+
+    int flip = x > 0.25f;
+    float y = PI * (flip ? 0.5f - x : x);
+    float y2 = y * y;
+    float p = y * (945.0f + y2 * (y2 - 105.0f));
+    float q = 945.0f + y2 * (15.0f * y2 - 420.0f);
+
+    return flip ? q / p : p / q;
+}
+
 // from Heng Li, a combination of inverse square root (see wiki) and inversion: https://bits.stephan-brumme.com/inverse.html
 float fastsqrtf(float x)
 {
@@ -814,12 +845,20 @@ int popcount(unsigned int x)
 //    for (; x != 0; x &= x - 1)
 //        c++;
 //    return c;
-    unsigned long long y;
-    y = x * 0x0002000400080010ULL;
-    y = y & 0x1111111111111111ULL;
-    y = y * 0x1111111111111111ULL;
-    y = y >> 60;
-    return (int) y;
+    // The multiply trick this used only counts the low 15 bits, so count in parallel instead
+    uint32_t y = x;
+    y = y - ((y >> 1) & 0x55555555U);
+    y = (y & 0x33333333U) + ((y >> 2) & 0x33333333U);
+    y = (y + (y >> 4)) & 0x0f0f0f0fU;
+    return (int) ((y * 0x01010101U) >> 24);
+}
+
+int popcount64(uint64_t x)
+{
+    x = x - ((x >> 1) & 0x5555555555555555ULL);
+    x = (x & 0x3333333333333333ULL) + ((x >> 2) & 0x3333333333333333ULL);
+    x = (x + (x >> 4)) & 0x0f0f0f0f0f0f0f0fULL;
+    return (int) ((x * 0x0101010101010101ULL) >> 56);
 }
 
 float median3f(float a, float b, float c)
@@ -873,3 +912,299 @@ void place_slope_dd(float *buffer, int index, float phase, float w, float slope_
     }
 }
 #endif // LEAF_INCLUDE_MINBLEP_TABLES
+
+void LEAF_controlRateInit(LEAFControlRate* const control, int divider, float value)
+{
+    control->divider = divider > 0 ? divider : 1;
+    control->scale = 1;
+    control->count = 0;
+    control->value = value;
+    control->target = value;
+    control->inc = 0.0f;
+}
+
+void LEAF_controlRateSetTarget(LEAFControlRate* const control, float target)
+{
+    control->target = target;
+    control->inc = (target - control->value) / (float) control->divider;
+    control->count = control->divider;
+}
+
+// Write up to size samples of the current ramp, landing exactly on the target at its end
+int LEAF_controlRateFill(LEAFControlRate* const control, float* output, int size)
+{
+    int n = control->count < size ? control->count : size;
+    float value = control->value;
+    float inc = control->inc;
+    for (int i = 0; i < n; ++i)
+    {
+        value += inc;
+        output[i] = value;
+    }
+    control->count -= n;
+    if (control->count == 0 && n > 0)
+    {
+        value = control->target;
+        output[n - 1] = value;
+    }
+    control->value = value;
+    return n;
+}
+
+void LEAF_quiescenceInit(LEAFQuiescence* const q, float threshold, int holdSamples)
+{
+    q->threshold = threshold > 0.0f ? threshold : 0.0f;
+    q->holdSamples = holdSamples > 0 ? holdSamples : 0;
+    q->quietSamples = 0;
+    q->lastLoud = -1;
+}
+
+// Start a block by hearing its input, which may be NULL for none. Returns 1 if the object is quiescent
+// and the input is quiet, in which case the object writes zeros and skips the rest of the block.
+int LEAF_quiescenceBegin(LEAFQuiescence* const q, const float* input, int stride, int size)
+{
+    if (q->threshold <= 0.0f) return 0;
+    
+    q->lastLoud = -1;
+    if (input != NULL) LEAF_quiescenceHear(q, input, stride, size);
+    if (q->lastLoud < 0 && q->quietSamples >= q->holdSamples) return 1;
+    return 0;
+}
+
+// Hear input or output of the current block. Only samples after the last loud one so far need checking.
+void LEAF_quiescenceHear(LEAFQuiescence* const q, const float* x, int stride, int size)
+{
+    if (q->threshold <= 0.0f) return;
+    
+    for (int i = size - 1; i > q->lastLoud; --i)
+    {
+        if (fabsf(x[i * stride]) >= q->threshold)
+        {
+            q->lastLoud = i;
+            break;
+        }
+    }
+}
+
+void LEAF_quiescenceEnd(LEAFQuiescence* const q, int size)
+{
+    if (q->threshold <= 0.0f) return;
+    
+    int quiet = q->lastLoud < 0 ? q->quietSamples + size : size - 1 - q->lastLoud;
+    q->quietSamples = quiet < q->holdSamples ? quiet : q->holdSamples;
+}
+
+void LEAF_quiescenceWake(LEAFQuiescence* const q)
+{
+    q->quietSamples = 0;
+}
+
+int LEAF_quiescenceIsQuiet(LEAFQuiescence* const q)
+{
+    return q->threshold > 0.0f && q->quietSamples >= q->holdSamples;
+}
+
+//==============================================================================
+// Block math
+//==============================================================================
+
+// 2^x splits x into an integer part, which goes straight into the exponent bits, and a fraction in [0, 1)
+// for the polynomial of fastexp2f. Adding 4096 before truncating makes the truncation a floor.
+static inline float leaf_exp2(float x)
+{
+    union {float f; int32_t i;} b;
+    if (x < -126.0f) x = -126.0f;
+    else if (x > 126.0f) x = 126.0f;
+    b.i = (int32_t)(x + 4096.0f) - 4096;
+    x -= (float)b.i;
+    float acc = 1.0f + 0.69303212081966f * x;
+    float xp = x * x;
+    acc += 0.24137976293709f * xp;
+    xp *= x;
+    acc += 0.05203236900844f * xp;
+    xp *= x;
+    acc += 0.01355574723481f * xp;
+    b.i = (b.i + 127) << 23;
+    return acc * b.f;
+}
+
+#if LEAF_SIMD_SSE2
+static inline __m128 leaf_exp2_simd(__m128 x)
+{
+    x = _mm_min_ps(_mm_max_ps(x, _mm_set1_ps(-126.0f)), _mm_set1_ps(126.0f));
+    __m128i xi = _mm_sub_epi32(_mm_cvttps_epi32(_mm_add_ps(x, _mm_set1_ps(4096.0f))), _mm_set1_epi32(4096));
+    x = _mm_sub_ps(x, _mm_cvtepi32_ps(xi));
+    __m128 acc = _mm_add_ps(_mm_set1_ps(1.0f), _mm_mul_ps(_mm_set1_ps(0.69303212081966f), x));
+    __m128 xp = _mm_mul_ps(x, x);
+    acc = _mm_add_ps(acc, _mm_mul_ps(_mm_set1_ps(0.24137976293709f), xp));
+    xp = _mm_mul_ps(xp, x);
+    acc = _mm_add_ps(acc, _mm_mul_ps(_mm_set1_ps(0.05203236900844f), xp));
+    xp = _mm_mul_ps(xp, x);
+    acc = _mm_add_ps(acc, _mm_mul_ps(_mm_set1_ps(0.01355574723481f), xp));
+    return _mm_mul_ps(acc, _mm_castsi128_ps(_mm_slli_epi32(_mm_add_epi32(xi, _mm_set1_epi32(127)), 23)));
+}
+#elif LEAF_SIMD_NEON || LEAF_SIMD_HELIUM
+// NEON and Helium share intrinsic names for everything here but min and max
+#if LEAF_SIMD_HELIUM
+#define leaf_vminq_f32 vminnmq_f32
+#define leaf_vmaxq_f32 vmaxnmq_f32
+#else
+#define leaf_vminq_f32 vminq_f32
+#define leaf_vmaxq_f32 vmaxq_f32
+#endif
+static inline float32x4_t leaf_exp2_simd(float32x4_t x)
+{
+    x = leaf_vminq_f32(leaf_vmaxq_f32(x, vdupq_n_f32(-126.0f)), vdupq_n_f32(126.0f));
+    int32x4_t xi = vsubq_s32(vcvtq_s32_f32(vaddq_f32(x, vdupq_n_f32(4096.0f))), vdupq_n_s32(4096));
+    x = vsubq_f32(x, vcvtq_f32_s32(xi));
+    float32x4_t acc = vaddq_f32(vdupq_n_f32(1.0f), vmulq_f32(vdupq_n_f32(0.69303212081966f), x));
+    float32x4_t xp = vmulq_f32(x, x);
+    acc = vaddq_f32(acc, vmulq_f32(vdupq_n_f32(0.24137976293709f), xp));
+    xp = vmulq_f32(xp, x);
+    acc = vaddq_f32(acc, vmulq_f32(vdupq_n_f32(0.05203236900844f), xp));
+    xp = vmulq_f32(xp, x);
+    acc = vaddq_f32(acc, vmulq_f32(vdupq_n_f32(0.01355574723481f), xp));
+    return vmulq_f32(acc, vreinterpretq_f32_s32(vshlq_n_s32(vaddq_s32(xi, vdupq_n_s32(127)), 23)));
+}
+
+// 1 / d for d in [27, 108], the range of the LEAF_tanh denominator. AArch64 NEON divides; 32-bit NEON
+// refines its reciprocal estimate and Helium, which has neither, refines a guess from the exponent bits.
+static inline float32x4_t leaf_recip_tanh(float32x4_t d)
+{
+#if LEAF_SIMD_HELIUM
+    float32x4_t r = vreinterpretq_f32_s32(vsubq_s32(vdupq_n_s32(0x7ef311c3), vreinterpretq_s32_f32(d)));
+    r = vmulq_f32(r, vsubq_f32(vdupq_n_f32(2.0f), vmulq_f32(d, r)));
+    r = vmulq_f32(r, vsubq_f32(vdupq_n_f32(2.0f), vmulq_f32(d, r)));
+    r = vmulq_f32(r, vsubq_f32(vdupq_n_f32(2.0f), vmulq_f32(d, r)));
+    return r;
+#else
+    float32x4_t r = vrecpeq_f32(d);
+    r = vmulq_f32(r, vrecpsq_f32(d, r));
+    r = vmulq_f32(r, vrecpsq_f32(d, r));
+    return r;
+#endif
+}
+#endif
+
+// Scales input into 2^x and scales the result
+static inline void leaf_exp2Scaled(const float* input, float* output, int size, float scale, float gain)
+{
+    int i = 0;
+#if LEAF_SIMD_SSE2
+    const __m128 vscale = _mm_set1_ps(scale), vgain = _mm_set1_ps(gain);
+    for (; i + 4 <= size; i += 4)
+        _mm_storeu_ps(output + i, _mm_mul_ps(leaf_exp2_simd(_mm_mul_ps(_mm_loadu_ps(input + i), vscale)), vgain));
+#elif LEAF_SIMD_NEON || LEAF_SIMD_HELIUM
+    const float32x4_t vscale = vdupq_n_f32(scale), vgain = vdupq_n_f32(gain);
+    for (; i + 4 <= size; i += 4)
+        vst1q_f32(output + i, vmulq_f32(leaf_exp2_simd(vmulq_f32(vld1q_f32(input + i), vscale)), vgain));
+#endif
+    for (; i < size; i++) output[i] = leaf_exp2(input[i] * scale) * gain;
+}
+
+void LEAF_exp2Block(const float* input, float* output, int size)
+{
+    leaf_exp2Scaled(input, output, size, 1.0f, 1.0f);
+}
+
+void LEAF_mtofBlock(const float* input, float* output, int size)
+{
+    leaf_exp2Scaled(input, output, size, 0.0833333333333333f, 8.17579891564f);
+}
+
+void LEAF_dbtoaBlock(const float* input, float* output, int size)
+{
+    leaf_exp2Scaled(input, output, size, 0.166096404744368f, 1.0f);
+}
+
+void LEAF_tanhBlock(const float* input, float* output, int size)
+{
+    int i = 0;
+#if LEAF_SIMD_SSE2
+    const __m128 lo = _mm_set1_ps(-3.0f), hi = _mm_set1_ps(3.0f);
+    const __m128 v27 = _mm_set1_ps(27.0f), v9 = _mm_set1_ps(9.0f);
+    for (; i + 4 <= size; i += 4)
+    {
+        __m128 x = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(input + i), lo), hi);
+        __m128 x2 = _mm_mul_ps(x, x);
+        __m128 num = _mm_mul_ps(x, _mm_add_ps(v27, x2));
+        __m128 den = _mm_add_ps(v27, _mm_mul_ps(_mm_mul_ps(v9, x), x));
+        _mm_storeu_ps(output + i, _mm_div_ps(num, den));
+    }
+#elif LEAF_SIMD_NEON || LEAF_SIMD_HELIUM
+    const float32x4_t lo = vdupq_n_f32(-3.0f), hi = vdupq_n_f32(3.0f);
+    const float32x4_t v27 = vdupq_n_f32(27.0f), v9 = vdupq_n_f32(9.0f);
+    for (; i + 4 <= size; i += 4)
+    {
+        float32x4_t x = leaf_vminq_f32(leaf_vmaxq_f32(vld1q_f32(input + i), lo), hi);
+        float32x4_t x2 = vmulq_f32(x, x);
+        float32x4_t num = vmulq_f32(x, vaddq_f32(v27, x2));
+        float32x4_t den = vaddq_f32(v27, vmulq_f32(vmulq_f32(v9, x), x));
+#if defined(__aarch64__)
+        vst1q_f32(output + i, vdivq_f32(num, den));
+#else
+        vst1q_f32(output + i, vmulq_f32(num, leaf_recip_tanh(den)));
+#endif
+    }
+#endif
+    for (; i < size; i++) output[i] = LEAF_tanh(input[i]);
+}
+
+void LEAF_interpolate_hermite_xBlock(const float* buffer, int length, const float* position, float* output, int size)
+{
+    int i = 0;
+#if LEAF_SIMD_SSE2 || LEAF_SIMD_NEON || LEAF_SIMD_HELIUM
+    // The four points are gathered one lane at a time, since none of these have a gather
+    float y0[4], y1[4], y2[4], y3[4], x[4];
+    for (; i + 4 <= size; i += 4)
+    {
+        for (int k = 0; k < 4; k++)
+        {
+            float p = position[i + k];
+            int idx = (int) p;
+            int im1 = idx - 1, ip1 = idx + 1, ip2 = idx + 2;
+            if (im1 < 0) im1 += length;
+            if (ip1 >= length) ip1 -= length;
+            if (ip2 >= length) ip2 -= length;
+            y0[k] = buffer[im1];
+            y1[k] = buffer[idx];
+            y2[k] = buffer[ip1];
+            y3[k] = buffer[ip2];
+            x[k] = p - (float) idx;
+        }
+#if LEAF_SIMD_SSE2
+        const __m128 half = _mm_set1_ps(0.5f);
+        __m128 a = _mm_loadu_ps(y0), b = _mm_loadu_ps(y1), c = _mm_loadu_ps(y2), d = _mm_loadu_ps(y3);
+        __m128 xx = _mm_loadu_ps(x);
+        __m128 c1 = _mm_mul_ps(half, _mm_sub_ps(c, a));
+        __m128 y0my1 = _mm_sub_ps(a, b);
+        __m128 c3 = _mm_add_ps(_mm_sub_ps(b, c), _mm_mul_ps(half, _mm_sub_ps(_mm_sub_ps(d, y0my1), c)));
+        __m128 c2 = _mm_sub_ps(_mm_add_ps(y0my1, c1), c3);
+        __m128 out = _mm_add_ps(_mm_mul_ps(c3, xx), c2);
+        out = _mm_add_ps(_mm_mul_ps(out, xx), c1);
+        _mm_storeu_ps(output + i, _mm_add_ps(_mm_mul_ps(out, xx), b));
+#else
+        const float32x4_t half = vdupq_n_f32(0.5f);
+        float32x4_t a = vld1q_f32(y0), b = vld1q_f32(y1), c = vld1q_f32(y2), d = vld1q_f32(y3);
+        float32x4_t xx = vld1q_f32(x);
+        float32x4_t c1 = vmulq_f32(half, vsubq_f32(c, a));
+        float32x4_t y0my1 = vsubq_f32(a, b);
+        float32x4_t c3 = vaddq_f32(vsubq_f32(b, c), vmulq_f32(half, vsubq_f32(vsubq_f32(d, y0my1), c)));
+        float32x4_t c2 = vsubq_f32(vaddq_f32(y0my1, c1), c3);
+        float32x4_t out = vaddq_f32(vmulq_f32(c3, xx), c2);
+        out = vaddq_f32(vmulq_f32(out, xx), c1);
+        vst1q_f32(output + i, vaddq_f32(vmulq_f32(out, xx), b));
+#endif
+    }
+#endif
+    for (; i < size; i++)
+    {
+        float p = position[i];
+        int idx = (int) p;
+        int im1 = idx - 1, ip1 = idx + 1, ip2 = idx + 2;
+        if (im1 < 0) im1 += length;
+        if (ip1 >= length) ip1 -= length;
+        if (ip2 >= length) ip2 -= length;
+        output[i] = LEAF_interpolate_hermite_x(buffer[im1], buffer[idx], buffer[ip1], buffer[ip2], p - (float) idx);
+    }
+}
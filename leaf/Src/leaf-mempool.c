@@ -60,6 +60,18 @@
 static inline size_t mpool_align(size_t size);
 static inline mpool_node_t* create_node(char* block_location, mpool_node_t* next, mpool_node_t* prev, size_t size, size_t header_size);
 static inline void delink_node(mpool_node_t* node);
+#if !LEAF_USE_DYNAMIC_ALLOCATION
+static char* mpool_tlsf_alloc(size_t asize, _tMempool* pool);
+static void mpool_tlsf_free(char* ptr, _tMempool* pool);
+static char* mpool_slab_alloc(_tMempool* pool, int clear);
+static void mpool_slab_free(char* ptr, _tMempool* pool);
+#endif
+static char* mpool_arena_alloc(size_t asize, _tMempool* pool, int clear);
+#if LEAF_POOL_STATS
+static void mpool_stats_init(_tMempool* pool);
+static void mpool_stats_count_alloc(_tMempool* pool, size_t asize);
+static inline void mpool_stats_update_peak(_tMempool* pool);
+#endif
 
 /**
  * create memory pool
@@ -71,6 +83,13 @@ void mpool_create (char* memory, size_t size, _tMempool* pool)
     pool->mpool = (char*)memory;
     pool->usize  = 0;
     pool->msize  = size;
+    pool->type = LEAFMempoolFirstFit;
+    pool->tlsf = NULL;
+    pool->bsize = 0;
+    pool->free_block = NULL;
+#if LEAF_POOL_STATS
+    mpool_stats_init(pool);
+#endif
     
     pool->head = create_node(pool->mpool, NULL, NULL, pool->msize - pool->leaf->header_size, pool->leaf->header_size);
     
@@ -95,10 +114,22 @@ void leaf_pool_init(LEAF* const leaf, char* memory, size_t size)
  */
 char* mpool_alloc(size_t asize, _tMempool* pool)
 {
-    pool->leaf->allocCount++;
+#if !LEAF_USE_DYNAMIC_ALLOCATION
+    // Anything that doesn't fit in a slab block comes from the parent pool, which counts it
+    if (pool->type == LEAFMempoolSlab && asize > pool->bsize) return mpool_alloc(asize, pool->mempool);
+#endif
+    leaf_fetchAdd(&pool->leaf->allocCount, 1);
+#if LEAF_POOL_STATS
+    mpool_stats_count_alloc(pool, asize);
+#endif
 #if LEAF_DEBUG
     DBG("alloc " + String(asize));
 #endif
+    // Arenas bump allocate even with dynamic allocation, so that resetting them releases everything
+    if (pool->type == LEAFMempoolArena)
+    {
+        return mpool_arena_alloc(asize, pool, pool->leaf->clearOnAllocation > 0);
+    }
 #if LEAF_USE_DYNAMIC_ALLOCATION
     char* temp = (char*) malloc(asize);
     if (temp == NULL)
@@ -113,6 +144,21 @@ char* mpool_alloc(size_t asize, _tMempool* pool)
     }
     return temp;
 #else
+    if (pool->type == LEAFMempoolSlab)
+    {
+        return mpool_slab_alloc(pool, pool->leaf->clearOnAllocation > 0);
+    }
+    
+    if (pool->type == LEAFMempoolTLSF)
+    {
+        char* new_pool = mpool_tlsf_alloc(asize, pool);
+        if (new_pool != NULL && pool->leaf->clearOnAllocation > 0)
+        {
+            memset(new_pool, 0, asize);
+        }
+        return new_pool;
+    }
+    
     // If the head is NULL, the mempool is full
     if (pool->head == NULL)
     {
@@ -184,6 +230,9 @@ char* mpool_alloc(size_t asize, _tMempool* pool)
     delink_node(node_to_alloc);
     
     pool->usize += pool->leaf->header_size + node_to_alloc->size;
+#if LEAF_POOL_STATS
+    mpool_stats_update_peak(pool);
+#endif
     
     if (pool->leaf->clearOnAllocation > 0)
     {
@@ -202,10 +251,20 @@ char* mpool_alloc(size_t asize, _tMempool* pool)
  */
 char* mpool_calloc(size_t asize, _tMempool* pool)
 {
-    pool->leaf->allocCount++;
+#if !LEAF_USE_DYNAMIC_ALLOCATION
+    if (pool->type == LEAFMempoolSlab && asize > pool->bsize) return mpool_calloc(asize, pool->mempool);
+#endif
+    leaf_fetchAdd(&pool->leaf->allocCount, 1);
+#if LEAF_POOL_STATS
+    mpool_stats_count_alloc(pool, asize);
+#endif
 #if LEAF_DEBUG
     DBG("calloc " + String(asize));
 #endif
+    if (pool->type == LEAFMempoolArena)
+    {
+        return mpool_arena_alloc(asize, pool, 1);
+    }
 #if LEAF_USE_DYNAMIC_ALLOCATION
     char* ret = (char*) malloc(asize);
     if (ret == NULL)
@@ -217,6 +276,18 @@ char* mpool_calloc(size_t asize, _tMempool* pool)
     memset(ret, 0, asize);
     return ret;
 #else
+    if (pool->type == LEAFMempoolSlab)
+    {
+        return mpool_slab_alloc(pool, 1);
+    }
+    
+    if (pool->type == LEAFMempoolTLSF)
+    {
+        char* new_pool = mpool_tlsf_alloc(asize, pool);
+        if (new_pool != NULL) memset(new_pool, 0, asize);
+        return new_pool;
+    }
+    
     // If the head is NULL, the mempool is full
     if (pool->head == NULL)
     {
@@ -288,6 +359,9 @@ char* mpool_calloc(size_t asize, _tMempool* pool)
     delink_node(node_to_alloc);
     
     pool->usize += pool->leaf->header_size + node_to_alloc->size;
+#if LEAF_POOL_STATS
+    mpool_stats_update_peak(pool);
+#endif
     // Format the new pool
     for (int i = 0; i < node_to_alloc->size; i++) node_to_alloc->pool[i] = 0;
     // Return the pool of the allocated node;
@@ -309,13 +383,38 @@ char* leaf_calloc(LEAF* const leaf, size_t size)
 
 void mpool_free(char* ptr, _tMempool* pool)
 {
-    pool->leaf->freeCount++;
+#if !LEAF_USE_DYNAMIC_ALLOCATION
+    // Frees of what a slab passed through to its parent are counted by the parent too
+    if (pool->type == LEAFMempoolSlab && (ptr < pool->mpool || ptr >= pool->mpool + pool->msize))
+    {
+        mpool_free(ptr, pool->mempool);
+        return;
+    }
+#endif
+    leaf_fetchAdd(&pool->leaf->freeCount, 1);
+#if LEAF_POOL_STATS
+    pool->freeCount++;
+#endif
 #if LEAF_DEBUG
     DBG("free");
 #endif
+    // Arena memory only comes back when the whole arena is reset
+    if (pool->type == LEAFMempoolArena) return;
 #if LEAF_USE_DYNAMIC_ALLOCATION
     free(ptr);
 #else
+    if (pool->type == LEAFMempoolSlab)
+    {
+        mpool_slab_free(ptr, pool);
+        return;
+    }
+    
+    if (pool->type == LEAFMempoolTLSF)
+    {
+        mpool_tlsf_free(ptr, pool);
+        return;
+    }
+    
     //if (ptr < pool->mpool || ptr >= pool->mpool + pool->msize)
     // Get the node at the freed space
     mpool_node_t* freed_node = (mpool_node_t*) (ptr - pool->leaf->header_size);
@@ -452,11 +551,436 @@ static inline void delink_node(mpool_node_t* node)
     node->prev = NULL;
 }
 
+/**
+ * TLSF (two-level segregated fit) pool, after Masmano et al.
+ *
+ * Free blocks are binned by size into first level classes (powers of two) and
+ * MPOOL_TLSF_SL_COUNT linear second level classes within each. A bitmap per level
+ * finds the smallest non-empty class that satisfies a request with two bit scans,
+ * and boundary tags (prev_phys and the prev-free flag) let freed blocks merge with
+ * their physical neighbors without searching, so alloc and free are O(1).
+ */
+#define MPOOL_TLSF_ALIGN_LOG2       (3) // log2(MPOOL_ALIGN_SIZE)
+#define MPOOL_TLSF_SL_LOG2          (4)
+#define MPOOL_TLSF_SL_COUNT         (1 << MPOOL_TLSF_SL_LOG2)
+#define MPOOL_TLSF_FL_SHIFT         (MPOOL_TLSF_SL_LOG2 + MPOOL_TLSF_ALIGN_LOG2)
+#define MPOOL_TLSF_SMALL_BLOCK      ((size_t) 1 << MPOOL_TLSF_FL_SHIFT)
+#define MPOOL_TLSF_FL_MAX           (31)
+#define MPOOL_TLSF_FREE_BIT         ((size_t) 1)
+#define MPOOL_TLSF_PREV_FREE_BIT    ((size_t) 2)
+#define MPOOL_TLSF_SIZE_MASK        (~((size_t) (MPOOL_ALIGN_SIZE - 1)))
+
+// index of the most significant set bit, x must not be 0
+static inline int mpool_fls(size_t x)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return (int) (sizeof(unsigned long long) * 8) - 1 - __builtin_clzll((unsigned long long) x);
+#else
+    unsigned long long v = x;
+    int bit = 0;
+    if (v >= (1ULL << 32)) { v >>= 32; bit += 32; }
+    if (v >= (1ULL << 16)) { v >>= 16; bit += 16; }
+    if (v >= (1ULL << 8)) { v >>= 8; bit += 8; }
+    if (v >= (1ULL << 4)) { v >>= 4; bit += 4; }
+    if (v >= (1ULL << 2)) { v >>= 2; bit += 2; }
+    if (v >= (1ULL << 1)) { bit += 1; }
+    return bit;
+#endif
+}
+
+// index of the least significant set bit, x must not be 0
+static inline int mpool_ffs(unsigned int x)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctz(x);
+#else
+    return mpool_fls(x & (~x + 1));
+#endif
+}
+
+static inline void mpool_tlsf_mapping(size_t size, int* fl, int* sl)
+{
+    if (size < MPOOL_TLSF_SMALL_BLOCK)
+    {
+        *fl = 0;
+        *sl = (int) (size >> MPOOL_TLSF_ALIGN_LOG2);
+    }
+    else
+    {
+        int f = mpool_fls(size);
+        *sl = (int) (size >> (f - MPOOL_TLSF_SL_LOG2)) ^ MPOOL_TLSF_SL_COUNT;
+        *fl = f - MPOOL_TLSF_FL_SHIFT + 1;
+    }
+}
+
+// round the request up to the next class boundary so any block in the class found is large enough
+static inline void mpool_tlsf_mapping_search(size_t size, int* fl, int* sl)
+{
+    if (size >= MPOOL_TLSF_SMALL_BLOCK)
+    {
+        size += ((size_t) 1 << (mpool_fls(size) - MPOOL_TLSF_SL_LOG2)) - 1;
+    }
+    mpool_tlsf_mapping(size, fl, sl);
+}
+
+static inline size_t mpool_tlsf_block_size(mpool_tlsf_block_t* block)
+{
+    return block->size & MPOOL_TLSF_SIZE_MASK;
+}
+
+static inline mpool_tlsf_block_t* mpool_tlsf_next_phys(mpool_tlsf_block_t* block, size_t header_size)
+{
+    return (mpool_tlsf_block_t*) ((char*) block + header_size + mpool_tlsf_block_size(block));
+}
+
+static inline void mpool_tlsf_insert(mpool_tlsf_t* ctl, mpool_tlsf_block_t* block)
+{
+    int fl, sl;
+    mpool_tlsf_mapping(mpool_tlsf_block_size(block), &fl, &sl);
+    
+    mpool_tlsf_block_t** head = &ctl->heads[fl * MPOOL_TLSF_SL_COUNT + sl];
+    block->next_free = *head;
+    block->prev_free = NULL;
+    if (*head != NULL) (*head)->prev_free = block;
+    *head = block;
+    
+    ctl->fl_bitmap |= (1U << fl);
+    ctl->sl_bitmap[fl] |= (1U << sl);
+}
+
+static inline void mpool_tlsf_remove(mpool_tlsf_t* ctl, mpool_tlsf_block_t* block)
+{
+    int fl, sl;
+    mpool_tlsf_mapping(mpool_tlsf_block_size(block), &fl, &sl);
+    
+    if (block->next_free != NULL) block->next_free->prev_free = block->prev_free;
+    if (block->prev_free != NULL) block->prev_free->next_free = block->next_free;
+    
+    mpool_tlsf_block_t** head = &ctl->heads[fl * MPOOL_TLSF_SL_COUNT + sl];
+    if (*head == block)
+    {
+        *head = block->next_free;
+        if (*head == NULL)
+        {
+            ctl->sl_bitmap[fl] &= ~(1U << sl);
+            if (ctl->sl_bitmap[fl] == 0) ctl->fl_bitmap &= ~(1U << fl);
+        }
+    }
+    block->next_free = NULL;
+    block->prev_free = NULL;
+}
+
+void mpool_create_tlsf (char* memory, size_t size, _tMempool* pool)
+{
+    size_t header_size = pool->leaf->header_size = mpool_align(sizeof(mpool_node_t));
+    
+    pool->mpool = (char*)memory;
+    pool->msize = size;
+    pool->head = NULL;
+    pool->type = LEAFMempoolTLSF;
+    pool->bsize = 0;
+    pool->free_block = NULL;
+#if LEAF_POOL_STATS
+    mpool_stats_init(pool);
+#endif
+    
+    // Size the control structure for the largest block this pool could hold
+    int fl_count, sl;
+    mpool_tlsf_mapping(size, &fl_count, &sl);
+    fl_count += 1;
+    if (fl_count > MPOOL_TLSF_FL_MAX) fl_count = MPOOL_TLSF_FL_MAX;
+    
+    size_t control_size = mpool_align(sizeof(mpool_tlsf_t))
+                        + mpool_align(sizeof(unsigned int) * fl_count)
+                        + mpool_align(sizeof(mpool_tlsf_block_t*) * fl_count * MPOOL_TLSF_SL_COUNT);
+    
+    mpool_tlsf_t* ctl = pool->tlsf = (mpool_tlsf_t*) memory;
+    ctl->fl_bitmap = 0;
+    ctl->fl_count = fl_count;
+    ctl->sl_bitmap = (unsigned int*) (memory + mpool_align(sizeof(mpool_tlsf_t)));
+    ctl->heads = (mpool_tlsf_block_t**) (memory + mpool_align(sizeof(mpool_tlsf_t)) + mpool_align(sizeof(unsigned int) * fl_count));
+    for (int i = 0; i < fl_count; ++i) ctl->sl_bitmap[i] = 0;
+    for (int i = 0; i < fl_count * MPOOL_TLSF_SL_COUNT; ++i) ctl->heads[i] = NULL;
+    
+    // The control structure and the zero size sentinel block at the end of the pool count as used
+    pool->usize = control_size + header_size;
+    
+    // Need room for the control structure, one block with some memory, and the sentinel
+    if (size < control_size + 2 * header_size + MPOOL_ALIGN_SIZE)
+    {
+        pool->usize = size;
+        return;
+    }
+    
+    size_t block_size = (size - control_size - 2 * header_size) & MPOOL_TLSF_SIZE_MASK;
+    mpool_tlsf_block_t* block = (mpool_tlsf_block_t*) (memory + control_size);
+    block->prev_phys = NULL;
+    block->size = block_size | MPOOL_TLSF_FREE_BIT;
+    
+    mpool_tlsf_block_t* sentinel = mpool_tlsf_next_phys(block, header_size);
+    sentinel->prev_phys = block;
+    sentinel->next_free = NULL;
+    sentinel->prev_free = NULL;
+    sentinel->size = 0 | MPOOL_TLSF_PREV_FREE_BIT;
+    
+    mpool_tlsf_insert(ctl, block);
+}
+
+#if !LEAF_USE_DYNAMIC_ALLOCATION
+static char* mpool_tlsf_alloc(size_t asize, _tMempool* pool)
+{
+    mpool_tlsf_t* ctl = pool->tlsf;
+    size_t header_size = pool->leaf->header_size;
+    
+    size_t size_to_alloc = mpool_align(asize);
+    if (size_to_alloc == 0) size_to_alloc = MPOOL_ALIGN_SIZE;
+    
+    // Find the first non-empty class at or above the rounded up request
+    mpool_tlsf_block_t* block = NULL;
+    int fl, sl;
+    mpool_tlsf_mapping_search(size_to_alloc, &fl, &sl);
+    if (fl < ctl->fl_count)
+    {
+        unsigned int sl_map = ctl->sl_bitmap[fl] & (~0U << sl);
+        if (sl_map == 0)
+        {
+            unsigned int fl_map = ctl->fl_bitmap & (~0U << (fl + 1));
+            if (fl_map != 0)
+            {
+                fl = mpool_ffs(fl_map);
+                sl_map = ctl->sl_bitmap[fl];
+            }
+        }
+        if (sl_map != 0)
+        {
+            sl = mpool_ffs(sl_map);
+            block = ctl->heads[fl * MPOOL_TLSF_SL_COUNT + sl];
+        }
+    }
+    
+    // Rounding up can skip past the only block large enough, so check the head of the request's own class
+    if (block == NULL)
+    {
+        mpool_tlsf_mapping(size_to_alloc, &fl, &sl);
+        if (fl < ctl->fl_count)
+        {
+            mpool_tlsf_block_t* candidate = ctl->heads[fl * MPOOL_TLSF_SL_COUNT + sl];
+            if (candidate != NULL && mpool_tlsf_block_size(candidate) >= size_to_alloc) block = candidate;
+        }
+    }
+    
+    if (block == NULL)
+    {
+        if ((pool->msize - pool->usize) > asize)
+        {
+            LEAF_internalErrorCallback(pool->leaf, LEAFMempoolFragmentation);
+        }
+        else
+        {
+            LEAF_internalErrorCallback(pool->leaf, LEAFMempoolOverrun);
+        }
+        return NULL;
+    }
+    
+    mpool_tlsf_remove(ctl, block);
+    
+    mpool_tlsf_block_t* next = mpool_tlsf_next_phys(block, header_size);
+    size_t leftover = mpool_tlsf_block_size(block) - size_to_alloc;
+    
+    // Split off the remainder as a new free block if there is enough space
+    if (leftover >= header_size + MPOOL_ALIGN_SIZE)
+    {
+        block->size = size_to_alloc | (block->size & MPOOL_TLSF_PREV_FREE_BIT);
+        
+        mpool_tlsf_block_t* remainder = mpool_tlsf_next_phys(block, header_size);
+        remainder->prev_phys = block;
+        remainder->size = (leftover - header_size) | MPOOL_TLSF_FREE_BIT;
+        next->prev_phys = remainder;
+        mpool_tlsf_insert(ctl, remainder);
+    }
+    else
+    {
+        // Add any leftover space to the allocated block
+        block->size &= ~MPOOL_TLSF_FREE_BIT;
+        next->size &= ~MPOOL_TLSF_PREV_FREE_BIT;
+    }
+    
+    pool->usize += header_size + mpool_tlsf_block_size(block);
+#if LEAF_POOL_STATS
+    mpool_stats_update_peak(pool);
+#endif
+    
+    return (char*) block + header_size;
+}
+
+static void mpool_tlsf_free(char* ptr, _tMempool* pool)
+{
+    mpool_tlsf_t* ctl = pool->tlsf;
+    size_t header_size = pool->leaf->header_size;
+    
+    mpool_tlsf_block_t* block = (mpool_tlsf_block_t*) (ptr - header_size);
+    
+    if ((char*) block < pool->mpool ||
+        ptr >= pool->mpool + pool->msize ||
+        (block->size & MPOOL_TLSF_FREE_BIT))
+    {
+        LEAF_internalErrorCallback(pool->leaf, LEAFInvalidFree);
+        return;
+    }
+    
+    pool->usize -= header_size + mpool_tlsf_block_size(block);
+    
+    // Merge with the physically previous block if it's free
+    if (block->size & MPOOL_TLSF_PREV_FREE_BIT)
+    {
+        mpool_tlsf_block_t* prev = block->prev_phys;
+        mpool_tlsf_remove(ctl, prev);
+        prev->size += header_size + mpool_tlsf_block_size(block);
+        block = prev;
+    }
+    
+    // Merge with the physically next block if it's free
+    mpool_tlsf_block_t* next = mpool_tlsf_next_phys(block, header_size);
+    if (next->size & MPOOL_TLSF_FREE_BIT)
+    {
+        mpool_tlsf_remove(ctl, next);
+        block->size += header_size + mpool_tlsf_block_size(next);
+        next = mpool_tlsf_next_phys(block, header_size);
+    }
+    
+    block->size |= MPOOL_TLSF_FREE_BIT;
+    next->prev_phys = block;
+    next->size |= MPOOL_TLSF_PREV_FREE_BIT;
+    
+    mpool_tlsf_insert(ctl, block);
+}
+#endif
+
+/**
+ * create slab pool, fixed size blocks linked through their first word while free
+ */
+void mpool_create_slab (char* memory, size_t size, size_t blockSize, _tMempool* pool)
+{
+    if (blockSize < sizeof(char*)) blockSize = sizeof(char*);
+    blockSize = mpool_align(blockSize);
+    
+    pool->mpool = (char*)memory;
+    pool->usize = 0;
+    pool->msize = size;
+    pool->head = NULL;
+    pool->type = LEAFMempoolSlab;
+    pool->tlsf = NULL;
+    pool->bsize = blockSize;
+    pool->free_block = NULL;
+#if LEAF_POOL_STATS
+    mpool_stats_init(pool);
+#endif
+    
+    // Link the blocks back to front so the free list hands them out in address order
+    size_t numBlocks = size / blockSize;
+    for (size_t i = numBlocks; i > 0; --i)
+    {
+        char* block = memory + (i - 1) * blockSize;
+        *(char**) block = pool->free_block;
+        pool->free_block = block;
+    }
+}
+
+/**
+ * create arena pool, allocated by moving usize along the memory and released all at once by mpool_reset
+ */
+void mpool_create_arena (char* memory, size_t size, _tMempool* pool)
+{
+    pool->mpool = (char*)memory;
+    pool->usize = 0;
+    pool->msize = size;
+    pool->head = NULL;
+    pool->type = LEAFMempoolArena;
+    pool->tlsf = NULL;
+    pool->bsize = 0;
+    pool->free_block = NULL;
+#if LEAF_POOL_STATS
+    mpool_stats_init(pool);
+#endif
+}
+
+/**
+ * discard everything allocated from a pool. Constant time for arenas, which keep their stats so the
+ * peak shows how big the arena needs to be. Other pools are created again over the same memory.
+ */
+void mpool_reset (_tMempool* pool)
+{
+    if (pool->type == LEAFMempoolArena) pool->usize = 0;
+    else if (pool->type == LEAFMempoolSlab) mpool_create_slab(pool->mpool, pool->msize, pool->bsize, pool);
+    else if (pool->type == LEAFMempoolTLSF) mpool_create_tlsf(pool->mpool, pool->msize, pool);
+    else mpool_create(pool->mpool, pool->msize, pool);
+}
+
+static char* mpool_arena_alloc(size_t asize, _tMempool* pool, int clear)
+{
+    size_t size = mpool_align(asize);
+    if (size > pool->msize - pool->usize)
+    {
+        LEAF_internalErrorCallback(pool->leaf, LEAFMempoolOverrun);
+        return NULL;
+    }
+    
+    char* ptr = pool->mpool + pool->usize;
+    pool->usize += size;
+#if LEAF_POOL_STATS
+    mpool_stats_update_peak(pool);
+#endif
+    
+    if (clear) memset(ptr, 0, asize);
+    
+    return ptr;
+}
+
+#if !LEAF_USE_DYNAMIC_ALLOCATION
+// mpool_alloc and mpool_calloc have already sent anything bigger than a block to the parent pool
+static char* mpool_slab_alloc(_tMempool* pool, int clear)
+{
+    char* block = pool->free_block;
+    if (block == NULL)
+    {
+        LEAF_internalErrorCallback(pool->leaf, LEAFMempoolOverrun);
+        return NULL;
+    }
+    pool->free_block = *(char**) block;
+    pool->usize += pool->bsize;
+#if LEAF_POOL_STATS
+    mpool_stats_update_peak(pool);
+#endif
+    
+    if (clear) memset(block, 0, pool->bsize);
+    
+    return block;
+}
+
+static void mpool_slab_free(char* ptr, _tMempool* pool)
+{
+    if ((size_t) (ptr - pool->mpool) % pool->bsize != 0)
+    {
+        LEAF_internalErrorCallback(pool->leaf, LEAFInvalidFree);
+        return;
+    }
+    
+    *(char**) ptr = pool->free_block;
+    pool->free_block = ptr;
+    pool->usize -= pool->bsize;
+}
+#endif
+
 void tMempool_init(tMempool* const mp, char* memory, size_t size, LEAF* const leaf)
 {
     tMempool_initToPool(mp, memory, size, &leaf->mempool);
 }
 
+void tMempool_initWithType(tMempool* const mp, char* memory, size_t size, LEAFMempoolType type, LEAF* const leaf)
+{
+    tMempool_initToPoolWithType(mp, memory, size, type, &leaf->mempool);
+}
+
 void tMempool_free(tMempool* const mp)
 {
     _tMempool* m = *mp;
@@ -468,8 +992,302 @@ void    tMempool_initToPool     (tMempool* const mp, char* memory, size_t size,
 {
     _tMempool* mm = *mem;
     _tMempool* m = *mp = (_tMempool*) mpool_alloc(sizeof(_tMempool), mm);
+    m->mempool = mm;
     m->leaf = mm->leaf;
     
     mpool_create (memory, size, m);
 }
 
+void    tMempool_initToPoolWithType (tMempool* const mp, char* memory, size_t size, LEAFMempoolType type, tMempool* const mem)
+{
+    _tMempool* mm = *mem;
+    _tMempool* m = *mp = (_tMempool*) mpool_alloc(sizeof(_tMempool), mm);
+    m->mempool = mm;
+    m->leaf = mm->leaf;
+
+    if (type == LEAFMempoolTLSF) mpool_create_tlsf (memory, size, m);
+    else if (type == LEAFMempoolArena) mpool_create_arena (memory, size, m);
+    else mpool_create (memory, size, m);
+}
+
+void    tMempool_initInPlace    (tMempool* const mp, _tMempool* const storage, char* memory, size_t size, LEAFMempoolType type, LEAF* const leaf)
+{
+    _tMempool* m = *mp = storage;
+    m->mempool = leaf->mempool;
+    m->leaf = leaf;
+    
+    if (type == LEAFMempoolTLSF) mpool_create_tlsf (memory, size, m);
+    else if (type == LEAFMempoolArena) mpool_create_arena (memory, size, m);
+    else mpool_create (memory, size, m);
+}
+
+void    tSlabPool_init          (tSlabPool* const sp, size_t blockSize, int numBlocks, LEAF* const leaf)
+{
+    tSlabPool_initToPool(sp, blockSize, numBlocks, &leaf->mempool);
+}
+
+void    tSlabPool_initToPool    (tSlabPool* const sp, size_t blockSize, int numBlocks, tMempool* const mem)
+{
+    _tMempool* mm = *mem;
+    _tMempool* m = *sp = (_tMempool*) mpool_alloc(sizeof(_tMempool), mm);
+    m->mempool = mm;
+    m->leaf = mm->leaf;
+    
+    size_t alignedSize = mpool_align(blockSize < sizeof(char*) ? sizeof(char*) : blockSize);
+    size_t size = alignedSize * numBlocks;
+    char* memory = mpool_alloc(size, mm);
+    
+    mpool_create_slab (memory, size, blockSize, m);
+}
+
+void    tSlabPool_free          (tSlabPool* const sp)
+{
+    _tMempool* m = *sp;
+    
+    mpool_free(m->mpool, m->mempool);
+    mpool_free((char*)m, m->mempool);
+}
+
+void    tArenaPool_init         (tArenaPool* const ap, size_t size, LEAF* const leaf)
+{
+    tArenaPool_initToPool(ap, size, &leaf->mempool);
+}
+
+void    tArenaPool_initToPool   (tArenaPool* const ap, size_t size, tMempool* const mem)
+{
+    _tMempool* mm = *mem;
+    _tMempool* m = *ap = (_tMempool*) mpool_alloc(sizeof(_tMempool), mm);
+    m->mempool = mm;
+    m->leaf = mm->leaf;
+    
+    size = mpool_align(size);
+    char* memory = mpool_alloc(size, mm);
+    
+    mpool_create_arena (memory, size, m);
+}
+
+void    tArenaPool_initInPlace  (tArenaPool* const ap, _tMempool* const storage, char* memory, size_t size, LEAF* const leaf)
+{
+    tMempool_initInPlace(ap, storage, memory, size, LEAFMempoolArena, leaf);
+}
+
+void    tArenaPool_free         (tArenaPool* const ap)
+{
+    _tMempool* m = *ap;
+    
+    mpool_free(m->mpool, m->mempool);
+    mpool_free((char*)m, m->mempool);
+}
+
+void    tArenaPool_reset        (tArenaPool* const ap)
+{
+    mpool_reset(*ap);
+}
+
+// The state word hands the inactive arena back and forth. The builder owns it from a successful
+// compare-exchange on idle until its release store of published, and the audio thread owns the flip
+// of active from its acquire load of published until its release store of idle. Neither side waits.
+enum
+{
+    ArenaSwapIdle = 0,
+    ArenaSwapBuilding,
+    ArenaSwapPublished
+};
+
+void    tArenaSwap_init         (tArenaSwap* const swap, size_t size, LEAF* const leaf)
+{
+    tArenaSwap_initToPool(swap, size, &leaf->mempool);
+}
+
+void    tArenaSwap_initToPool   (tArenaSwap* const swap, size_t size, tMempool* const mem)
+{
+    _tMempool* m = *mem;
+    _tArenaSwap* s = *swap = (_tArenaSwap*) mpool_alloc(sizeof(_tArenaSwap), m);
+    s->mempool = m;
+    
+    tArenaPool_initToPool(&s->arenas[0], size, mem);
+    tArenaPool_initToPool(&s->arenas[1], size, mem);
+    s->presets[0] = NULL;
+    s->presets[1] = NULL;
+    s->active = 0;
+    s->state = ArenaSwapIdle;
+}
+
+void    tArenaSwap_free         (tArenaSwap* const swap)
+{
+    _tArenaSwap* s = *swap;
+    
+    tArenaPool_free(&s->arenas[1]);
+    tArenaPool_free(&s->arenas[0]);
+    mpool_free((char*)s, s->mempool);
+}
+
+tMempool* tArenaSwap_beginBuild (tArenaSwap* const swap)
+{
+    _tArenaSwap* s = *swap;
+    
+    if (leaf_compareExchange(&s->state, ArenaSwapIdle, ArenaSwapBuilding) != ArenaSwapIdle) return NULL;
+    
+    int inactive = 1 - s->active;
+    tArenaPool_reset(&s->arenas[inactive]);
+    s->presets[inactive] = NULL;
+    
+    return &s->arenas[inactive];
+}
+
+void    tArenaSwap_publish      (tArenaSwap* const swap, void* preset)
+{
+    _tArenaSwap* s = *swap;
+    
+    s->presets[1 - s->active] = preset;
+    leaf_storeRelease(&s->state, ArenaSwapPublished);
+}
+
+void    tArenaSwap_cancelBuild  (tArenaSwap* const swap)
+{
+    _tArenaSwap* s = *swap;
+    
+    leaf_storeRelease(&s->state, ArenaSwapIdle);
+}
+
+int     tArenaSwap_swap         (tArenaSwap* const swap)
+{
+    _tArenaSwap* s = *swap;
+    
+    if (leaf_loadAcquire(&s->state) != ArenaSwapPublished) return 0;
+    
+    s->active = 1 - s->active;
+    leaf_storeRelease(&s->state, ArenaSwapIdle);
+    
+    return 1;
+}
+
+void*   tArenaSwap_getPreset    (tArenaSwap* const swap)
+{
+    _tArenaSwap* s = *swap;
+    
+    return s->presets[s->active];
+}
+
+tMempool* tArenaSwap_getActivePool (tArenaSwap* const swap)
+{
+    _tArenaSwap* s = *swap;
+    
+    return &s->arenas[s->active];
+}
+
+#if LEAF_POOL_STATS
+static void mpool_stats_init(_tMempool* pool)
+{
+    pool->peak = 0;
+    pool->allocCount = 0;
+    pool->freeCount = 0;
+    pool->tag = NULL;
+    pool->numTags = 0;
+}
+
+static void mpool_stats_count_alloc(_tMempool* pool, size_t asize)
+{
+    pool->allocCount++;
+    
+    if (pool->tag == NULL) return;
+    
+    for (int i = 0; i < pool->numTags; ++i)
+    {
+        if (pool->tags[i].name == pool->tag || strcmp(pool->tags[i].name, pool->tag) == 0)
+        {
+            pool->tags[i].bytes += asize;
+            pool->tags[i].count++;
+            return;
+        }
+    }
+    
+    // Tags beyond LEAF_POOL_STATS_MAX_TAGS aren't recorded
+    if (pool->numTags < LEAF_POOL_STATS_MAX_TAGS)
+    {
+        LEAFMempoolTag* t = &pool->tags[pool->numTags++];
+        t->name = pool->tag;
+        t->bytes = asize;
+        t->count = 1;
+    }
+}
+
+static inline void mpool_stats_update_peak(_tMempool* pool)
+{
+    if (pool->usize > pool->peak) pool->peak = pool->usize;
+}
+
+void mpool_get_stats(_tMempool* pool, LEAFMempoolStats* stats)
+{
+    stats->size = pool->msize;
+    stats->used = pool->usize;
+    stats->peak = pool->peak > pool->usize ? pool->peak : pool->usize;
+    stats->largestFree = 0;
+    stats->freeBlocks = 0;
+    stats->allocCount = pool->allocCount;
+    stats->freeCount = pool->freeCount;
+    
+    if (pool->type == LEAFMempoolSlab)
+    {
+        for (char* block = pool->free_block; block != NULL; block = *(char**) block)
+        {
+            stats->freeBlocks++;
+        }
+        if (stats->freeBlocks > 0) stats->largestFree = pool->bsize;
+    }
+    else if (pool->type == LEAFMempoolArena)
+    {
+        stats->largestFree = pool->msize - pool->usize;
+        stats->freeBlocks = stats->largestFree > 0 ? 1 : 0;
+    }
+    else if (pool->type == LEAFMempoolTLSF)
+    {
+        mpool_tlsf_t* ctl = pool->tlsf;
+        if (ctl == NULL) return;
+        for (int i = 0; i < ctl->fl_count * MPOOL_TLSF_SL_COUNT; ++i)
+        {
+            for (mpool_tlsf_block_t* block = ctl->heads[i]; block != NULL; block = block->next_free)
+            {
+                size_t size = mpool_tlsf_block_size(block);
+                if (size > stats->largestFree) stats->largestFree = size;
+                stats->freeBlocks++;
+            }
+        }
+    }
+    else
+    {
+        for (mpool_node_t* node = pool->head; node != NULL; node = node->next)
+        {
+            if (node->size > stats->largestFree) stats->largestFree = node->size;
+            stats->freeBlocks++;
+        }
+    }
+}
+
+void mpool_reset_peak(_tMempool* pool)
+{
+    pool->peak = pool->usize;
+}
+
+void mpool_set_tag(_tMempool* pool, const char* tag)
+{
+    pool->tag = tag;
+}
+
+int mpool_get_num_tags(_tMempool* pool)
+{
+    return pool->numTags;
+}
+
+LEAFMempoolTag* mpool_get_tag(_tMempool* pool, int index)
+{
+    if (index < 0 || index >= pool->numTags) return NULL;
+    return &pool->tags[index];
+}
+
+void leaf_pool_get_stats(LEAF* const leaf, LEAFMempoolStats* stats)
+{
+    mpool_get_stats(&leaf->_internal_mempool, stats);
+}
+#endif
+
@@ -27,6 +27,7 @@ void tStack_init(tStack* const stack, LEAF* const leaf)
 
 void    tStack_initToPool           (tStack* const stack, tMempool* const mp)
 {
+    LEAF_PROFILE_POOL(mp);
     _tMempool* m = *mp;
     _tStack* ns = *stack = (_tStack*) mpool_alloc(sizeof(_tStack), m);
     ns->mempool = m;
@@ -255,7 +256,383 @@ int tStack_first(tStack* const stack)
 }
 
 
+// VOICE ALLOCATOR
+
+// Append a voice to the list for a state, or leave it on none if it is above numVoices
+static inline void voiceAllocator_link(_tVoiceAllocator* const a, int voice, int state)
+{
+    a->voiceState[voice] = (uint8_t) state;
+    if (voice >= a->numVoices)
+    {
+        a->voiceList[voice] = -1;
+        return;
+    }
+    a->voiceList[voice] = (int8_t) state;
+    a->prev[voice] = a->tail[state];
+    a->next[voice] = -1;
+    if (a->tail[state] >= 0) a->next[a->tail[state]] = voice;
+    else a->head[state] = voice;
+    a->tail[state] = voice;
+}
+
+static inline void voiceAllocator_unlink(_tVoiceAllocator* const a, int voice)
+{
+    int list = a->voiceList[voice];
+    if (list < 0) return;
+    if (a->prev[voice] >= 0) a->next[a->prev[voice]] = a->next[voice];
+    else a->head[list] = a->next[voice];
+    if (a->next[voice] >= 0) a->prev[a->next[voice]] = a->prev[voice];
+    else a->tail[list] = a->prev[voice];
+    a->voiceList[voice] = -1;
+}
+
+// Stolen notes are kept newest first
+static inline void voiceAllocator_pushStolen(_tVoiceAllocator* const a, int note)
+{
+    a->stolenPrev[note] = -1;
+    a->stolenNext[note] = a->stolenHead;
+    if (a->stolenHead >= 0) a->stolenPrev[a->stolenHead] = note;
+    a->stolenHead = note;
+}
+
+static inline void voiceAllocator_removeStolen(_tVoiceAllocator* const a, int note)
+{
+    if (a->stolenPrev[note] >= 0) a->stolenNext[a->stolenPrev[note]] = a->stolenNext[note];
+    else a->stolenHead = a->stolenNext[note];
+    if (a->stolenNext[note] >= 0) a->stolenPrev[a->stolenNext[note]] = a->stolenPrev[note];
+}
+
+// Take whatever a voice was doing away from it and give it a held note
+static inline void voiceAllocator_assign(_tVoiceAllocator* const a, int voice, int note)
+{
+    int oldNote = a->voiceNote[voice];
+    if (oldNote >= 0 && a->noteVoice[oldNote] == voice) a->noteVoice[oldNote] = -1;
+    voiceAllocator_unlink(a, voice);
+    voiceAllocator_link(a, voice, VoiceHeld);
+    a->voiceNote[voice] = note;
+    a->voiceVelocity[voice] = a->noteVelocity[note];
+    a->noteVoice[note] = voice;
+}
+
+static inline int voiceAllocator_quietest(_tVoiceAllocator* const a, int list)
+{
+    int voice = a->head[list];
+    float level = a->levelCallback(a->levelUserData, voice);
+    for (int v = a->next[voice]; v >= 0; v = a->next[v])
+    {
+        float l = a->levelCallback(a->levelUserData, v);
+        if (l < level)
+        {
+            level = l;
+            voice = v;
+        }
+    }
+    return voice;
+}
+
+// Hand a voice that has come free to the most recent stolen note, if there is one waiting
+static inline int voiceAllocator_recover(_tVoiceAllocator* const a, int voice)
+{
+    if (!a->recoverStolen || a->stolenHead < 0 || voice >= a->numVoices) return -1;
+    int note = a->stolenHead;
+    voiceAllocator_removeStolen(a, note);
+    voiceAllocator_assign(a, voice, note);
+    return note;
+}
+
+void tVoiceAllocator_init(tVoiceAllocator* const alloc, int maxNumVoices, LEAF* const leaf)
+{
+    tVoiceAllocator_initToPool(alloc, maxNumVoices, &leaf->mempool);
+}
+
+void    tVoiceAllocator_initToPool    (tVoiceAllocator* const alloc, int maxNumVoices, tMempool* const mp)
+{
+    LEAF_PROFILE_POOL(mp);
+    _tMempool* m = *mp;
+    _tVoiceAllocator* a = *alloc = (_tVoiceAllocator*) mpool_alloc(sizeof(_tVoiceAllocator), m);
+    a->mempool = m;
+    
+    a->maxNumVoices = maxNumVoices;
+    a->numVoices = maxNumVoices;
+    a->voiceNote = (int*) mpool_alloc(sizeof(int) * maxNumVoices, m);
+    a->voiceVelocity = (int*) mpool_calloc(sizeof(int) * maxNumVoices, m);
+    a->voiceState = (uint8_t*) mpool_calloc(sizeof(uint8_t) * maxNumVoices, m);
+    a->voiceList = (int8_t*) mpool_alloc(sizeof(int8_t) * maxNumVoices, m);
+    a->prev = (int*) mpool_alloc(sizeof(int) * maxNumVoices, m);
+    a->next = (int*) mpool_alloc(sizeof(int) * maxNumVoices, m);
+    for (int i = 0; i < VoiceStateNil; ++i)
+    {
+        a->head[i] = -1;
+        a->tail[i] = -1;
+    }
+    for (int i = 0; i < maxNumVoices; ++i)
+    {
+        a->voiceNote[i] = -1;
+        voiceAllocator_link(a, i, VoiceFree);
+    }
+    
+    for (int i = 0; i < 128; ++i)
+    {
+        a->noteVoice[i] = -1;
+        a->noteVelocity[i] = 0;
+        a->noteHeld[i] = 0;
+    }
+    a->stolenHead = -1;
+    a->numHeld = 0;
+    a->stolenNote = -1;
+    
+    a->stealMode = VoiceStealOldest;
+    a->stealing = 1;
+    a->recoverStolen = 1;
+    a->levelCallback = NULL;
+    a->levelUserData = NULL;
+}
+
+void    tVoiceAllocator_free          (tVoiceAllocator* const alloc)
+{
+    _tVoiceAllocator* a = *alloc;
+    
+    mpool_free((char*)a->next, a->mempool);
+    mpool_free((char*)a->prev, a->mempool);
+    mpool_free((char*)a->voiceList, a->mempool);
+    mpool_free((char*)a->voiceState, a->mempool);
+    mpool_free((char*)a->voiceVelocity, a->mempool);
+    mpool_free((char*)a->voiceNote, a->mempool);
+    mpool_free((char*)a, a->mempool);
+}
+
+int     tVoiceAllocator_noteOn        (tVoiceAllocator* const alloc, int note, int velocity)
+{
+    _tVoiceAllocator* a = *alloc;
+    
+    a->stolenNote = -1;
+    if (note < 0 || note > 127 || a->noteHeld[note]) return -1;
+    
+    int voice = -1;
+    int same = a->noteVoice[note];
+    if (a->stealMode == VoiceStealSameNote && same >= 0 && a->voiceList[same] == VoiceReleased) voice = same;
+    else if (a->head[VoiceFree] >= 0) voice = a->head[VoiceFree];
+    else if (a->head[VoiceReleased] >= 0)
+    {
+        if (a->stealMode == VoiceStealQuietest && a->levelCallback != NULL) voice = voiceAllocator_quietest(a, VoiceReleased);
+        else voice = a->head[VoiceReleased];
+    }
+    else if (a->stealing && a->head[VoiceHeld] >= 0)
+    {
+        if (a->stealMode == VoiceStealQuietest && a->levelCallback != NULL) voice = voiceAllocator_quietest(a, VoiceHeld);
+        else voice = a->head[VoiceHeld];
+        
+        // The note losing its voice stays held and waits for another
+        int oldNote = a->voiceNote[voice];
+        a->noteVoice[oldNote] = -1;
+        voiceAllocator_pushStolen(a, oldNote);
+        a->stolenNote = oldNote;
+    }
+    if (voice < 0) return -1;
+    
+    a->noteHeld[note] = 1;
+    a->noteVelocity[note] = velocity;
+    a->numHeld++;
+    voiceAllocator_assign(a, voice, note);
+    
+    return voice;
+}
+
+int     tVoiceAllocator_noteOff       (tVoiceAllocator* const alloc, int note)
+{
+    _tVoiceAllocator* a = *alloc;
+    
+    if (note < 0 || note > 127 || !a->noteHeld[note]) return -1;
+    a->noteHeld[note] = 0;
+    a->numHeld--;
+    
+    int voice = a->noteVoice[note];
+    if (voice < 0 || a->voiceState[voice] != VoiceHeld)
+    {
+        // Was waiting for a voice
+        if (voice < 0) voiceAllocator_removeStolen(a, note);
+        return -1;
+    }
+    
+    a->noteVoice[note] = -1;
+    a->voiceVelocity[voice] = 0;
+    if (voiceAllocator_recover(a, voice) >= 0) return -1;
+    
+    voiceAllocator_unlink(a, voice);
+    voiceAllocator_link(a, voice, VoiceFree);
+    return voice;
+}
+
+int     tVoiceAllocator_noteRelease   (tVoiceAllocator* const alloc, int note)
+{
+    _tVoiceAllocator* a = *alloc;
+    
+    if (note < 0 || note > 127 || !a->noteHeld[note]) return -1;
+    a->noteHeld[note] = 0;
+    a->numHeld--;
+    
+    int voice = a->noteVoice[note];
+    if (voice < 0 || a->voiceState[voice] != VoiceHeld)
+    {
+        if (voice < 0) voiceAllocator_removeStolen(a, note);
+        return -1;
+    }
+    
+    // Keep noteVoice pointing at the voice so the same note can find it again
+    a->voiceVelocity[voice] = 0;
+    voiceAllocator_unlink(a, voice);
+    voiceAllocator_link(a, voice, VoiceReleased);
+    return voice;
+}
+
+int     tVoiceAllocator_freeVoice     (tVoiceAllocator* const alloc, int voice)
+{
+    _tVoiceAllocator* a = *alloc;
+    
+    if (a->voiceState[voice] != VoiceReleased) return -1;
+    
+    int note = a->voiceNote[voice];
+    if (note >= 0 && a->noteVoice[note] == voice) a->noteVoice[note] = -1;
+    
+    int recovered = voiceAllocator_recover(a, voice);
+    if (recovered >= 0) return recovered;
+    
+    voiceAllocator_unlink(a, voice);
+    voiceAllocator_link(a, voice, VoiceFree);
+    return -1;
+}
+
+void    tVoiceAllocator_setNumVoices  (tVoiceAllocator* const alloc, int numVoices)
+{
+    _tVoiceAllocator* a = *alloc;
+    
+    if (numVoices > a->maxNumVoices) numVoices = a->maxNumVoices;
+    if (numVoices < 0) numVoices = 0;
+    int old = a->numVoices;
+    a->numVoices = numVoices;
+    
+    // Voices going out of range leave their lists but keep their state, voices coming back in rejoin theirs
+    for (int i = numVoices; i < old; ++i) voiceAllocator_unlink(a, i);
+    for (int i = old; i < numVoices; ++i)
+    {
+        if (a->voiceList[i] < 0) voiceAllocator_link(a, i, a->voiceState[i]);
+    }
+}
+
+void    tVoiceAllocator_setStealMode  (tVoiceAllocator* const alloc, VoiceStealMode mode)
+{
+    _tVoiceAllocator* a = *alloc;
+    a->stealMode = mode;
+}
+
+void    tVoiceAllocator_setStealing   (tVoiceAllocator* const alloc, int stealing, int recoverStolen)
+{
+    _tVoiceAllocator* a = *alloc;
+    a->stealing = stealing;
+    a->recoverStolen = recoverStolen;
+}
+
+void    tVoiceAllocator_setLevelCallback (tVoiceAllocator* const alloc, tVoiceLevelCallback callback, void* userData)
+{
+    _tVoiceAllocator* a = *alloc;
+    a->levelCallback = callback;
+    a->levelUserData = userData;
+}
+
+int     tVoiceAllocator_getVoice      (tVoiceAllocator* const alloc, int note)
+{
+    _tVoiceAllocator* a = *alloc;
+    if (note < 0 || note > 127) return -1;
+    return a->noteVoice[note];
+}
+
+int     tVoiceAllocator_getNote       (tVoiceAllocator* const alloc, int voice)
+{
+    _tVoiceAllocator* a = *alloc;
+    return a->voiceNote[voice];
+}
+
+int     tVoiceAllocator_getVelocity   (tVoiceAllocator* const alloc, int voice)
+{
+    _tVoiceAllocator* a = *alloc;
+    return a->voiceVelocity[voice];
+}
+
+VoiceState tVoiceAllocator_getState   (tVoiceAllocator* const alloc, int voice)
+{
+    _tVoiceAllocator* a = *alloc;
+    return (VoiceState) a->voiceState[voice];
+}
+
+int     tVoiceAllocator_getNumHeld    (tVoiceAllocator* const alloc)
+{
+    _tVoiceAllocator* a = *alloc;
+    return a->numHeld;
+}
+
+int     tVoiceAllocator_getStolenNote (tVoiceAllocator* const alloc)
+{
+    _tVoiceAllocator* a = *alloc;
+    return a->stolenNote;
+}
+
 // POLY
+
+#define POLY_BLOCK 64
+
+// The glide and MPE bend ramps of every voice step exactly like a tRamp ticked once per sample,
+// but live in arrays so all voices can be stepped in one loop
+static inline void tPoly_updateGlideFactor(_tPoly* const poly)
+{
+    float time = poly->glideTime < poly->invSampleRateMs ? poly->invSampleRateMs : poly->glideTime;
+    poly->glideFactor = (1.0f / time) * poly->invSampleRateMs * 1.0f;
+    for (int i = 0; i < poly->maxNumVoices; ++i)
+    {
+        poly->glideInc[i] = (poly->glideDest[i] - poly->glideCurr[i]) * poly->glideFactor;
+    }
+}
+
+static inline void tPoly_updateBendIncs(_tPoly* const poly)
+{
+    for (int i = 0; i < poly->maxNumVoices; ++i)
+    {
+        poly->bendInc[i] = (poly->bendDest[i] - poly->bendCurr[i]) * poly->pitchBendRamp->factor;
+    }
+}
+
+static inline void tPoly_step(float* const curr, float dest, float* const inc)
+{
+    *curr += *inc;
+    if (((*curr >= dest) && (*inc > 0.0f)) || ((*curr <= dest) && (*inc < 0.0f)))
+    {
+        *inc = 0.0f;
+        *curr = dest;
+    }
+}
+
+// Set a voice off towards a note it has just been given, along with its channel's expression
+static void tPoly_startVoice(_tPoly* const poly, int voice, int note, int stolen)
+{
+    if ((stolen && !poly->pitchGlideIsActive) || (!stolen && (!poly->firstReceived[voice] || !poly->pitchGlideIsActive)))
+    {
+        poly->glideCurr[voice] = note;
+        if (!stolen) poly->firstReceived[voice] = 1;
+    }
+    poly->glideDest[voice] = note;
+    poly->glideInc[voice] = (poly->glideDest[voice] - poly->glideCurr[voice]) * poly->glideFactor;
+
+    // The channel has usually been bent before the note on, so start from where it already is
+    int channel = poly->noteChannel[note];
+    poly->voiceChannel[voice] = channel;
+    poly->bendCurr[voice] = channel >= 0 ? poly->channelBend[channel] : 0.0f;
+    poly->bendDest[voice] = poly->bendCurr[voice];
+    poly->bendInc[voice] = 0.0f;
+    poly->voicePressure[voice] = channel >= 0 ? poly->channelPressure[channel] : 0.0f;
+    poly->voiceTimbre[voice] = channel >= 0 ? poly->channelTimbre[channel] : 0.0f;
+    
+    LEAF_quiescenceWake(&poly->voiceQuiet[voice]);
+}
+
 void tPoly_init(tPoly* const polyh, int maxNumVoices, LEAF* const leaf)
 {
     tPoly_initToPool(polyh, maxNumVoices, &leaf->mempool);
@@ -263,9 +640,11 @@ void tPoly_init(tPoly* const polyh, int maxNumVoices, LEAF* const leaf)
 
 void    tPoly_initToPool            (tPoly* const polyh, int maxNumVoices, tMempool* const mp)
 {
+    LEAF_PROFILE_POOL(mp);
     _tMempool* m = *mp;
     _tPoly* poly = *polyh = (_tPoly*) mpool_alloc(sizeof(_tPoly), m);
     poly->mempool = m;
+    LEAF* leaf = poly->mempool->leaf;
     
     poly->numVoices = maxNumVoices;
     poly->maxNumVoices = maxNumVoices;
@@ -276,53 +655,64 @@ void    tPoly_initToPool            (tPoly* const polyh, int maxNumVoices, tMemp
     poly->maxLength = 128;
     poly->currentNote = -1;
     
-    //default learned CCs and notes are just the CCs 1-128 - notes are skipped
-    for (int i = 0; i < 128; i++)
-    {
-        poly->notes[i][0] = 0;
-        poly->notes[i][1] = -1;
-    }
-    
     poly->glideTime = 5.0f;
+    poly->invSampleRateMs = 1.0f / (leaf->sampleRate * 0.001f);
     
-    poly->ramps = (tRamp*) mpool_alloc(sizeof(tRamp) * poly->maxNumVoices, m);
     poly->rampVals = (float*) mpool_alloc(sizeof(float) * poly->maxNumVoices, m);
     poly->firstReceived = (int*) mpool_alloc(sizeof(int) * poly->maxNumVoices, m);
-    poly->voices = (int**) mpool_alloc(sizeof(int*) * poly->maxNumVoices, m);
+    poly->glideCurr = (float*) mpool_calloc(sizeof(float) * poly->maxNumVoices, m);
+    poly->glideDest = (float*) mpool_calloc(sizeof(float) * poly->maxNumVoices, m);
+    poly->glideInc = (float*) mpool_calloc(sizeof(float) * poly->maxNumVoices, m);
+    poly->bendCurr = (float*) mpool_calloc(sizeof(float) * poly->maxNumVoices, m);
+    poly->bendDest = (float*) mpool_calloc(sizeof(float) * poly->maxNumVoices, m);
+    poly->bendInc = (float*) mpool_calloc(sizeof(float) * poly->maxNumVoices, m);
+    poly->voiceChannel = (int*) mpool_alloc(sizeof(int) * poly->maxNumVoices, m);
+    poly->voicePressure = (float*) mpool_calloc(sizeof(float) * poly->maxNumVoices, m);
+    poly->voiceTimbre = (float*) mpool_calloc(sizeof(float) * poly->maxNumVoices, m);
+    poly->voiceQuiet = (LEAFQuiescence*) mpool_alloc(sizeof(LEAFQuiescence) * poly->maxNumVoices, m);
     
     for (int i = 0; i < poly->maxNumVoices; ++i)
     {
-        poly->voices[i] = (int*) mpool_alloc(sizeof(int) * 2, m);
-        poly->voices[i][0] = -1;
         poly->firstReceived[i] = 0;
-        
-        tRamp_initToPool(&poly->ramps[i], poly->glideTime, 1, mp);
+        poly->voiceChannel[i] = -1;
+        LEAF_quiescenceInit(&poly->voiceQuiet[i], 0.0f, 0);
+    }
+    for (int i = 0; i < 128; ++i) poly->noteChannel[i] = -1;
+    for (int i = 0; i < 16; ++i)
+    {
+        poly->channelBend[i] = 0.0f;
+        poly->channelPressure[i] = 0.0f;
+        poly->channelTimbre[i] = 0.0f;
     }
     
     poly->pitchBend = 0.0f;
     
     tRamp_initToPool(&poly->pitchBendRamp, 1.0f, 1, mp);
-    tStack_initToPool(&poly->stack, mp);
+    tVoiceAllocator_initToPool(&poly->alloc, maxNumVoices, mp);
     tStack_initToPool(&poly->orderStack, mp);
     
     poly->pitchGlideIsActive = 0;
+    tPoly_updateGlideFactor(poly);
 }
 
 void    tPoly_free  (tPoly* const polyh)
 {
     _tPoly* poly = *polyh;
     
-    for (int i = 0; i < poly->maxNumVoices; i++)
-    {
-        tRamp_free(&poly->ramps[i]);
-        mpool_free((char*)poly->voices[i], poly->mempool);
-    }
     tRamp_free(&poly->pitchBendRamp);
-    tStack_free(&poly->stack);
+    tVoiceAllocator_free(&poly->alloc);
     tStack_free(&poly->orderStack);
     
-    mpool_free((char*)poly->voices, poly->mempool);
-    mpool_free((char*)poly->ramps, poly->mempool);
+    mpool_free((char*)poly->voiceQuiet, poly->mempool);
+    mpool_free((char*)poly->voiceTimbre, poly->mempool);
+    mpool_free((char*)poly->voicePressure, poly->mempool);
+    mpool_free((char*)poly->voiceChannel, poly->mempool);
+    mpool_free((char*)poly->bendInc, poly->mempool);
+    mpool_free((char*)poly->bendDest, poly->mempool);
+    mpool_free((char*)poly->bendCurr, poly->mempool);
+    mpool_free((char*)poly->glideInc, poly->mempool);
+    mpool_free((char*)poly->glideDest, poly->mempool);
+    mpool_free((char*)poly->glideCurr, poly->mempool);
     mpool_free((char*)poly->rampVals, poly->mempool);
     mpool_free((char*)poly->firstReceived, poly->mempool);
     
@@ -331,168 +721,180 @@ void    tPoly_free  (tPoly* const polyh)
 
 void tPoly_tickPitch(tPoly* polyh)
 {
+    LEAF_PROFILE_OBJECT(polyh);
     tPoly_tickPitchGlide(polyh);
     tPoly_tickPitchBend(polyh);
 }
 
 void tPoly_tickPitchGlide(tPoly* polyh)
 {
+    LEAF_PROFILE_OBJECT(polyh);
     _tPoly* poly = *polyh;
     for (int i = 0; i < poly->maxNumVoices; ++i)
     {
-        tRamp_tick(&poly->ramps[i]);
+        tPoly_step(&poly->glideCurr[i], poly->glideDest[i], &poly->glideInc[i]);
     }
 }
 
 void tPoly_tickPitchBend(tPoly* polyh)
 {
+    LEAF_PROFILE_OBJECT(polyh);
     _tPoly* poly = *polyh;
     tRamp_tick(&poly->pitchBendRamp);
+    for (int i = 0; i < poly->maxNumVoices; ++i)
+    {
+        tPoly_step(&poly->bendCurr[i], poly->bendDest[i], &poly->bendInc[i]);
+    }
 }
 
-void tPoly_setPitchBend(tPoly* const polyh, float pitchBend)
+void tPoly_tickPitchBlock(tPoly* const polyh, float** output, int size)
 {
+    LEAF_PROFILE_OBJECT(polyh);
     _tPoly* poly = *polyh;
-    poly->pitchBend = pitchBend;
-    tRamp_setDest(&poly->pitchBendRamp, poly->pitchBend);
-}
+    float bend[POLY_BLOCK];
 
-int tPoly_noteOn(tPoly* const polyh, int note, uint8_t vel)
-{
-    _tPoly* poly = *polyh;
-    
-    // if not in keymap or already on stack, dont do anything. else, add that note.
-    if (tStack_contains(&poly->stack, note) >= 0) return -1;
-    else
+    for (int start = 0; start < size; start += POLY_BLOCK)
     {
-        tPoly_orderedAddToStack(polyh, note);
-        tStack_add(&poly->stack, note);
-        
-        int alteredVoice = -1;
-        int found = 0;
-        for (int i = 0; i < poly->numVoices; i++)
+        int n = size - start < POLY_BLOCK ? size - start : POLY_BLOCK;
+        for (int k = 0; k < n; ++k) bend[k] = tRamp_tick(&poly->pitchBendRamp);
+
+        for (int i = 0; i < poly->maxNumVoices; ++i)
         {
-            if (poly->voices[i][0] < 0)    // if inactive voice, give this note to voice
+            float* out = output != NULL ? output[i] + start : NULL;
+            float glide = poly->glideCurr[i];
+            float voiceBend = poly->bendCurr[i];
+
+            if (poly->glideInc[i] == 0.0f && poly->bendInc[i] == 0.0f)
             {
-                if (!poly->firstReceived[i] || !poly->pitchGlideIsActive)
-                {
-                    tRamp_setVal(&poly->ramps[i], note);
-                    poly->firstReceived[i] = 1;
-                }
-                
-                found = 1;
-                
-                poly->voices[i][0] = note;
-                poly->voices[i][1] = vel;
-                poly->lastVoiceToChange = i;
-                poly->notes[note][0] = vel;
-                poly->notes[note][1] = i;
-                
-                tRamp_setDest(&poly->ramps[i], poly->voices[i][0]);
-                
-                alteredVoice = i;
-                break;
+                // Settled, which is most voices most of the time
+                if (out != NULL) for (int k = 0; k < n; ++k) out[k] = (glide + bend[k]) + voiceBend;
+                continue;
             }
-        }
-        
-        if (!found) //steal
-        {
-            int whichVoice, whichNote;
-            for (int j = tStack_getSize(&poly->stack) - 1; j >= 0; j--)
+
+            float glideInc = poly->glideInc[i];
+            float bendInc = poly->bendInc[i];
+            for (int k = 0; k < n; ++k)
             {
-                whichNote = tStack_get(&poly->stack, j);
-                whichVoice = poly->notes[whichNote][1];
-                if (whichVoice >= 0)
-                {
-                    poly->lastVoiceToChange = whichVoice;
-                    int oldNote = poly->voices[whichVoice][0];
-                    poly->voices[whichVoice][0] = note;
-                    poly->voices[whichVoice][1] = vel;
-                    poly->notes[oldNote][1] = -1; //mark the stolen voice as inactive (in the second dimension of the notes array)
-                    poly->notes[note][0] = vel;
-                    poly->notes[note][1] = whichVoice;
-                    
-                    if (poly->pitchGlideIsActive)
-                    {
-                    	tRamp_setTime(&poly->ramps[whichVoice], poly->glideTime);
-                    }
-                    else
-                    {
-                    	tRamp_setVal(&poly->ramps[whichVoice], note);
-                    }
-                    tRamp_setDest(&poly->ramps[whichVoice], poly->voices[whichVoice][0]);
-                    
-                    alteredVoice = whichVoice;
-                    
-                    break;
-                }
+                tPoly_step(&glide, poly->glideDest[i], &glideInc);
+                tPoly_step(&voiceBend, poly->bendDest[i], &bendInc);
+                if (out != NULL) out[k] = (glide + bend[k]) + voiceBend;
             }
+            poly->glideCurr[i] = glide;
+            poly->glideInc[i] = glideInc;
+            poly->bendCurr[i] = voiceBend;
+            poly->bendInc[i] = bendInc;
         }
-        return alteredVoice;
     }
 }
 
+void tPoly_setPitchBend(tPoly* const polyh, float pitchBend)
+{
+    _tPoly* poly = *polyh;
+    poly->pitchBend = pitchBend;
+    tRamp_setDest(&poly->pitchBendRamp, poly->pitchBend);
+}
+
+int tPoly_noteOn(tPoly* const polyh, int note, uint8_t vel)
+{
+    _tPoly* poly = *polyh;
+    
+    // if already held, dont do anything. else, give that note a voice.
+    if (note >= 0 && note < 128 && !poly->alloc->noteHeld[note]) poly->noteChannel[note] = -1;
+    int voice = tVoiceAllocator_noteOn(&poly->alloc, note, vel);
+    if (voice < 0) return -1;
+    
+    tPoly_orderedAddToStack(polyh, note);
+    tPoly_startVoice(poly, voice, note, tVoiceAllocator_getStolenNote(&poly->alloc) >= 0);
+    
+    poly->lastVoiceToChange = voice;
+    return voice;
+}
+
+int tPoly_noteOnMPE(tPoly* const polyh, int channel, int note, uint8_t vel)
+{
+    _tPoly* poly = *polyh;
+    
+    if (note < 0 || note > 127 || poly->alloc->noteHeld[note]) return -1;
+    poly->noteChannel[note] = channel & 15;
+    int voice = tVoiceAllocator_noteOn(&poly->alloc, note, vel);
+    if (voice < 0) return -1;
+    
+    tPoly_orderedAddToStack(polyh, note);
+    tPoly_startVoice(poly, voice, note, tVoiceAllocator_getStolenNote(&poly->alloc) >= 0);
+    
+    poly->lastVoiceToChange = voice;
+    return voice;
+}
 
-int16_t noteToTest = -1;
 
 int tPoly_noteOff(tPoly* const polyh, uint8_t note)
 {
     _tPoly* poly = *polyh;
     
-    tStack_remove(&poly->stack, note);
     tStack_remove(&poly->orderStack, note);
-    poly->notes[note][0] = 0;
-    poly->notes[note][1] = -1;
     
-    int deactivatedVoice = -1;
-    for (int i = 0; i < poly->maxNumVoices; i++)
+    int voice = tVoiceAllocator_getVoice(&poly->alloc, note);
+    int deactivatedVoice = tVoiceAllocator_noteOff(&poly->alloc, note);
+    if (deactivatedVoice >= 0)
     {
-        if (poly->voices[i][0] == note)
-        {
-            poly->voices[i][0] = -1;
-            poly->voices[i][1] = 0;
-            poly->lastVoiceToChange = i;
-            deactivatedVoice = i;
-            break;
-        }
+        poly->lastVoiceToChange = deactivatedVoice;
+        return deactivatedVoice;
     }
-    /*
-     //monophonic handling
-     if ((poly->numVoices == 1) && (tStack_getSize(poly->stack) > 0))
-     {
-     int oldNote = tStack_first(poly->stack);
-     poly->voices[0][0] = oldNote;
-     poly->voices[0][1] = poly->notes[oldNote][0];
-     poly->lastVoiceToChange = 0;
-     }
-     */
-    
-    //grab old notes off the stack if there are notes waiting to replace the free voice
-    if (deactivatedVoice >= 0)
+    
+    //the freed voice went straight to a stolen note that was waiting for one
+    if (voice >= 0)
     {
-        for (int j = 0; j < tStack_getSize(&poly->stack); ++j)
-        {
-            noteToTest = tStack_get(&poly->stack, j);
-            
-            if (poly->notes[noteToTest][1] < 0) //if there is a stolen note waiting (marked inactive but on the stack)
-            {
-                poly->voices[deactivatedVoice][0] = noteToTest; //set the newly free voice to use the old stolen note
-                if (poly->pitchGlideIsActive)
-                {
-                	tRamp_setTime(&poly->ramps[deactivatedVoice], poly->glideTime);
-                }
-                else
-                {
-                	tRamp_setVal(&poly->ramps[deactivatedVoice], noteToTest);
-                }
-                tRamp_setDest(&poly->ramps[deactivatedVoice], poly->voices[deactivatedVoice][0]);
-                poly->voices[deactivatedVoice][1] = poly->notes[noteToTest][0]; // set the velocity of the voice to be the velocity of that note
-                poly->notes[noteToTest][1] = deactivatedVoice; //mark that it is no longer stolen and is now active
-                return -1;
-            }
-        }
+        tPoly_startVoice(poly, voice, tVoiceAllocator_getNote(&poly->alloc, voice), 1);
+        poly->lastVoiceToChange = voice;
+    }
+    return -1;
+}
+
+int tPoly_noteOffMPE(tPoly* const polyh, int channel, int note)
+{
+    _tPoly* poly = *polyh;
+
+    // Only end the note if it is the one that came in on this channel
+    if (note < 0 || note > 127 || poly->noteChannel[note] != (channel & 15)) return -1;
+    return tPoly_noteOff(polyh, note);
+}
+
+void tPoly_setChannelPitchBend(tPoly* const polyh, int channel, float pitchBend)
+{
+    _tPoly* poly = *polyh;
+
+    channel &= 15;
+    poly->channelBend[channel] = pitchBend;
+    for (int i = 0; i < poly->maxNumVoices; ++i)
+    {
+        if (poly->voiceChannel[i] != channel) continue;
+        poly->bendDest[i] = pitchBend;
+        poly->bendInc[i] = (pitchBend - poly->bendCurr[i]) * poly->pitchBendRamp->factor;
+    }
+}
+
+void tPoly_setChannelPressure(tPoly* const polyh, int channel, float pressure)
+{
+    _tPoly* poly = *polyh;
+
+    channel &= 15;
+    poly->channelPressure[channel] = pressure;
+    for (int i = 0; i < poly->maxNumVoices; ++i)
+    {
+        if (poly->voiceChannel[i] == channel) poly->voicePressure[i] = pressure;
+    }
+}
+
+void tPoly_setChannelTimbre(tPoly* const polyh, int channel, float timbre)
+{
+    _tPoly* poly = *polyh;
+
+    channel &= 15;
+    poly->channelTimbre[channel] = timbre;
+    for (int i = 0; i < poly->maxNumVoices; ++i)
+    {
+        if (poly->voiceChannel[i] == channel) poly->voiceTimbre[i] = timbre;
     }
-    return deactivatedVoice;
 }
 
 void tPoly_orderedAddToStack(tPoly* const polyh, uint8_t noteVal)
@@ -539,6 +941,7 @@ void tPoly_setNumVoices(tPoly* const polyh, uint8_t numVoices)
 {
     _tPoly* poly = *polyh;
     poly->numVoices = (numVoices > poly->maxNumVoices) ? poly->maxNumVoices : numVoices;
+    tVoiceAllocator_setNumVoices(&poly->alloc, poly->numVoices);
 }
 
 void tPoly_setPitchGlideActive(tPoly* const polyh, int isActive)
@@ -551,16 +954,14 @@ void tPoly_setPitchGlideTime(tPoly* const polyh, float t)
 {
     _tPoly* poly = *polyh;
     poly->glideTime = t;
-    for (int i = 0; i < poly->maxNumVoices; ++i)
-    {
-        tRamp_setTime(&poly->ramps[i], poly->glideTime);
-    }
+    tPoly_updateGlideFactor(poly);
 }
 
 void tPoly_setBendGlideTime(tPoly* const polyh, float t)
 {
     _tPoly* poly = *polyh;
     tRamp_setTime(&poly->pitchBendRamp, t);
+    tPoly_updateBendIncs(poly);
 }
 
 void tPoly_setBendSamplesPerTick(tPoly* const polyh, float t)
@@ -578,41 +979,93 @@ int tPoly_getNumVoices(tPoly* const polyh)
 int tPoly_getNumActiveVoices(tPoly* const polyh)
 {
     _tPoly* poly = *polyh;
-    return LEAF_clip(0, tStack_getSize(&poly->stack), poly->numVoices);
+    return LEAF_clip(0, tVoiceAllocator_getNumHeld(&poly->alloc), poly->numVoices);
 }
 
 float tPoly_getPitch(tPoly* const polyh, uint8_t voice)
 {
     _tPoly* poly = *polyh;
-    return tRamp_sample(&poly->ramps[voice]) + tRamp_sample(&poly->pitchBendRamp);
+    return (poly->glideCurr[voice] + tRamp_sample(&poly->pitchBendRamp)) + poly->bendCurr[voice];
 }
 
 int tPoly_getKey(tPoly* const polyh, uint8_t voice)
 {
     _tPoly* poly = *polyh;
-    return poly->voices[voice][0];
+    if (tVoiceAllocator_getState(&poly->alloc, voice) != VoiceHeld) return -1;
+    return tVoiceAllocator_getNote(&poly->alloc, voice);
 }
 
 int tPoly_getVelocity(tPoly* const polyh, uint8_t voice)
 {
     _tPoly* poly = *polyh;
-    return poly->voices[voice][1];
+    return tVoiceAllocator_getVelocity(&poly->alloc, voice);
 }
 
 int tPoly_isOn(tPoly* const polyh, uint8_t voice)
 {
     _tPoly* poly = *polyh;
-    return (poly->voices[voice][0] > 0) ? 1 : 0;
+    return tVoiceAllocator_getState(&poly->alloc, voice) == VoiceHeld;
+}
+
+void tPoly_setQuiescence(tPoly* const polyh, float threshold, int holdSamples)
+{
+    _tPoly* poly = *polyh;
+    for (int i = 0; i < poly->maxNumVoices; ++i) LEAF_quiescenceInit(&poly->voiceQuiet[i], threshold, holdSamples);
+}
+
+int tPoly_beginVoiceBlock(tPoly* const polyh, uint8_t voice, float* output, int size)
+{
+    _tPoly* poly = *polyh;
+    LEAFQuiescence* q = &poly->voiceQuiet[voice];
+    
+    // A held note keeps its voice awake, however quiet it is
+    if (tPoly_isOn(polyh, voice)) LEAF_quiescenceWake(q);
+    if (!LEAF_quiescenceBegin(q, NULL, 1, size)) return 0;
+    
+    for (int i = 0; i < size; ++i) output[i] = 0.0f;
+    return 1;
+}
+
+void tPoly_endVoiceBlock(tPoly* const polyh, uint8_t voice, const float* output, int size)
+{
+    _tPoly* poly = *polyh;
+    LEAFQuiescence* q = &poly->voiceQuiet[voice];
+    
+    LEAF_quiescenceHear(q, output, 1, size);
+    LEAF_quiescenceEnd(q, size);
+}
+
+int tPoly_isVoiceQuiescent(tPoly* const polyh, uint8_t voice)
+{
+    _tPoly* poly = *polyh;
+    return !tPoly_isOn(polyh, voice) && LEAF_quiescenceIsQuiet(&poly->voiceQuiet[voice]);
+}
+
+int tPoly_getChannel(tPoly* const polyh, uint8_t voice)
+{
+    _tPoly* poly = *polyh;
+    return poly->voiceChannel[voice];
+}
+
+float tPoly_getPressure(tPoly* const polyh, uint8_t voice)
+{
+    _tPoly* poly = *polyh;
+    return poly->voicePressure[voice];
+}
+
+float tPoly_getTimbre(tPoly* const polyh, uint8_t voice)
+{
+    _tPoly* poly = *polyh;
+    return poly->voiceTimbre[voice];
 }
 
 void tPoly_setSampleRate(tPoly* const polyh, float sr)
 {
     _tPoly* poly = *polyh;
-    for (int i = 0; i < poly->maxNumVoices; i++)
-    {
-        tRamp_setSampleRate(&poly->ramps[i], sr);
-    }
+    poly->invSampleRateMs = 1.0f / (sr * 0.001f);
+    tPoly_updateGlideFactor(poly);
     tRamp_setSampleRate(&poly->pitchBendRamp, sr);
+    tPoly_updateBendIncs(poly);
 }
 
 
@@ -627,119 +1080,33 @@ void tSimplePoly_init(tSimplePoly* const polyh, int maxNumVoices, LEAF* const le
 
 void    tSimplePoly_initToPool            (tSimplePoly* const polyh, int maxNumVoices, tMempool* const mp)
 {
+    LEAF_PROFILE_POOL(mp);
     _tMempool* m = *mp;
     _tSimplePoly* poly = *polyh = (_tSimplePoly*) mpool_alloc(sizeof(_tSimplePoly), m);
     poly->mempool = m;
-
+    
     poly->numVoices = maxNumVoices;
     poly->maxNumVoices = maxNumVoices;
-
-    for (int i = 0; i < 128; i++)
-    {
-        poly->notes[i][0] = -1;
-        poly->notes[i][1] = 0;
-    }
+    
     poly->stealing_on = 1;
     poly->recover_stolen = 1;
-    poly->voices = (int**) mpool_calloc(sizeof(int*) * poly->maxNumVoices, m);
-
-    for (int i = 0; i < poly->maxNumVoices; ++i)
-    {
-        poly->voices[i] = (int*) mpool_calloc(sizeof(int) * 3, m);
-        poly->voices[i][0] = -1;
-    }
-    tStack_initToPool(&poly->stack, mp);
-
+    tVoiceAllocator_initToPool(&poly->alloc, maxNumVoices, mp);
 }
 
 void    tSimplePoly_free  (tSimplePoly* const polyh)
 {
     _tSimplePoly* poly = *polyh;
-
-    for (int i = 0; i < poly->maxNumVoices; i++)
-    {
-        mpool_free((char*)poly->voices[i], poly->mempool);
-    }
-    tStack_free(&poly->stack);
-    mpool_free((char*)poly->voices, poly->mempool);
+    
+    tVoiceAllocator_free(&poly->alloc);
     mpool_free((char*)poly, poly->mempool);
 }
 
 int tSimplePoly_noteOn(tSimplePoly* const polyh, int note, uint8_t vel)
 {
     _tSimplePoly* poly = *polyh;
-    int whichVoice, whichNote, oldNote, alteredVoice;
-    // if not in keymap or already on stack, dont do anything. else, add that note.
-    if (tStack_contains(&poly->stack, note) >= 0) return -1;
-    else
-    {
-        alteredVoice = -1;
-        int found = 0;
-        for (int i = 0; i < poly->numVoices; i++)
-        {
-            if (poly->voices[i][0] == -1)    // if inactive voice, give this note to voice
-            {
-
-                found = 1;
-
-                poly->voices[i][0] = note;
-                poly->voices[i][1] = vel;
-                poly->notes[note][0] = i;
-                poly->notes[note][1] = vel;
-                poly->voices[i][2] = note; // voices[i][2] is the output midi note, (avoiding the -1 when a voice is inactive)
-
-                alteredVoice = i;
-                tStack_add(&poly->stack, note);
-                break;
-            }
-        }
-        if (!found)
-        {
-            //second preference is grabbing one that is in release phase but not finished sounding yet
-            for (int i = 0 ; i < poly->numVoices; i++)
-            {
-                if (poly->voices[i][0] == -2)    // if voice is released but still sounding, take over this voice
-                {
-
-                    found = 1;
-
-                    poly->voices[i][0] = note;
-                    poly->voices[i][1] = vel;
-                    poly->notes[note][0] = i;
-                    poly->notes[note][1] = vel;
-                    poly->voices[i][2] = note; // voices[i][2] is the output midi note, (avoiding the -1 when a voice is inactive)
-
-                    alteredVoice = i;
-                    tStack_add(&poly->stack, note);
-                    break;
-                }
-            }
-        }
-        if ((!found) && (poly->stealing_on)) //steal
-        {
-            for (int j = tStack_getSize(&poly->stack) - 1; j >= 0; j--)
-            {
-                whichNote = tStack_get(&poly->stack, j);
-                whichVoice = poly->notes[whichNote][0];
-                if (whichVoice >= 0)
-                {
-                    oldNote = poly->voices[whichVoice][0];
-                    poly->voices[whichVoice][0] = note;
-                    poly->voices[whichVoice][1] = vel;
-                    poly->notes[oldNote][0] = -3; //mark the stolen voice as stolen (in the second dimension of the notes array)
-                    poly->notes[note][0] = whichVoice;
-                    poly->notes[note][1] = vel;
-
-                    poly->voices[whichVoice][2] = note;
-
-                    alteredVoice = whichVoice;
-                    tStack_add(&poly->stack, note);
-                    break;
-                }
-            }
-        }
-        return alteredVoice;
-    }
+    // free voices first, then ones in release phase but not finished sounding yet, then steal if stealing is on
+    tVoiceAllocator_setStealing(&poly->alloc, poly->stealing_on, poly->recover_stolen);
+    return tVoiceAllocator_noteOn(&poly->alloc, note, vel);
 }
 
 
@@ -747,125 +1114,39 @@ int tSimplePoly_noteOn(tSimplePoly* const polyh, int note, uint8_t vel)
 int tSimplePoly_noteOff(tSimplePoly* const polyh, uint8_t note)
 {
     _tSimplePoly* poly = *polyh;
-    int16_t noteToTest = -1;
-
-    tStack_remove(&poly->stack, note);
-    poly->notes[note][0] = -1;
-
-    int deactivatedVoice = -1;
-    for (int i = 0; i < poly->maxNumVoices; i++)
-    {
-        if (poly->voices[i][0] == note)
-        {
-            poly->voices[i][0] = -1;
-            poly->voices[i][1] = 0;
-            deactivatedVoice = i;
-            break;
-        }
-    }
-
-    if (poly->recover_stolen)
-    {
-        //grab old notes off the stack if there are notes waiting to replace the free voice
-        if (deactivatedVoice >= 0)
-        {
-            for (int j = 0; j < tStack_getSize(&poly->stack); ++j)
-            {
-                noteToTest = tStack_get(&poly->stack, j);
-
-                if (poly->notes[noteToTest][0] == -3) //if there is a stolen note waiting (marked inactive but on the stack)
-                {
-                    poly->voices[deactivatedVoice][0] = noteToTest; //set the newly free voice to use the old stolen note
-                    poly->voices[deactivatedVoice][1] = poly->notes[noteToTest][1]; // set the velocity of the voice to be the velocity of that note
-                    poly->voices[deactivatedVoice][2] = noteToTest;
-                    poly->notes[noteToTest][0] = deactivatedVoice; //mark that it is no longer stolen and is now active
-                    return -1;
-                }
-            }
-        }
-    }
-    return deactivatedVoice;
+    tVoiceAllocator_setStealing(&poly->alloc, poly->stealing_on, poly->recover_stolen);
+    return tVoiceAllocator_noteOff(&poly->alloc, note);
 }
 
 
 void tSimplePoly_deactivateVoice(tSimplePoly* const polyh, uint8_t voice)
 {
     _tSimplePoly* poly = *polyh;
-
-    if (poly->voices[voice][0] == -2) //only do this if the voice is waiting for deactivation (not already reassigned while waiting)
-    {
-        poly->voices[voice][0] = -1;
-        poly->voices[voice][1] = 0;
-        if (poly->recover_stolen)
-        {
-            //grab old notes off the stack if there are notes waiting to replace the free voice
-            for (int j = 0; j < tStack_getSize(&poly->stack); ++j)
-            {
-                noteToTest = tStack_get(&poly->stack, j);
-
-                if (poly->notes[noteToTest][0] == -3) //if there is a stolen note waiting (marked inactive but on the stack)
-                {
-                    poly->voices[voice][0] = noteToTest; //set the newly free voice to use the old stolen note
-                    poly->voices[voice][1] = poly->notes[noteToTest][1]; // set the velocity of the voice to be the velocity of that note
-                    poly->voices[voice][2] = noteToTest;
-                    poly->notes[noteToTest][0] = voice; //mark that it is no longer stolen and is now active
-                }
-            }
-        }
-    }
+    //only does anything if the voice is waiting for deactivation (not already reassigned while waiting)
+    tVoiceAllocator_setStealing(&poly->alloc, poly->stealing_on, poly->recover_stolen);
+    tVoiceAllocator_freeVoice(&poly->alloc, voice);
 }
 
 int tSimplePoly_findVoiceAssignedToNote(tSimplePoly* const polyh, uint8_t note)
 {
     _tSimplePoly* poly = *polyh;
-
-
-    int voiceWithThatNote = -1;
-    for (int i = 0; i < poly->maxNumVoices; i++)
-    {
-        if (poly->voices[i][0] == note)
-        {
-            voiceWithThatNote = i;
-            break;
-        }
-    }
-    return voiceWithThatNote;
+    int voice = tVoiceAllocator_getVoice(&poly->alloc, note);
+    if (voice >= 0 && tVoiceAllocator_getState(&poly->alloc, voice) != VoiceHeld) voice = -1;
+    return voice;
 }
 
 
 int tSimplePoly_markPendingNoteOff(tSimplePoly* const polyh, uint8_t note)
 {
     _tSimplePoly* poly = *polyh;
-    int deactivatedVoice = -1;
-
-    if (tStack_remove(&poly->stack, note))
-
-    {
-
-        poly->notes[note][0] = -2;
-
-
-
-        for (int i = 0; i < poly->maxNumVoices; i++)
-        {
-            if (poly->voices[i][0] == note)
-            {
-                poly->voices[i][0] = -2;
-                poly->voices[i][1] = 0;
-                deactivatedVoice = i;
-                break;
-            }
-        }
-
-
-    }
-    return deactivatedVoice;
+    return tVoiceAllocator_noteRelease(&poly->alloc, note);
 }
 
 void tSimplePoly_setNumVoices(tSimplePoly* const polyh, uint8_t numVoices)
 {
     _tSimplePoly* poly = *polyh;
     poly->numVoices = (numVoices > poly->maxNumVoices) ? poly->maxNumVoices : numVoices;
+    tVoiceAllocator_setNumVoices(&poly->alloc, poly->numVoices);
 }
 
 
@@ -878,31 +1159,36 @@ int tSimplePoly_getNumVoices(tSimplePoly* const polyh)
 int tSimplePoly_getNumActiveVoices(tSimplePoly* const polyh)
 {
     _tSimplePoly* poly = *polyh;
-    return LEAF_clip(0, tStack_getSize(&poly->stack), poly->numVoices);
+    return LEAF_clip(0, tVoiceAllocator_getNumHeld(&poly->alloc), poly->numVoices);
 }
 
 
 int tSimplePoly_getPitch(tSimplePoly* const polyh, uint8_t voice)
 {
     _tSimplePoly* poly = *polyh;
-    return poly->voices[voice][2];
+    // the output midi note, kept through the release (avoiding the -1 when a voice is inactive)
+    int note = tVoiceAllocator_getNote(&poly->alloc, voice);
+    return note < 0 ? 0 : note;
 }
 
 //this one returns negative one if the voice is inactive
 int tSimplePoly_getPitchAndCheckActive(tSimplePoly* const polyh, uint8_t voice)
 {
     _tSimplePoly* poly = *polyh;
-    return poly->voices[voice][0];
+    VoiceState state = tVoiceAllocator_getState(&poly->alloc, voice);
+    if (state == VoiceReleased) return -2;
+    if (state == VoiceFree) return -1;
+    return tVoiceAllocator_getNote(&poly->alloc, voice);
 }
 
 int tSimplePoly_getVelocity(tSimplePoly* const polyh, uint8_t voice)
 {
     _tSimplePoly* poly = *polyh;
-    return poly->voices[voice][1];
+    return tVoiceAllocator_getVelocity(&poly->alloc, voice);
 }
 
 int tSimplePoly_isOn(tSimplePoly* const polyh, uint8_t voice)
 {
     _tSimplePoly* poly = *polyh;
-    return (poly->voices[voice][0] > 0) ? 1 : 0;
+    return tVoiceAllocator_getState(&poly->alloc, voice) == VoiceHeld;
 }
@@ -16,6 +16,20 @@
 
 #endif
 
+#if LEAF_USE_SIMD
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define LEAF_SIMD_NEON 1
+#elif defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define LEAF_SIMD_SSE 1
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define LEAF_SIMD_SSE2 1
+#endif
+#endif
+#endif
+
 #if LEAF_INCLUDE_SINE_TABLE
 // Cycle
 void    tCycle_init(tCycle* const cy, LEAF* const leaf)
@@ -25,14 +39,20 @@ void    tCycle_init(tCycle* const cy, LEAF* const leaf)
 
 void    tCycle_initToPool   (tCycle* const cy, tMempool* const mp)
 {
+    LEAF_PROFILE_POOL(mp);
     _tMempool* m = *mp;
     _tCycle* c = *cy = (_tCycle*) mpool_alloc(sizeof(_tCycle), m);
     c->mempool = m;
     LEAF* leaf = c->mempool->leaf;
     
+    c->table = LEAF_getSineTable(leaf);
     c->inc      =  0.0f;
     c->phase    =  0.0f;
+    c->freq     =  0.0f;
     c->invSampleRate = leaf->invSampleRate;
+    
+    LEAF_controlRateInit(&c->control, 1, 0.0f);
+    if (leaf->controlRate > 1) tCycle_setControlRate(cy, leaf->controlRate);
 }
 
 void    tCycle_free (tCycle* const cy)
@@ -50,37 +70,49 @@ void     tCycle_setFreq(tCycle* const cy, float freq)
     
     c->freq  = freq;
 
-    c->inc = freq * c->invSampleRate;
+    c->inc = (leaf_coeff_t) freq * c->invSampleRate;
     c->inc -= (int)c->inc;
 }
 
 //need to check bounds and wrap table properly to allow through-zero FM
-float   tCycle_tick(tCycle* const cy)
+static inline float cycle_read(_tCycle* const c)
 {
-    _tCycle* c = *cy;
-    float temp;
+    leaf_coeff_t temp;
     int idx;
     float frac;
     float samp0;
     float samp1;
     
-    // Phasor increment
-    c->phase += c->inc;
-    if (c->phase >= 1.0f) c->phase -= 1.0f;
-    if (c->phase < 0.0f) c->phase += 1.0f;
-
     // Wavetable synthesis
 
     temp = SINE_TABLE_SIZE * c->phase;
     idx = (int)temp;
-    frac = temp - (float)idx;
-    samp0 = __leaf_table_sinewave[idx];
+    frac = (float) (temp - idx);
+    samp0 = LEAF_TABLE_READ(c->table, idx);
     if (++idx >= SINE_TABLE_SIZE) idx = 0;
-    samp1 = __leaf_table_sinewave[idx];
+    samp1 = LEAF_TABLE_READ(c->table, idx);
 
     return (samp0 + (samp1 - samp0) * frac);
 }
 
+static inline float cycle_tick(_tCycle* const c)
+{
+    // Phasor increment
+    c->phase += c->inc;
+    if (c->phase >= 1.0f) c->phase -= 1.0f;
+    if (c->phase < 0.0f) c->phase += 1.0f;
+    
+    return cycle_read(c);
+}
+
+float   tCycle_tick(tCycle* const cy)
+{
+    LEAF_PROFILE_OBJECT(cy);
+    _tCycle* c = *cy;
+    
+    return cycle_tick(c);
+}
+
 void     tCycle_setSampleRate (tCycle* const cy, float sr)
 {
     _tCycle* c = *cy;
@@ -88,6 +120,39 @@ void     tCycle_setSampleRate (tCycle* const cy, float sr)
     c->invSampleRate = 1.0f/sr;
     tCycle_setFreq(cy, c->freq);
 }
+
+void    tCycle_tickBlock (tCycle* const cy, float* output, int size)
+{
+    LEAF_PROFILE_OBJECT(cy);
+    _tCycle* c = *cy;
+    
+    if (c->control.divider == 1)
+    {
+        for (int i = 0; i < size; i++) output[i] = cycle_tick(c);
+        if (size > 0) c->control.value = output[size - 1];
+        return;
+    }
+    
+    // The phase increment stays per sample, so each control tick steps it a whole period
+    float step = c->inc * (float) c->control.divider;
+    for (int i = 0; i < size; )
+    {
+        if (c->control.count == 0)
+        {
+            c->phase += step;
+            c->phase -= floorf(c->phase);
+            LEAF_controlRateSetTarget(&c->control, cycle_read(c));
+        }
+        i += LEAF_controlRateFill(&c->control, output + i, size - i);
+    }
+}
+
+void    tCycle_setControlRate (tCycle* const cy, int divider)
+{
+    _tCycle* c = *cy;
+    
+    LEAF_controlRateInit(&c->control, divider, c->control.value);
+}
 #endif // LEAF_INCLUDE_SINE_TABLE
 
 #if LEAF_INCLUDE_TRIANGLE_TABLE
@@ -100,6 +165,7 @@ void   tTriangle_init(tTriangle* const cy, LEAF* const leaf)
 
 void    tTriangle_initToPool    (tTriangle* const cy, tMempool* const mp)
 {
+    LEAF_PROFILE_POOL(mp);
     _tMempool* m = *mp;
     _tTriangle* c = *cy = (_tTriangle*) mpool_alloc(sizeof(_tTriangle), m);
     c->mempool = m;
@@ -140,6 +206,7 @@ void tTriangle_setFreq(tTriangle* const cy, float freq)
 
 float   tTriangle_tick(tTriangle* const cy)
 {
+    LEAF_PROFILE_OBJECT(cy);
     _tTriangle* c = *cy;
     
     float temp;
@@ -193,6 +260,7 @@ void   tSquare_init(tSquare* const cy, LEAF* const leaf)
 
 void    tSquare_initToPool  (tSquare* const cy, tMempool* const mp)
 {
+    LEAF_PROFILE_POOL(mp);
     _tMempool* m = *mp;
     _tSquare* c = *cy = (_tSquare*) mpool_alloc(sizeof(_tSquare), m);
     c->mempool = m;
@@ -232,6 +300,7 @@ void    tSquare_setFreq(tSquare* const cy, float freq)
 
 float   tSquare_tick(tSquare* const cy)
 {
+    LEAF_PROFILE_OBJECT(cy);
     _tSquare* c = *cy;
     
     float temp;
@@ -285,6 +354,7 @@ void    tSawtooth_init(tSawtooth* const cy, LEAF* const leaf)
 
 void    tSawtooth_initToPool    (tSawtooth* const cy, tMempool* const mp)
 {
+    LEAF_PROFILE_POOL(mp);
     _tMempool* m = *mp;
     _tSawtooth* c = *cy = (_tSawtooth*) mpool_alloc(sizeof(_tSawtooth), m);
     c->mempool = m;
@@ -324,6 +394,7 @@ void    tSawtooth_setFreq(tSawtooth* const cy, float freq)
 
 float   tSawtooth_tick(tSawtooth* const cy)
 {
+    LEAF_PROFILE_OBJECT(cy);
     _tSawtooth* c = *cy;
     
     float temp;
@@ -377,6 +448,7 @@ void    tPBTriangle_init          (tPBTriangle* const osc, LEAF* const leaf)
 
 void    tPBTriangle_initToPool    (tPBTriangle* const osc, tMempool* const mp)
 {
+    LEAF_PROFILE_POOL(mp);
     _tMempool* m = *mp;
     _tPBTriangle* c = *osc = (_tPBTriangle*) mpool_alloc(sizeof(_tPBTriangle), m);
     c->mempool = m;
@@ -398,6 +470,7 @@ void    tPBTriangle_free (tPBTriangle* const cy)
 
 float   tPBTriangle_tick          (tPBTriangle* const osc)
 {
+    LEAF_PROFILE_OBJECT(osc);
     _tPBTriangle* c = *osc;
     
     float out;
@@ -460,6 +533,7 @@ void    tPBPulse_init        (tPBPulse* const osc, LEAF* const leaf)
 
 void    tPBPulse_initToPool  (tPBPulse* const osc, tMempool* const mp)
 {
+    LEAF_PROFILE_POOL(mp);
     _tMempool* m = *mp;
     _tPBPulse* c = *osc = (_tPBPulse*) mpool_alloc(sizeof(_tPBPulse), m);
     c->mempool = m;
@@ -480,6 +554,7 @@ void    tPBPulse_free (tPBPulse* const osc)
 
 float   tPBPulse_tick        (tPBPulse* const osc)
 {
+    LEAF_PROFILE_OBJECT(osc);
     _tPBPulse* c = *osc;
     
     float out;
@@ -527,6 +602,7 @@ void    tPBSaw_init          (tPBSaw* const osc, LEAF* const leaf)
 
 void    tPBSaw_initToPool    (tPBSaw* const osc, tMempool* const mp)
 {
+    LEAF_PROFILE_POOL(mp);
     _tMempool* m = *mp;
     _tPBSaw* c = *osc = (_tPBSaw*) mpool_alloc(sizeof(_tPBSaw), m);
     c->mempool = m;
@@ -546,6 +622,7 @@ void    tPBSaw_free  (tPBSaw* const osc)
 
 float   tPBSaw_tick          (tPBSaw* const osc)
 {
+    LEAF_PROFILE_OBJECT(osc);
     _tPBSaw* c = *osc;
     
     float out = (c->phase * 2.0f) - 1.0f;
@@ -584,6 +661,7 @@ void    tPhasor_init(tPhasor* const ph, LEAF* const leaf)
 
 void    tPhasor_initToPool  (tPhasor* const ph, tMempool* const mp)
 {
+    LEAF_PROFILE_POOL(mp);
     _tMempool* m = *mp;
     _tPhasor* p = *ph = (_tPhasor*) mpool_alloc(sizeof(_tPhasor), m);
     p->mempool = m;
@@ -614,6 +692,7 @@ void    tPhasor_setFreq(tPhasor* const ph, float freq)
 
 float   tPhasor_tick(tPhasor* const ph)
 {
+    LEAF_PROFILE_OBJECT(ph);
     _tPhasor* p = *ph;
     
     p->phase += p->inc;
@@ -650,13 +729,18 @@ void    tNoise_init(tNoise* const ns, NoiseType type, LEAF* const leaf)
 
 void    tNoise_initToPool   (tNoise* const ns, NoiseType type, tMempool* const mp)
 {
+    LEAF_PROFILE_POOL(mp);
     _tMempool* m = *mp;
     _tNoise* n = *ns = (_tNoise*) mpool_alloc(sizeof(_tNoise), m);
     n->mempool = m;
     LEAF* leaf = n->mempool->leaf;
     
     n->type = type;
-    n->rand = leaf->random;
+    n->pinkb0 = n->pinkb1 = n->pinkb2 = 0.0f;
+    n->rand = NULL;
+    
+    // Seed from the LEAF random function so voices start out different, or use a fixed seed without one
+    tNoise_setSeed(ns, leaf->random != NULL ? (uint32_t) (leaf->random() * 4294967295.0f) : 0);
 }
 
 void    tNoise_free (tNoise* const ns)
@@ -666,11 +750,47 @@ void    tNoise_free (tNoise* const ns)
     mpool_free((char*)n, n->mempool);
 }
 
+// One step of a lane's xorshift32, scaled from a signed 32 bit integer to [-1, 1)
+static inline float noise_next(_tNoise* const n)
+{
+    uint32_t x = n->state[n->lane];
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    n->state[n->lane] = x;
+    n->lane = (n->lane + 1) & 3;
+    return (float) (int32_t) x * 4.656612873e-10f;
+}
+
+void    tNoise_setSeed (tNoise* const ns, uint32_t seed)
+{
+    _tNoise* n = *ns;
+    
+    // splitmix32 spreads one seed over the four lanes. xorshift gets stuck at zero, so no lane may start there
+    for (int i = 0; i < 4; i++)
+    {
+        uint32_t z = (seed += 0x9E3779B9u);
+        z = (z ^ (z >> 16)) * 0x85EBCA6Bu;
+        z = (z ^ (z >> 13)) * 0xC2B2AE35u;
+        z ^= z >> 16;
+        n->state[i] = z != 0 ? z : 0x6D2B79F5u;
+    }
+    n->lane = 0;
+}
+
+void    tNoise_setRandomFunction (tNoise* const ns, float (*random)(void))
+{
+    _tNoise* n = *ns;
+    
+    n->rand = random;
+}
+
 float   tNoise_tick(tNoise* const ns)
 {
+    LEAF_PROFILE_OBJECT(ns);
     _tNoise* n = *ns;
     
-    float rand = (n->rand() * 2.0f) - 1.0f;
+    float rand = n->rand != NULL ? (n->rand() * 2.0f) - 1.0f : noise_next(n);
     
     if (n->type == PinkNoise)
     {
@@ -687,6 +807,69 @@ float   tNoise_tick(tNoise* const ns)
     }
 }
 
+void    tNoise_tickBlock (tNoise* const ns, float* output, int size)
+{
+    LEAF_PROFILE_OBJECT(ns);
+    _tNoise* n = *ns;
+    int i = 0;
+    
+    if (n->rand != NULL)
+    {
+        for (; i < size; i++) output[i] = (n->rand() * 2.0f) - 1.0f;
+    }
+    else
+    {
+        // Line the lanes up with the vector, so the block gives the same samples as ticking
+        for (; i < size && n->lane != 0; i++) output[i] = noise_next(n);
+#if LEAF_SIMD_SSE2
+        if (i + 4 <= size)
+        {
+            const __m128 scale = _mm_set1_ps(4.656612873e-10f);
+            __m128i x = _mm_loadu_si128((const __m128i*) n->state);
+            for (; i + 4 <= size; i += 4)
+            {
+                x = _mm_xor_si128(x, _mm_slli_epi32(x, 13));
+                x = _mm_xor_si128(x, _mm_srli_epi32(x, 17));
+                x = _mm_xor_si128(x, _mm_slli_epi32(x, 5));
+                _mm_storeu_ps(output + i, _mm_mul_ps(_mm_cvtepi32_ps(x), scale));
+            }
+            _mm_storeu_si128((__m128i*) n->state, x);
+        }
+#elif LEAF_SIMD_NEON
+        if (i + 4 <= size)
+        {
+            const float32x4_t scale = vdupq_n_f32(4.656612873e-10f);
+            uint32x4_t x = vld1q_u32(n->state);
+            for (; i + 4 <= size; i += 4)
+            {
+                x = veorq_u32(x, vshlq_n_u32(x, 13));
+                x = veorq_u32(x, vshrq_n_u32(x, 17));
+                x = veorq_u32(x, vshlq_n_u32(x, 5));
+                vst1q_f32(output + i, vmulq_f32(vcvtq_f32_s32(vreinterpretq_s32_u32(x)), scale));
+            }
+            vst1q_u32(n->state, x);
+        }
+#endif
+        for (; i < size; i++) output[i] = noise_next(n);
+    }
+    
+    if (n->type == PinkNoise)
+    {
+        float b0 = n->pinkb0, b1 = n->pinkb1, b2 = n->pinkb2;
+        for (i = 0; i < size; i++)
+        {
+            float rand = output[i];
+            b0 = 0.99765f * b0 + rand * 0.0990460f;
+            b1 = 0.96300f * b1 + rand * 0.2965164f;
+            b2 = 0.57000f * b2 + rand * 1.0526913f;
+            output[i] = (b0 + b1 + b2 + rand * 0.1848f) * 0.05f;
+        }
+        n->pinkb0 = b0;
+        n->pinkb1 = b1;
+        n->pinkb2 = b2;
+    }
+}
+
 //=================================================================================
 /* Neuron */
 
@@ -697,6 +880,7 @@ void tNeuron_init(tNeuron* const nr, LEAF* const leaf)
 
 void tNeuron_initToPool  (tNeuron* const nr, tMempool* const mp)
 {
+    LEAF_PROFILE_POOL(mp);
     _tMempool* m = *mp;
     _tNeuron* n = *nr = (_tNeuron*) mpool_alloc(sizeof(_tNeuron), m);
     n->mempool = m;
@@ -819,6 +1003,7 @@ void tNeuron_setC(tNeuron* const nr, float C)
 
 float tNeuron_tick(tNeuron* const nr)
 {
+    LEAF_PROFILE_OBJECT(nr);
     _tNeuron* n = *nr;
     
     float output = 0.0f;
@@ -912,6 +1097,155 @@ void tNeuron_setSampleRate (tNeuron* const nr, float sr)
     n->timeStep = (44100.0f * n->invSampleRate) / 50.0f;
 }
 
+//----------------------------------------------------------------------------------------------------------
+// Block rendering for the MB oscillators
+
+// A block is cut into chunks that stop at the end of _f. A first pass over a chunk runs the phase and
+// notes each discontinuity, a second places their BLEPs with vector table reads, and a third adds the
+// naive waveform and runs the low pass. The BLEP for a sample only reaches that sample and later ones,
+// so placing a chunk's BLEPs together gives what ticking gives, up to the order the corrections sum in.
+
+#define MB_CHUNK 32
+
+typedef struct mb_dd
+{
+    int index;
+    float phase, w, scale;
+} mb_dd;
+
+static inline int mb_push(mb_dd* dd, int count, int index, float phase, float w, float scale)
+{
+    dd[count].index = index;
+    dd[count].phase = phase;
+    dd[count].w = w;
+    dd[count].scale = scale;
+    return count + 1;
+}
+
+// The tables hold every phase of a tap together, so the taps for one phase are a stride apart
+#if LEAF_SIMD_SSE
+static inline __m128 mb_gather(const float* p, int stride)
+{
+    return _mm_setr_ps(p[0], p[stride], p[2 * stride], p[3 * stride]);
+}
+#elif LEAF_SIMD_NEON
+static inline float32x4_t mb_gather(const float* p, int stride)
+{
+    float32x4_t v = vdupq_n_f32(p[0]);
+    v = vsetq_lane_f32(p[stride], v, 1);
+    v = vsetq_lane_f32(p[2 * stride], v, 2);
+    return vsetq_lane_f32(p[3 * stride], v, 3);
+}
+#endif
+
+// Same as place_step_dd()
+static inline void mb_placeStep(float* buffer, int index, float phase, float w, float scale)
+{
+    float r = MINBLEP_PHASES * phase / w;
+    int i = floorf(r);
+    r -= (float)i;
+    i &= MINBLEP_PHASE_MASK;
+    
+    const float* e = (const float*) &step_dd_table[i];
+    const int stride = 2 * MINBLEP_PHASES;
+    float* out = buffer + index;
+    int t = 0;
+#if LEAF_SIMD_SSE
+    const __m128 vs = _mm_set1_ps(scale), vr = _mm_set1_ps(r);
+    for (; t + 4 <= STEP_DD_PULSE_LENGTH; t += 4, e += 4 * stride)
+    {
+        __m128 d = _mm_add_ps(mb_gather(e, stride), _mm_mul_ps(vr, mb_gather(e + 1, stride)));
+        _mm_storeu_ps(out + t, _mm_add_ps(_mm_loadu_ps(out + t), _mm_mul_ps(vs, d)));
+    }
+#elif LEAF_SIMD_NEON
+    const float32x4_t vs = vdupq_n_f32(scale), vr = vdupq_n_f32(r);
+    for (; t + 4 <= STEP_DD_PULSE_LENGTH; t += 4, e += 4 * stride)
+    {
+        float32x4_t d = vaddq_f32(mb_gather(e, stride), vmulq_f32(vr, mb_gather(e + 1, stride)));
+        vst1q_f32(out + t, vaddq_f32(vld1q_f32(out + t), vmulq_f32(vs, d)));
+    }
+#endif
+    for (; t < STEP_DD_PULSE_LENGTH; t++, e += stride)
+        out[t] += scale * (e[0] + r * e[1]);
+}
+
+// Same as place_slope_dd()
+static inline void mb_placeSlope(float* buffer, int index, float phase, float w, float slope_delta)
+{
+    float r = MINBLEP_PHASES * phase / w;
+    int i = rintf(r - 0.5f);
+    r -= (float)i;
+    i &= MINBLEP_PHASE_MASK;
+    
+    slope_delta *= w;
+    
+    const float* e = &slope_dd_table[i];
+    const int stride = MINBLEP_PHASES;
+    float* out = buffer + index;
+    int t = 0;
+#if LEAF_SIMD_SSE
+    const __m128 vs = _mm_set1_ps(slope_delta), vr = _mm_set1_ps(r);
+    for (; t + 4 <= SLOPE_DD_PULSE_LENGTH; t += 4, e += 4 * stride)
+    {
+        __m128 v = mb_gather(e, stride);
+        __m128 d = _mm_add_ps(v, _mm_mul_ps(vr, _mm_sub_ps(mb_gather(e + 1, stride), v)));
+        _mm_storeu_ps(out + t, _mm_add_ps(_mm_loadu_ps(out + t), _mm_mul_ps(vs, d)));
+    }
+#elif LEAF_SIMD_NEON
+    const float32x4_t vs = vdupq_n_f32(slope_delta), vr = vdupq_n_f32(r);
+    for (; t + 4 <= SLOPE_DD_PULSE_LENGTH; t += 4, e += 4 * stride)
+    {
+        float32x4_t v = mb_gather(e, stride);
+        float32x4_t d = vaddq_f32(v, vmulq_f32(vr, vsubq_f32(mb_gather(e + 1, stride), v)));
+        vst1q_f32(out + t, vaddq_f32(vld1q_f32(out + t), vmulq_f32(vs, d)));
+    }
+#endif
+    for (; t < SLOPE_DD_PULSE_LENGTH; t++, e += stride)
+        out[t] += slope_delta * (e[0] + r * (e[1] - e[0]));
+}
+
+// Adds a chunk's naive waveform DD_SAMPLE_DELAY samples ahead, then low passes _f into output
+static inline float mb_filterChunk(float* f, int j, const float* x, float z, float amp, float* output, int n)
+{
+    float* dd = f + j + DD_SAMPLE_DELAY;
+    int t = 0;
+#if LEAF_SIMD_SSE
+    for (; t + 4 <= n; t += 4)
+        _mm_storeu_ps(dd + t, _mm_add_ps(_mm_loadu_ps(dd + t), _mm_loadu_ps(x + t)));
+#elif LEAF_SIMD_NEON
+    for (; t + 4 <= n; t += 4)
+        vst1q_f32(dd + t, vaddq_f32(vld1q_f32(dd + t), vld1q_f32(x + t)));
+#endif
+    for (; t < n; t++) dd[t] += x[t];
+    
+    for (t = 0; t < n; t++)
+    {
+        z += 0.5f * (f[j + t] - z);
+        output[t] = amp * z;
+    }
+    return z;
+}
+
+// Chunk length from buffer index j, and the shift of _f once a chunk reaches its end
+static inline int mb_chunkSize(int remaining, int j)
+{
+    int n = FILLEN - j;
+    if (n > MB_CHUNK) n = MB_CHUNK;
+    return remaining < n ? remaining : n;
+}
+
+static inline int mb_advance(float* f, int j, int n)
+{
+    j += n;
+    if (j == FILLEN)
+    {
+        j = 0;
+        memcpy (f, f + FILLEN, STEP_DD_PULSE_LENGTH * sizeof (float));
+        memset (f + STEP_DD_PULSE_LENGTH, 0,  FILLEN * sizeof (float));
+    }
+    return j;
+}
+
 //----------------------------------------------------------------------------------------------------------
 
 void tMBPulse_init(tMBPulse* const osc, LEAF* const leaf)
@@ -921,6 +1255,7 @@ void tMBPulse_init(tMBPulse* const osc, LEAF* const leaf)
                           
 void tMBPulse_initToPool(tMBPulse* const osc, tMempool* const pool)
 {
+    LEAF_PROFILE_POOL(pool);
     _tMempool* m = *pool;
     _tMBPulse* c = *osc = (_tMBPulse*) mpool_alloc(sizeof(_tMBPulse), m);
     c->mempool = m;
@@ -949,6 +1284,7 @@ void tMBPulse_free(tMBPulse* const osc)
 
 float tMBPulse_tick(tMBPulse* const osc)
 {
+    LEAF_PROFILE_OBJECT(osc);
     _tMBPulse* c = *osc;
     
     int    j, k;
@@ -1174,6 +1510,121 @@ float tMBPulse_tick(tMBPulse* const osc)
     return c->out;
 }
 
+void tMBPulse_tickBlock(tMBPulse* const osc, float* output, int size)
+{
+    LEAF_PROFILE_OBJECT(osc);
+    _tMBPulse* c = *osc;
+    int i = 0;
+    
+    // Sync, and the setup on the first tick, are left to the tick
+    if (c->sync > 0.0f)
+    {
+        for (; i < size; i++) output[i] = tMBPulse_tick(osc);
+        return;
+    }
+    if (c->_init && size > 0) output[i++] = tMBPulse_tick(osc);
+    if (i == size) return;
+    
+    float w = c->freq * c->invSampleRate;
+    float b = 0.5f * (1.0f + c->waveform);
+    float sw = w * c->syncdir;
+    float inc = sw - (int)sw;
+    float p = c->_p, x = c->_x, z = c->_z;
+    int j = c->_j, k = c->_k;
+    
+    float xs[MB_CHUNK];
+    mb_dd dd[2 * MB_CHUNK];
+    
+    while (i < size)
+    {
+        int n = mb_chunkSize(size - i, j);
+        int numDD = 0;
+        
+        for (int t = 0; t < n; t++)
+        {
+            p += inc;
+            if (!k)
+            {
+                if (sw > 0)
+                {
+                    if (p >= b) {
+                        numDD = mb_push(dd, numDD, j + t, p - b, sw, -1.0f);
+                        k = 1;
+                        x = -0.5f;
+                    }
+                    if (p >= 1.0f) {
+                        p -= 1.0f;
+                        numDD = mb_push(dd, numDD, j + t, p, sw, 1.0f);
+                        k = 0;
+                        x = 0.5f;
+                    }
+                }
+                else if (sw < 0)
+                {
+                    if (p < 0.0f) {
+                        p += 1.0f;
+                        numDD = mb_push(dd, numDD, j + t, 1.0f - p, -sw, -1.0f);
+                        k = 1;
+                        x = -0.5f;
+                    }
+                    if (k && p < b) {
+                        numDD = mb_push(dd, numDD, j + t, b - p, -sw, 1.0f);
+                        k = 0;
+                        x = 0.5f;
+                    }
+                }
+            }
+            else
+            {
+                if (sw > 0)
+                {
+                    if (p >= 1.0f) {
+                        p -= 1.0f;
+                        numDD = mb_push(dd, numDD, j + t, p, sw, 1.0f);
+                        k = 0;
+                        x = 0.5f;
+                    }
+                    if (!k && p >= b) {
+                        numDD = mb_push(dd, numDD, j + t, p - b, sw, -1.0f);
+                        k = 1;
+                        x = -0.5f;
+                    }
+                }
+                else if (sw < 0)
+                {
+                    if (p < b) {
+                        numDD = mb_push(dd, numDD, j + t, b - p, -sw, 1.0f);
+                        k = 0;
+                        x = 0.5f;
+                    }
+                    if (p < 0.0f) {
+                        p += 1.0f;
+                        numDD = mb_push(dd, numDD, j + t, 1.0f - p, -sw, -1.0f);
+                        k = 1;
+                        x = -0.5f;
+                    }
+                }
+            }
+            xs[t] = x;
+        }
+        
+        for (int e = 0; e < numDD; e++) mb_placeStep(c->_f, dd[e].index, dd[e].phase, dd[e].w, dd[e].scale);
+        z = mb_filterChunk(c->_f, j, xs, z, c->amp, output + i, n);
+        
+        j = mb_advance(c->_f, j, n);
+        i += n;
+    }
+    
+    c->out = output[size - 1];
+    c->_p = p;
+    c->_w = w;
+    c->_b = b;
+    c->_x = x;
+    c->_z = z;
+    c->_j = j;
+    c->_k = k;
+}
+
 void tMBPulse_setFreq(tMBPulse* const osc, float f)
 {
     _tMBPulse* c = *osc;
@@ -1224,6 +1675,7 @@ void tMBTriangle_init(tMBTriangle* const osc, LEAF* const leaf)
 
 void tMBTriangle_initToPool(tMBTriangle* const osc, tMempool* const pool)
 {
+    LEAF_PROFILE_POOL(pool);
     _tMempool* m = *pool;
     _tMBTriangle* c = *osc = (_tMBTriangle*) mpool_alloc(sizeof(_tMBTriangle), m);
     c->mempool = m;
@@ -1251,6 +1703,7 @@ void tMBTriangle_free(tMBTriangle* const osc)
 
 float tMBTriangle_tick(tMBTriangle* const osc)
 {
+    LEAF_PROFILE_OBJECT(osc);
     _tMBTriangle* c = *osc;
     
     int    j, k, dir;
@@ -1476,6 +1929,125 @@ float tMBTriangle_tick(tMBTriangle* const osc)
     return c->out;
 }
 
+void tMBTriangle_tickBlock(tMBTriangle* const osc, float* output, int size)
+{
+    LEAF_PROFILE_OBJECT(osc);
+    _tMBTriangle* c = *osc;
+    int i = 0;
+    
+    // Sync, and the setup on the first tick, are left to the tick
+    if (c->sync > 0.0f)
+    {
+        for (; i < size; i++) output[i] = tMBTriangle_tick(osc);
+        return;
+    }
+    if (c->_init && size > 0) output[i++] = tMBTriangle_tick(osc);
+    if (i == size) return;
+    
+    float w = c->freq * c->invSampleRate;
+    float b = 0.5f * (1.0f + c->waveform);
+    float b1 = 1.0f - b;
+    float up = 1.0f / b + 1.0f / b1;
+    float down = -1.0f / b1 - 1.0f / b;
+    float sw = w * c->syncdir;
+    float inc = sw - (int)sw;
+    float p = c->_p, x, z = c->_z;
+    int j = c->_j, k = c->_k;
+    
+    float xs[MB_CHUNK];
+    mb_dd dd[2 * MB_CHUNK];
+    
+    while (i < size)
+    {
+        int n = mb_chunkSize(size - i, j);
+        int numDD = 0;
+        
+        for (int t = 0; t < n; t++)
+        {
+            p += inc;
+            if (!k)
+            {
+                x = -0.5f + p / b;
+                if (sw > 0)
+                {
+                    if (p >= b) {
+                        x = 0.5f - (p - b) / b1;
+                        numDD = mb_push(dd, numDD, j + t, p - b, sw, down);
+                        k = 1;
+                    }
+                    if (p >= 1.0f) {
+                        p -= 1.0f;
+                        x = -0.5f + p / b;
+                        numDD = mb_push(dd, numDD, j + t, p, sw, up);
+                        k = 0;
+                    }
+                }
+                else if (sw < 0)
+                {
+                    if (p < 0.0f) {
+                        p += 1.0f;
+                        x = 0.5f - (p - b) / b1;
+                        numDD = mb_push(dd, numDD, j + t, 1.0f - p, -sw, up);
+                        k = 1;
+                    }
+                    if (k && p < b) {
+                        x = -0.5f + p / b;
+                        numDD = mb_push(dd, numDD, j + t, b - p, -sw, down);
+                        k = 0;
+                    }
+                }
+            }
+            else
+            {
+                x = 0.5f - (p - b) / b1;
+                if (sw > 0)
+                {
+                    if (p >= 1.0f) {
+                        p -= 1.0f;
+                        x = -0.5f + p / b;
+                        numDD = mb_push(dd, numDD, j + t, p, sw, up);
+                        k = 0;
+                    }
+                    if (!k && p >= b) {
+                        x = 0.5f - (p - b) / b1;
+                        numDD = mb_push(dd, numDD, j + t, p - b, sw, down);
+                        k = 1;
+                    }
+                }
+                else if (sw < 0)
+                {
+                    if (p < b) {
+                        x = -0.5f + p / b;
+                        numDD = mb_push(dd, numDD, j + t, b - p, -sw, down);
+                        k = 0;
+                    }
+                    if (p < 0.0f) {
+                        p += 1.0f;
+                        x = 0.5f - (p - b) / b1;
+                        numDD = mb_push(dd, numDD, j + t, 1.0f - p, -sw, up);
+                        k = 1;
+                    }
+                }
+            }
+            xs[t] = x;
+        }
+        
+        for (int e = 0; e < numDD; e++) mb_placeSlope(c->_f, dd[e].index, dd[e].phase, dd[e].w, dd[e].scale);
+        z = mb_filterChunk(c->_f, j, xs, z, c->amp, output + i, n);
+        
+        j = mb_advance(c->_f, j, n);
+        i += n;
+    }
+    
+    c->out = output[size - 1];
+    c->_p = p;
+    c->_w = w;
+    c->_b = b;
+    c->_z = z;
+    c->_j = j;
+    c->_k = k;
+}
+
 void tMBTriangle_setFreq(tMBTriangle* const osc, float f)
 {
     _tMBTriangle* c = *osc;
@@ -1526,6 +2098,7 @@ void tMBSaw_init(tMBSaw* const osc, LEAF* const leaf)
 
 void tMBSaw_initToPool(tMBSaw* const osc, tMempool* const pool)
 {
+    LEAF_PROFILE_POOL(pool);
     _tMempool* m = *pool;
     _tMBSaw* c = *osc = (_tMBSaw*) mpool_alloc(sizeof(_tMBSaw), m);
     c->mempool = m;
@@ -1552,6 +2125,7 @@ void tMBSaw_free(tMBSaw* const osc)
 
 float tMBSaw_tick(tMBSaw* const osc)
 {
+    LEAF_PROFILE_OBJECT(osc);
     _tMBSaw* c = *osc;
     
     int    j;
@@ -1648,6 +2222,62 @@ float tMBSaw_tick(tMBSaw* const osc)
     return c->out;
 }
 
+void tMBSaw_tickBlock(tMBSaw* const osc, float* output, int size)
+{
+    LEAF_PROFILE_OBJECT(osc);
+    _tMBSaw* c = *osc;
+    int i = 0;
+    
+    // Sync, and the setup on the first tick, are left to the tick
+    if (c->sync > 0.0f)
+    {
+        for (; i < size; i++) output[i] = tMBSaw_tick(osc);
+        return;
+    }
+    if (c->_init && size > 0) output[i++] = tMBSaw_tick(osc);
+    if (i == size) return;
+    
+    float w = c->freq * c->invSampleRate;
+    float sw = w * c->syncdir;
+    float inc = sw - (int)sw;
+    float p = c->_p, z = c->_z;
+    int j = c->_j;
+    
+    float xs[MB_CHUNK];
+    mb_dd dd[MB_CHUNK];
+    
+    while (i < size)
+    {
+        int n = mb_chunkSize(size - i, j);
+        int numDD = 0;
+        
+        for (int t = 0; t < n; t++)
+        {
+            p += inc;
+            if (p >= 1.0f) {
+                p -= 1.0f;
+                numDD = mb_push(dd, numDD, j + t, p, sw, 1.0f);
+            } else if (p < 0.0f) {
+                p += 1.0f;
+                numDD = mb_push(dd, numDD, j + t, 1.0f - p, -sw, -1.0f);
+            }
+            xs[t] = 0.5f - p;
+        }
+        
+        for (int e = 0; e < numDD; e++) mb_placeStep(c->_f, dd[e].index, dd[e].phase, dd[e].w, dd[e].scale);
+        z = mb_filterChunk(c->_f, j, xs, z, c->amp, output + i, n);
+        
+        j = mb_advance(c->_f, j, n);
+        i += n;
+    }
+    
+    c->out = output[size - 1];
+    c->_p = p;
+    c->_w = w;
+    c->_z = z;
+    c->_j = j;
+}
+
 void tMBSaw_setFreq(tMBSaw* const osc, float f)
 {
     _tMBSaw* c = *osc;
@@ -1682,34 +2312,787 @@ void tMBSaw_setSampleRate(tMBSaw* const osc, float sr)
     c->invSampleRate = 1.0f/sr;
 }
 
+//==========================================================================================================
+// Oscillator banks
+//==========================================================================================================
 
-// WaveTable
-void    tTable_init(tTable* const cy, float* waveTable, int size, LEAF* const leaf)
-{
-    tTable_initToPool(cy, waveTable, size, &leaf->mempool);
-}
-
-void    tTable_initToPool(tTable* const cy, float* waveTable, int size, tMempool* const mp)
+// Per-voice state is stored as arrays of numLanes floats, with numLanes a multiple of 4,
+// so the loops below never need a scalar tail.
+static inline int oscbank_numLanes(int numVoices)
 {
-    _tMempool* m = *mp;
-    _tTable* c = *cy = (_tTable*)mpool_alloc(sizeof(_tTable), m);
-    c->mempool = m;
-    LEAF* leaf = c->mempool->leaf;
-    
-    c->waveTable = waveTable;
-    c->size = size;
-    c->inc = 0.0f;
-    c->phase = 0.0f;
-    c->invSampleRate = leaf->invSampleRate;
+    if (numVoices < 1) numVoices = 1;
+    return (numVoices + 3) & ~3;
 }
 
-void    tTable_free(tTable* const cy)
+// p += inc, optionally wrapping p into [0, 1) the same way tCycle does
+static inline void oscbank_advance(float* p, const float* inc, int numLanes, int wrap)
 {
-    _tTable* c = *cy;
-    
-    mpool_free((char*)c, c->mempool);
-}
-
+    int i = 0;
+#if LEAF_SIMD_SSE
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 zero = _mm_setzero_ps();
+    for (; i < numLanes; i += 4)
+    {
+        __m128 v = _mm_add_ps(_mm_loadu_ps(p + i), _mm_loadu_ps(inc + i));
+        if (wrap)
+        {
+            v = _mm_sub_ps(v, _mm_and_ps(_mm_cmpge_ps(v, one), one));
+            v = _mm_add_ps(v, _mm_and_ps(_mm_cmplt_ps(v, zero), one));
+        }
+        _mm_storeu_ps(p + i, v);
+    }
+#elif LEAF_SIMD_NEON
+    const float32x4_t one = vdupq_n_f32(1.0f);
+    const float32x4_t zero = vdupq_n_f32(0.0f);
+    for (; i < numLanes; i += 4)
+    {
+        float32x4_t v = vaddq_f32(vld1q_f32(p + i), vld1q_f32(inc + i));
+        if (wrap)
+        {
+            v = vsubq_f32(v, vbslq_f32(vcgeq_f32(v, one), one, zero));
+            v = vaddq_f32(v, vbslq_f32(vcltq_f32(v, zero), one, zero));
+        }
+        vst1q_f32(p + i, v);
+    }
+#endif
+    for (; i < numLanes; ++i)
+    {
+        p[i] += inc[i];
+        if (wrap)
+        {
+            if (p[i] >= 1.0f) p[i] -= 1.0f;
+            if (p[i] < 0.0f) p[i] += 1.0f;
+        }
+    }
+}
+
+// Adds this sample's naive waveform into the minBLEP buffer, then runs the one-pole
+// low pass the MB oscillators use (a = 0.5) on the buffer's current row
+static inline void oscbank_accumulateAndFilter(float* f, int j, const float* x, float* z, float* out, int numLanes)
+{
+    float* dd = f + (j + DD_SAMPLE_DELAY) * numLanes;
+    float* in = f + j * numLanes;
+    int i = 0;
+#if LEAF_SIMD_SSE
+    const __m128 a = _mm_set1_ps(0.5f);
+    for (; i < numLanes; i += 4)
+    {
+        _mm_storeu_ps(dd + i, _mm_add_ps(_mm_loadu_ps(dd + i), _mm_loadu_ps(x + i)));
+        __m128 zv = _mm_loadu_ps(z + i);
+        zv = _mm_add_ps(zv, _mm_mul_ps(a, _mm_sub_ps(_mm_loadu_ps(in + i), zv)));
+        _mm_storeu_ps(z + i, zv);
+        _mm_storeu_ps(out + i, zv);
+    }
+#elif LEAF_SIMD_NEON
+    const float32x4_t a = vdupq_n_f32(0.5f);
+    for (; i < numLanes; i += 4)
+    {
+        vst1q_f32(dd + i, vaddq_f32(vld1q_f32(dd + i), vld1q_f32(x + i)));
+        float32x4_t zv = vld1q_f32(z + i);
+        zv = vaddq_f32(zv, vmulq_f32(a, vsubq_f32(vld1q_f32(in + i), zv)));
+        vst1q_f32(z + i, zv);
+        vst1q_f32(out + i, zv);
+    }
+#endif
+    for (; i < numLanes; ++i)
+    {
+        dd[i] += x[i];
+        z[i] += 0.5f * (in[i] - z[i]);
+        out[i] = z[i];
+    }
+}
+
+// Moves to the next row of the minBLEP buffer, carrying the tails of placed steps over when it wraps
+static inline int oscbank_nextRow(float* f, int j, int length, int numLanes)
+{
+    if (++j == FILLEN)
+    {
+        j = 0;
+        memcpy (f, f + FILLEN * numLanes, length * numLanes * sizeof (float));
+        memset (f + length * numLanes, 0, FILLEN * numLanes * sizeof (float));
+    }
+    return j;
+}
+
+// place_step_dd and place_slope_dd for one voice of an interleaved minBLEP buffer
+static void oscbank_place_step_dd(float *buffer, int index, int stride, float phase, float w, float scale)
+{
+    float r;
+    int i;
+    
+    r = MINBLEP_PHASES * phase / w;
+    i = floorf(r);
+    r -= (float)i;
+    i &= MINBLEP_PHASE_MASK;
+    
+    buffer += index * stride;
+    while (i < MINBLEP_PHASES * STEP_DD_PULSE_LENGTH) {
+        *buffer += scale * (step_dd_table[i].value + r * step_dd_table[i].delta);
+        i += MINBLEP_PHASES;
+        buffer += stride;
+    }
+}
+
+static void oscbank_place_slope_dd(float *buffer, int index, int stride, float phase, float w, float slope_delta)
+{
+    float r;
+    int i;
+    
+    r = MINBLEP_PHASES * phase / w;
+    i = rintf(r - 0.5f);
+    r -= (float)i;
+    i &= MINBLEP_PHASE_MASK;
+    
+    slope_delta *= w;
+    
+    buffer += index * stride;
+    while (i < MINBLEP_PHASES * SLOPE_DD_PULSE_LENGTH) {
+        *buffer += slope_delta * (slope_dd_table[i] + r * (slope_dd_table[i + 1] - slope_dd_table[i]));
+        i += MINBLEP_PHASES;
+        buffer += stride;
+    }
+}
+
+static inline void oscbank_scatter(const float* frame, float** outputs, int numVoices, int n)
+{
+    for (int v = 0; v < numVoices; ++v) outputs[v][n] = frame[v];
+}
+
+#if LEAF_INCLUDE_SINE_TABLE
+void    tCycleBank_init         (tCycleBank* const bank, int numVoices, LEAF* const leaf)
+{
+    tCycleBank_initToPool(bank, numVoices, &leaf->mempool);
+}
+
+void    tCycleBank_initToPool   (tCycleBank* const bank, int numVoices, tMempool* const mp)
+{
+    LEAF_PROFILE_POOL(mp);
+    _tMempool* m = *mp;
+    _tCycleBank* c = *bank = (_tCycleBank*) mpool_alloc(sizeof(_tCycleBank), m);
+    c->mempool = m;
+    LEAF* leaf = c->mempool->leaf;
+    
+    c->numVoices = numVoices > 0 ? numVoices : 1;
+    c->numLanes = oscbank_numLanes(numVoices);
+    c->table = LEAF_getSineTable(leaf);
+    c->phase = (float*) mpool_calloc(sizeof(float) * c->numLanes, m);
+    c->inc = (float*) mpool_calloc(sizeof(float) * c->numLanes, m);
+    c->freq = (float*) mpool_calloc(sizeof(float) * c->numLanes, m);
+    c->frame = (float*) mpool_calloc(sizeof(float) * c->numLanes, m);
+    c->invSampleRate = leaf->invSampleRate;
+}
+
+void    tCycleBank_free         (tCycleBank* const bank)
+{
+    _tCycleBank* c = *bank;
+    
+    mpool_free((char*)c->frame, c->mempool);
+    mpool_free((char*)c->freq, c->mempool);
+    mpool_free((char*)c->inc, c->mempool);
+    mpool_free((char*)c->phase, c->mempool);
+    mpool_free((char*)c, c->mempool);
+}
+
+static void tCycleBank_tickFrame(_tCycleBank* c)
+{
+    const leaf_table_t* table = c->table;
+    float* phase = c->phase;
+    float* frame = c->frame;
+    
+    oscbank_advance(phase, c->inc, c->numLanes, 1);
+    
+    for (int v = 0; v < c->numLanes; ++v)
+    {
+        float temp = SINE_TABLE_SIZE * phase[v];
+        int idx = (int)temp;
+        float frac = temp - (float)idx;
+        float samp0 = LEAF_TABLE_READ(table, idx);
+        if (++idx >= SINE_TABLE_SIZE) idx = 0;
+        float samp1 = LEAF_TABLE_READ(table, idx);
+        frame[v] = samp0 + (samp1 - samp0) * frac;
+    }
+}
+
+void    tCycleBank_tick         (tCycleBank* const bank, float* output)
+{
+    LEAF_PROFILE_OBJECT(bank);
+    _tCycleBank* c = *bank;
+    
+    tCycleBank_tickFrame(c);
+    memcpy(output, c->frame, sizeof(float) * c->numVoices);
+}
+
+void    tCycleBank_tickBlock    (tCycleBank* const bank, float** outputs, int size)
+{
+    LEAF_PROFILE_OBJECT(bank);
+    _tCycleBank* c = *bank;
+    
+    for (int n = 0; n < size; ++n)
+    {
+        tCycleBank_tickFrame(c);
+        oscbank_scatter(c->frame, outputs, c->numVoices, n);
+    }
+}
+
+void    tCycleBank_setFreq      (tCycleBank* const bank, int voice, float freq)
+{
+    _tCycleBank* c = *bank;
+    
+    if (voice < 0 || voice >= c->numVoices) return;
+    if (!isfinite(freq)) return;
+    
+    c->freq[voice] = freq;
+    c->inc[voice] = freq * c->invSampleRate;
+    c->inc[voice] -= (int)c->inc[voice];
+}
+
+void    tCycleBank_setSampleRate(tCycleBank* const bank, float sr)
+{
+    _tCycleBank* c = *bank;
+    
+    c->invSampleRate = 1.0f/sr;
+    for (int v = 0; v < c->numVoices; ++v) tCycleBank_setFreq(bank, v, c->freq[v]);
+}
+#endif // LEAF_INCLUDE_SINE_TABLE
+
+//==========================================================================================================
+
+void tMBSawBank_init(tMBSawBank* const bank, int numVoices, LEAF* const leaf)
+{
+    tMBSawBank_initToPool(bank, numVoices, &leaf->mempool);
+}
+
+void tMBSawBank_initToPool(tMBSawBank* const bank, int numVoices, tMempool* const pool)
+{
+    LEAF_PROFILE_POOL(pool);
+    _tMempool* m = *pool;
+    _tMBSawBank* c = *bank = (_tMBSawBank*) mpool_alloc(sizeof(_tMBSawBank), m);
+    c->mempool = m;
+    LEAF* leaf = c->mempool->leaf;
+    
+    c->invSampleRate = leaf->invSampleRate;
+    c->numVoices = numVoices > 0 ? numVoices : 1;
+    c->numLanes = oscbank_numLanes(numVoices);
+    int L = c->numLanes;
+    c->freq = (float*) mpool_calloc(sizeof(float) * L, m);
+    c->w = (float*) mpool_calloc(sizeof(float) * L, m);
+    c->inc = (float*) mpool_calloc(sizeof(float) * L, m);
+    c->p = (float*) mpool_calloc(sizeof(float) * L, m);
+    c->x = (float*) mpool_calloc(sizeof(float) * L, m);
+    c->z = (float*) mpool_calloc(sizeof(float) * L, m);
+    c->f = (float*) mpool_calloc(sizeof(float) * L * (FILLEN + STEP_DD_PULSE_LENGTH), m);
+    c->frame = (float*) mpool_calloc(sizeof(float) * L, m);
+    c->j = 0;
+    
+    for (int v = 0; v < L; ++v) c->p[v] = 0.5f;
+    for (int v = 0; v < c->numVoices; ++v) tMBSawBank_setFreq(bank, v, 440.f);
+}
+
+void tMBSawBank_free(tMBSawBank* const bank)
+{
+    _tMBSawBank* c = *bank;
+    
+    mpool_free((char*)c->frame, c->mempool);
+    mpool_free((char*)c->f, c->mempool);
+    mpool_free((char*)c->z, c->mempool);
+    mpool_free((char*)c->x, c->mempool);
+    mpool_free((char*)c->p, c->mempool);
+    mpool_free((char*)c->inc, c->mempool);
+    mpool_free((char*)c->w, c->mempool);
+    mpool_free((char*)c->freq, c->mempool);
+    mpool_free((char*)c, c->mempool);
+}
+
+static void tMBSawBank_tickFrame(_tMBSawBank* c)
+{
+    int L = c->numLanes;
+    int j = c->j;
+    float* p = c->p;
+    float* x = c->x;
+    float* f = c->f;
+    
+    oscbank_advance(p, c->inc, L, 0);
+    
+    for (int v = 0; v < L; ++v)
+    {
+        if (p[v] >= 1.0f) {  /* normal phase reset */
+            p[v] -= 1.0f;
+            oscbank_place_step_dd(f + v, j, L, p[v], c->w[v], 1.0f);
+        } else if (p[v] < 0.0f) {
+            p[v] += 1.0f;
+            oscbank_place_step_dd(f + v, j, L, 1.0f - p[v], -c->w[v], -1.0f);
+        }
+        x[v] = 0.5f - p[v];
+    }
+    
+    oscbank_accumulateAndFilter(f, j, x, c->z, c->frame, L);
+    c->j = oscbank_nextRow(f, j, STEP_DD_PULSE_LENGTH, L);
+}
+
+void tMBSawBank_tick(tMBSawBank* const bank, float* output)
+{
+    LEAF_PROFILE_OBJECT(bank);
+    _tMBSawBank* c = *bank;
+    
+    tMBSawBank_tickFrame(c);
+    memcpy(output, c->frame, sizeof(float) * c->numVoices);
+}
+
+void tMBSawBank_tickBlock(tMBSawBank* const bank, float** outputs, int size)
+{
+    LEAF_PROFILE_OBJECT(bank);
+    _tMBSawBank* c = *bank;
+    
+    for (int n = 0; n < size; ++n)
+    {
+        tMBSawBank_tickFrame(c);
+        oscbank_scatter(c->frame, outputs, c->numVoices, n);
+    }
+}
+
+void tMBSawBank_setFreq(tMBSawBank* const bank, int voice, float f)
+{
+    _tMBSawBank* c = *bank;
+    
+    if (voice < 0 || voice >= c->numVoices) return;
+    
+    c->freq[voice] = f;
+    c->w[voice] = f * c->invSampleRate;
+    c->inc[voice] = c->w[voice] - (int)c->w[voice];
+}
+
+void tMBSawBank_setSampleRate(tMBSawBank* const bank, float sr)
+{
+    _tMBSawBank* c = *bank;
+    
+    c->invSampleRate = 1.0f/sr;
+    for (int v = 0; v < c->numVoices; ++v) tMBSawBank_setFreq(bank, v, c->freq[v]);
+}
+
+//==========================================================================================================
+
+void tMBPulseBank_init(tMBPulseBank* const bank, int numVoices, LEAF* const leaf)
+{
+    tMBPulseBank_initToPool(bank, numVoices, &leaf->mempool);
+}
+
+void tMBPulseBank_initToPool(tMBPulseBank* const bank, int numVoices, tMempool* const pool)
+{
+    LEAF_PROFILE_POOL(pool);
+    _tMempool* m = *pool;
+    _tMBPulseBank* c = *bank = (_tMBPulseBank*) mpool_alloc(sizeof(_tMBPulseBank), m);
+    c->mempool = m;
+    LEAF* leaf = c->mempool->leaf;
+    
+    c->invSampleRate = leaf->invSampleRate;
+    c->numVoices = numVoices > 0 ? numVoices : 1;
+    c->numLanes = oscbank_numLanes(numVoices);
+    int L = c->numLanes;
+    c->freq = (float*) mpool_calloc(sizeof(float) * L, m);
+    c->w = (float*) mpool_calloc(sizeof(float) * L, m);
+    c->inc = (float*) mpool_calloc(sizeof(float) * L, m);
+    c->b = (float*) mpool_calloc(sizeof(float) * L, m);
+    c->p = (float*) mpool_calloc(sizeof(float) * L, m);
+    c->x = (float*) mpool_calloc(sizeof(float) * L, m);
+    c->z = (float*) mpool_calloc(sizeof(float) * L, m);
+    c->k = (int*) mpool_calloc(sizeof(int) * L, m);
+    c->f = (float*) mpool_calloc(sizeof(float) * L * (FILLEN + STEP_DD_PULSE_LENGTH), m);
+    c->frame = (float*) mpool_calloc(sizeof(float) * L, m);
+    c->j = 0;
+    
+    for (int v = 0; v < L; ++v)
+    {
+        c->b[v] = 0.5f;
+        c->x[v] = 0.5f;
+    }
+    for (int v = 0; v < c->numVoices; ++v) tMBPulseBank_setFreq(bank, v, 440.f);
+}
+
+void tMBPulseBank_free(tMBPulseBank* const bank)
+{
+    _tMBPulseBank* c = *bank;
+    
+    mpool_free((char*)c->frame, c->mempool);
+    mpool_free((char*)c->f, c->mempool);
+    mpool_free((char*)c->k, c->mempool);
+    mpool_free((char*)c->z, c->mempool);
+    mpool_free((char*)c->x, c->mempool);
+    mpool_free((char*)c->p, c->mempool);
+    mpool_free((char*)c->b, c->mempool);
+    mpool_free((char*)c->inc, c->mempool);
+    mpool_free((char*)c->w, c->mempool);
+    mpool_free((char*)c->freq, c->mempool);
+    mpool_free((char*)c, c->mempool);
+}
+
+static void tMBPulseBank_tickFrame(_tMBPulseBank* c)
+{
+    int L = c->numLanes;
+    int j = c->j;
+    float* p = c->p;
+    float* x = c->x;
+    float* f = c->f;
+    
+    oscbank_advance(p, c->inc, L, 0);
+    
+    for (int v = 0; v < L; ++v)
+    {
+        float* fv = f + v;
+        float sw = c->w[v];
+        float b = c->b[v];
+        int k = c->k[v];
+        
+        if (!k) {  /* signal currently high */
+            if (sw > 0)
+            {
+                if (p[v] >= b) {
+                    oscbank_place_step_dd(fv, j, L, p[v] - b, sw, -1.0f);
+                    k = 1;
+                    x[v] = -0.5f;
+                }
+                if (p[v] >= 1.0f) {
+                    p[v] -= 1.0f;
+                    oscbank_place_step_dd(fv, j, L, p[v], sw, 1.0f);
+                    k = 0;
+                    x[v] = 0.5f;
+                }
+            }
+            else if (sw < 0)
+            {
+                if (p[v] < 0.0f) {
+                    p[v] += 1.0f;
+                    oscbank_place_step_dd(fv, j, L, 1.0f - p[v], -sw, -1.0f);
+                    k = 1;
+                    x[v] = -0.5f;
+                }
+                if (k && p[v] < b) {
+                    oscbank_place_step_dd(fv, j, L, b - p[v], -sw, 1.0f);
+                    k = 0;
+                    x[v] = 0.5f;
+                }
+            }
+        } else {  /* signal currently low */
+            if (sw > 0)
+            {
+                if (p[v] >= 1.0f) {
+                    p[v] -= 1.0f;
+                    oscbank_place_step_dd(fv, j, L, p[v], sw, 1.0f);
+                    k = 0;
+                    x[v] = 0.5f;
+                }
+                if (!k && p[v] >= b) {
+                    oscbank_place_step_dd(fv, j, L, p[v] - b, sw, -1.0f);
+                    k = 1;
+                    x[v] = -0.5f;
+                }
+            }
+            else if (sw < 0)
+            {
+                if (p[v] < b) {
+                    oscbank_place_step_dd(fv, j, L, b - p[v], -sw, 1.0f);
+                    k = 0;
+                    x[v] = 0.5f;
+                }
+                if (p[v] < 0.0f) {
+                    p[v] += 1.0f;
+                    oscbank_place_step_dd(fv, j, L, 1.0f - p[v], -sw, -1.0f);
+                    k = 1;
+                    x[v] = -0.5f;
+                }
+            }
+        }
+        c->k[v] = k;
+    }
+    
+    oscbank_accumulateAndFilter(f, j, x, c->z, c->frame, L);
+    c->j = oscbank_nextRow(f, j, STEP_DD_PULSE_LENGTH, L);
+}
+
+void tMBPulseBank_tick(tMBPulseBank* const bank, float* output)
+{
+    LEAF_PROFILE_OBJECT(bank);
+    _tMBPulseBank* c = *bank;
+    
+    tMBPulseBank_tickFrame(c);
+    memcpy(output, c->frame, sizeof(float) * c->numVoices);
+}
+
+void tMBPulseBank_tickBlock(tMBPulseBank* const bank, float** outputs, int size)
+{
+    LEAF_PROFILE_OBJECT(bank);
+    _tMBPulseBank* c = *bank;
+    
+    for (int n = 0; n < size; ++n)
+    {
+        tMBPulseBank_tickFrame(c);
+        oscbank_scatter(c->frame, outputs, c->numVoices, n);
+    }
+}
+
+void tMBPulseBank_setFreq(tMBPulseBank* const bank, int voice, float f)
+{
+    _tMBPulseBank* c = *bank;
+    
+    if (voice < 0 || voice >= c->numVoices) return;
+    
+    c->freq[voice] = f;
+    c->w[voice] = f * c->invSampleRate;
+    c->inc[voice] = c->w[voice] - (int)c->w[voice];
+}
+
+void tMBPulseBank_setWidth(tMBPulseBank* const bank, int voice, float w)
+{
+    _tMBPulseBank* c = *bank;
+    
+    if (voice < 0 || voice >= c->numVoices) return;
+    
+    c->b[voice] = 0.5f * (1.0f + w);
+}
+
+void tMBPulseBank_setSampleRate(tMBPulseBank* const bank, float sr)
+{
+    _tMBPulseBank* c = *bank;
+    
+    c->invSampleRate = 1.0f/sr;
+    for (int v = 0; v < c->numVoices; ++v) tMBPulseBank_setFreq(bank, v, c->freq[v]);
+}
+
+//==========================================================================================================
+
+void tMBTriangleBank_init(tMBTriangleBank* const bank, int numVoices, LEAF* const leaf)
+{
+    tMBTriangleBank_initToPool(bank, numVoices, &leaf->mempool);
+}
+
+void tMBTriangleBank_initToPool(tMBTriangleBank* const bank, int numVoices, tMempool* const pool)
+{
+    LEAF_PROFILE_POOL(pool);
+    _tMempool* m = *pool;
+    _tMBTriangleBank* c = *bank = (_tMBTriangleBank*) mpool_alloc(sizeof(_tMBTriangleBank), m);
+    c->mempool = m;
+    LEAF* leaf = c->mempool->leaf;
+    
+    c->invSampleRate = leaf->invSampleRate;
+    c->numVoices = numVoices > 0 ? numVoices : 1;
+    c->numLanes = oscbank_numLanes(numVoices);
+    int L = c->numLanes;
+    c->freq = (float*) mpool_calloc(sizeof(float) * L, m);
+    c->w = (float*) mpool_calloc(sizeof(float) * L, m);
+    c->inc = (float*) mpool_calloc(sizeof(float) * L, m);
+    c->b = (float*) mpool_calloc(sizeof(float) * L, m);
+    c->ib = (float*) mpool_calloc(sizeof(float) * L, m);
+    c->ib1 = (float*) mpool_calloc(sizeof(float) * L, m);
+    c->p = (float*) mpool_calloc(sizeof(float) * L, m);
+    c->x = (float*) mpool_calloc(sizeof(float) * L, m);
+    c->z = (float*) mpool_calloc(sizeof(float) * L, m);
+    c->k = (int*) mpool_calloc(sizeof(int) * L, m);
+    c->f = (float*) mpool_calloc(sizeof(float) * L * (FILLEN + LONGEST_DD_PULSE_LENGTH), m);
+    c->frame = (float*) mpool_calloc(sizeof(float) * L, m);
+    c->j = 0;
+    c->_init = true;
+    
+    for (int v = 0; v < L; ++v)
+    {
+        c->b[v] = 0.5f;
+        c->ib[v] = 2.0f;
+        c->ib1[v] = 2.0f;
+    }
+    for (int v = 0; v < c->numVoices; ++v) tMBTriangleBank_setFreq(bank, v, 440.f);
+}
+
+void tMBTriangleBank_free(tMBTriangleBank* const bank)
+{
+    _tMBTriangleBank* c = *bank;
+    
+    mpool_free((char*)c->frame, c->mempool);
+    mpool_free((char*)c->f, c->mempool);
+    mpool_free((char*)c->k, c->mempool);
+    mpool_free((char*)c->z, c->mempool);
+    mpool_free((char*)c->x, c->mempool);
+    mpool_free((char*)c->p, c->mempool);
+    mpool_free((char*)c->ib1, c->mempool);
+    mpool_free((char*)c->ib, c->mempool);
+    mpool_free((char*)c->b, c->mempool);
+    mpool_free((char*)c->inc, c->mempool);
+    mpool_free((char*)c->w, c->mempool);
+    mpool_free((char*)c->freq, c->mempool);
+    mpool_free((char*)c, c->mempool);
+}
+
+static void tMBTriangleBank_tickFrame(_tMBTriangleBank* c)
+{
+    int L = c->numLanes;
+    int j = c->j;
+    float* p = c->p;
+    float* x = c->x;
+    float* f = c->f;
+    
+    if (c->_init) {
+        for (int v = 0; v < L; ++v) p[v] = 0.5f * c->b[v];
+        c->_init = false;
+    }
+    
+    oscbank_advance(p, c->inc, L, 0);
+    
+    for (int v = 0; v < L; ++v)
+    {
+        float* fv = f + v;
+        float sw = c->w[v];
+        float b = c->b[v];
+        float ib = c->ib[v];
+        float ib1 = c->ib1[v];
+        int k = c->k[v];
+        
+        if (!k) {  /* slope currently up */
+            x[v] = -0.5f + p[v] * ib;
+            if (sw > 0)
+            {
+                if (p[v] >= b) {
+                    x[v] = 0.5f - (p[v] - b) * ib1;
+                    oscbank_place_slope_dd(fv, j, L, p[v] - b, sw, -ib1 - ib);
+                    k = 1;
+                }
+                if (p[v] >= 1.0f) {
+                    p[v] -= 1.0f;
+                    x[v] = -0.5f + p[v] * ib;
+                    oscbank_place_slope_dd(fv, j, L, p[v], sw, ib + ib1);
+                    k = 0;
+                }
+            }
+            else if (sw < 0)
+            {
+                if (p[v] < 0.0f) {
+                    p[v] += 1.0f;
+                    x[v] = 0.5f - (p[v] - b) * ib1;
+                    oscbank_place_slope_dd(fv, j, L, 1.0f - p[v], -sw, ib + ib1);
+                    k = 1;
+                }
+                if (k && p[v] < b) {
+                    x[v] = -0.5f + p[v] * ib;
+                    oscbank_place_slope_dd(fv, j, L, b - p[v], -sw, -ib1 - ib);
+                    k = 0;
+                }
+            }
+        } else {  /* slope currently down */
+            x[v] = 0.5f - (p[v] - b) * ib1;
+            if (sw > 0)
+            {
+                if (p[v] >= 1.0f) {
+                    p[v] -= 1.0f;
+                    x[v] = -0.5f + p[v] * ib;
+                    oscbank_place_slope_dd(fv, j, L, p[v], sw, ib + ib1);
+                    k = 0;
+                }
+                if (!k && p[v] >= b) {
+                    x[v] = 0.5f - (p[v] - b) * ib1;
+                    oscbank_place_slope_dd(fv, j, L, p[v] - b, sw, -ib1 - ib);
+                    k = 1;
+                }
+            }
+            else if (sw < 0)
+            {
+                if (p[v] < b) {
+                    x[v] = -0.5f + p[v] * ib;
+                    oscbank_place_slope_dd(fv, j, L, b - p[v], -sw, -ib1 - ib);
+                    k = 0;
+                }
+                if (p[v] < 0.0f) {
+                    p[v] += 1.0f;
+                    x[v] = 0.5f - (p[v] - b) * ib1;
+                    oscbank_place_slope_dd(fv, j, L, 1.0f - p[v], -sw, ib + ib1);
+                    k = 1;
+                }
+            }
+        }
+        c->k[v] = k;
+    }
+    
+    oscbank_accumulateAndFilter(f, j, x, c->z, c->frame, L);
+    c->j = oscbank_nextRow(f, j, STEP_DD_PULSE_LENGTH, L);
+}
+
+void tMBTriangleBank_tick(tMBTriangleBank* const bank, float* output)
+{
+    LEAF_PROFILE_OBJECT(bank);
+    _tMBTriangleBank* c = *bank;
+    
+    tMBTriangleBank_tickFrame(c);
+    memcpy(output, c->frame, sizeof(float) * c->numVoices);
+}
+
+void tMBTriangleBank_tickBlock(tMBTriangleBank* const bank, float** outputs, int size)
+{
+    LEAF_PROFILE_OBJECT(bank);
+    _tMBTriangleBank* c = *bank;
+    
+    for (int n = 0; n < size; ++n)
+    {
+        tMBTriangleBank_tickFrame(c);
+        oscbank_scatter(c->frame, outputs, c->numVoices, n);
+    }
+}
+
+void tMBTriangleBank_setFreq(tMBTriangleBank* const bank, int voice, float f)
+{
+    _tMBTriangleBank* c = *bank;
+    
+    if (voice < 0 || voice >= c->numVoices) return;
+    
+    c->freq[voice] = f;
+    c->w[voice] = f * c->invSampleRate;
+    c->inc[voice] = c->w[voice] - (int)c->w[voice];
+}
+
+void tMBTriangleBank_setWidth(tMBTriangleBank* const bank, int voice, float w)
+{
+    _tMBTriangleBank* c = *bank;
+    
+    if (voice < 0 || voice >= c->numVoices) return;
+    
+    float b = 0.5f * (1.0f + w);
+    c->b[voice] = b;
+    c->ib[voice] = 1.0f / b;
+    c->ib1[voice] = 1.0f / (1.0f - b);
+}
+
+void tMBTriangleBank_setSampleRate(tMBTriangleBank* const bank, float sr)
+{
+    _tMBTriangleBank* c = *bank;
+    
+    c->invSampleRate = 1.0f/sr;
+    for (int v = 0; v < c->numVoices; ++v) tMBTriangleBank_setFreq(bank, v, c->freq[v]);
+}
+
+
+
+// WaveTable
+void    tTable_init(tTable* const cy, float* waveTable, int size, LEAF* const leaf)
+{
+    tTable_initToPool(cy, waveTable, size, &leaf->mempool);
+}
+
+void    tTable_initToPool(tTable* const cy, float* waveTable, int size, tMempool* const mp)
+{
+    LEAF_PROFILE_POOL(mp);
+    _tMempool* m = *mp;
+    _tTable* c = *cy = (_tTable*)mpool_alloc(sizeof(_tTable), m);
+    c->mempool = m;
+    LEAF* leaf = c->mempool->leaf;
+    
+    c->waveTable = waveTable;
+    c->size = size;
+    c->inc = 0.0f;
+    c->phase = 0.0f;
+    c->invSampleRate = leaf->invSampleRate;
+}
+
+void    tTable_free(tTable* const cy)
+{
+    _tTable* c = *cy;
+    
+    mpool_free((char*)c, c->mempool);
+}
+
 void     tTable_setFreq(tTable* const cy, float freq)
 {
     _tTable* c = *cy;
@@ -1723,6 +3106,7 @@ void     tTable_setFreq(tTable* const cy, float freq)
 
 float   tTable_tick(tTable* const cy)
 {
+    LEAF_PROFILE_OBJECT(cy);
     _tTable* c = *cy;
     float temp;
     int intPart;
@@ -1754,6 +3138,62 @@ void     tTable_setSampleRate(tTable* const cy, float sr)
     tTable_setFreq(cy, c->freq);
 }
 
+// Checks a wavetable image and returns its level descriptors, or NULL if the image can't be used
+static const LEAFWaveTableImageLevel* wavetableimage_getLevels(const void* image, size_t imageSize, int equalSizes)
+{
+    const LEAFWaveTableImageHeader* header = (const LEAFWaveTableImageHeader*) image;
+    if (header == NULL || ((uintptr_t) header % sizeof(uint32_t)) != 0) return NULL;
+    if (imageSize < sizeof(LEAFWaveTableImageHeader)) return NULL;
+    if (memcmp(header->magic, LEAF_WAVETABLE_IMAGE_MAGIC, 4) != 0) return NULL;
+    if (header->version != LEAF_WAVETABLE_IMAGE_VERSION) return NULL;
+    if (header->format != LEAFWaveTableImageFloat32 && header->format != LEAFWaveTableImageInt16) return NULL;
+    // Oscillators always read two adjacent levels
+    if (header->numLevels < 2) return NULL;
+    if (header->numLevels > (imageSize - sizeof(LEAFWaveTableImageHeader)) / sizeof(LEAFWaveTableImageLevel)) return NULL;
+    
+    size_t sampleSize = header->format == LEAFWaveTableImageFloat32 ? sizeof(float) : sizeof(int16_t);
+    const LEAFWaveTableImageLevel* levels = (const LEAFWaveTableImageLevel*) (header + 1);
+    for (uint32_t t = 0; t < header->numLevels; ++t)
+    {
+        if (levels[t].size == 0) return NULL;
+        if (equalSizes && levels[t].size != levels[0].size) return NULL;
+        // Level data has to lie inside the image, at the aligned offsets the format requires,
+        // so float levels can always be read in place
+        if ((levels[t].offset % 16) != 0) return NULL;
+        if (levels[t].offset > imageSize) return NULL;
+        if (levels[t].size > (imageSize - levels[t].offset) / sampleSize) return NULL;
+    }
+    return levels;
+}
+
+// Points a level at the image data when it's float, otherwise converts it into the mempool
+static float* wavetableimage_getLevel(const void* image, const LEAFWaveTableImageLevel* level, _tMempool* m)
+{
+    const LEAFWaveTableImageHeader* header = (const LEAFWaveTableImageHeader*) image;
+    const char* data = (const char*) image + level->offset;
+    
+    if (header->format == LEAFWaveTableImageFloat32)
+    {
+        return (float*) data;
+    }
+    
+    float* table = (float*) mpool_alloc(sizeof(float) * level->size, m);
+    if (header->format == LEAFWaveTableImageFloat32)
+    {
+        memcpy(table, data, sizeof(float) * level->size);
+    }
+    else
+    {
+        for (uint32_t i = 0; i < level->size; ++i)
+        {
+            int16_t sample;
+            memcpy(&sample, data + i * sizeof(int16_t), sizeof(int16_t));
+            table[i] = sample * header->scale;
+        }
+    }
+    return table;
+}
+
 void tWaveTable_init(tWaveTable* const cy, float* table, int size, float maxFreq, LEAF* const leaf)
 {
     tWaveTable_initToPool(cy, table, size, maxFreq, &leaf->mempool);
@@ -1761,17 +3201,21 @@ void tWaveTable_init(tWaveTable* const cy, float* table, int size, float maxFreq
 
 void tWaveTable_initToPool(tWaveTable* const cy, float* table, int size, float maxFreq, tMempool* const mp)
 {
-    _tMempool* m = *mp;
-    _tWaveTable* c = *cy = (_tWaveTable*) mpool_alloc(sizeof(_tWaveTable), m);
-    c->mempool = m;
-    LEAF* leaf = c->mempool->leaf;
-    
-    c->sampleRate = leaf->sampleRate;
-    
-    c->maxFreq = maxFreq;
-    
+    LEAF_PROFILE_POOL(mp);
+    tWaveTable_initToPoolDeferred(cy, table, size, maxFreq, mp);
+    tWaveTable_buildStep(cy, INT_MAX);
+}
+
+void tWaveTable_initDeferred(tWaveTable* const cy, float* table, int size, float maxFreq, LEAF* const leaf)
+{
+    tWaveTable_initToPoolDeferred(cy, table, size, maxFreq, &leaf->mempool);
+}
+
+// Allocates the band-limited levels for the current sample rate and sets up to build them with tWaveTable_buildStep
+static void tWaveTable_startBuild(_tWaveTable* c)
+{
     // Determine base frequency
-    c->baseFreq = c->sampleRate / (float) size;
+    c->baseFreq = c->sampleRate / (float) c->size;
     c->invBaseFreq = 1.0f / c->baseFreq;
     
     // Determine how many tables we need
@@ -1784,51 +3228,176 @@ void tWaveTable_initToPool(tWaveTable* const cy, float* table, int size, float m
         f *= 2.0f; // pass this multiplier in to set spacing of tables? would need to change setFreq too
     }
     
-    c->size = size;
-    
     // Allocate memory for the tables
     c->tables = (float**) mpool_alloc(sizeof(float*) * c->numTables, c->mempool);
-    c->baseTable = (float*) mpool_alloc(sizeof(float) * c->size, c->mempool);
     c->tables[0] = c->baseTable;
     for (int t = 1; t < c->numTables; ++t)
     {
         c->tables[t] = (float*) mpool_alloc(sizeof(float) * c->size, c->mempool);
     }
     
+    // Only the base table can be read until the rest are built
+    c->numReady = 1;
+    c->buildLevel = 1;
+    c->buildPass = 0;
+    c->buildIndex = 0;
+    c->buildDone = 0;
+    c->buildTotal = 12 * c->size * (c->numTables - 1);
+    
+    // Make bandlimited copies
+    c->buildFreq = c->sampleRate * 0.25f; //start at half nyquist
+    // Not worth going over order 8 I think, and even 8 is only marginally better than 4.
+    tButterworth_initToPool(&c->bl, 8, -1.0f, c->buildFreq, &c->mempool);
+    tButterworth_setF2(&c->bl, c->buildFreq);
+}
+
+void tWaveTable_initToPoolDeferred(tWaveTable* const cy, float* table, int size, float maxFreq, tMempool* const mp)
+{
+    LEAF_PROFILE_POOL(mp);
+    _tMempool* m = *mp;
+    _tWaveTable* c = *cy = (_tWaveTable*) mpool_alloc(sizeof(_tWaveTable), m);
+    c->mempool = m;
+    LEAF* leaf = c->mempool->leaf;
+    
+    c->sampleRate = leaf->sampleRate;
+    
+    c->maxFreq = maxFreq;
+    
+    c->size = size;
+    c->fromImage = 0;
+    c->ownsLevels = 1;
+    
+    c->baseTable = (float*) mpool_alloc(sizeof(float) * c->size, c->mempool);
+    
     // Copy table
     for (int i = 0; i < c->size; ++i)
     {
         c->baseTable[i] = table[i];
     }
     
-    // Make bandlimited copies
-    f = c->sampleRate * 0.25; //start at half nyquist
-    // Not worth going over order 8 I think, and even 8 is only marginally better than 4.
-    tButterworth_initToPool(&c->bl, 8, -1.0f, f, mp);
-    for (int t = 1; t < c->numTables; ++t)
+    tWaveTable_startBuild(c);
+}
+
+void tWaveTable_initFromImage(tWaveTable* const cy, const void* image, size_t imageSize, LEAF* const leaf)
+{
+    tWaveTable_initToPoolFromImage(cy, image, imageSize, &leaf->mempool);
+}
+
+void tWaveTable_initToPoolFromImage(tWaveTable* const cy, const void* image, size_t imageSize, tMempool* const mp)
+{
+    LEAF_PROFILE_POOL(mp);
+    _tMempool* m = *mp;
+    _tWaveTable* c = *cy = (_tWaveTable*) mpool_alloc(sizeof(_tWaveTable), m);
+    c->mempool = m;
+    LEAF* leaf = c->mempool->leaf;
+    
+    c->sampleRate = leaf->sampleRate;
+    c->bl = NULL;
+    c->fromImage = 1;
+    c->ownsLevels = 0;
+    
+    const LEAFWaveTableImageHeader* header = (const LEAFWaveTableImageHeader*) image;
+    const LEAFWaveTableImageLevel* levels = wavetableimage_getLevels(image, imageSize, 1);
+    
+    if (levels == NULL)
+    {
+        LEAF_internalErrorCallback(leaf, LEAFInvalidImage);
+        
+        // Fall back to a silent table so oscillators can still use this one
+        c->size = 1;
+        c->numTables = 2;
+        c->maxFreq = 0.0f;
+        c->ownsLevels = 1;
+        c->tables = (float**) mpool_alloc(sizeof(float*) * c->numTables, c->mempool);
+        for (int t = 0; t < c->numTables; ++t)
+        {
+            c->tables[t] = (float*) mpool_calloc(sizeof(float), c->mempool);
+        }
+    }
+    else
+    {
+        c->size = levels[0].size;
+        c->numTables = header->numLevels;
+        c->maxFreq = header->maxFreq;
+        c->ownsLevels = header->format != LEAFWaveTableImageFloat32;
+        c->tables = (float**) mpool_alloc(sizeof(float*) * c->numTables, c->mempool);
+        for (int t = 0; t < c->numTables; ++t)
+        {
+            c->tables[t] = wavetableimage_getLevel(image, &levels[t], c->mempool);
+        }
+    }
+    c->baseTable = c->tables[0];
+    
+    c->baseFreq = c->sampleRate / (float) c->size;
+    c->invBaseFreq = 1.0f / c->baseFreq;
+    
+    // Nothing to build
+    c->numReady = c->numTables;
+    c->buildLevel = c->numTables;
+    c->buildPass = 0;
+    c->buildIndex = 0;
+    c->buildDone = 0;
+    c->buildTotal = 0;
+}
+
+int tWaveTable_buildStep(tWaveTable* const cy, int budgetSamples)
+{
+    _tWaveTable* c = *cy;
+    
+    while (c->buildLevel < c->numTables && budgetSamples > 0)
     {
-        tButterworth_setF2(&c->bl, f);
+        int t = c->buildLevel;
+        
         // Do several passes here to prevent errors at the beginning of the waveform
         // Not sure how many passes to do, seem to need more as the filter cutoff goes down
         // 12 might be excessive but seems to work for now.
-        for (int p = 0; p < 12; ++p)
+        int end = c->size;
+        if (end - c->buildIndex > budgetSamples) end = c->buildIndex + budgetSamples;
+        for (int i = c->buildIndex; i < end; ++i)
         {
-            for (int i = 0; i < c->size; ++i)
-            {
-                c->tables[t][i] = tButterworth_tick(&c->bl, c->tables[t-1][i]);
-            }
+            c->tables[t][i] = tButterworth_tick(&c->bl, c->tables[t-1][i]);
         }
-        f *= 0.5f; //halve the cutoff for next pass
+        budgetSamples -= end - c->buildIndex;
+        c->buildDone += end - c->buildIndex;
+        c->buildIndex = end;
+        
+        if (c->buildIndex < c->size) break;
+        c->buildIndex = 0;
+        if (++c->buildPass < 12) continue;
+        
+        // This level is finished and can be read
+        c->buildPass = 0;
+        c->numReady = ++c->buildLevel;
+        c->buildFreq *= 0.5f; //halve the cutoff for next pass
+        tButterworth_setF2(&c->bl, c->buildFreq);
+    }
+    
+    if (c->buildLevel < c->numTables) return 0;
+    
+    if (c->bl != NULL)
+    {
+        tButterworth_free(&c->bl);
+        c->bl = NULL;
     }
-    tButterworth_free(&c->bl);
+    return 1;
+}
+
+float tWaveTable_getBuildProgress(tWaveTable* const cy)
+{
+    _tWaveTable* c = *cy;
+    if (c->buildTotal <= 0) return 1.0f;
+    return (float) c->buildDone / (float) c->buildTotal;
 }
 
 void tWaveTable_free(tWaveTable* const cy)
 {
     _tWaveTable* c = *cy;
     
+    if (c->bl != NULL) tButterworth_free(&c->bl);
     for (int t = 0; t < c->numTables; ++t)
     {
+        // Levels read in place from an image don't belong to the mempool
+        if (!c->ownsLevels) break;
         mpool_free((char*)c->tables[t], c->mempool);
     }
     mpool_free((char*)c->tables, c->mempool);
@@ -1838,59 +3407,29 @@ void tWaveTable_free(tWaveTable* const cy)
 void tWaveTable_setSampleRate(tWaveTable* const cy, float sr)
 {
     _tWaveTable* c = *cy;
-        
-    // Changing the sample rate of a wavetable requires up to partially reinitialize
-    for (int t = 1; t < c->numTables; ++t)
-    {
-        mpool_free((char*)c->tables[t], c->mempool);
-    }
-    mpool_free((char*)c->tables, c->mempool);
     
-    c->sampleRate = sr;
-    
-    // Determine base frequency
-    c->baseFreq = c->sampleRate / (float) c->size;
-    c->invBaseFreq = 1.0f / c->baseFreq;
-    
-    // Determine how many tables we need
-    // Assume we need at least 2, the fundamental + one to account for setting extra anti aliasing
-    c->numTables = 2;
-    float f = c->baseFreq;
-    while (f < c->maxFreq)
+    // Levels from an image are kept as they are
+    if (c->fromImage)
     {
-        c->numTables++;
-        f *= 2.0f; // pass this multiplier in to set spacing of tables? would need to change setFreq too
+        c->sampleRate = sr;
+        c->baseFreq = c->sampleRate / (float) c->size;
+        c->invBaseFreq = 1.0f / c->baseFreq;
+        return;
     }
     
-    // Allocate memory for the tables
-    c->tables = (float**) mpool_alloc(sizeof(float*) * c->numTables, c->mempool);
-    c->tables[0] = c->baseTable;
+    // Changing the sample rate of a wavetable requires up to partially reinitialize
+    if (c->bl != NULL) tButterworth_free(&c->bl);
     for (int t = 1; t < c->numTables; ++t)
     {
-        c->tables[t] = (float*) mpool_alloc(sizeof(float) * c->size, c->mempool);
+        mpool_free((char*)c->tables[t], c->mempool);
     }
+    mpool_free((char*)c->tables, c->mempool);
     
-    // Make bandlimited copies
-    f = c->sampleRate * 0.25; //start at half nyquist
-    // Not worth going over order 8 I think, and even 8 is only marginally better than 4.
-    tButterworth_initToPool(&c->bl, 8, -1.0f, f, &c->mempool);
-    tButterworth_setSampleRate(&c->bl, c->sampleRate);
-    for (int t = 1; t < c->numTables; ++t)
-    {
-        tButterworth_setF2(&c->bl, f);
-        // Do several passes here to prevent errors at the beginning of the waveform
-        // Not sure how many passes to do, seem to need more as the filter cutoff goes down
-        // 12 might be excessive but seems to work for now.
-        for (int p = 0; p < 12; ++p)
-        {
-            for (int i = 0; i < c->size; ++i)
-            {
-                c->tables[t][i] = tButterworth_tick(&c->bl, c->tables[t-1][i]);
-            }
-        }
-        f *= 0.5f; //halve the cutoff for next pass
-    }
-    tButterworth_free(&c->bl);
+    c->sampleRate = sr;
+    
+    tWaveTable_startBuild(c);
+    tButterworth_setSampleRate(&c->bl, c->sampleRate);
+    tWaveTable_buildStep(cy, INT_MAX);
 }
 
 //=======================================================================================
@@ -1903,6 +3442,7 @@ void tWaveOsc_init(tWaveOsc* const cy, tWaveTable* const table, LEAF* const leaf
 
 void tWaveOsc_initToPool(tWaveOsc* const cy, tWaveTable* const table, tMempool* const mp)
 {
+    LEAF_PROFILE_POOL(mp);
     _tMempool* m = *mp;
     _tWaveOsc* c = *cy = (_tWaveOsc*) mpool_alloc(sizeof(_tWaveOsc), m);
     c->mempool = m;
@@ -1928,6 +3468,7 @@ void tWaveOsc_free(tWaveOsc* const cy)
 
 float tWaveOsc_tick(tWaveOsc* const cy)
 {
+    LEAF_PROFILE_OBJECT(cy);
     _tWaveOsc* c = *cy;
     
     float temp;
@@ -1939,6 +3480,15 @@ float tWaveOsc_tick(tWaveOsc* const cy)
     int size = c->table->size;
     float** tables = c->table->tables;
     
+    // Fall back to the highest level built so far
+    int lo = c->oct, hi = c->oct + 1;
+    int ready = c->table->numReady - 1;
+    if (hi > ready)
+    {
+        hi = ready;
+        if (lo > ready) lo = ready;
+    }
+    
     // Phasor increment
     c->phase += c->inc;
     if (c->phase + c->phaseOffset >= 1.0f) c->phase -= 1.0f;
@@ -1949,16 +3499,16 @@ float tWaveOsc_tick(tWaveOsc* const cy)
     
     idx = (int)temp;
     frac = temp - (float)idx;
-    samp0 = tables[c->oct][idx];
+    samp0 = tables[lo][idx];
     if (++idx >= size) idx = 0;
-    samp1 = tables[c->oct][idx];
+    samp1 = tables[lo][idx];
     
     float oct0 = (samp0 + (samp1 - samp0) * frac);
     
     idx = (int)temp;
-    samp0 = tables[c->oct+1][idx];
+    samp0 = tables[hi][idx];
     if (++idx >= size) idx = 0;
-    samp1 = tables[c->oct+1][idx];
+    samp1 = tables[hi][idx];
     
     float oct1 = (samp0 + (samp1 - samp0) * frac);
     
@@ -2020,9 +3570,11 @@ void    tWaveSynth_init(tWaveSynth* const cy, int numVoices, float** tables, int
 void    tWaveSynth_initToPool(tWaveSynth* const cy, int numVoices, float** tables, int* sizes,
                               int numTables, float maxFreq, tMempool* const mp)
 {
+    LEAF_PROFILE_POOL(mp);
     _tMempool* m = *mp;
     _tWaveSynth* c = *cy = (_tWaveSynth*) mpool_alloc(sizeof(_tWaveSynth), m);
     c->mempool = m;
+    LEAF* leaf = c->mempool->leaf;
     
     c->numTables = 0;
     for (int t = 0; t < numTables; ++t)
@@ -2031,9 +3583,9 @@ void    tWaveSynth_initToPool(tWaveSynth* const cy, int numVoices, float** table
     }
     
     c->tables = (tWaveTable*) mpool_alloc(sizeof(tWaveTable) * c->numTables, m);
-    c->oscs = (tWaveOsc**) mpool_alloc(sizeof(tWaveOsc*) * c->numTables, m);
 
     c->numVoices = numVoices;
+    c->numLanes = oscbank_numLanes(numVoices);
     
     int i = 0;
     for (int t = 0; t < numTables; ++t)
@@ -2041,17 +3593,29 @@ void    tWaveSynth_initToPool(tWaveSynth* const cy, int numVoices, float** table
         if (sizes[t] > 0)
         {
             tWaveTable_initToPool(&c->tables[i], tables[t], sizes[t], maxFreq, mp);
-            c->oscs[i] = (tWaveOsc*) mpool_alloc(sizeof(tWaveOsc) * c->numVoices, m);
-            for (int v = 0; v < c->numVoices; ++v) tWaveOsc_initToPool(&c->oscs[i][v], &c->tables[i], mp);
             i++;
         }
     }
     
+    // Voices share one phase across tables; each table only adds its own offset and octave selection
+    int L = c->numLanes;
+    c->phase = (float*) mpool_calloc(sizeof(float) * L, m);
+    c->inc = (float*) mpool_calloc(sizeof(float) * L, m);
+    c->freq = (float*) mpool_calloc(sizeof(float) * L, m);
+    c->oct = (int*) mpool_calloc(sizeof(int) * L * c->numTables, m);
+    c->w = (float*) mpool_calloc(sizeof(float) * L * c->numTables, m);
+    c->phaseOffset = (float*) mpool_calloc(sizeof(float) * c->numTables, m);
+    c->scratch = (float*) mpool_calloc(sizeof(float) * L * 8, m);
+    
     c->g = (float*) mpool_alloc(sizeof(float) * c->numTables, m);
     for (int i = 0; i < c->numTables; ++i)  c->g[i] = 1.0f;
     
     c->index = 0.0f;
     c->maxFreq = maxFreq;
+    c->aa = 0.5f;
+    c->invSampleRate = leaf->invSampleRate;
+    
+    for (int v = 0; v < c->numVoices; ++v) tWaveSynth_setFreq(cy, v, 220);
 }
 
 void    tWaveSynth_free(tWaveSynth* const cy)
@@ -2061,34 +3625,163 @@ void    tWaveSynth_free(tWaveSynth* const cy)
     for (int i = 0; i < c->numTables; ++i)
     {
         tWaveTable_free(&c->tables[i]);
-        for (int v = 0; v < c->numVoices; ++v) tWaveOsc_free(&c->oscs[i][v]);
-        mpool_free((char*)c->oscs[i], c->mempool);
     }
+    mpool_free((char*)c->scratch, c->mempool);
+    mpool_free((char*)c->phaseOffset, c->mempool);
+    mpool_free((char*)c->w, c->mempool);
+    mpool_free((char*)c->oct, c->mempool);
+    mpool_free((char*)c->freq, c->mempool);
+    mpool_free((char*)c->inc, c->mempool);
+    mpool_free((char*)c->phase, c->mempool);
     mpool_free((char*)c->g, c->mempool);
-    mpool_free((char*)c->oscs, c->mempool);
     mpool_free((char*)c->tables, c->mempool);
     mpool_free((char*)c, c->mempool);
 }
 
-float   tWaveSynth_tick(tWaveSynth* const cy)
+// out = lerp(lerp(a0, a1, frac), lerp(b0, b1, frac), w), as in tWaveOsc_tick
+static inline void tWaveSynth_interpolate(float* out, const float* a0, const float* a1, const float* b0, const float* b1,
+                                          const float* frac, const float* w, int numLanes)
 {
-    _tWaveSynth* c = *cy;
+    int i = 0;
+#if LEAF_SIMD_SSE
+    for (; i < numLanes; i += 4)
+    {
+        __m128 f = _mm_loadu_ps(frac + i);
+        __m128 s0 = _mm_loadu_ps(a0 + i);
+        __m128 oct0 = _mm_add_ps(s0, _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(a1 + i), s0), f));
+        s0 = _mm_loadu_ps(b0 + i);
+        __m128 oct1 = _mm_add_ps(s0, _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(b1 + i), s0), f));
+        _mm_storeu_ps(out + i, _mm_add_ps(oct0, _mm_mul_ps(_mm_sub_ps(oct1, oct0), _mm_loadu_ps(w + i))));
+    }
+#elif LEAF_SIMD_NEON
+    for (; i < numLanes; i += 4)
+    {
+        float32x4_t f = vld1q_f32(frac + i);
+        float32x4_t s0 = vld1q_f32(a0 + i);
+        float32x4_t oct0 = vaddq_f32(s0, vmulq_f32(vsubq_f32(vld1q_f32(a1 + i), s0), f));
+        s0 = vld1q_f32(b0 + i);
+        float32x4_t oct1 = vaddq_f32(s0, vmulq_f32(vsubq_f32(vld1q_f32(b1 + i), s0), f));
+        vst1q_f32(out + i, vaddq_f32(oct0, vmulq_f32(vsubq_f32(oct1, oct0), vld1q_f32(w + i))));
+    }
+#endif
+    for (; i < numLanes; ++i)
+    {
+        float oct0 = a0[i] + (a1[i] - a0[i]) * frac[i];
+        float oct1 = b0[i] + (b1[i] - b0[i]) * frac[i];
+        out[i] = oct0 + (oct1 - oct0) * w[i];
+    }
+}
+
+// Reads table t for lanes [start, end) into out. Tables outside the set read as silence.
+static void tWaveSynth_readTable(_tWaveSynth* c, int t, float* out, int start, int end)
+{
+    int L = c->numLanes;
+    
+    if (t < 0 || t >= c->numTables)
+    {
+        for (int v = start; v < end; ++v) out[v] = 0.0f;
+        return;
+    }
+    
+    float* a0 = c->scratch + L * 2;
+    float* a1 = c->scratch + L * 3;
+    float* b0 = c->scratch + L * 4;
+    float* b1 = c->scratch + L * 5;
+    float* frac = c->scratch + L * 6;
+    
+    _tWaveTable* table = c->tables[t];
+    int size = table->size;
+    float** tables = table->tables;
+    float offset = c->phaseOffset[t];
+    int* oct = c->oct + t * L;
+    int ready = table->numReady - 1;
+    
+    // Table reads are gathers, so this part stays scalar
+    for (int v = start; v < end; ++v)
+    {
+        float phase = c->phase[v] + offset;
+        if (phase >= 1.0f) phase -= 1.0f;
+        if (phase < 0.0f) phase += 1.0f;
+        
+        float temp = size * phase;
+        int idx = (int)temp;
+        int idx1 = idx + 1;
+        if (idx1 >= size) idx1 = 0;
+        frac[v] = temp - (float)idx;
+        
+        // Fall back to the highest level built so far
+        int lo = oct[v], hi = oct[v] + 1;
+        if (hi > ready)
+        {
+            hi = ready;
+            if (lo > ready) lo = ready;
+        }
+        float* t0 = tables[lo];
+        float* t1 = tables[hi];
+        a0[v] = t0[idx];
+        a1[v] = t0[idx1];
+        b0[v] = t1[idx];
+        b1[v] = t1[idx1];
+    }
     
+    if (start == 0 && end == L)
+    {
+        tWaveSynth_interpolate(out, a0, a1, b0, b1, frac, c->w + t * L, L);
+    }
+    else
+    {
+        float* w = c->w + t * L;
+        for (int v = start; v < end; ++v)
+        {
+            float oct0 = a0[v] + (a1[v] - a0[v]) * frac[v];
+            float oct1 = b0[v] + (b1[v] - b0[v]) * frac[v];
+            out[v] = oct0 + (oct1 - oct0) * w[v];
+        }
+    }
+}
+
+static inline void tWaveSynth_getFade(_tWaveSynth* c, int* o1, int* o2, float* mix)
+{
     float f = c->index * (c->numTables - 1);
     
-    int o1 = (int)f;
-    int o2 = o1 + 1;
-    if (c->index >= 1.0f) o2 = o1;
-    float mix = f - o1;
+    *o1 = (int)f;
+    *o2 = *o1 + 1;
+    if (c->index >= 1.0f) *o2 = *o1;
+    *mix = f - *o1;
+}
+
+// Advances every voice and writes the gain-weighted reads of the two faded tables to s1 and s2
+static void tWaveSynth_tickFrame(_tWaveSynth* c, int* o1, int* o2, float* mix)
+{
+    int L = c->numLanes;
+    
+    tWaveSynth_getFade(c, o1, o2, mix);
+    
+    oscbank_advance(c->phase, c->inc, L, 1);
+    
+    tWaveSynth_readTable(c, *o1, c->scratch, 0, L);
+    tWaveSynth_readTable(c, *o2, c->scratch + L, 0, L);
+}
+
+float   tWaveSynth_tick(tWaveSynth* const cy)
+{
+    LEAF_PROFILE_OBJECT(cy);
+    _tWaveSynth* c = *cy;
     
+    int o1, o2;
+    float mix;
+    tWaveSynth_tickFrame(c, &o1, &o2, &mix);
+    
+    float* r1 = c->scratch;
+    float* r2 = c->scratch + c->numLanes;
     float s1 = 0.f, s2 = 0.f;
-    for (int t = 0; t < c->numTables; ++t)
+    for (int v = 0; v < c->numVoices; ++v)
     {
-        float s0 = 0.f;
-        for (int v = 0; v < c->numVoices; ++v) s0 += tWaveOsc_tick(&c->oscs[t][v]);
-        if (t == o1) s1 = s0 * c->g[t];
-        if (t == o2) s2 = s0 * c->g[t];
+        s1 += r1[v];
+        s2 += r2[v];
     }
+    s1 = (o1 < c->numTables && o1 >= 0) ? s1 * c->g[o1] : 0.0f;
+    s2 = (o2 < c->numTables && o2 >= 0) ? s2 * c->g[o2] : 0.0f;
     
     // Ideally should determine correlation to get a good equal power fade between tables
     return s1 + (s2 - s1) * mix;
@@ -2096,46 +3789,130 @@ float   tWaveSynth_tick(tWaveSynth* const cy)
 
 float tWaveSynth_tickVoice(tWaveSynth* const cy, int voice)
 {
+    LEAF_PROFILE_OBJECT(cy);
     _tWaveSynth* c = *cy;
     
-    float f = c->index * (c->numTables - 1);
+    int o1, o2;
+    float mix;
+    tWaveSynth_getFade(c, &o1, &o2, &mix);
     
-    int o1 = (int)f;
-    int o2 = o1 + 1;
-    if (c->index >= 1.0f) o2 = o1;
-    float mix = f - o1;
+    c->phase[voice] += c->inc[voice];
+    if (c->phase[voice] >= 1.0f) c->phase[voice] -= 1.0f;
+    if (c->phase[voice] < 0.0f) c->phase[voice] += 1.0f;
     
-    float s1 = 0.f, s2 = 0.f;
-    for (int t = 0; t < c->numTables; ++t)
-    {
-        // Should we tick every voice anyway to preserve relative phases?
-        float s0 = tWaveOsc_tick(&c->oscs[t][voice]);
-        if (t == o1) s1 = s0 * c->g[t];
-        if (t == o2) s2 = s0 * c->g[t];
-    }
+    tWaveSynth_readTable(c, o1, c->scratch, voice, voice + 1);
+    tWaveSynth_readTable(c, o2, c->scratch + c->numLanes, voice, voice + 1);
+    float s1 = (o1 < c->numTables && o1 >= 0) ? c->scratch[voice] * c->g[o1] : 0.0f;
+    float s2 = (o2 < c->numTables && o2 >= 0) ? c->scratch[c->numLanes + voice] * c->g[o2] : 0.0f;
     
     // Ideally should determine correlation to get a good equal power fade between tables
     return s1 + (s2 - s1) * mix;
 }
 
-void tWaveSynth_setFreq(tWaveSynth* const cy, int voice, float freq)
+void    tWaveSynth_tickVoices(tWaveSynth* const cy, float* output)
 {
+    LEAF_PROFILE_OBJECT(cy);
     _tWaveSynth* c = *cy;
-    for (int t = 0; t < c->numTables; ++t)
+    
+    int o1, o2;
+    float mix;
+    tWaveSynth_tickFrame(c, &o1, &o2, &mix);
+    
+    float g1 = (o1 < c->numTables && o1 >= 0) ? c->g[o1] : 0.0f;
+    float g2 = (o2 < c->numTables && o2 >= 0) ? c->g[o2] : 0.0f;
+    float* r1 = c->scratch;
+    float* r2 = c->scratch + c->numLanes;
+    for (int v = 0; v < c->numVoices; ++v)
     {
-        tWaveOsc_setFreq(&c->oscs[t][voice], freq);
+        float s1 = r1[v] * g1;
+        float s2 = r2[v] * g2;
+        output[v] = s1 + (s2 - s1) * mix;
     }
 }
 
-void tWaveSynth_setAntiAliasing(tWaveSynth* const cy, float aa)
+void    tWaveSynth_tickBlock(tWaveSynth* const cy, float* output, int size)
 {
+    LEAF_PROFILE_OBJECT(cy);
     _tWaveSynth* c = *cy;
-    for (int t = 0; t < c->numTables; ++t)
+    int L = c->numLanes;
+    
+    // The index and gains can't change within a block, so the fade is only worked out once
+    int o1, o2;
+    float mix;
+    tWaveSynth_getFade(c, &o1, &o2, &mix);
+    float g1 = (o1 < c->numTables && o1 >= 0) ? c->g[o1] : 0.0f;
+    float g2 = (o2 < c->numTables && o2 >= 0) ? c->g[o2] : 0.0f;
+    
+    float* r1 = c->scratch;
+    float* r2 = c->scratch + L;
+    for (int n = 0; n < size; ++n)
     {
+        oscbank_advance(c->phase, c->inc, L, 1);
+        tWaveSynth_readTable(c, o1, r1, 0, L);
+        tWaveSynth_readTable(c, o2, r2, 0, L);
+        
+        float s1 = 0.f, s2 = 0.f;
         for (int v = 0; v < c->numVoices; ++v)
         {
-            tWaveOsc_setAntiAliasing(&c->oscs[t][v], aa);
+            s1 += r1[v];
+            s2 += r2[v];
         }
+        s1 *= g1;
+        s2 *= g2;
+        output[n] = s1 + (s2 - s1) * mix;
+    }
+}
+
+void    tWaveSynth_tickVoicesBlock(tWaveSynth* const cy, float** outputs, int size)
+{
+    LEAF_PROFILE_OBJECT(cy);
+    _tWaveSynth* c = *cy;
+    
+    float* frame = c->scratch + c->numLanes * 7;
+    for (int n = 0; n < size; ++n)
+    {
+        tWaveSynth_tickVoices(cy, frame);
+        oscbank_scatter(frame, outputs, c->numVoices, n);
+    }
+}
+
+void tWaveSynth_setFreq(tWaveSynth* const cy, int voice, float freq)
+{
+    _tWaveSynth* c = *cy;
+    
+    if (voice < 0 || voice >= c->numVoices) return;
+    
+    c->freq[voice] = freq;
+    c->inc[voice] = freq * c->invSampleRate;
+    c->inc[voice] -= (int)c->inc[voice];
+    
+    // Same octave selection as tWaveOsc_setFreq, per table since tables can differ in size
+    for (int t = 0; t < c->numTables; ++t)
+    {
+        _tWaveTable* table = c->tables[t];
+        
+        // abs for negative frequencies
+        float w = fabsf(freq * table->invBaseFreq);
+        
+        w = log2f_approx(w) + c->aa;
+        if (w < 0.0f) w = 0.0f;
+        int oct = (int)w;
+        w -= oct;
+        
+        if (oct >= table->numTables - 1) oct = table->numTables - 2;
+        
+        c->oct[t * c->numLanes + voice] = oct;
+        c->w[t * c->numLanes + voice] = w;
+    }
+}
+
+void tWaveSynth_setAntiAliasing(tWaveSynth* const cy, float aa)
+{
+    _tWaveSynth* c = *cy;
+    c->aa = aa;
+    for (int v = 0; v < c->numVoices; ++v)
+    {
+        tWaveSynth_setFreq(cy, v, c->freq[v]);
     }
 }
 
@@ -2156,10 +3933,7 @@ void tWaveSynth_setIndexPhase(tWaveSynth* const cy, int i, float phase)
 {
     _tWaveSynth* c = *cy;
     if (i >= c->numTables) return;
-    for (int v = 0; v < c->numVoices; ++v)
-    {
-        tWaveOsc_setPhaseOffset(&c->oscs[i][v], phase);
-    }
+    c->phaseOffset[i] = phase - (int)phase;
 }
 
 void tWaveSynth_setSampleRate(tWaveSynth* const cy, float sr)
@@ -2169,7 +3943,11 @@ void tWaveSynth_setSampleRate(tWaveSynth* const cy, float sr)
     for (int i = 0; i < c->numTables; ++i)
     {
         tWaveTable_setSampleRate(&c->tables[i], sr);
-        for (int v = 0; v < c->numVoices; ++v) tWaveOsc_setSampleRate(&c->oscs[i][v], sr);
+    }
+    c->invSampleRate = 1.0f/sr;
+    for (int v = 0; v < c->numVoices; ++v)
+    {
+        tWaveSynth_setFreq(cy, v, c->freq[v]);
     }
 }
 
@@ -2183,15 +3961,19 @@ void tWaveTableS_init(tWaveTableS* const cy, float* table, int size, float maxFr
 
 void tWaveTableS_initToPool(tWaveTableS* const cy, float* table, int size, float maxFreq, tMempool* const mp)
 {
-    _tMempool* m = *mp;
-    _tWaveTableS* c = *cy = (_tWaveTableS*) mpool_alloc(sizeof(_tWaveTableS), m);
-    c->mempool = m;
-    LEAF* leaf = c->mempool->leaf;
-    
-    c->sampleRate = leaf->sampleRate;
-    
-    c->maxFreq = maxFreq;
-    
+    LEAF_PROFILE_POOL(mp);
+    tWaveTableS_initToPoolDeferred(cy, table, size, maxFreq, mp);
+    tWaveTableS_buildStep(cy, INT_MAX);
+}
+
+void tWaveTableS_initDeferred(tWaveTableS* const cy, float* table, int size, float maxFreq, LEAF* const leaf)
+{
+    tWaveTableS_initToPoolDeferred(cy, table, size, maxFreq, &leaf->mempool);
+}
+
+// Allocates the band-limited levels for the current sample rate and sets up to build them with tWaveTableS_buildStep
+static void tWaveTableS_startBuild(_tWaveTableS* c, int size)
+{
     // Determine base frequency
     c->baseFreq = c->sampleRate / (float) size;
     c->invBaseFreq = 1.0f / c->baseFreq;
@@ -2199,7 +3981,7 @@ void tWaveTableS_initToPool(tWaveTableS* const cy, float* table, int size, float
     // Determine how many tables we need
     c->numTables = 2;
     float f = c->baseFreq;
-    while (f < maxFreq)
+    while (f < c->maxFreq)
     {
         c->numTables++;
         f *= 2.0f; // pass this multiplier in to set spacing of tables?
@@ -2208,48 +3990,180 @@ void tWaveTableS_initToPool(tWaveTableS* const cy, float* table, int size, float
     // Allocate memory for the tables
     c->tables = (float**) mpool_alloc(sizeof(float*) * c->numTables, c->mempool);
     c->sizes = (int*) mpool_alloc(sizeof(int) * c->numTables, c->mempool);
-    c->sizes[0] = size;
-    c->baseTable = (float*) mpool_alloc(sizeof(float) * c->sizes[0], c->mempool);
     c->tables[0] = c->baseTable;
+    c->sizes[0] = size;
+    c->buildTotal = 0;
     for (int t = 1; t < c->numTables; ++t)
     {
         c->sizes[t] = c->sizes[t-1] / 2;
         c->tables[t] = (float*) mpool_alloc(sizeof(float) * c->sizes[t], c->mempool);
+        c->buildTotal += 12 * c->sizes[t-1];
     }
     
+    // Only the base table can be read until the rest are built
+    c->numReady = 1;
+    c->buildLevel = 1;
+    c->buildPass = 0;
+    c->buildIndex = 0;
+    c->buildDone = 0;
+    
+    // Make bandlimited copies
+    // Not worth going over order 8 I think, and even 8 is only marginally better than 4.
+    tButterworth_initToPool(&c->bl, 8, -1.0f, c->sampleRate * 0.25f, &c->mempool);
+    tOversampler_initToPool(&c->ds, 2, 1, &c->mempool);
+}
+
+void tWaveTableS_initToPoolDeferred(tWaveTableS* const cy, float* table, int size, float maxFreq, tMempool* const mp)
+{
+    LEAF_PROFILE_POOL(mp);
+    _tMempool* m = *mp;
+    _tWaveTableS* c = *cy = (_tWaveTableS*) mpool_alloc(sizeof(_tWaveTableS), m);
+    c->mempool = m;
+    LEAF* leaf = c->mempool->leaf;
+    
+    c->sampleRate = leaf->sampleRate;
+    
+    c->maxFreq = maxFreq;
+    c->fromImage = 0;
+    c->ownsLevels = 1;
+    
+    c->baseTable = (float*) mpool_alloc(sizeof(float) * size, c->mempool);
+    
     // Copy table
-    for (int i = 0; i < c->sizes[0]; ++i)
+    for (int i = 0; i < size; ++i)
     {
         c->baseTable[i] = table[i];
     }
     
-    // Make bandlimited copies
-    // Not worth going over order 8 I think, and even 8 is only marginally better than 4.
-    tButterworth_initToPool(&c->bl, 8, -1.0f, c->sampleRate * 0.25f, mp);
-    tOversampler_initToPool(&c->ds, 2, 1, mp);
-    for (int t = 1; t < c->numTables; ++t)
+    tWaveTableS_startBuild(c, size);
+}
+
+void tWaveTableS_initFromImage(tWaveTableS* const cy, const void* image, size_t imageSize, LEAF* const leaf)
+{
+    tWaveTableS_initToPoolFromImage(cy, image, imageSize, &leaf->mempool);
+}
+
+void tWaveTableS_initToPoolFromImage(tWaveTableS* const cy, const void* image, size_t imageSize, tMempool* const mp)
+{
+    LEAF_PROFILE_POOL(mp);
+    _tMempool* m = *mp;
+    _tWaveTableS* c = *cy = (_tWaveTableS*) mpool_alloc(sizeof(_tWaveTableS), m);
+    c->mempool = m;
+    LEAF* leaf = c->mempool->leaf;
+    
+    c->sampleRate = leaf->sampleRate;
+    c->bl = NULL;
+    c->fromImage = 1;
+    c->ownsLevels = 0;
+    
+    const LEAFWaveTableImageHeader* header = (const LEAFWaveTableImageHeader*) image;
+    const LEAFWaveTableImageLevel* levels = wavetableimage_getLevels(image, imageSize, 0);
+    
+    if (levels == NULL)
+    {
+        LEAF_internalErrorCallback(leaf, LEAFInvalidImage);
+        
+        // Fall back to a silent table so oscillators can still use this one
+        c->numTables = 2;
+        c->maxFreq = 0.0f;
+        c->ownsLevels = 1;
+        c->tables = (float**) mpool_alloc(sizeof(float*) * c->numTables, c->mempool);
+        c->sizes = (int*) mpool_alloc(sizeof(int) * c->numTables, c->mempool);
+        for (int t = 0; t < c->numTables; ++t)
+        {
+            c->sizes[t] = 1;
+            c->tables[t] = (float*) mpool_calloc(sizeof(float), c->mempool);
+        }
+    }
+    else
+    {
+        c->numTables = header->numLevels;
+        c->maxFreq = header->maxFreq;
+        c->ownsLevels = header->format != LEAFWaveTableImageFloat32;
+        c->tables = (float**) mpool_alloc(sizeof(float*) * c->numTables, c->mempool);
+        c->sizes = (int*) mpool_alloc(sizeof(int) * c->numTables, c->mempool);
+        for (int t = 0; t < c->numTables; ++t)
+        {
+            c->sizes[t] = levels[t].size;
+            c->tables[t] = wavetableimage_getLevel(image, &levels[t], c->mempool);
+        }
+    }
+    c->baseTable = c->tables[0];
+    
+    c->baseFreq = c->sampleRate / (float) c->sizes[0];
+    c->invBaseFreq = 1.0f / c->baseFreq;
+    
+    // Nothing to build
+    c->numReady = c->numTables;
+    c->buildLevel = c->numTables;
+    c->buildPass = 0;
+    c->buildIndex = 0;
+    c->buildDone = 0;
+    c->buildTotal = 0;
+}
+
+int tWaveTableS_buildStep(tWaveTableS* const cy, int budgetSamples)
+{
+    _tWaveTableS* c = *cy;
+    
+    // The budget counts samples of the level being read; each output sample consumes two
+    while (c->buildLevel < c->numTables && budgetSamples > 1)
     {
+        int t = c->buildLevel;
+        
         // Similar to tWaveTable, doing multiple passes here helps, but not sure what number is optimal
-        for (int p = 0; p < 12; ++p)
+        int end = c->sizes[t];
+        if (end - c->buildIndex > budgetSamples / 2) end = c->buildIndex + budgetSamples / 2;
+        for (int i = c->buildIndex; i < end; ++i)
         {
-            for (int i = 0; i < c->sizes[t]; ++i)
-            {
-                c->dsBuffer[0] = tButterworth_tick(&c->bl, c->tables[t-1][i*2]);
-                c->dsBuffer[1] = tButterworth_tick(&c->bl, c->tables[t-1][(i*2)+1]);
-                c->tables[t][i] = tOversampler_downsample(&c->ds, c->dsBuffer);
-            }
+            c->dsBuffer[0] = tButterworth_tick(&c->bl, c->tables[t-1][i*2]);
+            c->dsBuffer[1] = tButterworth_tick(&c->bl, c->tables[t-1][(i*2)+1]);
+            c->tables[t][i] = tOversampler_downsample(&c->ds, c->dsBuffer);
         }
+        budgetSamples -= (end - c->buildIndex) * 2;
+        c->buildDone += (end - c->buildIndex) * 2;
+        c->buildIndex = end;
+        
+        if (c->buildIndex < c->sizes[t]) break;
+        c->buildIndex = 0;
+        if (++c->buildPass < 12) continue;
+        
+        // This level is finished and can be read
+        c->buildPass = 0;
+        c->numReady = ++c->buildLevel;
     }
-    tOversampler_free(&c->ds);
-    tButterworth_free(&c->bl);
+    
+    if (c->buildLevel < c->numTables) return 0;
+    
+    if (c->bl != NULL)
+    {
+        tOversampler_free(&c->ds);
+        tButterworth_free(&c->bl);
+        c->bl = NULL;
+    }
+    return 1;
+}
+
+float tWaveTableS_getBuildProgress(tWaveTableS* const cy)
+{
+    _tWaveTableS* c = *cy;
+    if (c->buildTotal <= 0) return 1.0f;
+    return (float) c->buildDone / (float) c->buildTotal;
 }
 
 void    tWaveTableS_free(tWaveTableS* const cy)
 {
     _tWaveTableS* c = *cy;
     
+    if (c->bl != NULL)
+    {
+        tOversampler_free(&c->ds);
+        tButterworth_free(&c->bl);
+    }
     for (int t = 0; t < c->numTables; ++t)
     {
+        // Levels read in place from an image don't belong to the mempool
+        if (!c->ownsLevels) break;
         mpool_free((char*)c->tables[t], c->mempool);
     }
     mpool_free((char*)c->tables, c->mempool);
@@ -2263,59 +4177,32 @@ void    tWaveTableS_setSampleRate(tWaveTableS* const cy, float sr)
     
     int size = c->sizes[0];
     
-    for (int t = 1; t < c->numTables; ++t)
+    // Levels from an image are kept as they are
+    if (c->fromImage)
     {
-        mpool_free((char*)c->tables[t], c->mempool);
+        c->sampleRate = sr;
+        c->baseFreq = c->sampleRate / (float) size;
+        c->invBaseFreq = 1.0f / c->baseFreq;
+        return;
     }
-    mpool_free((char*)c->tables, c->mempool);
-    mpool_free((char*)c->sizes, c->mempool);
-    
-    c->sampleRate = sr;
     
-    // Determine base frequency
-    c->baseFreq = c->sampleRate / (float) size;
-    c->invBaseFreq = 1.0f / c->baseFreq;
-    
-    // Determine how many tables we need
-    c->numTables = 2;
-    float f = c->baseFreq;
-    while (f < c->maxFreq)
+    if (c->bl != NULL)
     {
-        c->numTables++;
-        f *= 2.0f; // pass this multiplier in to set spacing of tables?
+        tOversampler_free(&c->ds);
+        tButterworth_free(&c->bl);
     }
-    
-    // Allocate memory for the tables
-    c->tables = (float**) mpool_alloc(sizeof(float*) * c->numTables, c->mempool);
-    c->sizes = (int*) mpool_alloc(sizeof(int) * c->numTables, c->mempool);
-    c->tables[0] = c->baseTable;
-    c->sizes[0] = size;
     for (int t = 1; t < c->numTables; ++t)
     {
-        c->sizes[t] = c->sizes[t-1] / 2;
-        c->tables[t] = (float*) mpool_alloc(sizeof(float) * c->sizes[t], c->mempool);
+        mpool_free((char*)c->tables[t], c->mempool);
     }
+    mpool_free((char*)c->tables, c->mempool);
+    mpool_free((char*)c->sizes, c->mempool);
     
-    // Make bandlimited copies
-    // Not worth going over order 8 I think, and even 8 is only marginally better than 4.
-    tButterworth_initToPool(&c->bl, 8, -1.0f, c->sampleRate * 0.25f, &c->mempool);
+    c->sampleRate = sr;
+    
+    tWaveTableS_startBuild(c, size);
     tButterworth_setSampleRate(&c->bl, c->sampleRate);
-    tOversampler_initToPool(&c->ds, 2, 1, &c->mempool);
-    for (int t = 1; t < c->numTables; ++t)
-    {
-        // Similar to tWaveTable, doing multiple passes here helps, but not sure what number is optimal
-        for (int p = 0; p < 12; ++p)
-        {
-            for (int i = 0; i < c->sizes[t]; ++i)
-            {
-                c->dsBuffer[0] = tButterworth_tick(&c->bl, c->tables[t-1][i*2]);
-                c->dsBuffer[1] = tButterworth_tick(&c->bl, c->tables[t-1][(i*2)+1]);
-                c->tables[t][i] = tOversampler_downsample(&c->ds, c->dsBuffer);
-            }
-        }
-    }
-    tOversampler_free(&c->ds);
-    tButterworth_free(&c->bl);
+    tWaveTableS_buildStep(cy, INT_MAX);
 }
 
 //================================================================================================
@@ -2328,11 +4215,14 @@ void tWaveOscS_init(tWaveOscS* const cy, tWaveTableS* const table, LEAF* const l
 
 void tWaveOscS_initToPool(tWaveOscS* const cy, tWaveTableS* const table, tMempool* const mp)
 {
+    LEAF_PROFILE_POOL(mp);
     _tMempool* m = *mp;
     _tWaveOscS* c = *cy = (_tWaveOscS*) mpool_alloc(sizeof(_tWaveOscS), m);
     c->mempool = m;
     LEAF* leaf = c->mempool->leaf;
     
+    c->table = *table;
+    
     c->invSampleRate = leaf->invSampleRate;
     c->inc = 0.0f;
     c->phase = 0.0f;
@@ -2350,6 +4240,7 @@ void tWaveOscS_free(tWaveOscS* const cy)
 
 float tWaveOscS_tick(tWaveOscS* const cy)
 {
+    LEAF_PROFILE_OBJECT(cy);
     _tWaveOscS* c = *cy;
     
     float temp;
@@ -2366,22 +4257,31 @@ float tWaveOscS_tick(tWaveOscS* const cy)
     int* sizes = c->table->sizes;
     float** tables = c->table->tables;
     
+    // Fall back to the highest level built so far
+    int lo = c->oct, hi = c->oct + 1;
+    int ready = c->table->numReady - 1;
+    if (hi > ready)
+    {
+        hi = ready;
+        if (lo > ready) lo = ready;
+    }
+    
     // Wavetable synthesis
-    temp = sizes[c->oct] * (c->phase + c->phaseOffset);
+    temp = sizes[lo] * (c->phase + c->phaseOffset);
     idx = (int)temp;
     frac = temp - (float)idx;
-    samp0 = tables[c->oct][idx];
-    if (++idx >= sizes[c->oct]) idx = 0;
-    samp1 = tables[c->oct][idx];
+    samp0 = tables[lo][idx];
+    if (++idx >= sizes[lo]) idx = 0;
+    samp1 = tables[lo][idx];
     
     float oct0 = (samp0 + (samp1 - samp0) * frac);
     
-    temp = sizes[c->oct+1] * c->phase;
+    temp = sizes[hi] * c->phase;
     idx = (int)temp;
     frac = temp - (float)idx;
-    samp0 = tables[c->oct+1][idx];
-    if (++idx >= sizes[c->oct+1]) idx = 0;
-    samp1 = tables[c->oct+1][idx];
+    samp0 = tables[hi][idx];
+    if (++idx >= sizes[hi]) idx = 0;
+    samp1 = tables[hi][idx];
     
     float oct1 = (samp0 + (samp1 - samp0) * frac);
     
@@ -2440,6 +4340,7 @@ void tWaveSynthS_init(tWaveSynthS* const cy, int numVoices, float** tables, int*
 void tWaveSynthS_initToPool(tWaveSynthS* const cy, int numVoices, float** tables, int* sizes,
                                   int numTables, float maxFreq, tMempool* const mp)
 {
+    LEAF_PROFILE_POOL(mp);
     _tMempool* m = *mp;
     _tWaveSynthS* c = *cy = (_tWaveSynthS*) mpool_alloc(sizeof(_tWaveSynthS), m);
     c->mempool = m;
@@ -2492,6 +4393,7 @@ void tWaveSynthS_free(tWaveSynthS* const cy)
 
 float tWaveSynthS_tick(tWaveSynthS* const cy)
 {
+    LEAF_PROFILE_OBJECT(cy);
     _tWaveSynthS* c = *cy;
     
     float f = c->index * (c->numTables - 1);
@@ -2516,6 +4418,7 @@ float tWaveSynthS_tick(tWaveSynthS* const cy)
 
 float tWaveSynthS_tickVoice(tWaveSynthS* const cy, int voice)
 {
+    LEAF_PROFILE_OBJECT(cy);
     _tWaveSynthS* c = *cy;
     
     float f = c->index * (c->numTables - 1);
@@ -0,0 +1,168 @@
+/*==============================================================================
+
+ leaf-parallel.c
+ 
+ ==============================================================================*/
+
+#if _WIN32 || _WIN64
+
+#include "..\Inc\leaf-parallel.h"
+
+#else
+
+#include "../Inc/leaf-parallel.h"
+
+#endif
+
+//==============================================================================
+// Voice renderer
+//==============================================================================
+
+// Nothing is pushed while a block runs, so each deque is just the range of voices still to take. The
+// front and back share a word, and the owner and thieves both take with a compare-exchange on it.
+// Whoever loses a race on the last voice sees the updated range and finds it empty. The render
+// callback, its data and the block size are written before the deques are published with a release,
+// and a worker only reads them after an acquire has taken a voice.
+
+void    tVoiceRenderer_init         (tVoiceRenderer* const renderer, int maxVoices, int numWorkers, int maxBlockSize, LEAF* const leaf)
+{
+    tVoiceRenderer_initToPool(renderer, maxVoices, numWorkers, maxBlockSize, &leaf->mempool);
+}
+
+void    tVoiceRenderer_initToPool   (tVoiceRenderer* const renderer, int maxVoices, int numWorkers, int maxBlockSize, tMempool* const mp)
+{
+    _tMempool* m = *mp;
+    _tVoiceRenderer* r = *renderer = (_tVoiceRenderer*) mpool_alloc(sizeof(_tVoiceRenderer), m);
+    r->mempool = m;
+    
+    if (maxVoices > 0xFFFF) maxVoices = 0xFFFF;
+    if (numWorkers < 1) numWorkers = 1;
+    // process() steps through a block maxBlockSize samples at a time
+    if (maxBlockSize < 1) maxBlockSize = 1;
+    
+    r->maxVoices = maxVoices;
+    r->numVoices = maxVoices;
+    r->numWorkers = numWorkers;
+    r->maxBlockSize = maxBlockSize;
+    
+    r->voiceBlocks = (float*) mpool_calloc(sizeof(float) * maxVoices * maxBlockSize, m);
+    r->deques = (volatile uint32_t*) mpool_calloc(sizeof(uint32_t) * numWorkers, m);
+    r->done = 0;
+    
+    r->render = NULL;
+    r->userData = NULL;
+    r->size = 0;
+}
+
+void    tVoiceRenderer_free         (tVoiceRenderer* const renderer)
+{
+    _tVoiceRenderer* r = *renderer;
+    
+    mpool_free((char*) r->deques, r->mempool);
+    mpool_free((char*) r->voiceBlocks, r->mempool);
+    mpool_free((char*) r, r->mempool);
+}
+
+void    tVoiceRenderer_setNumVoices (tVoiceRenderer* const renderer, int numVoices)
+{
+    _tVoiceRenderer* r = *renderer;
+    
+    if (numVoices < 0) numVoices = 0;
+    else if (numVoices > r->maxVoices) numVoices = r->maxVoices;
+    r->numVoices = numVoices;
+}
+
+int     tVoiceRenderer_getNumVoices (tVoiceRenderer* const renderer)
+{
+    _tVoiceRenderer* r = *renderer;
+    
+    return r->numVoices;
+}
+
+// Take a voice from the back of a deque for its owner or the front for a thief, or -1 if it's empty
+static int voices_take(volatile uint32_t* const deque, int fromBack)
+{
+    uint32_t range = leaf_loadAcquire(deque);
+    for (;;)
+    {
+        uint32_t front = range & 0xFFFF;
+        uint32_t back = range >> 16;
+        if (front >= back) return -1;
+        
+        uint32_t next = fromBack ? range - 0x10000 : range + 1;
+        uint32_t seen = leaf_compareExchange(deque, range, next);
+        if (seen == range) return (int) (fromBack ? back - 1 : front);
+        range = seen;
+    }
+}
+
+// Empty this worker's deque, then steal from the others in turn
+static int voices_run(_tVoiceRenderer* const r, int worker)
+{
+    int count = 0;
+    for (int i = 0; i < r->numWorkers; i++)
+    {
+        int w = worker + i;
+        if (w >= r->numWorkers) w -= r->numWorkers;
+        
+        int voice;
+        while ((voice = voices_take(&r->deques[w], i == 0)) >= 0)
+        {
+            r->render(r->userData, voice, &r->voiceBlocks[voice * r->maxBlockSize], r->size);
+            leaf_fetchAdd(&r->done, 1);
+            count++;
+        }
+    }
+    return count;
+}
+
+static void voices_block(_tVoiceRenderer* const r, tVoiceRenderCallback render, void* userData, float* output, int size)
+{
+    uint32_t numVoices = (uint32_t) r->numVoices;
+    uint32_t numWorkers = (uint32_t) r->numWorkers;
+    
+    r->render = render;
+    r->userData = userData;
+    r->size = size;
+    leaf_storeRelease(&r->done, 0);
+    
+    for (uint32_t w = 0; w < numWorkers; w++)
+    {
+        uint32_t front = numVoices * w / numWorkers;
+        uint32_t back = numVoices * (w + 1) / numWorkers;
+        leaf_storeRelease(&r->deques[w], front | (back << 16));
+    }
+    
+    voices_run(r, 0);
+    
+    // The other workers may still be finishing the voices they took
+    while (leaf_loadAcquire(&r->done) < numVoices);
+    
+    for (int i = 0; i < size; i++) output[i] = 0.0f;
+    for (uint32_t v = 0; v < numVoices; v++)
+    {
+        float* block = &r->voiceBlocks[v * r->maxBlockSize];
+        for (int i = 0; i < size; i++) output[i] += block[i];
+    }
+}
+
+void    tVoiceRenderer_process      (tVoiceRenderer* const renderer, tVoiceRenderCallback render, void* userData, float* output, int size)
+{
+    _tVoiceRenderer* r = *renderer;
+    
+    while (size > 0)
+    {
+        int n = size < r->maxBlockSize ? size : r->maxBlockSize;
+        voices_block(r, render, userData, output, n);
+        output += n;
+        size -= n;
+    }
+}
+
+int     tVoiceRenderer_work         (tVoiceRenderer* const renderer, int worker)
+{
+    _tVoiceRenderer* r = *renderer;
+    
+    if (worker < 1 || worker >= r->numWorkers) return 0;
+    return voices_run(r, worker);
+}
@@ -24,6 +24,7 @@ void    tPluck_init         (tPluck* const pl, float lowestFrequency, LEAF* cons
 
 void    tPluck_initToPool    (tPluck* const pl, float lowestFrequency, tMempool* const mp)
 {
+    LEAF_PROFILE_POOL(mp);
     _tMempool* m = *mp;
     _tPluck* p = *pl = (_tPluck*) mpool_alloc(sizeof(_tPluck), m);
     p->mempool = m;
@@ -39,7 +40,7 @@ void    tPluck_initToPool    (tPluck* const pl, float lowestFrequency, tMempool*
     
     tOneZero_initToPool(&p->loopFilter, 0.0f, mp);
     
-    tAllpassDelay_initToPool(&p->delayLine, 0.0f, p->sampleRate * 2, mp);
+    tAllpassDelay_initToPoolPow2(&p->delayLine, 0.0f, p->sampleRate * 2, mp);
     tAllpassDelay_clear(&p->delayLine);
     
     tPluck_setFrequency(pl, 220.0f);
@@ -65,6 +66,7 @@ float   tPluck_getLastOut    (tPluck* const pl)
 
 float   tPluck_tick          (tPluck* const pl)
 {
+    LEAF_PROFILE_OBJECT(pl);
     _tPluck* p = *pl;
     return (p->lastOut = 3.0f * tAllpassDelay_tick(&p->delayLine, tOneZero_tick(&p->loopFilter, tAllpassDelay_getLastOut(&p->delayLine) * p->loopGain ) ));
 }
@@ -133,7 +135,7 @@ void tPluck_setSampleRate(tPluck* const pl, float sr)
     p->sampleRate = sr;
     
     tAllpassDelay_free(&p->delayLine);
-    tAllpassDelay_initToPool(&p->delayLine, 0.0f, p->sampleRate * 2, &p->mempool);
+    tAllpassDelay_initToPoolPow2(&p->delayLine, 0.0f, p->sampleRate * 2, &p->mempool);
     tAllpassDelay_clear(&p->delayLine);
     
     tPluck_setFrequency(pl, p->lastFreq);
@@ -149,6 +151,7 @@ void    tKarplusStrong_init (tKarplusStrong* const pl, float lowestFrequency, LE
 
 void    tKarplusStrong_initToPool   (tKarplusStrong* const pl, float lowestFrequency, tMempool* const mp)
 {
+    LEAF_PROFILE_POOL(mp);
     _tMempool* m = *mp;
     _tKarplusStrong* p = *pl = (_tKarplusStrong*) mpool_alloc(sizeof(_tKarplusStrong), m);
     p->mempool = m;
@@ -158,10 +161,10 @@ void    tKarplusStrong_initToPool   (tKarplusStrong* const pl, float lowestFrequ
     
     if ( lowestFrequency <= 0.0f )  lowestFrequency = 8.0f;
     
-    tAllpassDelay_initToPool(&p->delayLine, 0.0f, p->sampleRate * 2, mp);
+    tAllpassDelay_initToPoolPow2(&p->delayLine, 0.0f, p->sampleRate * 2, mp);
     tAllpassDelay_clear(&p->delayLine);
     
-    tLinearDelay_initToPool(&p->combDelay, 0.0f, p->sampleRate * 2, mp);
+    tLinearDelay_initToPoolPow2(&p->combDelay, 0.0f, p->sampleRate * 2, mp);
     tLinearDelay_clear(&p->combDelay);
     
     tOneZero_initToPool(&p->filter, 0.0f, mp);
@@ -208,6 +211,7 @@ float   tKarplusStrong_getLastOut    (tKarplusStrong* const pl)
 
 float   tKarplusStrong_tick          (tKarplusStrong* const pl)
 {
+    LEAF_PROFILE_OBJECT(pl);
     _tKarplusStrong* p = *pl;
     
     float temp = tAllpassDelay_getLastOut(&p->delayLine) * p->loopGain;
@@ -352,11 +356,11 @@ void    tKarplusStrong_setSampleRate (tKarplusStrong* const pl, float sr)
     p->sampleRate = sr;
     
     tAllpassDelay_free(&p->delayLine);
-    tAllpassDelay_initToPool(&p->delayLine, 0.0f, p->sampleRate * 2, &p->mempool);
+    tAllpassDelay_initToPoolPow2(&p->delayLine, 0.0f, p->sampleRate * 2, &p->mempool);
     tAllpassDelay_clear(&p->delayLine);
     
     tLinearDelay_free(&p->combDelay);
-    tLinearDelay_initToPool(&p->combDelay, 0.0f, p->sampleRate * 2, &p->mempool);
+    tLinearDelay_initToPoolPow2(&p->combDelay, 0.0f, p->sampleRate * 2, &p->mempool);
     tLinearDelay_clear(&p->combDelay);
     
     tKarplusStrong_setFrequency(pl, p->lastFrequency);
@@ -381,6 +385,7 @@ void    tSimpleLivingString_initToPool  (tSimpleLivingString* const pl, float fr
                                          float decay, float targetLev, float levSmoothFactor,
                                          float levStrength, int levMode, tMempool* const mp)
 {
+    LEAF_PROFILE_POOL(mp);
     _tMempool* m = *mp;
     _tSimpleLivingString* p = *pl = (_tSimpleLivingString*) mpool_alloc(sizeof(_tSimpleLivingString), m);
     p->mempool = m;
@@ -390,7 +395,7 @@ void    tSimpleLivingString_initToPool  (tSimpleLivingString* const pl, float fr
     p->curr=0.0f;
     tExpSmooth_initToPool(&p->wlSmooth, p->sampleRate/freq, 0.01f, mp); // smoother for string wavelength (not freq, to avoid expensive divisions)
     tSimpleLivingString_setFreq(pl, freq);
-    tLinearDelay_initToPool(&p->delayLine,p->waveLengthInSamples, 2400, mp);
+    tLinearDelay_initToPoolPow2(&p->delayLine,p->waveLengthInSamples, 2400, mp);
     tLinearDelay_clear(&p->delayLine);
     tOnePole_initToPool(&p->bridgeFilter, dampFreq, mp);
     tHighpass_initToPool(&p->DCblocker,13, mp);
@@ -471,6 +476,7 @@ void     tSimpleLivingString_setLevMode(tSimpleLivingString* const pl, int levMo
 
 float   tSimpleLivingString_tick(tSimpleLivingString* const pl, float input)
 {
+    LEAF_PROFILE_OBJECT(pl);
     _tSimpleLivingString* p = *pl;
     
     float stringOut=tOnePole_tick(&p->bridgeFilter,tLinearDelay_tickOut(&p->delayLine));
@@ -498,6 +504,550 @@ void   tSimpleLivingString_setSampleRate(tSimpleLivingString* const pl, float sr
     tHighpass_setSampleRate(&p->DCblocker, p->sampleRate);
 }
 
+/* Simple Living String Bank */
+
+#define STRINGBANK_LANES 8
+
+// Same as tLinearDelay_setDelay. A clipped delay is never more than a whole buffer, so one wrap is enough
+static inline void stringBank_setDelay(_tSimpleLivingStringBank* const s, int i, uint32_t inPoint, float delay)
+{
+    float maxDelay = (float) s->delaySize;
+    delay = delay < 0.0f ? 0.0f : (delay > maxDelay ? maxDelay : delay);
+    
+    float outPointer = inPoint - delay;
+    if (outPointer < 0) outPointer += maxDelay;
+    
+    uint32_t outPoint = (uint32_t) outPointer;
+    s->alpha[i] = outPointer - outPoint;
+    s->omAlpha[i] = 1.0f - s->alpha[i];
+    s->outPoint[i] = outPoint == s->delaySize ? 0 : outPoint;
+}
+
+void    tSimpleLivingStringBank_init            (tSimpleLivingStringBank* const sb, int numStrings, int blockSize, float freq,
+                                                 float dampFreq, float decay, float targetLev, float levSmoothFactor,
+                                                 float levStrength, int levMode, LEAF* const leaf)
+{
+    tSimpleLivingStringBank_initToPool(sb, numStrings, blockSize, freq, dampFreq, decay, targetLev, levSmoothFactor, levStrength, levMode, &leaf->mempool);
+}
+
+void    tSimpleLivingStringBank_initToPool      (tSimpleLivingStringBank* const sb, int numStrings, int blockSize, float freq,
+                                                 float dampFreq, float decay, float targetLev, float levSmoothFactor,
+                                                 float levStrength, int levMode, tMempool* const mp)
+{
+    LEAF_PROFILE_POOL(mp);
+    _tMempool* m = *mp;
+    _tSimpleLivingStringBank* s = *sb = (_tSimpleLivingStringBank*) mpool_alloc(sizeof(_tSimpleLivingStringBank), m);
+    s->mempool = m;
+    LEAF* leaf = s->mempool->leaf;
+    
+    s->numStrings = numStrings;
+    s->blockSize = blockSize;
+    s->denormalOffset = LEAF_DENORMAL_OFFSET;
+    s->buffers = (float*) mpool_calloc(sizeof(float) * numStrings * blockSize, m);
+    s->excitation = (float*) mpool_calloc(sizeof(float) * numStrings * blockSize, m);
+    s->excited = 0;
+    
+    // Sized as tSimpleLivingString sizes its delay line
+    uint32_t size = 2;
+    while (size < 2400) size <<= 1;
+    s->delaySize = size;
+    s->delayMask = size - 1;
+    s->inPoint = 0;
+    s->arena = (float*) mpool_calloc(sizeof(float) * numStrings * size, m);
+    
+    s->outPoint = (uint32_t*) mpool_alloc(sizeof(uint32_t) * numStrings, m);
+    s->alpha = (float*) mpool_alloc(sizeof(float) * numStrings, m);
+    s->omAlpha = (float*) mpool_alloc(sizeof(float) * numStrings, m);
+    s->waveLength = (float*) mpool_alloc(sizeof(float) * numStrings, m);
+    s->wlCurr = (float*) mpool_alloc(sizeof(float) * numStrings, m);
+    s->dampFreq = (float*) mpool_alloc(sizeof(float) * numStrings, m);
+    s->b0 = (float*) mpool_alloc(sizeof(float) * numStrings, m);
+    s->a1 = (float*) mpool_alloc(sizeof(float) * numStrings, m);
+    s->lpOut = (float*) mpool_calloc(sizeof(float) * numStrings, m);
+    s->decay = (float*) mpool_alloc(sizeof(float) * numStrings, m);
+    s->loopGain = (float*) mpool_alloc(sizeof(float) * numStrings, m);
+    s->levMode = (int*) mpool_alloc(sizeof(int) * numStrings, m);
+    s->targetLevel = (float*) mpool_alloc(sizeof(float) * numStrings, m);
+    s->factor = (float*) mpool_alloc(sizeof(float) * numStrings, m);
+    s->oneminusfactor = (float*) mpool_alloc(sizeof(float) * numStrings, m);
+    s->strength = (float*) mpool_alloc(sizeof(float) * numStrings, m);
+    s->power = (float*) mpool_calloc(sizeof(float) * numStrings, m);
+    s->xs = (float*) mpool_calloc(sizeof(float) * numStrings, m);
+    s->ys = (float*) mpool_calloc(sizeof(float) * numStrings, m);
+    s->curr = (float*) mpool_calloc(sizeof(float) * numStrings, m);
+    
+    s->sampleRate = leaf->sampleRate;
+    s->twoPiTimesInvSampleRate = leaf->twoPiTimesInvSampleRate;
+    s->wlFactor = 0.01f;
+    s->wlOneMinusFactor = 1.0f - s->wlFactor;
+    s->R = (1.0f - (13.0f * s->twoPiTimesInvSampleRate));
+    
+    if (levSmoothFactor < 0) levSmoothFactor = 0;
+    if (levSmoothFactor > 1) levSmoothFactor = 1;
+    
+    for (int i = 0; i < numStrings; ++i)
+    {
+        s->wlCurr[i] = s->sampleRate/freq > 0.0f ? s->sampleRate/freq : 0.0f;
+        tSimpleLivingStringBank_setFreq(sb, i, freq);
+        stringBank_setDelay(s, i, s->inPoint, s->waveLength[i]);
+        tSimpleLivingStringBank_setDampFreq(sb, i, dampFreq);
+        s->decay[i] = decay;
+        s->levMode[i] = levMode;
+        s->loopGain[i] = levMode==0?decay:1.0f;
+        s->targetLevel[i] = targetLev;
+        s->factor[i] = levSmoothFactor;
+        s->oneminusfactor[i] = 1.0f-levSmoothFactor;
+        s->strength[i] = levStrength;
+    }
+}
+
+void    tSimpleLivingStringBank_free            (tSimpleLivingStringBank* const sb)
+{
+    _tSimpleLivingStringBank* s = *sb;
+    
+    mpool_free((char*) s->curr, s->mempool);
+    mpool_free((char*) s->ys, s->mempool);
+    mpool_free((char*) s->xs, s->mempool);
+    mpool_free((char*) s->power, s->mempool);
+    mpool_free((char*) s->strength, s->mempool);
+    mpool_free((char*) s->oneminusfactor, s->mempool);
+    mpool_free((char*) s->factor, s->mempool);
+    mpool_free((char*) s->targetLevel, s->mempool);
+    mpool_free((char*) s->levMode, s->mempool);
+    mpool_free((char*) s->loopGain, s->mempool);
+    mpool_free((char*) s->decay, s->mempool);
+    mpool_free((char*) s->lpOut, s->mempool);
+    mpool_free((char*) s->a1, s->mempool);
+    mpool_free((char*) s->b0, s->mempool);
+    mpool_free((char*) s->dampFreq, s->mempool);
+    mpool_free((char*) s->wlCurr, s->mempool);
+    mpool_free((char*) s->waveLength, s->mempool);
+    mpool_free((char*) s->omAlpha, s->mempool);
+    mpool_free((char*) s->alpha, s->mempool);
+    mpool_free((char*) s->outPoint, s->mempool);
+    mpool_free((char*) s->arena, s->mempool);
+    mpool_free((char*) s->excitation, s->mempool);
+    mpool_free((char*) s->buffers, s->mempool);
+    mpool_free((char*) s, s->mempool);
+}
+
+// Renders strings first to first + numLanes - 1 through a whole block. Their state is held in local arrays
+// for the block, so the compiler can run the filters and levelers of all the lanes side by side
+static inline void stringBank_renderLanes(_tSimpleLivingStringBank* const s, int first, int numLanes, float* output, int size)
+{
+    float lp[STRINGBANK_LANES], b0[STRINGBANK_LANES], a1[STRINGBANK_LANES], loopGain[STRINGBANK_LANES];
+    float power[STRINGBANK_LANES], factor[STRINGBANK_LANES], oneminusfactor[STRINGBANK_LANES];
+    float targetLevel[STRINGBANK_LANES], strength[STRINGBANK_LANES], floor[STRINGBANK_LANES];
+    float xs[STRINGBANK_LANES], ys[STRINGBANK_LANES], wlCurr[STRINGBANK_LANES], waveLength[STRINGBANK_LANES];
+    float alpha[STRINGBANK_LANES], omAlpha[STRINGBANK_LANES], fromDelay[STRINGBANK_LANES];
+    uint32_t outPoint[STRINGBANK_LANES];
+    
+    for (int l = 0; l < numLanes; ++l)
+    {
+        int i = first + l;
+        lp[l] = s->lpOut[i];
+#if !LEAF_DENORMAL_CHECK
+        lp[l] += s->denormalOffset;
+#endif
+        b0[l] = s->b0[i];
+        a1[l] = s->a1[i];
+        loopGain[l] = s->loopGain[i];
+        power[l] = s->power[i];
+        factor[l] = s->factor[i];
+        oneminusfactor[l] = s->oneminusfactor[i];
+        targetLevel[l] = s->targetLevel[i];
+        strength[l] = s->strength[i];
+        // Mode 0 only limits upwards
+        floor[l] = s->levMode[i]==0 ? 0.0f : -INFINITY;
+        xs[l] = s->xs[i];
+        ys[l] = s->ys[i];
+        wlCurr[l] = s->wlCurr[i];
+        waveLength[l] = s->waveLength[i];
+        alpha[l] = s->alpha[i];
+        omAlpha[l] = s->omAlpha[i];
+        outPoint[l] = s->outPoint[i];
+    }
+    
+    float* arena = s->arena + first * s->delaySize;
+    float* buffers = s->buffers + first * s->blockSize;
+    uint32_t delaySize = s->delaySize;
+    uint32_t mask = s->delayMask;
+    float maxDelay = (float) delaySize;
+    float R = s->R;
+    float wlFactor = s->wlFactor;
+    float wlOneMinusFactor = s->wlOneMinusFactor;
+    uint32_t inPoint = s->inPoint;
+    
+    for (int n = 0; n < size; ++n)
+    {
+        const float* input = s->excitation + n * s->numStrings + first;
+        uint32_t nextIn = (inPoint + 1) & mask;
+        float inPointer = (float) nextIn;
+        
+        for (int l = 0; l < numLanes; ++l)
+        {
+            float* buff = arena + l * delaySize;
+            uint32_t idx = outPoint[l];
+            fromDelay[l] = buff[idx] * omAlpha[l] + buff[(idx + 1) & mask] * alpha[l];
+        }
+        
+        // Same arithmetic as tSimpleLivingString_tick, with the sub-objects inlined
+        for (int l = 0; l < numLanes; ++l)
+        {
+            float stringOut = (b0[l] * fromDelay[l]) + (a1[l] * lp[l]);
+            lp[l] = stringOut;
+            
+            float x = loopGain[l]*stringOut+input[l];
+            power[l] = factor[l]*x*x+oneminusfactor[l]*power[l];
+            float levdiff = power[l]-targetLevel[l];
+            levdiff = levdiff < floor[l] ? floor[l] : levdiff;
+            float leveled = x*(1.0f-strength[l]*levdiff);
+            
+            float y = leveled - xs[l] + R * ys[l];
+            xs[l] = leveled;
+            ys[l] = y;
+            
+            // tLinearDelay_setDelay. The wavelength never goes below zero, so only the top needs clipping,
+            // and a clipped delay is never more than a whole buffer, so one wrap is enough
+            float wl = wlFactor * waveLength[l] + wlOneMinusFactor * wlCurr[l];
+            wlCurr[l] = wl;
+            float delay = wl > maxDelay ? maxDelay : wl;
+            float outPointer = inPointer - delay;
+            outPointer += outPointer < 0 ? maxDelay : 0.0f;
+            int32_t op = (int32_t) outPointer;
+            alpha[l] = outPointer - op;
+            omAlpha[l] = 1.0f - alpha[l];
+            outPoint[l] = (uint32_t) op & mask;
+        }
+        
+        for (int l = 0; l < numLanes; ++l)
+        {
+            arena[l * delaySize + inPoint] = ys[l];
+            buffers[l * s->blockSize + n] = lp[l];
+        }
+        if (output != NULL) for (int l = 0; l < numLanes; ++l) output[n] += lp[l];
+        
+        inPoint = nextIn;
+    }
+    
+    for (int l = 0; l < numLanes; ++l)
+    {
+        int i = first + l;
+        s->lpOut[i] = lp[l];
+        s->power[i] = power[l];
+        s->xs[i] = xs[l];
+        s->ys[i] = ys[l];
+        s->wlCurr[i] = wlCurr[l];
+        s->alpha[i] = alpha[l];
+        s->omAlpha[i] = omAlpha[l];
+        s->outPoint[i] = outPoint[l];
+        if (size > 0) s->curr[i] = lp[l];
+    }
+}
+
+void    tSimpleLivingStringBank_tickBlock       (tSimpleLivingStringBank* const sb, float* output, int size)
+{
+    LEAF_PROFILE_OBJECT(sb);
+    _tSimpleLivingStringBank* s = *sb;
+    
+    if (size > s->blockSize) size = s->blockSize;
+    if (output != NULL) for (int n = 0; n < size; ++n) output[n] = 0.0f;
+    
+    int first = 0;
+    for (; first + STRINGBANK_LANES <= s->numStrings; first += STRINGBANK_LANES)
+        stringBank_renderLanes(s, first, STRINGBANK_LANES, output, size);
+    if (first < s->numStrings)
+        stringBank_renderLanes(s, first, s->numStrings - first, output, size);
+    
+    s->inPoint = (s->inPoint + size) & s->delayMask;
+#if !LEAF_DENORMAL_CHECK
+    s->denormalOffset = -s->denormalOffset;
+#endif
+    
+    if (s->excited)
+    {
+        for (int i = 0; i < s->numStrings * s->blockSize; ++i) s->excitation[i] = 0.0f;
+        s->excited = 0;
+    }
+}
+
+float*  tSimpleLivingStringBank_getBuffer       (tSimpleLivingStringBank* const sb, int index)
+{
+    _tSimpleLivingStringBank* s = *sb;
+    return s->buffers + index * s->blockSize;
+}
+
+float   tSimpleLivingStringBank_sample          (tSimpleLivingStringBank* const sb, int index)
+{
+    _tSimpleLivingStringBank* s = *sb;
+    return s->curr[index];
+}
+
+void    tSimpleLivingStringBank_pluck           (tSimpleLivingStringBank* const sb, int index, int offset, float amplitude)
+{
+    _tSimpleLivingStringBank* s = *sb;
+    
+    if (offset < 0 || offset >= s->blockSize) return;
+    s->excitation[offset * s->numStrings + index] += amplitude;
+    s->excited = 1;
+}
+
+void    tSimpleLivingStringBank_excite          (tSimpleLivingStringBank* const sb, int index, int offset, const float* input, int size)
+{
+    _tSimpleLivingStringBank* s = *sb;
+    
+    if (offset < 0) offset = 0;
+    for (int n = 0; n < size && offset + n < s->blockSize; ++n)
+        s->excitation[(offset + n) * s->numStrings + index] += input[n];
+    s->excited = 1;
+}
+
+void    tSimpleLivingStringBank_setFreq         (tSimpleLivingStringBank* const sb, int index, float freq)
+{
+    _tSimpleLivingStringBank* s = *sb;
+    
+    if (freq<20) freq=20;
+    else if (freq>10000) freq=10000;
+    s->waveLength[index] = s->sampleRate/freq;
+}
+
+void    tSimpleLivingStringBank_setWaveLength   (tSimpleLivingStringBank* const sb, int index, float waveLength)
+{
+    _tSimpleLivingStringBank* s = *sb;
+    
+    if (waveLength<4.8) waveLength=4.8f;
+    else if (waveLength>2400) waveLength=2400;
+    s->waveLength[index] = waveLength;
+}
+
+void    tSimpleLivingStringBank_setDampFreq     (tSimpleLivingStringBank* const sb, int index, float dampFreq)
+{
+    _tSimpleLivingStringBank* s = *sb;
+    
+    s->dampFreq[index] = dampFreq;
+    s->b0[index] = LEAF_clip(0.0f, dampFreq * s->twoPiTimesInvSampleRate, 1.0f);
+    s->a1[index] = 1.0f - s->b0[index];
+}
+
+void    tSimpleLivingStringBank_setDecay        (tSimpleLivingStringBank* const sb, int index, float decay)
+{
+    _tSimpleLivingStringBank* s = *sb;
+    
+    s->decay[index] = decay;
+    s->loopGain[index] = s->levMode[index]==0?decay:1.0f;
+}
+
+void    tSimpleLivingStringBank_setTargetLev    (tSimpleLivingStringBank* const sb, int index, float targetLev)
+{
+    _tSimpleLivingStringBank* s = *sb;
+    s->targetLevel[index] = targetLev;
+}
+
+void    tSimpleLivingStringBank_setLevSmoothFactor (tSimpleLivingStringBank* const sb, int index, float levSmoothFactor)
+{
+    _tSimpleLivingStringBank* s = *sb;
+    
+    if (levSmoothFactor<0) levSmoothFactor=0;
+    if (levSmoothFactor>1) levSmoothFactor=1;
+    s->factor[index] = levSmoothFactor;
+    s->oneminusfactor[index] = 1.0f-levSmoothFactor;
+}
+
+void    tSimpleLivingStringBank_setLevStrength  (tSimpleLivingStringBank* const sb, int index, float levStrength)
+{
+    _tSimpleLivingStringBank* s = *sb;
+    s->strength[index] = levStrength;
+}
+
+void    tSimpleLivingStringBank_setLevMode      (tSimpleLivingStringBank* const sb, int index, int levMode)
+{
+    _tSimpleLivingStringBank* s = *sb;
+    
+    s->levMode[index] = levMode;
+    s->loopGain[index] = levMode==0?s->decay[index]:1.0f;
+}
+
+void    tSimpleLivingStringBank_setSampleRate   (tSimpleLivingStringBank* const sb, float sr)
+{
+    _tSimpleLivingStringBank* s = *sb;
+    
+    for (int i = 0; i < s->numStrings; ++i)
+    {
+        float freq = s->sampleRate/s->waveLength[i];
+        s->waveLength[i] = sr/freq;
+    }
+    s->sampleRate = sr;
+    s->twoPiTimesInvSampleRate = TWO_PI * (1.0f/sr);
+    s->R = (1.0f - (13.0f * s->twoPiTimesInvSampleRate));
+    for (int i = 0; i < s->numStrings; ++i)
+        tSimpleLivingStringBank_setDampFreq(sb, i, s->dampFreq[i]);
+}
+
+// Block versions of the living strings copy the state of their delays, filters and levelers into these
+// locals once per block and run everything inline, with the same arithmetic as the objects' own ticks.
+// The strings' delays are always power of two sized, so only that case is handled.
+
+typedef struct _lsLine
+{
+    leaf_sample_t* buff;
+    uint32_t mask, maxDelay;
+    uint32_t inPoint, outPoint;
+    float gain, delay, alpha, omAlpha, lastOut;
+} lsLine;
+
+typedef struct _lsPole
+{
+    float gain, b0, a1, lastIn, lastOut;
+} lsPole;
+
+typedef struct _lsEnd
+{
+    lsPole lp; // tOnePole
+    float R, xs, ys; // tHighpass
+    float factor, oneminusfactor, power, targetLevel, strength, curr; // tFeedbackLeveler
+    int mode;
+} lsEnd;
+
+typedef struct _lsSmooth
+{
+    float factor, oneminusfactor, curr, dest;
+} lsSmooth;
+
+static inline void lsLine_load(lsLine* const l, _tLinearDelay* const d)
+{
+    l->buff = d->buff;
+    l->mask = d->bufferMask;
+    l->maxDelay = d->maxDelay;
+    l->inPoint = d->inPoint;
+    l->outPoint = d->outPoint;
+    l->gain = d->gain;
+    l->delay = d->delay;
+    l->alpha = d->alpha;
+    l->omAlpha = d->omAlpha;
+    l->lastOut = d->lastOut;
+}
+
+static inline void lsLine_store(const lsLine* const l, _tLinearDelay* const d)
+{
+    d->inPoint = l->inPoint;
+    d->outPoint = l->outPoint;
+    d->delay = l->delay;
+    d->alpha = l->alpha;
+    d->omAlpha = l->omAlpha;
+    d->lastOut = l->lastOut;
+}
+
+static inline float lsLine_out(lsLine* const l)
+{
+    uint32_t idx = l->outPoint;
+    l->lastOut = LEAF_SAMPLE_TO_FLOAT(l->buff[idx]) * l->omAlpha + LEAF_SAMPLE_TO_FLOAT(l->buff[(idx + 1) & l->mask]) * l->alpha;
+    l->outPoint = (idx + 1) & l->mask;
+    return l->lastOut;
+}
+
+static inline void lsLine_in(lsLine* const l, float input)
+{
+    l->buff[l->inPoint] = LEAF_SAMPLE_FROM_FLOAT(input * l->gain);
+    l->inPoint = (l->inPoint + 1) & l->mask;
+}
+
+static inline void lsLine_setDelay(lsLine* const l, float delay)
+{
+    float maxDelay = l->maxDelay;
+    l->delay = delay < 0.0f ? 0.0f : (delay > maxDelay ? maxDelay : delay);
+    
+    float outPointer = l->inPoint - l->delay;
+    while (outPointer < 0) outPointer += l->maxDelay;
+    
+    l->outPoint = (uint32_t) outPointer;
+    l->alpha = outPointer - l->outPoint;
+    l->omAlpha = 1.0f - l->alpha;
+    if (l->outPoint == l->maxDelay) l->outPoint = 0;
+}
+
+static inline void lsPole_load(lsPole* const l, _tOnePole* const f)
+{
+    l->gain = f->gain;
+    l->b0 = f->b0;
+    l->a1 = f->a1;
+    l->lastIn = f->lastIn;
+    l->lastOut = f->lastOut;
+}
+
+static inline void lsPole_store(const lsPole* const l, _tOnePole* const f)
+{
+    f->lastIn = l->lastIn;
+    f->lastOut = l->lastOut;
+}
+
+static inline float lsPole_tick(lsPole* const l, float input)
+{
+    float in = input * l->gain;
+    float out = (l->b0 * in) + (l->a1 * l->lastOut);
+    l->lastIn = in;
+    l->lastOut = out;
+    return out;
+}
+
+static inline void lsEnd_load(lsEnd* const e, _tOnePole* const lp, _tHighpass* const dc, _tFeedbackLeveler* const lev)
+{
+    _tPowerFollower* pf = lev->pwrFlw;
+    lsPole_load(&e->lp, lp);
+    e->R = dc->R;
+    e->xs = dc->xs;
+    e->ys = dc->ys;
+    e->factor = pf->factor;
+    e->oneminusfactor = pf->oneminusfactor;
+    e->power = pf->curr;
+    e->targetLevel = lev->targetLevel;
+    e->strength = lev->strength;
+    e->mode = lev->mode;
+    e->curr = lev->curr;
+}
+
+static inline void lsEnd_store(const lsEnd* const e, _tOnePole* const lp, _tHighpass* const dc, _tFeedbackLeveler* const lev)
+{
+    lsPole_store(&e->lp, lp);
+    dc->xs = e->xs;
+    dc->ys = e->ys;
+    lev->pwrFlw->curr = e->power;
+    lev->curr = e->curr;
+}
+
+// Damping filter, DC blocker and leveler at one end of the string, inverted for the reflection
+static inline float lsEnd_tick(lsEnd* const e, float gain, float input)
+{
+    float lp = lsPole_tick(&e->lp, input);
+    e->ys = lp - e->xs + e->R * e->ys;
+    e->xs = lp;
+    
+    float x = gain * e->ys;
+    e->power = e->factor*x*x+e->oneminusfactor*e->power;
+    float levdiff = e->power - e->targetLevel;
+    if (e->mode==0 && levdiff<0.0f) levdiff=0.0f;
+    e->curr = x*(1.0f-e->strength*levdiff);
+    return -e->curr;
+}
+
+static inline void lsSmooth_load(lsSmooth* const s, _tExpSmooth* const smooth)
+{
+    s->factor = smooth->factor;
+    s->oneminusfactor = smooth->oneminusfactor;
+    s->curr = smooth->curr;
+    s->dest = smooth->dest;
+}
+
+static inline void lsSmooth_store(const lsSmooth* const s, _tExpSmooth* const smooth)
+{
+    smooth->curr = s->curr;
+}
+
+static inline float lsSmooth_tick(lsSmooth* const s)
+{
+    s->curr = s->factor * s->dest + s->oneminusfactor * s->curr;
+    return s->curr;
+}
+
 /* Living String*/
 
 void    tLivingString_init(tLivingString* const pl, float freq, float pickPos, float prepIndex,
@@ -511,6 +1061,7 @@ void    tLivingString_initToPool    (tLivingString* const pl, float freq, float
                                      float dampFreq, float decay, float targetLev, float levSmoothFactor,
                                      float levStrength, int levMode, tMempool* const mp)
 {
+    LEAF_PROFILE_POOL(mp);
     _tMempool* m = *mp;
     _tLivingString* p = *pl = (_tLivingString*) mpool_alloc(sizeof(_tLivingString), m);
     p->mempool = m;
@@ -518,16 +1069,18 @@ void    tLivingString_initToPool    (tLivingString* const pl, float freq, float
     
     p->sampleRate = leaf->sampleRate;
     p->curr=0.0f;
+    p->denormalOffset = LEAF_DENORMAL_OFFSET;
+    LEAF_quiescenceInit(&p->quiet, 0.0f, 0);
     tExpSmooth_initToPool(&p->wlSmooth, p->sampleRate/freq, 0.01f, mp); // smoother for string wavelength (not freq, to avoid expensive divisions)
     tLivingString_setFreq(pl, freq);
     p->freq = freq;
     tExpSmooth_initToPool(&p->ppSmooth, pickPos, 0.01f, mp); // smoother for pick position
     tLivingString_setPickPos(pl, pickPos);
     p->prepIndex=prepIndex;
-    tLinearDelay_initToPool(&p->delLF,p->waveLengthInSamples, 2400, mp);
-    tLinearDelay_initToPool(&p->delUF,p->waveLengthInSamples, 2400, mp);
-    tLinearDelay_initToPool(&p->delUB,p->waveLengthInSamples, 2400, mp);
-    tLinearDelay_initToPool(&p->delLB,p->waveLengthInSamples, 2400, mp);
+    tLinearDelay_initToPoolPow2(&p->delLF,p->waveLengthInSamples, 2400, mp);
+    tLinearDelay_initToPoolPow2(&p->delUF,p->waveLengthInSamples, 2400, mp);
+    tLinearDelay_initToPoolPow2(&p->delUB,p->waveLengthInSamples, 2400, mp);
+    tLinearDelay_initToPoolPow2(&p->delLB,p->waveLengthInSamples, 2400, mp);
     tLinearDelay_clear(&p->delLF);
     tLinearDelay_clear(&p->delUF);
     tLinearDelay_clear(&p->delUB);
@@ -648,8 +1201,21 @@ void     tLivingString_setLevMode(tLivingString* const pl, int levMode)
     p->levMode=levMode;
 }
 
+void    tLivingString_setQuiescence     (tLivingString* const pl, float threshold, int holdSamples)
+{
+    _tLivingString* p = *pl;
+    LEAF_quiescenceInit(&p->quiet, threshold, holdSamples);
+}
+
+int     tLivingString_isQuiescent       (tLivingString* const pl)
+{
+    _tLivingString* p = *pl;
+    return LEAF_quiescenceIsQuiet(&p->quiet);
+}
+
 float   tLivingString_tick(tLivingString* const pl, float input)
 {
+    LEAF_PROFILE_OBJECT(pl);
     _tLivingString* p = *pl;
     
     // from pickPos upwards=forwards
@@ -705,6 +1271,90 @@ void   tLivingString_setSampleRate(tLivingString* const pl, float sr)
     tHighpass_setSampleRate(&p->DCblockerL, p->sampleRate);
 }
 
+void    tLivingString_tickBlock(tLivingString* const pl, const float* input, float* output, int size)
+{
+    LEAF_PROFILE_OBJECT(pl);
+    _tLivingString* p = *pl;
+    
+    if (LEAF_quiescenceBegin(&p->quiet, input, 1, size))
+    {
+        for (int i = 0; i < size; ++i) output[i] = 0.0f;
+        p->curr = 0.0f;
+        return;
+    }
+    
+    lsLine LF, UF, UB, LB;
+    lsEnd nut, bridge;
+    lsPole prepU, prepL;
+    lsSmooth pp, wl;
+    lsLine_load(&LF, p->delLF);
+    lsLine_load(&UF, p->delUF);
+    lsLine_load(&UB, p->delUB);
+    lsLine_load(&LB, p->delLB);
+    lsEnd_load(&nut, p->nutFilter, p->DCblockerU, p->fbLevU);
+    lsEnd_load(&bridge, p->bridgeFilter, p->DCblockerL, p->fbLevL);
+    lsPole_load(&prepU, p->prepFilterU);
+    lsPole_load(&prepL, p->prepFilterL);
+    lsSmooth_load(&pp, p->ppSmooth);
+    lsSmooth_load(&wl, p->wlSmooth);
+
+#if !LEAF_DENORMAL_CHECK
+    // Keep the loop out of denormals without checking every sample
+    bridge.lp.lastOut += p->denormalOffset;
+    p->denormalOffset = -p->denormalOffset;
+#endif
+    
+    float gain = p->levMode==0?p->decay:1.0f;
+    float prepIndex = p->prepIndex;
+    float fromBridge = p->curr;
+    
+    for (int i = 0; i < size; ++i)
+    {
+        float in = input != NULL ? input[i] : 0.0f;
+        
+        float fromLF=lsLine_out(&LF);
+        float fromUF=lsLine_out(&UF);
+        float fromUB=lsLine_out(&UB);
+        float fromLB=lsLine_out(&LB);
+        float fromNut=lsEnd_tick(&nut, gain, fromUF);
+        lsLine_in(&UB, fromNut);
+        float fromLowerPrep=-lsPole_tick(&prepL, fromLF);
+        float intoLower=prepIndex*fromLowerPrep+(1.0f - prepIndex)*fromUB+in;
+        lsLine_in(&LB, intoLower);
+        fromBridge=lsEnd_tick(&bridge, gain, fromLB);
+        lsLine_in(&LF, fromBridge);
+        float fromUpperPrep=-lsPole_tick(&prepU, fromUB);
+        float intoUpper=prepIndex*fromUpperPrep+(1.0f - prepIndex)*fromLF+in;
+        lsLine_in(&UF, intoUpper);
+        
+        float pickP=lsSmooth_tick(&pp);
+        float wLen=lsSmooth_tick(&wl);
+        float lowLen=pickP*wLen;
+        float upLen=(1.0f-pickP)*wLen;
+        lsLine_setDelay(&LF, lowLen);
+        lsLine_setDelay(&LB, lowLen);
+        lsLine_setDelay(&UF, upLen);
+        lsLine_setDelay(&UB, upLen);
+        
+        output[i] = fromBridge;
+    }
+    p->curr = fromBridge;
+    
+    LEAF_quiescenceHear(&p->quiet, output, 1, size);
+    LEAF_quiescenceEnd(&p->quiet, size);
+    
+    lsLine_store(&LF, p->delLF);
+    lsLine_store(&UF, p->delUF);
+    lsLine_store(&UB, p->delUB);
+    lsLine_store(&LB, p->delLB);
+    lsEnd_store(&nut, p->nutFilter, p->DCblockerU, p->fbLevU);
+    lsEnd_store(&bridge, p->bridgeFilter, p->DCblockerL, p->fbLevL);
+    lsPole_store(&prepU, p->prepFilterU);
+    lsPole_store(&prepL, p->prepFilterL);
+    lsSmooth_store(&pp, p->ppSmooth);
+    lsSmooth_store(&wl, p->wlSmooth);
+}
+
 
 //////////---------------------------
 /* Version of Living String with Hermite Interpolation */
@@ -723,11 +1373,12 @@ void    tLivingString2_initToPool    (tLivingString2* const pl, float freq, floa
                                      float brightness, float decay, float targetLev, float levSmoothFactor,
                                      float levStrength, int levMode, tMempool* const mp)
 {
+    LEAF_PROFILE_POOL(mp);
     _tMempool* m = *mp;
     _tLivingString2* p = *pl = (_tLivingString2*) mpool_alloc(sizeof(_tLivingString2), m);
     p->mempool = m;
     LEAF* leaf = p->mempool->leaf;
-
+    
     p->sampleRate = leaf->sampleRate;
     p->curr=0.0f;
     tExpSmooth_initToPool(&p->wlSmooth, p->sampleRate/freq, 0.1f, mp); // smoother for string wavelength (not freq, to avoid expensive divisions)
@@ -766,7 +1417,7 @@ void    tLivingString2_initToPool    (tLivingString2* const pl, float freq, floa
 void    tLivingString2_free (tLivingString2* const pl)
 {
     _tLivingString2* p = *pl;
-
+    
     tExpSmooth_free(&p->wlSmooth);
     tExpSmooth_free(&p->ppSmooth);
     tExpSmooth_free(&p->prpSmooth);
@@ -783,7 +1434,7 @@ void    tLivingString2_free (tLivingString2* const pl)
     tHighpass_free(&p->DCblockerL);
     tFeedbackLeveler_free(&p->fbLevU);
     tFeedbackLeveler_free(&p->fbLevL);
-
+    
     mpool_free((char*)p, p->mempool);
 }
 
@@ -851,7 +1502,7 @@ void     tLivingString2_setBrightness(tLivingString2* const pl, float brightness
     _tLivingString2* p = *pl;
     float h0=(1.0 + brightness) * 0.5f;
     float h1=(1.0 - brightness) * 0.25f;
-
+    
     tTwoZero_setCoefficients(&p->bridgeFilter, h1, h0, h1);
     tTwoZero_setCoefficients(&p->nutFilter, h1, h0, h1);
     tTwoZero_setCoefficients(&p->prepFilterU, h1, h0, h1);
@@ -895,16 +1546,17 @@ void     tLivingString2_setLevMode(tLivingString2* const pl, int levMode)
 
 float   tLivingString2_tick(tLivingString2* const pl, float input)
 {
+    LEAF_PROFILE_OBJECT(pl);
     _tLivingString2* p = *pl;
-
+    
     input = input * 0.5f; // drop gain by half since we'll be equally adding it at half amplitude to forward and backward waveguides
     // from prepPos upwards=forwards
     float wLen=tExpSmooth_tick(&p->wlSmooth);
-
+    
     float pickP=tExpSmooth_tick(&p->ppSmooth);
-
+    
     //float pickupPos=tExpSmooth_tick(&p->puSmooth);
-
+    
     //need to determine which delay line to put it into (should be half amplitude into forward and backward lines for the correct portion of string)
     float prepP=tExpSmooth_tick(&p->prpSmooth);
     float lowLen=prepP*wLen;
@@ -916,7 +1568,7 @@ float   tLivingString2_tick(tLivingString2* const pl, float input)
         float fullPickPoint =  ((pickP*wLen) - lowLen);
         pickPInt = (uint) fullPickPoint; // where does the input go? that's the pick point
         float pickPFloat = fullPickPoint - pickPInt;
-
+        
         tHermiteDelay_addTo(&p->delUF, input * (1.0f - pickPFloat), pickPInt);
         tHermiteDelay_addTo(&p->delUF, input * pickPFloat, pickPInt + 1);
         tHermiteDelay_addTo(&p->delUB, input * (1.0f - pickPFloat), (uint) (upLen - pickPInt));
@@ -927,7 +1579,7 @@ float   tLivingString2_tick(tLivingString2* const pl, float input)
          float fullPickPoint =  pickP * wLen;
         pickPInt = (uint) fullPickPoint; // where does the input go? that's the pick point
         float pickPFloat = fullPickPoint - pickPInt;
-
+        
         tHermiteDelay_addTo(&p->delLF, input * (1.0f - pickPFloat), pickPInt);
         tHermiteDelay_addTo(&p->delLF, input * pickPFloat, pickPInt + 1);
         tHermiteDelay_addTo(&p->delLB, input * (1.0f - pickPFloat), (uint) (lowLen - pickPInt));
@@ -938,7 +1590,7 @@ float   tLivingString2_tick(tLivingString2* const pl, float input)
     {
         float fullPickPoint =  ((pickP*wLen) - lowLen);
         pickPInt = (uint32_t) fullPickPoint; // where does the input go? that's the pick point
-
+        
         tHermiteDelay_addTo(&p->delUF, input, pickPInt);
         tHermiteDelay_addTo(&p->delUB, input, (uint32_t) (upLen - pickPInt));
     }
@@ -946,11 +1598,11 @@ float   tLivingString2_tick(tLivingString2* const pl, float input)
     {
         float fullPickPoint =  pickP * wLen;
         pickPInt = (uint32_t) fullPickPoint; // where does the input go? that's the pick point
-
+        
         tHermiteDelay_addTo(&p->delLF, input, pickPInt);
         tHermiteDelay_addTo(&p->delLB, input, (uint32_t) (lowLen - pickPInt));
     }
-
+    
     float fromLF=tHermiteDelay_tickOut(&p->delLF);
     float fromUF=tHermiteDelay_tickOut(&p->delUF);
     float fromUB=tHermiteDelay_tickOut(&p->delUB);
@@ -970,7 +1622,7 @@ float   tLivingString2_tick(tLivingString2* const pl, float input)
     float intoUpper=p->prepIndex*fromUpperPrep+(1.0f - p->prepIndex)*fromLF;
     tHermiteDelay_tickIn(&p->delUF, intoUpper);
     // update all delay lengths
-
+    
     tHermiteDelay_setDelay(&p->delLF, lowLen);
     tHermiteDelay_setDelay(&p->delLB, lowLen);
     tHermiteDelay_setDelay(&p->delUF, upLen);
@@ -996,24 +1648,25 @@ float   tLivingString2_tick(tLivingString2* const pl, float input)
     {
         p->curr = fromBridge;
     }
-
+    
     //p->curr = fromBridge;
     //p->curr += fromNut;
-
+    
     return p->curr;
 }
 
 float   tLivingString2_tickEfficient(tLivingString2* const pl, float input)
 {
+    LEAF_PROFILE_OBJECT(pl);
     _tLivingString2* p = *pl;
-
+    
     input = input * 0.5f; // drop gain by half since we'll be equally adding it at half amplitude to forward and backward waveguides
     // from prepPos upwards=forwards
     //float pickupPos=tExpSmooth_tick(&p->puSmooth);
     float wLen = p->wlSmooth->dest;
-
+    
     float pickP = p->ppSmooth->dest;
-
+    
     //need to determine which delay line to put it into (should be half amplitude into forward and backward lines for the correct portion of string)
     float prepP = p->prpSmooth->dest;
     float lowLen=p->prpSmooth->dest*p->wlSmooth->dest;
@@ -1023,7 +1676,7 @@ float   tLivingString2_tickEfficient(tLivingString2* const pl, float input)
     {
         float fullPickPoint =  ((pickP*wLen) - lowLen);
         pickPInt = (uint32_t) fullPickPoint; // where does the input go? that's the pick point
-
+        
         tHermiteDelay_addTo(&p->delUF, input, pickPInt);
         tHermiteDelay_addTo(&p->delUB, input, (uint32_t) (upLen - pickPInt));
     }
@@ -1031,7 +1684,7 @@ float   tLivingString2_tickEfficient(tLivingString2* const pl, float input)
     {
         float fullPickPoint =  pickP * wLen;
         pickPInt = (uint32_t) fullPickPoint; // where does the input go? that's the pick point
-
+        
         tHermiteDelay_addTo(&p->delLF, input, pickPInt);
         tHermiteDelay_addTo(&p->delLB, input, (uint32_t) (lowLen - pickPInt));
     }
@@ -1056,28 +1709,28 @@ float   tLivingString2_tickEfficient(tLivingString2* const pl, float input)
     float intoUpper=(p->prepIndex*fromUpperPrep)+((1.0f - p->prepIndex)*fromLF);
     tHermiteDelay_tickIn(&p->delUF, intoUpper);
     // update all delay lengths
-
+    
     p->curr = fromBridge;
-
+    
     //p->curr = fromBridge;
     //p->curr += fromNut;
-
+    
     return p->curr;
 }
 
 float   tLivingString2_udpateDelays(tLivingString2* const pl)
 {
     _tLivingString2* p = *pl;
-
-
-
+    
+    
+    
     //need to determine which delay line to put it into (should be half amplitude into forward and backward lines for the correct portion of string)
-
+    
     float lowLen=p->prpSmooth->dest*p->wlSmooth->dest;
     float upLen=(1.0f-p->prpSmooth->dest)*p->wlSmooth->dest;
-
-
-
+    
+    
+    
     tHermiteDelay_setDelay(&p->delLF, lowLen);
     tHermiteDelay_setDelay(&p->delLB, lowLen);
     tHermiteDelay_setDelay(&p->delUF, upLen);
@@ -1120,30 +1773,32 @@ void    tComplexLivingString_initToPool    (tComplexLivingString* const pl, floa
                                      float dampFreq, float decay, float targetLev, float levSmoothFactor,
                                      float levStrength, int levMode, tMempool* const mp)
 {
+    LEAF_PROFILE_POOL(mp);
     _tMempool* m = *mp;
     _tComplexLivingString* p = *pl = (_tComplexLivingString*) mpool_alloc(sizeof(_tComplexLivingString), m);
     p->mempool = m;
     LEAF* leaf = p->mempool->leaf;
-
+    
     p->sampleRate = leaf->sampleRate;
     p->curr=0.0f;
+    p->denormalOffset = LEAF_DENORMAL_OFFSET;
     tExpSmooth_initToPool(&p->wlSmooth, p->sampleRate/freq, 0.01f, mp); // smoother for string wavelength (not freq, to avoid expensive divisions)
     tComplexLivingString_setFreq(pl, freq);
     p->freq = freq;
     tExpSmooth_initToPool(&p->pickPosSmooth, pickPos, 0.01f, mp); // smoother for pick position
     tExpSmooth_initToPool(&p->prepPosSmooth, prepPos, 0.01f, mp); // smoother for pick position
-
+    
     tComplexLivingString_setPickPos(pl, pickPos);
     tComplexLivingString_setPrepPos(pl, prepPos);
-
+    
     p->prepPos=prepPos;
     p->pickPos=pickPos;
-    tLinearDelay_initToPool(&p->delLF,p->waveLengthInSamples, 2400, mp);
-    tLinearDelay_initToPool(&p->delMF,p->waveLengthInSamples, 2400, mp);
-    tLinearDelay_initToPool(&p->delUF,p->waveLengthInSamples, 2400, mp);
-    tLinearDelay_initToPool(&p->delUB,p->waveLengthInSamples, 2400, mp);
-    tLinearDelay_initToPool(&p->delMB,p->waveLengthInSamples, 2400, mp);
-    tLinearDelay_initToPool(&p->delLB,p->waveLengthInSamples, 2400, mp);
+    tLinearDelay_initToPoolPow2(&p->delLF,p->waveLengthInSamples, 2400, mp);
+    tLinearDelay_initToPoolPow2(&p->delMF,p->waveLengthInSamples, 2400, mp);
+    tLinearDelay_initToPoolPow2(&p->delUF,p->waveLengthInSamples, 2400, mp);
+    tLinearDelay_initToPoolPow2(&p->delUB,p->waveLengthInSamples, 2400, mp);
+    tLinearDelay_initToPoolPow2(&p->delMB,p->waveLengthInSamples, 2400, mp);
+    tLinearDelay_initToPoolPow2(&p->delLB,p->waveLengthInSamples, 2400, mp);
     tLinearDelay_clear(&p->delLF);
     tLinearDelay_clear(&p->delMF);
     tLinearDelay_clear(&p->delUF);
@@ -1167,7 +1822,7 @@ void    tComplexLivingString_initToPool    (tComplexLivingString* const pl, floa
 void    tComplexLivingString_free (tComplexLivingString* const pl)
 {
     _tComplexLivingString* p = *pl;
-
+    
     tExpSmooth_free(&p->wlSmooth);
     tExpSmooth_free(&p->pickPosSmooth);
     tExpSmooth_free(&p->prepPosSmooth);
@@ -1185,7 +1840,7 @@ void    tComplexLivingString_free (tComplexLivingString* const pl)
     tHighpass_free(&p->DCblockerL);
     tFeedbackLeveler_free(&p->fbLevU);
     tFeedbackLeveler_free(&p->fbLevL);
-
+    
     mpool_free((char*)p, p->mempool);
 }
 
@@ -1280,8 +1935,9 @@ void     tComplexLivingString_setLevMode(tComplexLivingString* const pl, int lev
 
 float   tComplexLivingString_tick(tComplexLivingString* const pl, float input)
 {
+    LEAF_PROFILE_OBJECT(pl);
     _tComplexLivingString* p = *pl;
-
+    
     // from pickPos upwards=forwards
     float fromLF=tLinearDelay_tickOut(&p->delLF);
     float fromMF=tLinearDelay_tickOut(&p->delMF);
@@ -1289,52 +1945,52 @@ float   tComplexLivingString_tick(tComplexLivingString* const pl, float input)
     float fromUB=tLinearDelay_tickOut(&p->delUB);
     float fromMB=tLinearDelay_tickOut(&p->delMB);
     float fromLB=tLinearDelay_tickOut(&p->delLB);
-
+    
     // into upper part of string, from bridge, going backwards
     float fromBridge=-tFeedbackLeveler_tick(&p->fbLevU, (p->levMode==0?p->decay:1)*tHighpass_tick(&p->DCblockerU, tOnePole_tick(&p->bridgeFilter, fromUF)));
     tLinearDelay_tickIn(&p->delUB, fromBridge);
-
+    
     // into pick position, take input and add it into the waveguide, going to come out of middle segment
     tLinearDelay_tickIn(&p->delMB, fromUB+input);
-
+    
     // into lower part of string, from prepPos, going backwards
     float fromLowerPrep=-tOnePole_tick(&p->prepFilterL, fromLF);
     float intoLower=p->prepIndex*fromLowerPrep+(1.0f - p->prepIndex)*fromMB;
     tLinearDelay_tickIn(&p->delLB, intoLower);
-
+    
     // into lower part of string, from nut, going forwards toward prep position
     float fromNut=-tFeedbackLeveler_tick(&p->fbLevL, (p->levMode==0?p->decay:1.0f)*tHighpass_tick(&p->DCblockerL, tOnePole_tick(&p->nutFilter, fromLB)));
     tLinearDelay_tickIn(&p->delLF, fromNut);
-
+    
     // into middle part of string, from prep going toward pick position
     float fromUpperPrep=-tOnePole_tick(&p->prepFilterU, fromUB);
     float intoMiddle=p->prepIndex*fromUpperPrep+(1.0f - p->prepIndex)*fromLF;
-
+    
     //pick position, take input and add it into the waveguide, going to come out of middle segment
     tLinearDelay_tickIn(&p->delMF, intoMiddle + input);
-
+    
     //take output of middle segment and put it into upper segment connecting to the bridge
     tLinearDelay_tickIn(&p->delUF, fromMF);
-
+    
     // update all delay lengths
     float pickP=tExpSmooth_tick(&p->pickPosSmooth);
     float prepP=tExpSmooth_tick(&p->prepPosSmooth);
     float wLen=tExpSmooth_tick(&p->wlSmooth);
-
+    
     float midLen = (pickP-prepP) * wLen; // the length between the pick and the prep;
     float lowLen = prepP*wLen; // the length from prep to nut
     float upLen = (1.0f-pickP)*wLen; // the length from pick to bridge
-
-
+    
+    
     tLinearDelay_setDelay(&p->delLF, lowLen);
     tLinearDelay_setDelay(&p->delLB, lowLen);
-
+    
     tLinearDelay_setDelay(&p->delMF, midLen);
     tLinearDelay_setDelay(&p->delMB, midLen);
-
+    
     tLinearDelay_setDelay(&p->delUF, upLen);
     tLinearDelay_setDelay(&p->delUB, upLen);
-
+    
     //update this to allow pickup position variation
     p->curr = fromBridge;
     return p->curr;
@@ -1361,6 +2017,95 @@ void    tComplexLivingString_setSampleRate(tComplexLivingString* const pl, float
     tHighpass_setSampleRate(&p->DCblockerL, p->sampleRate);
 }
 
+void    tComplexLivingString_tickBlock(tComplexLivingString* const pl, const float* input, float* output, int size)
+{
+    LEAF_PROFILE_OBJECT(pl);
+    _tComplexLivingString* p = *pl;
+    
+    lsLine LF, MF, UF, UB, MB, LB;
+    lsEnd bridge, nut;
+    lsPole prepU, prepL;
+    lsSmooth pick, prep, wl;
+    lsLine_load(&LF, p->delLF);
+    lsLine_load(&MF, p->delMF);
+    lsLine_load(&UF, p->delUF);
+    lsLine_load(&UB, p->delUB);
+    lsLine_load(&MB, p->delMB);
+    lsLine_load(&LB, p->delLB);
+    lsEnd_load(&bridge, p->bridgeFilter, p->DCblockerU, p->fbLevU);
+    lsEnd_load(&nut, p->nutFilter, p->DCblockerL, p->fbLevL);
+    lsPole_load(&prepU, p->prepFilterU);
+    lsPole_load(&prepL, p->prepFilterL);
+    lsSmooth_load(&pick, p->pickPosSmooth);
+    lsSmooth_load(&prep, p->prepPosSmooth);
+    lsSmooth_load(&wl, p->wlSmooth);
+    
+#if !LEAF_DENORMAL_CHECK
+    // Keep the loop out of denormals without checking every sample
+    bridge.lp.lastOut += p->denormalOffset;
+    p->denormalOffset = -p->denormalOffset;
+#endif
+
+    float gain = p->levMode==0?p->decay:1.0f;
+    float prepIndex = p->prepIndex;
+    float fromBridge = p->curr;
+    
+    for (int i = 0; i < size; ++i)
+    {
+        float in = input != NULL ? input[i] : 0.0f;
+        
+        float fromLF=lsLine_out(&LF);
+        float fromMF=lsLine_out(&MF);
+        float fromUF=lsLine_out(&UF);
+        float fromUB=lsLine_out(&UB);
+        float fromMB=lsLine_out(&MB);
+        float fromLB=lsLine_out(&LB);
+        
+        fromBridge=lsEnd_tick(&bridge, gain, fromUF);
+        lsLine_in(&UB, fromBridge);
+        lsLine_in(&MB, fromUB+in);
+        float fromLowerPrep=-lsPole_tick(&prepL, fromLF);
+        float intoLower=prepIndex*fromLowerPrep+(1.0f - prepIndex)*fromMB;
+        lsLine_in(&LB, intoLower);
+        float fromNut=lsEnd_tick(&nut, gain, fromLB);
+        lsLine_in(&LF, fromNut);
+        float fromUpperPrep=-lsPole_tick(&prepU, fromUB);
+        float intoMiddle=prepIndex*fromUpperPrep+(1.0f - prepIndex)*fromLF;
+        lsLine_in(&MF, intoMiddle + in);
+        lsLine_in(&UF, fromMF);
+        
+        float pickP=lsSmooth_tick(&pick);
+        float prepP=lsSmooth_tick(&prep);
+        float wLen=lsSmooth_tick(&wl);
+        float midLen = (pickP-prepP) * wLen;
+        float lowLen = prepP*wLen;
+        float upLen = (1.0f-pickP)*wLen;
+        lsLine_setDelay(&LF, lowLen);
+        lsLine_setDelay(&LB, lowLen);
+        lsLine_setDelay(&MF, midLen);
+        lsLine_setDelay(&MB, midLen);
+        lsLine_setDelay(&UF, upLen);
+        lsLine_setDelay(&UB, upLen);
+        
+        output[i] = fromBridge;
+    }
+    p->curr = fromBridge;
+    
+    lsLine_store(&LF, p->delLF);
+    lsLine_store(&MF, p->delMF);
+    lsLine_store(&UF, p->delUF);
+    lsLine_store(&UB, p->delUB);
+    lsLine_store(&MB, p->delMB);
+    lsLine_store(&LB, p->delLB);
+    lsEnd_store(&bridge, p->bridgeFilter, p->DCblockerU, p->fbLevU);
+    lsEnd_store(&nut, p->nutFilter, p->DCblockerL, p->fbLevL);
+    lsPole_store(&prepU, p->prepFilterU);
+    lsPole_store(&prepL, p->prepFilterL);
+    lsSmooth_store(&pick, p->pickPosSmooth);
+    lsSmooth_store(&prep, p->prepPosSmooth);
+    lsSmooth_store(&wl, p->wlSmooth);
+}
+
 ///Reed Table model
 //default values from STK are 0.6 offset and -0.8 slope
 
@@ -1371,6 +2116,7 @@ void    tReedTable_init      (tReedTable* const pm, float offset, float slope, L
 
 void    tReedTable_initToPool   (tReedTable* const pm, float offset, float slope, tMempool* const mp)
 {
+    LEAF_PROFILE_POOL(mp);
     _tMempool* m = *mp;
     _tReedTable* p = *pm = (_tReedTable*) mpool_alloc(sizeof(_tReedTable), m);
     p->mempool = m;
@@ -1388,6 +2134,7 @@ void    tReedTable_free (tReedTable* const pm)
 
 float   tReedTable_tick      (tReedTable* const pm, float input)
 {
+    LEAF_PROFILE_OBJECT(pm);
     _tReedTable* p = *pm;
     
     // The input is differential pressure across the reed.
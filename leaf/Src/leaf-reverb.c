@@ -18,6 +18,16 @@
 
 #endif
 
+#if LEAF_USE_SIMD
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define LEAF_SIMD_NEON 1
+#elif defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define LEAF_SIMD_SSE 1
+#endif
+#endif
+
 // ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ PRCReverb ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ //
 void    tPRCReverb_init(tPRCReverb* const rev, float t60, LEAF* const leaf)
 {
@@ -26,6 +36,7 @@ void    tPRCReverb_init(tPRCReverb* const rev, float t60, LEAF* const leaf)
 
 void    tPRCReverb_initToPool   (tPRCReverb* const rev, float t60, tMempool* const mp)
 {
+    LEAF_PROFILE_POOL(mp);
     _tMempool* m = *mp;
     _tPRCReverb* r = *rev = (_tPRCReverb*) mpool_alloc(sizeof(_tPRCReverb), m);
     r->mempool = m;
@@ -102,6 +113,7 @@ void    tPRCReverb_setMix(tPRCReverb* const rev, float mix)
 
 float   tPRCReverb_tick(tPRCReverb* const rev, float input)
 {
+    LEAF_PROFILE_OBJECT(rev);
     _tPRCReverb* r = *rev;
     
     float temp, temp0, temp1, temp2;
@@ -178,6 +190,7 @@ void    tNReverb_init(tNReverb* const rev, float t60, LEAF* const leaf)
 
 void    tNReverb_initToPool     (tNReverb* const rev, float t60, tMempool* const mp)
 {
+    LEAF_PROFILE_POOL(mp);
     _tMempool* m = *mp;
     _tNReverb* r = *rev = (_tNReverb*) mpool_alloc(sizeof(_tNReverb), m);
     r->mempool = m;
@@ -272,6 +285,7 @@ void    tNReverb_clear             (tNReverb* const rev)
 
 float   tNReverb_tick(tNReverb* const rev, float input)
 {
+    LEAF_PROFILE_OBJECT(rev);
     _tNReverb* r = *rev;
     r->lastIn = input;
     
@@ -329,6 +343,7 @@ float   tNReverb_tick(tNReverb* const rev, float input)
 
 void   tNReverb_tickStereo(tNReverb* const rev, float input, float* output)
 {
+    LEAF_PROFILE_OBJECT(rev);
     _tNReverb* r = *rev;
     r->lastIn = input;
 
@@ -418,6 +433,16 @@ void     tNReverb_setSampleRate (tNReverb* const rev, float sr)
     tNReverb_setT60(rev, r->t60);
 }
 
+// Output of a block skipped while quiescent
+static void reverb_silence(float* outL, float* outR, int outStride, int size)
+{
+    for (int i = 0; i < size; i++)
+    {
+        outL[i * outStride] = 0.0f;
+        if (outR != NULL) outR[i * outStride] = 0.0f;
+    }
+}
+
 // ======================================DATTORRO=========================================
 
 #define SAMP(in) (in*r->t)
@@ -425,6 +450,172 @@ void     tNReverb_setSampleRate (tNReverb* const rev, float sr)
 float       in_allpass_delays[4] = { 4.771f, 3.595f, 12.73f, 9.307f };
 float       in_allpass_gains[4] = { 0.75f, 0.75f, 0.625f, 0.625f };
 
+// The delay lines below are tTapeDelay and tAllpass with their buffers in the reverb's arena,
+// and have to stay step for step the same as those objects
+
+static inline void dattorro_tape_setDelay(_tDattorroTape* const d, float delay)
+{
+    d->delay = LEAF_clip(1.f, delay,  d->maxDelay);
+}
+
+static inline void dattorro_tape_init(_tDattorroTape* const d, float* buff, float delay, uint32_t maxDelay)
+{
+    d->buff = buff;
+    d->maxDelay = maxDelay;
+    d->inPoint = 0;
+    d->idx = 0.0f;
+    dattorro_tape_setDelay(d, delay);
+}
+
+static inline float dattorro_tape_read(const _tDattorroTape* const d, float pos)
+{
+    int idx = (int) pos;
+    float alpha = pos - idx;
+    uint32_t max = d->maxDelay;
+    
+    int i0 = idx > 0 ? idx - 1 : (int) max - 1;
+    int i2 = idx + 1 < (int) max ? idx + 1 : idx + 1 - (int) max;
+    int i3 = idx + 2 < (int) max ? idx + 2 : idx + 2 - (int) max;
+    
+    return LEAF_interpolate_hermite_x (d->buff[i0], d->buff[idx], d->buff[i2], d->buff[i3], alpha);
+}
+
+static inline float dattorro_tape_tick(_tDattorroTape* const d, float input)
+{
+    d->buff[d->inPoint] = input;
+    
+    if (++(d->inPoint) == d->maxDelay )    d->inPoint = 0;
+    
+    float lastOut = dattorro_tape_read(d, d->idx);
+    
+    float diff = (d->inPoint - d->idx);
+    while (diff < 0.f) diff += d->maxDelay;
+    
+    d->idx += 1.0f + (diff - d->delay) / d->delay;
+    
+    while (d->idx >= d->maxDelay) d->idx -= d->maxDelay;
+    
+    if (lastOut)
+        return lastOut;
+    return 0.0f;
+}
+
+static inline float dattorro_tape_tapOut(const _tDattorroTape* const d, float tapDelay)
+{
+    float tap = (float) d->inPoint - tapDelay - 1.f;
+    
+    while ( tap < 0.f )   tap += (float)d->maxDelay;
+    
+    return dattorro_tape_read(d, tap);
+}
+
+static inline void dattorro_allpass_setDelay(_tDattorroAllpass* const d, float delay)
+{
+    d->delay = LEAF_clip(0.0f, delay,  d->maxDelay);
+    
+    float outPointer = d->inPoint - d->delay;
+    
+    while ( outPointer < 0 )
+        outPointer += d->maxDelay;
+    
+    d->outPoint = (uint32_t) outPointer;
+    
+    d->alpha = outPointer - d->outPoint;
+    d->omAlpha = 1.0f - d->alpha;
+    
+    if ( d->outPoint == d->maxDelay ) d->outPoint = 0;
+}
+
+static inline void dattorro_allpass_init(_tDattorroAllpass* const d, float* buff, float delay, uint32_t maxDelay, float gain)
+{
+    d->buff = buff;
+    d->maxDelay = maxDelay;
+    d->inPoint = 0;
+    d->outPoint = 0;
+    d->gain = gain;
+    d->lastOut = 0.0f;
+    
+    if (delay > maxDelay)   delay = maxDelay;
+    else if (delay < 0.0f)  delay = 0.0f;
+    dattorro_allpass_setDelay(d, delay);
+}
+
+static inline float dattorro_allpass_tick(_tDattorroAllpass* const d, float input)
+{
+    float s1 = (-d->gain) * d->lastOut + input;
+    
+    d->buff[d->inPoint] = s1;
+    
+    if (++(d->inPoint) == d->maxDelay )    d->inPoint = 0;
+    
+    uint32_t idx = d->outPoint;
+    float out = d->buff[idx] * d->omAlpha;
+    if ((idx + 1) < d->maxDelay)
+        out += d->buff[idx+1] * d->alpha;
+    else
+        out += d->buff[0] * d->alpha;
+    
+    if ( (++d->outPoint) >= d->maxDelay )   d->outPoint = 0;
+    
+    d->lastOut = out + (d->gain) * input;
+    
+    return d->lastOut;
+}
+
+// Lays out every delay line of the reverb in one arena, each starting on a 16 byte boundary
+static void dattorro_initLines(_tDattorroReverb* const r)
+{
+    uint32_t in_delay = SAMP(200.f);
+    uint32_t in_allpass = SAMP(20.f);
+    uint32_t f_allpass = SAMP(100.f);
+    uint32_t f_delay_long = SAMP(200.0f) * r->size_max + 1;
+    uint32_t f_delay_short = SAMP(100.0f) * r->size_max + 1;
+    
+    uint32_t sizes[13] = { in_delay, in_allpass, in_allpass, in_allpass, in_allpass,
+        f_allpass, f_delay_long, f_delay_short, f_delay_long,
+        f_allpass, f_delay_long, f_delay_short, f_delay_long };
+    float* lines[13];
+    
+    size_t total = 0;
+    for (int i = 0; i < 13; i++) total += (sizes[i] + 3) & ~3u;
+    
+    r->arena = mpool_calloc(sizeof(float) * total + 15, r->mempool);
+    float* p = (float*) (((uintptr_t) r->arena + 15) & ~(uintptr_t) 15);
+    for (int i = 0; i < 13; i++)
+    {
+        lines[i] = p;
+        p += (sizes[i] + 3) & ~3u;
+    }
+    
+    // INPUT
+    dattorro_tape_init(&r->in_delay, lines[0], 0.f, in_delay);
+    
+    for (int i = 0; i < 4; i++)
+    {
+        dattorro_allpass_init(&r->in_allpass[i], lines[1 + i], SAMP(in_allpass_delays[i]), in_allpass, in_allpass_gains[i]);
+    }
+    
+    // FEEDBACK 1
+    dattorro_allpass_init(&r->f1_allpass, lines[5], SAMP(30.51f), f_allpass, 0.7f);
+    
+    dattorro_tape_init(&r->f1_delay_1, lines[6], SAMP(141.69f), f_delay_long);
+    dattorro_tape_init(&r->f1_delay_2, lines[7], SAMP(89.24f), f_delay_short);
+    dattorro_tape_init(&r->f1_delay_3, lines[8], SAMP(125.f), f_delay_long);
+    
+    // FEEDBACK 2
+    dattorro_allpass_init(&r->f2_allpass, lines[9], SAMP(22.58f), f_allpass, 0.7f);
+    
+    dattorro_tape_init(&r->f2_delay_1, lines[10], SAMP(149.62f), f_delay_long);
+    dattorro_tape_init(&r->f2_delay_2, lines[11], SAMP(60.48f), f_delay_short);
+    dattorro_tape_init(&r->f2_delay_3, lines[12], SAMP(106.28f), f_delay_long);
+    
+    if (r->frozen)
+    {
+        r->f1_allpass.gain = 1.0f;
+        r->f2_allpass.gain = 1.0f;
+    }
+}
+
 void    tDattorroReverb_init              (tDattorroReverb* const rev, LEAF* const leaf)
 {
     tDattorroReverb_initToPool(rev, &leaf->mempool);
@@ -432,35 +623,32 @@ void    tDattorroReverb_init              (tDattorroReverb* const rev, LEAF* con
 
 void    tDattorroReverb_initToPool        (tDattorroReverb* const rev, tMempool* const mp)
 {
+    LEAF_PROFILE_POOL(mp);
     _tMempool* m = *mp;
     _tDattorroReverb* r = *rev = (_tDattorroReverb*) mpool_alloc(sizeof(_tDattorroReverb), m);
     r->mempool = m;
     LEAF* leaf = r->mempool->leaf;
     
     r->sampleRate = leaf->sampleRate;
+    r->denormalOffset = LEAF_DENORMAL_OFFSET;
     
     r->size_max = 2.0f;
     r->size = 1.f;
     r->t = r->size * r->sampleRate * 0.001f;
     r->frozen = 0;
-    // INPUT
-    tTapeDelay_initToPool(&r->in_delay, 0.f, SAMP(200.f), mp);
-    tOnePole_initToPool(&r->in_filter, 1.f, mp);
+    LEAF_quiescenceInit(&r->quiet, 0.0f, 0);
     
-    for (int i = 0; i < 4; i++)
-    {
-        tAllpass_initToPool(&r->in_allpass[i], SAMP(in_allpass_delays[i]), SAMP(20.f), mp); // * r->size_max
-        tAllpass_setGain(&r->in_allpass[i], in_allpass_gains[i]);
-    }
+    r->f1_delay_2_last = 0.0f;
+    r->f2_delay_2_last = 0.0f;
+    r->f1_last = 0.0f;
+    r->f2_last = 0.0f;
     
-    // FEEDBACK 1
-    tAllpass_initToPool(&r->f1_allpass, SAMP(30.51f), SAMP(100.f), mp); // * r->size_max
-    tAllpass_setGain(&r->f1_allpass, 0.7f);
+    dattorro_initLines(r);
     
-    tTapeDelay_initToPool(&r->f1_delay_1, SAMP(141.69f), SAMP(200.0f) * r->size_max + 1, mp);
-    tTapeDelay_initToPool(&r->f1_delay_2, SAMP(89.24f), SAMP(100.0f) * r->size_max + 1, mp);
-    tTapeDelay_initToPool(&r->f1_delay_3, SAMP(125.f), SAMP(200.0f) * r->size_max + 1, mp);
+    // INPUT
+    tOnePole_initToPool(&r->in_filter, 1.f, mp);
     
+    // FEEDBACK 1
     tOnePole_initToPool(&r->f1_filter, 1.f, mp);
     
     tHighpass_initToPool(&r->f1_hp, 20.f, mp);
@@ -469,13 +657,6 @@ void    tDattorroReverb_initToPool        (tDattorroReverb* const rev, tMempool*
     tCycle_setFreq(&r->f1_lfo, 0.1f);
     
     // FEEDBACK 2
-    tAllpass_initToPool(&r->f2_allpass, SAMP(22.58f), SAMP(100.f), mp); // * r->size_max
-    tAllpass_setGain(&r->f2_allpass, 0.7f);
-    
-    tTapeDelay_initToPool(&r->f2_delay_1, SAMP(149.62f), SAMP(200.f) * r->size_max + 1, mp);
-    tTapeDelay_initToPool(&r->f2_delay_2, SAMP(60.48f), SAMP(100.f) * r->size_max + 1, mp);
-    tTapeDelay_initToPool(&r->f2_delay_3, SAMP(106.28f), SAMP(200.f) * r->size_max + 1, mp);
-    
     tOnePole_initToPool(&r->f2_filter, 1.f, mp);
     
     tHighpass_initToPool(&r->f2_hp, 20.f, mp);
@@ -496,21 +677,9 @@ void    tDattorroReverb_free (tDattorroReverb* const rev)
     _tDattorroReverb* r = *rev;
     
     // INPUT
-    tTapeDelay_free(&r->in_delay);
     tOnePole_free(&r->in_filter);
     
-    for (int i = 0; i < 4; i++)
-    {
-        tAllpass_free(&r->in_allpass[i]);
-    }
-    
     // FEEDBACK 1
-    tAllpass_free(&r->f1_allpass);
-    
-    tTapeDelay_free(&r->f1_delay_1);
-    tTapeDelay_free(&r->f1_delay_2);
-    tTapeDelay_free(&r->f1_delay_3);
-    
     tOnePole_free(&r->f1_filter);
     
     tHighpass_free(&r->f1_hp);
@@ -518,261 +687,300 @@ void    tDattorroReverb_free (tDattorroReverb* const rev)
     tCycle_free(&r->f1_lfo);
     
     // FEEDBACK 2
-    tAllpass_free(&r->f2_allpass);
-    
-    tTapeDelay_free(&r->f2_delay_1);
-    tTapeDelay_free(&r->f2_delay_2);
-    tTapeDelay_free(&r->f2_delay_3);
-    
     tOnePole_free(&r->f2_filter);
     
     tHighpass_free(&r->f2_hp);
     
     tCycle_free(&r->f2_lfo);
     
+    mpool_free(r->arena, r->mempool);
     mpool_free((char*)r, r->mempool);
 }
 
+static inline void dattorro_tape_clear(_tDattorroTape* const d)
+{
+    for (unsigned i = 0; i < d->maxDelay; i++)
+    {
+        d->buff[i] = 0;
+    }
+}
+
 void    tDattorroReverb_clear             (tDattorroReverb* const rev)
 {
     _tDattorroReverb* r = *rev;
     
-    tTapeDelay_clear(&r->in_delay);
-    tTapeDelay_clear(&r->f1_delay_1);
-    tTapeDelay_clear(&r->f1_delay_2);
-    tTapeDelay_clear(&r->f1_delay_3);
-    tTapeDelay_clear(&r->f2_delay_1);
-    tTapeDelay_clear(&r->f2_delay_2);
-    tTapeDelay_clear(&r->f2_delay_3);
+    dattorro_tape_clear(&r->in_delay);
+    dattorro_tape_clear(&r->f1_delay_1);
+    dattorro_tape_clear(&r->f1_delay_2);
+    dattorro_tape_clear(&r->f1_delay_3);
+    dattorro_tape_clear(&r->f2_delay_1);
+    dattorro_tape_clear(&r->f2_delay_2);
+    dattorro_tape_clear(&r->f2_delay_3);
 }
 
-float   tDattorroReverb_tick              (tDattorroReverb* const rev, float input)
+// Runs the reverb over a block. The LFOs and the tap positions are worked out before the loop,
+// and the filter states are kept in locals while it runs. tickStereo has always cut the tank
+// input while frozen and tick hasn't, so that depends on stereo.
+static void dattorro_process(_tDattorroReverb* const r, const float* input, int inStride, float* outL, float* outR, int outStride, int size, int stereo)
 {
-    _tDattorroReverb* r = *rev;
+    // A frozen tank never dies away
+    if (r->frozen) LEAF_quiescenceWake(&r->quiet);
+    else if (LEAF_quiescenceBegin(&r->quiet, input, inStride, size))
+    {
+        reverb_silence(outL, stereo ? outR : NULL, outStride, size);
+        return;
+    }
     
+    float lfo1[DATTORRO_BLOCK], lfo2[DATTORRO_BLOCK];
+    
+    _tOnePole* in_filter = r->in_filter;
+    _tOnePole* f1_filter = r->f1_filter;
+    _tOnePole* f2_filter = r->f2_filter;
+    _tHighpass* f1_hp = r->f1_hp;
+    _tHighpass* f2_hp = r->f2_hp;
+    
+    float in_b0 = in_filter->b0, in_a1 = in_filter->a1, in_gain = in_filter->gain;
+    float in_lastIn = in_filter->lastIn, in_lastOut = in_filter->lastOut;
+    float f1_b0 = f1_filter->b0, f1_a1 = f1_filter->a1, f1_gain = f1_filter->gain;
+    float f1_lastIn = f1_filter->lastIn, f1_lastOut = f1_filter->lastOut;
+    float f2_b0 = f2_filter->b0, f2_a1 = f2_filter->a1, f2_gain = f2_filter->gain;
+    float f2_lastIn = f2_filter->lastIn, f2_lastOut = f2_filter->lastOut;
+    float f1_R = f1_hp->R, f1_xs = f1_hp->xs, f1_ys = f1_hp->ys;
+    float f2_R = f2_hp->R, f2_xs = f2_hp->xs, f2_ys = f2_hp->ys;
+    
+    float f1_delay_2_last = r->f1_delay_2_last;
+    float f2_delay_2_last = r->f2_delay_2_last;
+    float f1_last = r->f1_last;
+    float f2_last = r->f2_last;
+    
+#if !LEAF_DENORMAL_CHECK
+    // Keep the diffusers and the tank out of denormals without checking every sample
+    float denormalOffset = r->denormalOffset;
+    r->denormalOffset = -r->denormalOffset;
+#endif
 
-    float in_sample, f1_sample,f1_delay_2_sample,  f2_sample, f2_delay_2_sample;
-
-    if (r->frozen)
+    float feedback_gain = r->feedback_gain;
+    float mix = r->mix;
+    int frozen = r->frozen;
+    
+    float f1_ap_base = SAMP(30.51f), f2_ap_base = SAMP(22.58f), ap_depth = SAMP(4.0f);
+    float tap_8_9 = SAMP(8.9f), tap_99_8 = SAMP(99.8f), tap_64_2 = SAMP(64.2f), tap_67 = SAMP(67.f);
+    float tap_66_8 = SAMP(66.8f), tap_6_3 = SAMP(6.3f), tap_35_8 = SAMP(35.8f);
+    float tap_11_8 = SAMP(11.8f), tap_121_7 = SAMP(121.7f), tap_89_7 = SAMP(89.7f);
+    float tap_70_8 = SAMP(70.8f), tap_11_2 = SAMP(11.2f), tap_4_1 = SAMP(4.1f);
+    
+    for (int offset = 0; offset < size; offset += DATTORRO_BLOCK)
     {
-        input = 0.0f;
-        //r->f1_last = 0.0f;
-        //r->f2_last = 0.0f;
+        int n = size - offset < DATTORRO_BLOCK ? size - offset : DATTORRO_BLOCK;
+        
+        for (int i = 0; i < n; i++)
+        {
+            lfo1[i] = tCycle_tick(&r->f1_lfo);
+            lfo2[i] = tCycle_tick(&r->f2_lfo);
+        }
+        
+        for (int i = 0; i < n; i++)
+        {
+            float in = input[(offset + i) * inStride];
+            float in_sample, f1_sample, f2_sample;
+            
+            if (frozen) in = 0.0f;
+#if !LEAF_DENORMAL_CHECK
+            in += denormalOffset;
+#endif
+            
+            // INPUT
+            in_sample = dattorro_tape_tick(&r->in_delay, in);
+            
+            in_lastIn = in_sample * in_gain;
+            in_lastOut = (in_b0 * in_lastIn) + (in_a1 * in_lastOut);
+            in_sample = in_lastOut;
+            
+            for (int j = 0; j < 4; j++)
+            {
+                in_sample = dattorro_allpass_tick(&r->in_allpass[j], in_sample);
+            }
+            
+            // FEEDBACK 1
+            f1_sample = in_sample + f2_last;
+            
+            dattorro_allpass_setDelay(&r->f1_allpass, f1_ap_base + lfo1[i] * ap_depth);
+            
+            f1_sample = dattorro_allpass_tick(&r->f1_allpass, f1_sample);
+            
+            f1_sample = dattorro_tape_tick(&r->f1_delay_1, f1_sample);
+            
+            f1_lastIn = f1_sample * f1_gain;
+            f1_lastOut = (f1_b0 * f1_lastIn) + (f1_a1 * f1_lastOut);
+            f1_sample = f1_lastOut;
+            
+            f1_sample = f1_sample + f1_delay_2_last * 0.5f;
+            
+            f1_delay_2_last = dattorro_tape_tick(&r->f1_delay_2, f1_sample * 0.5f);
+            
+            f1_sample = f1_delay_2_last + f1_sample;
+            
+            f1_ys = f1_sample - f1_xs + f1_R * f1_ys;
+            f1_xs = f1_sample;
+            f1_sample = f1_ys;
+            
+            f1_sample *= feedback_gain;
+            
+            if (stereo && frozen) f1_sample = 0.0f;
+            
+            f1_last = dattorro_tape_tick(&r->f1_delay_3, f1_sample);
+            
+            // FEEDBACK 2
+            f2_sample = in_sample + f1_last;
+            
+            dattorro_allpass_setDelay(&r->f2_allpass, f2_ap_base + lfo2[i] * ap_depth);
+            
+            f2_sample = dattorro_allpass_tick(&r->f2_allpass, f2_sample);
+            
+            f2_sample = dattorro_tape_tick(&r->f2_delay_1, f2_sample);
+            
+            f2_lastIn = f2_sample * f2_gain;
+            f2_lastOut = (f2_b0 * f2_lastIn) + (f2_a1 * f2_lastOut);
+            f2_sample = f2_lastOut;
+            
+            f2_sample = f2_sample + f2_delay_2_last * 0.5f;
+            
+            f2_delay_2_last = dattorro_tape_tick(&r->f2_delay_2, f2_sample * 0.5f);
+            
+            f2_sample = f2_delay_2_last + f2_sample;
+            
+            f2_ys = f2_sample - f2_xs + f2_R * f2_ys;
+            f2_xs = f2_sample;
+            f2_sample = f2_ys;
+            
+            f2_sample *= feedback_gain;
+            
+            if (stereo && frozen) f2_sample = 0.0f;
+            
+            f2_last = dattorro_tape_tick(&r->f2_delay_3, f2_sample);
+            
+            // TAP OUT 1
+            f1_sample =     dattorro_tape_tapOut(&r->f1_delay_1, tap_8_9) +
+            dattorro_tape_tapOut(&r->f1_delay_1, tap_99_8);
+            
+            f1_sample -=    dattorro_tape_tapOut(&r->f1_delay_2, tap_64_2);
+            
+            f1_sample +=    dattorro_tape_tapOut(&r->f1_delay_3, tap_67);
+            
+            f1_sample -=    dattorro_tape_tapOut(&r->f2_delay_1, tap_66_8);
+            
+            f1_sample -=    dattorro_tape_tapOut(&r->f2_delay_2, tap_6_3);
+            
+            f1_sample -=    dattorro_tape_tapOut(&r->f2_delay_3, tap_35_8);
+            
+            f1_sample *=    0.14f;
+            
+            // TAP OUT 2
+            f2_sample =     dattorro_tape_tapOut(&r->f2_delay_1, tap_11_8) +
+            dattorro_tape_tapOut(&r->f2_delay_1, tap_121_7);
+            
+            f2_sample -=    dattorro_tape_tapOut(&r->f2_delay_2, tap_6_3);
+            
+            f2_sample +=    dattorro_tape_tapOut(&r->f2_delay_3, tap_89_7);
+            
+            f2_sample -=    dattorro_tape_tapOut(&r->f1_delay_1, tap_70_8);
+            
+            f2_sample -=    dattorro_tape_tapOut(&r->f1_delay_2, tap_11_2);
+            
+            f2_sample -=    dattorro_tape_tapOut(&r->f1_delay_3, tap_4_1);
+            
+            f2_sample *=    0.14f;
+            
+            if (stereo)
+            {
+                outL[(offset + i) * outStride] = in * (1.0f - mix) + f1_sample  * mix;
+                outR[(offset + i) * outStride] = in * (1.0f - mix) + f2_sample * mix;
+            }
+            else
+            {
+                float sample = (f1_sample + f2_sample) * 0.5f;
+                outL[(offset + i) * outStride] = (in * (1.0f - mix) + sample * mix);
+            }
+        }
     }
-    // INPUT
-    in_sample = tTapeDelay_tick(&r->in_delay, input);
-
-    in_sample = tOnePole_tick(&r->in_filter, in_sample);
-
-    for (int i = 0; i < 4; i++)
+    
+    in_filter->lastIn = in_lastIn;
+    in_filter->lastOut = in_lastOut;
+    f1_filter->lastIn = f1_lastIn;
+    f1_filter->lastOut = f1_lastOut;
+    f2_filter->lastIn = f2_lastIn;
+    f2_filter->lastOut = f2_lastOut;
+    f1_hp->xs = f1_xs;
+    f1_hp->ys = f1_ys;
+    f2_hp->xs = f2_xs;
+    f2_hp->ys = f2_ys;
+    
+    r->f1_delay_2_last = f1_delay_2_last;
+    r->f2_delay_2_last = f2_delay_2_last;
+    r->f1_last = f1_last;
+    r->f2_last = f2_last;
+    
+    if (!r->frozen)
     {
-        in_sample = tAllpass_tick(&r->in_allpass[i], in_sample);
+        LEAF_quiescenceHear(&r->quiet, outL, outStride, size);
+        if (stereo) LEAF_quiescenceHear(&r->quiet, outR, outStride, size);
+        LEAF_quiescenceEnd(&r->quiet, size);
     }
+}
 
-    // FEEDBACK 1
-    f1_sample = in_sample + r->f2_last; // + f2_last_out;
-
-    tAllpass_setDelay(&r->f1_allpass, SAMP(30.51f) + tCycle_tick(&r->f1_lfo) * SAMP(4.0f));
-
-    f1_sample = tAllpass_tick(&r->f1_allpass, f1_sample);
-
-    f1_sample = tTapeDelay_tick(&r->f1_delay_1, f1_sample);
-
-    f1_sample = tOnePole_tick(&r->f1_filter, f1_sample);
-
-    f1_sample = f1_sample + r->f1_delay_2_last * 0.5f;
-
-    f1_delay_2_sample = tTapeDelay_tick(&r->f1_delay_2, f1_sample * 0.5f);
-
-    r->f1_delay_2_last = f1_delay_2_sample;
-
-    f1_sample = r->f1_delay_2_last + f1_sample;
-
-    f1_sample = tHighpass_tick(&r->f1_hp, f1_sample);
-
-    f1_sample *= r->feedback_gain;
-
-    r->f1_last = tTapeDelay_tick(&r->f1_delay_3, f1_sample);
-
-    // FEEDBACK 2
-    f2_sample = in_sample + r->f1_last;
-
-    tAllpass_setDelay(&r->f2_allpass, SAMP(22.58f) + tCycle_tick(&r->f2_lfo) * SAMP(4.0f));
-
-    f2_sample = tAllpass_tick(&r->f2_allpass, f2_sample);
-
-    f2_sample = tTapeDelay_tick(&r->f2_delay_1, f2_sample);
-
-    f2_sample = tOnePole_tick(&r->f2_filter, f2_sample);
-
-    f2_sample = f2_sample + r->f2_delay_2_last * 0.5f;
-
-    f2_delay_2_sample = tTapeDelay_tick(&r->f2_delay_2, f2_sample * 0.5f);
-
-    r->f2_delay_2_last = f2_delay_2_sample;
-
-    f2_sample = r->f2_delay_2_last + f2_sample;
-
-    f2_sample = tHighpass_tick(&r->f2_hp, f2_sample);
-
-    f2_sample *= r->feedback_gain;
-
-    r->f2_last = tTapeDelay_tick(&r->f2_delay_3, f2_sample);
-    
-    // TAP OUT 1
-    f1_sample =     tTapeDelay_tapOut(&r->f1_delay_1, SAMP(8.9f)) +
-    tTapeDelay_tapOut(&r->f1_delay_1, SAMP(99.8f));
-    
-    f1_sample -=    tTapeDelay_tapOut(&r->f1_delay_2, SAMP(64.2f));
-    
-    f1_sample +=    tTapeDelay_tapOut(&r->f1_delay_3, SAMP(67.f));
-    
-    f1_sample -=    tTapeDelay_tapOut(&r->f2_delay_1, SAMP(66.8f));
-    
-    f1_sample -=    tTapeDelay_tapOut(&r->f2_delay_2, SAMP(6.3f));
-    
-    f1_sample -=    tTapeDelay_tapOut(&r->f2_delay_3, SAMP(35.8f));
-    
-    f1_sample *=    0.14f;
-    
-    // TAP OUT 2
-    f2_sample =     tTapeDelay_tapOut(&r->f2_delay_1, SAMP(11.8f)) +
-    tTapeDelay_tapOut(&r->f2_delay_1, SAMP(121.7f));
-    
-    f2_sample -=    tTapeDelay_tapOut(&r->f2_delay_2, SAMP(6.3f));
-    
-    f2_sample +=    tTapeDelay_tapOut(&r->f2_delay_3, SAMP(89.7f));
-    
-    f2_sample -=    tTapeDelay_tapOut(&r->f1_delay_1, SAMP(70.8f));
-    
-    f2_sample -=    tTapeDelay_tapOut(&r->f1_delay_2, SAMP(11.2f));
-    
-    f2_sample -=    tTapeDelay_tapOut(&r->f1_delay_3, SAMP(4.1f));
-    
-    f2_sample *=    0.14f;
-    
-    float sample = (f1_sample + f2_sample) * 0.5f;
+float   tDattorroReverb_tick              (tDattorroReverb* const rev, float input)
+{
+    LEAF_PROFILE_OBJECT(rev);
+    _tDattorroReverb* r = *rev;
     
-    return (input * (1.0f - r->mix) + sample * r->mix);
+    float output;
+    dattorro_process(r, &input, 1, &output, NULL, 1, 1, 0);
+    return output;
 }
 
 void   tDattorroReverb_tickStereo              (tDattorroReverb* const rev, float input, float* output)
 {
+    LEAF_PROFILE_OBJECT(rev);
     _tDattorroReverb* r = *rev;
-    float in_sample, f1_sample,f1_delay_2_sample,  f2_sample, f2_delay_2_sample;
 
-    if (r->frozen)
-    {
-        input = 0.0f;
-        //r->f1_last = 0.0f;
-        //r->f2_last = 0.0f;
+    dattorro_process(r, &input, 1, &output[0], &output[1], 1, 1, 1);
     }
-    // INPUT
-    in_sample = tTapeDelay_tick(&r->in_delay, input);
-
-    in_sample = tOnePole_tick(&r->in_filter, in_sample);
 
-    for (int i = 0; i < 4; i++)
-    {
-        in_sample = tAllpass_tick(&r->in_allpass[i], in_sample);
-    }
-
-    // FEEDBACK 1
-    f1_sample = in_sample + r->f2_last; // + f2_last_out;
-    
-    tAllpass_setDelay(&r->f1_allpass, SAMP(30.51f) + tCycle_tick(&r->f1_lfo) * SAMP(4.0f));
-    
-    f1_sample = tAllpass_tick(&r->f1_allpass, f1_sample);
-    
-    f1_sample = tTapeDelay_tick(&r->f1_delay_1, f1_sample);
-    
-    f1_sample = tOnePole_tick(&r->f1_filter, f1_sample);
-    
-    f1_sample = f1_sample + r->f1_delay_2_last * 0.5f;
-    
-    f1_delay_2_sample = tTapeDelay_tick(&r->f1_delay_2, f1_sample * 0.5f);
-    
-    r->f1_delay_2_last = f1_delay_2_sample;
-    
-    f1_sample = r->f1_delay_2_last + f1_sample;
-    
-    f1_sample = tHighpass_tick(&r->f1_hp, f1_sample);
-    
-    f1_sample *= r->feedback_gain;
+void    tDattorroReverb_tickBlock         (tDattorroReverb* const rev, const float* input, float* output, int size)
+{
+    LEAF_PROFILE_OBJECT(rev);
+    _tDattorroReverb* r = *rev;
     
-    if (r->frozen)
-    {
-        f1_sample = 0.0f;
+    dattorro_process(r, input, 1, output, NULL, 1, size, 0);
     }
     
-    r->f1_last = tTapeDelay_tick(&r->f1_delay_3, f1_sample);
-    
-    // FEEDBACK 2
-    f2_sample = in_sample + r->f1_last;
-    
-    tAllpass_setDelay(&r->f2_allpass, SAMP(22.58f) + tCycle_tick(&r->f2_lfo) * SAMP(4.0f));
-    
-    f2_sample = tAllpass_tick(&r->f2_allpass, f2_sample);
-    
-    f2_sample = tTapeDelay_tick(&r->f2_delay_1, f2_sample);
-    
-    f2_sample = tOnePole_tick(&r->f2_filter, f2_sample);
-    
-    f2_sample = f2_sample + r->f2_delay_2_last * 0.5f;
-    
-    f2_delay_2_sample = tTapeDelay_tick(&r->f2_delay_2, f2_sample * 0.5f);
-    
-    r->f2_delay_2_last = f2_delay_2_sample;
-    
-    f2_sample = r->f2_delay_2_last + f2_sample;
-    
-    f2_sample = tHighpass_tick(&r->f2_hp, f2_sample);
-    
-    f2_sample *= r->feedback_gain;
-    
-    if (r->frozen)
-    {
-        f2_sample = 0.0f;
-    }
-    r->f2_last = tTapeDelay_tick(&r->f2_delay_3, f2_sample);
+void    tDattorroReverb_tickStereoBlock   (tDattorroReverb* const rev, const float* input, float** outputs, int size)
+{
+    LEAF_PROFILE_OBJECT(rev);
+    _tDattorroReverb* r = *rev;
     
+    dattorro_process(r, input, 1, outputs[0], outputs[1], 1, size, 1);
+}
 
+void    tDattorroReverb_tickView          (tDattorroReverb* const rev, LEAFBufferView input, LEAFBufferView output)
+{
+    LEAF_PROFILE_OBJECT(rev);
+    _tDattorroReverb* r = *rev;
+    
+    float* outR = output.channels > 1 ? output.data + output.channelStride : NULL;
+    dattorro_process(r, input.data, input.frameStride, output.data, outR, output.frameStride, input.frames, outR != NULL);
+}
 
-    // TAP OUT 1
-    f1_sample =     tTapeDelay_tapOut(&r->f1_delay_1, SAMP(8.9f)) +
-    tTapeDelay_tapOut(&r->f1_delay_1, SAMP(99.8f));
-
-    f1_sample -=    tTapeDelay_tapOut(&r->f1_delay_2, SAMP(64.2f));
-
-    f1_sample +=    tTapeDelay_tapOut(&r->f1_delay_3, SAMP(67.f));
-
-    f1_sample -=    tTapeDelay_tapOut(&r->f2_delay_1, SAMP(66.8f));
-
-    f1_sample -=    tTapeDelay_tapOut(&r->f2_delay_2, SAMP(6.3f));
-
-    f1_sample -=    tTapeDelay_tapOut(&r->f2_delay_3, SAMP(35.8f));
-
-    f1_sample *=    0.14f;
-
-    // TAP OUT 2
-    f2_sample =     tTapeDelay_tapOut(&r->f2_delay_1, SAMP(11.8f)) +
-    tTapeDelay_tapOut(&r->f2_delay_1, SAMP(121.7f));
-
-    f2_sample -=    tTapeDelay_tapOut(&r->f2_delay_2, SAMP(6.3f));
-
-    f2_sample +=    tTapeDelay_tapOut(&r->f2_delay_3, SAMP(89.7f));
-
-    f2_sample -=    tTapeDelay_tapOut(&r->f1_delay_1, SAMP(70.8f));
-
-    f2_sample -=    tTapeDelay_tapOut(&r->f1_delay_2, SAMP(11.2f));
-
-    f2_sample -=    tTapeDelay_tapOut(&r->f1_delay_3, SAMP(4.1f));
-
-    f2_sample *=    0.14f;
-
-    output[0] = input * (1.0f - r->mix) + f1_sample  * r->mix;
-    output[1] = input * (1.0f - r->mix) + f2_sample * r->mix;
+void    tDattorroReverb_setQuiescence (tDattorroReverb* const rev, float threshold, int holdSamples)
+{
+    _tDattorroReverb* r = *rev;
+    LEAF_quiescenceInit(&r->quiet, threshold, holdSamples);
+}
 
+int     tDattorroReverb_isQuiescent   (tDattorroReverb* const rev)
+{
+    _tDattorroReverb* r = *rev;
+    return LEAF_quiescenceIsQuiet(&r->quiet);
 }
 
 void    tDattorroReverb_setMix            (tDattorroReverb* const rev, float mix)
@@ -787,24 +995,15 @@ void    tDattorroReverb_setFreeze            (tDattorroReverb* const rev, int fr
     r->frozen = freeze;
     if (freeze)
     {
-        tAllpass_setGain(&r->f2_allpass, 1.0f);
-        tAllpass_setGain(&r->f1_allpass, 1.0f);
-        for (int i = 0; i < 4; i++)
-        {
-
-            //tAllpass_setGain(&r->in_allpass[i], 1.0f);
-        }
+        r->f2_allpass.gain = 1.0f;
+        r->f1_allpass.gain = 1.0f;
         tCycle_setFreq(&r->f1_lfo, 0.0f);
         tCycle_setFreq(&r->f2_lfo, 0.0f);
     }
     else
     {
-        tAllpass_setGain(&r->f2_allpass, 0.7f);
-        tAllpass_setGain(&r->f1_allpass, 0.7f);
-        for (int i = 0; i < 4; i++)
-        {
-             //tAllpass_setGain(&r->in_allpass[i], in_allpass_gains[i]);
-        }
+        r->f2_allpass.gain = 0.7f;
+        r->f1_allpass.gain = 0.7f;
         tCycle_setFreq(&r->f1_lfo, 0.1f);
         tCycle_setFreq(&r->f2_lfo, 0.07f);
     }
@@ -827,29 +1026,18 @@ void    tDattorroReverb_setSize           (tDattorroReverb* const rev, float siz
     r->size = LEAF_clip(0.01f, size*r->size_max, r->size_max);
     r->t = r->size * r->sampleRate * 0.001f;
     
-    /*
-     for (int i = 0; i < 4; i++)
-     {
-     tAllpass_setDelay(&r->in_allpass[i], SAMP(in_allpass_delays[i]));
-     }
-     */
-    
     // FEEDBACK 1
-    //tAllpass_setDelay(&r->f1_allpass, SAMP(30.51f));
-    
-    tTapeDelay_setDelay(&r->f1_delay_1, SAMP(141.69f));
-    tTapeDelay_setDelay(&r->f1_delay_2, SAMP(89.24f));
-    tTapeDelay_setDelay(&r->f1_delay_3, SAMP(125.f));
+    dattorro_tape_setDelay(&r->f1_delay_1, SAMP(141.69f));
+    dattorro_tape_setDelay(&r->f1_delay_2, SAMP(89.24f));
+    dattorro_tape_setDelay(&r->f1_delay_3, SAMP(125.f));
     
     // maybe change rate of SINE LFO's when size changes?
     //tCycle_setFreq(&r->f2_lfo, 0.07f * size * r->size_max);
     
     // FEEDBACK 2
-    //tAllpass_setDelay(&r->f2_allpass, SAMP(22.58f));
-    
-    tTapeDelay_setDelay(&r->f2_delay_1, SAMP(149.62f));
-    tTapeDelay_setDelay(&r->f2_delay_2, SAMP(60.48f));
-    tTapeDelay_setDelay(&r->f2_delay_3, SAMP(106.28f));
+    dattorro_tape_setDelay(&r->f2_delay_1, SAMP(149.62f));
+    dattorro_tape_setDelay(&r->f2_delay_2, SAMP(60.48f));
+    dattorro_tape_setDelay(&r->f2_delay_3, SAMP(106.28f));
 }
 
 void    tDattorroReverb_setInputDelay     (tDattorroReverb* const rev, float preDelay)
@@ -858,7 +1046,7 @@ void    tDattorroReverb_setInputDelay     (tDattorroReverb* const rev, float pre
     
     r->predelay = LEAF_clip(0.0f, preDelay, 200.0f);
     
-    tTapeDelay_setDelay(&r->in_delay, SAMP(r->predelay));
+    dattorro_tape_setDelay(&r->in_delay, SAMP(r->predelay));
 }
 
 void    tDattorroReverb_setInputFilter    (tDattorroReverb* const rev, float freq)
@@ -889,71 +1077,418 @@ void    tDattorroReverb_setFeedbackGain   (tDattorroReverb* const rev, float gai
 void    tDattorroReverb_setSampleRate   (tDattorroReverb* const rev, float sr)
 {
     _tDattorroReverb* r = *rev;
-    tMempool* mp = &r->mempool;
     
     r->sampleRate = sr;
     r->t = r->size * r->sampleRate * 0.001f;
     
-    // INPUT
-    tTapeDelay_free(&r->in_delay);
+    mpool_free(r->arena, r->mempool);
+    dattorro_initLines(r);
     
-    for (int i = 0; i < 4; i++)
+    tOnePole_setSampleRate(&r->in_filter, r->sampleRate);
+    tOnePole_setSampleRate(&r->f1_filter, r->sampleRate);
+    tHighpass_setSampleRate(&r->f1_hp, r->sampleRate);
+    tCycle_setSampleRate(&r->f1_lfo, r->sampleRate);
+    tOnePole_setSampleRate(&r->f2_filter, r->sampleRate);
+    tHighpass_setSampleRate(&r->f2_hp, r->sampleRate);
+    tCycle_setSampleRate(&r->f2_lfo, r->sampleRate);
+    
+    // PARAMETERS
+    tDattorroReverb_setSize(rev, r->size*0.5f);
+    tDattorroReverb_setMix(rev, r->mix);
+    tDattorroReverb_setInputDelay(rev,  r->predelay);
+    tDattorroReverb_setInputFilter(rev, r->input_filter);
+    tDattorroReverb_setFeedbackFilter(rev, r->feedback_filter);
+    tDattorroReverb_setFeedbackGain(rev, r->feedback_gain);
+}
+
+// ======================================FDN=========================================
+
+// Line lengths in ms at full size for 16 lines; fewer lines spread out over the same range
+float   fdn_delays[FDN_MAX_LINES] = { 31.3f, 35.9f, 38.7f, 42.1f, 45.3f, 48.7f, 52.9f, 56.3f,
+    60.1f, 63.7f, 67.9f, 71.3f, 75.7f, 79.1f, 83.9f, 88.7f };
+
+// y = a * y + s
+static inline void fdn_axpy(float* y, float a, const float* s, int n)
+{
+    int t = 0;
+#if LEAF_SIMD_SSE
+    const __m128 va = _mm_set1_ps(a);
+    for (; t + 4 <= n; t += 4)
+        _mm_storeu_ps(y + t, _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(y + t), va), _mm_loadu_ps(s + t)));
+#elif LEAF_SIMD_NEON
+    const float32x4_t va = vdupq_n_f32(a);
+    for (; t + 4 <= n; t += 4)
+        vst1q_f32(y + t, vmlaq_f32(vld1q_f32(s + t), vld1q_f32(y + t), va));
+#endif
+    for (; t < n; t++) y[t] = a * y[t] + s[t];
+}
+
+// s += k * y
+static inline void fdn_accumulate(float* s, float k, const float* y, int n)
+{
+    int t = 0;
+#if LEAF_SIMD_SSE
+    const __m128 vk = _mm_set1_ps(k);
+    for (; t + 4 <= n; t += 4)
+        _mm_storeu_ps(s + t, _mm_add_ps(_mm_loadu_ps(s + t), _mm_mul_ps(_mm_loadu_ps(y + t), vk)));
+#elif LEAF_SIMD_NEON
+    const float32x4_t vk = vdupq_n_f32(k);
+    for (; t + 4 <= n; t += 4)
+        vst1q_f32(s + t, vmlaq_f32(vld1q_f32(s + t), vld1q_f32(y + t), vk));
+#endif
+    for (; t < n; t++) s[t] += k * y[t];
+}
+
+// a, b = a + b, a - b
+static inline void fdn_butterfly(float* a, float* b, int n)
+{
+    int t = 0;
+#if LEAF_SIMD_SSE
+    for (; t + 4 <= n; t += 4)
+    {
+        __m128 x = _mm_loadu_ps(a + t);
+        __m128 y = _mm_loadu_ps(b + t);
+        _mm_storeu_ps(a + t, _mm_add_ps(x, y));
+        _mm_storeu_ps(b + t, _mm_sub_ps(x, y));
+    }
+#elif LEAF_SIMD_NEON
+    for (; t + 4 <= n; t += 4)
     {
-        tAllpass_free(&r->in_allpass[i]);
+        float32x4_t x = vld1q_f32(a + t);
+        float32x4_t y = vld1q_f32(b + t);
+        vst1q_f32(a + t, vaddq_f32(x, y));
+        vst1q_f32(b + t, vsubq_f32(x, y));
+    }
+#endif
+    for (; t < n; t++)
+    {
+        float x = a[t];
+        a[t] = x + b[t];
+        b[t] = x - b[t];
+    }
+}
+
+static void fdn_setLengths(_tFDNReverb* const r)
+{
+    int step = FDN_MAX_LINES / r->numLines;
+    for (int i = 0; i < r->numLines; i++)
+    {
+        float ms = fdn_delays[i * step + (step >> 1)];
+        uint32_t length = (uint32_t) (ms * r->size * r->sampleRate * 0.001f) | 1;
+        if (length < FDN_BLOCK) length = FDN_BLOCK | 1;
+        if (length > r->mask[i] + 1) length = r->mask[i] + 1;
+        r->length[i] = length;
+        r->gain[i] = powf(10.0f, (-3.0f * (float)length / (r->t60 * r->sampleRate)));
+    }
+}
+
+// Gives each line a power of two buffer big enough for its full size length, all in one arena
+static void fdn_initLines(_tFDNReverb* const r)
+{
+    int step = FDN_MAX_LINES / r->numLines;
+    size_t total = 0;
+    for (int i = 0; i < r->numLines; i++)
+    {
+        float ms = fdn_delays[i * step + (step >> 1)];
+        uint32_t length = ((uint32_t) (ms * r->sampleRate * 0.001f) | 1) + 1;
+        if (length < FDN_BLOCK + 1) length = FDN_BLOCK + 1;
+        uint32_t size = 16;
+        while (size < length) size <<= 1;
+        r->mask[i] = size - 1;
+        total += size;
     }
     
-    // FEEDBACK 1
-    tAllpass_free(&r->f1_allpass);
+    r->arena = mpool_calloc(sizeof(float) * total + 15, r->mempool);
+    float* p = (float*) (((uintptr_t) r->arena + 15) & ~(uintptr_t) 15);
+    for (int i = 0; i < r->numLines; i++)
+    {
+        r->buff[i] = p;
+        p += r->mask[i] + 1;
+        r->lp[i] = 0.0f;
+    }
+    r->writePos = 0;
+    
+    fdn_setLengths(r);
+}
+
+void    tFDNReverb_init              (tFDNReverb* const rev, int numLines, LEAF* const leaf)
+{
+    tFDNReverb_initToPool(rev, numLines, &leaf->mempool);
+}
+
+void    tFDNReverb_initToPool        (tFDNReverb* const rev, int numLines, tMempool* const mp)
+{
+    LEAF_PROFILE_POOL(mp);
+    _tMempool* m = *mp;
+    _tFDNReverb* r = *rev = (_tFDNReverb*) mpool_alloc(sizeof(_tFDNReverb), m);
+    r->mempool = m;
+    LEAF* leaf = r->mempool->leaf;
+    
+    r->sampleRate = leaf->sampleRate;
+    r->denormalOffset = LEAF_DENORMAL_OFFSET;
     
-    tTapeDelay_free(&r->f1_delay_1);
-    tTapeDelay_free(&r->f1_delay_2);
-    tTapeDelay_free(&r->f1_delay_3);
+    if (numLines <= 4)      r->numLines = 4;
+    else if (numLines <= 8) r->numLines = 8;
+    else                    r->numLines = 16;
     
-    // FEEDBACK 2
-    tAllpass_free(&r->f2_allpass);
+    r->matrix = FDNHadamard;
+    r->size = 1.0f;
+    r->t60 = 2.0f;
+    LEAF_quiescenceInit(&r->quiet, 0.0f, 0);
     
-    tTapeDelay_free(&r->f2_delay_1);
-    tTapeDelay_free(&r->f2_delay_2);
-    tTapeDelay_free(&r->f2_delay_3);
+    fdn_initLines(r);
     
-    // INPUT
-    tTapeDelay_initToPool(&r->in_delay, 0.f, SAMP(200.f), mp);
+    tFDNReverb_setDamping(rev, 6000.0f);
+    tFDNReverb_setMix(rev, 0.5f);
+}
+
+void    tFDNReverb_free              (tFDNReverb* const rev)
+{
+    _tFDNReverb* r = *rev;
     
-    for (int i = 0; i < 4; i++)
+    mpool_free(r->arena, r->mempool);
+    mpool_free((char*)r, r->mempool);
+}
+
+void    tFDNReverb_clear             (tFDNReverb* const rev)
+{
+    _tFDNReverb* r = *rev;
+    
+    for (int i = 0; i < r->numLines; i++)
     {
-        tAllpass_initToPool(&r->in_allpass[i], SAMP(in_allpass_delays[i]), SAMP(20.f), mp); // * r->size_max
-        tAllpass_setGain(&r->in_allpass[i], in_allpass_gains[i]);
+        for (uint32_t j = 0; j <= r->mask[i]; j++) r->buff[i][j] = 0.0f;
+        r->lp[i] = 0.0f;
     }
+}
+
+// Every line is at least FDN_BLOCK long, so a whole block can be read out of the lines before any
+// of it is written back, and the matrix is applied to each line's block at once.
+static void fdn_process(_tFDNReverb* const r, const float* input, int inStride, float* outL, float* outR, int outStride, int size)
+{
+    float x[FDN_BLOCK];
+    float y[FDN_MAX_LINES][FDN_BLOCK];
+    float wetL[FDN_BLOCK], wetR[FDN_BLOCK];
+    float sPos[FDN_BLOCK], sNeg[FDN_BLOCK];
     
-    // FEEDBACK 1
-    tAllpass_initToPool(&r->f1_allpass, SAMP(30.51f), SAMP(100.f), mp); // * r->size_max
-    tAllpass_setGain(&r->f1_allpass, 0.7f);
+    if (LEAF_quiescenceBegin(&r->quiet, input, inStride, size))
+    {
+        reverb_silence(outL, outR, outStride, size);
+        return;
+    }
     
-    tTapeDelay_initToPool(&r->f1_delay_1, SAMP(141.69f), SAMP(200.0f) * r->size_max + 1, mp);
-    tTapeDelay_initToPool(&r->f1_delay_2, SAMP(89.24f), SAMP(100.0f) * r->size_max + 1, mp);
-    tTapeDelay_initToPool(&r->f1_delay_3, SAMP(125.f), SAMP(200.0f) * r->size_max + 1, mp);
+    int N = r->numLines;
+    float a = r->dampCoeff;
+    float mix = r->mix;
+    float outScale = 2.0f / sqrtf((float) N);
+    float inScale = 1.0f / sqrtf((float) N);
+
+#if !LEAF_DENORMAL_CHECK
+    // Keep the lines out of denormals without checking every sample. The matrix spreads it to the rest.
+    r->lp[0] += r->denormalOffset;
+    r->denormalOffset = -r->denormalOffset;
+#endif
     
-    // FEEDBACK 2
-    tAllpass_initToPool(&r->f2_allpass, SAMP(22.58f), SAMP(100.f), mp); // * r->size_max
-    tAllpass_setGain(&r->f2_allpass, 0.7f);
+    for (int offset = 0; offset < size; offset += FDN_BLOCK)
+    {
+        int n = size - offset < FDN_BLOCK ? size - offset : FDN_BLOCK;
+        // A strided input is gathered first, since it is read more than once
+        const float* in = input + offset * inStride;
+        if (inStride != 1)
+        {
+            for (int t = 0; t < n; t++) x[t] = in[t * inStride];
+            in = x;
+        }
+        uint32_t w = r->writePos;
+        
+        // Read and damp each line
+        for (int i = 0; i < N; i++)
+        {
+            const float* b = r->buff[i];
+            uint32_t mask = r->mask[i];
+            uint32_t pos = w - r->length[i];
+            float lp = r->lp[i];
+            float g = r->gain[i];
+            for (int t = 0; t < n; t++)
+            {
+                lp += a * (b[(pos + t) & mask] - lp);
+                y[i][t] = lp * g;
+            }
+            r->lp[i] = lp;
+        }
+        
+        // Output taps, alternating lines and signs between the two sides
+        for (int t = 0; t < n; t++)
+        {
+            wetL[t] = 0.0f;
+            wetR[t] = 0.0f;
+        }
+        for (int i = 0; i < N; i += 2)
+        {
+            float k = (i & 2) ? -outScale : outScale;
+            fdn_accumulate(wetL, k, y[i], n);
+            fdn_accumulate(wetR, k, y[i + 1], n);
+        }
+        
+        // Feedback matrix, then the input is added in with alternating signs
+        float scale;
+        if (r->matrix == FDNHouseholder)
+        {
+            for (int t = 0; t < n; t++) sPos[t] = 0.0f;
+            for (int i = 0; i < N; i++) fdn_accumulate(sPos, -2.0f / N, y[i], n);
+            for (int t = 0; t < n; t++)
+            {
+                sNeg[t] = sPos[t] - in[t] * inScale;
+                sPos[t] += in[t] * inScale;
+            }
+            scale = 1.0f;
+        }
+        else
+        {
+            for (int h = 1; h < N; h <<= 1)
+            {
+                for (int i = 0; i < N; i += h << 1)
+                {
+                    for (int j = i; j < i + h; j++) fdn_butterfly(y[j], y[j + h], n);
+                }
+            }
+            for (int t = 0; t < n; t++)
+            {
+                sPos[t] = in[t] * inScale;
+                sNeg[t] = -sPos[t];
+            }
+            scale = inScale;
+        }
+        
+        for (int i = 0; i < N; i++)
+        {
+            fdn_axpy(y[i], scale, (i & 1) ? sNeg : sPos, n);
+            
+            float* b = r->buff[i];
+            uint32_t mask = r->mask[i];
+            for (int t = 0; t < n; t++) b[(w + t) & mask] = y[i][t];
+        }
+        r->writePos = w + n;
+        
+        if (outR != NULL)
+        {
+            for (int t = 0; t < n; t++)
+            {
+                float dry = in[t] * (1.0f - mix);
+                outL[(offset + t) * outStride] = dry + wetL[t] * mix;
+                outR[(offset + t) * outStride] = dry + wetR[t] * mix;
+            }
+        }
+        else
+        {
+            for (int t = 0; t < n; t++)
+            {
+                outL[(offset + t) * outStride] = in[t] * (1.0f - mix) + (wetL[t] + wetR[t]) * 0.5f * mix;
+            }
+        }
+    }
     
-    tTapeDelay_initToPool(&r->f2_delay_1, SAMP(149.62f), SAMP(200.f) * r->size_max + 1, mp);
-    tTapeDelay_initToPool(&r->f2_delay_2, SAMP(60.48f), SAMP(100.f) * r->size_max + 1, mp);
-    tTapeDelay_initToPool(&r->f2_delay_3, SAMP(106.28f), SAMP(200.f) * r->size_max + 1, mp);
+    LEAF_quiescenceHear(&r->quiet, outL, outStride, size);
+    if (outR != NULL) LEAF_quiescenceHear(&r->quiet, outR, outStride, size);
+    LEAF_quiescenceEnd(&r->quiet, size);
+}
+
+float   tFDNReverb_tick              (tFDNReverb* const rev, float input)
+{
+    LEAF_PROFILE_OBJECT(rev);
+    _tFDNReverb* r = *rev;
     
-    tOnePole_setSampleRate(&r->in_filter, r->sampleRate);
-    tOnePole_setSampleRate(&r->f1_filter, r->sampleRate);
-    tHighpass_setSampleRate(&r->f1_hp, r->sampleRate);
-    tCycle_setSampleRate(&r->f1_lfo, r->sampleRate);
-    tOnePole_setSampleRate(&r->f2_filter, r->sampleRate);
-    tHighpass_setSampleRate(&r->f2_hp, r->sampleRate);
-    tCycle_setSampleRate(&r->f2_lfo, r->sampleRate);
+    float output;
+    fdn_process(r, &input, 1, &output, NULL, 1, 1);
+    return output;
+}
+
+void    tFDNReverb_tickStereo        (tFDNReverb* const rev, float input, float* output)
+{
+    LEAF_PROFILE_OBJECT(rev);
+    _tFDNReverb* r = *rev;
     
-    // PARAMETERS
-    tDattorroReverb_setSize(rev, r->size*0.5f);
-    tDattorroReverb_setMix(rev, r->mix);
-    tDattorroReverb_setInputDelay(rev,  r->predelay);
-    tDattorroReverb_setInputFilter(rev, r->input_filter);
-    tDattorroReverb_setFeedbackFilter(rev, r->feedback_filter);
-    tDattorroReverb_setFeedbackGain(rev, r->feedback_gain);
+    fdn_process(r, &input, 1, &output[0], &output[1], 1, 1);
+}
+
+void    tFDNReverb_tickBlock         (tFDNReverb* const rev, const float* input, float* output, int size)
+{
+    LEAF_PROFILE_OBJECT(rev);
+    _tFDNReverb* r = *rev;
+    
+    fdn_process(r, input, 1, output, NULL, 1, size);
+}
+
+void    tFDNReverb_tickStereoBlock   (tFDNReverb* const rev, const float* input, float** outputs, int size)
+{
+    LEAF_PROFILE_OBJECT(rev);
+    _tFDNReverb* r = *rev;
+    
+    fdn_process(r, input, 1, outputs[0], outputs[1], 1, size);
+}
+
+void    tFDNReverb_tickView          (tFDNReverb* const rev, LEAFBufferView input, LEAFBufferView output)
+{
+    LEAF_PROFILE_OBJECT(rev);
+    _tFDNReverb* r = *rev;
+    
+    float* outR = output.channels > 1 ? output.data + output.channelStride : NULL;
+    fdn_process(r, input.data, input.frameStride, output.data, outR, output.frameStride, input.frames);
+}
+
+void    tFDNReverb_setMatrix         (tFDNReverb* const rev, FDNMatrix matrix)
+{
+    _tFDNReverb* r = *rev;
+    if (matrix >= FDNMatrixNil) matrix = FDNHadamard;
+    r->matrix = matrix;
+}
+
+void    tFDNReverb_setT60            (tFDNReverb* const rev, float t60)
+{
+    _tFDNReverb* r = *rev;
+    r->t60 = LEAF_clip(0.1f, t60, 100.0f);
+    fdn_setLengths(r);
+}
+
+void    tFDNReverb_setSize           (tFDNReverb* const rev, float size)
+{
+    _tFDNReverb* r = *rev;
+    r->size = LEAF_clip(0.1f, size, 1.0f);
+    fdn_setLengths(r);
+}
+
+void    tFDNReverb_setDamping        (tFDNReverb* const rev, float freq)
+{
+    _tFDNReverb* r = *rev;
+    r->damping = LEAF_clip(20.0f, freq, r->sampleRate * 0.5f);
+    r->dampCoeff = 1.0f - expf(-TWO_PI * r->damping / r->sampleRate);
+}
+
+void    tFDNReverb_setQuiescence (tFDNReverb* const rev, float threshold, int holdSamples)
+{
+    _tFDNReverb* r = *rev;
+    LEAF_quiescenceInit(&r->quiet, threshold, holdSamples);
+}
+
+int     tFDNReverb_isQuiescent   (tFDNReverb* const rev)
+{
+    _tFDNReverb* r = *rev;
+    return LEAF_quiescenceIsQuiet(&r->quiet);
+}
+
+void    tFDNReverb_setMix            (tFDNReverb* const rev, float mix)
+{
+    _tFDNReverb* r = *rev;
+    r->mix = LEAF_clip(0.0f, mix, 1.0f);
+}
+
+void    tFDNReverb_setSampleRate     (tFDNReverb* const rev, float sr)
+{
+    _tFDNReverb* r = *rev;
+    
+    r->sampleRate = sr;
+    
+    mpool_free(r->arena, r->mempool);
+    fdn_initLines(r);
+    
+    tFDNReverb_setDamping(rev, r->damping);
 }
@@ -22,21 +22,127 @@
 
 #endif
 
+#if LEAF_USE_SIMD
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define LEAF_SIMD_NEON 1
+#elif defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define LEAF_SIMD_SSE 1
+#endif
+#endif
+
+// Chunk states are handed between the audio thread and the thread servicing a streaming tBuffer
+#if defined(__GNUC__) || defined(__clang__)
+#define STREAM_LOAD(x) __atomic_load_n(&(x), __ATOMIC_ACQUIRE)
+#define STREAM_STORE(x, v) __atomic_store_n(&(x), (v), __ATOMIC_RELEASE)
+#else
+#define STREAM_LOAD(x) (x)
+#define STREAM_STORE(x, v) ((x) = (v))
+#endif
+
 //==============================================================================
 
+static float tBuffer_readStream(_tBuffer* const s, int i);
+
+// G.711 mu-law, on 14-bit magnitudes with the usual bias of 132
+static inline uint8_t tBuffer_encodeMuLaw(float x)
+{
+    int sample = (int) (x * 32768.0f);
+    int sign = 0;
+    if (sample < 0)
+    {
+        sign = 0x80;
+        sample = -sample;
+    }
+    if (sample > 32635) sample = 32635;
+    sample += 132;
+
+    int exponent = 7;
+    for (int mask = 0x4000; (sample & mask) == 0 && exponent > 0; mask >>= 1) exponent--;
+    int mantissa = (sample >> (exponent + 3)) & 0x0F;
+    return (uint8_t) ~(sign | (exponent << 4) | mantissa);
+}
+
+static inline float tBuffer_decodeMuLaw(uint8_t u)
+{
+    u = ~u;
+    int exponent = (u >> 4) & 0x07;
+    int sample = ((((u & 0x0F) << 3) + 132) << exponent) - 132;
+    return (float) ((u & 0x80) ? -sample : sample) * (1.0f / 32768.0f);
+}
+
+static inline float tBuffer_readSample(_tBuffer* const s, int i)
+{
+    if (s->stream != NULL) return tBuffer_readStream(s, i);
+    if (s->format == BufferInt16) return (float) s->buff16[i] * (1.0f / 32768.0f);
+    if (s->format == BufferMuLaw) return tBuffer_decodeMuLaw(s->buff8[i]);
+    return s->buff[i];
+}
+
+// Frees the sample storage unless it was handed to the buffer with tBuffer_setBuffer or tBuffer_setBufferInt16
+static void tBuffer_freeStorage(_tBuffer* const s)
+{
+    if (s->ownsBuffer)
+    {
+        if (s->buff != NULL) mpool_free((char*)s->buff, s->mempool);
+        if (s->buff16 != NULL) mpool_free((char*)s->buff16, s->mempool);
+        if (s->buff8 != NULL) mpool_free((char*)s->buff8, s->mempool);
+    }
+    s->buff = NULL;
+    s->buff16 = NULL;
+    s->buff8 = NULL;
+    s->ownsBuffer = 0;
+}
+
+static inline void tBuffer_writeSample(_tBuffer* const s, int i, float x)
+{
+    if (s->format == BufferInt16)
+    {
+        float y = x * 32768.0f;
+        s->buff16[i] = (int16_t) (y >= 32767.0f ? 32767.0f : y <= -32768.0f ? -32768.0f : y);
+    }
+    else if (s->format == BufferMuLaw) s->buff8[i] = tBuffer_encodeMuLaw(x);
+    else s->buff[i] = x;
+}
+
 void  tBuffer_init (tBuffer* const sb, uint32_t length, LEAF* const leaf)
 {
-    tBuffer_initToPool(sb, length, &leaf->mempool);
+    tBuffer_initToPoolWithFormat(sb, length, BufferFloat, &leaf->mempool);
 }
 
 void  tBuffer_initToPool (tBuffer* const sb, uint32_t length, tMempool* const mp)
 {
+    LEAF_PROFILE_POOL(mp);
+    tBuffer_initToPoolWithFormat(sb, length, BufferFloat, mp);
+}
+
+void  tBuffer_initWithFormat (tBuffer* const sb, uint32_t length, BufferFormat format, LEAF* const leaf)
+{
+    tBuffer_initToPoolWithFormat(sb, length, format, &leaf->mempool);
+}
+
+void  tBuffer_initToPoolWithFormat (tBuffer* const sb, uint32_t length, BufferFormat format, tMempool* const mp)
+{
+    LEAF_PROFILE_POOL(mp);
     _tMempool* m = *mp;
     _tBuffer* s = *sb = (_tBuffer*) mpool_alloc(sizeof(_tBuffer), m);
     s->mempool = m;
     LEAF* leaf = s->mempool->leaf;
     
-    s->buff = (float*) mpool_alloc( sizeof(float) * length, m);
+    s->format = format;
+    s->buff = NULL;
+    s->buff16 = NULL;
+    s->buff8 = NULL;
+    if (format == BufferInt16) s->buff16 = (int16_t*) mpool_alloc( sizeof(int16_t) * length, m);
+    else if (format == BufferMuLaw) s->buff8 = (uint8_t*) mpool_alloc( sizeof(uint8_t) * length, m);
+    else
+    {
+        s->format = BufferFloat;
+        s->buff = (float*) mpool_alloc( sizeof(float) * length, m);
+    }
+    s->ownsBuffer = 1;
+    s->stream = NULL;
     s->sampleRate = leaf->sampleRate;
     s->channels = 1;
     s->bufferLength = length;
@@ -46,23 +152,142 @@ void  tBuffer_initToPool (tBuffer* const sb, uint32_t length, tMempool* const mp
     s->mode = RecordOneShot;
 }
 
+void  tBuffer_initStreaming (tBuffer* const sb, uint32_t length, uint32_t channels, uint32_t sampleRate,
+                             uint32_t residentLength, uint32_t chunkLength, uint32_t numChunks,
+                             tBufferReadCallback read, void* userData, LEAF* const leaf)
+{
+    tBuffer_initToPoolStreaming(sb, length, channels, sampleRate, residentLength, chunkLength, numChunks,
+                                read, userData, &leaf->mempool);
+}
+
+void  tBuffer_initToPoolStreaming (tBuffer* const sb, uint32_t length, uint32_t channels, uint32_t sampleRate,
+                                   uint32_t residentLength, uint32_t chunkLength, uint32_t numChunks,
+                                   tBufferReadCallback read, void* userData, tMempool* const mp)
+{
+    LEAF_PROFILE_POOL(mp);
+    _tMempool* m = *mp;
+    _tBuffer* s = *sb = (_tBuffer*) mpool_alloc(sizeof(_tBuffer), m);
+    s->mempool = m;
+
+    s->format = BufferFloat;
+    s->buff16 = NULL;
+    s->buff8 = NULL;
+    s->ownsBuffer = 1;
+    if (channels < 1) channels = 1;
+    if (residentLength > length) residentLength = length;
+    if (numChunks < 2) numChunks = 2;
+
+    s->channels = channels;
+    s->sampleRate = sampleRate;
+    s->bufferLength = length;
+    s->recordedLength = length;
+    s->active = 0;
+    s->idx = 0;
+    s->mode = RecordOneShot;
+
+    _tBufferStream* st = s->stream = (_tBufferStream*) mpool_alloc(sizeof(_tBufferStream), m);
+    st->read = read;
+    st->userData = userData;
+    st->residentLength = residentLength;
+    st->chunkShift = 0;
+    while ((1u << st->chunkShift) < chunkLength) st->chunkShift++;
+    st->chunkLength = 1u << st->chunkShift;
+    st->chunkSamples = st->chunkLength * channels;
+    st->numChunks = numChunks;
+    st->lastChunk = 0;
+    st->requestOrder = 0;
+    st->underruns = 0;
+
+    st->chunks = (_tBufferChunk*) mpool_alloc(sizeof(_tBufferChunk) * numChunks, m);
+    st->wanted = (int32_t*) mpool_alloc(sizeof(int32_t) * numChunks, m);
+
+    // Read the resident frames and fill every chunk with the frames that follow them,
+    // so playback from the start doesn't depend on the first service call
+    s->buff = (float*) mpool_calloc(sizeof(float) * (residentLength > 0 ? residentLength : 1) * channels, m);
+    if (residentLength > 0) read(userData, s->buff, 0, residentLength);
+
+    int32_t numStreamed = (int32_t) ((length - residentLength + st->chunkLength - 1) >> st->chunkShift);
+    for (uint32_t i = 0; i < numChunks; ++i)
+    {
+        _tBufferChunk* k = &st->chunks[i];
+        k->data = (float*) mpool_calloc(sizeof(float) * st->chunkLength * channels, m);
+        k->chunk = (int32_t) i;
+        k->order = 0;
+        k->state = BufferChunkEmpty;
+        if (k->chunk < numStreamed)
+        {
+            uint32_t start = residentLength + i * st->chunkLength;
+            uint32_t n = length - start < st->chunkLength ? length - start : st->chunkLength;
+            read(userData, k->data, start, n);
+            k->state = BufferChunkReady;
+        }
+    }
+}
+
 void  tBuffer_free (tBuffer* const sb)
 {
     _tBuffer* s = *sb;
     
-    mpool_free((char*)s->buff, s->mempool);
+    if (s->stream != NULL)
+    {
+        _tBufferStream* st = s->stream;
+        for (uint32_t i = 0; i < st->numChunks; ++i)
+        {
+            mpool_free((char*)st->chunks[i].data, s->mempool);
+        }
+        mpool_free((char*)st->wanted, s->mempool);
+        mpool_free((char*)st->chunks, s->mempool);
+        mpool_free((char*)st, s->mempool);
+    }
+    tBuffer_freeStorage(s);
     mpool_free((char*)s, s->mempool);
 }
 
 void tBuffer_tick (tBuffer* const sb, float sample)
 {
+    LEAF_PROFILE_OBJECT(sb);
     _tBuffer* s = *sb;
     
     if (s->active == 1)
     {
-        s->buff[s->idx] = sample;
+        tBuffer_writeSample(s, s->idx, sample);
         
         s->idx += 1;
+
+        if (s->idx >= s->bufferLength)
+        {
+            if (s->mode == RecordOneShot)
+            {
+                tBuffer_stop(sb);
+            }
+            else if (s->mode == RecordLoop)
+            {
+                s->idx = 0;
+            }
+        }
+        s->recordedLength = s->idx;
+    }
+}
+
+void tBuffer_tickBlock (tBuffer* const sb, const float* input, int size)
+{
+    LEAF_PROFILE_OBJECT(sb);
+    _tBuffer* s = *sb;
+
+    int i = 0;
+    while (s->active == 1 && i < size)
+    {
+        int n = 0;
+        if (s->idx < s->bufferLength)
+        {
+            n = size - i;
+            if ((uint32_t) n > s->bufferLength - s->idx) n = (int) (s->bufferLength - s->idx);
+        }
+
+        if (s->format == BufferFloat) memcpy(s->buff + s->idx, input + i, sizeof(float) * n);
+        else for (int j = 0; j < n; ++j) tBuffer_writeSample(s, (int) s->idx + j, input[i + j]);
+        s->idx += n;
+        i += n;
         
         if (s->idx >= s->bufferLength)
         {
@@ -82,10 +307,24 @@ void tBuffer_tick (tBuffer* const sb, float sample)
 void  tBuffer_read(tBuffer* const sb, float* buff, uint32_t len)
 {
     _tBuffer* s = *sb;
+    if (s->stream != NULL) return;
+    for (unsigned i = 0; i < s->bufferLength; i++)
+    {
+        if (i < len)    tBuffer_writeSample(s, i, buff[i]);
+        else            tBuffer_writeSample(s, i, 0.f);
+    }
+    s->recordedLength = len;
+}
+
+void  tBuffer_readInt16(tBuffer* const sb, const int16_t* buff, uint32_t len)
+{
+    _tBuffer* s = *sb;
+    if (s->stream != NULL) return;
     for (unsigned i = 0; i < s->bufferLength; i++)
     {
-        if (i < len)    s->buff[i] = buff[i];
-        else            s->buff[i] = 0.f;
+        if (s->format == BufferInt16) s->buff16[i] = i < len ? buff[i] : 0;
+        else if (i < len) tBuffer_writeSample(s, i, (float) buff[i] * (1.0f / 32768.0f));
+        else tBuffer_writeSample(s, i, 0.f);
     }
     s->recordedLength = len;
 }
@@ -94,12 +333,13 @@ float tBuffer_get (tBuffer* const sb, int idx)
 {
     _tBuffer* s = *sb;
     if ((idx < 0) || (idx >= (int) s->bufferLength)) return 0.f;
-    return s->buff[idx];
+    return tBuffer_readSample(s, idx);
 }
 
 void  tBuffer_record(tBuffer* const sb)
 {
     _tBuffer* s = *sb;
+    if (s->stream != NULL) return;
     s->active = 1;
     s->idx = 0;
 }
@@ -131,9 +371,10 @@ void  tBuffer_setRecordMode (tBuffer* const sb, RecordMode mode)
 void  tBuffer_clear (tBuffer* const sb)
 {
     _tBuffer* s = *sb;
+    if (s->stream != NULL) return;
     for (unsigned i = 0; i < s->bufferLength; i++)
     {
-        s->buff[i] = 0.f;
+        tBuffer_writeSample(s, i, 0.f);
     }
 
 }
@@ -142,6 +383,8 @@ void tBuffer_setBuffer(tBuffer* const sb, float* externalBuffer, int length, int
 {
     _tBuffer* s = *sb;
 
+    tBuffer_freeStorage(s);
+    s->format = BufferFloat;
     s->buff = externalBuffer;
     s->channels = channels;
     s->sampleRate = sampleRate;
@@ -149,6 +392,25 @@ void tBuffer_setBuffer(tBuffer* const sb, float* externalBuffer, int length, int
     s->bufferLength = s->recordedLength;
 }
 
+void tBuffer_setBufferInt16(tBuffer* const sb, int16_t* externalBuffer, int length, int channels, int sampleRate)
+{
+    _tBuffer* s = *sb;
+
+    tBuffer_freeStorage(s);
+    s->format = BufferInt16;
+    s->buff16 = externalBuffer;
+    s->channels = channels;
+    s->sampleRate = sampleRate;
+    s->recordedLength = length/channels;
+    s->bufferLength = s->recordedLength;
+}
+
+BufferFormat tBuffer_getFormat(tBuffer* const sb)
+{
+    _tBuffer* s = *sb;
+    return s->format;
+}
+
 uint32_t tBuffer_getBufferLength(tBuffer* const sb)
 {
     _tBuffer* s = *sb;
@@ -173,12 +435,351 @@ int tBuffer_isActive(tBuffer* const sb)
     return s->active;
 }
 
+static float tBuffer_readStream(_tBuffer* const s, int i)
+{
+    _tBufferStream* st = s->stream;
+
+    uint32_t resident = st->residentLength * s->channels;
+    if ((uint32_t) i < resident) return s->buff[i];
+
+    uint32_t offset = (uint32_t) i - resident;
+    // Channel counts needn't be a power of two, so the chunk can't be found with a shift
+    uint32_t chunk = offset / st->chunkSamples;
+    offset -= chunk * st->chunkSamples;
+    _tBufferChunk* k = &st->chunks[st->lastChunk];
+
+    // Reads are local, so the chunk read last is almost always the right one
+    if (k->chunk != (int32_t) chunk || STREAM_LOAD(k->state) != BufferChunkReady)
+    {
+        int found = -1;
+        for (uint32_t j = 0; j < st->numChunks; ++j)
+        {
+            if (st->chunks[j].chunk == (int32_t) chunk && STREAM_LOAD(st->chunks[j].state) == BufferChunkReady)
+            {
+                found = (int) j;
+                break;
+            }
+        }
+        if (found < 0)
+        {
+            st->underruns++;
+            return 0.f;
+        }
+        st->lastChunk = found;
+        k = &st->chunks[found];
+    }
+
+    return k->data[offset];
+}
+
+// Called from the audio thread with the chunks it will need next, nearest first
+static void tBuffer_requestChunks(_tBuffer* const s, const int32_t* wanted, int numWanted)
+{
+    _tBufferStream* st = s->stream;
+
+    for (int w = 0; w < numWanted; ++w)
+    {
+        int victim = -1;
+        int present = 0;
+        for (uint32_t j = 0; j < st->numChunks && !present; ++j)
+        {
+            _tBufferChunk* k = &st->chunks[j];
+            int32_t state = STREAM_LOAD(k->state);
+            if (state != BufferChunkEmpty && k->chunk == wanted[w])
+            {
+                present = 1;
+            }
+            else if (state != BufferChunkRequested &&
+                     (victim < 0 || (int32_t) (k->order - st->chunks[victim].order) < 0))
+            {
+                // Recycle the least recently requested chunk that isn't wanted at all
+                int keep = 0;
+                if (state == BufferChunkReady)
+                {
+                    for (int o = 0; o < numWanted; ++o)
+                    {
+                        if (k->chunk == wanted[o])
+                        {
+                            keep = 1;
+                            break;
+                        }
+                    }
+                }
+                if (!keep) victim = (int) j;
+            }
+        }
+        if (present || victim < 0) continue;
+
+        _tBufferChunk* k = &st->chunks[victim];
+        k->chunk = wanted[w];
+        k->order = ++st->requestOrder;
+        STREAM_STORE(k->state, BufferChunkRequested);
+    }
+}
+
+int tBuffer_serviceStream(tBuffer* const sb)
+{
+    _tBuffer* s = *sb;
+    _tBufferStream* st = s->stream;
+    if (st == NULL) return 0;
+
+    int serviced = 0;
+    for (;;)
+    {
+        // Oldest request first, since that's the one the sampler will reach first
+        _tBufferChunk* next = NULL;
+        for (uint32_t j = 0; j < st->numChunks; ++j)
+        {
+            _tBufferChunk* k = &st->chunks[j];
+            if (STREAM_LOAD(k->state) != BufferChunkRequested) continue;
+            if (next == NULL || (int32_t) (k->order - next->order) < 0) next = k;
+        }
+        if (next == NULL) break;
+
+        uint32_t start = st->residentLength + ((uint32_t) next->chunk << st->chunkShift);
+        uint32_t n = s->bufferLength - start < st->chunkLength ? s->bufferLength - start : st->chunkLength;
+        uint32_t got = st->read(st->userData, next->data, start, n);
+        if (got > n) got = n;
+        for (uint32_t i = got * s->channels; i < st->chunkLength * s->channels; ++i)
+        {
+            next->data[i] = 0.f;
+        }
+        STREAM_STORE(next->state, BufferChunkReady);
+        serviced++;
+    }
+    return serviced;
+}
+
+uint32_t tBuffer_getUnderruns(tBuffer* const sb)
+{
+    _tBuffer* s = *sb;
+    if (s->stream == NULL) return 0;
+    return s->stream->underruns;
+}
+
 //================================tSampler=====================================
 
 static void handleStartEndChange(tSampler* const sp);
 
 static void attemptStartEndChange(tSampler* const sp);
 
+// Adds the chunks holding frames lo to hi to a sampler's wanted list
+static int tSampler_wantFrames(_tBufferStream* const st, int numWanted, int lo, int hi)
+{
+    int resident = (int) st->residentLength;
+    if (lo < resident) lo = resident;
+    for (int f = lo; f <= hi && numWanted < (int) st->numChunks; f += (int) st->chunkLength)
+    {
+        int32_t c = (f - resident) >> st->chunkShift;
+        int w = 0;
+        while (w < numWanted && st->wanted[w] != c) w++;
+        if (w == numWanted) st->wanted[numWanted++] = c;
+    }
+    if (hi >= lo && numWanted < (int) st->numChunks)
+    {
+        int32_t c = (hi - resident) >> st->chunkShift;
+        int w = 0;
+        while (w < numWanted && st->wanted[w] != c) w++;
+        if (w == numWanted) st->wanted[numWanted++] = c;
+    }
+    return numWanted;
+}
+
+// Requests the chunks of a streaming buffer in the order playback will reach them
+static void tSampler_updateStream(_tSampler* const p, int dir, int myStart, int myEnd)
+{
+    _tBuffer* s = p->samp;
+    _tBufferStream* st = s->stream;
+    int resident = (int) st->residentLength;
+    int length = (int) s->recordedLength;
+
+    int frame = (int) p->idx;
+    int32_t cfxlen = p->cfxlen;
+    if (p->len * 0.25f < cfxlen) cfxlen = p->len * 0.25f;
+
+    // Loop crossfades read from the other end of the loop
+    int32_t fadeLeftStart = myStart >= cfxlen ? myStart - cfxlen : 0;
+    int32_t fadeLeftEnd = fadeLeftStart + cfxlen;
+    int32_t fadeRightStart = myEnd - cfxlen;
+    int zone = 0;
+    if (p->mode == PlayLoop)
+    {
+        if (fadeLeftStart - 2 <= frame && frame <= fadeLeftEnd + 2) zone = 1;
+        else if (fadeRightStart - 2 <= frame && frame <= myEnd + 2) zone = 2;
+    }
+
+    int32_t chunk = frame < resident ? -1 : (frame - resident) >> st->chunkShift;
+    int32_t state = dir * 3 + zone;
+    if (chunk == p->streamChunk && state == p->streamState &&
+        myStart == p->streamStart && myEnd == p->streamEnd) return;
+    p->streamChunk = chunk;
+    p->streamState = state;
+    p->streamStart = myStart;
+    p->streamEnd = myEnd;
+
+    int numWanted = 0;
+
+    // Start far enough behind the play head to cover the interpolation points and any flip crossfade
+    int f = frame - dir * (cfxlen + 2);
+    if (f < 0) f = 0;
+    if (f > length - 1) f = length - 1;
+    numWanted = tSampler_wantFrames(st, numWanted, dir > 0 ? f : frame - 2, dir > 0 ? frame + 3 : f);
+
+    // Interpolation wraps around the ends of the buffer
+    if (frame < 2) numWanted = tSampler_wantFrames(st, numWanted, length - 3, length - 1);
+
+    if (zone == 1) numWanted = tSampler_wantFrames(st, numWanted, fadeRightStart - 2, myEnd + 2);
+    else if (zone == 2) numWanted = tSampler_wantFrames(st, numWanted, fadeLeftStart - 2, fadeLeftEnd + 2);
+
+    // Then walk ahead a chunk at a time, following loops and direction changes
+    f = frame;
+    for (int steps = 0; numWanted < (int) st->numChunks && steps < 2 * (int) st->numChunks; ++steps)
+    {
+        int next;
+        if (f < resident)
+        {
+            if (dir < 0) break;
+            next = resident;
+        }
+        else
+        {
+            numWanted = tSampler_wantFrames(st, numWanted, f, f);
+            int base = resident + (((f - resident) >> st->chunkShift) << st->chunkShift);
+            next = dir > 0 ? base + (int) st->chunkLength : base - 1;
+        }
+
+        if (p->mode == PlayLoop)
+        {
+            if (dir > 0 && next > myEnd + 2) next = fadeLeftStart - 2;
+            else if (dir < 0 && next < myStart - 2) next = myEnd + 2;
+        }
+        else if (p->mode == PlayBackAndForth)
+        {
+            if (dir > 0 && next > myEnd) { dir = -dir; next = myEnd; }
+            else if (dir < 0 && next < myStart) { dir = -dir; next = myStart; }
+        }
+        else if ((dir > 0 && next > myEnd + 2) || (dir < 0 && next < myStart - 2)) break;
+
+        if (next < 0) next = 0;
+        if (next > length - 1) next = length - 1;
+        f = next;
+    }
+
+    tBuffer_requestChunks(s, st->wanted, numWanted);
+}
+
+// h = c0 + f * (c1 - c0), blending two rows of a polyphase table
+static inline void sampler_blendRows(float* h, const float* c0, const float* c1, float f, int n)
+{
+    int i = 0;
+#if LEAF_SIMD_SSE
+    const __m128 fv = _mm_set1_ps(f);
+    for (; i + 4 <= n; i += 4)
+    {
+        __m128 a = _mm_loadu_ps(c0 + i);
+        _mm_storeu_ps(h + i, _mm_add_ps(a, _mm_mul_ps(fv, _mm_sub_ps(_mm_loadu_ps(c1 + i), a))));
+    }
+#elif LEAF_SIMD_NEON
+    const float32x4_t fv = vdupq_n_f32(f);
+    for (; i + 4 <= n; i += 4)
+    {
+        float32x4_t a = vld1q_f32(c0 + i);
+        vst1q_f32(h + i, vaddq_f32(a, vmulq_f32(fv, vsubq_f32(vld1q_f32(c1 + i), a))));
+    }
+#endif
+    for (; i < n; ++i) h[i] = c0[i] + f * (c1[i] - c0[i]);
+}
+
+static inline float sampler_dot(const float* x, const float* h, int n)
+{
+    int i = 0;
+    float sum = 0.0f;
+#if LEAF_SIMD_SSE
+    __m128 acc = _mm_setzero_ps();
+    for (; i + 4 <= n; i += 4) acc = _mm_add_ps(acc, _mm_mul_ps(_mm_loadu_ps(x + i), _mm_loadu_ps(h + i)));
+    float lanes[4];
+    _mm_storeu_ps(lanes, acc);
+    sum = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+#elif LEAF_SIMD_NEON
+    float32x4_t acc = vdupq_n_f32(0.0f);
+    for (; i + 4 <= n; i += 4) acc = vmlaq_f32(acc, vld1q_f32(x + i), vld1q_f32(h + i));
+    float32x2_t pair = vadd_f32(vget_low_f32(acc), vget_high_f32(acc));
+    sum = vget_lane_f32(vpadd_f32(pair, pair), 0);
+#endif
+    for (; i < n; ++i) sum += x[i] * h[i];
+    return sum;
+}
+
+// Windowed sinc interpolation through the points idx + k * dir, alpha of the way from idx to idx + dir.
+// At or below the sample's own rate the coefficients are a blend of two rows of the polyphase table.
+// Above it the kernel is widened by the rate so it also band limits, reading the table as a finely
+// sampled kernel one coefficient at a time.
+static void tSampler_interpolateSinc(_tSampler* const p, int idx, int dir, float alpha, int length,
+                                     int stride, int numOutputs, float* out)
+{
+    float h[SAMPLER_SINC_MAX_TAPS * SAMPLER_SINC_MAX_STRETCH];
+    float x[SAMPLER_SINC_MAX_TAPS * SAMPLER_SINC_MAX_STRETCH];
+
+    _tBuffer* s = p->samp;
+    int taps = p->sincTaps;
+    int half = taps / 2;
+    int reach = half;
+    float stretch = p->inc < (float) SAMPLER_SINC_MAX_STRETCH ? p->inc : (float) SAMPLER_SINC_MAX_STRETCH;
+
+    if (length < 1)
+    {
+        for (int c = 0; c < numOutputs; ++c) out[c] = 0.0f;
+        return;
+    }
+
+    if (stretch <= 1.0f)
+    {
+        float phase = alpha * SAMPLER_SINC_PHASES;
+        int row = (int) phase;
+        if (row >= SAMPLER_SINC_PHASES) row = SAMPLER_SINC_PHASES - 1;
+        sampler_blendRows(h, p->sincTable + row * taps, p->sincTable + (row + 1) * taps, phase - row, taps);
+    }
+    else
+    {
+        reach = (int) ceilf(half * stretch);
+        float scale = 1.0f / stretch;
+        for (int t = 0; t < 2 * reach; ++t)
+        {
+            // Where this point falls on the unstretched kernel, as a column and a fractional row of the table
+            float u = ((float) (t - reach + 1) - alpha) * scale + (float) (half - 1);
+            int col = (int) ceilf(u);
+            if (col < 0 || col >= taps)
+            {
+                h[t] = 0.0f;
+                continue;
+            }
+            float phase = ((float) col - u) * SAMPLER_SINC_PHASES;
+            int row = (int) phase;
+            if (row >= SAMPLER_SINC_PHASES) row = SAMPLER_SINC_PHASES - 1;
+            const float* c = p->sincTable + row * taps + col;
+            h[t] = (c[0] + (phase - row) * (c[taps] - c[0])) * scale;
+        }
+    }
+
+    int n = 2 * reach;
+    int first = idx - (reach - 1) * dir;
+    while (first < 0) first += length;
+    while (first >= length) first -= length;
+
+    for (int c = 0; c < numOutputs; ++c)
+    {
+        int j = first;
+        for (int t = 0; t < n; ++t)
+        {
+            x[t] = tBuffer_readSample(s, j * stride + c);
+            j += dir;
+            if (j >= length) j -= length;
+            else if (j < 0) j += length;
+        }
+        out[c] = sampler_dot(x, h, n);
+    }
+}
+
 void tSampler_init(tSampler* const sp, tBuffer* const b, LEAF* const leaf)
 {
     tSampler_initToPool(sp, b, &leaf->mempool, leaf);
@@ -186,6 +787,7 @@ void tSampler_init(tSampler* const sp, tBuffer* const b, LEAF* const leaf)
 
 void tSampler_initToPool(tSampler* const sp, tBuffer* const b, tMempool* const mp, LEAF* const leaf)
 {
+    LEAF_PROFILE_POOL(mp);
     _tMempool* m = *mp;
     _tSampler* p = *sp = (_tSampler*) mpool_alloc(sizeof(_tSampler), m);
     p->mempool = m;
@@ -239,12 +841,20 @@ void tSampler_initToPool(tSampler* const sp, tBuffer* const b, tMempool* const m
     p->inCrossfade = 0;
     p->flipStart = -1;
     p->flipIdx = -1;
+
+    p->streamChunk = INT32_MIN;
+    p->streamState = 0;
+
+    p->interpolation = SamplerHermite;
+    p->sincTaps = 0;
+    p->sincTable = NULL;
 }
 
 void tSampler_free (tSampler* const sp)
 {
     _tSampler* p = *sp;
     tRamp_free(&p->gain);
+    if (p->sincTable != NULL) mpool_free((char*)p->sincTable, p->mempool);
     
     mpool_free((char*)p, p->mempool);
 }
@@ -265,10 +875,12 @@ void tSampler_setSample (tSampler* const sp, tBuffer* const b)
     p->len = p->end - p->start;
     
     p->idx = 0.f;
+    p->streamChunk = INT32_MIN;
 }
 
 float tSampler_tick        (tSampler* const sp)
 {
+    LEAF_PROFILE_OBJECT(sp);
     _tSampler* p = *sp;
     
     attemptStartEndChange(sp);
@@ -287,7 +899,7 @@ float tSampler_tick        (tSampler* const sp)
     float flipsample = 0.0f;
     float flipMix = 0.0f;
     
-    float* buff = p->samp->buff;
+    _tBuffer* s = p->samp;
     
     // Variables so start is also before end
     int myStart = p->start;
@@ -302,6 +914,8 @@ float tSampler_tick        (tSampler* const sp)
     int dir = p->bnf * p->dir * p->flip;
     int rev = 0;
     if (dir < 0) rev = 1;
+
+    if (s->stream != NULL) tSampler_updateStream(p, dir, myStart, myEnd);
     
     // Get the current integer index and alpha for interpolation
     int idx = (int) p->idx;
@@ -322,14 +936,16 @@ float tSampler_tick        (tSampler* const sp)
     i3 = (i3 < length*(1-rev)) ? i3 + (length * rev) : i3 - (length * (1-rev));
     i4 = (i4 < length*(1-rev)) ? i4 + (length * rev) : i4 - (length * (1-rev));
     
-    sample = LEAF_interpolate_hermite_x (buff[i1],
-                                         buff[i2],
-                                         buff[i3],
-                                         buff[i4],
+    if (p->interpolation == SamplerSinc) tSampler_interpolateSinc(p, idx, dir, alpha, length, 1, 1, &sample);
+    else sample = LEAF_interpolate_hermite_x (tBuffer_readSample(s, i1),
+                                         tBuffer_readSample(s, i2),
+                                         tBuffer_readSample(s, i3),
+                                         tBuffer_readSample(s, i4),
                                          alpha);
     
     int32_t cfxlen = p->cfxlen;
     if (p->len * 0.25f < cfxlen) cfxlen = p->len * 0.25f;
+
     
     // Determine crossfade points
     int32_t fadeLeftStart = 0;
@@ -372,10 +988,11 @@ float tSampler_tick        (tSampler* const sp)
             c3 = (c3 < length * (1-rev)) ? c3 + (length * rev) : c3 - (length * (1-rev));
             c4 = (c4 < length * (1-rev)) ? c4 + (length * rev) : c4 - (length * (1-rev));
             
-            cfxsample = LEAF_interpolate_hermite_x (buff[c1],
-                                                    buff[c2],
-                                                    buff[c3],
-                                                    buff[c4],
+            if (p->interpolation == SamplerSinc) tSampler_interpolateSinc(p, cdx, dir, alpha, length, 1, 1, &cfxsample);
+            else cfxsample = LEAF_interpolate_hermite_x (tBuffer_readSample(s, c1),
+                                                    tBuffer_readSample(s, c2),
+                                                    tBuffer_readSample(s, c3),
+                                                    tBuffer_readSample(s, c4),
                                                     alpha);
             if (cfxlen > 0.0f) crossfadeMix = (float) offset / (float) cfxlen;
             else crossfadeMix = 0.0f;
@@ -412,10 +1029,11 @@ float tSampler_tick        (tSampler* const sp)
             f3 = (f3 < length*rev) ? f3 + (length * (1-rev)) : f3 - (length * rev);
             f4 = (f4 < length*rev) ? f4 + (length * (1-rev)) : f4 - (length * rev);
             
-            flipsample = LEAF_interpolate_hermite_x (buff[f1],
-                                                     buff[f2],
-                                                     buff[f3],
-                                                     buff[f4],
+            if (p->interpolation == SamplerSinc) tSampler_interpolateSinc(p, fdx, -dir, falpha, length, 1, 1, &flipsample);
+            else flipsample = LEAF_interpolate_hermite_x (tBuffer_readSample(s, f1),
+                                                     tBuffer_readSample(s, f2),
+                                                     tBuffer_readSample(s, f3),
+                                                     tBuffer_readSample(s, f4),
                                                      falpha);
             flipMix = (float) (cfxlen - flipLength) / (float) cfxlen;
         }
@@ -528,6 +1146,7 @@ float tSampler_tick        (tSampler* const sp)
 
 float tSampler_tickStereo        (tSampler* const sp, float* outputArray)
 {
+    LEAF_PROFILE_OBJECT(sp);
     _tSampler* p = *sp;
 
     attemptStartEndChange(sp);
@@ -545,7 +1164,7 @@ float tSampler_tickStereo        (tSampler* const sp, float* outputArray)
     float flipsample[2] = {0.0f, 0.0f};
     float flipMix = 0.0f;
 
-    float* buff = p->samp->buff;
+    _tBuffer* s = p->samp;
 
     // Variables so start is also before end
     int myStart = p->start;
@@ -561,6 +1180,8 @@ float tSampler_tickStereo        (tSampler* const sp, float* outputArray)
     int rev = 0;
     if (dir < 0) rev = 1;
 
+    if (s->stream != NULL) tSampler_updateStream(p, dir, myStart, myEnd);
+
     // Get the current integer index and alpha for interpolation
     int idx = (int) p->idx;
     float alpha = rev + (p->idx - idx) * dir;
@@ -580,21 +1201,26 @@ float tSampler_tickStereo        (tSampler* const sp, float* outputArray)
     i3 = (i3 < length*(1-rev)) ? i3 + (length * rev) : i3 - (length * (1-rev));
     i4 = (i4 < length*(1-rev)) ? i4 + (length * rev) : i4 - (length * (1-rev));
 
-    outputArray[0] = LEAF_interpolate_hermite_x (buff[i1 * p->channels],
-                                         buff[i2 * p->channels],
-                                         buff[i3 * p->channels],
-                                         buff[i4 * p->channels],
-                                         alpha);
-
-    outputArray[1] = LEAF_interpolate_hermite_x (buff[(i1 * p->channels) + 1],
-                                         buff[(i2 * p->channels) + 1],
-                                         buff[(i3 * p->channels) + 1],
-                                         buff[(i4 * p->channels) + 1],
-                                         alpha);
+    if (p->interpolation == SamplerSinc) tSampler_interpolateSinc(p, idx, dir, alpha, length, p->channels, 2, outputArray);
+    else
+    {
+        outputArray[0] = LEAF_interpolate_hermite_x (tBuffer_readSample(s, i1 * p->channels),
+                                             tBuffer_readSample(s, i2 * p->channels),
+                                             tBuffer_readSample(s, i3 * p->channels),
+                                             tBuffer_readSample(s, i4 * p->channels),
+                                             alpha);
+
+        outputArray[1] = LEAF_interpolate_hermite_x (tBuffer_readSample(s, (i1 * p->channels) + 1),
+                                             tBuffer_readSample(s, (i2 * p->channels) + 1),
+                                             tBuffer_readSample(s, (i3 * p->channels) + 1),
+                                             tBuffer_readSample(s, (i4 * p->channels) + 1),
+                                             alpha);
+    }
 
     int32_t cfxlen = p->cfxlen;
     if (p->len * 0.25f < cfxlen) cfxlen = p->len * 0.25f;
 
+
     // Determine crossfade points
     int32_t fadeLeftStart = 0;
     if (myStart >= cfxlen) fadeLeftStart = myStart - cfxlen;
@@ -636,17 +1262,21 @@ float tSampler_tickStereo        (tSampler* const sp, float* outputArray)
             c3 = (c3 < length * (1-rev)) ? c3 + (length * rev) : c3 - (length * (1-rev));
             c4 = (c4 < length * (1-rev)) ? c4 + (length * rev) : c4 - (length * (1-rev));
 
-            cfxsample[0] = LEAF_interpolate_hermite_x (buff[c1 * p->channels],
-                                                    buff[c2 * p->channels],
-                                                    buff[c3 * p->channels],
-                                                    buff[c4 * p->channels],
-                                                    alpha);
-
-            cfxsample[1] = LEAF_interpolate_hermite_x (buff[(c1 * p->channels) + 1],
-                                                                buff[(c2 * p->channels) + 1],
-                                                                buff[(c3 * p->channels) + 1],
-                                                                buff[(c4 * p->channels) + 1],
-                                                                alpha);
+            if (p->interpolation == SamplerSinc) tSampler_interpolateSinc(p, cdx, dir, alpha, length, p->channels, 2, cfxsample);
+            else
+            {
+                cfxsample[0] = LEAF_interpolate_hermite_x (tBuffer_readSample(s, c1 * p->channels),
+                                                        tBuffer_readSample(s, c2 * p->channels),
+                                                        tBuffer_readSample(s, c3 * p->channels),
+                                                        tBuffer_readSample(s, c4 * p->channels),
+                                                        alpha);
+
+                cfxsample[1] = LEAF_interpolate_hermite_x (tBuffer_readSample(s, (c1 * p->channels) + 1),
+                                                                    tBuffer_readSample(s, (c2 * p->channels) + 1),
+                                                                    tBuffer_readSample(s, (c3 * p->channels) + 1),
+                                                                    tBuffer_readSample(s, (c4 * p->channels) + 1),
+                                                                    alpha);
+            }
 
             crossfadeMix = (float) offset / (float) cfxlen;
         }
@@ -682,17 +1312,21 @@ float tSampler_tickStereo        (tSampler* const sp, float* outputArray)
             f3 = (f3 < length*rev) ? f3 + (length * (1-rev)) : f3 - (length * rev);
             f4 = (f4 < length*rev) ? f4 + (length * (1-rev)) : f4 - (length * rev);
 
-            flipsample[0] = LEAF_interpolate_hermite_x (buff[f1 * p->channels],
-                                                     buff[f2 * p->channels],
-                                                     buff[f3 * p->channels],
-                                                     buff[f4 * p->channels],
-                                                     falpha);
-
-            flipsample[1] = LEAF_interpolate_hermite_x (buff[(f1 * p->channels) + 1],
-                                                     buff[(f2 * p->channels) + 1],
-                                                     buff[(f3 * p->channels) + 1],
-                                                     buff[(f4 * p->channels) + 1],
-                                                     falpha);
+            if (p->interpolation == SamplerSinc) tSampler_interpolateSinc(p, fdx, -dir, falpha, length, p->channels, 2, flipsample);
+            else
+            {
+                flipsample[0] = LEAF_interpolate_hermite_x (tBuffer_readSample(s, f1 * p->channels),
+                                                         tBuffer_readSample(s, f2 * p->channels),
+                                                         tBuffer_readSample(s, f3 * p->channels),
+                                                         tBuffer_readSample(s, f4 * p->channels),
+                                                         falpha);
+
+                flipsample[1] = LEAF_interpolate_hermite_x (tBuffer_readSample(s, (f1 * p->channels) + 1),
+                                                         tBuffer_readSample(s, (f2 * p->channels) + 1),
+                                                         tBuffer_readSample(s, (f3 * p->channels) + 1),
+                                                         tBuffer_readSample(s, (f4 * p->channels) + 1),
+                                                         falpha);
+            }
 
             if (cfxlen > 0) flipMix = (float) (cfxlen - flipLength) / (float) cfxlen;
             else flipMix = 1.0f;
@@ -1082,6 +1716,46 @@ void tSampler_setSampleRate(tSampler* const sp, float sr)
     tRamp_setSampleRate(&p->gain, p->sampleRate);
 }
 
+void tSampler_setInterpolation (tSampler* const sp, SamplerInterpolation interpolation, int taps)
+{
+    _tSampler* p = *sp;
+
+    p->interpolation = SamplerHermite;
+    if (p->sincTable != NULL) mpool_free((char*)p->sincTable, p->mempool);
+    p->sincTable = NULL;
+
+    if (interpolation != SamplerSinc) return;
+
+    taps = (taps + 3) & ~3;
+    if (taps < 4) taps = 4;
+    if (taps > SAMPLER_SINC_MAX_TAPS) taps = SAMPLER_SINC_MAX_TAPS;
+    p->sincTaps = taps;
+    p->sincTable = (float*) mpool_alloc(sizeof(float) * taps * (SAMPLER_SINC_PHASES + 1), p->mempool);
+
+    // Row r holds the kernel at (t - taps/2 + 1) - r/SAMPLER_SINC_PHASES, normalized so each row sums to 1.
+    // The cutoff sits a little below Nyquist so short kernels don't alias in their transition band.
+    int half = taps / 2;
+    float cutoff = 0.9f;
+    for (int r = 0; r <= SAMPLER_SINC_PHASES; ++r)
+    {
+        float* row = p->sincTable + r * taps;
+        float sum = 0.0f;
+        for (int t = 0; t < taps; ++t)
+        {
+            float x = (float) (t - half + 1) - (float) r / (float) SAMPLER_SINC_PHASES;
+            float w = x / (float) half;
+            float window = 0.0f;
+            if (fabsf(w) < 1.0f) window = 0.42f + 0.5f * cosf(PI * w) + 0.08f * cosf(TWO_PI * w);
+            float y = cutoff * PI * x;
+            float sinc = (y == 0.0f) ? 1.0f : sinf(y) / y;
+            row[t] = cutoff * sinc * window;
+            sum += row[t];
+        }
+        for (int t = 0; t < taps; ++t) row[t] /= sum;
+    }
+    p->interpolation = SamplerSinc;
+}
+
 //==============================================================================
 
 void    tAutoSampler_init   (tAutoSampler* const as, tBuffer* const b, LEAF* const leaf)
@@ -1091,6 +1765,7 @@ void    tAutoSampler_init   (tAutoSampler* const as, tBuffer* const b, LEAF* con
 
 void    tAutoSampler_initToPool (tAutoSampler* const as, tBuffer* const b, tMempool* const mp, LEAF* const leaf)
 {
+    LEAF_PROFILE_POOL(mp);
     _tMempool* m = *mp;
     _tAutoSampler* a = *as = (_tAutoSampler*) mpool_alloc(sizeof(_tAutoSampler), m);
     a->mempool = m;
@@ -1099,20 +1774,156 @@ void    tAutoSampler_initToPool (tAutoSampler* const as, tBuffer* const b, tMemp
     tSampler_initToPool(&a->sampler, b, mp, leaf);
     tSampler_setMode(&a->sampler, PlayLoop);
     tEnvelopeFollower_initToPool(&a->ef, 0.05f, 0.9999f, mp);
+
+    a->windowSize = 0;
+    a->threshold = 0.0f;
+    a->previousPower = 0.0f;
+    a->sampleCounter = 0;
+    a->powerCounter = 0;
+    a->sampleTriggered = 0;
+
+    a->preRollBuffer = NULL;
+    a->preRollLength = 0;
+    a->preRollIdx = 0;
+    a->blockDecay = 1.0f;
+    a->blockDecaySize = 0;
 }
 
 void    tAutoSampler_free (tAutoSampler* const as)
 {
     _tAutoSampler* a = *as;
     
+    if (a->preRollBuffer != NULL) mpool_free((char*)a->preRollBuffer, a->mempool);
     tEnvelopeFollower_free(&a->ef);
     tSampler_free(&a->sampler);
     
     mpool_free((char*)a, a->mempool);
 }
 
+// Starts a recording, beginning it with the pre-roll if there is one
+static void tAutoSampler_trigger(_tAutoSampler* const a)
+{
+    tBuffer* b = &a->sampler->samp;
+
+    a->sampleTriggered = 1;
+    tBuffer_record(b);
+    if (a->preRollLength > 0)
+    {
+        tBuffer_tickBlock(b, a->preRollBuffer + a->preRollIdx, a->preRollLength - a->preRollIdx);
+        tBuffer_tickBlock(b, a->preRollBuffer, a->preRollIdx);
+    }
+    a->sampler->samp->recordedLength = a->sampler->samp->bufferLength;
+    a->sampleCounter = a->windowSize + 24;//arbitrary extra time to avoid resampling while playing previous sample - better solution would be alternating buffers and crossfading
+    a->powerCounter = 1000;
+}
+
+static void tAutoSampler_feedPreRoll(_tAutoSampler* const a, const float* input, int size)
+{
+    uint32_t length = a->preRollLength;
+    if (length == 0) return;
+
+    if ((uint32_t) size > length)
+    {
+        input += size - length;
+        size = length;
+    }
+    uint32_t n = length - a->preRollIdx;
+    if (n > (uint32_t) size) n = size;
+    memcpy(a->preRollBuffer + a->preRollIdx, input, sizeof(float) * n);
+    memcpy(a->preRollBuffer, input + n, sizeof(float) * (size - n));
+    a->preRollIdx += size;
+    if (a->preRollIdx >= length) a->preRollIdx -= length;
+}
+
+// Largest absolute value in a block
+static inline float autosampler_peak(const float* x, int size)
+{
+    int i = 0;
+    float peak = 0.0f;
+#if LEAF_SIMD_SSE
+    const __m128 mask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+    __m128 acc = _mm_setzero_ps();
+    for (; i + 4 <= size; i += 4) acc = _mm_max_ps(acc, _mm_and_ps(_mm_loadu_ps(x + i), mask));
+    float lanes[4];
+    _mm_storeu_ps(lanes, acc);
+    peak = fmaxf(fmaxf(lanes[0], lanes[1]), fmaxf(lanes[2], lanes[3]));
+#elif LEAF_SIMD_NEON
+    float32x4_t acc = vdupq_n_f32(0.0f);
+    for (; i + 4 <= size; i += 4) acc = vmaxq_f32(acc, vabsq_f32(vld1q_f32(x + i)));
+    float32x2_t pair = vpmax_f32(vget_low_f32(acc), vget_high_f32(acc));
+    peak = vget_lane_f32(vpmax_f32(pair, pair), 0);
+#endif
+    for (; i < size; ++i) peak = fmaxf(peak, fabsf(x[i]));
+    return peak;
+}
+
+// Runs the envelope and trigger logic of tAutoSampler_tick over a block, up to the first sample that
+// should trigger a recording. Returns the index of that sample, with the envelope already updated for
+// it, or size if there isn't one. When no sample in the block can ride the envelope up it only
+// decays, so the whole block is done at once.
+static int tAutoSampler_scan(_tAutoSampler* const a, const float* input, int size)
+{
+    _tEnvelopeFollower* e = a->ef;
+
+    float peak = autosampler_peak(input, size);
+    if (size != a->blockDecaySize)
+    {
+        a->blockDecay = powf(e->d_coeff, (float) size);
+        a->blockDecaySize = size;
+    }
+    if (peak <= e->a_thresh || peak < e->y * a->blockDecay)
+    {
+        e->y *= a->blockDecay;
+        if (e->y < VSF) e->y = 0.0f;
+        a->sampleCounter = a->sampleCounter > (uint32_t) size ? a->sampleCounter - size : 0;
+        if (a->powerCounter >= (uint32_t) size) a->powerCounter -= size;
+        else
+        {
+            a->powerCounter = 0;
+            a->sampleTriggered = 0;
+        }
+        a->previousPower = e->y;
+        return size;
+    }
+
+    for (int i = 0; i < size; ++i)
+    {
+        float currentPower = tEnvelopeFollower_tick(&a->ef, input[i]);
+
+        if ((currentPower > (a->threshold)) &&
+            (currentPower > a->previousPower + 0.001f) &&
+            (a->sampleTriggered == 0) &&
+            (a->sampleCounter == 0))
+        {
+            return i;
+        }
+
+        if (a->sampleCounter > 0)
+        {
+            a->sampleCounter--;
+        }
+
+        //on it's way down
+        if (currentPower <= a->previousPower)
+        {
+            if (a->powerCounter > 0)
+            {
+                a->powerCounter--;
+            }
+            else if (a->sampleTriggered == 1)
+            {
+                a->sampleTriggered = 0;
+            }
+        }
+
+        a->previousPower = currentPower;
+    }
+    return size;
+}
+
 float   tAutoSampler_tick               (tAutoSampler* const as, float input)
 {
+    LEAF_PROFILE_OBJECT(as);
     _tAutoSampler* a = *as;
     float currentPower = tEnvelopeFollower_tick(&a->ef, input);
     
@@ -1121,11 +1932,7 @@ float   tAutoSampler_tick               (tAutoSampler* const as, float input)
         (a->sampleTriggered == 0) &&
         (a->sampleCounter == 0))
     {
-        a->sampleTriggered = 1;
-        tBuffer_record(&a->sampler->samp);
-        a->sampler->samp->recordedLength = a->sampler->samp->bufferLength;
-        a->sampleCounter = a->windowSize + 24;//arbitrary extra time to avoid resampling while playing previous sample - better solution would be alternating buffers and crossfading
-        a->powerCounter = 1000;
+        tAutoSampler_trigger(a);
     }
     
     if (a->sampleCounter > 0)
@@ -1136,6 +1943,7 @@ float   tAutoSampler_tick               (tAutoSampler* const as, float input)
     
     tSampler_setEnd(&a->sampler, a->windowSize);
     tBuffer_tick(&a->sampler->samp, input);
+    tAutoSampler_feedPreRoll(a, &input, 1);
     //on it's way down
     if (currentPower <= a->previousPower)
     {
@@ -1154,6 +1962,39 @@ float   tAutoSampler_tick               (tAutoSampler* const as, float input)
     return tSampler_tick(&a->sampler);
 }
 
+void    tAutoSampler_tickBlock          (tAutoSampler* const as, const float* input, float* output, int size)
+{
+    LEAF_PROFILE_OBJECT(as);
+    _tAutoSampler* a = *as;
+    tBuffer* b = &a->sampler->samp;
+
+    tSampler_setEnd(&a->sampler, a->windowSize);
+
+    int n = 0;
+    while (n < size)
+    {
+        int t = n + tAutoSampler_scan(a, input + n, size - n);
+
+        // Samples up to the trigger carry on any recording in progress, then the trigger sample
+        // starts a new one, finishing what tAutoSampler_scan left of its tick
+        tBuffer_tickBlock(b, input + n, t - n);
+        tAutoSampler_feedPreRoll(a, input + n, t - n);
+        if (t < size)
+        {
+            tAutoSampler_trigger(a);
+            tSampler_setEnd(&a->sampler, a->windowSize);
+            a->sampleCounter--;
+            a->previousPower = a->ef->y;
+            tBuffer_tickBlock(b, input + t, 1);
+            tAutoSampler_feedPreRoll(a, input + t, 1);
+            t++;
+        }
+
+        for (int i = n; i < t; ++i) output[i] = tSampler_tick(&a->sampler);
+        n = t;
+    }
+}
+
 void    tAutoSampler_setBuffer         (tAutoSampler* const as, tBuffer* const b)
 {
     _tAutoSampler* a = *as;
@@ -1194,6 +2035,19 @@ void    tAutoSampler_setWindowSize      (tAutoSampler* const as, uint32_t size)
     else a->windowSize = size;
 }
 
+void    tAutoSampler_setPreRoll         (tAutoSampler* const as, uint32_t length)
+{
+    _tAutoSampler* a = *as;
+
+    if (length > tBuffer_getBufferLength(&a->sampler->samp) / 2)
+        length = tBuffer_getBufferLength(&a->sampler->samp) / 2;
+    if (a->preRollBuffer != NULL) mpool_free((char*)a->preRollBuffer, a->mempool);
+    a->preRollBuffer = NULL;
+    if (length > 0) a->preRollBuffer = (float*) mpool_calloc(sizeof(float) * length, a->mempool);
+    a->preRollLength = length;
+    a->preRollIdx = 0;
+}
+
 void    tAutoSampler_setCrossfadeLength (tAutoSampler* const as, uint32_t length)
 {
     _tAutoSampler* a = *as;
@@ -1219,6 +2073,7 @@ void tMBSampler_init(tMBSampler* const sp, tBuffer* const b, LEAF* const leaf)
 
 void tMBSampler_initToPool(tMBSampler* const sp, tBuffer* const b, tMempool* const mp)
 {
+    LEAF_PROFILE_POOL(mp);
     _tMempool* m = *mp;
     _tMBSampler* c = *sp = (_tMBSampler*) mpool_alloc(sizeof(_tMBSampler), m);
     c->mempool = m;
@@ -1268,6 +2123,7 @@ void tMBSampler_setSample (tMBSampler* const sp, tBuffer* const b)
 
 float tMBSampler_tick        (tMBSampler* const sp)
 {
+    LEAF_PROFILE_OBJECT(sp);
     _tMBSampler* c = *sp;
     
     if ((c->gain->curr == 0.0f) && (!c->active)) return 0.0f;
@@ -1279,7 +2135,7 @@ float tMBSampler_tick        (tMBSampler* const sp)
     
     float last, beforeLast;
     int start, end, length;
-    float* buff;
+    _tBuffer* buff;
     int    j;
     float  syncin;
     float  a, p, w, z;
@@ -1288,7 +2144,7 @@ float tMBSampler_tick        (tMBSampler* const sp)
     start = c->start;
     end = c->end;
 
-    buff = c->samp->buff;
+    buff = c->samp;
     
     last = c->last;
     beforeLast = c->beforeLast;
@@ -1351,12 +2207,12 @@ float tMBSampler_tick        (tMBSampler* const sp)
             float f = p;
             int i = (int) f;
             f -= i;
-            next = buff[i] * (1.0f - f) + buff[i+1] * f;
+            next = tBuffer_readSample(buff, i) * (1.0f - f) + tBuffer_readSample(buff, i+1) * f;
             
             f = p + w;
             i = (int) f;
             f -= i;
-            afterNext = buff[i] * (1.0f - f) + buff[i+1] * f;
+            afterNext = tBuffer_readSample(buff, i) * (1.0f - f) + tBuffer_readSample(buff, i+1) * f;
  
             place_step_dd(c->_f, j, p - start, w, next - last);
             float nextSlope = (afterNext - next) / w;
@@ -1388,7 +2244,7 @@ float tMBSampler_tick        (tMBSampler* const sp)
             float f = p;
             int i = (int) f;
             f -= i;
-            next = buff[i] * (1.0f - f) + buff[i+1] * f;
+            next = tBuffer_readSample(buff, i) * (1.0f - f) + tBuffer_readSample(buff, i+1) * f;
 
 
             if ((end - p) < 480) // 480 samples should be enough to let the tExpSmooth go from 1 to 0 (10ms at 48k, 5ms at 192k)
@@ -1403,7 +2259,7 @@ float tMBSampler_tick        (tMBSampler* const sp)
             float f = p + w;
             int i = (int) f;
             f -= i;
-            afterNext = buff[i] * (1.0f - f) + buff[i+1] * f;
+            afterNext = tBuffer_readSample(buff, i) * (1.0f - f) + tBuffer_readSample(buff, i+1) * f;
             
             float nextSlope = (afterNext - next) / w;
             float lastSlope = (last - beforeLast) / w;
@@ -1423,12 +2279,12 @@ float tMBSampler_tick        (tMBSampler* const sp)
             float f = p;
             int i = (int) f;
             f -= i;
-            next = buff[i] * (1.0f - f) + buff[i+1] * f;
+            next = tBuffer_readSample(buff, i) * (1.0f - f) + tBuffer_readSample(buff, i+1) * f;
 
             f = p + w;
             i = (int) f;
             f -= i;
-            afterNext = buff[i] * (1.0f - f) + buff[i+1] * f;
+            afterNext = tBuffer_readSample(buff, i) * (1.0f - f) + tBuffer_readSample(buff, i+1) * f;
 
             place_step_dd(c->_f, j, end - p, w, next - last);
             float nextSlope = (afterNext - next) / w;
@@ -1466,7 +2322,7 @@ float tMBSampler_tick        (tMBSampler* const sp)
             float f = p;
             int i = (int) f;
             f -= i;
-            next = buff[i] * (1.0f - f) + buff[i+1] * f;
+            next = tBuffer_readSample(buff, i) * (1.0f - f) + tBuffer_readSample(buff, i+1) * f;
         }
         
         if (c->_last_w > 0.0f)
@@ -1474,7 +2330,7 @@ float tMBSampler_tick        (tMBSampler* const sp)
             float f = p + w;
             int i = (int) f;
             f -= i;
-            afterNext = buff[i] * (1.0f - f) + buff[i+1] * f;
+            afterNext = tBuffer_readSample(buff, i) * (1.0f - f) + tBuffer_readSample(buff, i+1) * f;
             
             float nextSlope = (afterNext - next) / w;
             float lastSlope = (last - beforeLast) / w;
@@ -1568,3 +2424,441 @@ void tMBSampler_setRate      (tMBSampler* const sp, float rate)
     p->_w = rate;
 }
 
+//==============================================================================
+
+void tSamplerPoly_init (tSamplerPoly* const sp, tBuffer* const b, int numVoices, LEAF* const leaf)
+{
+    tSamplerPoly_initToPool(sp, b, numVoices, &leaf->mempool);
+}
+
+void tSamplerPoly_initToPool (tSamplerPoly* const sp, tBuffer* const b, int numVoices, tMempool* const mp)
+{
+    LEAF_PROFILE_POOL(mp);
+    _tMempool* m = *mp;
+    _tSamplerPoly* p = *sp = (_tSamplerPoly*) mpool_alloc(sizeof(_tSamplerPoly), m);
+    p->mempool = m;
+    LEAF* leaf = p->mempool->leaf;
+
+    p->numVoices = numVoices > 0 ? numVoices : 1;
+    p->voices = (_tSamplerPolyVoice*) mpool_calloc(sizeof(_tSamplerPolyVoice) * p->numVoices, m);
+    p->tails = (_tSamplerPolyVoice*) mpool_calloc(sizeof(_tSamplerPolyVoice) * p->numVoices, m);
+    p->age = 0;
+    p->stealMode = StealOldest;
+
+    p->mode = PlayNormal;
+    p->cfxlen = 500;
+
+    p->samp = NULL;
+    tSamplerPoly_setSampleRate(sp, leaf->sampleRate);
+    tSamplerPoly_setSample(sp, b);
+}
+
+void tSamplerPoly_free (tSamplerPoly* const sp)
+{
+    _tSamplerPoly* p = *sp;
+
+    mpool_free((char*)p->tails, p->mempool);
+    mpool_free((char*)p->voices, p->mempool);
+    mpool_free((char*)p, p->mempool);
+}
+
+// Works out one run of a voice's interpolation points and gains, returning 0 once the voice has finished
+static int tSamplerPoly_gather(_tSamplerPoly* p, _tSamplerPolyVoice* v, int n,
+                               int lo, int hi, int last, int xf, int xr)
+{
+    _tBuffer* s = p->samp;
+    int channels = p->samp->channels > 1 ? 2 : 1;
+    int stride = (int) p->samp->channels;
+    int loopLength = hi - lo;
+    float invXf = xf > 0 ? 1.0f / (float) xf : 0.0f;
+    float invXr = xr > 0 ? 1.0f / (float) xr : 0.0f;
+    float fadeDistance = p->fadeTicks * fabsf(v->inc);
+
+    for (int k = 0; k < n; ++k)
+    {
+        float pos = v->pos;
+        int i = (int) pos;
+        float alpha = pos - (float) i;
+
+        int j[4];
+        for (int t = 0; t < 4; ++t)
+        {
+            int idx = i - 1 + t;
+            j[t] = idx < 0 ? 0 : idx > last ? last : idx;
+        }
+
+        // Loop crossfades mix in the same points from the other end of the loop, which is
+        // the same as mixing the interpolated samples since the interpolation is linear in them
+        float mix = 0.0f;
+        int shift = 0;
+        if (p->mode == PlayLoop)
+        {
+            if (v->inc > 0.0f && pos > (float) (hi - xf))
+            {
+                mix = (pos - (float) (hi - xf)) * invXf;
+                shift = -loopLength;
+            }
+            else if (v->inc < 0.0f && pos < (float) (lo + xr))
+            {
+                mix = ((float) (lo + xr) - pos) * invXr;
+                shift = loopLength;
+            }
+        }
+
+        for (int c = 0; c < channels; ++c)
+        {
+            for (int t = 0; t < 4; ++t)
+            {
+                float x = tBuffer_readSample(s, j[t] * stride + c);
+                if (mix > 0.0f)
+                {
+                    int o = j[t] + shift;
+                    o = o < 0 ? 0 : o > last ? last : o;
+                    x += (tBuffer_readSample(s, o * stride + c) - x) * mix;
+                }
+                p->x[c][t][k] = x;
+            }
+        }
+        p->alpha[k] = alpha;
+
+        v->env += v->envInc;
+        if (v->env >= 1.0f)
+        {
+            v->env = 1.0f;
+            v->envInc = 0.0f;
+        }
+        else if (v->env <= 0.0f)
+        {
+            // Faded out, silence the rest of the run
+            for (; k < n; ++k)
+            {
+                p->amp[k] = 0.0f;
+                for (int c = 0; c < channels; ++c)
+                {
+                    for (int t = 0; t < 4; ++t) p->x[c][t][k] = 0.0f;
+                }
+                p->alpha[k] = 0.0f;
+            }
+            v->env = 0.0f;
+            v->state = 0;
+            return 0;
+        }
+        p->amp[k] = v->env * v->gain;
+
+        pos += v->inc;
+        if (p->mode == PlayLoop)
+        {
+            if (v->inc > 0.0f && pos >= (float) hi) pos -= (float) loopLength;
+            else if (v->inc < 0.0f && pos <= (float) lo) pos += (float) loopLength;
+            if (pos < (float) lo || pos > (float) hi) pos = v->inc > 0.0f ? (float) lo : (float) hi;
+        }
+        else if (p->mode == PlayBackAndForth)
+        {
+            if (pos > (float) hi)
+            {
+                pos = 2.0f * (float) hi - pos;
+                v->inc = -v->inc;
+                v->bnf = -v->bnf;
+            }
+            else if (pos < (float) lo)
+            {
+                pos = 2.0f * (float) lo - pos;
+                v->inc = -v->inc;
+                v->bnf = -v->bnf;
+            }
+        }
+        else
+        {
+            // Fade out just before the end, as tSampler does
+            float toEnd = v->inc > 0.0f ? (float) hi - pos : pos - (float) lo;
+            if (toEnd < fadeDistance && v->state == 1)
+            {
+                v->state = 2;
+                v->envInc = -p->fadeInc;
+            }
+            if (pos > (float) hi) pos = (float) hi;
+            else if (pos < (float) lo) pos = (float) lo;
+        }
+        v->pos = pos;
+    }
+    return 1;
+}
+
+// Adds a block of one voice to the outputs and returns its peak level
+static float tSamplerPoly_renderVoice(_tSamplerPoly* p, _tSamplerPolyVoice* v, float** outputs, int size,
+                                      int lo, int hi, int last, int xf, int xr)
+{
+    int channels = p->samp->channels > 1 ? 2 : 1;
+    float peak = 0.0f;
+    for (int offset = 0; offset < size && v->state != 0; offset += SAMPLERPOLY_RUN)
+    {
+        int n = size - offset < SAMPLERPOLY_RUN ? size - offset : SAMPLERPOLY_RUN;
+        tSamplerPoly_gather(p, v, n, lo, hi, last, xf, xr);
+
+        // 4-point Hermite over the whole run, the same as LEAF_interpolate_hermite_x
+        for (int c = 0; c < channels; ++c)
+        {
+            const float* y0 = p->x[c][0];
+            const float* y1 = p->x[c][1];
+            const float* y2 = p->x[c][2];
+            const float* y3 = p->x[c][3];
+            float* out = outputs[c] + offset;
+            for (int k = 0; k < n; ++k)
+            {
+                float c0 = y1[k];
+                float c1 = 0.5f * (y2[k] - y0[k]);
+                float y0my1 = y0[k] - y1[k];
+                float c3 = (y1[k] - y2[k]) + 0.5f * (y3[k] - y0my1 - y2[k]);
+                float c2 = y0my1 + c1 - c3;
+                float a = p->alpha[k];
+                float y = (((c3 * a + c2) * a + c1) * a + c0) * p->amp[k];
+                out[k] += y;
+                if (c == 0) peak = fmaxf(peak, fabsf(y));
+            }
+        }
+    }
+    return peak;
+}
+
+void tSamplerPoly_tickBlock (tSamplerPoly* const sp, float** outputs, int size)
+{
+    LEAF_PROFILE_OBJECT(sp);
+    _tSamplerPoly* p = *sp;
+
+    int channels = p->samp->channels > 1 ? 2 : 1;
+    for (int c = 0; c < channels; ++c)
+    {
+        for (int i = 0; i < size; ++i) outputs[c][i] = 0.0f;
+    }
+    if (p->samp->stream != NULL) return;
+
+    // Loop points and crossfades are shared by every voice, so work them out once per block
+    int last = (int) p->samp->recordedLength - 1;
+    int lo = p->start < p->end ? p->start : p->end;
+    int hi = p->start < p->end ? p->end : p->start;
+    if (hi > last) hi = last;
+    if (lo > hi) lo = hi;
+    if (hi - lo < 2) return;
+
+    int xf = (int) p->cfxlen;
+    if (xf > (hi - lo) / 4) xf = (hi - lo) / 4;
+    int xr = xf;
+    if (xf > lo) xf = lo;
+    if (xr > last - hi) xr = last - hi;
+
+    for (int vi = 0; vi < p->numVoices; ++vi)
+    {
+        _tSamplerPolyVoice* t = &p->tails[vi];
+        if (t->state != 0) tSamplerPoly_renderVoice(p, t, outputs, size, lo, hi, last, xf, xr);
+
+        _tSamplerPolyVoice* v = &p->voices[vi];
+        if (v->state == 0) continue;
+
+        float peak = tSamplerPoly_renderVoice(p, v, outputs, size, lo, hi, last, xf, xr);
+        // Slowly falling peak level, used for stealing the quietest voice
+        v->level = fmaxf(peak, v->level * 0.9f);
+    }
+}
+
+int tSamplerPoly_noteOn (tSamplerPoly* const sp, int note, float rate, float gain)
+{
+    _tSamplerPoly* p = *sp;
+
+    // Use a free voice if there is one, otherwise steal, preferring voices that are already fading out
+    int voice = -1;
+    for (int i = 0; i < p->numVoices && voice < 0; ++i)
+    {
+        if (p->voices[i].state == 0) voice = i;
+    }
+    if (voice < 0)
+    {
+        for (int i = 0; i < p->numVoices; ++i)
+        {
+            _tSamplerPolyVoice* v = &p->voices[i];
+            if (voice < 0)
+            {
+                voice = i;
+                continue;
+            }
+            _tSamplerPolyVoice* w = &p->voices[voice];
+            if (v->state != w->state)
+            {
+                if (v->state == 2) voice = i;
+                continue;
+            }
+            if (p->stealMode == StealQuietest)
+            {
+                if (v->level < w->level) voice = i;
+            }
+            else if ((int32_t) (v->age - w->age) < 0) voice = i;
+        }
+    }
+
+    _tSamplerPolyVoice* v = &p->voices[voice];
+    if (v->state != 0)
+    {
+        // Let what the stolen voice was playing fade out rather than cutting it off
+        _tSamplerPolyVoice* t = &p->tails[voice];
+        *t = *v;
+        t->state = 2;
+        t->envInc = -p->fadeInc;
+    }
+    v->note = note;
+    v->state = 1;
+    v->rate = rate;
+    v->bnf = 1;
+    v->gain = gain;
+    v->env = 0.0f;
+    v->envInc = p->fadeInc;
+    v->level = fabsf(gain);
+    v->age = ++p->age;
+
+    tSamplerPoly_setVoiceRate(sp, voice, rate);
+    int lo = p->start < p->end ? p->start : p->end;
+    int hi = p->start < p->end ? p->end : p->start;
+    v->pos = v->inc >= 0.0f ? (float) lo : (float) hi;
+
+    return voice;
+}
+
+void tSamplerPoly_noteOff (tSamplerPoly* const sp, int note)
+{
+    _tSamplerPoly* p = *sp;
+
+    for (int i = 0; i < p->numVoices; ++i)
+    {
+        _tSamplerPolyVoice* v = &p->voices[i];
+        if (v->state == 1 && v->note == note)
+        {
+            v->state = 2;
+            v->envInc = -p->fadeInc;
+        }
+    }
+}
+
+void tSamplerPoly_allNotesOff (tSamplerPoly* const sp)
+{
+    _tSamplerPoly* p = *sp;
+
+    for (int i = 0; i < p->numVoices; ++i)
+    {
+        _tSamplerPolyVoice* v = &p->voices[i];
+        if (v->state == 1)
+        {
+            v->state = 2;
+            v->envInc = -p->fadeInc;
+        }
+    }
+}
+
+void tSamplerPoly_setVoiceRate (tSamplerPoly* const sp, int voice, float rate)
+{
+    _tSamplerPoly* p = *sp;
+    if (voice < 0 || voice >= p->numVoices) return;
+
+    _tSamplerPolyVoice* v = &p->voices[voice];
+    v->rate = rate;
+    // Voices travel from start towards end
+    float dir = p->start <= p->end ? 1.0f : -1.0f;
+    v->inc = rate * p->rateFactor * dir * (float) v->bnf;
+}
+
+void tSamplerPoly_setVoiceGain (tSamplerPoly* const sp, int voice, float gain)
+{
+    _tSamplerPoly* p = *sp;
+    if (voice < 0 || voice >= p->numVoices) return;
+
+    p->voices[voice].gain = gain;
+}
+
+void tSamplerPoly_setStealMode (tSamplerPoly* const sp, SamplerStealMode mode)
+{
+    _tSamplerPoly* p = *sp;
+    p->stealMode = mode;
+}
+
+int tSamplerPoly_getNumActiveVoices (tSamplerPoly* const sp)
+{
+    _tSamplerPoly* p = *sp;
+
+    int active = 0;
+    for (int i = 0; i < p->numVoices; ++i)
+    {
+        if (p->voices[i].state != 0) active++;
+    }
+    return active;
+}
+
+void tSamplerPoly_setSample (tSamplerPoly* const sp, tBuffer* const b)
+{
+    _tSamplerPoly* p = *sp;
+    _tBuffer* s = *b;
+
+    // Voices read anywhere in the sample at once, which a streamed buffer can't serve
+    if (s->stream != NULL) LEAF_internalErrorCallback(p->mempool->leaf, LEAFInvalidBuffer);
+
+    p->samp = s;
+    p->rateFactor = s->sampleRate / p->sampleRate;
+    p->start = 0;
+    p->end = s->bufferLength - 1;
+
+    for (int i = 0; i < p->numVoices; ++i)
+    {
+        p->voices[i].state = 0;
+        p->voices[i].env = 0.0f;
+        p->tails[i].state = 0;
+    }
+}
+
+void tSamplerPoly_setMode (tSamplerPoly* const sp, PlayMode mode)
+{
+    _tSamplerPoly* p = *sp;
+    p->mode = mode;
+}
+
+void tSamplerPoly_setStart (tSamplerPoly* const sp, int32_t start)
+{
+    _tSamplerPoly* p = *sp;
+
+    int32_t last = (int32_t) p->samp->bufferLength - 1;
+    p->start = start < 0 ? 0 : start > last ? last : start;
+    for (int i = 0; i < p->numVoices; ++i)
+    {
+        if (p->voices[i].state != 0) tSamplerPoly_setVoiceRate(sp, i, p->voices[i].rate);
+    }
+}
+
+void tSamplerPoly_setEnd (tSamplerPoly* const sp, int32_t end)
+{
+    _tSamplerPoly* p = *sp;
+
+    int32_t last = (int32_t) p->samp->bufferLength - 1;
+    p->end = end < 0 ? 0 : end > last ? last : end;
+    for (int i = 0; i < p->numVoices; ++i)
+    {
+        if (p->voices[i].state != 0) tSamplerPoly_setVoiceRate(sp, i, p->voices[i].rate);
+    }
+}
+
+void tSamplerPoly_setCrossfadeLength (tSamplerPoly* const sp, uint32_t length)
+{
+    _tSamplerPoly* p = *sp;
+    p->cfxlen = length;
+}
+
+void tSamplerPoly_setSampleRate (tSamplerPoly* const sp, float sr)
+{
+    _tSamplerPoly* p = *sp;
+
+    p->sampleRate = sr;
+    p->fadeTicks = 0.007f * sr;
+    p->fadeInc = 1.0f / (0.005f * sr);
+    if (p->samp != NULL)
+    {
+        p->rateFactor = p->samp->sampleRate / sr;
+        for (int i = 0; i < p->numVoices; ++i)
+        {
+            tSamplerPoly_setVoiceRate(sp, i, p->voices[i].rate);
+        }
+    }
+}
@@ -3484,7 +3484,7 @@ const float __leaf_table_squarewave[11][SQR_TABLE_SIZE] =
 };
 #endif // LEAF_INCLUDE_SQUARE_TABLE
 
-#if LEAF_INCLUDE_ADSR_TABLES
+#if LEAF_INCLUDE_ADSR_TABLES && !LEAF_GENERATE_TABLES
 const float __leaf_table_exp_decay[EXP_DECAY_TABLE_SIZE] = { 
 	1.0f, 0.999969f, 0.999939f, 0.999908f, 0.999878f, 0.999847f, 0.999817f, 0.999786f, 0.999756f, 0.999725f, 0.999695f, 0.999664f, 0.999634f, 0.999603f, 0.999573f, 0.999542f, 0.999512f, 0.999481f, 0.999451f, 0.99942f,
 0.99939f, 0.999359f, 0.999329f, 0.999298f, 0.999268f, 0.999237f, 0.999207f, 0.999176f, 0.999146f, 0.999115f, 0.999085f, 0.999054f, 0.999024f, 0.998993f, 0.998963f, 0.998932f, 0.998902f, 0.998871f, 0.998841f, 0.99881f,
@@ -13953,7 +13953,7 @@ const float __leaf_table_tanh1[TANH1_TABLE_SIZE] = {-0.964028f, -0.964023f, -0.9
 0.963963f, 0.963967f, 0.963971f, 0.963976f, 0.96398f, 0.963984f, 0.963989f, 0.963993f, 0.963997f, 0.964002f, 0.964006f, 0.96401f, 0.964015f, 0.964019f, 0.964023f, 0.964028f, };
 #endif // LEAF_INCLUDE_TANH_TABLE
 
-#if LEAF_INCLUDE_SINE_TABLE
+#if LEAF_INCLUDE_SINE_TABLE && !LEAF_GENERATE_TABLES
 const float __leaf_table_sinewave[SINE_TABLE_SIZE] = {0.0f, 0.00305f, 0.00613f, 0.00919f, 0.01227f, 0.01532f, 0.0184f, 0.02145f, 0.02454f, 0.02759f, 0.03067f, 0.03372f, 0.0368f, 0.03986f, 0.04291f, 0.04599f, 0.04904f, 0.05212f, 0.05518f, 0.05823f,
 0.06131f, 0.06436f, 0.06741f, 0.0705f, 0.07355f, 0.0766f, 0.07965f, 0.08273f, 0.08578f, 0.08884f, 0.09189f, 0.09494f, 0.09799f, 0.10104f, 0.1041f, 0.10715f, 0.1102f, 0.11325f, 0.1163f, 0.11935f,
 0.12241f, 0.12543f, 0.12848f, 0.13153f, 0.13455f, 0.1376f, 0.14066f, 0.14368f, 0.1467f, 0.14975f, 0.15277f, 0.15582f, 0.15884f, 0.16187f, 0.16489f, 0.16791f, 0.17093f, 0.17398f, 0.17697f, 0.17999f,
@@ -15819,3 +15819,44 @@ slope_dd_table [MINBLEP_PHASES * SLOPE_DD_PULSE_LENGTH + 1] =
     0.000000e+00
 };
 #endif // LEAF_INCLUDE_MINBLEP_TABLES
+
+#if LEAF_GENERATE_TABLES
+static leaf_table_t leaf_table_fromFloat(float value)
+{
+#if LEAF_TABLE_PRECISION == LEAF_TABLE_Q15
+    return (leaf_table_t) lrintf(LEAF_clip(-1.0f, value, 1.0f) * 32767.0f);
+#else
+    return value;
+#endif
+}
+
+void LEAF_generateTables(LEAF* const leaf)
+{
+    leaf->sineTable = NULL;
+    leaf->expDecayTable = NULL;
+
+#if LEAF_INCLUDE_SINE_TABLE
+    leaf->sineTable = (leaf_table_t*) mpool_alloc(sizeof(leaf_table_t) * SINE_TABLE_SIZE, leaf->mempool);
+    if (leaf->sineTable != NULL)
+    {
+        for (int i = 0; i < SINE_TABLE_SIZE; ++i)
+        {
+            leaf->sineTable[i] = leaf_table_fromFloat(sinf(TWO_PI * (float) i / (float) SINE_TABLE_SIZE));
+        }
+    }
+#endif
+
+#if LEAF_INCLUDE_ADSR_TABLES
+    // Squared falling ramp, the same curve as the precomputed table
+    leaf->expDecayTable = (leaf_table_t*) mpool_alloc(sizeof(leaf_table_t) * EXP_DECAY_TABLE_SIZE, leaf->mempool);
+    if (leaf->expDecayTable != NULL)
+    {
+        for (int i = 0; i < EXP_DECAY_TABLE_SIZE; ++i)
+        {
+            float x = 1.0f - (float) i / (float) EXP_DECAY_TABLE_SIZE;
+            leaf->expDecayTable[i] = leaf_table_fromFloat(x * x);
+        }
+    }
+#endif
+}
+#endif // LEAF_GENERATE_TABLES
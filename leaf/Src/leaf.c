@@ -18,6 +18,11 @@
 
 #endif
 
+#if LEAF_FLUSH_DENORMALS && (defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1))
+#include <xmmintrin.h>
+#define LEAF_FLUSH_SSE 1
+#endif
+
 void LEAF_init(LEAF* const leaf, float sr, char* memory, size_t memorysize, float(*random)(void))
 {
     leaf->_internal_mempool.leaf = leaf;
@@ -29,6 +34,10 @@ void LEAF_init(LEAF* const leaf, float sr, char* memory, size_t memorysize, floa
     
     leaf->twoPiTimesInvSampleRate = leaf->invSampleRate * TWO_PI;
 
+    leaf->blockSize = 1;
+
+    leaf->controlRate = 1;
+
     leaf->random = random;
     
     leaf->clearOnAllocation = 0;
@@ -41,6 +50,42 @@ void LEAF_init(LEAF* const leaf, float sr, char* memory, size_t memorysize, floa
     leaf->allocCount = 0;
     
     leaf->freeCount = 0;
+
+#if LEAF_PROFILE
+    leaf->profileTime = NULL;
+    leaf->profileDepth = 0;
+    leaf->numProfileEntries = 0;
+#endif
+
+#if LEAF_GENERATE_TABLES
+    LEAF_generateTables(leaf);
+#endif
+
+    LEAF_enterAudioThread();
+}
+
+void LEAF_enterAudioThread(void)
+{
+#if LEAF_FLUSH_DENORMALS
+#if LEAF_FLUSH_SSE
+    // FTZ is bit 15 of MXCSR and DAZ bit 6
+    _mm_setcsr(_mm_getcsr() | 0x8040);
+#elif defined(__GNUC__) && defined(__aarch64__)
+    // FZ is bit 24 of FPCR, and flushes inputs as well as results
+    uint64_t fpcr;
+    __asm__ __volatile__ ("mrs %0, fpcr" : "=r" (fpcr));
+    __asm__ __volatile__ ("msr fpcr, %0" : : "r" (fpcr | (1u << 24)));
+#elif defined(__GNUC__) && defined(__arm__) && defined(__ARM_FP)
+    // FZ is bit 24 of FPSCR, and flushes inputs as well as results
+    uint32_t fpscr;
+    __asm__ __volatile__ ("vmrs %0, fpscr" : "=r" (fpscr));
+    __asm__ __volatile__ ("vmsr fpscr, %0" : : "r" (fpscr | (1u << 24)));
+#if defined(__ARM_ARCH_PROFILE) && __ARM_ARCH_PROFILE == 'M'
+    // Exception handlers start from FPDSCR instead of the interrupted FPSCR
+    *(volatile uint32_t*) 0xE000EF3C |= (1u << 24);
+#endif
+#endif
+#endif
 }
 
 void LEAF_setSampleRate(LEAF* const leaf, float sampleRate)
@@ -55,6 +100,26 @@ float LEAF_getSampleRate(LEAF* const leaf)
     return leaf->sampleRate;
 }
 
+void LEAF_setBlockSize(LEAF* const leaf, int blockSize)
+{
+    leaf->blockSize = blockSize > 0 ? blockSize : 1;
+}
+
+int LEAF_getBlockSize(LEAF* const leaf)
+{
+    return leaf->blockSize;
+}
+
+void LEAF_setControlRate(LEAF* const leaf, int divider)
+{
+    leaf->controlRate = divider > 0 ? divider : 1;
+}
+
+int LEAF_getControlRate(LEAF* const leaf)
+{
+    return leaf->controlRate;
+}
+
 void LEAF_defaultErrorCallback(LEAF* const leaf, LEAFErrorType whichone)
 {
     // Not sure what this should do if anything
@@ -71,3 +136,83 @@ void LEAF_setErrorCallback(LEAF* const leaf, void (*callback)(LEAF* const, LEAFE
 {
     leaf->errorCallback = callback;
 }
+
+#if LEAF_PROFILE
+void LEAF_setProfileCallback(LEAF* const leaf, uint32_t (*time)(void))
+{
+    leaf->profileTime = time;
+}
+
+// Nested calls, like a string ticking its own filters, only bump the depth so their time is counted
+// once, in the function the host called
+void LEAF_profileEnter(LEAFProfileScope* const scope)
+{
+    LEAF* leaf = scope->leaf;
+    if (leaf->profileDepth++ == 0 && leaf->profileTime != NULL) scope->start = leaf->profileTime();
+}
+
+void LEAF_profileExit(LEAFProfileScope* const scope)
+{
+    LEAF* leaf = scope->leaf;
+    if (--leaf->profileDepth > 0 || leaf->profileTime == NULL) return;
+    uint32_t time = leaf->profileTime() - scope->start;
+    
+    // Each function caches its entry, which only has to be looked up again for another LEAF instance.
+    // Names are the functions' __func__ strings, so comparing pointers is enough.
+    int slot = *scope->slot;
+    if (slot < 0 || slot >= leaf->numProfileEntries || leaf->profile[slot].name != scope->name)
+    {
+        for (slot = 0; slot < leaf->numProfileEntries; slot++)
+        {
+            if (leaf->profile[slot].name == scope->name) break;
+        }
+        if (slot == leaf->numProfileEntries)
+        {
+            if (slot >= LEAF_PROFILE_MAX_ENTRIES) return;
+            LEAFProfileEntry* entry = &leaf->profile[slot];
+            entry->name = scope->name;
+            entry->calls = 0;
+            entry->minTime = UINT32_MAX;
+            entry->maxTime = 0;
+            entry->totalTime = 0;
+            entry->blockTime = 0;
+            entry->worstBlockTime = 0;
+            leaf->numProfileEntries++;
+        }
+        *scope->slot = slot;
+    }
+    
+    LEAFProfileEntry* entry = &leaf->profile[slot];
+    entry->calls++;
+    if (time < entry->minTime) entry->minTime = time;
+    if (time > entry->maxTime) entry->maxTime = time;
+    entry->totalTime += time;
+    entry->blockTime += time;
+}
+
+void LEAF_profileEndBlock(LEAF* const leaf)
+{
+    for (int i = 0; i < leaf->numProfileEntries; i++)
+    {
+        LEAFProfileEntry* entry = &leaf->profile[i];
+        if (entry->blockTime > entry->worstBlockTime) entry->worstBlockTime = entry->blockTime;
+        entry->blockTime = 0;
+    }
+}
+
+void LEAF_resetProfile(LEAF* const leaf)
+{
+    leaf->numProfileEntries = 0;
+}
+
+int LEAF_getNumProfileEntries(LEAF* const leaf)
+{
+    return leaf->numProfileEntries;
+}
+
+LEAFProfileEntry* LEAF_getProfileEntry(LEAF* const leaf, int index)
+{
+    if (index < 0 || index >= leaf->numProfileEntries) return NULL;
+    return &leaf->profile[index];
+}
+#endif
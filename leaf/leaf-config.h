@@ -54,13 +54,58 @@
 //! Include tables for minblep insertion, required for all tMB objects.
 #define LEAF_INCLUDE_MINBLEP_TABLES 1
 
+//! Build the sine and envelope tables into the default mempool in LEAF_init() instead of using the precomputed tables in leaf-tables.c. This drops about 520KB of tables from flash, and is required for any table size or precision other than the defaults below.
+#define LEAF_GENERATE_TABLES 0
+
+//! Number of points in the sine table used by tCycle and tCycleBank. Must be a power of two. Sizes other than 2048 require LEAF_GENERATE_TABLES.
+#define LEAF_SINE_TABLE_SIZE 2048
+
+//! Number of points in the exponential decay table used by tEnvelope and tADSR. Must be a power of two no larger than 65536. Sizes other than 65536 require LEAF_GENERATE_TABLES.
+#define LEAF_EXP_DECAY_TABLE_SIZE 65536
+
+#define LEAF_TABLE_FLOAT32 0
+#define LEAF_TABLE_Q15 1
+
+//! Sample format of the sine and envelope tables, LEAF_TABLE_FLOAT32 or LEAF_TABLE_Q15. Q15 halves the memory used by the tables at the cost of 16-bit resolution. LEAF_TABLE_Q15 requires LEAF_GENERATE_TABLES.
+#define LEAF_TABLE_PRECISION LEAF_TABLE_FLOAT32
+
+#define LEAF_PRECISION_FLOAT32 0
+#define LEAF_PRECISION_FLOAT64 1
+#define LEAF_PRECISION_Q31 2
+
+//! Storage format of delay line buffers (leaf_sample_t), LEAF_PRECISION_FLOAT32, LEAF_PRECISION_FLOAT64 or LEAF_PRECISION_Q31. Q31 keeps 31-bit resolution in integer memory but saturates what is written to [-1, 1). Delays still take and return float.
+#define LEAF_SAMPLE_PRECISION LEAF_PRECISION_FLOAT32
+
+//! Arithmetic type of filter coefficients and state and oscillator phase (leaf_coeff_t), LEAF_PRECISION_FLOAT32 or LEAF_PRECISION_FLOAT64. Double keeps tBiQuad and tSVF stable with cutoffs far below the sample rate and tunes tCycle exactly at low frequencies.
+#define LEAF_COEFF_PRECISION LEAF_PRECISION_FLOAT32
+
+//! Skip the checks that recursive objects make on every tick to zero state decaying into denormals. Only safe when the audio thread flushes denormals, as LEAF_FLUSH_DENORMALS arranges.
 #define LEAF_NO_DENORMAL_CHECK 0
 
+//! Have LEAF_init() and LEAF_enterAudioThread() set the FPU to flush denormals to zero (FTZ and DAZ in MXCSR on x86, FZ in FPSCR or FPCR on ARM). Turns on LEAF_NO_DENORMAL_CHECK. Reverbs and strings then add an inaudible offset to their input or feedback, in case audio runs on a thread that wasn't set.
+#define LEAF_FLUSH_DENORMALS 0
+
+//! Use CMSIS-DSP functions (arm_math.h) for supported processing such as tOversampler. Requires linking CMSIS-DSP.
 #define LEAF_USE_CMSIS 0
 
+//! Use NEON, Helium or SSE intrinsics for supported processing when the target has them and LEAF_USE_CMSIS is off. Vectorized sums are accumulated in a different order, so results can differ from the portable code in the last bits.
+#define LEAF_USE_SIMD 1
+
 //! Use stdlib malloc() and free() internally instead of LEAF's normal mempool behavior for when you want to avoid being limited to and managing mempool a fixed mempool size. Usage of all object remains essentially the same.
 #define LEAF_USE_DYNAMIC_ALLOCATION 1
 
+//! Track per-mempool usage statistics (high-water mark, alloc/free counts, tagged allocations) for sizing a mempool. See mpool_get_stats(). Adds a little work to every allocation, so leave off in release builds.
+#define LEAF_POOL_STATS 0
+
+//! Maximum number of distinct tags tracked per mempool when LEAF_POOL_STATS is on.
+#define LEAF_POOL_STATS_MAX_TAGS 16
+
+//! Time every call to object init, tick and block functions and keep per-function call counts, min, max and mean times and the worst time in one block. See LEAF_setProfileCallback(). The time-stamp callback runs twice for each outermost call, so leave off in release builds. Needs GCC, Clang or a C++ build of LEAF, and a LEAF instance whose objects all run on one thread.
+#define LEAF_PROFILE 0
+
+//! Maximum number of distinct functions tracked per LEAF instance when LEAF_PROFILE is on.
+#define LEAF_PROFILE_MAX_ENTRIES 64
+
 //==============================================================================
 
 #endif // LEAF_CONFIG_H_INCLUDED
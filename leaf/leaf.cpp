@@ -4,6 +4,8 @@
 #include ".\Src\leaf-math.c"
 #include ".\Src\leaf-mempool.c"
 #include ".\Src\leaf-tables.c"
+#include ".\Src\leaf-fft.c"
+#include ".\Src\leaf-events.c"
 #include ".\Src\leaf-distortion.c"
 #include ".\Src\leaf-oscillators.c"
 #include ".\Src\leaf-filters.c"
@@ -18,6 +20,8 @@
 #include ".\Src\leaf-sampling.c"
 #include ".\Src\leaf-physical.c"
 #include ".\Src\leaf-electrical.c"
+#include ".\Src\leaf-graph.c"
+#include ".\Src\leaf-parallel.c"
 #include ".\Src\leaf.c"
 
 #include ".\Externals\d_fft_mayer.c"
@@ -28,6 +32,8 @@
 #include "./Src/leaf-math.c"
 #include "./Src/leaf-mempool.c"
 #include "./Src/leaf-tables.c"
+#include "./Src/leaf-fft.c"
+#include "./Src/leaf-events.c"
 #include "./Src/leaf-distortion.c"
 #include "./Src/leaf-dynamics.c"
 #include "./Src/leaf-oscillators.c"
@@ -42,6 +48,8 @@
 #include "./Src/leaf-sampling.c"
 #include "./Src/leaf-physical.c"
 #include "./Src/leaf-electrical.c"
+#include "./Src/leaf-graph.c"
+#include "./Src/leaf-parallel.c"
 #include "./Src/leaf.c"
 
 #include "./Externals/d_fft_mayer.c"
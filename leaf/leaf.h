@@ -1,5 +1,5 @@
 /** BEGIN_JUCE_MODULE_DECLARATION
- 
+
  ID:            leaf
  vendor:
  version:        0.0.1
@@ -37,6 +37,8 @@
 #include ".\Inc\leaf-math.h"
 #include ".\Inc\leaf-mempool.h"
 #include ".\Inc\leaf-tables.h"
+#include ".\Inc\leaf-fft.h"
+#include ".\Inc\leaf-events.h"
 #include ".\Inc\leaf-distortion.h"
 #include ".\Inc\leaf-oscillators.h"
 #include ".\Inc\leaf-filters.h"
@@ -51,6 +53,8 @@
 #include ".\Inc\leaf-sampling.h"
 #include ".\Inc\leaf-physical.h"
 #include ".\Inc\leaf-electrical.h"
+#include ".\Inc\leaf-graph.h"
+#include ".\Inc\leaf-parallel.h"
 
 #else
 
@@ -58,6 +62,8 @@
 #include "./Inc/leaf-math.h"
 #include "./Inc/leaf-mempool.h"
 #include "./Inc/leaf-tables.h"
+#include "./Inc/leaf-fft.h"
+#include "./Inc/leaf-events.h"
 #include "./Inc/leaf-distortion.h"
 #include "./Inc/leaf-dynamics.h"
 #include "./Inc/leaf-oscillators.h"
@@ -72,6 +78,8 @@
 #include "./Inc/leaf-sampling.h"
 #include "./Inc/leaf-physical.h"
 #include "./Inc/leaf-electrical.h"
+#include "./Inc/leaf-graph.h"
+#include "./Inc/leaf-parallel.h"
 
 #endif
 
@@ -123,6 +131,12 @@
  @brief String models and more.
  @defgroup electrical Electrical Models
  @brief Circuit models.
+ @defgroup events Events
+ @brief Passing events and parameter changes between threads.
+ @defgroup graph Graph
+ @brief Running patches of objects a block at a time.
+ @defgroup parallel Parallel
+ @brief Rendering voices on more than one core.
  @defgroup mempool Mempool
  @brief Memory allocation.
  @defgroup math Math
@@ -134,7 +148,7 @@
 #ifdef __cplusplus
 extern "C" {
 #endif
-    
+
     /*!
      @ingroup leaf
      @{
@@ -149,6 +163,12 @@ extern "C" {
      */
     void        LEAF_init            (LEAF* const leaf, float sampleRate, char* memory, size_t memorySize, float(*random)(void));
     
+    //! Set up the calling thread's FPU for audio. Call at the start of the audio thread or callback if it isn't the thread that called LEAF_init().
+    /*!
+     With LEAF_FLUSH_DENORMALS set, turns on flush-to-zero and denormals-are-zero so denormals can't stall the FPU, which lets objects skip their per-tick denormal checks. The modes belong to the thread, so a host that resets them between callbacks needs this called each time; it is only a couple of register accesses. On a Cortex-M it also sets the default for interrupt handlers, where audio callbacks usually run. Does nothing with LEAF_FLUSH_DENORMALS off.
+     */
+    void        LEAF_enterAudioThread (void);
+
     //! Set the sample rate of LEAF.
     /*!
      @param sampleRate The new audio sample rate.
@@ -161,6 +181,30 @@ extern "C" {
      */
     float       LEAF_getSampleRate   (LEAF* const leaf);
     
+    //! Set the block size of LEAF.
+    /*!
+     @param blockSize The number of samples processed per call by the _tickBlock functions in the host's audio callback.
+     */
+    void        LEAF_setBlockSize    (LEAF* const leaf, int blockSize);
+    
+    //! Get the block size of LEAF.
+    /*!
+     @return The current block size as an int.
+     */
+    int         LEAF_getBlockSize    (LEAF* const leaf);
+    
+    //! Set the default control rate divider of LEAF.
+    /*!
+     @param divider The number of samples between ticks of envelopes, LFOs and smoothers that support a control rate, with their block output interpolated in between. Applies to objects initialized after the call; 1, the default, runs them at audio rate.
+     */
+    void        LEAF_setControlRate  (LEAF* const leaf, int divider);
+
+    //! Get the default control rate divider of LEAF.
+    /*!
+     @return The number of samples between control rate ticks.
+     */
+    int         LEAF_getControlRate  (LEAF* const leaf);
+
     //! The default callback function for LEAF errors.
     /*!
      @param errorType The type of the error that has occurred.
@@ -175,8 +219,35 @@ extern "C" {
      */
     void LEAF_setErrorCallback(LEAF* const leaf, void (*callback)(LEAF* const, LEAFErrorType));
     
-    /*! @} */
+#if LEAF_PROFILE
+    //! Set the time-stamp callback for profiling and start recording. Set it between blocks.
+    /*!
+     @param time A pointer to a function returning a time stamp that counts up and wraps at 32 bits, such as DWT->CYCCNT on a Cortex-M. Times in the profile are differences of its values. NULL stops recording.
+     */
+    void LEAF_setProfileCallback(LEAF* const leaf, uint32_t (*time)(void));
+    
+    //! Mark the end of an audio block, which updates each entry's worst block time. Call at the end of the audio callback.
+    void LEAF_profileEndBlock(LEAF* const leaf);
+    
+    //! Clear the profile.
+    void LEAF_resetProfile(LEAF* const leaf);
+    
+    //! Get the number of functions in the profile.
+    /*!
+     @return The number of entries.
+     */
+    int LEAF_getNumProfileEntries(LEAF* const leaf);
+    
+    //! Get the timing of a function in the profile.
+    /*!
+     @param index The entry, from 0 to LEAF_getNumProfileEntries() - 1, in the order the functions were first called.
+     @return A pointer to the entry, or NULL if index is out of range.
+     */
+    LEAFProfileEntry* LEAF_getProfileEntry(LEAF* const leaf, int index);
+#endif
     
+    /*! @} */
+
 #ifdef __cplusplus
 }
 #endif
@@ -1,5 +1,5 @@
 # Wavetable generator, by Michael Mulshine
-# Use: python wtgenerator.py NAME DOMAINSIZE SAMPLERATE BASEFREQ
+# Use: python wtgenerator.py NAME DOMAINSIZE SAMPLERATE BASEFREQ [MAXFREQ]
 # As configured, will generate a set of wavetables for a square wave 
 # starting at a base frequency and jumping up octaves until Nyquist.
 #
@@ -9,10 +9,13 @@
 #   SQE_full.txt (all wavetables configured in floating point two dimensional array)
 #   SQE_XXXX.txt (Individual wavetables for frequency XXXX.)
 #   SQE_XXXX.png (Plots for frequency XXXX, concatenated on previous.)
+#   SQE.lwt (Only if MAXFREQ is given. Wavetable image of the first table with
+#            all mip levels up to MAXFREQ, for tWaveTable_initFromImage.)
 #
 
 import sys, re, string, numpy, math
 import matplotlib.pyplot as plt
+import wtimage
 
 def clip(lo, x, hi):
     return max(lo, min(hi, x))
@@ -168,6 +171,9 @@ while (base < nyquist):
 	tablenum += 1
 	outputfile.flush()
 
+	if (tablenum == 2 and len(sys.argv) > 5):
+		wtimage.write_image(sys.argv[1] + ".lwt", [ -w for w in wave ], float(sys.argv[3]), float(sys.argv[5]))
+
 	base*=2
 
 
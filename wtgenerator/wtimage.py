@@ -0,0 +1,97 @@
+# Wavetable image writer
+# Use: python wtimage.py INPUT OUTPUT SAMPLERATE MAXFREQ [float32|int16] [halve]
+#
+# Reads a single cycle from INPUT (comma or whitespace separated values, as
+# written by wtgenerator.py) and writes a LEAF wavetable image with every
+# mip level precomputed, ready for tWaveTable_initFromImage (or, with
+# "halve", tWaveTableS_initFromImage).
+#
+# python wtimage.py SQR_20 SQR.lwt 48000 20000 float32
+#
+# Layout (little endian):
+#   header:  char magic[4] "LWTI", uint16 version, uint16 format,
+#            uint32 numLevels, float sampleRate, float maxFreq, float scale,
+#            uint32 reserved[2]
+#   levels:  numLevels x { uint32 size, uint32 offset }
+#   data:    each level's samples starting at a 16 byte aligned offset
+#            from the start of the image, float32 or int16 (x scale)
+#
+
+import sys, re, struct, numpy
+
+MAGIC = b"LWTI"
+VERSION = 1
+FORMATS = { "float32" : 0, "int16" : 1 }
+HEADER = "<4sHHIfff2I"
+LEVEL = "<II"
+ALIGN = 16
+
+def num_levels(size, sampleRate, maxFreq):
+	# Same count tWaveTable_init arrives at: the base table, one level per
+	# octave from the table's base frequency up to maxFreq, and one extra
+	n = 2
+	freq = float(sampleRate) / float(size)
+	while freq < maxFreq:
+		n += 1
+		freq *= 2.0
+	return n
+
+def band_limit(wave, harmonics, size):
+	# Brickwall in the frequency domain, resampled to size
+	spectrum = numpy.fft.rfft(wave)
+	out = numpy.zeros(size // 2 + 1, dtype=complex)
+	keep = min(harmonics, len(spectrum), len(out))
+	out[:keep] = spectrum[:keep]
+	if keep == len(out):
+		out[-1] = 0.0
+	return numpy.fft.irfft(out, size) * (float(size) / float(len(wave)))
+
+def make_levels(wave, sampleRate, maxFreq, halve=False):
+	wave = numpy.asarray(wave, dtype=float)
+	size = len(wave)
+	levels = [ wave.copy() ]
+	for t in range(1, num_levels(size, sampleRate, maxFreq)):
+		lsize = max(size >> t, 2) if halve else size
+		levels.append(band_limit(wave, size >> (t + 1), lsize))
+	return levels
+
+def write_image(path, wave, sampleRate, maxFreq, fmt="float32", halve=False):
+	levels = make_levels(wave, sampleRate, maxFreq, halve)
+	scale = 1.0
+	if fmt == "int16":
+		peak = max(numpy.max(numpy.abs(l)) for l in levels)
+		scale = peak / 32767.0 if peak > 0.0 else 1.0
+
+	width = 4 if fmt == "float32" else 2
+	offset = struct.calcsize(HEADER) + struct.calcsize(LEVEL) * len(levels)
+	table = []
+	for l in levels:
+		offset += (-offset) % ALIGN
+		table.append((len(l), offset))
+		offset += len(l) * width
+
+	with open(path, "wb") as out:
+		out.write(struct.pack(HEADER, MAGIC, VERSION, FORMATS[fmt], len(levels),
+							  sampleRate, maxFreq, scale, 0, 0))
+		for size, off in table:
+			out.write(struct.pack(LEVEL, size, off))
+		for l, (size, off) in zip(levels, table):
+			out.write(b"\0" * (off - out.tell()))
+			if fmt == "float32":
+				out.write(l.astype("<f4").tobytes())
+			else:
+				q = numpy.clip(numpy.round(l / scale), -32767, 32767)
+				out.write(q.astype("<i2").tobytes())
+
+def read_wave(path):
+	with open(path) as f:
+		text = f.read()
+	return [ float(v) for v in re.findall(r"[-+]?[0-9]*\.?[0-9]+(?:[eE][-+]?[0-9]+)?", text) ]
+
+if __name__ == "__main__":
+	if len(sys.argv) < 5:
+		print("Use: python wtimage.py INPUT OUTPUT SAMPLERATE MAXFREQ [float32|int16] [halve]")
+		sys.exit(1)
+	fmt = sys.argv[5] if len(sys.argv) > 5 else "float32"
+	halve = len(sys.argv) > 6 and sys.argv[6] == "halve"
+	write_image(sys.argv[2], read_wave(sys.argv[1]), float(sys.argv[3]), float(sys.argv[4]), fmt, halve)